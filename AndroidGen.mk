@@ -3,6 +3,7 @@
 
 LOCAL_SRC_FILES := \
 	execserver/xsDefs.cpp \
+	execserver/xsEventPoller.cpp \
 	execserver/xsExecutionServer.cpp \
 	execserver/xsPosixFileReader.cpp \
 	execserver/xsPosixTestProcess.cpp \
@@ -49,11 +50,13 @@ LOCAL_SRC_FILES := \
 	external/vulkancts/framework/vulkan/vkRef.cpp \
 	external/vulkancts/framework/vulkan/vkRefUtil.cpp \
 	external/vulkancts/framework/vulkan/vkRenderDocUtil.cpp \
+	external/vulkancts/framework/vulkan/vkShaderCache.cpp \
 	external/vulkancts/framework/vulkan/vkShaderProgram.cpp \
 	external/vulkancts/framework/vulkan/vkShaderToSpirV.cpp \
 	external/vulkancts/framework/vulkan/vkSpirVAsm.cpp \
 	external/vulkancts/framework/vulkan/vkSpirVProgram.cpp \
 	external/vulkancts/framework/vulkan/vkStrUtil.cpp \
+	external/vulkancts/framework/vulkan/vkSubAllocator.cpp \
 	external/vulkancts/framework/vulkan/vkTypeUtil.cpp \
 	external/vulkancts/framework/vulkan/vkWsiPlatform.cpp \
 	external/vulkancts/framework/vulkan/vkWsiUtil.cpp \
@@ -530,6 +533,7 @@ LOCAL_SRC_FILES := \
 	external/vulkancts/modules/vulkan/vktCustomInstancesDevices.cpp \
 	external/vulkancts/modules/vulkan/vktInfoTests.cpp \
 	external/vulkancts/modules/vulkan/vktShaderLibrary.cpp \
+	external/vulkancts/modules/vulkan/vktTaskExecutor.cpp \
 	external/vulkancts/modules/vulkan/vktTestCase.cpp \
 	external/vulkancts/modules/vulkan/vktTestCaseUtil.cpp \
 	external/vulkancts/modules/vulkan/vktTestGroupUtil.cpp \
@@ -563,6 +567,7 @@ LOCAL_SRC_FILES := \
 	framework/common/tcuCPUWarmup.cpp \
 	framework/common/tcuCommandLine.cpp \
 	framework/common/tcuCompressedTexture.cpp \
+	framework/common/tcuDecompressedTextureCache.cpp \
 	framework/common/tcuDefs.cpp \
 	framework/common/tcuEither.cpp \
 	framework/common/tcuFactoryRegistry.cpp \
@@ -584,6 +589,7 @@ LOCAL_SRC_FILES := \
 	framework/common/tcuResultCollector.cpp \
 	framework/common/tcuSeedBuilder.cpp \
 	framework/common/tcuStringTemplate.cpp \
+	framework/common/tcuSubprocessRunner.cpp \
 	framework/common/tcuSurface.cpp \
 	framework/common/tcuSurfaceAccess.cpp \
 	framework/common/tcuTestCase.cpp \
@@ -620,6 +626,7 @@ LOCAL_SRC_FILES := \
 	framework/delibs/decpp/deDirectoryIterator.cpp \
 	framework/delibs/decpp/deDynamicLibrary.cpp \
 	framework/delibs/decpp/deFilePath.cpp \
+	framework/delibs/decpp/deLockFreeQueue.cpp \
 	framework/delibs/decpp/deMemPool.cpp \
 	framework/delibs/decpp/deMeta.cpp \
 	framework/delibs/decpp/deMutex.cpp \
@@ -672,6 +679,7 @@ LOCAL_SRC_FILES := \
 	framework/delibs/deutil/deCommandLine.c \
 	framework/delibs/deutil/deDynamicLibrary.c \
 	framework/delibs/deutil/deFile.c \
+	framework/delibs/deutil/deMappedFile.c \
 	framework/delibs/deutil/deProcess.c \
 	framework/delibs/deutil/deSocket.c \
 	framework/delibs/deutil/deTimer.c \
@@ -81,7 +81,12 @@ int main (int argc, const char* const* argv)
 														? xs::ExecutionServer::RUNMODE_SINGLE_EXEC
 														: xs::ExecutionServer::RUNMODE_FOREVER;
 		const int							port		= cmdLine.getOption<opt::Port>();
-		xs::ExecutionServer					server		(&testProcess, DE_SOCKETFAMILY_INET4, port, runMode);
+#if defined(XS_HAS_EVENT_POLLER)
+		const xs::ExecutionServer::ServerMode	serverMode	= xs::ExecutionServer::SERVERMODE_EVENT_LOOP;
+#else
+		const xs::ExecutionServer::ServerMode	serverMode	= xs::ExecutionServer::SERVERMODE_THREAD_PER_CONNECTION;
+#endif
+		xs::ExecutionServer					server		(&testProcess, DE_SOCKETFAMILY_INET4, port, runMode, serverMode);
 
 		std::cout << "Listening on port " << port << ".\n";
 		server.runServer();
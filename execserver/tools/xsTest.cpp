@@ -24,6 +24,7 @@
 #include "xsDefs.hpp"
 
 #include "xsProtocol.hpp"
+#include "xsEventPoller.hpp"
 #include "deSocket.hpp"
 #include "deRingBuffer.hpp"
 #include "deFilePath.hpp"
@@ -40,6 +41,10 @@
 #include <memory>
 #include <algorithm>
 
+#if defined(XS_HAS_EVENT_POLLER)
+#	include <unistd.h>
+#endif
+
 using std::string;
 using std::vector;
 
@@ -813,6 +818,250 @@ public:
 	void runProgram (void) { /* nothing */ }
 };
 
+#if defined(XS_HAS_EVENT_POLLER)
+
+class Pipe
+{
+public:
+	Pipe (void)
+	{
+		XS_CHECK(pipe(m_fds) == 0);
+	}
+
+	~Pipe (void)
+	{
+		closeReadEnd();
+		closeWriteEnd();
+	}
+
+	int		getReadEnd		(void) const { return m_fds[0]; }
+	int		getWriteEnd		(void) const { return m_fds[1]; }
+
+	void	closeReadEnd	(void) { if (m_fds[0] >= 0) close(m_fds[0]); m_fds[0] = -1; }
+	void	closeWriteEnd	(void) { if (m_fds[1] >= 0) close(m_fds[1]); m_fds[1] = -1; }
+
+	void write (deUint8 value)
+	{
+		XS_CHECK(::write(m_fds[1], &value, sizeof(value)) == (ssize_t)sizeof(value));
+	}
+
+	deUint8 read (void)
+	{
+		deUint8 value = 0;
+		XS_CHECK(::read(m_fds[0], &value, sizeof(value)) == (ssize_t)sizeof(value));
+		return value;
+	}
+
+private:
+			Pipe		(const Pipe& other);
+	Pipe&	operator=	(const Pipe& other);
+
+	int		m_fds[2];
+};
+
+class DelayedWakeup : public de::Thread
+{
+public:
+	DelayedWakeup (EventPoller& poller, int delay)
+		: m_poller	(poller)
+		, m_delay	(delay)
+	{
+	}
+
+	void run (void)
+	{
+		deSleep(m_delay);
+		m_poller.wakeup();
+	}
+
+private:
+	EventPoller&	m_poller;
+	const int		m_delay;
+};
+
+void testEventPollerTimeout (void)
+{
+	EventPoller						poller;
+	Pipe							idlePipe;
+	std::vector<EventPoller::Event>	events;
+	TestClock						clock;
+
+	poller.add(idlePipe.getReadEnd(), EventPoller::EVENT_READ);
+
+	XS_CHECK(!poller.wait(events, 0));
+	XS_CHECK(events.empty());
+
+	clock.reset();
+	XS_CHECK(!poller.wait(events, 50));
+	XS_CHECK(events.empty());
+	XS_CHECK(clock.getMilliseconds() >= 40);
+}
+
+void testEventPollerRead (void)
+{
+	EventPoller						poller;
+	Pipe							dataPipe;
+	std::vector<EventPoller::Event>	events;
+
+	poller.add(dataPipe.getReadEnd(), EventPoller::EVENT_READ);
+	XS_CHECK(!poller.wait(events, 0));
+
+	// Pending data is reported until it has been read.
+	dataPipe.write(0x5a);
+
+	for (int ndx = 0; ndx < 2; ndx++)
+	{
+		XS_CHECK(poller.wait(events, -1));
+		XS_CHECK(events.size() == 1);
+		XS_CHECK(events[0].fd == dataPipe.getReadEnd());
+		XS_CHECK(events[0].events == EventPoller::EVENT_READ);
+	}
+
+	XS_CHECK(dataPipe.read() == 0x5a);
+	XS_CHECK(!poller.wait(events, 0));
+
+	// Closing write end is reported as readable.
+	dataPipe.closeWriteEnd();
+	XS_CHECK(poller.wait(events, -1));
+	XS_CHECK(events.size() == 1);
+	XS_CHECK(events[0].fd == dataPipe.getReadEnd());
+	XS_CHECK((events[0].events & EventPoller::EVENT_READ) != 0);
+}
+
+void testEventPollerModifyRemove (void)
+{
+	EventPoller						poller;
+	Pipe							pipeA;
+	Pipe							pipeB;
+	std::vector<EventPoller::Event>	events;
+
+	poller.add(pipeA.getReadEnd(), EventPoller::EVENT_READ);
+	poller.add(pipeB.getWriteEnd(), EventPoller::EVENT_WRITE);
+
+	// Empty pipe is writable.
+	XS_CHECK(poller.wait(events, -1));
+	XS_CHECK(events.size() == 1);
+	XS_CHECK(events[0].fd == pipeB.getWriteEnd());
+	XS_CHECK(events[0].events == EventPoller::EVENT_WRITE);
+
+	// Stop listening for writes.
+	poller.modify(pipeB.getWriteEnd(), 0u);
+	XS_CHECK(!poller.wait(events, 0));
+
+	// Both fds are reported from a single wait.
+	poller.modify(pipeB.getWriteEnd(), EventPoller::EVENT_WRITE);
+	pipeA.write(1);
+	XS_CHECK(poller.wait(events, -1));
+	XS_CHECK(events.size() == 2);
+	XS_CHECK(events[0].fd != events[1].fd);
+
+	for (size_t ndx = 0; ndx < events.size(); ndx++)
+	{
+		if (events[ndx].fd == pipeA.getReadEnd())
+			XS_CHECK(events[ndx].events == EventPoller::EVENT_READ);
+		else
+		{
+			XS_CHECK(events[ndx].fd == pipeB.getWriteEnd());
+			XS_CHECK(events[ndx].events == EventPoller::EVENT_WRITE);
+		}
+	}
+
+	// Removed fds are not reported even if they are ready.
+	poller.remove(pipeB.getWriteEnd());
+	XS_CHECK(poller.wait(events, -1));
+	XS_CHECK(events.size() == 1);
+	XS_CHECK(events[0].fd == pipeA.getReadEnd());
+
+	poller.remove(pipeA.getReadEnd());
+	XS_CHECK(!poller.wait(events, 0));
+	XS_CHECK(events.empty());
+}
+
+void testEventPollerWakeup (void)
+{
+	EventPoller						poller;
+	Pipe							idlePipe;
+	std::vector<EventPoller::Event>	events;
+	TestClock						clock;
+
+	poller.add(idlePipe.getReadEnd(), EventPoller::EVENT_READ);
+
+	// Wakeup from another thread interrupts a pending wait.
+	{
+		DelayedWakeup wakeupThread(poller, 50);
+
+		clock.reset();
+		wakeupThread.start();
+		XS_CHECK(!poller.wait(events, 5000));
+		XS_CHECK(events.empty());
+		XS_CHECK(clock.getMilliseconds() < 2500);
+		wakeupThread.join();
+	}
+
+	// Wakeup issued before wait is not lost.
+	clock.reset();
+	poller.wakeup();
+	XS_CHECK(!poller.wait(events, 5000));
+	XS_CHECK(clock.getMilliseconds() < 2500);
+
+	// Wakeups are coalesced, even if there are more than fit in the pipe.
+	for (int ndx = 0; ndx < 128*1024; ndx++)
+		poller.wakeup();
+
+	XS_CHECK(!poller.wait(events, 5000));
+
+	clock.reset();
+	XS_CHECK(!poller.wait(events, 50));
+	XS_CHECK(clock.getMilliseconds() >= 40);
+
+	// Data and wakeup are reported together.
+	idlePipe.write(1);
+	poller.wakeup();
+	XS_CHECK(poller.wait(events, -1));
+	XS_CHECK(events.size() == 1);
+	XS_CHECK(events[0].fd == idlePipe.getReadEnd());
+}
+
+struct EventPollerCase
+{
+	const char*	name;
+	void		(*func)	(void);
+};
+
+bool runEventPollerTests (void)
+{
+	static const EventPollerCase s_cases[] =
+	{
+		{ "event-poller-timeout",		testEventPollerTimeout		},
+		{ "event-poller-read",			testEventPollerRead			},
+		{ "event-poller-modify-remove",	testEventPollerModifyRemove	},
+		{ "event-poller-wakeup",		testEventPollerWakeup		},
+	};
+
+	int numPassed = 0;
+
+	for (int caseNdx = 0; caseNdx < DE_LENGTH_OF_ARRAY(s_cases); caseNdx++)
+	{
+		printf("%s\n", s_cases[caseNdx].name);
+
+		try
+		{
+			s_cases[caseNdx].func();
+			numPassed += 1;
+		}
+		catch (const std::exception& e)
+		{
+			printf("FAIL: %s\n\n", e.what());
+		}
+	}
+
+	printf("\n  %d/%d passed!\n", numPassed, DE_LENGTH_OF_ARRAY(s_cases));
+
+	return numPassed == DE_LENGTH_OF_ARRAY(s_cases);
+}
+
+#endif // XS_HAS_EVENT_POLLER
+
 void printHelp (const char* binName)
 {
 	printf("%s:\n", binName);
@@ -823,6 +1072,7 @@ void printHelp (const char* binName)
 	printf("  --tester-cmd=[cmd]    Launch tester with [cmd]\n");
 	printf("  --server-cmd=[cmd]    Launch server with [cmd]\n");
 	printf("  --start-server        Start server for test execution\n");
+	printf("  --event-poller        Run local event poller tests only\n");
 }
 
 struct CompareCaseName
@@ -850,6 +1100,7 @@ void runExecServerTests (int argc, const char* const* argv)
 
 	std::string runClient = "";
 	std::string runProgram = "";
+	bool runEventPoller = false;
 
 	// Parse command line.
 	for (int argNdx = 1; argNdx < argc; argNdx++)
@@ -881,6 +1132,8 @@ void runExecServerTests (int argc, const char* const* argv)
 		}
 		else if (deStringEqual(arg, "--start-server"))
 			testCtx.startServer = true;
+		else if (deStringEqual(arg, "--event-poller"))
+			runEventPoller = true;
 		else
 		{
 			printHelp(argv[0]);
@@ -918,9 +1171,20 @@ void runExecServerTests (int argc, const char* const* argv)
 			fflush(stdout);	// Make sure handles are flushed.
 			fflush(stderr);
 		}
+		else if (runEventPoller)
+		{
+#if defined(XS_HAS_EVENT_POLLER)
+			runEventPollerTests();
+#else
+			printf("Event poller is not supported on this platform\n");
+#endif
+		}
 		else
 		{
 			// Run all tests.
+#if defined(XS_HAS_EVENT_POLLER)
+			runEventPollerTests();
+#endif
 			TestExecutor executor(testCtx);
 			executor.runCases(testCases);
 		}
@@ -41,21 +41,23 @@ enum
 
 	SERVER_IDLE_THRESHOLD		= 10,
 	SERVER_IDLE_SLEEP			= 50,
+	SERVER_PROCESS_POLL_INTERVAL	= 100,
 	FILEREADER_IDLE_SLEEP		= 100,
 
-	LOG_BUFFER_BLOCK_SIZE		= 1024,
+	LOG_BUFFER_BLOCK_SIZE		= 4*1024,
 	LOG_BUFFER_NUM_BLOCKS		= 512,
 
 	INFO_BUFFER_BLOCK_SIZE		= 64,
 	INFO_BUFFER_NUM_BLOCKS		= 128,
 
-	SEND_BUFFER_SIZE			= 16*1024,
+	SEND_BUFFER_SIZE			= 256*1024,
 	RECV_BUFFER_SIZE			= 4*1024,
 
-	FILEREADER_TMP_BUFFER_SIZE	= 1024,
+	FILEREADER_TMP_BUFFER_SIZE	= 16*1024,
 	SEND_RECV_TMP_BUFFER_SIZE	= 4*1024,
 
-	MIN_MSG_PAYLOAD_SIZE		= 32
+	MIN_MSG_PAYLOAD_SIZE		= 32,
+	MAX_DATA_MSG_SIZE			= 64*1024	//!< Upper limit for log and info data messages.
 };
 
 typedef de::RingBuffer<deUint8>		ByteBuffer;
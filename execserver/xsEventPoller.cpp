@@ -0,0 +1,273 @@
+/*-------------------------------------------------------------------------
+ * drawElements Quality Program Execution Server
+ * ---------------------------------------------
+ *
+ * Copyright 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *//*!
+ * \file
+ * \brief I/O event poller.
+ *//*--------------------------------------------------------------------*/
+
+#include "xsEventPoller.hpp"
+
+#if defined(XS_HAS_EVENT_POLLER)
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <poll.h>
+
+#if defined(__linux__)
+#	define XS_USE_EPOLL
+#	include <sys/epoll.h>
+#endif
+
+namespace xs
+{
+
+namespace
+{
+
+void setNonBlockingCloseOnExec (int fd)
+{
+	const int flags = fcntl(fd, F_GETFL);
+
+	if (flags < 0 || fcntl(fd, F_SETFL, flags|O_NONBLOCK) != 0 || fcntl(fd, F_SETFD, FD_CLOEXEC) != 0)
+		XS_FAIL("Failed to set file descriptor flags");
+}
+
+#if defined(XS_USE_EPOLL)
+
+deUint32 getEpollEvents (deUint32 events)
+{
+	return ((events & EventPoller::EVENT_READ)	? (deUint32)(EPOLLIN|EPOLLRDHUP)	: 0u)
+		 | ((events & EventPoller::EVENT_WRITE)	? (deUint32)EPOLLOUT				: 0u);
+}
+
+#else
+
+short getPollEvents (deUint32 events)
+{
+	return (short)(((events & EventPoller::EVENT_READ)	? POLLIN	: 0)
+				 | ((events & EventPoller::EVENT_WRITE)	? POLLOUT	: 0));
+}
+
+#endif // XS_USE_EPOLL
+
+} // anonymous
+
+EventPoller::EventPoller (void)
+	: m_epollFd(-1)
+{
+	if (pipe(m_wakeupPipe) != 0)
+		XS_FAIL("Failed to create wakeup pipe");
+
+	try
+	{
+		setNonBlockingCloseOnExec(m_wakeupPipe[0]);
+		setNonBlockingCloseOnExec(m_wakeupPipe[1]);
+
+#if defined(XS_USE_EPOLL)
+		m_epollFd = epoll_create1(EPOLL_CLOEXEC);
+		if (m_epollFd < 0)
+			XS_FAIL("Failed to create epoll instance");
+
+		{
+			struct epoll_event ev;
+			ev.events	= EPOLLIN;
+			ev.data.fd	= m_wakeupPipe[0];
+
+			if (epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_wakeupPipe[0], &ev) != 0)
+				XS_FAIL("Failed to add wakeup pipe to epoll");
+		}
+#endif
+	}
+	catch (...)
+	{
+		if (m_epollFd >= 0)
+			close(m_epollFd);
+		close(m_wakeupPipe[0]);
+		close(m_wakeupPipe[1]);
+		throw;
+	}
+}
+
+EventPoller::~EventPoller (void)
+{
+	if (m_epollFd >= 0)
+		close(m_epollFd);
+
+	close(m_wakeupPipe[0]);
+	close(m_wakeupPipe[1]);
+}
+
+void EventPoller::add (int fd, deUint32 events)
+{
+	DE_ASSERT(m_fds.find(fd) == m_fds.end());
+
+#if defined(XS_USE_EPOLL)
+	{
+		struct epoll_event ev;
+		ev.events	= getEpollEvents(events);
+		ev.data.fd	= fd;
+
+		if (epoll_ctl(m_epollFd, EPOLL_CTL_ADD, fd, &ev) != 0)
+			XS_FAIL("epoll_ctl(EPOLL_CTL_ADD) failed");
+	}
+#endif
+
+	m_fds[fd] = events;
+}
+
+void EventPoller::modify (int fd, deUint32 events)
+{
+	const std::map<int, deUint32>::iterator pos = m_fds.find(fd);
+	DE_ASSERT(pos != m_fds.end());
+
+	if (pos->second == events)
+		return;
+
+#if defined(XS_USE_EPOLL)
+	{
+		struct epoll_event ev;
+		ev.events	= getEpollEvents(events);
+		ev.data.fd	= fd;
+
+		if (epoll_ctl(m_epollFd, EPOLL_CTL_MOD, fd, &ev) != 0)
+			XS_FAIL("epoll_ctl(EPOLL_CTL_MOD) failed");
+	}
+#endif
+
+	pos->second = events;
+}
+
+void EventPoller::remove (int fd)
+{
+	DE_ASSERT(m_fds.find(fd) != m_fds.end());
+
+#if defined(XS_USE_EPOLL)
+	{
+		// \note Event argument must be non-null on old kernels.
+		struct epoll_event ev;
+		ev.events	= 0;
+		ev.data.fd	= fd;
+		epoll_ctl(m_epollFd, EPOLL_CTL_DEL, fd, &ev);
+	}
+#endif
+
+	m_fds.erase(fd);
+}
+
+bool EventPoller::wait (std::vector<Event>& events, int timeout)
+{
+	events.clear();
+
+#if defined(XS_USE_EPOLL)
+	{
+		std::vector<struct epoll_event>	epollEvents	(m_fds.size()+1);
+		const int						numEvents	= epoll_wait(m_epollFd, &epollEvents[0], (int)epollEvents.size(), timeout);
+
+		if (numEvents < 0)
+		{
+			if (errno == EINTR)
+				return false;
+			XS_FAIL("epoll_wait() failed");
+		}
+
+		for (int ndx = 0; ndx < numEvents; ndx++)
+		{
+			const struct epoll_event&	ev		= epollEvents[ndx];
+			const deUint32				flags	= ((ev.events & (EPOLLIN|EPOLLRDHUP|EPOLLHUP))	? (deUint32)EVENT_READ	: 0u)
+												| ((ev.events & EPOLLOUT)						? (deUint32)EVENT_WRITE	: 0u)
+												| ((ev.events & EPOLLERR)						? (deUint32)EVENT_ERROR	: 0u);
+
+			if (ev.data.fd == m_wakeupPipe[0])
+				drainWakeups();
+			else
+				events.push_back(Event(ev.data.fd, flags));
+		}
+	}
+#else
+	{
+		std::vector<struct pollfd> pollFds;
+
+		pollFds.reserve(m_fds.size()+1);
+
+		{
+			struct pollfd wakeupFd;
+			wakeupFd.fd			= m_wakeupPipe[0];
+			wakeupFd.events		= POLLIN;
+			wakeupFd.revents	= 0;
+			pollFds.push_back(wakeupFd);
+		}
+
+		for (std::map<int, deUint32>::const_iterator fdIter = m_fds.begin(); fdIter != m_fds.end(); ++fdIter)
+		{
+			struct pollfd pollFd;
+			pollFd.fd		= fdIter->first;
+			pollFd.events	= getPollEvents(fdIter->second);
+			pollFd.revents	= 0;
+			pollFds.push_back(pollFd);
+		}
+
+		if (poll(&pollFds[0], (nfds_t)pollFds.size(), timeout) < 0)
+		{
+			if (errno == EINTR)
+				return false;
+			XS_FAIL("poll() failed");
+		}
+
+		if (pollFds[0].revents != 0)
+			drainWakeups();
+
+		for (size_t ndx = 1; ndx < pollFds.size(); ndx++)
+		{
+			const short		revents	= pollFds[ndx].revents;
+			const deUint32	flags	= ((revents & (POLLIN|POLLHUP))			? (deUint32)EVENT_READ	: 0u)
+									| ((revents & POLLOUT)					? (deUint32)EVENT_WRITE	: 0u)
+									| ((revents & (POLLERR|POLLNVAL))		? (deUint32)EVENT_ERROR	: 0u);
+
+			if (flags != 0)
+				events.push_back(Event(pollFds[ndx].fd, flags));
+		}
+	}
+#endif
+
+	return !events.empty();
+}
+
+void EventPoller::wakeup (void)
+{
+	const deUint8 value = 1;
+
+	// \note Called from reader threads so errors are ignored. Non-blocking
+	//		 write can only fail if pipe is full, and then wakeup is pending anyway.
+	if (write(m_wakeupPipe[1], &value, sizeof(value)) < 0)
+		return;
+}
+
+void EventPoller::drainWakeups (void)
+{
+	deUint8 buf[64];
+
+	while (read(m_wakeupPipe[0], buf, sizeof(buf)) > 0)
+	{
+	}
+}
+
+} // xs
+
+#endif // XS_HAS_EVENT_POLLER
@@ -0,0 +1,90 @@
+#ifndef _XSEVENTPOLLER_HPP
+#define _XSEVENTPOLLER_HPP
+/*-------------------------------------------------------------------------
+ * drawElements Quality Program Execution Server
+ * ---------------------------------------------
+ *
+ * Copyright 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *//*!
+ * \file
+ * \brief I/O event poller.
+ *//*--------------------------------------------------------------------*/
+
+#include "xsDefs.hpp"
+
+#include <map>
+#include <vector>
+
+#if (DE_OS == DE_OS_UNIX || DE_OS == DE_OS_OSX || DE_OS == DE_OS_ANDROID || DE_OS == DE_OS_QNX || DE_OS == DE_OS_IOS)
+#	define XS_HAS_EVENT_POLLER
+#endif
+
+namespace xs
+{
+
+#if defined(XS_HAS_EVENT_POLLER)
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Waits for I/O readiness on a set of file descriptors
+ *
+ * Uses epoll on Linux and poll() on other POSIX systems. wakeup() may be
+ * called from any thread to make a pending or the next wait() return.
+ *//*--------------------------------------------------------------------*/
+class EventPoller
+{
+public:
+	enum EventBits
+	{
+		EVENT_READ		= (1<<0),	//!< Data can be read or peer closed the connection.
+		EVENT_WRITE		= (1<<1),	//!< Data can be written.
+		EVENT_ERROR		= (1<<2)	//!< Error condition, always reported.
+	};
+
+	struct Event
+	{
+		int			fd;
+		deUint32	events;
+
+		Event (int fd_, deUint32 events_) : fd(fd_), events(events_) {}
+	};
+
+							EventPoller		(void);
+							~EventPoller	(void);
+
+	void					add				(int fd, deUint32 events);
+	void					modify			(int fd, deUint32 events);
+	void					remove			(int fd);
+
+	//! Wait for events, timeout in milliseconds, negative to wait indefinitely. Returns false on timeout or wakeup.
+	bool					wait			(std::vector<Event>& events, int timeout);
+	void					wakeup			(void);
+
+private:
+							EventPoller		(const EventPoller& other);
+	EventPoller&			operator=		(const EventPoller& other);
+
+	void					drainWakeups	(void);
+
+	int						m_wakeupPipe[2];
+	int						m_epollFd;		//!< -1 if epoll is not used.
+	std::map<int, deUint32>	m_fds;
+};
+
+#endif // XS_HAS_EVENT_POLLER
+
+} // xs
+
+#endif // _XSEVENTPOLLER_HPP
@@ -23,8 +23,10 @@
 
 #include "xsExecutionServer.hpp"
 #include "deClock.h"
+#include "deAtomic.h"
 
 #include <cstdio>
+#include <set>
 
 using std::vector;
 using std::string;
@@ -98,15 +100,69 @@ void MessageBuilder::clear (void)
 	m_messageSize	= 0;
 }
 
-ExecutionServer::ExecutionServer (xs::TestProcess* testProcess, deSocketFamily family, int port, RunMode runMode)
-	: TcpServer		(family, port)
-	, m_testDriver	(testProcess)
-	, m_runMode		(runMode)
+ExecutionServer::ExecutionServer (xs::TestProcess* testProcess, deSocketFamily family, int port, RunMode runMode, ServerMode serverMode)
+	: TcpServer			(family, port)
+	, m_testDriver		(testProcess)
+	, m_runMode			(runMode)
+	, m_serverMode		(serverMode)
+#if defined(XS_HAS_EVENT_POLLER)
+	, m_poller			(serverMode == SERVERMODE_EVENT_LOOP ? new EventPoller() : DE_NULL)
+	, m_stopRequested	(0)
+#endif
 {
+#if defined(XS_HAS_EVENT_POLLER)
+	// Reader threads of test process wake up the event loop when data is available.
+	if (m_serverMode == SERVERMODE_EVENT_LOOP)
+		m_testDriver.setListener(this);
+#else
+	if (m_serverMode == SERVERMODE_EVENT_LOOP)
+		XS_FAIL("Event loop server mode is not supported on this platform");
+#endif
 }
 
 ExecutionServer::~ExecutionServer (void)
 {
+	if (m_serverMode == SERVERMODE_EVENT_LOOP)
+	{
+		// Stop test process and its reader threads before they lose the listener.
+		m_testDriver.reset();
+		m_testDriver.setListener(DE_NULL);
+	}
+}
+
+void ExecutionServer::runServer (void)
+{
+#if defined(XS_HAS_EVENT_POLLER)
+	if (m_serverMode == SERVERMODE_EVENT_LOOP)
+	{
+		runEventLoop();
+		return;
+	}
+#endif
+
+	TcpServer::runServer();
+}
+
+void ExecutionServer::stopServer (void)
+{
+#if defined(XS_HAS_EVENT_POLLER)
+	if (m_serverMode == SERVERMODE_EVENT_LOOP)
+	{
+		// Event loop closes the socket when it exits.
+		deAtomicIncrementUint32(&m_stopRequested);
+		m_poller->wakeup();
+		return;
+	}
+#endif
+
+	TcpServer::stopServer();
+}
+
+void ExecutionServer::dataAvailable (void)
+{
+#if defined(XS_HAS_EVENT_POLLER)
+	m_poller->wakeup();
+#endif
 }
 
 TestDriver* ExecutionServer::acquireTestDriver (void)
@@ -138,6 +194,165 @@ void ExecutionServer::connectionDone (ConnectionHandler* handler)
 	TcpServer::connectionDone(handler);
 }
 
+#if defined(XS_HAS_EVENT_POLLER)
+
+void ExecutionServer::runEventLoop (void)
+{
+	const int							listenFd		= (int)m_socket.getHandle();
+	HandlerMap							handlers;
+	std::set<int>						pendingFds;		//!< Connections that have socket events or made progress on last poll.
+	std::vector<EventPoller::Event>		events;
+	bool								isListening		= true;
+
+	m_socket.setFlags(DE_SOCKET_NONBLOCKING|DE_SOCKET_CLOSE_ON_EXEC);
+	m_poller->add(listenFd, EventPoller::EVENT_READ);
+
+	try
+	{
+		while (deAtomicCompareExchangeUint32(&m_stopRequested, 0u, 0u) == 0u && (isListening || !handlers.empty()))
+		{
+			// Sleep until socket I/O, test process data or next keepalive. Test process exit and
+			// log file creation are not notified so active process is polled at lower frequency.
+			int timeout = pendingFds.empty() ? -1 : 0;
+
+			for (HandlerMap::const_iterator handlerIter = handlers.begin(); handlerIter != handlers.end() && timeout != 0; ++handlerIter)
+			{
+				const int handlerTimeout = handlerIter->second->hasTestDriver()
+										 ? de::min<int>(handlerIter->second->getKeepAliveTimeout(), SERVER_PROCESS_POLL_INTERVAL)
+										 : handlerIter->second->getKeepAliveTimeout();
+
+				timeout = (timeout < 0) ? handlerTimeout : de::min(timeout, handlerTimeout);
+			}
+
+			m_poller->wait(events, timeout);
+
+			for (std::vector<EventPoller::Event>::const_iterator eventIter = events.begin(); eventIter != events.end(); ++eventIter)
+			{
+				if (eventIter->fd == listenFd)
+					acceptConnection(handlers);
+				else
+					pendingFds.insert(eventIter->fd);
+			}
+
+			for (HandlerMap::iterator handlerIter = handlers.begin(); handlerIter != handlers.end();)
+			{
+				ExecutionRequestHandler* const	handler		= handlerIter->second;
+				const int						fd			= handlerIter->first;
+				bool							isDone		= false;
+
+				if (pendingFds.count(fd) == 0 && !handler->hasTestDriver() && handler->getKeepAliveTimeout() > 0)
+				{
+					++handlerIter;
+					continue; // Nothing to do.
+				}
+
+				try
+				{
+					if (handler->pollSession())
+						pendingFds.insert(fd);
+					else
+						pendingFds.erase(fd);
+
+					isDone = !handler->isSessionRunning();
+				}
+				catch (const std::exception& e)
+				{
+					printf("ExecutionRequestHandler::run(): %s\n", e.what());
+					isDone = true;
+				}
+
+				if (isDone)
+				{
+					pendingFds.erase(fd);
+					deleteHandler(handlers, handlerIter++);
+
+					if (m_runMode == RUNMODE_SINGLE_EXEC && isListening)
+					{
+						m_poller->remove(listenFd);
+						m_socket.close();
+						isListening = false;
+					}
+				}
+				else
+				{
+					m_poller->modify(fd, (deUint32)EventPoller::EVENT_READ | (handler->hasPendingOutput() ? (deUint32)EventPoller::EVENT_WRITE : 0u));
+					++handlerIter;
+				}
+			}
+		}
+	}
+	catch (...)
+	{
+		while (!handlers.empty())
+			deleteHandler(handlers, handlers.begin());
+		throw;
+	}
+
+	while (!handlers.empty())
+		deleteHandler(handlers, handlers.begin());
+
+	if (isListening)
+	{
+		m_poller->remove(listenFd);
+		m_socket.close();
+	}
+}
+
+void ExecutionServer::acceptConnection (HandlerMap& handlers)
+{
+	de::SocketAddress			clientAddress;
+	de::Socket*					clientSocket	= DE_NULL;
+	ExecutionRequestHandler*	handler			= DE_NULL;
+
+	try
+	{
+		clientSocket = m_socket.accept(clientAddress);
+	}
+	catch (const de::SocketError&)
+	{
+		return; // Connection was dropped before accept().
+	}
+
+	printf("ExecutionServer: New connection from %s:%d\n", clientAddress.getHost(), clientAddress.getPort());
+
+	try
+	{
+		handler = new ExecutionRequestHandler(this, clientSocket);
+	}
+	catch (...)
+	{
+		delete clientSocket;
+		throw;
+	}
+
+	try
+	{
+		handlers[handler->getSocketHandle()] = handler;
+		m_poller->add(handler->getSocketHandle(), EventPoller::EVENT_READ);
+	}
+	catch (...)
+	{
+		handlers.erase(handler->getSocketHandle());
+		delete handler;
+		throw;
+	}
+
+	handler->startSession();
+}
+
+void ExecutionServer::deleteHandler (HandlerMap& handlers, HandlerMap::iterator handlerPos)
+{
+	ExecutionRequestHandler* const handler = handlerPos->second;
+
+	m_poller->remove(handlerPos->first);
+	handlers.erase(handlerPos);
+
+	handler->endSession();
+	delete handler;
+}
+
+#endif // XS_HAS_EVENT_POLLER
+
 ExecutionRequestHandler::ExecutionRequestHandler (ExecutionServer* server, de::Socket* socket)
 	: ConnectionHandler	(server, socket)
 	, m_execServer		(server)
@@ -145,7 +360,6 @@ ExecutionRequestHandler::ExecutionRequestHandler (ExecutionServer* server, de::S
 	, m_bufferIn		(RECV_BUFFER_SIZE)
 	, m_bufferOut		(SEND_BUFFER_SIZE)
 	, m_run				(false)
-	, m_sendRecvTmpBuf	(SEND_RECV_TMP_BUFFER_SIZE)
 {
 	// Set flags.
 	m_socket->setFlags(DE_SOCKET_NONBLOCKING|DE_SOCKET_KEEPALIVE|DE_SOCKET_CLOSE_ON_EXEC);
@@ -176,6 +390,11 @@ void ExecutionRequestHandler::handle (void)
 
 	DBG_PRINT(("ExecutionRequestHandler::handle(): Done!\n"));
 
+	endSession();
+}
+
+void ExecutionRequestHandler::endSession (void)
+{
 	// Release test driver.
 	if (m_testDriver)
 	{
@@ -206,43 +425,58 @@ void ExecutionRequestHandler::acquireTestDriver (void)
 
 }
 
-void ExecutionRequestHandler::processSession (void)
+void ExecutionRequestHandler::startSession (void)
 {
 	m_run = true;
+}
 
-	deUint64 lastIoTime = deGetMicroseconds();
+bool ExecutionRequestHandler::pollSession (void)
+{
+	bool anyIO = false;
 
-	while (m_run)
+	// Read from socket to buffer.
+	anyIO = receive() || anyIO;
+
+	// Send bytes in buffer.
+	anyIO = send() || anyIO;
+
+	// Process incoming data.
+	if (m_bufferIn.getNumElements() > 0)
 	{
-		bool anyIO = false;
+		DE_ASSERT(!m_msgBuilder.isComplete());
+		m_msgBuilder.read(m_bufferIn);
+	}
 
-		// Read from socket to buffer.
-		anyIO = receive() || anyIO;
+	if (m_msgBuilder.isComplete())
+	{
+		// Process message.
+		processMessage(m_msgBuilder.getMessageType(), m_msgBuilder.getMessageData(), m_msgBuilder.getMessageDataSize());
 
-		// Send bytes in buffer.
-		anyIO = send() || anyIO;
+		m_msgBuilder.clear();
 
-		// Process incoming data.
-		if (m_bufferIn.getNumElements() > 0)
-		{
-			DE_ASSERT(!m_msgBuilder.isComplete());
-			m_msgBuilder.read(m_bufferIn);
-		}
+		// Input buffer may contain more messages.
+		anyIO = true;
+	}
 
-		if (m_msgBuilder.isComplete())
-		{
-			// Process message.
-			processMessage(m_msgBuilder.getMessageType(), m_msgBuilder.getMessageData(), m_msgBuilder.getMessageDataSize());
+	// Keepalives, anyone?
+	pollKeepAlives();
 
-			m_msgBuilder.clear();
-		}
+	// Poll test driver for IO.
+	if (m_testDriver)
+		anyIO = getTestDriver()->poll(m_bufferOut) || anyIO;
+
+	return anyIO;
+}
 
-		// Keepalives, anyone?
-		pollKeepAlives();
+void ExecutionRequestHandler::processSession (void)
+{
+	startSession();
 
-		// Poll test driver for IO.
-		if (m_testDriver)
-			anyIO = getTestDriver()->poll(m_bufferOut) || anyIO;
+	deUint64 lastIoTime = deGetMicroseconds();
+
+	while (m_run)
+	{
+		const bool anyIO = pollSession();
 
 		// If no IO happens in a reasonable amount of time, go to sleep.
 		{
@@ -319,6 +553,16 @@ void ExecutionRequestHandler::keepAliveReceived (void)
 	m_lastKeepAliveReceived = deGetMicroseconds();
 }
 
+int ExecutionRequestHandler::getKeepAliveTimeout (void) const
+{
+	const deUint64	curTime			= deGetMicroseconds();
+	const deUint64	nextEventTime	= de::min(m_lastKeepAliveSent		+ KEEPALIVE_SEND_INTERVAL*1000,
+											  m_lastKeepAliveReceived	+ KEEPALIVE_TIMEOUT*1000);
+
+	// \note pollKeepAlives() acts only after deadline has passed.
+	return nextEventTime >= curTime ? (int)((nextEventTime - curTime) / 1000) + 1 : 0;
+}
+
 void ExecutionRequestHandler::pollKeepAlives (void)
 {
 	deUint64 curTime = deGetMicroseconds();
@@ -341,17 +585,19 @@ void ExecutionRequestHandler::pollKeepAlives (void)
 
 bool ExecutionRequestHandler::receive (void)
 {
-	size_t maxLen = de::min(m_sendRecvTmpBuf.size(), (size_t)m_bufferIn.getNumFree());
+	// Receive directly to input buffer.
+	int			maxLen	= 0;
+	deUint8*	dst		= m_bufferIn.getFreeSpan(maxLen);
 
 	if (maxLen > 0)
 	{
 		size_t			numRecv;
-		deSocketResult	result	= m_socket->receive(&m_sendRecvTmpBuf[0], maxLen, &numRecv);
+		deSocketResult	result	= m_socket->receive(dst, (size_t)maxLen, &numRecv);
 
 		if (result == DE_SOCKETRESULT_SUCCESS)
 		{
 			DE_ASSERT(numRecv > 0);
-			m_bufferIn.pushFront(&m_sendRecvTmpBuf[0], (int)numRecv);
+			m_bufferIn.commitFront((int)numRecv);
 			return true;
 		}
 		else if (result == DE_SOCKETRESULT_CONNECTION_CLOSED)
@@ -372,20 +618,24 @@ bool ExecutionRequestHandler::receive (void)
 
 bool ExecutionRequestHandler::send (void)
 {
-	size_t maxLen = de::min(m_sendRecvTmpBuf.size(), (size_t)m_bufferOut.getNumElements());
+	bool anySent = false;
 
-	if (maxLen > 0)
+	// Send directly from output buffer. Data that wraps around the end of the buffer is sent with second call.
+	while (m_bufferOut.getNumElements() > 0)
 	{
-		m_bufferOut.peekBack(&m_sendRecvTmpBuf[0], (int)maxLen);
-
-		size_t			numSent;
-		deSocketResult	result	= m_socket->send(&m_sendRecvTmpBuf[0], maxLen, &numSent);
+		int				maxLen	= 0;
+		const deUint8*	src		= m_bufferOut.getElementSpan(maxLen);
+		size_t			numSent	= 0;
+		deSocketResult	result	= m_socket->send(src, (size_t)maxLen, &numSent);
 
 		if (result == DE_SOCKETRESULT_SUCCESS)
 		{
 			DE_ASSERT(numSent > 0);
 			m_bufferOut.popBack((int)numSent);
-			return true;
+			anySent = true;
+
+			if (numSent < (size_t)maxLen)
+				break; // Socket buffer is full.
 		}
 		else if (result == DE_SOCKETRESULT_CONNECTION_CLOSED)
 		{
@@ -393,14 +643,14 @@ bool ExecutionRequestHandler::send (void)
 			return true;
 		}
 		else if (result == DE_SOCKETRESULT_WOULD_BLOCK)
-			return false;
+			break;
 		else if (result == DE_SOCKETRESULT_CONNECTION_TERMINATED)
 			throw ConnectionError("Connection terminated");
 		else
 			throw ConnectionError("send() failed");
 	}
-	else
-		return false;
+
+	return anySent;
 }
 
 } // xs
@@ -28,13 +28,18 @@
 #include "xsTestDriver.hpp"
 #include "xsProtocol.hpp"
 #include "xsTestProcess.hpp"
+#include "xsEventPoller.hpp"
+#include "deUniquePtr.hpp"
 
+#include <map>
 #include <vector>
 
 namespace xs
 {
 
-class ExecutionServer : public TcpServer
+class ExecutionRequestHandler;
+
+class ExecutionServer : public TcpServer, private TestProcessListener
 {
 public:
 	enum RunMode
@@ -45,20 +50,45 @@ public:
 		RUNMODE_LAST
 	};
 
-							ExecutionServer			(xs::TestProcess* testProcess, deSocketFamily family, int port, RunMode runMode);
+	enum ServerMode
+	{
+		SERVERMODE_THREAD_PER_CONNECTION = 0,	//!< Each connection is handled in its own thread that polls for I/O.
+		SERVERMODE_EVENT_LOOP,					//!< All connections are handled in runServer() thread that sleeps until I/O happens. Requires XS_HAS_EVENT_POLLER.
+
+		SERVERMODE_LAST
+	};
+
+							ExecutionServer			(xs::TestProcess* testProcess, deSocketFamily family, int port, RunMode runMode, ServerMode serverMode = SERVERMODE_THREAD_PER_CONNECTION);
 							~ExecutionServer		(void);
 
 	ConnectionHandler*		createHandler			(de::Socket* socket, const de::SocketAddress& clientAddress);
 
+	void					runServer				(void);
+	void					stopServer				(void);
+
 	TestDriver*				acquireTestDriver		(void);
 	void					releaseTestDriver		(TestDriver* driver);
 
 	void					connectionDone			(ConnectionHandler* handler);
 
 private:
+	void					dataAvailable			(void);
+
 	TestDriver				m_testDriver;
 	de::Mutex				m_testDriverLock;
 	RunMode					m_runMode;
+	ServerMode				m_serverMode;
+
+#if defined(XS_HAS_EVENT_POLLER)
+	typedef std::map<int, ExecutionRequestHandler*> HandlerMap;
+
+	void					runEventLoop			(void);
+	void					acceptConnection		(HandlerMap& handlers);
+	void					deleteHandler			(HandlerMap& handlers, HandlerMap::iterator handlerPos);
+
+	de::UniquePtr<EventPoller>	m_poller;
+	volatile deUint32		m_stopRequested;
+#endif
 };
 
 class MessageBuilder
@@ -88,6 +118,17 @@ public:
 								ExecutionRequestHandler			(ExecutionServer* server, de::Socket* socket);
 								~ExecutionRequestHandler		(void);
 
+	// Event loop interface, see ExecutionServer::SERVERMODE_EVENT_LOOP.
+	void						startSession					(void);
+	bool						pollSession						(void);
+	void						endSession						(void);
+
+	bool						isSessionRunning				(void) const	{ return m_run;									}
+	bool						hasPendingOutput				(void) const	{ return m_bufferOut.getNumElements() > 0;		}
+	bool						hasTestDriver					(void) const	{ return m_testDriver != DE_NULL;				}
+	int							getSocketHandle					(void) const	{ return (int)m_socket->getHandle();			}
+	int							getKeepAliveTimeout				(void) const;
+
 protected:
 	void						handle							(void);
 
@@ -120,8 +161,6 @@ private:
 	// \todo [2011-09-30 pyry] Move to some watchdog class instead.
 	deUint64					m_lastKeepAliveSent;
 	deUint64					m_lastKeepAliveReceived;
-
-	std::vector<deUint8>		m_sendRecvTmpBuf;
 };
 
 } // xs
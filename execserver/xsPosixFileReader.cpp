@@ -25,6 +25,13 @@
 
 #include <vector>
 
+#if (DE_OS == DE_OS_UNIX || DE_OS == DE_OS_ANDROID) && defined(__linux__)
+#	define XS_FILEREADER_USE_INOTIFY
+#	include <sys/inotify.h>
+#	include <poll.h>
+#	include <unistd.h>
+#endif
+
 namespace xs
 {
 namespace posix
@@ -34,6 +41,7 @@ FileReader::FileReader (int blockSize, int numBlocks)
 	: m_file		(DE_NULL)
 	, m_buf			(blockSize, numBlocks)
 	, m_isRunning	(false)
+	, m_listener	(DE_NULL)
 {
 }
 
@@ -58,15 +66,57 @@ void FileReader::start (const char* filename)
 	}
 #endif
 
+	m_filename	= filename;
 	m_isRunning	= true;
 
 	de::Thread::start();
 }
 
+void FileReader::waitForData (int notifyFd)
+{
+#if defined(XS_FILEREADER_USE_INOTIFY)
+	if (notifyFd >= 0)
+	{
+		// Wait until file is modified. Timeout bounds the latency of stop().
+		struct pollfd pollFd;
+		pollFd.fd		= notifyFd;
+		pollFd.events	= POLLIN;
+		pollFd.revents	= 0;
+
+		if (poll(&pollFd, 1, FILEREADER_IDLE_SLEEP) > 0)
+		{
+			deUint8 eventBuf[1024];
+
+			while (::read(notifyFd, eventBuf, sizeof(eventBuf)) > 0)
+			{
+			}
+		}
+
+		return;
+	}
+#else
+	DE_UNREF(notifyFd);
+#endif
+
+	deSleep(FILEREADER_IDLE_SLEEP);
+}
+
 void FileReader::run (void)
 {
 	std::vector<deUint8>	tmpBuf		(FILEREADER_TMP_BUFFER_SIZE);
 	deInt64					numRead		= 0;
+	int						notifyFd	= -1;
+
+#if defined(XS_FILEREADER_USE_INOTIFY)
+	// Get notified when test process writes to the log instead of polling the file.
+	notifyFd = inotify_init1(IN_NONBLOCK|IN_CLOEXEC);
+
+	if (notifyFd >= 0 && inotify_add_watch(notifyFd, m_filename.c_str(), IN_MODIFY|IN_CLOSE_WRITE) < 0)
+	{
+		close(notifyFd);
+		notifyFd = -1;
+	}
+#endif
 
 	while (!m_buf.isCanceled())
 	{
@@ -85,16 +135,24 @@ void FileReader::run (void)
 				// Canceled.
 				break;
 			}
+
+			if (m_listener)
+				m_listener->dataAvailable();
 		}
 		else if (result == DE_FILERESULT_END_OF_FILE ||
 				 result == DE_FILERESULT_WOULD_BLOCK)
 		{
 			// Wait for more data.
-			deSleep(FILEREADER_IDLE_SLEEP);
+			waitForData(notifyFd);
 		}
 		else
 			break; // Error.
 	}
+
+#if defined(XS_FILEREADER_USE_INOTIFY)
+	if (notifyFd >= 0)
+		close(notifyFd);
+#endif
 }
 
 void FileReader::stop (void)
@@ -24,9 +24,12 @@
  *//*--------------------------------------------------------------------*/
 
 #include "xsDefs.hpp"
+#include "xsTestProcess.hpp"
 #include "deFile.h"
 #include "deThread.hpp"
 
+#include <string>
+
 namespace xs
 {
 namespace posix
@@ -44,12 +47,19 @@ public:
 	bool					isRunning			(void) const					{ return m_isRunning;					}
 	int						read				(deUint8* dst, int numBytes)	{ return m_buf.tryRead(numBytes, dst);	}
 
+	//! Listener is notified from reader thread whenever new data is written to buffer. Must be set before start().
+	void					setListener			(TestProcessListener* listener)	{ DE_ASSERT(!isStarted()); m_listener = listener; }
+
 	void					run					(void);
 
 private:
+	void					waitForData			(int notifyFd);
+
 	deFile*					m_file;
+	std::string				m_filename;
 	ThreadedByteBuffer		m_buf;
 	bool					m_isRunning;
+	TestProcessListener*	m_listener;
 };
 
 } // posix
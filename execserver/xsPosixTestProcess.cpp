@@ -28,6 +28,11 @@
 #include <string.h>
 #include <stdio.h>
 
+#if (DE_OS == DE_OS_UNIX || DE_OS == DE_OS_OSX || DE_OS == DE_OS_ANDROID || DE_OS == DE_OS_QNX || DE_OS == DE_OS_IOS)
+#	define XS_PIPEREADER_USE_POLL
+#	include <poll.h>
+#endif
+
 using std::string;
 using std::vector;
 
@@ -96,8 +101,9 @@ void CaseListWriter::stop (void)
 }
 
 PipeReader::PipeReader (ThreadedByteBuffer* dst)
-	: m_file	(DE_NULL)
-	, m_buf		(dst)
+	: m_file		(DE_NULL)
+	, m_buf			(dst)
+	, m_listener	(DE_NULL)
 {
 }
 
@@ -118,6 +124,21 @@ void PipeReader::start (deFile* file)
 	de::Thread::start();
 }
 
+void PipeReader::waitForData (void)
+{
+#if defined(XS_PIPEREADER_USE_POLL)
+	// Wait until pipe has data. Timeout bounds the latency of stop().
+	struct pollfd pollFd;
+	pollFd.fd		= (int)deFile_getHandle(m_file);
+	pollFd.events	= POLLIN;
+	pollFd.revents	= 0;
+
+	poll(&pollFd, 1, FILEREADER_IDLE_SLEEP);
+#else
+	deSleep(FILEREADER_IDLE_SLEEP);
+#endif
+}
+
 void PipeReader::run (void)
 {
 	std::vector<deUint8>	tmpBuf		(FILEREADER_TMP_BUFFER_SIZE);
@@ -140,11 +161,18 @@ void PipeReader::run (void)
 				// Canceled.
 				break;
 			}
+
+			if (m_listener)
+				m_listener->dataAvailable();
 		}
-		else if (result == DE_FILERESULT_END_OF_FILE ||
-				 result == DE_FILERESULT_WOULD_BLOCK)
+		else if (result == DE_FILERESULT_WOULD_BLOCK)
 		{
 			// Wait for more data.
+			waitForData();
+		}
+		else if (result == DE_FILERESULT_END_OF_FILE)
+		{
+			// Writer has closed the pipe, poll() would return immediately.
 			deSleep(FILEREADER_IDLE_SLEEP);
 		}
 		else
@@ -295,6 +323,16 @@ void PosixTestProcess::cleanup (void)
 	}
 }
 
+void PosixTestProcess::setListener (TestProcessListener* listener)
+{
+	// Reader threads only run while there is a process, so they can't be reading the listener concurrently.
+	DE_ASSERT(!m_process);
+
+	m_stdOutReader.setListener(listener);
+	m_stdErrReader.setListener(listener);
+	m_logReader.setListener(listener);
+}
+
 bool PosixTestProcess::isRunning (void)
 {
 	if (m_process)
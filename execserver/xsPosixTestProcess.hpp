@@ -63,11 +63,17 @@ public:
 	void					start				(deFile* file);
 	void					stop				(void);
 
+	//! Listener is notified from reader thread whenever new data is written to buffer. Must be set before start().
+	void					setListener			(TestProcessListener* listener)	{ DE_ASSERT(!isStarted()); m_listener = listener; }
+
 	void					run					(void);
 
 private:
+	void					waitForData			(void);
+
 	deFile*					m_file;
 	ThreadedByteBuffer*		m_buf;
+	TestProcessListener*	m_listener;
 };
 
 } // posix
@@ -89,6 +95,8 @@ public:
 	virtual int				readTestLog				(deUint8* dst, int numBytes);
 	virtual int				readInfoLog				(deUint8* dst, int numBytes) { return m_infoBuffer.tryRead(numBytes, dst); }
 
+	virtual void			setListener				(TestProcessListener* listener);
+
 private:
 							PosixTestProcess		(const PosixTestProcess& other);
 	PosixTestProcess&		operator=				(const PosixTestProcess& other);
@@ -44,7 +44,7 @@ public:
 	virtual ConnectionHandler*		createHandler			(de::Socket* socket, const de::SocketAddress& clientAddress) = DE_NULL;
 
 	virtual void					runServer				(void);
-	void							stopServer				(void);
+	virtual void					stopServer				(void);
 
 	virtual void					connectionDone			(ConnectionHandler* handler);
 
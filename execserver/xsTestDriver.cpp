@@ -189,6 +189,13 @@ bool TestDriver::pollInfo (ByteBuffer& messageBuffer)
 	return pollBuffer(messageBuffer, MESSAGETYPE_INFO);
 }
 
+int TestDriver::readData (MessageType msgType, deUint8* dst, int numBytes)
+{
+	return msgType == MESSAGETYPE_PROCESS_LOG_DATA
+		 ? m_process->readTestLog(dst, numBytes)
+		 : m_process->readInfoLog(dst, numBytes);
+}
+
 bool TestDriver::pollBuffer (ByteBuffer& messageBuffer, MessageType msgType)
 {
 	const int minBytesAvailable = MESSAGE_HEADER_SIZE + MIN_MSG_PAYLOAD_SIZE;
@@ -196,28 +203,49 @@ bool TestDriver::pollBuffer (ByteBuffer& messageBuffer, MessageType msgType)
 	if (messageBuffer.getNumFree() < minBytesAvailable)
 		return false; // Not enough space in message buffer.
 
-	const int	maxMsgSize	= de::min((int)m_dataMsgTmpBuf.size(), messageBuffer.getNumFree());
+	int			spanSize	= 0;
+	deUint8*	span		= messageBuffer.getFreeSpan(spanSize);
 	int			numRead		= 0;
 	int			msgSize		= MESSAGE_HEADER_SIZE+1; // One byte is reserved for terminating 0.
 
-	// Fill in data \note Last byte is reserved for 0.
-	numRead = msgType == MESSAGETYPE_PROCESS_LOG_DATA
-			? m_process->readTestLog(&m_dataMsgTmpBuf[MESSAGE_HEADER_SIZE], maxMsgSize-MESSAGE_HEADER_SIZE-1)
-			: m_process->readInfoLog(&m_dataMsgTmpBuf[MESSAGE_HEADER_SIZE], maxMsgSize-MESSAGE_HEADER_SIZE-1);
+	if (spanSize >= minBytesAvailable)
+	{
+		// Assemble message in place to avoid copying data through temporary buffer.
+		const int maxMsgSize = de::min(spanSize, (int)MAX_DATA_MSG_SIZE);
+
+		numRead = readData(msgType, span+MESSAGE_HEADER_SIZE, maxMsgSize-MESSAGE_HEADER_SIZE-1);
+
+		if (numRead <= 0)
+			return false; // Didn't get any data.
 
-	if (numRead <= 0)
-		return false; // Didn't get any data.
+		msgSize += numRead;
+		span[msgSize-1] = 0;
+		Message::writeHeader(msgType, msgSize, span, MESSAGE_HEADER_SIZE);
 
-	msgSize += numRead;
+		messageBuffer.commitFront(msgSize);
+	}
+	else
+	{
+		// Free space wraps around end of buffer.
+		const int maxMsgSize = de::min((int)m_dataMsgTmpBuf.size(), messageBuffer.getNumFree());
+
+		// Fill in data \note Last byte is reserved for 0.
+		numRead = readData(msgType, &m_dataMsgTmpBuf[MESSAGE_HEADER_SIZE], maxMsgSize-MESSAGE_HEADER_SIZE-1);
 
-	// Terminate with 0.
-	m_dataMsgTmpBuf[msgSize-1] = 0;
+		if (numRead <= 0)
+			return false; // Didn't get any data.
 
-	// Write header.
-	Message::writeHeader(msgType, msgSize, &m_dataMsgTmpBuf[0], MESSAGE_HEADER_SIZE);
+		msgSize += numRead;
 
-	// Write to messagebuffer.
-	messageBuffer.pushFront(&m_dataMsgTmpBuf[0], msgSize);
+		// Terminate with 0.
+		m_dataMsgTmpBuf[msgSize-1] = 0;
+
+		// Write header.
+		Message::writeHeader(msgType, msgSize, &m_dataMsgTmpBuf[0], MESSAGE_HEADER_SIZE);
+
+		// Write to messagebuffer.
+		messageBuffer.pushFront(&m_dataMsgTmpBuf[0], msgSize);
+	}
 
 	DBG_PRINT(("  wrote %d bytes of %s data\n", msgSize, msgType == MESSAGETYPE_INFO ? "info" : "log"));
 
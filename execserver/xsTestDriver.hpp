@@ -45,6 +45,8 @@ public:
 
 	bool					poll				(ByteBuffer& messageBuffer);
 
+	void					setListener			(TestProcessListener* listener)	{ m_process->setListener(listener); }
+
 private:
 	enum State
 	{
@@ -61,6 +63,7 @@ private:
 	bool					pollLogFile			(ByteBuffer& messageBuffer);
 	bool					pollInfo			(ByteBuffer& messageBuffer);
 	bool					pollBuffer			(ByteBuffer& messageBuffer, MessageType msgType);
+	int						readData			(MessageType msgType, deUint8* dst, int numBytes);
 
 	bool					writeMessage		(ByteBuffer& messageBuffer, const Message& message);
 
@@ -36,6 +36,14 @@ public:
 	TestProcessException (const std::string& message) : std::runtime_error(message) {}
 };
 
+//! Notified by test process reader threads when new data can be read from the process.
+class TestProcessListener
+{
+public:
+	virtual					~TestProcessListener	(void) {}
+	virtual void			dataAvailable			(void) = DE_NULL;
+};
+
 class TestProcess
 {
 public:
@@ -51,6 +59,9 @@ public:
 	virtual int				readTestLog				(deUint8* dst, int numBytes)	= DE_NULL;
 	virtual int				readInfoLog				(deUint8* dst, int numBytes)	= DE_NULL;
 
+	//! Set listener for data notifications. Processes that do not support notifications must be polled.
+	virtual void			setListener				(TestProcessListener* listener)	{ DE_UNREF(listener); }
+
 protected:
 							TestProcess				(void) {}
 };
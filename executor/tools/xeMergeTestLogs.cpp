@@ -163,6 +163,7 @@ static void printHelp (const char* binName)
 	printf("%s: [filename] [[filename 2] ...]\n", binName);
 	printf("  --dst=[filename]    Write final log to file, otherwise written to stdout.\n");
 	printf("  --info=[first|last] Select which session info to use (default: first).\n");
+	printf("Source logs can be in text or binary (--deqp-log-format=binary) format. Final log is always text.\n");
 }
 
 static bool parseCommandLine (CommandLine& cmdLine, int argc, const char* const* argv)
@@ -0,0 +1,374 @@
+/*-------------------------------------------------------------------------
+ * drawElements Quality Program Test Executor
+ * ------------------------------------------
+ *
+ * Copyright (c) 2020 The Khronos Group Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *//*!
+ * \file
+ * \brief Binary test log decoder.
+ *//*--------------------------------------------------------------------*/
+
+#include "xeBinaryLogDecoder.hpp"
+#include "deInt32.h"
+
+#include <zlib.h>
+
+#include <cstring>
+
+using std::string;
+
+namespace xe
+{
+
+namespace
+{
+
+// \note Must match qpXmlWriter.h
+static const char	s_magic[]	= "qpBinLog";
+
+enum
+{
+	MAGIC_SIZE			= sizeof(s_magic) - 1,
+	HEADER_SIZE			= MAGIC_SIZE + 4,
+	RECORD_HEADER_SIZE	= 1 + 4,
+	FORMAT_VERSION		= 1,
+	MAX_DEFLATE_RATIO	= 1032		//!< Maximum compression ratio of deflate
+};
+
+enum RecordType
+{
+	RECORD_RAW = 0,
+	RECORD_START_DOCUMENT,
+	RECORD_END_DOCUMENT,
+	RECORD_START_ELEMENT,
+	RECORD_END_ELEMENT,
+	RECORD_STRING,
+	RECORD_BASE64,
+	RECORD_BASE64_DEFLATE,
+
+	RECORD_LAST
+};
+
+inline deUint32 readUint32 (const deUint8* ptr)
+{
+	return (deUint32)ptr[0] | ((deUint32)ptr[1] << 8) | ((deUint32)ptr[2] << 16) | ((deUint32)ptr[3] << 24);
+}
+
+class PayloadReader
+{
+public:
+	PayloadReader (const deUint8* data, size_t size)
+		: m_data	(data)
+		, m_size	(size)
+		, m_pos		(0)
+	{
+	}
+
+	deUint32 getUint32 (void)
+	{
+		check(4);
+		m_pos += 4;
+		return readUint32(m_data + m_pos - 4);
+	}
+
+	string getString (void)
+	{
+		const size_t len = (size_t)getUint32();
+
+		check(len);
+		m_pos += len;
+		return string((const char*)m_data + m_pos - len, len);
+	}
+
+	bool isEnd (void) const { return m_pos == m_size; }
+
+private:
+	void check (size_t numBytes) const
+	{
+		if (m_size - m_pos < numBytes)
+			throw BinaryLogParseError("Truncated record payload");
+	}
+
+	const deUint8* const	m_data;
+	const size_t			m_size;
+	size_t					m_pos;
+};
+
+// \note Escaping and indentation match qpXmlWriter.c
+void writeEscaped (const char* str, size_t len, string& dst)
+{
+	static const char* const s_controlNames[] =
+	{
+		DE_NULL, "SOH", "STX", "ETX", "EOT", "ENQ", "ACK", "BEL", "BS", DE_NULL, DE_NULL, "VT", "FF", DE_NULL, "SO", "SI",
+		"DLE", "DC1", "DC2", "DC3", "DC4", "NAK", "SYN", "ETB", "CAN", "EM", "SUB", "ESC", "FS", "GS", "RS", "US"
+	};
+
+	for (size_t ndx = 0; ndx < len; ndx++)
+	{
+		const char c = str[ndx];
+
+		switch (c)
+		{
+			case '<':	dst += "&lt;";		break;
+			case '>':	dst += "&gt;";		break;
+			case '&':	dst += "&amp;";		break;
+			case '\'':	dst += "&apos;";	break;
+			case '"':	dst += "&quot;";	break;
+
+			default:
+				if (c > 0 && c < 32 && s_controlNames[(int)c])
+				{
+					dst += "&lt;";
+					dst += s_controlNames[(int)c];
+					dst += "&gt;";
+				}
+				else if (c == 0)
+					return; // Text writer stops at terminator
+				else
+					dst += c;
+		}
+	}
+}
+
+inline void writeEscaped (const string& str, string& dst)
+{
+	writeEscaped(str.c_str(), str.size(), dst);
+}
+
+inline void writeIndent (int level, string& dst)
+{
+	dst.append((size_t)deMin32(32, level), ' ');
+}
+
+} // anonymous
+
+BinaryLogDecoder::MagicMatch BinaryLogDecoder::matchMagic (const deUint8* bytes, size_t numBytes)
+{
+	const size_t numCompared = de::min<size_t>(numBytes, MAGIC_SIZE);
+
+	if (std::memcmp(bytes, s_magic, numCompared) != 0)
+		return MAGIC_MISMATCH;
+
+	return numCompared == MAGIC_SIZE ? MAGIC_MATCH : MAGIC_PARTIAL;
+}
+
+BinaryLogDecoder::BinaryLogDecoder (void)
+{
+	clear();
+}
+
+BinaryLogDecoder::~BinaryLogDecoder (void)
+{
+}
+
+void BinaryLogDecoder::clear (void)
+{
+	m_buf.clear();
+	m_bufOffset				= 0;
+	m_headerParsed			= false;
+	m_prevIsStartElement	= false;
+	m_elementDepth			= 0;
+}
+
+void BinaryLogDecoder::decode (const deUint8* bytes, size_t numBytes, string& dst)
+{
+	m_buf.insert(m_buf.end(), bytes, bytes + numBytes);
+
+	if (!m_headerParsed)
+	{
+		if (m_buf.size() < HEADER_SIZE)
+			return;
+
+		if (matchMagic(&m_buf[0], m_buf.size()) != MAGIC_MATCH)
+			throw BinaryLogParseError("Not a binary test log");
+
+		if (readUint32(&m_buf[MAGIC_SIZE]) != FORMAT_VERSION)
+			throw BinaryLogParseError("Unsupported binary test log version");
+
+		m_bufOffset		= HEADER_SIZE;
+		m_headerParsed	= true;
+	}
+
+	while (m_buf.size() - m_bufOffset >= RECORD_HEADER_SIZE)
+	{
+		const deUint8* const	header		= &m_buf[m_bufOffset];
+		const size_t			payloadSize	= (size_t)readUint32(header + 1);
+
+		if (m_buf.size() - m_bufOffset - RECORD_HEADER_SIZE < payloadSize)
+			break;
+
+		decodeRecord((int)header[0], header + RECORD_HEADER_SIZE, payloadSize, dst);
+		m_bufOffset += RECORD_HEADER_SIZE + payloadSize;
+	}
+
+	// Drop consumed records.
+	m_buf.erase(m_buf.begin(), m_buf.begin() + (std::ptrdiff_t)m_bufOffset);
+	m_bufOffset = 0;
+}
+
+void BinaryLogDecoder::closePending (string& dst)
+{
+	if (m_prevIsStartElement)
+	{
+		dst += ">\n";
+		m_prevIsStartElement = false;
+	}
+}
+
+void BinaryLogDecoder::writeBase64 (const deUint8* data, size_t numBytes, string& dst)
+{
+	static const char s_base64Table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+	int		numWritten	= 0;
+	size_t	srcNdx		= 0;
+
+	closePending(dst);
+
+	while (srcNdx < numBytes)
+	{
+		const size_t	numRead	= de::min<size_t>(3, numBytes - srcNdx);
+		const deUint8	s0		= data[srcNdx];
+		const deUint8	s1		= (numRead >= 2) ? data[srcNdx+1] : 0;
+		const deUint8	s2		= (numRead >= 3) ? data[srcNdx+2] : 0;
+
+		srcNdx += numRead;
+
+		if (numWritten == 0)
+			writeIndent(m_elementDepth, dst);
+
+		dst += s_base64Table[s0 >> 2];
+		dst += s_base64Table[((s0&0x3)<<4) | (s1>>4)];
+		dst += (numRead < 2) ? '=' : s_base64Table[((s1&0xF)<<2) | (s2>>6)];
+		dst += (numRead < 3) ? '=' : s_base64Table[s2&0x3F];
+
+		numWritten += 4;
+		if (numWritten >= 64)
+		{
+			dst += '\n';
+			numWritten = 0;
+		}
+	}
+
+	if (numWritten > 0)
+		dst += '\n';
+}
+
+void BinaryLogDecoder::decodeRecord (int type, const deUint8* payload, size_t payloadSize, string& dst)
+{
+	const char* const chars = (const char*)payload;
+
+	switch (type)
+	{
+		case RECORD_RAW:
+			closePending(dst);
+			dst.append(chars, payloadSize);
+			break;
+
+		case RECORD_START_DOCUMENT:
+			m_elementDepth			= 0;
+			m_prevIsStartElement	= false;
+			dst += "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+			break;
+
+		case RECORD_END_DOCUMENT:
+			closePending(dst);
+			break;
+
+		case RECORD_START_ELEMENT:
+		{
+			PayloadReader	reader		(payload, payloadSize);
+			const string	name		= reader.getString();
+			const deUint32	numAttribs	= reader.getUint32();
+
+			closePending(dst);
+			writeIndent(m_elementDepth, dst);
+			dst += "<" + name;
+
+			for (deUint32 ndx = 0; ndx < numAttribs; ndx++)
+			{
+				const string attribName		= reader.getString();
+				const string attribValue	= reader.getString();
+
+				dst += " " + attribName + "=\"";
+				writeEscaped(attribValue, dst);
+				dst += "\"";
+			}
+
+			if (!reader.isEnd())
+				throw BinaryLogParseError("Invalid start element record");
+
+			m_elementDepth			+= 1;
+			m_prevIsStartElement	 = true;
+			break;
+		}
+
+		case RECORD_END_ELEMENT:
+			if (m_elementDepth == 0)
+				throw BinaryLogParseError("Unexpected end element record");
+
+			m_elementDepth -= 1;
+
+			if (m_prevIsStartElement)
+			{
+				dst += " />\n";
+				m_prevIsStartElement = false;
+			}
+			else
+			{
+				dst += "</";
+				dst.append(chars, payloadSize);
+				dst += ">\n";
+			}
+			break;
+
+		case RECORD_STRING:
+			if (m_prevIsStartElement)
+			{
+				dst += ">";
+				m_prevIsStartElement = false;
+			}
+
+			writeEscaped(chars, payloadSize, dst);
+			break;
+
+		case RECORD_BASE64:
+			writeBase64(payload, payloadSize, dst);
+			break;
+
+		case RECORD_BASE64_DEFLATE:
+		{
+			PayloadReader			reader		(payload, payloadSize);
+			uLongf					dataSize	= (uLongf)reader.getUint32();
+
+			// Size comes from the log, don't trust it before allocating
+			if ((deUint64)dataSize > (deUint64)(payloadSize - 4) * MAX_DEFLATE_RATIO)
+				throw BinaryLogParseError("Invalid data record size");
+
+			std::vector<deUint8>	data		(de::max<size_t>((size_t)dataSize, 1));
+
+			if (uncompress(&data[0], &dataSize, payload + 4, (uLong)(payloadSize - 4)) != Z_OK)
+				throw BinaryLogParseError("Failed to inflate data record");
+
+			writeBase64(&data[0], (size_t)dataSize, dst);
+			break;
+		}
+
+		default:
+			throw BinaryLogParseError("Unknown record type");
+	}
+}
+
+} // xe
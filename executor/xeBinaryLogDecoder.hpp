@@ -0,0 +1,92 @@
+#ifndef _XEBINARYLOGDECODER_HPP
+#define _XEBINARYLOGDECODER_HPP
+/*-------------------------------------------------------------------------
+ * drawElements Quality Program Test Executor
+ * ------------------------------------------
+ *
+ * Copyright (c) 2020 The Khronos Group Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *//*!
+ * \file
+ * \brief Binary test log decoder.
+ *//*--------------------------------------------------------------------*/
+
+#include "xeDefs.hpp"
+
+#include <string>
+#include <vector>
+
+namespace xe
+{
+
+class BinaryLogParseError : public ParseError
+{
+public:
+	BinaryLogParseError (const std::string& message) : ParseError(message) {}
+};
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Binary test log decoder
+ *
+ * Converts test log written with binary record encoding (see
+ * qpXmlWriter_createBinaryFileWriter()) back to the text format. The
+ * output is identical to what the text writer would have produced,
+ * except that deflated data blocks are written as base64 of the
+ * uncompressed data.
+ *
+ * Input can be fed in arbitrary chunks; only complete records are
+ * converted.
+ *//*--------------------------------------------------------------------*/
+class BinaryLogDecoder
+{
+public:
+	enum MagicMatch
+	{
+		MAGIC_MISMATCH = 0,		//!< Data is not a binary log.
+		MAGIC_PARTIAL,			//!< Not enough data to decide.
+		MAGIC_MATCH,			//!< Data starts with binary log magic.
+
+		MAGIC_LAST
+	};
+
+	static MagicMatch		matchMagic				(const deUint8* bytes, size_t numBytes);
+
+							BinaryLogDecoder		(void);
+							~BinaryLogDecoder		(void);
+
+	void					clear					(void);
+
+	//! Decode bytes and append text of all completed records to dst.
+	void					decode					(const deUint8* bytes, size_t numBytes, std::string& dst);
+
+private:
+							BinaryLogDecoder		(const BinaryLogDecoder& other);
+	BinaryLogDecoder&		operator=				(const BinaryLogDecoder& other);
+
+	void					decodeRecord			(int type, const deUint8* payload, size_t payloadSize, std::string& dst);
+	void					closePending			(std::string& dst);
+	void					writeBase64				(const deUint8* data, size_t numBytes, std::string& dst);
+
+	std::vector<deUint8>	m_buf;
+	size_t					m_bufOffset;
+	bool					m_headerParsed;
+
+	bool					m_prevIsStartElement;
+	int						m_elementDepth;
+};
+
+} // xe
+
+#endif // _XEBINARYLOGDECODER_HPP
@@ -25,6 +25,7 @@
 #include "xsProtocol.hpp"
 #include "deClock.h"
 #include "deInt32.h"
+#include "deMemory.h"
 
 namespace xe
 {
@@ -32,7 +33,9 @@ namespace xe
 enum
 {
 	SEND_BUFFER_BLOCK_SIZE		= 1024,
-	SEND_BUFFER_NUM_BLOCKS		= 64
+	SEND_BUFFER_NUM_BLOCKS		= 64,
+
+	RECV_BUFFER_SIZE			= 128*1024	//!< Initial receive buffer size, grown if larger messages are received.
 };
 
 // Utilities for writing messages out.
@@ -263,7 +266,8 @@ void TcpIpSendThread::stop (void)
 TcpIpRecvThread::TcpIpRecvThread (de::Socket& socket, TcpIpLinkState& state)
 	: m_socket		(socket)
 	, m_state		(state)
-	, m_curMsgPos	(0)
+	, m_recvBuf		(RECV_BUFFER_SIZE)
+	, m_recvPos		(0)
 	, m_isRunning	(false)
 {
 }
@@ -277,8 +281,8 @@ void TcpIpRecvThread::start (void)
 	DE_ASSERT(!m_isRunning);
 
 	// Reset state.
-	m_curMsgPos = 0;
-	m_isRunning = true;
+	m_recvPos	= 0;
+	m_isRunning	= true;
 
 	de::Thread::start();
 }
@@ -289,35 +293,45 @@ void TcpIpRecvThread::run (void)
 	{
 		for (;;)
 		{
-			bool				hasHeader		= m_curMsgPos >= xs::MESSAGE_HEADER_SIZE;
-			bool				hasPayload		= false;
-			size_t				messageSize		= 0;
-			xs::MessageType		messageType		= (xs::MessageType)0;
+			size_t numConsumed = 0;
 
-			if (hasHeader)
+			// Handle all complete messages in place. Receiving in large batches keeps the number of
+			// receive calls low and lets log data be passed on without copying it to message buffer.
+			while (m_recvPos-numConsumed >= (size_t)xs::MESSAGE_HEADER_SIZE)
 			{
-				xs::Message::parseHeader(&m_curMsgBuf[0], xs::MESSAGE_HEADER_SIZE, messageType, messageSize);
-				hasPayload = m_curMsgPos >= messageSize;
+				const deUint8* const	msgStart		= &m_recvBuf[numConsumed];
+				size_t					messageSize		= 0;
+				xs::MessageType			messageType		= (xs::MessageType)0;
+
+				xs::Message::parseHeader(msgStart, xs::MESSAGE_HEADER_SIZE, messageType, messageSize);
+				XE_CHECK_MSG(messageSize >= (size_t)xs::MESSAGE_HEADER_SIZE, "Invalid message size");
+
+				if (m_recvPos-numConsumed < messageSize)
+				{
+					// Grow buffer if message doesn't fit.
+					if (m_recvBuf.size() < messageSize)
+						m_recvBuf.resize(messageSize);
+					break;
+				}
+
+				handleMessage(messageType, messageSize > xs::MESSAGE_HEADER_SIZE ? msgStart+xs::MESSAGE_HEADER_SIZE : DE_NULL, messageSize-xs::MESSAGE_HEADER_SIZE);
+				numConsumed += messageSize;
 			}
 
-			if (hasPayload)
+			// Move partial message to the beginning of buffer.
+			if (numConsumed > 0)
 			{
-				// Process message.
-				handleMessage(messageType, m_curMsgPos > xs::MESSAGE_HEADER_SIZE ? &m_curMsgBuf[xs::MESSAGE_HEADER_SIZE] : DE_NULL, messageSize-xs::MESSAGE_HEADER_SIZE);
-				m_curMsgPos = 0;
+				if (numConsumed < m_recvPos)
+					deMemmove(&m_recvBuf[0], &m_recvBuf[numConsumed], m_recvPos-numConsumed);
+
+				m_recvPos -= numConsumed;
 			}
-			else
+
+			// Receive as many bytes as fit in buffer.
 			{
-				// Try to receive missing bytes.
-				size_t				curSize			= hasHeader ? messageSize : (size_t)xs::MESSAGE_HEADER_SIZE;
-				size_t				bytesToRecv		= curSize-m_curMsgPos;
+				size_t				bytesToRecv		= m_recvBuf.size()-m_recvPos;
 				size_t				numRecv			= 0;
-				deSocketResult		result			= DE_SOCKETRESULT_LAST;
-
-				if (m_curMsgBuf.size() < curSize)
-					m_curMsgBuf.resize(curSize);
-
-				result = m_socket.receive(&m_curMsgBuf[m_curMsgPos], bytesToRecv, &numRecv);
+				deSocketResult		result			= m_socket.receive(&m_recvBuf[m_recvPos], bytesToRecv, &numRecv);
 
 				if (result == DE_SOCKETRESULT_CONNECTION_CLOSED)
 					XE_FAIL("Connection closed");
@@ -335,8 +349,8 @@ void TcpIpRecvThread::run (void)
 				{
 					DE_ASSERT(result == DE_SOCKETRESULT_SUCCESS);
 					DE_ASSERT(numRecv <= bytesToRecv);
-					m_curMsgPos += numRecv;
-					// Continue receiving bytes / handle message in next iter.
+					m_recvPos += numRecv;
+					// Handle received messages in next iter.
 				}
 			}
 		}
@@ -109,8 +109,8 @@ private:
 	de::Socket&					m_socket;
 	TcpIpLinkState&				m_state;
 
-	std::vector<deUint8>		m_curMsgBuf;
-	size_t						m_curMsgPos;
+	std::vector<deUint8>		m_recvBuf;
+	size_t						m_recvPos;			//!< Number of received bytes in m_recvBuf.
 
 	bool						m_isRunning;
 };
@@ -32,7 +32,8 @@ namespace xe
 {
 
 TestLogParser::TestLogParser (TestLogHandler* handler)
-	: m_handler		(handler)
+	: m_format		(FORMAT_UNKNOWN)
+	, m_handler		(handler)
 	, m_inSession	(false)
 {
 }
@@ -43,6 +44,10 @@ TestLogParser::~TestLogParser (void)
 
 void TestLogParser::reset (void)
 {
+	m_format = FORMAT_UNKNOWN;
+	m_pending.clear();
+	m_binaryDecoder.clear();
+	m_decodedText.clear();
 	m_containerParser.clear();
 	m_currentCaseData.clear();
 	m_sessionInfo	= SessionInfo();
@@ -50,6 +55,41 @@ void TestLogParser::reset (void)
 }
 
 void TestLogParser::parse (const deUint8* bytes, size_t numBytes)
+{
+	if (m_format == FORMAT_UNKNOWN)
+	{
+		m_pending.insert(m_pending.end(), bytes, bytes + numBytes);
+
+		if (m_pending.empty())
+			return;
+
+		switch (BinaryLogDecoder::matchMagic(&m_pending[0], m_pending.size()))
+		{
+			case BinaryLogDecoder::MAGIC_PARTIAL:	return;
+			case BinaryLogDecoder::MAGIC_MATCH:		m_format = FORMAT_BINARY;	break;
+			default:								m_format = FORMAT_TEXT;		break;
+		}
+
+		std::vector<deUint8> pending;
+		pending.swap(m_pending);
+
+		parse(&pending[0], pending.size());
+		return;
+	}
+
+	if (m_format == FORMAT_BINARY)
+	{
+		m_decodedText.clear();
+		m_binaryDecoder.decode(bytes, numBytes, m_decodedText);
+
+		if (!m_decodedText.empty())
+			parseText((const deUint8*)m_decodedText.c_str(), m_decodedText.size());
+	}
+	else
+		parseText(bytes, numBytes);
+}
+
+void TestLogParser::parseText (const deUint8* bytes, size_t numBytes)
 {
 	m_containerParser.feed(bytes, numBytes);
 
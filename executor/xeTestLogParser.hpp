@@ -28,6 +28,7 @@
 #include "xeContainerFormatParser.hpp"
 #include "xeTestResultParser.hpp"
 #include "xeBatchResult.hpp"
+#include "xeBinaryLogDecoder.hpp"
 
 #include <string>
 #include <vector>
@@ -62,6 +63,22 @@ private:
 							TestLogParser			(const TestLogParser& other);
 	TestLogParser&			operator=				(const TestLogParser& other);
 
+	void					parseText				(const deUint8* bytes, size_t numBytes);
+
+	enum Format
+	{
+		FORMAT_UNKNOWN = 0,		//!< Not enough data received to detect format.
+		FORMAT_TEXT,
+		FORMAT_BINARY,
+
+		FORMAT_LAST
+	};
+
+	Format					m_format;
+	std::vector<deUint8>	m_pending;			//!< Data received before format was detected.
+	BinaryLogDecoder		m_binaryDecoder;
+	std::string				m_decodedText;
+
 	ContainerFormatParser	m_containerParser;
 	TestLogHandler*			m_handler;
 
@@ -24,6 +24,7 @@
 #include "vkBinaryRegistry.hpp"
 #include "tcuResource.hpp"
 #include "tcuFormatUtil.hpp"
+#include "gluShaderUtil.hpp"
 #include "deFilePath.hpp"
 #include "deStringUtil.hpp"
 #include "deDirectoryIterator.hpp"
@@ -106,27 +107,24 @@ string getIndexPath (const std::string& dirName)
 	return de::FilePath::join(dirName, "index.bin").getPath();
 }
 
-void writeBinary (const ProgramBinary& binary, const std::string& dstPath)
+string getSourceIndexPath (const std::string& dirName)
 {
-	const de::FilePath	filePath(dstPath);
-
-	if (!de::FilePath(filePath.getDirName()).exists())
-		de::createDirectoryAndParents(filePath.getDirName().c_str());
-
-	{
-		std::ofstream	out		(dstPath.c_str(), std::ios_base::binary);
+	return de::FilePath::join(dirName, "sources.bin").getPath();
+}
 
-		if (!out.is_open() || !out.good())
-			throw tcu::Exception("Failed to open " + dstPath);
+string getBlobPath (const std::string& dirName)
+{
+	return de::FilePath::join(dirName, "binaries.bin").getPath();
+}
 
-		out.write((const char*)binary.getBinary(), binary.getSize());
-		out.close();
-	}
+bool isBlobEntryTableValid (deUint32 numBinaries, size_t blobSize)
+{
+	return (deUint64)sizeof(BinaryBlobHeader) + (deUint64)numBinaries*sizeof(BinaryBlobEntry) <= (deUint64)blobSize;
 }
 
-void writeBinary (const std::string& dstDir, deUint32 index, const ProgramBinary& binary)
+bool isBlobEntryValid (const BinaryBlobEntry& entry, size_t blobSize)
 {
-	writeBinary(binary, getProgramPath(dstDir, index));
+	return entry.size > 0 && (entry.offset % (deUint32)sizeof(deUint32)) == 0 && (deUint64)entry.offset + entry.size <= (deUint64)blobSize;
 }
 
 ProgramBinary* readBinary (const std::string& srcPath)
@@ -177,7 +175,8 @@ std::vector<deUint32> getSearchPath (const ProgramIdentifier& id)
 	return words;
 }
 
-const deUint32* findBinaryIndex (BinaryIndexAccess* index, const ProgramIdentifier& id)
+template<typename IndexAccess>
+const deUint32* findBinaryIndex (IndexAccess* index, const ProgramIdentifier& id)
 {
 	const vector<deUint32>	words	= getSearchPath(id);
 	size_t					nodeNdx	= 0;
@@ -384,8 +383,64 @@ void buildBinaryIndex (std::vector<BinaryIndexNode>* dst, size_t numEntries, con
 	buildFinalIndex(dst, sparseIndex.get());
 }
 
+void addSources (std::ostringstream& key, const std::vector<std::string> (&sources)[glu::SHADERTYPE_LAST])
+{
+	for (int shaderType = 0; shaderType < glu::SHADERTYPE_LAST; shaderType++)
+	{
+		// Sources are prefixed with their length so that different splits of the same text give different keys
+		for (std::vector<std::string>::const_iterator srcIter = sources[shaderType].begin(); srcIter != sources[shaderType].end(); ++srcIter)
+			key << glu::getShaderTypeName((glu::ShaderType)shaderType) << " " << srcIter->size() << "\n" << *srcIter;
+	}
+}
+
+void addBuildOptions (std::ostringstream& key, const ShaderBuildOptions& buildOptions)
+{
+	key << "Vulkan " << buildOptions.vulkanVersion
+		<< ", SPIR-V " << (deUint32)buildOptions.targetVersion
+		<< ", flags " << buildOptions.flags
+		<< ", VK_KHR_spirv_1_4 " << buildOptions.supports_VK_KHR_spirv_1_4 << "\n";
+}
+
 } // anonymous
 
+// Program source hash
+
+ShaderCacheHash getProgramSourceHash (const std::string& environment, const GlslSource& source)
+{
+	std::ostringstream	key;
+
+	key << environment << "GLSL\n";
+	addBuildOptions(key, source.buildOptions);
+	addSources(key, source.sources);
+
+	return computeShaderCacheHash(key.str());
+}
+
+ShaderCacheHash getProgramSourceHash (const std::string& environment, const HlslSource& source)
+{
+	std::ostringstream	key;
+
+	key << environment << "HLSL\n";
+	addBuildOptions(key, source.buildOptions);
+	addSources(key, source.sources);
+
+	return computeShaderCacheHash(key.str());
+}
+
+ShaderCacheHash getProgramSourceHash (const std::string& environment, const SpirVAsmSource& source)
+{
+	std::ostringstream	key;
+
+	key << environment << "SPIR-V assembly\n"
+		<< "Vulkan " << source.buildOptions.vulkanVersion
+		<< ", SPIR-V " << (deUint32)source.buildOptions.targetVersion
+		<< ", VK_KHR_spirv_1_4 " << source.buildOptions.supports_VK_KHR_spirv_1_4
+		<< ", VK_KHR_maintenance4 " << source.buildOptions.supports_VK_KHR_maintenance4 << "\n"
+		<< source.source;
+
+	return computeShaderCacheHash(key.str());
+}
+
 // BinaryIndexHash
 
 DE_IMPLEMENT_POOL_HASH(BinaryIndexHashImpl, const ProgramBinary*, deUint32, binaryHash, binaryEqual);
@@ -433,6 +488,9 @@ void BinaryRegistryWriter::initFromPath (const std::string& srcPath)
 {
 	DE_ASSERT(m_binaries.empty());
 
+	if (de::FilePath(getBlobPath(srcPath)).exists())
+		readBlob(getBlobPath(srcPath));
+
 	for (de::DirectoryIterator iter(srcPath); iter.hasItem(); iter.next())
 	{
 		const de::FilePath	path		= iter.getItem();
@@ -441,6 +499,11 @@ void BinaryRegistryWriter::initFromPath (const std::string& srcPath)
 		if (isProgramFileName(baseName))
 		{
 			const deUint32						index	= getProgramIndexFromName(baseName);
+
+			// \note Separate binary files are left only by registries written before binary blob was introduced
+			if ((size_t)index < m_binaries.size() && m_binaries[index].binary)
+				continue;
+
 			const de::UniquePtr<ProgramBinary>	binary	(readBinary(path.getPath()));
 
 			addBinary(index, *binary);
@@ -448,6 +511,58 @@ void BinaryRegistryWriter::initFromPath (const std::string& srcPath)
 			//		 if binary is reused (added via addProgram()).
 		}
 	}
+
+	if (de::FilePath(getSourceIndexPath(srcPath)).exists())
+		readSourceIndex(getSourceIndexPath(srcPath));
+}
+
+void BinaryRegistryWriter::readBlob (const std::string& srcPath)
+{
+	const tcu::MappedFileResource	blob	(srcPath.c_str());
+	const deUint8* const			data	= blob.getData();
+	const size_t					size	= (size_t)blob.getSize();
+	BinaryBlobHeader				header;
+
+	if (size < sizeof(header))
+		throw tcu::Exception("Malformed binary blob " + srcPath);
+
+	deMemcpy(&header, data, sizeof(header));
+
+	if (header.magic != BINARY_BLOB_MAGIC || !isBlobEntryTableValid(header.numBinaries, size))
+		throw tcu::Exception("Malformed binary blob " + srcPath);
+
+	for (deUint32 index = 0; index < header.numBinaries; ++index)
+	{
+		const BinaryBlobEntry* const	entry	= (const BinaryBlobEntry*)(data + sizeof(BinaryBlobHeader)) + index;
+
+		if (entry->size == 0)
+			continue;
+
+		if (!isBlobEntryValid(*entry, size))
+			throw tcu::Exception("Malformed binary blob " + srcPath);
+
+		{
+			const de::UniquePtr<ProgramBinary>	binary	(ProgramBinary::createReference(vk::PROGRAM_FORMAT_SPIRV, entry->size, data + entry->offset));
+
+			addBinary(index, *binary);
+		}
+	}
+}
+
+void BinaryRegistryWriter::readSourceIndex (const std::string& srcPath)
+{
+	std::ifstream		in		(srcPath.c_str(), std::ios::binary);
+	SourceIndexEntry	entry;
+
+	if (!in.is_open() || !in.good())
+		throw tcu::Exception("Failed to open " + srcPath);
+
+	while (in.read((char*)&entry, sizeof(entry)))
+	{
+		// Binaries that were removed after previous build are simply rebuilt
+		if ((size_t)entry.index < m_binaries.size() && m_binaries[entry.index].binary)
+			m_prevSourceIndices[entry.sourceHash] = entry.index;
+	}
 }
 
 void BinaryRegistryWriter::addProgram (const ProgramIdentifier& id, const ProgramBinary& binary)
@@ -465,6 +580,19 @@ void BinaryRegistryWriter::addProgram (const ProgramIdentifier& id, const Progra
 	m_binaryIndices.push_back(ProgramIdentifierIndex(id, index));
 }
 
+void BinaryRegistryWriter::addProgram (const ProgramIdentifier& id, const ProgramBinary& binary, const ShaderCacheHash& sourceHash)
+{
+	addProgram(id, binary);
+	m_sourceIndices[sourceHash] = m_binaryIndices.back().index;
+}
+
+const ProgramBinary* BinaryRegistryWriter::findPreviousBinary (const ShaderCacheHash& sourceHash) const
+{
+	const SourceIndexMap::const_iterator	pos	= m_prevSourceIndices.find(sourceHash);
+
+	return pos != m_prevSourceIndices.end() ? m_binaries[pos->second].binary : DE_NULL;
+}
+
 deUint32* BinaryRegistryWriter::findBinary (const ProgramBinary& binary) const
 {
 	return m_binaryHash.find(&binary);
@@ -517,25 +645,83 @@ void BinaryRegistryWriter::writeToPath (const std::string& dstPath) const
 	if (!de::FilePath(dstPath).exists())
 		de::createDirectoryAndParents(dstPath.c_str());
 
-	DE_ASSERT(m_binaries.size() <= 0xffffffffu);
-	for (size_t binaryNdx = 0; binaryNdx < m_binaries.size(); ++binaryNdx)
+	// Write binary blob
 	{
-		const BinarySlot&	slot	= m_binaries[binaryNdx];
+		const string					blobPath	= getBlobPath(dstPath);
+		const deUint8					padding[sizeof(deUint32)]	= { 0, 0, 0, 0 };
+		BinaryBlobHeader				header;
+		std::vector<BinaryBlobEntry>	entries		(m_binaries.size());
+		deUint64						offset		= sizeof(BinaryBlobHeader) + entries.size()*sizeof(BinaryBlobEntry);
+
+		DE_ASSERT(m_binaries.size() <= 0xffffffffu);
 
-		if (slot.referenceCount > 0)
+		header.magic		= BINARY_BLOB_MAGIC;
+		header.numBinaries	= (deUint32)m_binaries.size();
+
+		for (size_t binaryNdx = 0; binaryNdx < m_binaries.size(); ++binaryNdx)
 		{
-			DE_ASSERT(slot.binary);
-			writeBinary(dstPath, (deUint32)binaryNdx, *slot.binary);
+			const BinarySlot&	slot	= m_binaries[binaryNdx];
+
+			// \note Unreferenced binaries are dropped
+			if (slot.referenceCount > 0)
+			{
+				DE_ASSERT(slot.binary);
+
+				entries[binaryNdx].offset	= (deUint32)offset;
+				entries[binaryNdx].size		= (deUint32)slot.binary->getSize();
+
+				offset = deAlign64(offset + slot.binary->getSize(), sizeof(deUint32));
+
+				if (offset > 0xffffffffu)
+					throw tcu::InternalError("Program binaries don't fit in binary blob");
+			}
+			else
+			{
+				entries[binaryNdx].offset	= 0;
+				entries[binaryNdx].size		= 0;
+			}
 		}
-		else
+
 		{
-			// Delete stale binary if such exists
-			const std::string	progPath	= getProgramPath(dstPath, (deUint32)binaryNdx);
+			std::ofstream	blobOut	(blobPath.c_str(), std::ios_base::binary);
+
+			if (!blobOut.is_open() || !blobOut.good())
+				throw tcu::InternalError(string("Failed to open program binary blob ") + blobPath);
+
+			blobOut.write((const char*)&header, sizeof(header));
 
-			if (de::FilePath(progPath).exists())
-				deDeleteFile(progPath.c_str());
+			if (!entries.empty())
+				blobOut.write((const char*)&entries[0], entries.size()*sizeof(BinaryBlobEntry));
+
+			for (size_t binaryNdx = 0; binaryNdx < m_binaries.size(); ++binaryNdx)
+			{
+				if (entries[binaryNdx].size > 0)
+				{
+					const ProgramBinary&	binary		= *m_binaries[binaryNdx].binary;
+					const size_t			paddingSize	= deAlign64(binary.getSize(), sizeof(deUint32)) - binary.getSize();
+
+					blobOut.write((const char*)binary.getBinary(), binary.getSize());
+					blobOut.write((const char*)padding, paddingSize);
+				}
+			}
+
+			if (!blobOut.good())
+				throw tcu::InternalError(string("Failed to write program binary blob ") + blobPath);
 		}
+	}
 
+	// Delete binaries stored in separate files, blob supersedes them
+	{
+		std::vector<string>	programPaths;
+
+		for (de::DirectoryIterator iter(dstPath); iter.hasItem(); iter.next())
+		{
+			if (isProgramFileName(iter.getItem().getBaseName()))
+				programPaths.push_back(iter.getItem().getPath());
+		}
+
+		for (std::vector<string>::const_iterator pathIter = programPaths.begin(); pathIter != programPaths.end(); ++pathIter)
+			deDeleteFile(pathIter->c_str());
 	}
 
 	// Write index
@@ -560,13 +746,35 @@ void BinaryRegistryWriter::writeToPath (const std::string& dstPath) const
 			indexOut.write((const char*)&index[0], index.size()*sizeof(BinaryIndexNode));
 		}
 	}
+
+	// Write source index
+	{
+		const string		sourceIndexPath	= getSourceIndexPath(dstPath);
+		std::ofstream		sourceIndexOut	(sourceIndexPath.c_str(), std::ios_base::binary);
+
+		if (!sourceIndexOut.is_open() || !sourceIndexOut.good())
+			throw tcu::InternalError(string("Failed to open program source index file ") + sourceIndexPath);
+
+		for (SourceIndexMap::const_iterator sourceIter = m_sourceIndices.begin(); sourceIter != m_sourceIndices.end(); ++sourceIter)
+		{
+			SourceIndexEntry	entry;
+
+			entry.sourceHash	= sourceIter->first;
+			entry.index			= sourceIter->second;
+
+			sourceIndexOut.write((const char*)&entry, sizeof(entry));
+		}
+	}
 }
 
 // BinaryRegistryReader
 
 BinaryRegistryReader::BinaryRegistryReader (const tcu::Archive& archive, const std::string& srcPath)
-	: m_archive	(archive)
-	, m_srcPath	(srcPath)
+	: m_archive			(archive)
+	, m_srcPath			(srcPath)
+	, m_blobOpened		(false)
+	, m_blobEntries		(DE_NULL)
+	, m_numBlobEntries	(0)
 {
 }
 
@@ -574,13 +782,129 @@ BinaryRegistryReader::~BinaryRegistryReader (void)
 {
 }
 
+void BinaryRegistryReader::openIndex (void) const
+{
+	ResourcePtr	resource	(m_archive.getMappedResource(getIndexPath(m_srcPath).c_str()));
+
+	if (resource->getData())
+	{
+		const size_t	size	= (size_t)resource->getSize();
+
+		TCU_CHECK_INTERNAL(size % sizeof(BinaryIndexNode) == 0);
+
+		m_mappedBinaryIndex	= MappedBinaryIndexPtr(new MappedBinaryIndexAccess((const BinaryIndexNode*)resource->getData(), size / sizeof(BinaryIndexNode)));
+		m_indexResource		= resource;
+	}
+	else
+		m_binaryIndex = BinaryIndexPtr(new BinaryIndexAccess(resource));
+}
+
+void BinaryRegistryReader::openBlob (void) const
+{
+	ResourcePtr	resource;
+
+	try
+	{
+		resource = ResourcePtr(m_archive.getMappedResource(getBlobPath(m_srcPath).c_str()));
+	}
+	catch (const tcu::ResourceError&)
+	{
+		// Binaries are stored in separate files
+		m_blobOpened = true;
+		return;
+	}
+
+	{
+		const deUint8* const	data	= resource->getData();
+		const size_t			size	= (size_t)resource->getSize();
+		BinaryBlobHeader		header;
+
+		TCU_CHECK_INTERNAL(size >= sizeof(header));
+
+		if (data)
+			deMemcpy(&header, data, sizeof(header));
+		else
+		{
+			resource->setPosition(0);
+			resource->read((deUint8*)&header, (int)sizeof(header));
+		}
+
+		TCU_CHECK_INTERNAL(header.magic == BINARY_BLOB_MAGIC && isBlobEntryTableValid(header.numBinaries, size));
+
+		if (data)
+			m_blobEntries = (const BinaryBlobEntry*)(data + sizeof(BinaryBlobHeader));
+		else
+		{
+			m_blobEntryCopy.resize(header.numBinaries);
+
+			if (!m_blobEntryCopy.empty())
+				resource->read((deUint8*)&m_blobEntryCopy[0], (int)(m_blobEntryCopy.size()*sizeof(BinaryBlobEntry)));
+
+			m_blobEntries = !m_blobEntryCopy.empty() ? &m_blobEntryCopy[0] : DE_NULL;
+		}
+
+		m_numBlobEntries	= header.numBinaries;
+		m_blobResource		= resource;
+		m_blobOpened		= true;
+	}
+}
+
+const deUint32* BinaryRegistryReader::findIndex (const ProgramIdentifier& id) const
+{
+	if (m_mappedBinaryIndex)
+		return findBinaryIndex(m_mappedBinaryIndex.get(), id);
+	else
+		return findBinaryIndex(m_binaryIndex.get(), id);
+}
+
+ProgramBinary* BinaryRegistryReader::loadBinary (deUint32 index) const
+{
+	if (!m_blobOpened)
+		openBlob();
+
+	if (m_blobResource)
+	{
+		TCU_CHECK_INTERNAL(index < m_numBlobEntries);
+
+		const BinaryBlobEntry&	entry	= m_blobEntries[index];
+		const deUint8* const	data	= m_blobResource->getData();
+
+		TCU_CHECK_INTERNAL(isBlobEntryValid(entry, (size_t)m_blobResource->getSize()));
+
+		if (data)
+			return ProgramBinary::createReference(vk::PROGRAM_FORMAT_SPIRV, entry.size, data + entry.offset);
+		else
+		{
+			vector<deUint8>	bytes	(entry.size);
+
+			m_blobResource->setPosition((int)entry.offset);
+			m_blobResource->read(&bytes[0], (int)bytes.size());
+
+			return new ProgramBinary(vk::PROGRAM_FORMAT_SPIRV, bytes.size(), &bytes[0]);
+		}
+	}
+	else
+	{
+		const string					fullPath	= getProgramPath(m_srcPath, index);
+		de::UniquePtr<tcu::Resource>	progRes		(m_archive.getResource(fullPath.c_str()));
+		const int						progSize	= progRes->getSize();
+		vector<deUint8>					bytes		(progSize);
+
+		TCU_CHECK_INTERNAL(!bytes.empty());
+
+		progRes->read(&bytes[0], progSize);
+
+		return new ProgramBinary(vk::PROGRAM_FORMAT_SPIRV, bytes.size(), &bytes[0]);
+	}
+}
+
 ProgramBinary* BinaryRegistryReader::loadProgram (const ProgramIdentifier& id) const
 {
-	if (!m_binaryIndex)
+	if (!m_mappedBinaryIndex && !m_binaryIndex)
 	{
 		try
 		{
-			m_binaryIndex = BinaryIndexPtr(new BinaryIndexAccess(de::MovePtr<tcu::Resource>(m_archive.getResource(getIndexPath(m_srcPath).c_str()))));
+			openIndex();
 		}
 		catch (const tcu::ResourceError& e)
 		{
@@ -589,23 +913,13 @@ ProgramBinary* BinaryRegistryReader::loadProgram (const ProgramIdentifier& id) c
 	}
 
 	{
-		const deUint32*	indexPos	= findBinaryIndex(m_binaryIndex.get(), id);
+		const deUint32*	indexPos	= findIndex(id);
 
 		if (indexPos)
 		{
-			const string	fullPath	= getProgramPath(m_srcPath, *indexPos);
-
 			try
 			{
-				de::UniquePtr<tcu::Resource>	progRes		(m_archive.getResource(fullPath.c_str()));
-				const int						progSize	= progRes->getSize();
-				vector<deUint8>					bytes		(progSize);
-
-				TCU_CHECK_INTERNAL(!bytes.empty());
-
-				progRes->read(&bytes[0], progSize);
-
-				return new ProgramBinary(vk::PROGRAM_FORMAT_SPIRV, bytes.size(), &bytes[0]);
+				return loadBinary(*indexPos);
 			}
 			catch (const tcu::ResourceError& e)
 			{
@@ -618,4 +932,430 @@ ProgramBinary* BinaryRegistryReader::loadProgram (const ProgramIdentifier& id) c
 }
 
 } // BinaryRegistryDetail
+
+// Self-test
+
+namespace
+{
+
+using namespace BinaryRegistryDetail;
+
+ProgramBinary* makeTestBinary (deUint32 seed, size_t numWords)
+{
+	std::vector<deUint32>	words	(numWords);
+
+	// \note First byte must be non-zero, see readBinary()
+	words[0] = 0x07230203u;
+
+	for (size_t ndx = 1; ndx < numWords; ndx++)
+		words[ndx] = deUint32Hash(seed ^ (deUint32)ndx);
+
+	return new ProgramBinary(PROGRAM_FORMAT_SPIRV, words.size()*sizeof(deUint32), (const deUint8*)&words[0]);
+}
+
+bool isBinaryEqual (const ProgramBinary* a, const ProgramBinary* b)
+{
+	return a && b && binaryEqual(a, b);
+}
+
+void deleteRegistryFiles (const std::string& path)
+{
+	if (!de::FilePath(path).exists())
+		return;
+
+	{
+		std::vector<std::string>	files;
+
+		for (de::DirectoryIterator iter(path); iter.hasItem(); iter.next())
+			files.push_back(iter.getItem().getPath());
+
+		for (std::vector<std::string>::const_iterator fileIter = files.begin(); fileIter != files.end(); ++fileIter)
+			deDeleteFile(fileIter->c_str());
+	}
+
+	// \note There is no portable directory removal in delibs, the empty directory is left behind
+}
+
+void sourceHashSelfTest (void)
+{
+	const std::string	env		= "glslang 1\nspirv-tools 1\n";
+	GlslSource			base;
+
+	base << glu::VertexSource("#version 450\nvoid main (void) {}\n")
+		 << ShaderBuildOptions(VK_MAKE_VERSION(1, 0, 0), SPIRV_VERSION_1_0, 0u);
+
+	const ShaderCacheHash	baseHash	= getProgramSourceHash(env, base);
+
+	DE_TEST_ASSERT(getProgramSourceHash(env, base) == baseHash);
+
+	// Changed source
+	{
+		GlslSource	changed	= base;
+		changed.sources[glu::SHADERTYPE_VERTEX][0] += " ";
+		DE_TEST_ASSERT(!(getProgramSourceHash(env, changed) == baseHash));
+	}
+
+	// Same source in a different stage
+	{
+		GlslSource	changed;
+		changed.buildOptions = base.buildOptions;
+		changed.sources[glu::SHADERTYPE_FRAGMENT] = base.sources[glu::SHADERTYPE_VERTEX];
+		DE_TEST_ASSERT(!(getProgramSourceHash(env, changed) == baseHash));
+	}
+
+	// Same text split differently
+	{
+		GlslSource	a;
+		GlslSource	b;
+		a << glu::VertexSource("ab") << glu::VertexSource("c");
+		b << glu::VertexSource("a") << glu::VertexSource("bc");
+		DE_TEST_ASSERT(!(getProgramSourceHash(env, a) == getProgramSourceHash(env, b)));
+	}
+
+	// Changed build options
+	{
+		GlslSource	changed	= base;
+		changed.buildOptions.flags = ShaderBuildOptions::FLAG_USE_STORAGE_BUFFER_STORAGE_CLASS;
+		DE_TEST_ASSERT(!(getProgramSourceHash(env, changed) == baseHash));
+	}
+	{
+		GlslSource	changed	= base;
+		changed.buildOptions.targetVersion = SPIRV_VERSION_1_3;
+		DE_TEST_ASSERT(!(getProgramSourceHash(env, changed) == baseHash));
+	}
+	{
+		GlslSource	changed	= base;
+		changed.buildOptions.supports_VK_KHR_spirv_1_4 = true;
+		DE_TEST_ASSERT(!(getProgramSourceHash(env, changed) == baseHash));
+	}
+
+	// Changed compiler
+	DE_TEST_ASSERT(!(getProgramSourceHash("glslang 2\nspirv-tools 1\n", base) == baseHash));
+
+	// Same sources as HLSL
+	{
+		HlslSource	hlsl;
+		hlsl.buildOptions = base.buildOptions;
+		hlsl.sources[glu::SHADERTYPE_VERTEX] = base.sources[glu::SHADERTYPE_VERTEX];
+		DE_TEST_ASSERT(!(getProgramSourceHash(env, hlsl) == baseHash));
+	}
+
+	// SPIR-V assembly
+	{
+		SpirVAsmSource			asmSource	("OpCapability Shader\n");
+		const ShaderCacheHash	asmHash		= getProgramSourceHash(env, asmSource);
+		SpirVAsmSource			changedSrc	= asmSource;
+		SpirVAsmSource			changedOpt	= asmSource;
+
+		changedSrc.source += "OpMemoryModel Logical GLSL450\n";
+		changedOpt.buildOptions.supports_VK_KHR_maintenance4 = true;
+
+		DE_TEST_ASSERT(getProgramSourceHash(env, asmSource) == asmHash);
+		DE_TEST_ASSERT(!(getProgramSourceHash(env, changedSrc) == asmHash));
+		DE_TEST_ASSERT(!(getProgramSourceHash(env, changedOpt) == asmHash));
+	}
+}
+
+void incrementalBuildSelfTest (void)
+{
+	const std::string					path		= "vk-binary-registry-selftest";
+	const std::string					env			= "glslang 1\nspirv-tools 1\n";
+	const ProgramIdentifier				idA			("dEQP-VK.selftest.a", "vert");
+	const ProgramIdentifier				idB			("dEQP-VK.selftest.b", "vert");
+	const de::UniquePtr<ProgramBinary>	binaryA		(makeTestBinary(1u, 16));
+	const de::UniquePtr<ProgramBinary>	binaryB		(makeTestBinary(2u, 24));
+	GlslSource							sourceA;
+	GlslSource							sourceB;
+
+	sourceA << glu::VertexSource("#version 450\nvoid main (void) { gl_Position = vec4(0.0); }\n");
+	sourceB << glu::VertexSource("#version 450\nvoid main (void) { gl_Position = vec4(1.0); }\n");
+
+	const ShaderCacheHash				hashA		= getProgramSourceHash(env, sourceA);
+	const ShaderCacheHash				hashB		= getProgramSourceHash(env, sourceB);
+
+	deleteRegistryFiles(path);
+
+	// First build
+	{
+		BinaryRegistryWriter	writer	(path);
+
+		DE_TEST_ASSERT(!writer.findPreviousBinary(hashA));
+
+		writer.addProgram(idA, *binaryA, hashA);
+		writer.addProgram(idB, *binaryB, hashB);
+		writer.write();
+	}
+
+	// Rebuild: unchanged program is reused, any change forces recompilation
+	{
+		BinaryRegistryWriter	writer	(path);
+		GlslSource				changedSource	= sourceA;
+		GlslSource				changedOptions	= sourceA;
+
+		changedSource.sources[glu::SHADERTYPE_VERTEX][0] += "\n";
+		changedOptions.buildOptions.flags = ShaderBuildOptions::FLAG_ALLOW_RELAXED_OFFSETS;
+
+		DE_TEST_ASSERT(isBinaryEqual(writer.findPreviousBinary(hashA), binaryA.get()));
+		DE_TEST_ASSERT(isBinaryEqual(writer.findPreviousBinary(hashB), binaryB.get()));
+		DE_TEST_ASSERT(!writer.findPreviousBinary(getProgramSourceHash(env, changedSource)));
+		DE_TEST_ASSERT(!writer.findPreviousBinary(getProgramSourceHash(env, changedOptions)));
+		DE_TEST_ASSERT(!writer.findPreviousBinary(getProgramSourceHash("glslang 2\nspirv-tools 1\n", sourceA)));
+
+		// Only A is part of this build
+		writer.addProgram(idA, *writer.findPreviousBinary(hashA), hashA);
+		writer.write();
+	}
+
+	// Programs dropped from the previous build are not reused
+	{
+		BinaryRegistryWriter	writer	(path);
+
+		DE_TEST_ASSERT(isBinaryEqual(writer.findPreviousBinary(hashA), binaryA.get()));
+		DE_TEST_ASSERT(!writer.findPreviousBinary(hashB));
+	}
+
+	deleteRegistryFiles(path);
+}
+
+//! Archive without memory-mapping support, resources are read through Resource::read().
+class UnmappedDirArchive : public tcu::Archive
+{
+public:
+						UnmappedDirArchive	(const char* path) : m_archive(path) {}
+
+	tcu::Resource*		getResource			(const char* name) const { return m_archive.getResource(name); }
+
+private:
+	tcu::DirArchive		m_archive;
+};
+
+void writeFile (const std::string& path, const void* data, size_t size)
+{
+	std::ofstream	out	(path.c_str(), std::ios_base::binary);
+
+	out.write((const char*)data, (std::streamsize)size);
+	DE_TEST_ASSERT(out.good());
+}
+
+std::vector<deUint8> readFile (const std::string& path)
+{
+	std::ifstream			in		(path.c_str(), std::ios_base::binary);
+	std::vector<deUint8>	data;
+
+	DE_TEST_ASSERT(in.good());
+
+	in.seekg(0, std::ios_base::end);
+	data.resize((size_t)in.tellg());
+	in.seekg(0, std::ios_base::beg);
+
+	if (!data.empty())
+		in.read((char*)&data[0], (std::streamsize)data.size());
+
+	DE_TEST_ASSERT(in.good());
+
+	return data;
+}
+
+int countProgramFiles (const std::string& path)
+{
+	int numFiles = 0;
+
+	for (de::DirectoryIterator iter(path); iter.hasItem(); iter.next())
+	{
+		if (isProgramFileName(iter.getItem().getBaseName()))
+			numFiles++;
+	}
+
+	return numFiles;
+}
+
+bool isProgramLoadable (const tcu::Archive& archive, const std::string& path, const ProgramIdentifier& id, const ProgramBinary* expected)
+{
+	const BinaryRegistryReader			reader	(archive, path);
+	const de::UniquePtr<ProgramBinary>	binary	(reader.loadProgram(id));
+
+	return isBinaryEqual(binary.get(), expected);
+}
+
+bool isProgramMissing (const tcu::Archive& archive, const std::string& path, const ProgramIdentifier& id)
+{
+	const BinaryRegistryReader	reader	(archive, path);
+
+	try
+	{
+		delete reader.loadProgram(id);
+		return false;
+	}
+	catch (const ProgramNotFoundException&)
+	{
+		return true;
+	}
+}
+
+bool isBlobRejected (const tcu::Archive& archive, const std::string& path, const ProgramIdentifier& id)
+{
+	try
+	{
+		BinaryRegistryWriter	writer	(path);
+		return false;
+	}
+	catch (const tcu::Exception&)
+	{
+	}
+
+	try
+	{
+		const BinaryRegistryReader	reader	(archive, path);
+		delete reader.loadProgram(id);
+		return false;
+	}
+	catch (const ProgramNotFoundException&)
+	{
+		return false;
+	}
+	catch (const tcu::Exception&)
+	{
+		return true;
+	}
+}
+
+void roundTripSelfTest (void)
+{
+	const std::string					path		= "vk-binary-registry-roundtrip-selftest";
+	const std::string					env			= "glslang 1\nspirv-tools 1\n";
+	const tcu::DirArchive				mapped		("");
+	const UnmappedDirArchive			unmapped	("");
+	const tcu::Archive* const			archives[]	= { &mapped, &unmapped };
+	const ProgramIdentifier				idA			("dEQP-VK.selftest.a", "vert");
+	const ProgramIdentifier				idB			("dEQP-VK.selftest.b", "frag");
+	const ProgramIdentifier				idC			("dEQP-VK.selftest.c", "vert");
+	const ProgramIdentifier				idMissing	("dEQP-VK.selftest.d", "vert");
+	const de::UniquePtr<ProgramBinary>	binaryA		(makeTestBinary(1u, 16));
+	const de::UniquePtr<ProgramBinary>	binaryB		(makeTestBinary(2u, 37));
+	const ShaderCacheHash				hashA		= getProgramSourceHash(env, SpirVAsmSource("OpCapability Shader\n"));
+	const ShaderCacheHash				hashB		= getProgramSourceHash(env, SpirVAsmSource("OpCapability Kernel\n"));
+
+	deleteRegistryFiles(path);
+
+	{
+		BinaryRegistryWriter	writer	(path);
+
+		writer.addProgram(idA, *binaryA, hashA);
+		writer.addProgram(idB, *binaryB, hashB);
+		writer.addProgram(idC, *binaryA, hashA);
+		writer.write();
+	}
+
+	// Blob registry through mapped and non-mapped resources
+	for (int archiveNdx = 0; archiveNdx < DE_LENGTH_OF_ARRAY(archives); archiveNdx++)
+	{
+		const tcu::Archive&	archive	= *archives[archiveNdx];
+
+		DE_TEST_ASSERT(isProgramLoadable(archive, path, idA, binaryA.get()));
+		DE_TEST_ASSERT(isProgramLoadable(archive, path, idB, binaryB.get()));
+		DE_TEST_ASSERT(isProgramLoadable(archive, path, idC, binaryA.get()));
+		DE_TEST_ASSERT(isProgramMissing(archive, path, idMissing));
+	}
+
+	DE_TEST_ASSERT(countProgramFiles(path) == 0);
+
+	// Registry written before binary blob was introduced, with binaries in separate .spv files
+	{
+		const std::vector<deUint8>	blob	= readFile(getBlobPath(path));
+		BinaryBlobHeader			header;
+
+		DE_TEST_ASSERT(blob.size() >= sizeof(header));
+		deMemcpy(&header, &blob[0], sizeof(header));
+
+		for (deUint32 index = 0; index < header.numBinaries; index++)
+		{
+			BinaryBlobEntry entry;
+
+			deMemcpy(&entry, &blob[sizeof(header) + index*sizeof(entry)], sizeof(entry));
+
+			if (entry.size > 0)
+				writeFile(getProgramPath(path, index), &blob[entry.offset], entry.size);
+		}
+
+		deDeleteFile(getBlobPath(path).c_str());
+		DE_TEST_ASSERT(countProgramFiles(path) == 2);
+	}
+
+	for (int archiveNdx = 0; archiveNdx < DE_LENGTH_OF_ARRAY(archives); archiveNdx++)
+	{
+		const tcu::Archive&	archive	= *archives[archiveNdx];
+
+		DE_TEST_ASSERT(isProgramLoadable(archive, path, idA, binaryA.get()));
+		DE_TEST_ASSERT(isProgramLoadable(archive, path, idB, binaryB.get()));
+		DE_TEST_ASSERT(isProgramLoadable(archive, path, idC, binaryA.get()));
+		DE_TEST_ASSERT(isProgramMissing(archive, path, idMissing));
+	}
+
+	// Rewriting an old registry reuses its binaries and replaces .spv files with a blob
+	{
+		BinaryRegistryWriter	writer	(path);
+
+		DE_TEST_ASSERT(isBinaryEqual(writer.findPreviousBinary(hashA), binaryA.get()));
+		DE_TEST_ASSERT(isBinaryEqual(writer.findPreviousBinary(hashB), binaryB.get()));
+
+		writer.addProgram(idA, *writer.findPreviousBinary(hashA), hashA);
+		writer.addProgram(idB, *writer.findPreviousBinary(hashB), hashB);
+		writer.write();
+	}
+
+	DE_TEST_ASSERT(countProgramFiles(path) == 0);
+
+	for (int archiveNdx = 0; archiveNdx < DE_LENGTH_OF_ARRAY(archives); archiveNdx++)
+	{
+		DE_TEST_ASSERT(isProgramLoadable(*archives[archiveNdx], path, idA, binaryA.get()));
+		DE_TEST_ASSERT(isProgramLoadable(*archives[archiveNdx], path, idB, binaryB.get()));
+		DE_TEST_ASSERT(isProgramMissing(*archives[archiveNdx], path, idC));
+	}
+
+	// Malformed blobs are rejected by both writer and reader
+	{
+		const std::vector<deUint8>	blob	= readFile(getBlobPath(path));
+		BinaryBlobHeader			header;
+
+		DE_TEST_ASSERT(blob.size() >= sizeof(header));
+		deMemcpy(&header, &blob[0], sizeof(header));
+		DE_TEST_ASSERT(header.numBinaries > 0);
+
+		for (int caseNdx = 0; caseNdx < 4; caseNdx++)
+		{
+			std::vector<deUint8>	malformed	= blob;
+			BinaryBlobHeader* const	badHeader	= (BinaryBlobHeader*)&malformed[0];
+			BinaryBlobEntry* const	badEntries	= (BinaryBlobEntry*)&malformed[sizeof(header)];
+
+			if (caseNdx == 0)
+				badHeader->magic ^= 1u;								// Wrong magic
+			else if (caseNdx == 1)
+				badHeader->numBinaries = 0x10000000u;				// Entry table past end of file
+			else if (caseNdx == 2)
+			{
+				for (deUint32 index = 0; index < header.numBinaries; index++)
+					badEntries[index].offset = (deUint32)blob.size() - 1u;	// Binaries past end of file
+			}
+			else
+				malformed.resize(sizeof(header) - 1u);				// Truncated header
+
+			writeFile(getBlobPath(path), &malformed[0], malformed.size());
+
+			for (int archiveNdx = 0; archiveNdx < DE_LENGTH_OF_ARRAY(archives); archiveNdx++)
+				DE_TEST_ASSERT(isBlobRejected(*archives[archiveNdx], path, idA));
+		}
+	}
+
+	deleteRegistryFiles(path);
+}
+
+} // anonymous
+
+void binaryRegistrySelfTest (void)
+{
+	sourceHashSelfTest();
+	incrementalBuildSelfTest();
+	roundTripSelfTest();
+}
+
 } // vk
@@ -25,6 +25,7 @@
 
 #include "vkDefs.hpp"
 #include "vkPrograms.hpp"
+#include "vkShaderCache.hpp"
 #include "tcuResource.hpp"
 #include "deMemPool.hpp"
 #include "dePoolHash.h"
@@ -170,21 +171,93 @@ void LazyResource<Element>::makePageResident (size_t pageNdx)
 
 typedef LazyResource<BinaryIndexNode> BinaryIndexAccess;
 
+//! Index accessed in place from memory mapped index file.
+class MappedBinaryIndexAccess
+{
+public:
+									MappedBinaryIndexAccess	(const BinaryIndexNode* nodes, size_t numNodes)
+										: m_nodes		(nodes)
+										, m_numNodes	(numNodes)
+									{}
+
+	const BinaryIndexNode&			operator[]				(size_t ndx) const
+	{
+		if (ndx >= m_numNodes)
+			throw std::out_of_range("");
+
+		return m_nodes[ndx];
+	}
+
+	size_t							size					(void) const { return m_numNodes; }
+
+private:
+	const BinaryIndexNode*			m_nodes;
+	size_t							m_numNodes;
+};
+
+// Program Binary Blob
+// -------------------
+//
+// All binaries are stored in a single file that the reader maps into memory,
+// so that SPIR-V words can be used in place and processes running from the
+// same registry share the pages through the OS page cache.
+//
+// File starts with BinaryBlobHeader followed by a BinaryBlobEntry for each
+// binary index. Binaries follow the entry table, each starting at a 4-byte
+// aligned offset. Unused binary indices have size 0.
+//
+// Older registries store each binary in a separate 0xXXXXXXXX.spv file. Those
+// are still read, and converted to a blob when the registry is rewritten.
+
+enum
+{
+	BINARY_BLOB_MAGIC = 0x42425856u		//!< "VXBB"
+};
+
+struct BinaryBlobHeader
+{
+	deUint32	magic;
+	deUint32	numBinaries;
+};
+
+struct BinaryBlobEntry
+{
+	deUint32	offset;		//!< Offset from start of the file.
+	deUint32	size;		//!< Binary size in bytes, 0 if index is not used.
+};
+
 class BinaryRegistryReader
 {
 public:
 							BinaryRegistryReader	(const tcu::Archive& archive, const std::string& srcPath);
 							~BinaryRegistryReader	(void);
 
+	//! Load program binary. If archive supports memory mapping, returned binary refers to
+	//! the mapped registry and must not outlive the reader.
 	ProgramBinary*			loadProgram				(const ProgramIdentifier& id) const;
 
 private:
-	typedef de::MovePtr<BinaryIndexAccess> BinaryIndexPtr;
+	typedef de::MovePtr<BinaryIndexAccess>			BinaryIndexPtr;
+	typedef de::MovePtr<MappedBinaryIndexAccess>	MappedBinaryIndexPtr;
+	typedef de::MovePtr<tcu::Resource>				ResourcePtr;
+
+	void					openIndex				(void) const;
+	void					openBlob				(void) const;
+	const deUint32*			findIndex				(const ProgramIdentifier& id) const;
+	ProgramBinary*			loadBinary				(deUint32 index) const;
 
 	const tcu::Archive&		m_archive;
 	const std::string		m_srcPath;
 
-	mutable BinaryIndexPtr	m_binaryIndex;
+	mutable ResourcePtr						m_indexResource;		//!< Index file, if it is mapped into memory.
+	mutable MappedBinaryIndexPtr			m_mappedBinaryIndex;
+	mutable BinaryIndexPtr					m_binaryIndex;			//!< Paged index, used when index can't be mapped.
+
+	mutable bool							m_blobOpened;
+	mutable ResourcePtr						m_blobResource;			//!< Binary blob, null if registry uses separate files.
+	mutable std::vector<BinaryBlobEntry>	m_blobEntryCopy;		//!< Copy of entry table if blob is not mapped.
+	mutable const BinaryBlobEntry*			m_blobEntries;
+	mutable deUint32						m_numBlobEntries;
 };
 
 struct ProgramIdentifierIndex
@@ -199,6 +272,27 @@ struct ProgramIdentifierIndex
 	{}
 };
 
+// Program Source Index
+// --------------------
+//
+// Writer can optionally record a hash of the source program (sources, build
+// options and compiler versions) that produced each binary. Source index is
+// stored next to the binary index as a flat array of SourceIndexEntries and
+// allows later builds into the same directory to reuse binaries of programs
+// that have not changed. Source index is not used by BinaryRegistryReader.
+
+struct SourceIndexEntry
+{
+	ShaderCacheHash		sourceHash;
+	deUint32			index;		//!< Binary index.
+};
+
+//! Hash of program sources and build options, combined with compile environment (compiler versions
+//! and settings). Programs with equal source hashes build to identical binaries.
+ShaderCacheHash		getProgramSourceHash	(const std::string& environment, const GlslSource& source);
+ShaderCacheHash		getProgramSourceHash	(const std::string& environment, const HlslSource& source);
+ShaderCacheHash		getProgramSourceHash	(const std::string& environment, const SpirVAsmSource& source);
+
 DE_DECLARE_POOL_HASH(BinaryIndexHashImpl, const ProgramBinary*, deUint32);
 
 class BinaryIndexHash
@@ -225,10 +319,16 @@ public:
 						~BinaryRegistryWriter	(void);
 
 	void				addProgram				(const ProgramIdentifier& id, const ProgramBinary& binary);
+	void				addProgram				(const ProgramIdentifier& id, const ProgramBinary& binary, const ShaderCacheHash& sourceHash);
 	void				write					(void) const;
 
+	//! Find binary that was built from given source in previous build into destination path. Returns DE_NULL if not found.
+	const ProgramBinary*	findPreviousBinary		(const ShaderCacheHash& sourceHash) const;
+
 private:
 	void				initFromPath			(const std::string& srcPath);
+	void				readBlob				(const std::string& srcPath);
+	void				readSourceIndex			(const std::string& srcPath);
 	void				writeToPath				(const std::string& dstPath) const;
 
 	deUint32*			findBinary				(const ProgramBinary& binary) const;
@@ -253,12 +353,15 @@ private:
 
 	typedef std::vector<BinarySlot>				BinaryVector;
 	typedef std::vector<ProgramIdentifierIndex>	ProgIdIndexVector;
+	typedef std::map<ShaderCacheHash, deUint32>	SourceIndexMap;
 
 	const std::string&	m_dstPath;
 
 	ProgIdIndexVector	m_binaryIndices;		//!< ProgramIdentifier -> slot in m_binaries
 	BinaryIndexHash		m_binaryHash;			//!< ProgramBinary -> slot in m_binaries
 	BinaryVector		m_binaries;
+	SourceIndexMap		m_prevSourceIndices;	//!< Source hash -> slot in m_binaries, from previous build
+	SourceIndexMap		m_sourceIndices;		//!< Source hash -> slot in m_binaries
 };
 
 } // BinaryRegistryDetail
@@ -267,6 +370,9 @@ using BinaryRegistryDetail::BinaryRegistryReader;
 using BinaryRegistryDetail::BinaryRegistryWriter;
 using BinaryRegistryDetail::ProgramIdentifier;
 using BinaryRegistryDetail::ProgramNotFoundException;
+using BinaryRegistryDetail::getProgramSourceHash;
+
+void binaryRegistrySelfTest (void);
 
 } // vk
 
@@ -19,6 +19,7 @@
 
 #include "deSTLUtil.hpp"
 #include "deString.h"
+#include "deUniquePtr.hpp"
 #include "vkQueryUtil.hpp"
 #include "vkDeviceFeatures.inl"
 #include "vkDeviceFeatures.hpp"
@@ -191,6 +192,28 @@ bool DeviceFeatures::isDeviceFeatureInitialized (VkStructureType sType) const
 	return false;
 }
 
+size_t getFeatureStructSize (VkStructureType sType)
+{
+	switch (sType)
+	{
+		case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2:			return sizeof(VkPhysicalDeviceFeatures2);
+		case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_FEATURES:	return sizeof(VkPhysicalDeviceVulkan11Features);
+		case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES:	return sizeof(VkPhysicalDeviceVulkan12Features);
+		default:
+			break;
+	}
+
+	for (const auto& featureStructCreationData : featureStructCreationArray)
+	{
+		const de::UniquePtr<FeatureStructWrapperBase>	wrapper	((*featureStructCreationData.creatorFunction)());
+
+		if (wrapper && wrapper->getFeatureDesc().sType == sType)
+			return wrapper->getFeatureTypeSize();
+	}
+
+	return 0;
+}
+
 DeviceFeatures::~DeviceFeatures (void)
 {
 	for (auto p : m_features)
@@ -61,6 +61,7 @@ public:
 	virtual FeatureDesc		getFeatureDesc				(void) const = 0;
 	virtual void**			getFeatureTypeNext			(void) = 0;
 	virtual void*			getFeatureTypeRaw			(void) = 0;
+	virtual size_t			getFeatureTypeSize			(void) const = 0;
 };
 
 using FeatureStructWrapperCreator	= FeatureStructWrapperBase* (*) (void);
@@ -89,6 +90,9 @@ void initFeatureFromBlobWrapper(FeatureType& featureType, const AllFeaturesBlobs
 	initFeatureFromBlob<FeatureType>(featureType, allFeaturesBlobs);
 }
 
+// Size of feature structure with given sType, or 0 if sType is not a known feature structure
+size_t getFeatureStructSize (VkStructureType sType);
+
 class DeviceFeatures
 {
 public:
@@ -172,6 +176,7 @@ public:
 	FeatureDesc		getFeatureDesc		(void) const	{ return m_featureDesc;			}
 	void**			getFeatureTypeNext	(void)			{ return &m_featureType.pNext;	}
 	void*			getFeatureTypeRaw	(void)			{ return &m_featureType;		}
+	size_t			getFeatureTypeSize	(void) const	{ return sizeof(FeatureType);	}
 	FeatureType&	getFeatureTypeRef	(void)			{ return m_featureType;			}
 
 public:
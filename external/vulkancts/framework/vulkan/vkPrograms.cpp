@@ -29,23 +29,20 @@
 #include "vkShaderToSpirV.hpp"
 #include "vkSpirVAsm.hpp"
 #include "vkRefUtil.hpp"
+#include "vkShaderCache.hpp"
 
-#include "deMutex.hpp"
-#include "deFilePath.hpp"
 #include "deArrayUtil.hpp"
 #include "deMemory.h"
 #include "deInt32.h"
 
 #include "tcuCommandLine.hpp"
 
-#include <map>
 
 namespace vk
 {
 
 using std::string;
 using std::vector;
-using std::map;
 
 #if defined(DE_DEBUG)
 #	define VALIDATE_BINARIES	true
@@ -59,11 +56,36 @@ using std::map;
 
 ProgramBinary::ProgramBinary (ProgramFormat format, size_t binarySize, const deUint8* binary)
 	: m_format	(format)
-	, m_binary	(binary, binary+binarySize)
+	, m_storage	(binary, binary+binarySize)
+	, m_binary	(m_storage.empty() ? DE_NULL : &m_storage[0])
+	, m_size	(binarySize)
 	, m_used	(false)
 {
 }
 
+ProgramBinary::ProgramBinary (const ProgramBinary& other)
+	: m_format	(other.m_format)
+	, m_storage	(other.getBinary(), other.getBinary()+other.getSize())
+	, m_binary	(m_storage.empty() ? DE_NULL : &m_storage[0])
+	, m_size	(other.m_size)
+	, m_used	(other.m_used)
+{
+}
+
+ProgramBinary::ProgramBinary (ProgramFormat format, size_t binarySize, const deUint8* binary, bool copyBinary)
+	: m_format	(format)
+	, m_storage	(copyBinary ? binary : DE_NULL, copyBinary ? binary+binarySize : DE_NULL)
+	, m_binary	(copyBinary ? (m_storage.empty() ? DE_NULL : &m_storage[0]) : binary)
+	, m_size	(binarySize)
+	, m_used	(false)
+{
+}
+
+ProgramBinary* ProgramBinary::createReference (ProgramFormat format, size_t binarySize, const deUint8* binary)
+{
+	return new ProgramBinary(format, binarySize, binary, false);
+}
+
 // Utils
 
 namespace
@@ -176,218 +198,9 @@ void validateCompiledBinary(const vector<deUint32>& binary, SpirVProgramInfo* bu
 	}
 }
 
-de::Mutex							cacheFileMutex;
-map<deUint32, vector<deUint32> >	cacheFileIndex;
-bool								cacheFileFirstRun = true;
-
-void shaderCacheFirstRunCheck (const char* shaderCacheFile, bool truncate)
-{
-	cacheFileMutex.lock();
-	if (cacheFileFirstRun)
-	{
-		cacheFileFirstRun = false;
-		if (truncate)
-		{
-			// Open file with "w" access to truncate it
-			FILE* f = fopen(shaderCacheFile, "wb");
-			if (f)
-				fclose(f);
-		}
-		else
-		{
-			// Parse chunked shader cache file for hashes and offsets
-			FILE* file = fopen(shaderCacheFile, "rb");
-			int count = 0;
-			if (file)
-			{
-				deUint32 chunksize	= 0;
-				deUint32 hash		= 0;
-				deUint32 offset		= 0;
-				bool ok				= true;
-				while (ok)
-				{
-					offset = (deUint32)ftell(file);
-					if (ok) ok = fread(&chunksize, 1, 4, file)				== 4;
-					if (ok) ok = fread(&hash, 1, 4, file)					== 4;
-					if (ok) cacheFileIndex[hash].push_back(offset);
-					if (ok) ok = fseek(file, offset + chunksize, SEEK_SET)	== 0;
-					count++;
-				}
-				fclose(file);
-			}
-		}
-	}
-	cacheFileMutex.unlock();
-}
-
-std::string intToString (deUint32 integer)
+ShaderCache& getShaderCache (const tcu::CommandLine& commandLine)
 {
-	std::stringstream temp_sstream;
-
-	temp_sstream << integer;
-
-	return temp_sstream.str();
-}
-
-// 32-bit FNV-1 hash
-deUint32 shadercacheHash (const char* str)
-{
-	deUint32 hash = 0x811c9dc5;
-	deUint32 c;
-	while ((c = (deUint32)*str++) != 0)
-	{
-		hash *= 16777619;
-		hash ^= c;
-	}
-	return hash;
-}
-
-vk::ProgramBinary* shadercacheLoad (const std::string& shaderstring, const char* shaderCacheFilename)
-{
-	deUint32		hash		= shadercacheHash(shaderstring.c_str());
-	deInt32			format;
-	deInt32			length;
-	deInt32			sourcelength;
-	deUint32		i;
-	deUint32		temp;
-	deUint8*		bin			= 0;
-	char*			source		= 0;
-	deBool			ok			= true;
-	deBool			diff		= true;
-	cacheFileMutex.lock();
-
-	if (cacheFileIndex.count(hash) == 0)
-	{
-		cacheFileMutex.unlock();
-		return 0;
-	}
-	FILE*			file		= fopen(shaderCacheFilename, "rb");
-	ok				= file											!= 0;
-
-	for (i = 0; i < cacheFileIndex[hash].size(); i++)
-	{
-		if (ok) ok = fseek(file, cacheFileIndex[hash][i], SEEK_SET)	== 0;
-		if (ok) ok = fread(&temp, 1, 4, file)						== 4; // Chunk size (skip)
-		if (ok) ok = fread(&temp, 1, 4, file)						== 4; // Stored hash
-		if (ok) ok = temp											== hash; // Double check
-		if (ok) ok = fread(&format, 1, 4, file)						== 4;
-		if (ok) ok = fread(&length, 1, 4, file)						== 4;
-		if (ok) ok = length											> 0; // sanity check
-		if (ok) bin = new deUint8[length];
-		if (ok) ok = fread(bin, 1, length, file)					== (size_t)length;
-		if (ok) ok = fread(&sourcelength, 1, 4, file)				== 4;
-		if (ok && sourcelength > 0)
-		{
-			source = new char[sourcelength + 1];
-			ok = fread(source, 1, sourcelength, file)				== (size_t)sourcelength;
-			source[sourcelength] = 0;
-			diff = shaderstring != std::string(source);
-		}
-		if (!ok || diff)
-		{
-			// Mismatch, but may still exist in cache if there were hash collisions
-			delete[] source;
-			delete[] bin;
-		}
-		else
-		{
-			delete[] source;
-			if (file) fclose(file);
-			cacheFileMutex.unlock();
-			vk::ProgramBinary* res = new vk::ProgramBinary((vk::ProgramFormat)format, length, bin);
-			delete[] bin;
-			return res;
-		}
-	}
-	if (file) fclose(file);
-	cacheFileMutex.unlock();
-	return 0;
-}
-
-void shadercacheSave (const vk::ProgramBinary* binary, const std::string& shaderstring, const char* shaderCacheFilename)
-{
-	if (binary == 0)
-		return;
-	deUint32			hash		= shadercacheHash(shaderstring.c_str());
-	deInt32				format		= binary->getFormat();
-	deUint32			length		= (deUint32)binary->getSize();
-	deUint32			chunksize;
-	deUint32			offset;
-	const deUint8*		bin			= binary->getBinary();
-	const de::FilePath	filePath	(shaderCacheFilename);
-
-	cacheFileMutex.lock();
-
-	if (cacheFileIndex[hash].size())
-	{
-		FILE*			file		= fopen(shaderCacheFilename, "rb");
-		deBool			ok			= (file != 0);
-		deBool			diff		= DE_TRUE;
-		deInt32			sourcelength;
-		deUint32		i;
-		deUint32		temp;
-
-		for (i = 0; i < cacheFileIndex[hash].size(); i++)
-		{
-			deUint32	cachedLength	= 0;
-
-			if (ok) ok = fseek(file, cacheFileIndex[hash][i], SEEK_SET)	== 0;
-			if (ok) ok = fread(&temp, 1, 4, file)						== 4; // Chunk size (skip)
-			if (ok) ok = fread(&temp, 1, 4, file)						== 4; // Stored hash
-			if (ok) ok = temp											== hash; // Double check
-			if (ok) ok = fread(&temp, 1, 4, file)						== 4;
-			if (ok) ok = fread(&cachedLength, 1, 4, file)				== 4;
-			if (ok) ok = cachedLength									> 0; // sanity check
-			if (ok) fseek(file, cachedLength, SEEK_CUR); // skip binary
-			if (ok) ok = fread(&sourcelength, 1, 4, file)				== 4;
-
-			if (ok && sourcelength > 0)
-			{
-				char* source;
-				source	= new char[sourcelength + 1];
-				ok		= fread(source, 1, sourcelength, file)			== (size_t)sourcelength;
-				source[sourcelength] = 0;
-				diff	= shaderstring != std::string(source);
-				delete[] source;
-			}
-
-			if (ok && !diff)
-			{
-				// Already in cache (written by another thread, probably)
-				fclose(file);
-				cacheFileMutex.unlock();
-				return;
-			}
-		}
-		fclose(file);
-	}
-
-	if (!de::FilePath(filePath.getDirName()).exists())
-		de::createDirectoryAndParents(filePath.getDirName().c_str());
-
-	FILE*				file		= fopen(shaderCacheFilename, "ab");
-	if (!file)
-	{
-		cacheFileMutex.unlock();
-		return;
-	}
-	// Append mode starts writing from the end of the file,
-	// but unless we do a seek, ftell returns 0.
-	fseek(file, 0, SEEK_END);
-	offset		= (deUint32)ftell(file);
-	chunksize	= 4 + 4 + 4 + 4 + length + 4 + (deUint32)shaderstring.length();
-	fwrite(&chunksize, 1, 4, file);
-	fwrite(&hash, 1, 4, file);
-	fwrite(&format, 1, 4, file);
-	fwrite(&length, 1, 4, file);
-	fwrite(bin, 1, length, file);
-	length = (deUint32)shaderstring.length();
-	fwrite(&length, 1, 4, file);
-	fwrite(shaderstring.c_str(), 1, length, file);
-	fclose(file);
-	cacheFileIndex[hash].push_back(offset);
-
-	cacheFileMutex.unlock();
+	return getShaderCache(commandLine.getShaderCacheFilename(), commandLine.isShaderCacheTruncateEnabled());
 }
 
 // Insert any information that may affect compilation into the shader string.
@@ -408,10 +221,14 @@ void getBuildOptions (std::string& shaderstring, const ShaderBuildOptions& build
 	shaderstring += "Target Spir-V ";
 	shaderstring += getSpirvVersionName(buildOptions.targetVersion);
 	shaderstring += "\n";
-	if (buildOptions.flags & ShaderBuildOptions::FLAG_ALLOW_RELAXED_OFFSETS)
-		shaderstring += "Flag:Allow relaxed offsets\n";
-	if (buildOptions.flags & ShaderBuildOptions::FLAG_USE_STORAGE_BUFFER_STORAGE_CLASS)
-		shaderstring += "Flag:Use storage buffer storage class\n";
+	shaderstring += "Vulkan version ";
+	shaderstring += de::toString(buildOptions.vulkanVersion);
+	shaderstring += "\n";
+	shaderstring += "Flags ";
+	shaderstring += de::toString(buildOptions.flags);
+	shaderstring += "\n";
+	if (buildOptions.supports_VK_KHR_spirv_1_4)
+		shaderstring += "Supports VK_KHR_spirv_1_4\n";
 	if (optimizationRecipe != 0)
 	{
 		shaderstring += "Optimization recipe ";
@@ -432,7 +249,6 @@ ProgramBinary* buildProgram (const GlslSource& program, glu::ShaderProgramInfo*
 
 	if (commandLine.isShadercacheEnabled())
 	{
-		shaderCacheFirstRunCheck(commandLine.getShaderCacheFilename(), commandLine.isShaderCacheTruncateEnabled());
 		getCompileEnvironment(cachekey);
 		getBuildOptions(cachekey, program.buildOptions, optimizationRecipe);
 
@@ -449,7 +265,7 @@ ProgramBinary* buildProgram (const GlslSource& program, glu::ShaderProgramInfo*
 
 		cachekey = cachekey + shaderstring;
 
-		res = shadercacheLoad(cachekey, commandLine.getShaderCacheFilename());
+		res = getShaderCache(commandLine).load(cachekey);
 
 		if (res)
 		{
@@ -500,7 +316,7 @@ ProgramBinary* buildProgram (const GlslSource& program, glu::ShaderProgramInfo*
 
 		res = createProgramBinaryFromSpirV(binary);
 		if (commandLine.isShadercacheEnabled())
-			shadercacheSave(res, cachekey, commandLine.getShaderCacheFilename());
+			getShaderCache(commandLine).store(*res, cachekey);
 	}
 	return res;
 }
@@ -517,7 +333,6 @@ ProgramBinary* buildProgram (const HlslSource& program, glu::ShaderProgramInfo*
 
 	if (commandLine.isShadercacheEnabled())
 	{
-		shaderCacheFirstRunCheck(commandLine.getShaderCacheFilename(), commandLine.isShaderCacheTruncateEnabled());
 		getCompileEnvironment(cachekey);
 		getBuildOptions(cachekey, program.buildOptions, optimizationRecipe);
 
@@ -534,7 +349,7 @@ ProgramBinary* buildProgram (const HlslSource& program, glu::ShaderProgramInfo*
 
 		cachekey = cachekey + shaderstring;
 
-		res = shadercacheLoad(cachekey, commandLine.getShaderCacheFilename());
+		res = getShaderCache(commandLine).load(cachekey);
 
 		if (res)
 		{
@@ -585,7 +400,7 @@ ProgramBinary* buildProgram (const HlslSource& program, glu::ShaderProgramInfo*
 
 		res = createProgramBinaryFromSpirV(binary);
 		if (commandLine.isShadercacheEnabled())
-			shadercacheSave(res, cachekey, commandLine.getShaderCacheFilename());
+			getShaderCache(commandLine).store(*res, cachekey);
 	}
 	return res;
 }
@@ -601,11 +416,17 @@ ProgramBinary* assembleProgram (const SpirVAsmSource& program, SpirVProgramInfo*
 
 	if (commandLine.isShadercacheEnabled())
 	{
-		shaderCacheFirstRunCheck(commandLine.getShaderCacheFilename(), commandLine.isShaderCacheTruncateEnabled());
 		getCompileEnvironment(cachekey);
 		cachekey += "Target Spir-V ";
 		cachekey += getSpirvVersionName(spirvVersion);
 		cachekey += "\n";
+		cachekey += "Vulkan version ";
+		cachekey += de::toString(program.buildOptions.vulkanVersion);
+		cachekey += "\n";
+		if (program.buildOptions.supports_VK_KHR_spirv_1_4)
+			cachekey += "Supports VK_KHR_spirv_1_4\n";
+		if (program.buildOptions.supports_VK_KHR_maintenance4)
+			cachekey += "Supports VK_KHR_maintenance4\n";
 		if (optimizationRecipe != 0)
 		{
 			cachekey += "Optimization recipe ";
@@ -615,7 +436,7 @@ ProgramBinary* assembleProgram (const SpirVAsmSource& program, SpirVProgramInfo*
 
 		cachekey += program.source;
 
-		res = shadercacheLoad(cachekey, commandLine.getShaderCacheFilename());
+		res = getShaderCache(commandLine).load(cachekey);
 
 		if (res)
 		{
@@ -645,7 +466,7 @@ ProgramBinary* assembleProgram (const SpirVAsmSource& program, SpirVProgramInfo*
 
 		res = createProgramBinaryFromSpirV(binary);
 		if (commandLine.isShadercacheEnabled())
-			shadercacheSave(res, cachekey, commandLine.getShaderCacheFilename());
+			getShaderCache(commandLine).store(*res, cachekey);
 	}
 	return res;
 }
@@ -48,17 +48,26 @@ class ProgramBinary
 {
 public:
 								ProgramBinary	(ProgramFormat format, size_t binarySize, const deUint8* binary);
+								ProgramBinary	(const ProgramBinary& other);
 
-	ProgramFormat				getFormat		(void) const { return m_format;										}
-	size_t						getSize			(void) const { return m_binary.size();								}
-	const deUint8*				getBinary		(void) const { return m_binary.empty() ? DE_NULL : &m_binary[0];	}
+	//! Create binary that refers to data owned by someone else instead of copying it. Data must outlive the binary.
+	static ProgramBinary*		createReference	(ProgramFormat format, size_t binarySize, const deUint8* binary);
 
-	inline void					setUsed			(void) const { m_used = true;										}
-	inline bool					getUsed			(void) const { return m_used;										}
+	ProgramFormat				getFormat		(void) const { return m_format;							}
+	size_t						getSize			(void) const { return m_size;							}
+	const deUint8*				getBinary		(void) const { return m_size > 0 ? m_binary : DE_NULL;	}
+
+	inline void					setUsed			(void) const { m_used = true;							}
+	inline bool					getUsed			(void) const { return m_used;							}
 
 private:
+								ProgramBinary	(ProgramFormat format, size_t binarySize, const deUint8* binary, bool copyBinary);
+	ProgramBinary&				operator=		(const ProgramBinary&); // disabled
+
 	const ProgramFormat			m_format;
-	const std::vector<deUint8>	m_binary;
+	const std::vector<deUint8>	m_storage;		//!< Copy of binary, empty if binary refers to external data.
+	const deUint8* const		m_binary;
+	const size_t				m_size;
 	mutable bool				m_used;
 };
 
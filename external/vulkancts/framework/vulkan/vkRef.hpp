@@ -123,6 +123,10 @@ public:
 										m_destroyDevice = (DestroyDeviceFunc)getDeviceProcAddr(device, "vkDestroyDevice");
 										m_allocator = allocator;
 									}
+									Deleter		(DestroyDeviceFunc destroyDevice, const VkAllocationCallbacks* allocator)
+										: m_destroyDevice	(destroyDevice)
+										, m_allocator		(allocator)
+									{}
 									Deleter		(void)
 										: m_destroyDevice	((DestroyDeviceFunc)DE_NULL)
 										, m_allocator		(DE_NULL)
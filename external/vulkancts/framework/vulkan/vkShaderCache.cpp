@@ -0,0 +1,1014 @@
+/*-------------------------------------------------------------------------
+ * Vulkan CTS Framework
+ * --------------------
+ *
+ * Copyright (c) 2020 The Khronos Group Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *//*!
+ * \file
+ * \brief Persistent shader binary cache.
+ *//*--------------------------------------------------------------------*/
+
+#include "vkShaderCache.hpp"
+
+#include "deSha1.h"
+#include "deFile.h"
+#include "deFilePath.hpp"
+#include "deAtomic.h"
+#include "deSingleton.h"
+#include "deInt32.h"
+#include "deMemory.h"
+#include "deUniquePtr.hpp"
+#include "deStringUtil.hpp"
+
+#include <cstdio>
+
+namespace vk
+{
+
+using std::string;
+using std::vector;
+
+namespace
+{
+
+enum
+{
+	FILE_MAGIC				= 0x43534b56u,	// 'VKSC'
+	INDEX_MAGIC				= 0x49534b56u,	// 'VKSI'
+	RECORD_MAGIC			= 0x52534b56u,	// 'VKSR'
+	FORMAT_VERSION			= 2u,
+
+	MIN_TABLE_CAPACITY		= 64u,
+
+	// Compact data file when at least 1/COMPACTION_RATIO of it is dead
+	COMPACTION_RATIO		= 4u
+};
+
+struct FileHeader
+{
+	deUint32	magic;
+	deUint32	version;
+	deUint32	reserved[2];
+};
+
+struct RecordHeader
+{
+	deUint32	magic;
+	deUint32	size;			//!< Total record size including header, payload and padding
+	deUint32	hash[4];
+	deUint32	format;
+	deUint32	binarySize;
+	deUint32	keySize;
+	deUint32	reserved;
+};
+
+struct IndexHeader
+{
+	deUint32	magic;
+	deUint32	version;
+	deUint32	capacity;
+	deUint32	numEntries;
+	deUint64	dataSize;		//!< Number of data file bytes covered by index
+	deUint64	deadBytes;		//!< Number of bytes in duplicate records
+};
+
+struct IndexEntry
+{
+	deUint32	hash[4];
+	deUint64	offset;			//!< Record offset in data file, 0 for empty slot
+};
+
+DE_STATIC_ASSERT(sizeof(FileHeader)		== 16);
+DE_STATIC_ASSERT(sizeof(RecordHeader)	== 40);
+DE_STATIC_ASSERT(sizeof(IndexHeader)	== 32);
+DE_STATIC_ASSERT(sizeof(IndexEntry)		== 24);
+
+inline bool hashEquals (const deUint32* a, const ShaderCacheHash& b)
+{
+	return a[0] == b.words[0] && a[1] == b.words[1] && a[2] == b.words[2] && a[3] == b.words[3];
+}
+
+inline deUint32 getRecordSize (deUint32 binarySize, deUint32 keySize)
+{
+	return (deUint32)deAlign32((deInt32)(sizeof(RecordHeader) + binarySize + keySize), (deInt32)sizeof(deUint32));
+}
+
+inline deUint32 getTableCapacity (deUint32 numEntries)
+{
+	return de::max((deUint32)MIN_TABLE_CAPACITY, deSmallestGreaterOrEquallPowerOfTwoU32(numEntries * 2u + 1u));
+}
+
+string getIndexFilename (const string& filename)
+{
+	return filename + ".idx";
+}
+
+string getTempFilename (const string& filename)
+{
+	return filename + ".tmp";
+}
+
+string getLockFilename (const string& filename)
+{
+	return filename + ".lock";
+}
+
+deFile* openLockFile (const string& filename)
+{
+	return deFile_create(getLockFilename(filename).c_str(), DE_FILEMODE_READ|DE_FILEMODE_WRITE|DE_FILEMODE_CREATE|DE_FILEMODE_OPEN);
+}
+
+//! Holds lock on cache files. Excludes other processes and other caches using the same files.
+class ScopedFileLock
+{
+public:
+	ScopedFileLock (deFile* lockFile)
+		: m_lockFile	(lockFile)
+		, m_isLocked	(lockFile && deFile_lock(lockFile))
+	{
+		// \note If lock file can't be created, the cache is used without locking
+	}
+
+	~ScopedFileLock (void)
+	{
+		if (m_isLocked)
+			deFile_unlock(m_lockFile);
+	}
+
+private:
+					ScopedFileLock	(const ScopedFileLock&);
+	ScopedFileLock&	operator=		(const ScopedFileLock&);
+
+	deFile* const	m_lockFile;
+	const bool		m_isLocked;
+};
+
+//! Returns record at offset or DE_NULL if there is no valid record.
+const RecordHeader* getRecord (const deUint8* data, deUint64 dataSize, deUint64 offset)
+{
+	const RecordHeader* record;
+
+	if (offset < sizeof(FileHeader) || offset + sizeof(RecordHeader) > dataSize)
+		return DE_NULL;
+
+	record = (const RecordHeader*)(data + offset);
+
+	if (record->magic != RECORD_MAGIC || record->size != getRecordSize(record->binarySize, record->keySize) || offset + record->size > dataSize)
+		return DE_NULL;
+
+	return record;
+}
+
+inline const deUint8* getRecordBinary (const RecordHeader* record)
+{
+	return (const deUint8*)(record + 1);
+}
+
+inline bool recordKeyEquals (const RecordHeader* record, const string& key)
+{
+	return record->keySize == (deUint32)key.size() && deMemCmp(getRecordBinary(record) + record->binarySize, key.c_str(), key.size()) == 0;
+}
+
+bool isValidDataFile (const deMappedFile* file)
+{
+	const FileHeader* header = (const FileHeader*)deMappedFile_getPtr(file);
+
+	return deMappedFile_getSize(file) >= (deInt64)sizeof(FileHeader) && header->magic == FILE_MAGIC && header->version == FORMAT_VERSION;
+}
+
+bool isValidIndexFile (const deMappedFile* file, deInt64 dataSize)
+{
+	const IndexHeader* header = (const IndexHeader*)deMappedFile_getPtr(file);
+
+	if (deMappedFile_getSize(file) < (deInt64)sizeof(IndexHeader))
+		return false;
+
+	return header->magic == INDEX_MAGIC
+		&& header->version == FORMAT_VERSION
+		&& deIsPowerOfTwo32((int)header->capacity)
+		&& header->numEntries < header->capacity
+		&& deMappedFile_getSize(file) == (deInt64)(sizeof(IndexHeader) + header->capacity * sizeof(IndexEntry))
+		&& header->dataSize >= sizeof(FileHeader)
+		&& header->dataSize <= (deUint64)dataSize;
+}
+
+bool writeFile (const string& filename, const vector<deUint8>& data)
+{
+	FILE*	file	= fopen(filename.c_str(), "wb");
+	bool	ok		= file != DE_NULL;
+
+	if (ok && !data.empty())
+		ok = fwrite(&data[0], 1, data.size(), file) == data.size();
+
+	if (file)
+		ok = (fclose(file) == 0) && ok;
+
+	return ok;
+}
+
+//! Replace dst with src. Readers that have the old file mapped keep seeing the old contents.
+bool replaceFile (const string& src, const string& dst)
+{
+	if (rename(src.c_str(), dst.c_str()) == 0)
+		return true;
+
+	// Win32 rename doesn't overwrite existing files
+	deDeleteFile(dst.c_str());
+	return rename(src.c_str(), dst.c_str()) == 0;
+}
+
+bool writeEmptyDataFile (const string& filename)
+{
+	FileHeader header;
+
+	deMemset(&header, 0, sizeof(header));
+	header.magic	= FILE_MAGIC;
+	header.version	= FORMAT_VERSION;
+
+	return writeFile(filename, vector<deUint8>((const deUint8*)&header, (const deUint8*)(&header + 1)));
+}
+
+//! Open addressing hash table matching the on-disk index layout
+class IndexBuilder
+{
+public:
+	IndexBuilder (void)
+		: m_numEntries	(0u)
+		, m_deadBytes	(0u)
+		, m_entries		(MIN_TABLE_CAPACITY)
+	{
+		deMemset(&m_entries[0], 0, m_entries.size() * sizeof(IndexEntry));
+	}
+
+	void addDeadBytes (deUint64 numBytes)
+	{
+		m_deadBytes += numBytes;
+	}
+
+	//! Returns false if hash already exists
+	bool insert (const deUint32* hash, deUint64 offset)
+	{
+		if (getTableCapacity(m_numEntries + 1u) > (deUint32)m_entries.size())
+			grow(getTableCapacity(m_numEntries + 1u));
+
+		{
+			const deUint32	mask	= (deUint32)m_entries.size() - 1u;
+			deUint32		slot	= hash[0] & mask;
+
+			while (m_entries[slot].offset != 0)
+			{
+				if (deMemCmp(m_entries[slot].hash, hash, sizeof(m_entries[slot].hash)) == 0)
+					return false;
+
+				slot = (slot + 1u) & mask;
+			}
+
+			deMemcpy(m_entries[slot].hash, hash, sizeof(m_entries[slot].hash));
+			m_entries[slot].offset = offset;
+			m_numEntries++;
+		}
+
+		return true;
+	}
+
+	vector<deUint8> serialize (deUint64 dataSize) const
+	{
+		vector<deUint8>	data	(sizeof(IndexHeader) + m_entries.size() * sizeof(IndexEntry));
+		IndexHeader		header;
+
+		header.magic		= INDEX_MAGIC;
+		header.version		= FORMAT_VERSION;
+		header.capacity		= (deUint32)m_entries.size();
+		header.numEntries	= m_numEntries;
+		header.dataSize		= dataSize;
+		header.deadBytes	= m_deadBytes;
+
+		deMemcpy(&data[0], &header, sizeof(header));
+		deMemcpy(&data[sizeof(header)], &m_entries[0], m_entries.size() * sizeof(IndexEntry));
+
+		return data;
+	}
+
+	deUint64 getDeadBytes (void) const
+	{
+		return m_deadBytes;
+	}
+
+private:
+	void grow (deUint32 newCapacity)
+	{
+		vector<IndexEntry> oldEntries (newCapacity);
+
+		deMemset(&oldEntries[0], 0, oldEntries.size() * sizeof(IndexEntry));
+		m_entries.swap(oldEntries);
+		m_numEntries = 0u;
+
+		for (size_t ndx = 0; ndx < oldEntries.size(); ndx++)
+		{
+			if (oldEntries[ndx].offset != 0)
+				insert(oldEntries[ndx].hash, oldEntries[ndx].offset);
+		}
+	}
+
+	deUint32			m_numEntries;
+	deUint64			m_deadBytes;
+	vector<IndexEntry>	m_entries;
+};
+
+//! Add records starting from offset to index. Returns offset of first byte not containing a valid record.
+deUint64 scanRecords (const deUint8* data, deUint64 dataSize, deUint64 offset, IndexBuilder& index)
+{
+	while (const RecordHeader* record = getRecord(data, dataSize, offset))
+	{
+		if (!index.insert(record->hash, offset))
+			index.addDeadBytes(record->size);
+
+		offset += record->size;
+	}
+
+	return offset;
+}
+
+bool needsCompaction (deUint64 deadBytes, deUint64 dataSize)
+{
+	return deadBytes * COMPACTION_RATIO >= dataSize && deadBytes > 0;
+}
+
+//! Rewrite data file dropping duplicate and invalid records. Caller must hold file lock.
+void compactDataFile (const string& filename)
+{
+	const string	indexFilename	= getIndexFilename(filename);
+	deMappedFile*	dataFile		= deMappedFile_create(filename.c_str());
+	vector<deUint8>	compacted;
+	IndexBuilder	builder;
+
+	if (!dataFile || !isValidDataFile(dataFile))
+	{
+		if (dataFile)
+			deMappedFile_destroy(dataFile);
+
+		deDeleteFile(indexFilename.c_str());
+		writeEmptyDataFile(filename);
+		return;
+	}
+
+	{
+		const deUint8*	data		= (const deUint8*)deMappedFile_getPtr(dataFile);
+		const deUint64	dataSize	= (deUint64)deMappedFile_getSize(dataFile);
+		deUint64		offset		= sizeof(FileHeader);
+
+		compacted.insert(compacted.end(), data, data + sizeof(FileHeader));
+
+		while (const RecordHeader* record = getRecord(data, dataSize, offset))
+		{
+			if (builder.insert(record->hash, (deUint64)compacted.size()))
+				compacted.insert(compacted.end(), data + offset, data + offset + record->size);
+
+			offset += record->size;
+		}
+	}
+
+	deMappedFile_destroy(dataFile);
+
+	deDeleteFile(indexFilename.c_str());
+
+	if (writeFile(getTempFilename(filename), compacted) && replaceFile(getTempFilename(filename), filename))
+	{
+		if (writeFile(getTempFilename(indexFilename), builder.serialize((deUint64)compacted.size())))
+			replaceFile(getTempFilename(indexFilename), indexFilename);
+	}
+}
+
+} // anonymous
+
+bool ShaderCacheHash::operator== (const ShaderCacheHash& other) const
+{
+	return hashEquals(words, other);
+}
+
+bool ShaderCacheHash::operator< (const ShaderCacheHash& other) const
+{
+	for (int ndx = 0; ndx < DE_LENGTH_OF_ARRAY(words); ndx++)
+	{
+		if (words[ndx] != other.words[ndx])
+			return words[ndx] < other.words[ndx];
+	}
+
+	return false;
+}
+
+ShaderCacheHash computeShaderCacheHash (const string& key)
+{
+	deSha1			sha1;
+	ShaderCacheHash	hash;
+
+	deSha1_compute(&sha1, key.size(), key.c_str());
+
+	for (int ndx = 0; ndx < DE_LENGTH_OF_ARRAY(hash.words); ndx++)
+		hash.words[ndx] = sha1.hash[ndx];
+
+	return hash;
+}
+
+ShaderCache::ShaderCache (const string& filename, bool truncate)
+	: m_filename		(filename)
+	, m_lockFile		(DE_NULL)
+	, m_dataFile		(DE_NULL)
+	, m_indexFile		(DE_NULL)
+	, m_appendFailed	(false)
+	, m_storedTable		(DE_NULL)
+{
+	Table* table = new Table();
+
+	table->capacity		= MIN_TABLE_CAPACITY;
+	table->numEntries	= 0u;
+	table->slots		= new Entry* volatile[table->capacity]();
+
+	m_storedTable = table;
+
+	open(truncate);
+}
+
+ShaderCache::~ShaderCache (void)
+{
+	Table* const table = m_storedTable;
+
+	for (deUint32 ndx = 0; ndx < table->capacity; ndx++)
+		delete table->slots[ndx];
+
+	m_retiredTables.push_back(table);
+
+	for (size_t ndx = 0; ndx < m_retiredTables.size(); ndx++)
+	{
+		delete[] m_retiredTables[ndx]->slots;
+		delete m_retiredTables[ndx];
+	}
+
+	if (m_indexFile)
+		deMappedFile_destroy(m_indexFile);
+
+	if (m_dataFile)
+		deMappedFile_destroy(m_dataFile);
+
+	if (m_lockFile)
+		deFile_destroy(m_lockFile);
+}
+
+void ShaderCache::open (bool truncate)
+{
+	const string		indexFilename	= getIndexFilename(m_filename);
+	const de::FilePath	filePath		(m_filename);
+
+	if (!filePath.getDirName().empty() && !de::FilePath(filePath.getDirName()).exists())
+		de::createDirectoryAndParents(filePath.getDirName().c_str());
+
+	m_lockFile = openLockFile(m_filename);
+
+	// Other processes may be appending to or compacting the same cache
+	const ScopedFileLock lock (m_lockFile);
+
+	if (truncate)
+	{
+		writeEmptyDataFile(m_filename);
+		deDeleteFile(indexFilename.c_str());
+	}
+
+	// Second pass is needed only if data file was reset or compacted
+	for (int attempt = 0; attempt < 2; attempt++)
+	{
+		m_dataFile = deMappedFile_create(m_filename.c_str());
+
+		if (!m_dataFile || !isValidDataFile(m_dataFile))
+		{
+			// Missing file or incompatible (older) format
+			if (m_dataFile)
+			{
+				deMappedFile_destroy(m_dataFile);
+				m_dataFile = DE_NULL;
+			}
+
+			deDeleteFile(indexFilename.c_str());
+
+			if (!writeEmptyDataFile(m_filename))
+				return;
+
+			continue;
+		}
+
+		{
+			const deUint8*		data		= (const deUint8*)deMappedFile_getPtr(m_dataFile);
+			const deUint64		dataSize	= (deUint64)deMappedFile_getSize(m_dataFile);
+			IndexBuilder		builder;
+			deUint64			scanStart	= sizeof(FileHeader);
+
+			m_indexFile = deMappedFile_create(indexFilename.c_str());
+
+			if (m_indexFile && !isValidIndexFile(m_indexFile, (deInt64)dataSize))
+			{
+				deMappedFile_destroy(m_indexFile);
+				m_indexFile = DE_NULL;
+			}
+
+			if (m_indexFile)
+			{
+				const IndexHeader*	header	= (const IndexHeader*)deMappedFile_getPtr(m_indexFile);
+				const IndexEntry*	entries	= (const IndexEntry*)(header + 1);
+
+				if (header->dataSize == dataSize)
+					return;
+
+				// Index doesn't cover records appended since it was written
+				for (deUint32 ndx = 0; ndx < header->capacity; ndx++)
+				{
+					if (entries[ndx].offset != 0)
+						builder.insert(entries[ndx].hash, entries[ndx].offset);
+				}
+
+				builder.addDeadBytes(header->deadBytes);
+				scanStart = header->dataSize;
+
+				deMappedFile_destroy(m_indexFile);
+				m_indexFile = DE_NULL;
+			}
+
+			{
+				const deUint64 scanEnd = scanRecords(data, dataSize, scanStart, builder);
+
+				if (scanEnd != dataSize || needsCompaction(builder.getDeadBytes(), dataSize))
+				{
+					// Torn record at the end or too many duplicates
+					deMappedFile_destroy(m_dataFile);
+					m_dataFile = DE_NULL;
+
+					compactDataFile(m_filename);
+					continue;
+				}
+			}
+
+			if (writeFile(getTempFilename(indexFilename), builder.serialize(dataSize)) &&
+				replaceFile(getTempFilename(indexFilename), indexFilename))
+			{
+				m_indexFile = deMappedFile_create(indexFilename.c_str());
+
+				if (m_indexFile && !isValidIndexFile(m_indexFile, (deInt64)dataSize))
+				{
+					deMappedFile_destroy(m_indexFile);
+					m_indexFile = DE_NULL;
+				}
+			}
+
+			return;
+		}
+	}
+}
+
+void ShaderCache::compact (const string& filename)
+{
+	deFile* const lockFile = openLockFile(filename);
+
+	{
+		const ScopedFileLock lock (lockFile);
+
+		compactDataFile(filename);
+	}
+
+	if (lockFile)
+		deFile_destroy(lockFile);
+}
+
+ProgramBinary* ShaderCache::loadMapped (const ShaderCacheHash& hash, const string& key) const
+{
+	if (!m_indexFile)
+		return DE_NULL;
+
+	{
+		const IndexHeader*	header		= (const IndexHeader*)deMappedFile_getPtr(m_indexFile);
+		const IndexEntry*	entries		= (const IndexEntry*)(header + 1);
+		const deUint8*		data		= (const deUint8*)deMappedFile_getPtr(m_dataFile);
+		const deUint32		mask		= header->capacity - 1u;
+
+		for (deUint32 slot = hash.words[0] & mask; entries[slot].offset != 0; slot = (slot + 1u) & mask)
+		{
+			if (hashEquals(entries[slot].hash, hash))
+			{
+				const RecordHeader* record = getRecord(data, header->dataSize, entries[slot].offset);
+
+				if (record && hashEquals(record->hash, hash) && recordKeyEquals(record, key))
+					return new ProgramBinary((ProgramFormat)record->format, record->binarySize, getRecordBinary(record));
+				else
+					return DE_NULL;
+			}
+		}
+	}
+
+	return DE_NULL;
+}
+
+ProgramBinary* ShaderCache::loadStored (const ShaderCacheHash& hash, const string& key) const
+{
+	// Pairs with release stores in insertStored()
+	const Table* const	table	= (const Table*)deAtomicLoadAcquirePtr((void* const volatile*)&m_storedTable);
+	const deUint32		mask	= table->capacity - 1u;
+
+	for (deUint32 slot = hash.words[0] & mask;; slot = (slot + 1u) & mask)
+	{
+		const Entry* const entry = (const Entry*)deAtomicLoadAcquirePtr((void* const volatile*)&table->slots[slot]);
+
+		if (!entry)
+			return DE_NULL;
+
+		if (entry->hash == hash)
+		{
+			if (entry->key == key)
+				return new ProgramBinary(entry->format, entry->binary.size(), entry->binary.empty() ? DE_NULL : &entry->binary[0]);
+			else
+				return DE_NULL;
+		}
+	}
+}
+
+ProgramBinary* ShaderCache::load (const string& key) const
+{
+	const ShaderCacheHash	hash	= computeShaderCacheHash(key);
+	ProgramBinary*			binary	= loadMapped(hash, key);
+
+	if (!binary)
+		binary = loadStored(hash, key);
+
+	return binary;
+}
+
+void ShaderCache::insertStored (Entry* entry)
+{
+	Table* table = m_storedTable;
+
+	// Caller must hold m_writeLock
+
+	if (getTableCapacity(table->numEntries + 1u) > table->capacity)
+	{
+		// Readers may still be using the old table, so it is kept alive until destruction
+		Table* const newTable = new Table();
+
+		newTable->capacity		= table->capacity * 2u;
+		newTable->numEntries	= 0u;
+		newTable->slots			= new Entry* volatile[newTable->capacity]();
+
+		for (deUint32 ndx = 0; ndx < table->capacity; ndx++)
+		{
+			if (Entry* const oldEntry = table->slots[ndx])
+			{
+				deUint32 slot = oldEntry->hash.words[0] & (newTable->capacity - 1u);
+
+				while (newTable->slots[slot])
+					slot = (slot + 1u) & (newTable->capacity - 1u);
+
+				newTable->slots[slot] = oldEntry;
+				newTable->numEntries++;
+			}
+		}
+
+		deAtomicStoreReleasePtr((void* volatile*)&m_storedTable, newTable);
+		m_retiredTables.push_back(table);
+		table = newTable;
+	}
+
+	{
+		const deUint32	mask	= table->capacity - 1u;
+		deUint32		slot	= entry->hash.words[0] & mask;
+
+		while (table->slots[slot])
+			slot = (slot + 1u) & mask;
+
+		// Entry must be fully visible before it is published
+		deAtomicStoreReleasePtr((void* volatile*)&table->slots[slot], entry);
+		table->numEntries++;
+	}
+}
+
+void ShaderCache::store (const ProgramBinary& binary, const string& key)
+{
+	const ShaderCacheHash	hash	= computeShaderCacheHash(key);
+	de::ScopedLock			lock	(m_writeLock);
+
+	{
+		// Already in cache (written by another thread, probably)
+		de::UniquePtr<ProgramBinary> existing (loadMapped(hash, key));
+
+		if (existing)
+			return;
+	}
+
+	{
+		de::UniquePtr<ProgramBinary> existing (loadStored(hash, key));
+
+		if (existing)
+			return;
+	}
+
+	{
+		de::MovePtr<Entry> entry (new Entry());
+
+		entry->hash		= hash;
+		entry->format	= binary.getFormat();
+		entry->binary	= vector<deUint8>(binary.getBinary(), binary.getBinary() + binary.getSize());
+		entry->key		= key;
+
+		if (m_dataFile && !m_appendFailed)
+		{
+			const ScopedFileLock	fileLock	(m_lockFile);
+			RecordHeader			header;
+			FILE*					file		= fopen(m_filename.c_str(), "ab");
+			bool					ok			= file != DE_NULL;
+
+			deMemset(&header, 0, sizeof(header));
+			header.magic		= RECORD_MAGIC;
+			header.binarySize	= (deUint32)binary.getSize();
+			header.keySize		= (deUint32)key.size();
+			header.size			= getRecordSize(header.binarySize, header.keySize);
+			header.format		= (deUint32)binary.getFormat();
+			deMemcpy(header.hash, hash.words, sizeof(header.hash));
+
+			if (ok)
+			{
+				const deUint8	padding[sizeof(deUint32)]	= { 0, 0, 0, 0 };
+				const size_t	paddingSize					= header.size - sizeof(header) - header.binarySize - header.keySize;
+
+				ok = fwrite(&header, 1, sizeof(header), file) == sizeof(header);
+
+				if (ok && binary.getSize() > 0)
+					ok = fwrite(binary.getBinary(), 1, binary.getSize(), file) == binary.getSize();
+
+				if (ok && !key.empty())
+					ok = fwrite(key.c_str(), 1, key.size(), file) == key.size();
+
+				if (ok && paddingSize > 0)
+					ok = fwrite(padding, 1, paddingSize, file) == paddingSize;
+
+				ok = (fclose(file) == 0) && ok;
+			}
+
+			// \note Torn record ends the valid part of the data file, so nothing is appended after it. Binary
+			//		 is still available from memory for the rest of the run and the record is dropped by
+			//		 compaction when the cache is opened next time.
+			if (!ok)
+				m_appendFailed = true;
+		}
+
+		insertStored(entry.release());
+	}
+}
+
+namespace
+{
+
+struct ShaderCacheParams
+{
+	const char*	filename;
+	bool		truncate;
+};
+
+volatile deSingletonState	s_shaderCacheState	= DE_SINGLETON_STATE_NOT_INITIALIZED;
+ShaderCache*				s_shaderCache		= DE_NULL;
+
+void createShaderCache (void* arg)
+{
+	const ShaderCacheParams* params = (const ShaderCacheParams*)arg;
+
+	s_shaderCache = new ShaderCache(params->filename, params->truncate);
+}
+
+} // anonymous
+
+ShaderCache& getShaderCache (const char* filename, bool truncate)
+{
+	ShaderCacheParams params;
+
+	params.filename	= filename;
+	params.truncate	= truncate;
+
+	deInitSingleton(&s_shaderCacheState, createShaderCache, &params);
+
+	return *s_shaderCache;
+}
+
+// Self-test
+
+namespace
+{
+
+vector<deUint8> readFile (const string& filename)
+{
+	FILE*			file	= fopen(filename.c_str(), "rb");
+	vector<deUint8>	data;
+
+	DE_TEST_ASSERT(file);
+
+	for (;;)
+	{
+		deUint8			buf[4096];
+		const size_t	numRead	= fread(buf, 1, sizeof(buf), file);
+
+		data.insert(data.end(), buf, buf + numRead);
+
+		if (numRead < sizeof(buf))
+			break;
+	}
+
+	fclose(file);
+
+	return data;
+}
+
+ProgramBinary makeTestBinary (int seed, size_t size)
+{
+	vector<deUint8> data (size);
+
+	for (size_t ndx = 0; ndx < size; ndx++)
+		data[ndx] = (deUint8)(deUint32Hash((deUint32)(seed * 7919 + (int)ndx)));
+
+	return ProgramBinary(PROGRAM_FORMAT_SPIRV, size, data.empty() ? DE_NULL : &data[0]);
+}
+
+string makeTestKey (int seed)
+{
+	return "#version 450\nvoid main (void) { /* " + de::toString(seed) + " */ }\n";
+}
+
+bool isCached (const ShaderCache& cache, int seed, size_t size)
+{
+	const de::UniquePtr<ProgramBinary>	loaded		(cache.load(makeTestKey(seed)));
+	const ProgramBinary					reference	= makeTestBinary(seed, size);
+
+	if (!loaded)
+		return false;
+
+	DE_TEST_ASSERT(loaded->getFormat() == reference.getFormat());
+	DE_TEST_ASSERT(loaded->getSize() == reference.getSize());
+	DE_TEST_ASSERT(reference.getSize() == 0 || deMemCmp(loaded->getBinary(), reference.getBinary(), reference.getSize()) == 0);
+
+	return true;
+}
+
+void deleteCacheFiles (const string& filename)
+{
+	deDeleteFile(filename.c_str());
+	deDeleteFile(getIndexFilename(filename).c_str());
+	deDeleteFile(getLockFilename(filename).c_str());
+}
+
+} // anonymous
+
+void shaderCacheSelfTest (void)
+{
+	const string	filename	= "vk-shader-cache-selftest.bin";
+	const int		numBinaries	= 5;
+
+	// Round trip within one instance
+	{
+		ShaderCache cache (filename, true);
+
+		for (int ndx = 0; ndx < numBinaries; ndx++)
+			cache.store(makeTestBinary(ndx, (size_t)ndx * 13u), makeTestKey(ndx));
+
+		for (int ndx = 0; ndx < numBinaries; ndx++)
+			DE_TEST_ASSERT(isCached(cache, ndx, (size_t)ndx * 13u));
+
+		DE_TEST_ASSERT(!isCached(cache, numBinaries, 0));
+	}
+
+	// Reopen finds stored binaries, and binaries appended after reopening
+	{
+		ShaderCache cache (filename, false);
+
+		for (int ndx = 0; ndx < numBinaries; ndx++)
+			DE_TEST_ASSERT(isCached(cache, ndx, (size_t)ndx * 13u));
+
+		cache.store(makeTestBinary(numBinaries, 100u), makeTestKey(numBinaries));
+	}
+
+	{
+		const ShaderCache cache (filename, false);
+
+		for (int ndx = 0; ndx < numBinaries; ndx++)
+			DE_TEST_ASSERT(isCached(cache, ndx, (size_t)ndx * 13u));
+
+		DE_TEST_ASSERT(isCached(cache, numBinaries, 100u));
+	}
+
+	// Compaction drops duplicates written by independent caches
+	{
+		const size_t sizeBefore = readFile(filename).size();
+
+		{
+			ShaderCache cacheA (filename, false);
+			ShaderCache cacheB (filename, false);
+
+			cacheA.store(makeTestBinary(100, 1000u), makeTestKey(100));
+			cacheB.store(makeTestBinary(100, 1000u), makeTestKey(100));
+		}
+
+		DE_TEST_ASSERT(readFile(filename).size() > sizeBefore + 2000u);
+
+		ShaderCache::compact(filename);
+
+		DE_TEST_ASSERT(readFile(filename).size() > sizeBefore + 1000u);
+		DE_TEST_ASSERT(readFile(filename).size() < sizeBefore + 2000u);
+
+		{
+			const ShaderCache cache (filename, false);
+
+			for (int ndx = 0; ndx < numBinaries; ndx++)
+				DE_TEST_ASSERT(isCached(cache, ndx, (size_t)ndx * 13u));
+
+			DE_TEST_ASSERT(isCached(cache, 100, 1000u));
+		}
+	}
+
+	// Truncated record at the end of data file is dropped
+	{
+		vector<deUint8> data;
+
+		{
+			ShaderCache cache (filename, false);
+			cache.store(makeTestBinary(200, 64u), makeTestKey(200));
+		}
+
+		data = readFile(filename);
+		data.resize(data.size() - 10u);
+		DE_TEST_ASSERT(writeFile(filename, data));
+
+		{
+			ShaderCache cache (filename, false);
+
+			DE_TEST_ASSERT(!isCached(cache, 200, 64u));
+			DE_TEST_ASSERT(isCached(cache, 100, 1000u));
+
+			for (int ndx = 0; ndx < numBinaries; ndx++)
+				DE_TEST_ASSERT(isCached(cache, ndx, (size_t)ndx * 13u));
+
+			cache.store(makeTestBinary(200, 64u), makeTestKey(200));
+		}
+
+		{
+			const ShaderCache cache (filename, false);
+			DE_TEST_ASSERT(isCached(cache, 200, 64u));
+		}
+	}
+
+	// Corrupt record and corrupt index
+	{
+		vector<deUint8>	data	= readFile(filename);
+		RecordHeader	header;
+
+		// Key of first record doesn't match anymore
+		deMemcpy(&header, &data[sizeof(FileHeader)], sizeof(header));
+		data[sizeof(FileHeader) + header.size - 1u - (header.size - sizeof(header) - header.binarySize - header.keySize)] ^= 0xffu;
+		DE_TEST_ASSERT(writeFile(filename, data));
+
+		{
+			const ShaderCache cache (filename, false);
+
+			DE_TEST_ASSERT(!isCached(cache, 0, 0u));
+
+			for (int ndx = 1; ndx < numBinaries; ndx++)
+				DE_TEST_ASSERT(isCached(cache, ndx, (size_t)ndx * 13u));
+		}
+
+		// Record magic is broken, rest of the file can't be trusted
+		data[sizeof(FileHeader)] ^= 0xffu;
+		DE_TEST_ASSERT(writeFile(filename, data));
+		DE_TEST_ASSERT(writeFile(getIndexFilename(filename), vector<deUint8>(sizeof(IndexHeader) + 3u, 0xabu)));
+
+		{
+			ShaderCache cache (filename, false);
+
+			for (int ndx = 0; ndx < numBinaries; ndx++)
+				DE_TEST_ASSERT(!isCached(cache, ndx, (size_t)ndx * 13u));
+
+			cache.store(makeTestBinary(0, 0u), makeTestKey(0));
+			DE_TEST_ASSERT(isCached(cache, 0, 0u));
+		}
+
+		{
+			const ShaderCache cache (filename, false);
+			DE_TEST_ASSERT(isCached(cache, 0, 0u));
+		}
+	}
+
+	deleteCacheFiles(filename);
+}
+
+} // vk
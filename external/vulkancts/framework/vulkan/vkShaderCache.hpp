@@ -0,0 +1,136 @@
+#ifndef _VKSHADERCACHE_HPP
+#define _VKSHADERCACHE_HPP
+/*-------------------------------------------------------------------------
+ * Vulkan CTS Framework
+ * --------------------
+ *
+ * Copyright (c) 2020 The Khronos Group Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *//*!
+ * \file
+ * \brief Persistent shader binary cache.
+ *//*--------------------------------------------------------------------*/
+
+#include "vkDefs.hpp"
+#include "vkPrograms.hpp"
+#include "deMutex.hpp"
+#include "deMappedFile.h"
+#include "deFile.h"
+
+#include <string>
+#include <vector>
+
+namespace vk
+{
+
+// Shader Cache
+// ------------
+//
+// Compiled binaries are stored in an append-only data file. Every record
+// is identified by a 128-bit content hash of the cache key, which contains
+// the shader sources, build options and compiler versions. The key itself
+// is stored along the binary and compared on lookup.
+//
+// Data file (<filename>):
+//   FileHeader, followed by RecordHeader + binary + key (padded to 4 bytes)
+//   for each record.
+//
+// Index file (<filename>.idx):
+//   IndexHeader, followed by an open addressing (linear probing) hash table
+//   of IndexEntry. Table capacity is a power of two and empty slots have
+//   offset 0. The index records how many bytes of the data file it covers.
+//
+// Both files are memory mapped when the cache is opened. If the index is
+// missing or does not cover the whole data file, the tail is scanned and
+// the index is rewritten. Duplicate and torn records are dropped by
+// compacting the data file when they make up a significant part of it.
+//
+// Lookups from the mapped files need no locking. Binaries stored during
+// the current run are appended to the data file under a writer lock and
+// published to an in-memory table that readers also access without locks.
+//
+// Processes sharing a cache hold an exclusive lock on <filename>.lock
+// while opening, compacting or appending to the cache files.
+
+struct ShaderCacheHash
+{
+	deUint32	words[4];
+
+	bool		operator==	(const ShaderCacheHash& other) const;
+	bool		operator!=	(const ShaderCacheHash& other) const { return !(*this == other); }
+	bool		operator<	(const ShaderCacheHash& other) const;
+};
+
+ShaderCacheHash	computeShaderCacheHash	(const std::string& key);
+
+class ShaderCache
+{
+public:
+							ShaderCache		(const std::string& filename, bool truncate);
+							~ShaderCache	(void);
+
+	//! Find binary by key. Returns DE_NULL if not found. Safe to call concurrently with store().
+	ProgramBinary*			load			(const std::string& key) const;
+
+	//! Append binary to cache unless it is already there.
+	void					store			(const ProgramBinary& binary, const std::string& key);
+
+	//! Rewrite data file dropping duplicate and invalid records, and rebuild the index. Takes the cache file lock.
+	static void				compact			(const std::string& filename);
+
+private:
+							ShaderCache		(const ShaderCache&);
+	ShaderCache&			operator=		(const ShaderCache&);
+
+	struct Entry
+	{
+		ShaderCacheHash			hash;
+		ProgramFormat			format;
+		std::vector<deUint8>	binary;
+		std::string				key;
+	};
+
+	struct Table
+	{
+		deUint32			capacity;
+		deUint32			numEntries;
+		Entry* volatile*	slots;
+	};
+
+	void					open			(bool truncate);
+	ProgramBinary*			loadMapped		(const ShaderCacheHash& hash, const std::string& key) const;
+	ProgramBinary*			loadStored		(const ShaderCacheHash& hash, const std::string& key) const;
+	void					insertStored	(Entry* entry);
+
+	const std::string		m_filename;
+
+	deFile*					m_lockFile;
+	deMappedFile*			m_dataFile;
+	deMappedFile*			m_indexFile;
+
+	de::Mutex				m_writeLock;
+	bool					m_appendFailed;
+	Table* volatile			m_storedTable;
+	std::vector<Table*>		m_retiredTables;
+};
+
+//! Get process-wide cache. The cache is opened (and optionally truncated) on first call.
+ShaderCache&	getShaderCache			(const char* filename, bool truncate);
+
+void			shaderCacheSelfTest		(void);
+
+} // vk
+
+#endif // _VKSHADERCACHE_HPP
@@ -0,0 +1,421 @@
+/*-------------------------------------------------------------------------
+ * Vulkan CTS Framework
+ * --------------------
+ *
+ * Copyright (c) 2020 Google Inc.
+ * Copyright (c) 2020 The Khronos Group Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *//*!
+ * \file
+ * \brief Sub-allocating memory allocator.
+ *//*--------------------------------------------------------------------*/
+
+#include "vkSubAllocator.hpp"
+#include "vkRefUtil.hpp"
+#include "deInt32.h"
+
+#include <map>
+#include <set>
+
+namespace vk
+{
+
+using de::MovePtr;
+using std::vector;
+
+namespace
+{
+
+VkDeviceSize roundUpToPowerOfTwo (VkDeviceSize value)
+{
+	return (VkDeviceSize)deSmallestGreaterOrEquallPowerOfTwoU64((deUint64)value);
+}
+
+VkDeviceSize roundDownToPowerOfTwo (VkDeviceSize value)
+{
+	DE_ASSERT(value > 0);
+	return (VkDeviceSize)1u << (63 - deClz64((deUint64)value));
+}
+
+deUint32 selectMemoryType (const VkPhysicalDeviceMemoryProperties& deviceMemProps, deUint32 allowedMemTypeBits, MemoryRequirement requirement)
+{
+	const deUint32	candidates	= allowedMemTypeBits & getCompatibleMemoryTypes(deviceMemProps, requirement);
+
+	if (candidates == 0)
+		TCU_THROW(NotSupportedError, "No compatible memory type found");
+
+	return (deUint32)deCtz32(candidates);
+}
+
+bool canSubAllocateFromType (const VkPhysicalDeviceMemoryProperties& deviceMemProps, deUint32 memoryTypeNdx)
+{
+	// \note Lazily allocated memory is meant for transient attachments and protected memory may have
+	//		 restrictions that don't fit sub-allocation, so they are always allocated separately.
+	const VkMemoryPropertyFlags	separateFlags	= VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT|VK_MEMORY_PROPERTY_PROTECTED_BIT;
+	const VkMemoryPropertyFlags	hostFlags		= VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT|VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+
+	DE_ASSERT(memoryTypeNdx < deviceMemProps.memoryTypeCount);
+
+	const VkMemoryPropertyFlags	propertyFlags	= deviceMemProps.memoryTypes[memoryTypeNdx].propertyFlags;
+
+	// \note flushAlloc() and invalidateAlloc() operate from allocation offset to the end of the memory object.
+	//		 On non-coherent memory that would flush or discard host writes of neighbouring sub-allocations.
+	if ((propertyFlags & hostFlags) == VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+		return false;
+
+	return (propertyFlags & separateFlags) == 0u;
+}
+
+Move<VkDeviceMemory> allocateBlockMemory (const DeviceInterface& vk, VkDevice device, deUint32 memoryTypeNdx, VkDeviceSize size)
+{
+	const VkMemoryAllocateInfo	allocInfo	=
+	{
+		VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,	//	VkStructureType			sType;
+		DE_NULL,								//	const void*				pNext;
+		size,									//	VkDeviceSize			allocationSize;
+		memoryTypeNdx,							//	deUint32				memoryTypeIndex;
+	};
+
+	return allocateMemory(vk, device, &allocInfo);
+}
+
+} // anonymous
+
+// SubAllocator::MemoryBlock
+
+//! Single VkDeviceMemory managed by a binary buddy allocator
+class SubAllocator::MemoryBlock
+{
+public:
+								MemoryBlock			(const DeviceInterface& vk, VkDevice device, deUint32 memoryTypeNdx, VkDeviceSize size, VkDeviceSize minAllocationSize, bool hostVisible);
+								~MemoryBlock		(void);
+
+	bool						allocate			(VkDeviceSize size, VkDeviceSize& offset);
+	void						free				(VkDeviceSize offset);
+
+	bool						isEmpty				(void) const { return m_allocated.empty();		}
+	VkDeviceSize				getSize				(void) const { return m_size;					}
+	VkDeviceMemory				getMemory			(void) const { return *m_memory;				}
+	void*						getHostPtr			(VkDeviceSize offset) const;
+
+private:
+								MemoryBlock			(const MemoryBlock&); // disabled, non-copyable
+	MemoryBlock&				operator=			(const MemoryBlock&); // disabled, non-copyable
+
+	int							getLevel			(VkDeviceSize size) const;
+	VkDeviceSize				getLevelSize		(int level) const { return m_size >> level;	}
+
+	const DeviceInterface&		m_vk;
+	const VkDevice				m_device;
+	const VkDeviceSize			m_size;
+	const Move<VkDeviceMemory>	m_memory;
+	void*						m_hostPtr;
+
+	//! Free ranges by level, level 0 is the whole block and each following level halves the size.
+	vector<std::set<VkDeviceSize> >	m_freeLists;
+	std::map<VkDeviceSize, int>		m_allocated;		//!< Level of each allocation by offset.
+};
+
+SubAllocator::MemoryBlock::MemoryBlock (const DeviceInterface& vk, VkDevice device, deUint32 memoryTypeNdx, VkDeviceSize size, VkDeviceSize minAllocationSize, bool hostVisible)
+	: m_vk			(vk)
+	, m_device		(device)
+	, m_size		(size)
+	, m_memory		(allocateBlockMemory(vk, device, memoryTypeNdx, size))
+	, m_hostPtr		(DE_NULL)
+{
+	DE_ASSERT(deIsPowerOfTwo64(size) && deIsPowerOfTwo64(minAllocationSize) && minAllocationSize <= size);
+
+	m_freeLists.resize(getLevel(minAllocationSize) + 1);
+	m_freeLists[0].insert(0u);
+
+	// Keep host-visible blocks mapped for their whole lifetime.
+	if (hostVisible)
+		m_hostPtr = mapMemory(vk, device, *m_memory, 0u, VK_WHOLE_SIZE, 0u);
+}
+
+SubAllocator::MemoryBlock::~MemoryBlock (void)
+{
+	if (m_hostPtr)
+		m_vk.unmapMemory(m_device, *m_memory);
+}
+
+int SubAllocator::MemoryBlock::getLevel (VkDeviceSize size) const
+{
+	DE_ASSERT(deIsPowerOfTwo64(size) && size <= m_size);
+	return deClz64((deUint64)size) - deClz64((deUint64)m_size);
+}
+
+void* SubAllocator::MemoryBlock::getHostPtr (VkDeviceSize offset) const
+{
+	return m_hostPtr ? (deUint8*)m_hostPtr + offset : DE_NULL;
+}
+
+bool SubAllocator::MemoryBlock::allocate (VkDeviceSize size, VkDeviceSize& offset)
+{
+	const int	level		= getLevel(size);
+	int			freeLevel	= level;
+
+	DE_ASSERT(level < (int)m_freeLists.size());
+
+	// Find smallest free range that is large enough.
+	while (freeLevel >= 0 && m_freeLists[freeLevel].empty())
+		freeLevel -= 1;
+
+	if (freeLevel < 0)
+		return false;
+
+	offset = *m_freeLists[freeLevel].begin();
+	m_freeLists[freeLevel].erase(m_freeLists[freeLevel].begin());
+
+	// Split until range is of requested size, upper halves are left free.
+	while (freeLevel < level)
+	{
+		freeLevel += 1;
+		m_freeLists[freeLevel].insert(offset + getLevelSize(freeLevel));
+	}
+
+	m_allocated[offset] = level;
+
+	return true;
+}
+
+void SubAllocator::MemoryBlock::free (VkDeviceSize offset)
+{
+	const std::map<VkDeviceSize, int>::iterator	allocPos	= m_allocated.find(offset);
+	int											level		= 0;
+
+	DE_ASSERT(allocPos != m_allocated.end());
+
+	level = allocPos->second;
+	m_allocated.erase(allocPos);
+
+	// Merge with free buddies.
+	while (level > 0)
+	{
+		const VkDeviceSize buddyOffset = offset ^ getLevelSize(level);
+
+		if (m_freeLists[level].erase(buddyOffset) == 0)
+			break;
+
+		offset	= de::min(offset, buddyOffset);
+		level	-= 1;
+	}
+
+	m_freeLists[level].insert(offset);
+}
+
+// SubAllocator::SubAllocation
+
+class SubAllocator::SubAllocation : public Allocation
+{
+public:
+						SubAllocation		(SubAllocator& allocator, deUint32 memoryTypeNdx, MemoryBlock& block, VkDeviceSize offset, VkDeviceSize size, VkDeviceSize requestedSize);
+						~SubAllocation		(void);
+
+	deUint32			getMemoryTypeIndex	(void) const { return m_memoryTypeNdx;	}
+	MemoryBlock&		getBlock			(void) const { return m_block;			}
+	VkDeviceSize		getSize				(void) const { return m_size;			}
+	VkDeviceSize		getRequestedSize	(void) const { return m_requestedSize;	}
+
+private:
+	SubAllocator&		m_allocator;
+	const deUint32		m_memoryTypeNdx;
+	MemoryBlock&		m_block;
+	const VkDeviceSize	m_size;
+	const VkDeviceSize	m_requestedSize;
+};
+
+SubAllocator::SubAllocation::SubAllocation (SubAllocator& allocator, deUint32 memoryTypeNdx, MemoryBlock& block, VkDeviceSize offset, VkDeviceSize size, VkDeviceSize requestedSize)
+	: Allocation		(block.getMemory(), offset, block.getHostPtr(offset))
+	, m_allocator		(allocator)
+	, m_memoryTypeNdx	(memoryTypeNdx)
+	, m_block			(block)
+	, m_size			(size)
+	, m_requestedSize	(requestedSize)
+{
+}
+
+SubAllocator::SubAllocation::~SubAllocation (void)
+{
+	m_allocator.free(this);
+}
+
+// SubAllocator
+
+SubAllocator::SubAllocator (const DeviceInterface&						vk,
+							VkDevice									device,
+							const VkPhysicalDeviceMemoryProperties&		deviceMemProps,
+							const VkPhysicalDeviceLimits&				deviceLimits,
+							VkDeviceSize								maxBlockSize)
+	: m_vk					(vk)
+	, m_device				(device)
+	, m_memProps			(deviceMemProps)
+	, m_minAllocationSize	(roundUpToPowerOfTwo(de::max(de::max((VkDeviceSize)MIN_ALLOCATION_SIZE, deviceLimits.bufferImageGranularity), deviceLimits.nonCoherentAtomSize)))
+	, m_dedicatedAllocator	(vk, device, deviceMemProps)
+	, m_blockSizes			(deviceMemProps.memoryTypeCount)
+	, m_blocks				(deviceMemProps.memoryTypeCount)
+{
+	DE_ASSERT(deIsPowerOfTwo64(maxBlockSize));
+
+	for (deUint32 memoryTypeNdx = 0; memoryTypeNdx < deviceMemProps.memoryTypeCount; memoryTypeNdx++)
+	{
+		// Limit blocks to 1/8 of the heap so that small heaps are not exhausted by few blocks.
+		const VkDeviceSize	heapSize	= deviceMemProps.memoryHeaps[deviceMemProps.memoryTypes[memoryTypeNdx].heapIndex].size;
+		const VkDeviceSize	blockSize	= heapSize >= 8u ? de::min(maxBlockSize, roundDownToPowerOfTwo(heapSize / 8u)) : 0u;
+
+		// \note Zero block size disables sub-allocation from the type.
+		m_blockSizes[memoryTypeNdx] = blockSize >= 2u*m_minAllocationSize ? blockSize : 0u;
+	}
+}
+
+SubAllocator::~SubAllocator (void)
+{
+}
+
+VkDeviceSize SubAllocator::getBlockSize (deUint32 memoryTypeNdx) const
+{
+	DE_ASSERT(memoryTypeNdx < m_memProps.memoryTypeCount);
+	return m_blockSizes[memoryTypeNdx];
+}
+
+MovePtr<Allocation> SubAllocator::allocate (const VkMemoryAllocateInfo& allocInfo, VkDeviceSize alignment)
+{
+	const deUint32	memoryTypeNdx	= allocInfo.memoryTypeIndex;
+
+	// Extension structures may request dedicated, exported or otherwise special memory.
+	if (allocInfo.pNext == DE_NULL						&&
+		canSubAllocateFromType(m_memProps, memoryTypeNdx)	&&
+		allocInfo.allocationSize <= getBlockSize(memoryTypeNdx) / 2u)
+		return subAllocate(memoryTypeNdx, allocInfo.allocationSize, alignment);
+
+	{
+		MovePtr<Allocation>		allocation	= m_dedicatedAllocator.allocate(allocInfo, alignment);
+		const de::ScopedLock	lock		(m_lock);
+
+		m_statistics.numDedicatedAllocations += 1;
+
+		return allocation;
+	}
+}
+
+MovePtr<Allocation> SubAllocator::allocate (const VkMemoryRequirements& memReqs, MemoryRequirement requirement)
+{
+	if (!(requirement & (MemoryRequirement::Protected | MemoryRequirement::LazilyAllocated | MemoryRequirement::DeviceAddress)))
+	{
+		const deUint32	memoryTypeNdx	= selectMemoryType(m_memProps, memReqs.memoryTypeBits, requirement);
+
+		if (canSubAllocateFromType(m_memProps, memoryTypeNdx) && memReqs.size <= getBlockSize(memoryTypeNdx) / 2u)
+			return subAllocate(memoryTypeNdx, memReqs.size, memReqs.alignment);
+	}
+
+	{
+		MovePtr<Allocation>		allocation	= m_dedicatedAllocator.allocate(memReqs, requirement);
+		const de::ScopedLock	lock		(m_lock);
+
+		m_statistics.numDedicatedAllocations += 1;
+
+		return allocation;
+	}
+}
+
+MovePtr<Allocation> SubAllocator::subAllocate (deUint32 memoryTypeNdx, VkDeviceSize size, VkDeviceSize alignment)
+{
+	// Buddy ranges are aligned to their size.
+	const VkDeviceSize			allocSize	= roundUpToPowerOfTwo(de::max(de::max(size, alignment), m_minAllocationSize));
+	const de::ScopedLock		lock		(m_lock);
+	vector<MemoryBlockSp>&		blocks		= m_blocks[memoryTypeNdx];
+	MemoryBlock*				block		= DE_NULL;
+	VkDeviceSize				offset		= 0u;
+
+	DE_ASSERT(allocSize <= getBlockSize(memoryTypeNdx));
+
+	for (size_t blockNdx = 0; blockNdx < blocks.size(); blockNdx++)
+	{
+		if (blocks[blockNdx]->allocate(allocSize, offset))
+		{
+			block = blocks[blockNdx].get();
+			break;
+		}
+	}
+
+	if (!block)
+	{
+		const bool			hostVisible	= (m_memProps.memoryTypes[memoryTypeNdx].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0u;
+		const MemoryBlockSp	newBlock	(new MemoryBlock(m_vk, m_device, memoryTypeNdx, getBlockSize(memoryTypeNdx), m_minAllocationSize, hostVisible));
+
+		blocks.push_back(newBlock);
+
+		m_statistics.numBlockAllocations	+= 1;
+		m_statistics.numBlocks				+= 1;
+		m_statistics.blockMemorySize		+= newBlock->getSize();
+
+		block = newBlock.get();
+
+		if (!block->allocate(allocSize, offset))
+			DE_FATAL("Allocation from empty block failed");
+	}
+
+	m_statistics.numSubAllocations	+= 1;
+	m_statistics.subAllocatedSize	+= allocSize;
+	m_statistics.requestedSize		+= size;
+
+	return MovePtr<Allocation>(new SubAllocation(*this, memoryTypeNdx, *block, offset, allocSize, size));
+}
+
+void SubAllocator::free (SubAllocation* allocation)
+{
+	const de::ScopedLock	lock	(m_lock);
+	MemoryBlock&			block	= allocation->getBlock();
+
+	block.free(allocation->getOffset());
+
+	m_statistics.subAllocatedSize	-= allocation->getSize();
+	m_statistics.requestedSize		-= allocation->getRequestedSize();
+
+	if (block.isEmpty())
+	{
+		// Keep one empty block per memory type around to avoid re-allocating it when allocations come and go.
+		vector<MemoryBlockSp>&	blocks		= m_blocks[allocation->getMemoryTypeIndex()];
+		int						numEmpty	= 0;
+		size_t					blockPos	= blocks.size();
+
+		for (size_t blockNdx = 0; blockNdx < blocks.size(); blockNdx++)
+		{
+			if (blocks[blockNdx].get() == &block)
+				blockPos = blockNdx;
+
+			if (blocks[blockNdx]->isEmpty())
+				numEmpty += 1;
+		}
+
+		DE_ASSERT(blockPos < blocks.size());
+
+		if (numEmpty > 1)
+		{
+			m_statistics.numBlocks			-= 1;
+			m_statistics.blockMemorySize	-= block.getSize();
+
+			blocks.erase(blocks.begin() + blockPos);
+		}
+	}
+}
+
+SubAllocator::Statistics SubAllocator::getStatistics (void) const
+{
+	const de::ScopedLock lock (m_lock);
+	return m_statistics;
+}
+
+} // vk
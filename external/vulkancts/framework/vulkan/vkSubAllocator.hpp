@@ -0,0 +1,128 @@
+#ifndef _VKSUBALLOCATOR_HPP
+#define _VKSUBALLOCATOR_HPP
+/*-------------------------------------------------------------------------
+ * Vulkan CTS Framework
+ * --------------------
+ *
+ * Copyright (c) 2020 Google Inc.
+ * Copyright (c) 2020 The Khronos Group Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *//*!
+ * \file
+ * \brief Sub-allocating memory allocator.
+ *//*--------------------------------------------------------------------*/
+
+#include "vkDefs.hpp"
+#include "vkMemUtil.hpp"
+#include "deMutex.hpp"
+#include "deSharedPtr.hpp"
+
+#include <vector>
+
+namespace vk
+{
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Allocator that sub-allocates from large per-memory-type blocks
+ *
+ * Memory is allocated in blocks of getBlockSize() bytes, one pool of
+ * blocks per memory type, and handed out with a buddy allocator. Host-
+ * visible blocks are mapped once for their whole lifetime.
+ *
+ * Sub-allocations are aligned to and rounded up to a power of two that
+ * is at least bufferImageGranularity and nonCoherentAtomSize, so linear
+ * and non-linear resources never share a granularity page.
+ *
+ * Requests that can't be served from a block - allocations with pNext
+ * chains, protected, lazily allocated or device address memory, host-
+ * visible memory that is not coherent, and allocations larger than half
+ * a block - get a dedicated VkDeviceMemory. flushAlloc() and
+ * invalidateAlloc() cover everything from the allocation offset to the
+ * end of the memory object, so non-coherent allocations can't share it.
+ *
+ * Allocator must outlive all allocations made from it. All methods are
+ * thread-safe.
+ *//*--------------------------------------------------------------------*/
+class SubAllocator : public Allocator
+{
+public:
+	enum
+	{
+		DEFAULT_BLOCK_SIZE		= 64*1024*1024,	//!< Upper limit for block size, smaller blocks are used for small heaps.
+		MIN_ALLOCATION_SIZE		= 256			//!< Smallest sub-allocation size.
+	};
+
+	struct Statistics
+	{
+		deUint64		numSubAllocations;			//!< Number of allocations served from blocks.
+		deUint64		numDedicatedAllocations;	//!< Number of allocations that got their own VkDeviceMemory.
+		deUint64		numBlockAllocations;		//!< Number of VkDeviceMemory objects allocated for blocks.
+		deUint32		numBlocks;					//!< Number of blocks currently allocated.
+		VkDeviceSize	blockMemorySize;			//!< Total size of currently allocated blocks.
+		VkDeviceSize	subAllocatedSize;			//!< Total size of live sub-allocations, including rounding.
+		VkDeviceSize	requestedSize;				//!< Total requested size of live sub-allocations.
+
+		Statistics (void)
+			: numSubAllocations			(0)
+			, numDedicatedAllocations	(0)
+			, numBlockAllocations		(0)
+			, numBlocks					(0)
+			, blockMemorySize			(0)
+			, subAllocatedSize			(0)
+			, requestedSize				(0)
+		{
+		}
+	};
+
+											SubAllocator		(const DeviceInterface&						vk,
+																 VkDevice									device,
+																 const VkPhysicalDeviceMemoryProperties&	deviceMemProps,
+																 const VkPhysicalDeviceLimits&				deviceLimits,
+																 VkDeviceSize								maxBlockSize = DEFAULT_BLOCK_SIZE);
+											~SubAllocator		(void);
+
+	de::MovePtr<Allocation>					allocate			(const VkMemoryAllocateInfo& allocInfo, VkDeviceSize alignment);
+	de::MovePtr<Allocation>					allocate			(const VkMemoryRequirements& memRequirements, MemoryRequirement requirement);
+
+	VkDeviceSize							getBlockSize		(deUint32 memoryTypeNdx) const;
+	VkDeviceSize							getMinAllocationSize(void) const { return m_minAllocationSize; }
+	Statistics								getStatistics		(void) const;
+
+private:
+											SubAllocator		(const SubAllocator&); // disabled, non-copyable
+	SubAllocator&							operator=			(const SubAllocator&); // disabled, non-copyable
+
+	class MemoryBlock;
+	class SubAllocation;
+	typedef de::SharedPtr<MemoryBlock>		MemoryBlockSp;
+
+	de::MovePtr<Allocation>					subAllocate			(deUint32 memoryTypeNdx, VkDeviceSize size, VkDeviceSize alignment);
+	void									free				(SubAllocation* allocation);
+
+	const DeviceInterface&					m_vk;
+	const VkDevice							m_device;
+	const VkPhysicalDeviceMemoryProperties	m_memProps;
+	const VkDeviceSize						m_minAllocationSize;
+	SimpleAllocator							m_dedicatedAllocator;
+
+	mutable de::Mutex						m_lock;
+	std::vector<VkDeviceSize>				m_blockSizes;		//!< Block size per memory type.
+	std::vector<std::vector<MemoryBlockSp> >	m_blocks;		//!< Blocks per memory type.
+	Statistics								m_statistics;
+};
+
+} // vk
+
+#endif // _VKSUBALLOCATOR_HPP
@@ -85,6 +85,10 @@ public:
 	// Otherwise, defaults to target Vulkan 1.0, SPIR-V 1.0.
 	void setSpirVAsmBuildOptions(const vk::SpirVAsmBuildOptions& asm_options);
 	void delayedInit (void) override;
+
+	// Programs come from the script parsed in delayedInit.
+	bool canPrefetchPrograms (void) const override { return false; }
+
 	void initPrograms (vk::SourceCollections& programCollection) const override;
 
 	// Add a required instance extension, device extension, or feature bit.
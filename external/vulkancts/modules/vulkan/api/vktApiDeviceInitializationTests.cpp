@@ -2058,6 +2058,204 @@ tcu::TestStatus createInstanceDeviceIntentionalAllocFail (Context& context)
 	return tcu::TestStatus::pass("Pass");
 }
 
+VkDeviceCreateInfo makePoolTestDeviceCreateInfo (const void* pNext, deUint32 queueCreateInfoCount, const VkDeviceQueueCreateInfo* pQueueCreateInfos, deUint32 extensionCount, const char* const* ppExtensionNames, const VkPhysicalDeviceFeatures* pEnabledFeatures)
+{
+	const VkDeviceCreateInfo	deviceCreateInfo	=
+	{
+		VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,	// VkStructureType					sType;
+		pNext,									// const void*						pNext;
+		(VkDeviceCreateFlags)0u,				// VkDeviceCreateFlags				flags;
+		queueCreateInfoCount,					// deUint32							queueCreateInfoCount;
+		pQueueCreateInfos,						// const VkDeviceQueueCreateInfo*	pQueueCreateInfos;
+		0u,										// deUint32							enabledLayerCount;
+		DE_NULL,								// const char* const*				ppEnabledLayerNames;
+		extensionCount,							// deUint32							enabledExtensionCount;
+		ppExtensionNames,						// const char* const*				ppEnabledExtensionNames;
+		pEnabledFeatures,						// const VkPhysicalDeviceFeatures*	pEnabledFeatures;
+	};
+
+	return deviceCreateInfo;
+}
+
+VkDeviceQueueCreateInfo makePoolTestQueueCreateInfo (const void* pNext, deUint32 queueFamilyIndex, deUint32 queueCount, const float* pQueuePriorities)
+{
+	const VkDeviceQueueCreateInfo	queueCreateInfo	=
+	{
+		VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,	// VkStructureType			sType;
+		pNext,										// const void*				pNext;
+		(VkDeviceQueueCreateFlags)0u,				// VkDeviceQueueCreateFlags	flags;
+		queueFamilyIndex,							// deUint32					queueFamilyIndex;
+		queueCount,									// deUint32					queueCount;
+		pQueuePriorities,							// const float*				pQueuePriorities;
+	};
+
+	return queueCreateInfo;
+}
+
+// Keys are computed without creating devices, so create infos don't need to be supported by the implementation.
+tcu::TestStatus customDevicePoolKeyTest (Context& context)
+{
+	CustomDevicePool						pool					(context.getPlatformInterface(), context.getInstance(), context.getInstanceInterface(), false, 1u);
+	const VkPhysicalDevice					physicalDevice			= context.getPhysicalDevice();
+	const float								priorities[]			= { 1.0f, 0.5f };
+	const float								otherPriorities[]		= { 1.0f, 0.25f };
+	const char* const						extensions[]			= { "VK_KHR_a", "VK_KHR_b" };
+	const char* const						reversedExtensions[]	= { "VK_KHR_b", "VK_KHR_a" };
+	const VkDeviceQueueCreateInfo			queueInfos[]			=
+	{
+		makePoolTestQueueCreateInfo(DE_NULL, 0u, 1u, priorities),
+		makePoolTestQueueCreateInfo(DE_NULL, 1u, 2u, priorities),
+	};
+	const VkDeviceQueueCreateInfo			reversedQueueInfos[]	=
+	{
+		queueInfos[1],
+		queueInfos[0],
+	};
+	const VkDeviceQueueCreateInfo			otherQueueInfos[]		=
+	{
+		queueInfos[0],
+		makePoolTestQueueCreateInfo(DE_NULL, 1u, 2u, otherPriorities),
+	};
+	VkPhysicalDeviceFeatures				features;
+	VkPhysicalDevice16BitStorageFeatures	storageFeatures			= initVulkanStructure();
+	VkPhysicalDeviceMultiviewFeatures		multiviewFeatures		= initVulkanStructure(&storageFeatures);
+	VkPhysicalDevice16BitStorageFeatures	storageFeaturesB		= initVulkanStructure();
+	VkPhysicalDeviceMultiviewFeatures		multiviewFeaturesB		= initVulkanStructure();
+	VkPhysicalDevice16BitStorageFeatures	otherStorageFeatures	= initVulkanStructure();
+	VkPhysicalDeviceMultiviewFeatures		otherMultiview			= initVulkanStructure(&otherStorageFeatures);
+
+	deMemset(&features, 0, sizeof(features));
+
+	storageFeatures.storageBuffer16BitAccess		= VK_TRUE;
+	storageFeaturesB.storageBuffer16BitAccess		= VK_TRUE;
+	otherStorageFeatures.storageBuffer16BitAccess	= VK_TRUE;
+	otherMultiview.multiview						= VK_TRUE;
+
+	// Same structures as multiviewFeatures chain, linked in the opposite order.
+	storageFeaturesB.pNext = &multiviewFeaturesB;
+
+	const VkDeviceCreateInfo				baseInfo				= makePoolTestDeviceCreateInfo(&multiviewFeatures, DE_LENGTH_OF_ARRAY(queueInfos), queueInfos, DE_LENGTH_OF_ARRAY(extensions), extensions, DE_NULL);
+	const VkDeviceCreateInfo				equivalentInfos[]		=
+	{
+		makePoolTestDeviceCreateInfo(&multiviewFeatures, DE_LENGTH_OF_ARRAY(reversedQueueInfos), reversedQueueInfos, DE_LENGTH_OF_ARRAY(extensions), extensions, DE_NULL),
+		makePoolTestDeviceCreateInfo(&multiviewFeatures, DE_LENGTH_OF_ARRAY(queueInfos), queueInfos, DE_LENGTH_OF_ARRAY(reversedExtensions), reversedExtensions, DE_NULL),
+		makePoolTestDeviceCreateInfo(&storageFeaturesB, DE_LENGTH_OF_ARRAY(queueInfos), queueInfos, DE_LENGTH_OF_ARRAY(extensions), extensions, DE_NULL),
+		makePoolTestDeviceCreateInfo(&storageFeaturesB, DE_LENGTH_OF_ARRAY(reversedQueueInfos), reversedQueueInfos, DE_LENGTH_OF_ARRAY(reversedExtensions), reversedExtensions, DE_NULL),
+	};
+	const VkDeviceCreateInfo				differentInfos[]		=
+	{
+		makePoolTestDeviceCreateInfo(&multiviewFeatures, DE_LENGTH_OF_ARRAY(otherQueueInfos), otherQueueInfos, DE_LENGTH_OF_ARRAY(extensions), extensions, DE_NULL),
+		makePoolTestDeviceCreateInfo(&multiviewFeatures, 1u, queueInfos, DE_LENGTH_OF_ARRAY(extensions), extensions, DE_NULL),
+		makePoolTestDeviceCreateInfo(&multiviewFeatures, DE_LENGTH_OF_ARRAY(queueInfos), queueInfos, 1u, extensions, DE_NULL),
+		makePoolTestDeviceCreateInfo(&multiviewFeatures, DE_LENGTH_OF_ARRAY(queueInfos), queueInfos, DE_LENGTH_OF_ARRAY(extensions), extensions, &features),
+		makePoolTestDeviceCreateInfo(&otherMultiview, DE_LENGTH_OF_ARRAY(queueInfos), queueInfos, DE_LENGTH_OF_ARRAY(extensions), extensions, DE_NULL),
+		makePoolTestDeviceCreateInfo(&storageFeatures, DE_LENGTH_OF_ARRAY(queueInfos), queueInfos, DE_LENGTH_OF_ARRAY(extensions), extensions, DE_NULL),
+	};
+	string									baseKey;
+
+	if (!pool.getKey(physicalDevice, baseInfo, baseKey))
+		return tcu::TestStatus::fail("Create info with feature structures can't be pooled");
+
+	for (int infoNdx = 0; infoNdx < DE_LENGTH_OF_ARRAY(equivalentInfos); infoNdx++)
+	{
+		string	key;
+
+		if (!pool.getKey(physicalDevice, equivalentInfos[infoNdx], key))
+			return tcu::TestStatus::fail("Equivalent create info " + de::toString(infoNdx) + " can't be pooled");
+
+		if (key != baseKey)
+			return tcu::TestStatus::fail("Equivalent create info " + de::toString(infoNdx) + " has a different key");
+	}
+
+	for (int infoNdx = 0; infoNdx < DE_LENGTH_OF_ARRAY(differentInfos); infoNdx++)
+	{
+		string	key;
+
+		if (!pool.getKey(physicalDevice, differentInfos[infoNdx], key))
+			return tcu::TestStatus::fail("Create info " + de::toString(infoNdx) + " can't be pooled");
+
+		if (key == baseKey)
+			return tcu::TestStatus::fail("Different create info " + de::toString(infoNdx) + " has the same key");
+	}
+
+	return tcu::TestStatus::pass("Pass");
+}
+
+tcu::TestStatus customDevicePoolFallbackTest (Context& context)
+{
+	const PlatformInterface&						vkp					= context.getPlatformInterface();
+	const VkInstance								instance			= context.getInstance();
+	const InstanceInterface&						vki					= context.getInstanceInterface();
+	const VkPhysicalDevice							physicalDevice		= context.getPhysicalDevice();
+	const deUint32									queueFamilyIndex	= context.getUniversalQueueFamilyIndex();
+	const float										queuePriority		= 1.0f;
+	VkPhysicalDevice16BitStorageFeatures			duplicateFeatures	= initVulkanStructure();
+	VkPhysicalDevice16BitStorageFeatures			storageFeatures		= initVulkanStructure(&duplicateFeatures);
+	const VkDeviceGroupDeviceCreateInfo				deviceGroupInfo		=
+	{
+		VK_STRUCTURE_TYPE_DEVICE_GROUP_DEVICE_CREATE_INFO,	// VkStructureType			sType;
+		DE_NULL,											// const void*				pNext;
+		1u,													// deUint32					physicalDeviceCount;
+		&physicalDevice,									// const VkPhysicalDevice*	pPhysicalDevices;
+	};
+	const VkDeviceQueueGlobalPriorityCreateInfoEXT	queuePriorityInfo	=
+	{
+		VK_STRUCTURE_TYPE_DEVICE_QUEUE_GLOBAL_PRIORITY_CREATE_INFO_EXT,	// VkStructureType			sType;
+		DE_NULL,														// const void*				pNext;
+		VK_QUEUE_GLOBAL_PRIORITY_MEDIUM_EXT,							// VkQueueGlobalPriorityEXT	globalPriority;
+	};
+	const VkDeviceQueueCreateInfo					queueInfo			= makePoolTestQueueCreateInfo(DE_NULL, queueFamilyIndex, 1u, &queuePriority);
+	const VkDeviceQueueCreateInfo					priorityQueueInfo	= makePoolTestQueueCreateInfo(&queuePriorityInfo, queueFamilyIndex, 1u, &queuePriority);
+	const VkDeviceCreateInfo						poolableInfo		= makePoolTestDeviceCreateInfo(DE_NULL, 1u, &queueInfo, 0u, DE_NULL, DE_NULL);
+	const VkDeviceCreateInfo						unpoolableInfos[]	=
+	{
+		makePoolTestDeviceCreateInfo(&storageFeatures, 1u, &queueInfo, 0u, DE_NULL, DE_NULL),		// Duplicate structure in pNext chain
+		makePoolTestDeviceCreateInfo(&deviceGroupInfo, 1u, &queueInfo, 0u, DE_NULL, DE_NULL),		// Structure other than features
+		makePoolTestDeviceCreateInfo(DE_NULL, 1u, &priorityQueueInfo, 0u, DE_NULL, DE_NULL),		// Extended queue create info
+	};
+
+	{
+		CustomDevicePool	pool	(vkp, instance, vki, false, 1u);
+
+		for (int infoNdx = 0; infoNdx < DE_LENGTH_OF_ARRAY(unpoolableInfos); infoNdx++)
+		{
+			string	key;
+
+			if (pool.getKey(physicalDevice, unpoolableInfos[infoNdx], key))
+				return tcu::TestStatus::fail("Create info " + de::toString(infoNdx) + " was accepted for pooling");
+
+			if (pool.acquire(physicalDevice, unpoolableInfos[infoNdx]) != DE_NULL)
+				return tcu::TestStatus::fail("Pool returned a device for unpoolable create info " + de::toString(infoNdx));
+		}
+
+		const CustomDevicePool::Statistics	stats	= pool.getStatistics();
+
+		if (stats.numRequests != DE_LENGTH_OF_ARRAY(unpoolableInfos) || stats.numUnpooled != DE_LENGTH_OF_ARRAY(unpoolableInfos) || stats.numCreated != 0)
+			return tcu::TestStatus::fail("Unexpected pool statistics");
+	}
+
+	// Disabled pool never hands out devices.
+	{
+		CustomDevicePool	pool	(vkp, instance, vki, false, 0u);
+
+		if (pool.acquire(physicalDevice, poolableInfo) != DE_NULL)
+			return tcu::TestStatus::fail("Disabled pool returned a device");
+
+		if (pool.getStatistics().numUnpooled != 1 || pool.getStatistics().numCreated != 0)
+			return tcu::TestStatus::fail("Unexpected pool statistics");
+	}
+
+	// Fallback must still produce a usable device owned by the caller.
+	{
+		const Unique<VkDevice>	device			(createPooledCustomDevice(context, physicalDevice, &poolableInfo));
+		const DeviceDriver		deviceDriver	(vkp, instance, *device);
+
+		VK_CHECK(deviceDriver.queueWaitIdle(getDeviceQueue(deviceDriver, *device, queueFamilyIndex, 0u)));
+	}
+
+	return tcu::TestStatus::pass("Pass");
+}
+
 } // anonymous
 
 tcu::TestCaseGroup* createDeviceInitializationTests (tcu::TestContext& testCtx)
@@ -2082,6 +2280,8 @@ tcu::TestCaseGroup* createDeviceInitializationTests (tcu::TestContext& testCtx)
 	addFunctionCase(deviceInitializationTests.get(), "create_device_queue2",							"", createDeviceQueue2Test);
 	addFunctionCase(deviceInitializationTests.get(), "create_device_queue2_unmatched_flags",			"", createDeviceQueue2UnmatchedFlagsTest);
 	addFunctionCase(deviceInitializationTests.get(), "create_instance_device_intentional_alloc_fail",	"", createInstanceDeviceIntentionalAllocFail);
+	addFunctionCase(deviceInitializationTests.get(), "custom_device_pool_key",							"", customDevicePoolKeyTest);
+	addFunctionCase(deviceInitializationTests.get(), "custom_device_pool_fallback",						"", customDevicePoolFallbackTest);
 
 	return deviceInitializationTests.release();
 }
@@ -39,8 +39,13 @@
 #include "vkQueryUtil.hpp"
 #include "vkRefUtil.hpp"
 #include "vkAllocationCallbackUtil.hpp"
+#include "vkSubAllocator.hpp"
+#include "vkCmdUtil.hpp"
+#include "vkObjUtil.hpp"
+#include "vkBarrierUtil.hpp"
 
 #include "deUniquePtr.hpp"
+#include "deSharedPtr.hpp"
 #include "deStringUtil.hpp"
 #include "deRandom.hpp"
 
@@ -770,6 +775,209 @@ tcu::TestStatus RandomAllocFreeTestInstance::iterate (void)
 	return tcu::TestStatus::incomplete();
 }
 
+struct SubAllocatorTestConfig
+{
+	deUint32	seed;
+	deUint32	opCount;
+
+	SubAllocatorTestConfig (deUint32 seed_, deUint32 opCount_)
+		: seed		(seed_)
+		, opCount	(opCount_)
+	{
+	}
+};
+
+class SubAllocatorTestInstance : public TestInstance
+{
+public:
+							SubAllocatorTestInstance	(Context& context, SubAllocatorTestConfig config)
+								: TestInstance	(context)
+								, m_config		(config)
+	{
+	}
+
+	tcu::TestStatus			iterate						(void);
+
+private:
+	enum
+	{
+		BLOCK_SIZE			= 1024*1024,	//!< Small blocks to exercise block management.
+		MAX_BUFFER_SIZE		= 64*1024,
+		LARGE_BUFFER_SIZE	= 768*1024		//!< Larger than half block, must get dedicated allocation.
+	};
+
+	struct LiveAllocation
+	{
+		de::SharedPtr<Unique<VkBuffer> >	buffer;
+		de::SharedPtr<Allocation>			allocation;
+		VkDeviceSize						size;
+		deUint8								pattern;
+	};
+
+	const SubAllocatorTestConfig	m_config;
+};
+
+tcu::TestStatus SubAllocatorTestInstance::iterate (void)
+{
+	const DeviceInterface&					vkd					= m_context.getDeviceInterface();
+	const VkDevice							device				= m_context.getDevice();
+	const VkPhysicalDeviceMemoryProperties	memProps			= getPhysicalDeviceMemoryProperties(m_context.getInstanceInterface(), m_context.getPhysicalDevice());
+	const VkPhysicalDeviceLimits			limits				= getPhysicalDeviceProperties(m_context.getInstanceInterface(), m_context.getPhysicalDevice()).limits;
+	SubAllocator							allocator			(vkd, device, memProps, limits, (VkDeviceSize)BLOCK_SIZE);
+	de::Random								rng					(m_config.seed);
+	tcu::TestLog&							log					= m_context.getTestContext().getLog();
+	tcu::ResultCollector					result				(log);
+	vector<LiveAllocation>					liveAllocations;
+	deUint32								numLargeAllocations	= 0;
+
+	for (deUint32 opNdx = 0; opNdx < m_config.opCount; opNdx++)
+	{
+		if (liveAllocations.empty() || rng.getFloat() < 0.6f)
+		{
+			const bool					isLarge		= rng.getFloat() < 0.02f;
+			const VkDeviceSize			size		= isLarge ? (VkDeviceSize)LARGE_BUFFER_SIZE : (VkDeviceSize)rng.getInt(1, MAX_BUFFER_SIZE);
+			const VkBufferCreateInfo	bufferInfo	=
+			{
+				VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+				DE_NULL,
+				0u,
+				size,
+				VK_BUFFER_USAGE_TRANSFER_SRC_BIT|VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+				VK_SHARING_MODE_EXCLUSIVE,
+				0u,
+				DE_NULL
+			};
+			LiveAllocation				newAlloc;
+
+			newAlloc.buffer		= de::SharedPtr<Unique<VkBuffer> >(new Unique<VkBuffer>(createBuffer(vkd, device, &bufferInfo)));
+			newAlloc.allocation	= de::SharedPtr<Allocation>(bindBuffer(vkd, device, allocator, **newAlloc.buffer, MemoryRequirement::HostVisible).release());
+			newAlloc.size		= size;
+			newAlloc.pattern	= (deUint8)rng.getUint32();
+
+			if (isLarge)
+				numLargeAllocations += 1;
+
+			// Check alignment and that the range doesn't overlap with any live allocation.
+			{
+				const VkMemoryRequirements	memReqs		= getBufferMemoryRequirements(vkd, device, **newAlloc.buffer);
+				const VkDeviceSize			offset		= newAlloc.allocation->getOffset();
+
+				result.check(offset % memReqs.alignment == 0, "Allocation offset is not aligned to required alignment");
+				result.check(offset % allocator.getMinAllocationSize() == 0, "Allocation offset is not aligned to minimum allocation size");
+
+				for (size_t allocNdx = 0; allocNdx < liveAllocations.size(); allocNdx++)
+				{
+					const LiveAllocation&	other		= liveAllocations[allocNdx];
+					const VkDeviceSize		otherOffset	= other.allocation->getOffset();
+
+					if (other.allocation->getMemory() == newAlloc.allocation->getMemory())
+						result.check(offset + memReqs.size <= otherOffset || otherOffset + other.size <= offset, "Allocation overlaps with another allocation");
+				}
+			}
+
+			deMemset(newAlloc.allocation->getHostPtr(), newAlloc.pattern, (size_t)size);
+			flushAlloc(vkd, device, *newAlloc.allocation);
+
+			liveAllocations.push_back(newAlloc);
+		}
+		else
+		{
+			const size_t allocNdx = (size_t)rng.getInt(0, (int)liveAllocations.size()-1);
+
+			liveAllocations[allocNdx] = liveAllocations.back();
+			liveAllocations.pop_back();
+		}
+	}
+
+	// Check that contents of live allocations were not overwritten.
+	for (size_t allocNdx = 0; allocNdx < liveAllocations.size(); allocNdx++)
+	{
+		const LiveAllocation&	alloc	= liveAllocations[allocNdx];
+		const deUint8* const	data	= (const deUint8*)alloc.allocation->getHostPtr();
+		bool					isOk	= true;
+
+		invalidateAlloc(vkd, device, *alloc.allocation);
+
+		for (size_t byteNdx = 0; byteNdx < (size_t)alloc.size && isOk; byteNdx++)
+			isOk = data[byteNdx] == alloc.pattern;
+
+		result.check(isOk, "Contents of allocation were overwritten");
+	}
+
+	liveAllocations.clear();
+
+	{
+		const SubAllocator::Statistics stats = allocator.getStatistics();
+
+		log << TestLog::Message << "Sub-allocations: " << stats.numSubAllocations
+								<< ", dedicated allocations: " << stats.numDedicatedAllocations
+								<< ", block allocations: " << stats.numBlockAllocations
+								<< TestLog::EndMessage;
+
+		result.check(stats.numDedicatedAllocations >= numLargeAllocations, "Allocations larger than half a block were not allocated separately");
+		result.check(stats.subAllocatedSize == 0 && stats.requestedSize == 0, "Sub-allocated size is not zero after freeing all allocations");
+		result.check(stats.numBlocks <= memProps.memoryTypeCount, "More than one empty block per memory type was kept");
+		result.check(stats.numSubAllocations == 0 || stats.numBlockAllocations < stats.numSubAllocations, "Blocks were not shared by allocations");
+	}
+
+	return tcu::TestStatus(result.getResult(), result.getMessage());
+}
+
+tcu::TestStatus subAllocatorNeighbourFlushTest (Context& context)
+{
+	// Host writes to an allocation must survive invalidating and flushing its neighbours in the same memory object.
+	const DeviceInterface&					vkd				= context.getDeviceInterface();
+	const VkDevice							device			= context.getDevice();
+	const VkQueue							queue			= context.getUniversalQueue();
+	const deUint32							queueFamilyNdx	= context.getUniversalQueueFamilyIndex();
+	const VkPhysicalDeviceMemoryProperties	memProps		= getPhysicalDeviceMemoryProperties(context.getInstanceInterface(), context.getPhysicalDevice());
+	const VkPhysicalDeviceLimits			limits			= getPhysicalDeviceProperties(context.getInstanceInterface(), context.getPhysicalDevice()).limits;
+	SubAllocator							allocator		(vkd, device, memProps, limits);
+	const VkDeviceSize						bufferSize		= 4096u;
+	const VkBufferCreateInfo				bufferInfo		= makeBufferCreateInfo(bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT|VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+	const Unique<VkBuffer>					bufferB			(createBuffer(vkd, device, &bufferInfo));
+	const de::UniquePtr<Allocation>			allocB			(bindBuffer(vkd, device, allocator, *bufferB, MemoryRequirement::HostVisible));
+	const Unique<VkBuffer>					bufferA			(createBuffer(vkd, device, &bufferInfo));
+	const de::UniquePtr<Allocation>			allocA			(bindBuffer(vkd, device, allocator, *bufferA, MemoryRequirement::HostVisible));
+	const Unique<VkBuffer>					readBuffer		(createBuffer(vkd, device, &bufferInfo));
+	const de::UniquePtr<Allocation>			readAlloc		(bindBuffer(vkd, device, context.getDefaultAllocator(), *readBuffer, MemoryRequirement::HostVisible));
+	const Unique<VkCommandPool>				cmdPool			(makeCommandPool(vkd, device, queueFamilyNdx));
+	const Unique<VkCommandBuffer>			cmdBuffer		(allocateCommandBuffer(vkd, device, *cmdPool, VK_COMMAND_BUFFER_LEVEL_PRIMARY));
+	vector<deUint8>							reference		((size_t)bufferSize);
+
+	for (size_t byteNdx = 0; byteNdx < reference.size(); byteNdx++)
+		reference[byteNdx] = (deUint8)(byteNdx * 7u + 3u);
+
+	context.getTestContext().getLog() << TestLog::Message << "Allocations " << (allocA->getMemory() == allocB->getMemory() ? "share" : "don't share") << " memory object" << TestLog::EndMessage;
+
+	// Write A without flushing, then invalidate and flush neighbour B before flushing A.
+	deMemcpy(allocA->getHostPtr(), &reference[0], reference.size());
+
+	deMemset(allocB->getHostPtr(), 0xcd, (size_t)bufferSize);
+	flushAlloc(vkd, device, *allocB);
+	invalidateAlloc(vkd, device, *allocB);
+
+	flushAlloc(vkd, device, *allocA);
+
+	// Read A back through the device so that host caches can't hide lost writes.
+	beginCommandBuffer(vkd, *cmdBuffer);
+	{
+		const VkBufferCopy				copyRegion	= { 0u, 0u, bufferSize };
+		const VkBufferMemoryBarrier		barrier		= makeBufferMemoryBarrier(VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_HOST_READ_BIT, *readBuffer, 0u, bufferSize);
+
+		vkd.cmdCopyBuffer(*cmdBuffer, *bufferA, *readBuffer, 1u, &copyRegion);
+		vkd.cmdPipelineBarrier(*cmdBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0u, 0u, DE_NULL, 1u, &barrier, 0u, DE_NULL);
+	}
+	endCommandBuffer(vkd, *cmdBuffer);
+	submitCommandsAndWait(vkd, device, queue, *cmdBuffer);
+
+	invalidateAlloc(vkd, device, *readAlloc);
+
+	if (deMemCmp(readAlloc->getHostPtr(), &reference[0], reference.size()) != 0)
+		return tcu::TestStatus::fail("Host writes to allocation were lost when neighbouring allocation was invalidated");
+
+	return tcu::TestStatus::pass("Pass");
+}
 
 } // anonymous
 
@@ -937,6 +1145,23 @@ tcu::TestCaseGroup* createAllocationTestsCommon (tcu::TestContext& testCtx, bool
 		group->addChild(randomGroup.release());
 	}
 
+	if (!useDeviceGroups)
+	{
+		const deUint32					caseCount		= 8;
+		de::MovePtr<tcu::TestCaseGroup>	subAllocGroup	(new tcu::TestCaseGroup(testCtx, "suballocator", "vk::SubAllocator tests."));
+
+		for (deUint32 caseNdx = 0; caseNdx < caseCount; caseNdx++)
+		{
+			const SubAllocatorTestConfig config (deInt32Hash(caseNdx ^ 0x51ab), 1024u);
+
+			subAllocGroup->addChild(new InstanceFactory1<SubAllocatorTestInstance, SubAllocatorTestConfig>(testCtx, tcu::NODETYPE_SELF_VALIDATE, de::toString(caseNdx), "Random allocations and frees", config));
+		}
+
+		addFunctionCase(subAllocGroup.get(), "neighbour_flush", "Flush and invalidate don't affect neighbouring allocations", subAllocatorNeighbourFlushTest);
+
+		group->addChild(subAllocGroup.release());
+	}
+
 	return group.release();
 }
 
@@ -138,6 +138,7 @@ public:
 								: TestCase(testCtx, name, description) {}
 	virtual					~SharedLayoutCase	(void) {}
 	virtual	void			delayedInit			(void);
+	virtual bool			canPrefetchPrograms	(void) const { return false; }
 	virtual	void			initPrograms		(vk::SourceCollections& programCollection) const;
 	virtual	TestInstance*	createInstance		(Context& context) const;
 	virtual void			checkSupport		(Context& context) const;
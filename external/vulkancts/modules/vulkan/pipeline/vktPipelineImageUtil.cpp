@@ -31,6 +31,7 @@
 #include "vkTypeUtil.hpp"
 #include "tcuTextureUtil.hpp"
 #include "tcuAstcUtil.hpp"
+#include "tcuDecompressedTextureCache.hpp"
 #include "deRandom.hpp"
 #include "deSharedPtr.hpp"
 
@@ -981,7 +982,7 @@ void TestTexture::populateCompressedLevels (tcu::CompressedTexFormat format, con
 		m_compressedLevels.push_back(compressedLevel);
 
 		// Store decompressed data
-		compressedLevel->decompress(level, tcu::TexDecompressionParams(tcu::TexDecompressionParams::ASTCMODE_LDR));
+		tcu::DecompressedTextureCache::getInstance().decompress(level, *compressedLevel, tcu::TexDecompressionParams(tcu::TexDecompressionParams::ASTCMODE_LDR));
 	}
 }
 
@@ -73,7 +73,7 @@ Move<VkDevice> createRobustBufferAccessVariablePointersDevice (Context& context)
 	features2.features.robustBufferAccess = VK_TRUE;
 	features2.pNext = &pointerFeatures;
 
-	return createRobustBufferAccessDevice(context, &features2);
+	return createRobustBufferAccessDevice(context, &features2, true);
 }
 
 // A supplementary structures that can hold information about buffer size
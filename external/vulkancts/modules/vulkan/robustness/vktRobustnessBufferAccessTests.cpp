@@ -628,7 +628,7 @@ void RobustBufferReadTest::initPrograms (SourceCollections& programCollection) c
 
 TestInstance* RobustBufferReadTest::createInstance (Context& context) const
 {
-	Move<VkDevice>	device			= createRobustBufferAccessDevice(context);
+	Move<VkDevice>	device			= createRobustBufferAccessDevice(context, DE_NULL, true);
 
 	return new BufferReadInstance(context, device, m_shaderType, m_shaderStage, m_bufferFormat, m_readFromStorage, m_readAccessRange, m_accessOutOfBackingMemory);
 }
@@ -657,7 +657,7 @@ void RobustBufferWriteTest::initPrograms (SourceCollections& programCollection)
 
 TestInstance* RobustBufferWriteTest::createInstance (Context& context) const
 {
-	Move<VkDevice>	device			= createRobustBufferAccessDevice(context);
+	Move<VkDevice>	device			= createRobustBufferAccessDevice(context, DE_NULL, true);
 
 	return new BufferWriteInstance(context, device, m_shaderType, m_shaderStage, m_bufferFormat, m_writeAccessRange, m_accessOutOfBackingMemory);
 }
@@ -64,7 +64,7 @@ vector<string> removeExtensions (const vector<string>& a, const vector<const cha
 	return res;
 }
 
-Move<VkDevice> createRobustBufferAccessDevice (Context& context, const VkPhysicalDeviceFeatures2* enabledFeatures2)
+Move<VkDevice> createRobustBufferAccessDevice (Context& context, const VkPhysicalDeviceFeatures2* enabledFeatures2, bool pooled)
 {
 	const float queuePriority = 1.0f;
 
@@ -108,6 +108,9 @@ Move<VkDevice> createRobustBufferAccessDevice (Context& context, const VkPhysica
         enabledFeatures2 ? NULL : &enabledFeatures	// const VkPhysicalDeviceFeatures*	pEnabledFeatures;
 	};
 
+	if (pooled)
+		return createPooledCustomDevice(context, context.getPhysicalDevice(), &deviceParams);
+
 	return createCustomDevice(context.getTestContext().getCommandLine().isValidationEnabled(), context.getPlatformInterface(),
 							  context.getInstance(), context.getInstanceInterface(), context.getPhysicalDevice(), &deviceParams);
 }
@@ -376,7 +376,7 @@ DrawAccessTest::DrawAccessTest (tcu::TestContext&		testContext,
 
 TestInstance* DrawAccessTest::createInstance (Context& context) const
 {
-	Move<VkDevice> device = createRobustBufferAccessDevice(context);
+	Move<VkDevice> device = createRobustBufferAccessDevice(context, DE_NULL, true);
 
 	return new DrawAccessInstance(context,
 								  device,
@@ -429,7 +429,7 @@ DrawIndexedAccessTest::DrawIndexedAccessTest (tcu::TestContext&		testContext,
 
 TestInstance* DrawIndexedAccessTest::createInstance (Context& context) const
 {
-	Move<VkDevice> device = createRobustBufferAccessDevice(context);
+	Move<VkDevice> device = createRobustBufferAccessDevice(context, DE_NULL, true);
 
 	return new DrawIndexedAccessInstance(context,
 										 device,
@@ -38,6 +38,8 @@
 #include "deUniquePtr.hpp"
 #include "deSharedPtr.hpp"
 #include "deArrayUtil.hpp"
+#include "deThread.hpp"
+#include "deAtomic.h"
 
 #include "tcuCommandLine.hpp"
 #include "tcuFloatFormat.hpp"
@@ -92,7 +94,10 @@ enum
 	// platforms where toggling floating-point rounding mode is slow (emulated arm on x86).
 	// As a workaround watchdog is kept happy by touching it periodically during reference
 	// interval computation.
-	TOUCH_WATCHDOG_VALUE_FREQUENCY	= 512
+	TOUCH_WATCHDOG_VALUE_FREQUENCY	= 512,
+
+	// Reference intervals are computed on multiple threads in batches of this many values.
+	REFERENCE_BATCH_VALUE_COUNT		= 256
 };
 
 namespace vkt
@@ -2257,8 +2262,8 @@ protected:
 		Interval ret;
 
 		TCU_INTERVAL_APPLY_MONOTONE1(ret, arg0, iarg0, val,
-									 TCU_SET_INTERVAL(val, point,
-													  point = this->applyPoint(ctx, arg0)));
+									 TCU_SET_INTERVAL_OPS(val, point, this->getNumExactOps(),
+														  point = this->applyPoint(ctx, arg0)));
 
 		ret |= innerExtrema(ctx, iarg0);
 		ret &= (this->getCodomain(ctx) | TCU_NAN);
@@ -2284,6 +2289,12 @@ protected:
 		TCU_THROW(InternalError, "Cannot apply");
 	}
 
+	//! Number of rounded operations in applyExact(), see TCU_SET_INTERVAL_OPS.
+	virtual int			getNumExactOps	(void) const
+	{
+		return 1;
+	}
+
 	virtual Interval	getCodomain		(const EvalContext&) const
 	{
 		return Interval::unbounded(true);
@@ -2737,6 +2748,7 @@ public:
 
 protected:
 	double		applyExact	(double x) const						{ return 1.0 / deSqrt(x); }
+	int			getNumExactOps	(void) const						{ return 2; }
 
 	double		precision	(const EvalContext& ctx, double ret, double x) const
 	{
@@ -6130,6 +6142,245 @@ struct DefaultSamplings : Samplings<In>
 						instance<DefaultSampling<typename In::In3> >()) {}
 };
 
+/*--------------------------------------------------------------------*//*!
+ * \brief Reference interval evaluation for all input values of a statement.
+ *
+ * Input values are split into batches of REFERENCE_BATCH_VALUE_COUNT values
+ * that are evaluated on multiple threads. Each batch executes the statement
+ * in its own Environment, and reference intervals are stored by value index
+ * so that comparison and logging can be done serially in value order.
+ *//*--------------------------------------------------------------------*/
+template <typename In, typename Out>
+class ReferenceEvaluator
+{
+public:
+	typedef typename Traits<typename Out::Out0>::IVal	IVal0;
+	typedef typename Traits<typename Out::Out1>::IVal	IVal1;
+
+							ReferenceEvaluator	(const Variables<In, Out>&	variables,
+												 const Inputs<In>&			inputs,
+												 const Statement&			stmt,
+												 const FloatFormat&			fmt,
+												 const FloatFormat&			highpFmt,
+												 Precision					precision,
+												 size_t						numValues);
+
+	//! Evaluate all values. Exceptions thrown by batches are re-thrown on the calling thread.
+	void					execute				(tcu::TestContext& testCtx);
+
+	//! Evaluate batches until none are left. Watchdog is touched only if testCtx is not null.
+	void					evaluateBatches		(tcu::TestContext* testCtx);
+
+	const IVal0&			getReference0		(size_t valueNdx) const	{ return m_reference0[valueNdx]; }
+	const IVal1&			getReference1		(size_t valueNdx) const	{ return m_reference1[valueNdx]; }
+
+	//! Re-evaluate output 0 of a single value with Statement::failed(). Must be called on the calling thread.
+	IVal0					evaluateFailed0		(size_t valueNdx) const;
+
+private:
+							ReferenceEvaluator	(const ReferenceEvaluator&);	// disabled, non-copyable
+	ReferenceEvaluator&		operator=			(const ReferenceEvaluator&);	// disabled, non-copyable
+
+	void					initEnvironment		(Environment& env) const;
+	void					setInputs			(Environment& env, size_t valueNdx) const;
+	void					evaluateBatch		(int batchNdx);
+
+	const Variables<In, Out>&	m_variables;
+	const Inputs<In>&			m_inputs;
+	const Statement&			m_stmt;
+	const FloatFormat			m_fmt;
+	const FloatFormat			m_highpFmt;
+	const Precision				m_precision;
+	const size_t				m_numValues;
+	const int					m_numBatches;
+	volatile deInt32			m_nextBatch;
+	std::vector<deUint8>		m_batchFailed;
+	std::vector<IVal0>			m_reference0;
+	std::vector<IVal1>			m_reference1;
+};
+
+template <typename In, typename Out>
+class ReferenceEvaluatorThread : public de::Thread
+{
+public:
+							ReferenceEvaluatorThread	(ReferenceEvaluator<In, Out>& evaluator) : m_evaluator(evaluator) {}
+	void					run							(void) { m_evaluator.evaluateBatches(DE_NULL); }
+
+private:
+	ReferenceEvaluator<In, Out>&	m_evaluator;
+};
+
+template <typename In, typename Out>
+ReferenceEvaluator<In, Out>::ReferenceEvaluator (const Variables<In, Out>&	variables,
+												 const Inputs<In>&			inputs,
+												 const Statement&			stmt,
+												 const FloatFormat&			fmt,
+												 const FloatFormat&			highpFmt,
+												 Precision					precision,
+												 size_t						numValues)
+	: m_variables	(variables)
+	, m_inputs		(inputs)
+	, m_stmt		(stmt)
+	, m_fmt			(fmt)
+	, m_highpFmt	(highpFmt)
+	, m_precision	(precision)
+	, m_numValues	(numValues)
+	, m_numBatches	((int)((numValues + REFERENCE_BATCH_VALUE_COUNT - 1) / REFERENCE_BATCH_VALUE_COUNT))
+	, m_nextBatch	(0)
+	, m_batchFailed	((size_t)m_numBatches, 0)
+	, m_reference0	(numOutputs<Out>() > 0 ? numValues : 0)
+	, m_reference1	(numOutputs<Out>() > 1 ? numValues : 0)
+{
+}
+
+template <typename In, typename Out>
+void ReferenceEvaluator<In, Out>::initEnvironment (Environment& env) const
+{
+	// Initialize environment with dummy values so we don't need to bind in inner loop.
+	const typename Traits<typename In::In0>::IVal	in0;
+	const typename Traits<typename In::In1>::IVal	in1;
+	const typename Traits<typename In::In2>::IVal	in2;
+	const typename Traits<typename In::In3>::IVal	in3;
+	const IVal0										reference0;
+	const IVal1										reference1;
+
+	env.bind(*m_variables.in0, in0);
+	env.bind(*m_variables.in1, in1);
+	env.bind(*m_variables.in2, in2);
+	env.bind(*m_variables.in3, in3);
+	env.bind(*m_variables.out0, reference0);
+	env.bind(*m_variables.out1, reference1);
+}
+
+template <typename In, typename Out>
+void ReferenceEvaluator<In, Out>::setInputs (Environment& env, size_t valueNdx) const
+{
+	env.lookup(*m_variables.in0) = convert<typename In::In0>(m_fmt, round(m_fmt, m_inputs.in0[valueNdx]));
+	env.lookup(*m_variables.in1) = convert<typename In::In1>(m_fmt, round(m_fmt, m_inputs.in1[valueNdx]));
+	env.lookup(*m_variables.in2) = convert<typename In::In2>(m_fmt, round(m_fmt, m_inputs.in2[valueNdx]));
+	env.lookup(*m_variables.in3) = convert<typename In::In3>(m_fmt, round(m_fmt, m_inputs.in3[valueNdx]));
+}
+
+template <typename In, typename Out>
+void ReferenceEvaluator<In, Out>::evaluateBatch (int batchNdx)
+{
+	const size_t		beginNdx	= (size_t)batchNdx * REFERENCE_BATCH_VALUE_COUNT;
+	const size_t		endNdx		= de::min(beginNdx + REFERENCE_BATCH_VALUE_COUNT, m_numValues);
+	const int			outCount	= numOutputs<Out>();
+	Environment			env;
+
+	initEnvironment(env);
+
+	for (size_t valueNdx = beginNdx; valueNdx < endNdx; valueNdx++)
+	{
+		setInputs(env, valueNdx);
+
+		{
+			EvalContext	ctx (m_fmt, m_precision, env, 0);
+			m_stmt.execute(ctx);
+		}
+
+		if (outCount > 1)
+			m_reference1[valueNdx] = convert<typename Out::Out1>(m_highpFmt, env.lookup(*m_variables.out1));
+		if (outCount > 0)
+			m_reference0[valueNdx] = convert<typename Out::Out0>(m_highpFmt, env.lookup(*m_variables.out0));
+	}
+}
+
+template <typename In, typename Out>
+typename ReferenceEvaluator<In, Out>::IVal0 ReferenceEvaluator<In, Out>::evaluateFailed0 (size_t valueNdx) const
+{
+	Environment	env;
+	EvalContext	ctx	(m_fmt, m_precision, env, 0);
+
+	initEnvironment(env);
+	setInputs(env, valueNdx);
+
+	m_stmt.execute(ctx);
+	m_stmt.failed(ctx);
+
+	return convert<typename Out::Out0>(m_highpFmt, env.lookup(*m_variables.out0));
+}
+
+template <typename In, typename Out>
+void ReferenceEvaluator<In, Out>::evaluateBatches (tcu::TestContext* testCtx)
+{
+	for (;;)
+	{
+		const int batchNdx = deAtomicIncrementInt32(&m_nextBatch) - 1;
+
+		if (batchNdx >= m_numBatches)
+			break;
+
+		try
+		{
+			evaluateBatch(batchNdx);
+		}
+		catch (...)
+		{
+			m_batchFailed[batchNdx] = 1;
+		}
+
+		if (testCtx)
+			testCtx->touchWatchdog();
+	}
+}
+
+template <typename In, typename Out>
+void ReferenceEvaluator<In, Out>::execute (tcu::TestContext& testCtx)
+{
+	const int											numThreads	= de::min((int)deGetNumAvailableLogicalCores(), m_numBatches);
+	std::vector<de::SharedPtr<de::Thread> >			threads;
+
+	if (m_numBatches == 0)
+		return;
+
+	// Functions initialize their expanded bodies lazily when first evaluated, so the
+	// first batch is evaluated on this thread before any other threads are started.
+	evaluateBatch(0);
+	testCtx.touchWatchdog();
+	m_nextBatch = 1;
+
+	if (numThreads <= 1)
+	{
+		for (int batchNdx = 1; batchNdx < m_numBatches; batchNdx++)
+		{
+			evaluateBatch(batchNdx);
+			testCtx.touchWatchdog();
+		}
+		return;
+	}
+
+	for (int threadNdx = 1; threadNdx < numThreads; threadNdx++)
+	{
+		const de::SharedPtr<de::Thread> thread (new ReferenceEvaluatorThread<In, Out>(*this));
+
+		try
+		{
+			thread->start();
+		}
+		catch (const std::bad_alloc&)
+		{
+			// Continue with threads started so far.
+			break;
+		}
+
+		threads.push_back(thread);
+	}
+
+	evaluateBatches(&testCtx);
+
+	for (size_t threadNdx = 0; threadNdx < threads.size(); threadNdx++)
+		threads[threadNdx]->join();
+
+	// Batches are independent, so re-running a failed batch reproduces the original exception on this thread.
+	for (int batchNdx = 0; batchNdx < m_numBatches; batchNdx++)
+	{
+		if (m_batchFailed[batchNdx])
+			evaluateBatch(batchNdx);
+	}
+}
+
 template <typename In, typename Out>
 class BuiltinPrecisionCaseTestInstance : public TestInstance
 {
@@ -6164,10 +6415,7 @@ protected:
 template<class In, class Out>
 tcu::TestStatus BuiltinPrecisionCaseTestInstance<In, Out>::iterate (void)
 {
-	typedef typename	In::In0		In0;
 	typedef typename	In::In1		In1;
-	typedef typename	In::In2		In2;
-	typedef typename	In::In3		In3;
 	typedef typename	Out::Out0	Out0;
 	typedef typename	Out::Out1	Out1;
 
@@ -6181,7 +6429,6 @@ tcu::TestStatus BuiltinPrecisionCaseTestInstance<In, Out>::iterate (void)
 	const FloatFormat	highpFmt	= m_caseCtx.highpFormat;
 	const int			maxMsgs		= 100;
 	int					numErrors	= 0;
-	Environment			env;		// Hoisted out of the inner loop for optimization.
 	ResultCollector		status;
 	TestLog&			testLog		= m_context.getTestContext().getLog();
 
@@ -6236,25 +6483,12 @@ tcu::TestStatus BuiltinPrecisionCaseTestInstance<In, Out>::iterate (void)
 
 	m_executor->execute(int(numValues), inputArr, outputArr);
 
-	// Initialize environment with dummy values so we don't need to bind in inner loop.
-	{
-		const typename Traits<In0>::IVal		in0;
-		const typename Traits<In1>::IVal		in1;
-		const typename Traits<In2>::IVal		in2;
-		const typename Traits<In3>::IVal		in3;
-		const typename Traits<Out0>::IVal		reference0;
-		const typename Traits<Out1>::IVal		reference1;
+	// Compute reference intervals for all input tuples.
+	ReferenceEvaluator<In, Out>	evaluator	(m_variables, inputs, *m_stmt, fmt, highpFmt, m_caseCtx.precision, numValues);
 
-		env.bind(*m_variables.in0, in0);
-		env.bind(*m_variables.in1, in1);
-		env.bind(*m_variables.in2, in2);
-		env.bind(*m_variables.in3, in3);
-		env.bind(*m_variables.out0, reference0);
-		env.bind(*m_variables.out1, reference1);
-	}
+	evaluator.execute(m_context.getTestContext());
 
-	// For each input tuple, compute output reference interval and compare
-	// shader output to the reference.
+	// For each input tuple, compare shader output to the reference.
 	for (size_t valueNdx = 0; valueNdx < numValues; valueNdx++)
 	{
 		bool						result			= true;
@@ -6269,19 +6503,11 @@ tcu::TestStatus BuiltinPrecisionCaseTestInstance<In, Out>::iterate (void)
 		if (valueNdx % (size_t)TOUCH_WATCHDOG_VALUE_FREQUENCY == 0)
 			m_context.getTestContext().touchWatchdog();
 
-		env.lookup(*m_variables.in0) = convert<In0>(fmt, round(fmt, inputs.in0[valueNdx]));
-		env.lookup(*m_variables.in1) = convert<In1>(fmt, round(fmt, inputs.in1[valueNdx]));
-		env.lookup(*m_variables.in2) = convert<In2>(fmt, round(fmt, inputs.in2[valueNdx]));
-		env.lookup(*m_variables.in3) = convert<In3>(fmt, round(fmt, inputs.in3[valueNdx]));
-
 		{
-			EvalContext	ctx (fmt, m_caseCtx.precision, env, 0);
-			m_stmt->execute(ctx);
-
 			switch (outCount)
 			{
 				case 2:
-					reference1 = convert<Out1>(highpFmt, env.lookup(*m_variables.out1));
+					reference1 = evaluator.getReference1(valueNdx);
 					if (!status.check(contains(reference1, outputs.out1[valueNdx], m_caseCtx.isPackFloat16b), "Shader output 1 is outside acceptable range"))
 						result = false;
 				// Fallthrough
@@ -6290,11 +6516,10 @@ tcu::TestStatus BuiltinPrecisionCaseTestInstance<In, Out>::iterate (void)
 						// Pass b from mod(a, b) if we are in the modulo operation.
 						const tcu::Maybe<In1> modularDivisor = (m_modularOp ? tcu::just(inputs.in1[valueNdx]) : tcu::Nothing);
 
-						reference0 = convert<Out0>(highpFmt, env.lookup(*m_variables.out0));
+						reference0 = evaluator.getReference0(valueNdx);
 						if (!status.check(contains(reference0, outputs.out0[valueNdx], m_caseCtx.isPackFloat16b, modularDivisor), "Shader output 0 is outside acceptable range"))
 						{
-							m_stmt->failed(ctx);
-							reference0 = convert<Out0>(highpFmt, env.lookup(*m_variables.out0));
+							reference0 = evaluator.evaluateFailed0(valueNdx);
 							if (!status.check(contains(reference0, outputs.out0[valueNdx], m_caseCtx.isPackFloat16b, modularDivisor), "Shader output 0 is outside acceptable range"))
 								result = false;
 						}
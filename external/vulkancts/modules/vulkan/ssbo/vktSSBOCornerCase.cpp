@@ -52,6 +52,7 @@ public:
 		init();
 	}
 	virtual void				delayedInit			(void);
+	virtual bool				canPrefetchPrograms	(void) const { return false; }
 	virtual void				initPrograms		(vk::SourceCollections &programCollection) const;
 	virtual TestInstance*		createInstance		(Context &context) const;
 
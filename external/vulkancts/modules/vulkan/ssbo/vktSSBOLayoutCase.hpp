@@ -242,6 +242,7 @@ public:
 	virtual						~SSBOLayoutCase				(void);
 
 	virtual void				delayedInit					(void);
+	virtual bool				canPrefetchPrograms			(void) const { return false; }
 	virtual void				initPrograms				(vk::SourceCollections& programCollection) const;
 	virtual TestInstance*		createInstance				(Context& context) const;
 	virtual void				checkSupport				(Context &context) const;
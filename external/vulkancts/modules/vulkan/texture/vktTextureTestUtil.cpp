@@ -28,6 +28,7 @@
 #include "deFilePath.hpp"
 #include "deMath.h"
 #include "tcuCompressedTexture.hpp"
+#include "tcuDecompressedTextureCache.hpp"
 #include "tcuImageIO.hpp"
 #include "tcuStringTemplate.hpp"
 #include "tcuTestLog.hpp"
@@ -1605,7 +1606,7 @@ TestTexture2DSp loadTexture2D (const tcu::Archive& archive, const std::vector<st
 			if (fileIndex == 0)
 				texture = TestTexture2DSp(new pipeline::TestTexture2D(commonFormat, level.getWidth(), level.getHeight()));
 
-			level.decompress(decompressedBuffer, tcu::TexDecompressionParams(tcu::TexDecompressionParams::ASTCMODE_LDR));
+			tcu::DecompressedTextureCache::getInstance().decompress(decompressedBuffer, level, tcu::TexDecompressionParams(tcu::TexDecompressionParams::ASTCMODE_LDR));
 
 			tcu::copy(commonFormatBuffer, decompressedBuffer);
 			tcu::copy(texture->getLevel((int)fileIndex, 0), commonFormatBuffer);
@@ -1669,7 +1670,7 @@ TestTextureCubeSp loadTextureCube (const tcu::Archive& archive, const std::vecto
 			if (fileIndex == 0)
 				texture = TestTextureCubeSp(new pipeline::TestTextureCube(commonFormat, level.getWidth()));
 
-			level.decompress(decompressedBuffer, tcu::TexDecompressionParams(tcu::TexDecompressionParams::ASTCMODE_LDR));
+			tcu::DecompressedTextureCache::getInstance().decompress(decompressedBuffer, level, tcu::TexDecompressionParams(tcu::TexDecompressionParams::ASTCMODE_LDR));
 
 			tcu::copy(commonFormatBuffer, decompressedBuffer);
 			tcu::copy(texture->getLevel((int)fileIndex / 6, (int)fileIndex % 6), commonFormatBuffer);
@@ -325,6 +325,7 @@ public:
 							~InterfaceBlockCase			(void);
 
 	virtual void			delayedInit					(void);
+	virtual bool			canPrefetchPrograms			(void) const { return false; }
 	virtual	void			initPrograms				(vk::SourceCollections&	programCollection) const;
 	virtual TestInstance*	createInstance				(Context&				context) const;
 
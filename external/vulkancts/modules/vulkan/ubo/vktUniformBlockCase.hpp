@@ -326,6 +326,7 @@ public:
 								~UniformBlockCase			(void);
 
 	virtual void				delayedInit					(void);
+	virtual bool				canPrefetchPrograms			(void) const { return false; }
 	virtual	void				initPrograms				(vk::SourceCollections& programCollection) const;
 	virtual TestInstance*		createInstance				(Context& context) const;
 	bool						usesBlockLayout				(UniformFlags layoutFlag) const { return m_interface.usesBlockLayout(layoutFlag); }
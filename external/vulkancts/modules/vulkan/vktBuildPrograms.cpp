@@ -30,16 +30,20 @@
 #include "deUniquePtr.hpp"
 #include "vkPrograms.hpp"
 #include "vkBinaryRegistry.hpp"
+#include "vkShaderCache.hpp"
 #include "vktTestCase.hpp"
 #include "vktTestPackage.hpp"
+#include "vktTaskExecutor.hpp"
 #include "deUniquePtr.hpp"
 #include "deCommandLine.hpp"
 #include "deSharedPtr.hpp"
 #include "deThread.hpp"
-#include "deThreadSafeRingBuffer.hpp"
 #include "dePoolArray.hpp"
+#include "deString.h"
+#include "qpInfo.h"
 
 #include <iostream>
+#include <map>
 
 using std::vector;
 using std::string;
@@ -57,130 +61,6 @@ typedef de::SharedPtr<glu::ProgramSources>	ProgramSourcesSp;
 typedef de::SharedPtr<vk::SpirVAsmSource>	SpirVAsmSourceSp;
 typedef de::SharedPtr<vk::ProgramBinary>	ProgramBinarySp;
 
-class Task
-{
-public:
-	virtual void	execute		(void) = 0;
-};
-
-typedef de::ThreadSafeRingBuffer<Task*>	TaskQueue;
-
-class TaskExecutorThread : public de::Thread
-{
-public:
-	TaskExecutorThread (TaskQueue& tasks)
-		: m_tasks(tasks)
-	{
-		start();
-	}
-
-	void run (void)
-	{
-		for (;;)
-		{
-			Task* const	task	= m_tasks.popBack();
-
-			if (task)
-				task->execute();
-			else
-				break; // End of tasks - time to terminate
-		}
-	}
-
-private:
-	TaskQueue&	m_tasks;
-};
-
-class TaskExecutor
-{
-public:
-								TaskExecutor		(deUint32 numThreads);
-								~TaskExecutor		(void);
-
-	void						submit				(Task* task);
-	void						waitForComplete		(void);
-
-private:
-	typedef de::SharedPtr<TaskExecutorThread>	ExecThreadSp;
-
-	std::vector<ExecThreadSp>	m_threads;
-	TaskQueue					m_tasks;
-};
-
-TaskExecutor::TaskExecutor (deUint32 numThreads)
-	: m_threads	(numThreads)
-	, m_tasks	(m_threads.size() * 1024u)
-{
-	for (size_t ndx = 0; ndx < m_threads.size(); ++ndx)
-		m_threads[ndx] = ExecThreadSp(new TaskExecutorThread(m_tasks));
-}
-
-TaskExecutor::~TaskExecutor (void)
-{
-	for (size_t ndx = 0; ndx < m_threads.size(); ++ndx)
-		m_tasks.pushFront(DE_NULL);
-
-	for (size_t ndx = 0; ndx < m_threads.size(); ++ndx)
-		m_threads[ndx]->join();
-}
-
-void TaskExecutor::submit (Task* task)
-{
-	DE_ASSERT(task);
-	m_tasks.pushFront(task);
-}
-
-class SyncTask : public Task
-{
-public:
-	SyncTask (de::Semaphore* enterBarrier, de::Semaphore* inBarrier, de::Semaphore* leaveBarrier)
-		: m_enterBarrier	(enterBarrier)
-		, m_inBarrier		(inBarrier)
-		, m_leaveBarrier	(leaveBarrier)
-	{}
-
-	SyncTask (void)
-		: m_enterBarrier	(DE_NULL)
-		, m_inBarrier		(DE_NULL)
-		, m_leaveBarrier	(DE_NULL)
-	{}
-
-	void execute (void)
-	{
-		m_enterBarrier->increment();
-		m_inBarrier->decrement();
-		m_leaveBarrier->increment();
-	}
-
-private:
-	de::Semaphore*	m_enterBarrier;
-	de::Semaphore*	m_inBarrier;
-	de::Semaphore*	m_leaveBarrier;
-};
-
-void TaskExecutor::waitForComplete (void)
-{
-	de::Semaphore			enterBarrier	(0);
-	de::Semaphore			inBarrier		(0);
-	de::Semaphore			leaveBarrier	(0);
-	std::vector<SyncTask>	syncTasks		(m_threads.size());
-
-	for (size_t ndx = 0; ndx < m_threads.size(); ++ndx)
-	{
-		syncTasks[ndx] = SyncTask(&enterBarrier, &inBarrier, &leaveBarrier);
-		submit(&syncTasks[ndx]);
-	}
-
-	for (size_t ndx = 0; ndx < m_threads.size(); ++ndx)
-		enterBarrier.decrement();
-
-	for (size_t ndx = 0; ndx < m_threads.size(); ++ndx)
-		inBarrier.increment();
-
-	for (size_t ndx = 0; ndx < m_threads.size(); ++ndx)
-		leaveBarrier.decrement();
-}
-
 struct Program
 {
 	enum Status
@@ -203,20 +83,85 @@ struct Program
 
 	vk::SpirvValidatorOptions	validatorOptions;
 
-	explicit				Program		(const vk::ProgramIdentifier& id_, const vk::SpirvValidatorOptions& valOptions_)
+	vk::ShaderCacheHash		sourceHash;
+	const Program*			original;		//!< Program with identical source and build options that is built instead, or DE_NULL.
+
+	explicit				Program		(const vk::ProgramIdentifier& id_, const vk::SpirvValidatorOptions& valOptions_, const vk::ShaderCacheHash& sourceHash_)
 								: id				(id_)
 								, buildStatus		(STATUS_NOT_COMPLETED)
 								, validationStatus	(STATUS_NOT_COMPLETED)
 								, validatorOptions	(valOptions_)
+								, sourceHash		(sourceHash_)
+								, original			(DE_NULL)
 							{}
 							Program		(void)
 								: id				("", "")
 								, buildStatus		(STATUS_NOT_COMPLETED)
 								, validationStatus	(STATUS_NOT_COMPLETED)
 								, validatorOptions()
+								, sourceHash		()
+								, original			(DE_NULL)
 							{}
 };
 
+typedef std::map<vk::ShaderCacheHash, Program*>	ProgramSourceMap;
+
+// Compiler versions are "unknown" when release info was not generated from git checkouts
+// of external sources. Compiler changes can't be detected from the environment then.
+bool isCompilerVersionKnown (void)
+{
+	const char* const	names[]	= { qpGetReleaseGlslName(), qpGetReleaseSpirvToolsName(), qpGetReleaseSpirvHeadersName() };
+
+	for (int ndx = 0; ndx < DE_LENGTH_OF_ARRAY(names); ndx++)
+	{
+		if (deStringEqual(names[ndx], "unknown"))
+			return false;
+	}
+
+	return true;
+}
+
+// Everything besides the program itself that affects the produced binary.
+std::string getCompileEnvironment (const tcu::CommandLine& commandLine)
+{
+	std::ostringstream	str;
+
+	str << "GLSL: " << qpGetReleaseGlslName() << "\n"
+		<< "SPIR-V Tools: " << qpGetReleaseSpirvToolsName() << "\n"
+		<< "SPIR-V Headers: " << qpGetReleaseSpirvHeadersName() << "\n"
+		<< "Optimization: " << (commandLine.isSpirvOptimizationEnabled() ? "enabled" : "disabled")
+		<< ", recipe " << commandLine.getOptimizationRecipe() << "\n";
+
+	return str.str();
+}
+
+//! Returns true if program must be built. Otherwise program is either a duplicate of an
+//! earlier program or its binary was taken from the previous build.
+bool prepareProgram (Program& program, ProgramSourceMap& uniquePrograms, const vk::BinaryRegistryWriter* previousBuild)
+{
+	const ProgramSourceMap::const_iterator	pos	= uniquePrograms.find(program.sourceHash);
+
+	if (pos != uniquePrograms.end())
+	{
+		program.original = pos->second;
+		return false;
+	}
+
+	uniquePrograms[program.sourceHash] = &program;
+
+	if (previousBuild)
+	{
+		if (const vk::ProgramBinary* const binary = previousBuild->findPreviousBinary(program.sourceHash))
+		{
+			program.binary		= ProgramBinarySp(new vk::ProgramBinary(*binary));
+			program.buildStatus	= Program::STATUS_PASSED;
+			return false;
+		}
+	}
+
+	return true;
+}
+
 void writeBuildLogs (const glu::ShaderProgramInfo& buildInfo, std::ostream& dst)
 {
 	for (size_t shaderNdx = 0; shaderNdx < buildInfo.shaders.size(); shaderNdx++)
@@ -380,11 +325,15 @@ struct BuildStats
 	int		numSucceeded;
 	int		numFailed;
 	int		notSupported;
+	int		numDuplicates;	//!< Programs that were not built because an identical program was built for another case.
+	int		numReused;		//!< Programs that were not built because binary from previous build was reused.
 
 	BuildStats (void)
 		: numSucceeded	(0)
 		, numFailed		(0)
 		, notSupported	(0)
+		, numDuplicates	(0)
+		, numReused		(0)
 	{
 	}
 };
@@ -395,8 +344,12 @@ BuildStats buildPrograms (tcu::TestContext&			testCtx,
 						  const deUint32			usedVulkanVersion,
 						  const vk::SpirvVersion	baselineSpirvVersion,
 						  const vk::SpirvVersion	maxSpirvVersion,
-						  const bool				allowSpirV14)
+						  const bool				allowSpirV14,
+						  const bool				incremental)
 {
+	if (incremental && !isCompilerVersionKnown())
+		TCU_THROW(NotSupportedError, "Incremental build requires known glslang and SPIR-V Tools versions, build with git checkouts of external sources or do a full build");
+
 	const deUint32						numThreads			= deGetNumAvailableLogicalCores();
 
 	TaskExecutor						executor			(numThreads);
@@ -405,8 +358,16 @@ BuildStats buildPrograms (tcu::TestContext&			testCtx,
 	de::MemPool							programPool;
 	de::PoolArray<Program>				programs			(&programPool);
 	int									notSupported		= 0;
+	int									numReused			= 0;
+
+	// Registry writer loads binaries from destination path. In incremental mode programs
+	// whose source hash matches one from the previous build reuse its binary.
+	vk::BinaryRegistryWriter			registryWriter		(dstPath);
+	const vk::BinaryRegistryWriter*		previousBuild		= incremental ? &registryWriter : DE_NULL;
+	const std::string					environment			= getCompileEnvironment(testCtx.getCommandLine());
 
 	{
+		ProgramSourceMap					uniquePrograms;
 		de::MemPool							tmpPool;
 		de::PoolArray<BuildHighLevelShaderTask<vk::GlslSource> >	buildGlslTasks		(&tmpPool);
 		de::PoolArray<BuildHighLevelShaderTask<vk::HlslSource> >	buildHlslTasks		(&tmpPool);
@@ -452,7 +413,14 @@ BuildStats buildPrograms (tcu::TestContext&			testCtx,
 						if (progIter.getProgram().buildOptions.targetVersion > maxSpirvVersion && !(allowSpirV14 && progIter.getProgram().buildOptions.supports_VK_KHR_spirv_1_4 && progIter.getProgram().buildOptions.targetVersion == vk::SPIRV_VERSION_1_4))
 							continue;
 
-						programs.pushBack(Program(vk::ProgramIdentifier(casePath, progIter.getName()), progIter.getProgram().buildOptions.getSpirvValidatorOptions()));
+						programs.pushBack(Program(vk::ProgramIdentifier(casePath, progIter.getName()), progIter.getProgram().buildOptions.getSpirvValidatorOptions(), vk::getProgramSourceHash(environment, progIter.getProgram())));
+
+						if (!prepareProgram(programs.back(), uniquePrograms, previousBuild))
+						{
+							numReused += programs.back().original ? 0 : 1;
+							continue;
+						}
+
 						buildGlslTasks.pushBack(BuildHighLevelShaderTask<vk::GlslSource>(progIter.getProgram(), &programs.back()));
 						buildGlslTasks.back().setCommandline(testCtx.getCommandLine());
 						executor.submit(&buildGlslTasks.back());
@@ -467,7 +435,14 @@ BuildStats buildPrograms (tcu::TestContext&			testCtx,
 						if (progIter.getProgram().buildOptions.targetVersion > maxSpirvVersion && !(allowSpirV14 && progIter.getProgram().buildOptions.supports_VK_KHR_spirv_1_4 && progIter.getProgram().buildOptions.targetVersion == vk::SPIRV_VERSION_1_4))
 							continue;
 
-						programs.pushBack(Program(vk::ProgramIdentifier(casePath, progIter.getName()), progIter.getProgram().buildOptions.getSpirvValidatorOptions()));
+						programs.pushBack(Program(vk::ProgramIdentifier(casePath, progIter.getName()), progIter.getProgram().buildOptions.getSpirvValidatorOptions(), vk::getProgramSourceHash(environment, progIter.getProgram())));
+
+						if (!prepareProgram(programs.back(), uniquePrograms, previousBuild))
+						{
+							numReused += programs.back().original ? 0 : 1;
+							continue;
+						}
+
 						buildHlslTasks.pushBack(BuildHighLevelShaderTask<vk::HlslSource>(progIter.getProgram(), &programs.back()));
 						buildHlslTasks.back().setCommandline(testCtx.getCommandLine());
 						executor.submit(&buildHlslTasks.back());
@@ -482,7 +457,14 @@ BuildStats buildPrograms (tcu::TestContext&			testCtx,
 						if (progIter.getProgram().buildOptions.targetVersion > maxSpirvVersion && !(allowSpirV14 && progIter.getProgram().buildOptions.supports_VK_KHR_spirv_1_4 && progIter.getProgram().buildOptions.targetVersion == vk::SPIRV_VERSION_1_4))
 							continue;
 
-						programs.pushBack(Program(vk::ProgramIdentifier(casePath, progIter.getName()), progIter.getProgram().buildOptions.getSpirvValidatorOptions()));
+						programs.pushBack(Program(vk::ProgramIdentifier(casePath, progIter.getName()), progIter.getProgram().buildOptions.getSpirvValidatorOptions(), vk::getProgramSourceHash(environment, progIter.getProgram())));
+
+						if (!prepareProgram(programs.back(), uniquePrograms, previousBuild))
+						{
+							numReused += programs.back().original ? 0 : 1;
+							continue;
+						}
+
 						buildSpirvAsmTasks.pushBack(BuildSpirVAsmTask(progIter.getProgram(), &programs.back()));
 						buildSpirvAsmTasks.back().setCommandline(testCtx.getCommandLine());
 						executor.submit(&buildSpirvAsmTasks.back());
@@ -505,7 +487,7 @@ BuildStats buildPrograms (tcu::TestContext&			testCtx,
 
 		for (de::PoolArray<Program>::iterator progIter = programs.begin(); progIter != programs.end(); ++progIter)
 		{
-			if (progIter->buildStatus == Program::STATUS_PASSED)
+			if (!progIter->original && progIter->buildStatus == Program::STATUS_PASSED)
 			{
 				validationTasks.push_back(ValidateBinaryTask(&*progIter));
 				executor.submit(&validationTasks.back());
@@ -515,23 +497,36 @@ BuildStats buildPrograms (tcu::TestContext&			testCtx,
 		executor.waitForComplete();
 	}
 
+	// Duplicates share results of the program that was built in their place
+	for (de::PoolArray<Program>::iterator progIter = programs.begin(); progIter != programs.end(); ++progIter)
 	{
-		vk::BinaryRegistryWriter	registryWriter		(dstPath);
-
-		for (de::PoolArray<Program>::iterator progIter = programs.begin(); progIter != programs.end(); ++progIter)
+		if (const Program* const original = progIter->original)
 		{
-			if (progIter->buildStatus == Program::STATUS_PASSED)
-				registryWriter.addProgram(progIter->id, *progIter->binary);
+			progIter->buildStatus		= original->buildStatus;
+			progIter->buildLog			= original->buildLog;
+			progIter->binary			= original->binary;
+			progIter->validationStatus	= original->validationStatus;
+			progIter->validationLog		= original->validationLog;
 		}
+	}
 
-		registryWriter.write();
+	for (de::PoolArray<Program>::iterator progIter = programs.begin(); progIter != programs.end(); ++progIter)
+	{
+		if (progIter->buildStatus == Program::STATUS_PASSED)
+			registryWriter.addProgram(progIter->id, *progIter->binary, progIter->sourceHash);
 	}
 
+	registryWriter.write();
+
 	{
 		BuildStats	stats;
-		stats.notSupported = notSupported;
+		stats.notSupported	= notSupported;
+		stats.numReused		= numReused;
 		for (de::PoolArray<Program>::iterator progIter = programs.begin(); progIter != programs.end(); ++progIter)
 		{
+			if (progIter->original)
+				stats.numDuplicates += 1;
+
 			const bool	buildOk			= progIter->buildStatus == Program::STATUS_PASSED;
 			const bool	validationOk	= progIter->validationStatus != Program::STATUS_FAILED;
 
@@ -567,6 +562,7 @@ DE_DECLARE_COMMAND_LINE_OPT(ShaderCacheTruncate,	bool);
 DE_DECLARE_COMMAND_LINE_OPT(SpirvOptimize,			bool);
 DE_DECLARE_COMMAND_LINE_OPT(SpirvOptimizationRecipe,std::string);
 DE_DECLARE_COMMAND_LINE_OPT(SpirvAllow14,			bool);
+DE_DECLARE_COMMAND_LINE_OPT(Incremental,			bool);
 
 static const de::cmdline::NamedValue<bool> s_enableNames[] =
 {
@@ -597,7 +593,8 @@ void registerOptions (de::cmdline::Parser& parser)
 		<< Option<opt::ShaderCacheTruncate>("x", "shadercache-truncate", "Truncate shader cache before running", s_enableNames, "enable")
 		<< Option<opt::SpirvOptimize>("o", "deqp-optimize-spirv", "Enable optimization for SPIR-V", s_enableNames, "disable")
 		<< Option<opt::SpirvOptimizationRecipe>("p","deqp-optimization-recipe", "Shader optimization recipe")
-		<< Option<opt::SpirvAllow14>("e","allow-spirv-14", "Allow SPIR-V 1.4 with Vulkan 1.1");
+		<< Option<opt::SpirvAllow14>("e","allow-spirv-14", "Allow SPIR-V 1.4 with Vulkan 1.1")
+		<< Option<opt::Incremental>("i", "incremental", "Reuse binaries of unchanged programs from previous build in destination path. Requires glslang and SPIR-V Tools versions from git checkouts of external sources");
 }
 
 } // opt
@@ -692,9 +689,11 @@ int main (int argc, const char* argv[])
 																 cmdLine.getOption<opt::VulkanVersion>(),
 																 baselineSpirvVersion,
 																 maxSpirvVersion,
-																 cmdLine.getOption<opt::SpirvAllow14>());
+																 cmdLine.getOption<opt::SpirvAllow14>(),
+																 cmdLine.getOption<opt::Incremental>());
 
 		tcu::print("DONE: %d passed, %d failed, %d not supported\n", stats.numSucceeded, stats.numFailed, stats.notSupported);
+		tcu::print("Programs not built: %d duplicates, %d reused from previous build\n", stats.numDuplicates, stats.numReused);
 
 		return stats.numFailed == 0 ? 0 : -1;
 	}
@@ -26,8 +26,10 @@
 #include "vkQueryUtil.hpp"
 #include "vkDeviceUtil.hpp"
 #include "vkDebugReportUtil.hpp"
+#include "vkDeviceFeatures.hpp"
 #include "tcuCommandLine.hpp"
 #include "vktCustomInstancesDevices.hpp"
+#include "deString.h"
 
 #include <algorithm>
 #include <memory>
@@ -417,5 +419,230 @@ vk::VkResult createUncheckedDevice (bool validationEnabled, const vk::InstanceIn
 	return vki.createDevice(physicalDevice, &createInfo, pAllocator, pDevice);
 }
 
+namespace
+{
+
+template<typename T>
+void appendToKey (string& key, const T& value)
+{
+	key.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void appendNamesToKey (string& key, deUint32 count, const char* const* names)
+{
+	// Order of layers and extensions doesn't matter.
+	std::set<string>	nameSet	(names, names + count);
+
+	appendToKey(key, (deUint32)nameSet.size());
+
+	for (std::set<string>::const_iterator nameIter = nameSet.begin(); nameIter != nameSet.end(); ++nameIter)
+		key.append(nameIter->c_str(), nameIter->size() + 1);
+}
+
+VKAPI_ATTR void VKAPI_CALL releasePooledDevice (vk::VkDevice, const vk::VkAllocationCallbacks*)
+{
+	// Pooled devices are owned by the pool and become available again at the end of the test case.
+}
+
+} // anonymous
+
+CustomDevicePool::CustomDevicePool (const vk::PlatformInterface& vkp, vk::VkInstance instance, const vk::InstanceInterface& vki, bool validationEnabled, size_t maxIdleDevices)
+	: m_vkp					(vkp)
+	, m_instance			(instance)
+	, m_vki					(vki)
+	, m_validationEnabled	(validationEnabled)
+	, m_maxIdleDevices		(maxIdleDevices)
+	, m_useCounter			(0)
+{
+}
+
+CustomDevicePool::~CustomDevicePool ()
+{
+}
+
+bool CustomDevicePool::getKey (vk::VkPhysicalDevice physicalDevice, const vk::VkDeviceCreateInfo& createInfo, string& key)
+{
+	// Extension structures sorted by type so that chain order doesn't matter.
+	std::map<vk::VkStructureType, const vk::VkBaseInStructure*>	extStructs;
+
+	for (const vk::VkBaseInStructure* ext = reinterpret_cast<const vk::VkBaseInStructure*>(createInfo.pNext); ext != DE_NULL; ext = ext->pNext)
+	{
+		if (!extStructs.insert(std::make_pair(ext->sType, ext)).second)
+			return false;
+	}
+
+	key.clear();
+
+	appendToKey(key, physicalDevice);
+	appendToKey(key, createInfo.flags);
+
+	{
+		vector<string> queueKeys;
+
+		for (deUint32 queueNdx = 0; queueNdx < createInfo.queueCreateInfoCount; queueNdx++)
+		{
+			const vk::VkDeviceQueueCreateInfo&	queueInfo	= createInfo.pQueueCreateInfos[queueNdx];
+			string								queueKey;
+
+			if (queueInfo.pNext != DE_NULL)
+				return false;
+
+			appendToKey(queueKey, queueInfo.flags);
+			appendToKey(queueKey, queueInfo.queueFamilyIndex);
+			appendToKey(queueKey, queueInfo.queueCount);
+			queueKey.append(reinterpret_cast<const char*>(queueInfo.pQueuePriorities), queueInfo.queueCount * sizeof(float));
+
+			queueKeys.push_back(queueKey);
+		}
+
+		std::sort(queueKeys.begin(), queueKeys.end());
+
+		appendToKey(key, (deUint32)queueKeys.size());
+
+		for (size_t queueNdx = 0; queueNdx < queueKeys.size(); queueNdx++)
+		{
+			appendToKey(key, (deUint32)queueKeys[queueNdx].size());
+			key += queueKeys[queueNdx];
+		}
+	}
+
+	appendNamesToKey(key, createInfo.enabledLayerCount, createInfo.ppEnabledLayerNames);
+	appendNamesToKey(key, createInfo.enabledExtensionCount, createInfo.ppEnabledExtensionNames);
+
+	appendToKey(key, (deUint8)(createInfo.pEnabledFeatures != DE_NULL));
+
+	if (createInfo.pEnabledFeatures)
+		appendToKey(key, *createInfo.pEnabledFeatures);
+
+	// Only feature structures are known to be plain data; anything else may point to
+	// caller-owned memory or request behavior that must not leak to other test cases.
+	for (std::map<vk::VkStructureType, const vk::VkBaseInStructure*>::const_iterator extIter = extStructs.begin(); extIter != extStructs.end(); ++extIter)
+	{
+		std::map<vk::VkStructureType, size_t>::const_iterator	sizeIter	= m_structSizes.find(extIter->first);
+
+		if (sizeIter == m_structSizes.end())
+			sizeIter = m_structSizes.insert(std::make_pair(extIter->first, vk::getFeatureStructSize(extIter->first))).first;
+
+		if (sizeIter->second == 0)
+			return false;
+
+		appendToKey(key, extIter->first);
+		key.append(reinterpret_cast<const char*>(extIter->second) + sizeof(vk::VkBaseInStructure), sizeIter->second - sizeof(vk::VkBaseInStructure));
+	}
+
+	return true;
+}
+
+vk::VkDevice CustomDevicePool::acquire (vk::VkPhysicalDevice physicalDevice, const vk::VkDeviceCreateInfo& createInfo)
+{
+	string			key;
+	deUint32		keyHash		= 0;
+
+	m_statistics.numRequests += 1;
+
+	if (m_maxIdleDevices == 0 || !getKey(physicalDevice, createInfo, key))
+	{
+		m_statistics.numUnpooled += 1;
+		return DE_NULL;
+	}
+
+	keyHash = deMemoryHash(key.data(), key.size());
+
+	for (size_t entryNdx = 0; entryNdx < m_entries.size(); entryNdx++)
+	{
+		Entry& entry = *m_entries[entryNdx];
+
+		if (!entry.inUse && entry.keyHash == keyHash && entry.key == key)
+		{
+			entry.inUse		= true;
+			entry.lastUse	= ++m_useCounter;
+
+			m_statistics.numHits += 1;
+
+			return *entry.device;
+		}
+	}
+
+	{
+		std::unique_ptr<Entry>	entry	(new Entry());
+
+		entry->key		= key;
+		entry->keyHash	= keyHash;
+		entry->device	= createCustomDevice(m_validationEnabled, m_vkp, m_instance, m_vki, physicalDevice, &createInfo);
+		entry->inUse	= true;
+		entry->lastUse	= ++m_useCounter;
+
+		m_entries.push_back(std::move(entry));
+
+		m_statistics.numCreated += 1;
+
+		return *m_entries.back()->device;
+	}
+}
+
+void CustomDevicePool::release ()
+{
+	const vk::GetDeviceProcAddrFunc	getDeviceProcAddr	= (vk::GetDeviceProcAddrFunc)m_vkp.getInstanceProcAddr(m_instance, "vkGetDeviceProcAddr");
+
+	for (size_t entryNdx = 0; entryNdx < m_entries.size();)
+	{
+		Entry& entry = *m_entries[entryNdx];
+
+		if (entry.inUse)
+		{
+			const vk::DeviceWaitIdleFunc	deviceWaitIdle	= (vk::DeviceWaitIdleFunc)getDeviceProcAddr(*entry.device, "vkDeviceWaitIdle");
+
+			// Lost devices can't be reused.
+			if (deviceWaitIdle(*entry.device) != vk::VK_SUCCESS)
+			{
+				m_entries.erase(m_entries.begin() + entryNdx);
+				continue;
+			}
+
+			entry.inUse = false;
+		}
+
+		entryNdx++;
+	}
+
+	evictIdleDevices();
+}
+
+void CustomDevicePool::evictIdleDevices ()
+{
+	for (;;)
+	{
+		size_t	numIdle	= 0;
+		size_t	lruNdx	= m_entries.size();
+
+		for (size_t entryNdx = 0; entryNdx < m_entries.size(); entryNdx++)
+		{
+			if (m_entries[entryNdx]->inUse)
+				continue;
+
+			numIdle += 1;
+
+			if (lruNdx == m_entries.size() || m_entries[entryNdx]->lastUse < m_entries[lruNdx]->lastUse)
+				lruNdx = entryNdx;
+		}
+
+		if (numIdle <= m_maxIdleDevices)
+			break;
+
+		m_entries.erase(m_entries.begin() + lruNdx);
+		m_statistics.numEvicted += 1;
+	}
+}
+
+vk::Move<vk::VkDevice> createPooledCustomDevice (Context& context, vk::VkPhysicalDevice physicalDevice, const vk::VkDeviceCreateInfo* pCreateInfo)
+{
+	const vk::VkDevice device = context.getCustomDevicePool().acquire(physicalDevice, *pCreateInfo);
+
+	if (device != DE_NULL)
+		return vk::Move<vk::VkDevice>(vk::check<vk::VkDevice>(device), vk::Deleter<vk::VkDevice>(releasePooledDevice, DE_NULL));
+
+	return createCustomDevice(context.getTestContext().getCommandLine().isValidationEnabled(), context.getPlatformInterface(), context.getInstance(), context.getInstanceInterface(), physicalDevice, pCreateInfo);
+}
+
 
 }
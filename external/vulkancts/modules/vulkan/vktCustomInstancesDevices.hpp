@@ -25,8 +25,11 @@
  *//*--------------------------------------------------------------------*/
 
 #include "vkDefs.hpp"
+#include "vkRef.hpp"
 #include "vktTestCase.hpp"
 
+#include <map>
+#include <string>
 #include <vector>
 #include <memory>
 
@@ -116,6 +119,73 @@ vk::Move<vk::VkDevice> createCustomDevice (bool validationEnabled, const vk::Pla
 
 vk::VkResult createUncheckedDevice (bool validationEnabled, const vk::InstanceInterface& vki, vk::VkPhysicalDevice physicalDevice, const vk::VkDeviceCreateInfo* pCreateInfo, const vk::VkAllocationCallbacks* pAllocator, vk::VkDevice* pDevice);
 
+// Pooled custom devices: devices on the default instance that are kept alive between test cases.
+
+class CustomDevicePool
+{
+public:
+	struct Statistics
+	{
+		deUint64	numRequests;	//!< Number of acquire() calls.
+		deUint64	numHits;		//!< Number of requests served with an existing device.
+		deUint64	numCreated;		//!< Number of devices created for the pool.
+		deUint64	numEvicted;		//!< Number of idle devices destroyed to make room.
+		deUint64	numUnpooled;	//!< Number of requests whose create info can't be pooled.
+
+		Statistics (void)
+			: numRequests	(0)
+			, numHits		(0)
+			, numCreated	(0)
+			, numEvicted	(0)
+			, numUnpooled	(0)
+		{
+		}
+	};
+
+								CustomDevicePool	(const vk::PlatformInterface& vkp, vk::VkInstance instance, const vk::InstanceInterface& vki, bool validationEnabled, size_t maxIdleDevices);
+								~CustomDevicePool	();
+
+	// Returns a device created with an equivalent create info, or DE_NULL if create info can't be pooled.
+	// Device is reserved for the caller until release().
+	vk::VkDevice				acquire				(vk::VkPhysicalDevice physicalDevice, const vk::VkDeviceCreateInfo& createInfo);
+
+	// Waits for all acquired devices to become idle and makes them available for reuse.
+	void						release				();
+
+	Statistics					getStatistics		() const { return m_statistics; }
+
+	// Canonical key for equivalent create infos, or false if create info can't be pooled.
+	bool						getKey				(vk::VkPhysicalDevice physicalDevice, const vk::VkDeviceCreateInfo& createInfo, std::string& key);
+
+								CustomDevicePool	(const CustomDevicePool& other) = delete;
+	CustomDevicePool&			operator=			(const CustomDevicePool& other) = delete;
+private:
+	struct Entry
+	{
+		std::string				key;
+		deUint32				keyHash;
+		vk::Move<vk::VkDevice>	device;
+		bool					inUse;
+		deUint64				lastUse;
+	};
+
+	void						evictIdleDevices	();
+
+	const vk::PlatformInterface&			m_vkp;
+	const vk::VkInstance					m_instance;
+	const vk::InstanceInterface&			m_vki;
+	const bool								m_validationEnabled;
+	const size_t							m_maxIdleDevices;
+	std::map<vk::VkStructureType, size_t>	m_structSizes;	//!< Sizes of pNext structures seen so far, 0 if structure can't be pooled.
+	std::vector<std::unique_ptr<Entry>>		m_entries;
+	deUint64								m_useCounter;
+	Statistics								m_statistics;
+};
+
+// Device from context's device pool, or a new custom device if create info can't be pooled. Pooled device may have been
+// used by earlier test cases and remains valid until the end of current case; it must not be kept across cases.
+vk::Move<vk::VkDevice> createPooledCustomDevice (Context& context, vk::VkPhysicalDevice physicalDevice, const vk::VkDeviceCreateInfo* pCreateInfo);
+
 }
 
 #endif // _VKTCUSTOMINSTANCESDEVICES_HPP
@@ -0,0 +1,136 @@
+/*-------------------------------------------------------------------------
+ * Vulkan Conformance Tests
+ * ------------------------
+ *
+ * Copyright (c) 2020 Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *//*!
+ * \file
+ * \brief Thread pool for executing independent tasks
+ *//*--------------------------------------------------------------------*/
+
+#include "vktTaskExecutor.hpp"
+#include "deThread.hpp"
+#include "deSemaphore.hpp"
+
+namespace vkt
+{
+
+class TaskExecutorThread : public de::Thread
+{
+public:
+	TaskExecutorThread (TaskQueue& tasks)
+		: m_tasks(tasks)
+	{
+		start();
+	}
+
+	void run (void)
+	{
+		for (;;)
+		{
+			Task* const	task	= m_tasks.pop();
+
+			if (task)
+				task->execute();
+			else
+				break; // End of tasks - time to terminate
+		}
+	}
+
+private:
+	TaskQueue&	m_tasks;
+};
+
+TaskExecutor::TaskExecutor (deUint32 numThreads)
+	: m_threads	(numThreads)
+	, m_tasks	(m_threads.size() * 1024u)
+{
+	for (size_t ndx = 0; ndx < m_threads.size(); ++ndx)
+		m_threads[ndx] = ExecThreadSp(new TaskExecutorThread(m_tasks));
+}
+
+TaskExecutor::~TaskExecutor (void)
+{
+	for (size_t ndx = 0; ndx < m_threads.size(); ++ndx)
+		m_tasks.push(DE_NULL);
+
+	for (size_t ndx = 0; ndx < m_threads.size(); ++ndx)
+		m_threads[ndx]->join();
+}
+
+void TaskExecutor::submit (Task* task)
+{
+	DE_ASSERT(task);
+	m_tasks.push(task);
+}
+
+namespace
+{
+
+class SyncTask : public Task
+{
+public:
+	SyncTask (de::Semaphore* enterBarrier, de::Semaphore* inBarrier, de::Semaphore* leaveBarrier)
+		: m_enterBarrier	(enterBarrier)
+		, m_inBarrier		(inBarrier)
+		, m_leaveBarrier	(leaveBarrier)
+	{}
+
+	SyncTask (void)
+		: m_enterBarrier	(DE_NULL)
+		, m_inBarrier		(DE_NULL)
+		, m_leaveBarrier	(DE_NULL)
+	{}
+
+	void execute (void)
+	{
+		m_enterBarrier->increment();
+		m_inBarrier->decrement();
+		m_leaveBarrier->increment();
+	}
+
+private:
+	de::Semaphore*	m_enterBarrier;
+	de::Semaphore*	m_inBarrier;
+	de::Semaphore*	m_leaveBarrier;
+};
+
+} // anonymous
+
+void TaskExecutor::waitForComplete (void)
+{
+	de::Semaphore			enterBarrier	(0);
+	de::Semaphore			inBarrier		(0);
+	de::Semaphore			leaveBarrier	(0);
+	std::vector<SyncTask>	syncTasks		(m_threads.size());
+
+	for (size_t ndx = 0; ndx < m_threads.size(); ++ndx)
+	{
+		syncTasks[ndx] = SyncTask(&enterBarrier, &inBarrier, &leaveBarrier);
+		submit(&syncTasks[ndx]);
+	}
+
+	for (size_t ndx = 0; ndx < m_threads.size(); ++ndx)
+		enterBarrier.decrement();
+
+	for (size_t ndx = 0; ndx < m_threads.size(); ++ndx)
+		inBarrier.increment();
+
+	for (size_t ndx = 0; ndx < m_threads.size(); ++ndx)
+		leaveBarrier.decrement();
+}
+
+} // vkt
@@ -0,0 +1,72 @@
+#ifndef _VKTTASKEXECUTOR_HPP
+#define _VKTTASKEXECUTOR_HPP
+/*-------------------------------------------------------------------------
+ * Vulkan Conformance Tests
+ * ------------------------
+ *
+ * Copyright (c) 2020 Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *//*!
+ * \file
+ * \brief Thread pool for executing independent tasks
+ *//*--------------------------------------------------------------------*/
+
+#include "tcuDefs.hpp"
+#include "deLockFreeQueue.hpp"
+#include "deSharedPtr.hpp"
+
+#include <vector>
+
+namespace vkt
+{
+
+class Task
+{
+public:
+	virtual			~Task		(void) {}
+	virtual void	execute		(void) = 0;
+};
+
+typedef de::BlockingLockFreeQueue<Task*>	TaskQueue;
+
+class TaskExecutorThread;
+
+class TaskExecutor
+{
+public:
+								TaskExecutor		(deUint32 numThreads);
+								~TaskExecutor		(void);
+
+	//! Queue task for execution. Task must stay alive until it has been executed.
+	void						submit				(Task* task);
+
+	//! Wait until all submitted tasks have been executed.
+	void						waitForComplete		(void);
+
+	deUint32					getNumThreads		(void) const { return (deUint32)m_threads.size(); }
+
+private:
+								TaskExecutor		(const TaskExecutor&);
+	TaskExecutor&				operator=			(const TaskExecutor&);
+
+	typedef de::SharedPtr<TaskExecutorThread>	ExecThreadSp;
+
+	std::vector<ExecThreadSp>	m_threads;
+	TaskQueue					m_tasks;
+};
+
+} // vkt
+
+#endif // _VKTTASKEXECUTOR_HPP
@@ -29,6 +29,7 @@
 #include "vkQueryUtil.hpp"
 #include "vkDeviceUtil.hpp"
 #include "vkMemUtil.hpp"
+#include "vkSubAllocator.hpp"
 #include "vkPlatform.hpp"
 #include "vkDebugReportUtil.hpp"
 #include "vkDeviceFeatures.hpp"
@@ -438,12 +439,14 @@ namespace
 {
 // Allocator utilities
 
-vk::Allocator* createAllocator (DefaultDevice* device)
+vk::Allocator* createAllocator (DefaultDevice* device, const tcu::CommandLine& cmdLine)
 {
 	const VkPhysicalDeviceMemoryProperties memoryProperties = vk::getPhysicalDeviceMemoryProperties(device->getInstanceInterface(), device->getPhysicalDevice());
 
-	// \todo [2015-07-24 jarkko] support allocator selection/configuration from command line (or compile time)
-	return new SimpleAllocator(device->getDeviceInterface(), device->getDevice(), memoryProperties);
+	if (cmdLine.isVKSuballocationEnabled())
+		return new SubAllocator(device->getDeviceInterface(), device->getDevice(), memoryProperties, device->getDeviceProperties().limits);
+	else
+		return new SimpleAllocator(device->getDeviceInterface(), device->getDevice(), memoryProperties);
 }
 
 } // anonymous
@@ -457,7 +460,9 @@ Context::Context (tcu::TestContext&				testCtx,
 	, m_platformInterface		(platformInterface)
 	, m_progCollection			(progCollection)
 	, m_device					(new DefaultDevice(m_platformInterface, testCtx.getCommandLine()))
-	, m_allocator				(createAllocator(m_device.get()))
+	, m_allocator				(createAllocator(m_device.get(), testCtx.getCommandLine()))
+	, m_devicePool				(new CustomDevicePool(m_platformInterface, m_device->getInstance(), m_device->getInstanceInterface(),
+												  testCtx.getCommandLine().isValidationEnabled(), (size_t)de::max(testCtx.getCommandLine().getVKDevicePoolSize(), 0)))
 	, m_resultSetOnValidation	(false)
 {
 }
@@ -576,6 +581,7 @@ vk::VkQueue								Context::getUniversalQueue					(void) const { return m_device
 deUint32								Context::getSparseQueueFamilyIndex			(void) const { return m_device->getSparseQueueFamilyIndex();	}
 vk::VkQueue								Context::getSparseQueue						(void) const { return m_device->getSparseQueue();				}
 vk::Allocator&							Context::getDefaultAllocator				(void) const { return *m_allocator;								}
+CustomDevicePool&						Context::getCustomDevicePool				(void) const { return *m_devicePool;							}
 deUint32								Context::getUsedApiVersion					(void) const { return m_device->getUsedApiVersion();			}
 bool									Context::contextSupports					(const deUint32 majorNum, const deUint32 minorNum, const deUint32 patchNum) const
 																							{ return m_device->getUsedApiVersion() >= VK_MAKE_VERSION(majorNum, minorNum, patchNum); }
@@ -51,6 +51,7 @@ namespace vkt
 {
 
 class DefaultDevice;
+class CustomDevicePool;
 
 class Context
 {
@@ -100,6 +101,7 @@ public:
 	deUint32										getSparseQueueFamilyIndex			(void) const;
 	vk::VkQueue										getSparseQueue						(void) const;
 	vk::Allocator&									getDefaultAllocator					(void) const;
+	CustomDevicePool&								getCustomDevicePool					(void) const;
 	bool											contextSupports						(const deUint32 majorNum, const deUint32 minorNum, const deUint32 patchNum) const;
 	bool											contextSupports						(const vk::ApiVersion version) const;
 	bool											contextSupports						(const deUint32 requiredApiVersionBits) const;
@@ -127,6 +129,7 @@ protected:
 
 	const de::UniquePtr<DefaultDevice>				m_device;
 	const de::UniquePtr<vk::Allocator>				m_allocator;
+	const de::UniquePtr<CustomDevicePool>			m_devicePool;
 
 	bool											m_resultSetOnValidation;
 
@@ -140,16 +143,17 @@ class TestInstance;
 class TestCase : public tcu::TestCase
 {
 public:
-							TestCase		(tcu::TestContext& testCtx, const std::string& name, const std::string& description);
-							TestCase		(tcu::TestContext& testCtx, tcu::TestNodeType type, const std::string& name, const std::string& description);
-	virtual					~TestCase		(void) {}
+							TestCase				(tcu::TestContext& testCtx, const std::string& name, const std::string& description);
+							TestCase				(tcu::TestContext& testCtx, tcu::TestNodeType type, const std::string& name, const std::string& description);
+	virtual					~TestCase				(void) {}
 
-	virtual void			delayedInit		(void); // non-const init called after checkSupport but before initPrograms
-	virtual void			initPrograms	(vk::SourceCollections& programCollection) const;
-	virtual TestInstance*	createInstance	(Context& context) const = 0;
-	virtual void			checkSupport	(Context& context) const;
+	virtual void			delayedInit				(void); // non-const init called after checkSupport but before initPrograms
+	virtual void			initPrograms			(vk::SourceCollections& programCollection) const;
+	virtual TestInstance*	createInstance			(Context& context) const = 0;
+	virtual void			checkSupport			(Context& context) const;
+	virtual bool			canPrefetchPrograms		(void) const { return true; } // initPrograms may be called ahead of time, before delayedInit
 
-	IterateResult			iterate			(void) { DE_ASSERT(false); return STOP; } // Deprecated in this module
+	IterateResult			iterate					(void) { DE_ASSERT(false); return STOP; } // Deprecated in this module
 };
 
 class TestInstance
@@ -37,10 +37,16 @@
 #include "vkQueryUtil.hpp"
 #include "vkApiVersion.hpp"
 #include "vkRenderDocUtil.hpp"
+#include "vkSubAllocator.hpp"
 
 #include "deUniquePtr.hpp"
+#include "deSharedPtr.hpp"
+#include "deSemaphore.hpp"
+#include "deThread.hpp"
 
 #include "vktTestGroupUtil.hpp"
+#include "vktCustomInstancesDevices.hpp"
+#include "vktTaskExecutor.hpp"
 #include "vktApiTests.hpp"
 #include "vktPipelineTests.hpp"
 #include "vktBindingModelTests.hpp"
@@ -107,6 +113,7 @@
 #include "vktMeshShaderTests.hpp"
 
 #include <vector>
+#include <map>
 #include <sstream>
 
 namespace // compilation
@@ -127,13 +134,200 @@ vk::ProgramBinary* compileProgram (const vk::SpirVAsmSource& source, vk::SpirVPr
 	return vk::assembleProgram(source, buildInfo, commandLine);
 }
 
+//! Compiles program on a worker thread. Results are consumed in source order by buildProgram().
+template <typename InfoType, typename IteratorType>
+class CompileProgramTask : public vkt::Task
+{
+public:
+	CompileProgramTask (IteratorType iter, const tcu::CommandLine& commandLine, de::Semaphore& completed)
+		: m_iter		(iter)
+		, m_commandLine	(commandLine)
+		, m_completed	(completed)
+	{}
+
+	void execute (void)
+	{
+		try
+		{
+			m_binary = de::MovePtr<vk::ProgramBinary>(compileProgram(m_iter.getProgram(), &m_buildInfo, m_commandLine));
+		}
+		catch (const std::exception&)
+		{
+			// Failed builds are repeated serially so that errors and fallbacks are reported in source order
+			m_binary.clear();
+		}
+
+		m_completed.increment();
+	}
+
+	bool							isCompiled		(void) const	{ return m_binary;		}
+	const IteratorType&				getIterator		(void) const	{ return m_iter;		}
+	const InfoType&					getBuildInfo	(void) const	{ return m_buildInfo;	}
+	de::MovePtr<vk::ProgramBinary>	takeBinary		(void)			{ return m_binary;		}
+
+private:
+	const IteratorType				m_iter;
+	const tcu::CommandLine&			m_commandLine;
+	de::Semaphore&					m_completed;
+	InfoType						m_buildInfo;
+	de::MovePtr<vk::ProgramBinary>	m_binary;
+};
+
+typedef CompileProgramTask<glu::ShaderProgramInfo, vk::GlslSourceCollection::Iterator>	GlslCompileTask;
+typedef CompileProgramTask<glu::ShaderProgramInfo, vk::HlslSourceCollection::Iterator>	HlslCompileTask;
+typedef CompileProgramTask<vk::SpirVProgramInfo, vk::SpirVAsmCollection::Iterator>		SpirVAsmCompileTask;
+
+bool operator== (const vk::ShaderBuildOptions& a, const vk::ShaderBuildOptions& b)
+{
+	return a.vulkanVersion				== b.vulkanVersion
+		&& a.targetVersion				== b.targetVersion
+		&& a.flags						== b.flags
+		&& a.supports_VK_KHR_spirv_1_4	== b.supports_VK_KHR_spirv_1_4;
+}
+
+bool operator== (const vk::SpirVAsmBuildOptions& a, const vk::SpirVAsmBuildOptions& b)
+{
+	return a.vulkanVersion					== b.vulkanVersion
+		&& a.targetVersion					== b.targetVersion
+		&& a.supports_VK_KHR_spirv_1_4		== b.supports_VK_KHR_spirv_1_4
+		&& a.supports_VK_KHR_maintenance4	== b.supports_VK_KHR_maintenance4;
+}
+
+template <typename SourceType>
+bool isSameProgram (const SourceType& a, const SourceType& b)
+{
+	for (int shaderType = 0; shaderType < glu::SHADERTYPE_LAST; shaderType++)
+	{
+		if (a.sources[shaderType] != b.sources[shaderType])
+			return false;
+	}
+
+	return a.buildOptions == b.buildOptions;
+}
+
+bool isSameProgram (const vk::SpirVAsmSource& a, const vk::SpirVAsmSource& b)
+{
+	return a.source == b.source && a.buildOptions == b.buildOptions;
+}
+
+vk::SourceCollections* createSourceCollections (deUint32 usedVulkanVersion)
+{
+	const vk::SpirvVersion		baselineSpirvVersion		= vk::getBaselineSpirvVersion(usedVulkanVersion);
+	vk::ShaderBuildOptions		defaultGlslBuildOptions		(usedVulkanVersion, baselineSpirvVersion, 0u);
+	vk::ShaderBuildOptions		defaultHlslBuildOptions		(usedVulkanVersion, baselineSpirvVersion, 0u);
+	vk::SpirVAsmBuildOptions	defaultSpirvAsmBuildOptions	(usedVulkanVersion, baselineSpirvVersion);
+
+	return new vk::SourceCollections(usedVulkanVersion, defaultGlslBuildOptions, defaultHlslBuildOptions, defaultSpirvAsmBuildOptions);
+}
+
+//! Programs of an upcoming test case, built in the background before the case is entered.
+class PrefetchedPrograms
+{
+public:
+	PrefetchedPrograms (deUint32 usedVulkanVersion)
+		: m_sources		(createSourceCollections(usedVulkanVersion))
+		, m_completed	(0)
+		, m_numPending	(0)
+	{
+	}
+
+	~PrefetchedPrograms (void)
+	{
+		// Tasks refer to sources and semaphore owned by this object
+		waitForCompletion();
+	}
+
+	vk::SourceCollections& getSources (void)
+	{
+		return *m_sources;
+	}
+
+	void submit (vkt::TaskExecutor& executor, const tcu::CommandLine& commandLine)
+	{
+		DE_ASSERT(m_numPending == 0);
+
+		for (vk::GlslSourceCollection::Iterator progIter = m_sources->glslSources.begin(); progIter != m_sources->glslSources.end(); ++progIter)
+		{
+			const de::SharedPtr<GlslCompileTask> task (new GlslCompileTask(progIter, commandLine, m_completed));
+
+			m_glslTasks[progIter.getName()] = task;
+			submitTask(executor, task.get());
+		}
+
+		for (vk::HlslSourceCollection::Iterator progIter = m_sources->hlslSources.begin(); progIter != m_sources->hlslSources.end(); ++progIter)
+		{
+			const de::SharedPtr<HlslCompileTask> task (new HlslCompileTask(progIter, commandLine, m_completed));
+
+			m_hlslTasks[progIter.getName()] = task;
+			submitTask(executor, task.get());
+		}
+
+		for (vk::SpirVAsmCollection::Iterator asmIterator = m_sources->spirvAsmSources.begin(); asmIterator != m_sources->spirvAsmSources.end(); ++asmIterator)
+		{
+			const de::SharedPtr<SpirVAsmCompileTask> task (new SpirVAsmCompileTask(asmIterator, commandLine, m_completed));
+
+			m_spirvAsmTasks[asmIterator.getName()] = task;
+			submitTask(executor, task.get());
+		}
+	}
+
+	void waitForCompletion (void)
+	{
+		for (; m_numPending > 0; --m_numPending)
+			m_completed.decrement();
+	}
+
+	bool isComplete (void)
+	{
+		while (m_numPending > 0 && m_completed.tryDecrement())
+			--m_numPending;
+
+		return m_numPending == 0;
+	}
+
+	//! Find task that built the same program. Returns null if test case produced something different this time.
+	de::SharedPtr<GlslCompileTask>		findTask	(const vk::GlslSourceCollection::Iterator& iter) const	{ return findTask(m_glslTasks, iter);		}
+	de::SharedPtr<HlslCompileTask>		findTask	(const vk::HlslSourceCollection::Iterator& iter) const	{ return findTask(m_hlslTasks, iter);		}
+	de::SharedPtr<SpirVAsmCompileTask>	findTask	(const vk::SpirVAsmCollection::Iterator& iter) const	{ return findTask(m_spirvAsmTasks, iter);	}
+
+private:
+	PrefetchedPrograms				(const PrefetchedPrograms&);
+	PrefetchedPrograms&	operator=	(const PrefetchedPrograms&);
+
+	void submitTask (vkt::TaskExecutor& executor, vkt::Task* task)
+	{
+		executor.submit(task);
+		m_numPending++;
+	}
+
+	template <typename TaskType, typename IteratorType>
+	static de::SharedPtr<TaskType> findTask (const std::map<std::string, de::SharedPtr<TaskType> >& tasks, const IteratorType& iter)
+	{
+		const typename std::map<std::string, de::SharedPtr<TaskType> >::const_iterator	found	= tasks.find(iter.getName());
+
+		if (found != tasks.end() && isSameProgram(found->second->getIterator().getProgram(), iter.getProgram()))
+			return found->second;
+		else
+			return de::SharedPtr<TaskType>();
+	}
+
+	const de::UniquePtr<vk::SourceCollections>					m_sources;
+	de::Semaphore												m_completed;
+	size_t														m_numPending;
+
+	std::map<std::string, de::SharedPtr<GlslCompileTask> >		m_glslTasks;
+	std::map<std::string, de::SharedPtr<HlslCompileTask> >		m_hlslTasks;
+	std::map<std::string, de::SharedPtr<SpirVAsmCompileTask> >	m_spirvAsmTasks;
+};
+
 template <typename InfoType, typename IteratorType>
 vk::ProgramBinary* buildProgram (const std::string&					casePath,
 								 IteratorType						iter,
 								 const vk::BinaryRegistryReader&	prebuiltBinRegistry,
 								 tcu::TestLog&						log,
 								 vk::BinaryCollection*				progCollection,
-								 const tcu::CommandLine&			commandLine)
+								 const tcu::CommandLine&			commandLine,
+								 CompileProgramTask<InfoType, IteratorType>*	compiled = DE_NULL)
 {
 	const vk::ProgramIdentifier		progId		(casePath, iter.getName());
 	const tcu::ScopedLogSection		progSection	(log, iter.getName(), "Program: " + iter.getName());
@@ -142,8 +336,16 @@ vk::ProgramBinary* buildProgram (const std::string&					casePath,
 
 	try
 	{
-		binProg	= de::MovePtr<vk::ProgramBinary>(compileProgram(iter.getProgram(), &buildInfo, commandLine));
-		log << buildInfo;
+		if (compiled && compiled->isCompiled())
+		{
+			binProg	= compiled->takeBinary();
+			log << compiled->getBuildInfo();
+		}
+		else
+		{
+			binProg	= de::MovePtr<vk::ProgramBinary>(compileProgram(iter.getProgram(), &buildInfo, commandLine));
+			log << buildInfo;
+		}
 	}
 	catch (const tcu::NotSupportedError& err)
 	{
@@ -195,8 +397,15 @@ public:
 
 	virtual tcu::TestNode::IterateResult		iterate				(tcu::TestCase* testCase);
 
+	virtual void								prefetch			(const vector<tcu::TestCase*>& cases, const vector<std::string>& paths);
+
 private:
+	typedef std::map<std::string, de::SharedPtr<PrefetchedPrograms> >	PrefetchMap;
+
 	void										logUnusedShaders	(tcu::TestCase* testCase);
+	void										logAllocatorStatistics(void);
+	void										releasePooledDevices(void);
+	TaskExecutor&								getCompileExecutor	(void);
 
 	bool										spirvVersionSupported(vk::SpirvVersion);
 	vk::BinaryCollection						m_progCollection;
@@ -210,6 +419,11 @@ private:
 	tcu::WaiverUtil								m_waiverMechanism;
 
 	TestInstance*								m_instance;			//!< Current test case instance
+	vk::SubAllocator::Statistics				m_allocatorStats;	//!< Default allocator statistics at start of current case
+	CustomDevicePool::Statistics				m_devicePoolStats;	//!< Custom device pool statistics at start of current case
+	MovePtr<TaskExecutor>						m_compileExecutor;	//!< Worker pool for building programs, created on first use
+	PrefetchMap									m_prefetched;		//!< Programs of upcoming cases by case path
+	vector<de::SharedPtr<PrefetchedPrograms> >	m_abandoned;		//!< Prefetched programs that were not used but are still being built
 };
 
 static MovePtr<vk::Library> createLibrary (tcu::TestContext& testCtx)
@@ -251,20 +465,108 @@ TestCaseExecutor::TestCaseExecutor (tcu::TestContext& testCtx)
 TestCaseExecutor::~TestCaseExecutor (void)
 {
 	delete m_instance;
+
+	// Wait for background builds before the worker pool goes away
+	m_prefetched.clear();
+	m_abandoned.clear();
+}
+
+TaskExecutor& TestCaseExecutor::getCompileExecutor (void)
+{
+	if (!m_compileExecutor)
+		m_compileExecutor = MovePtr<TaskExecutor>(new TaskExecutor(deGetNumAvailableLogicalCores()));
+
+	return *m_compileExecutor;
+}
+
+void TestCaseExecutor::prefetch (const vector<tcu::TestCase*>& cases, const vector<std::string>& paths)
+{
+	const tcu::CommandLine&	commandLine	= m_context.getTestContext().getCommandLine();
+	PrefetchMap				prefetched;
+
+	DE_ASSERT(cases.size() == paths.size());
+
+	for (size_t ndx = 0; ndx < m_abandoned.size();)
+	{
+		if (m_abandoned[ndx]->isComplete())
+		{
+			m_abandoned[ndx] = m_abandoned.back();
+			m_abandoned.pop_back();
+		}
+		else
+			ndx++;
+	}
+
+	for (size_t caseNdx = 0; caseNdx < cases.size(); ++caseNdx)
+	{
+		const PrefetchMap::iterator	existing	= m_prefetched.find(paths[caseNdx]);
+		TestCase* const				vktCase		= dynamic_cast<TestCase*>(cases[caseNdx]);
+
+		if (existing != m_prefetched.end())
+		{
+			prefetched[paths[caseNdx]] = existing->second;
+			m_prefetched.erase(existing);
+			continue;
+		}
+
+		if (!vktCase || !vktCase->canPrefetchPrograms() || m_waiverMechanism.isOnWaiverList(paths[caseNdx]))
+			continue;
+
+		try
+		{
+			const de::SharedPtr<PrefetchedPrograms>	programs	(new PrefetchedPrograms(m_context.getUsedApiVersion()));
+
+			// Unsupported cases don't need programs, and checkSupport is cheap compared to building them
+			vktCase->checkSupport(m_context);
+			vktCase->initPrograms(programs->getSources());
+
+			programs->submit(getCompileExecutor(), commandLine);
+			prefetched[paths[caseNdx]] = programs;
+		}
+		catch (const std::exception&)
+		{
+			// Errors are reported when the case is executed
+		}
+	}
+
+	// Cases left in the map are not coming up anymore
+	for (PrefetchMap::const_iterator iter = m_prefetched.begin(); iter != m_prefetched.end(); ++iter)
+		m_abandoned.push_back(iter->second);
+
+	m_prefetched.swap(prefetched);
 }
 
 void TestCaseExecutor::init (tcu::TestCase* testCase, const std::string& casePath)
 {
-	TestCase*					vktCase						= dynamic_cast<TestCase*>(testCase);
-	tcu::TestLog&				log							= m_context.getTestContext().getLog();
-	const deUint32				usedVulkanVersion			= m_context.getUsedApiVersion();
-	const vk::SpirvVersion		baselineSpirvVersion		= vk::getBaselineSpirvVersion(usedVulkanVersion);
-	vk::ShaderBuildOptions		defaultGlslBuildOptions		(usedVulkanVersion, baselineSpirvVersion, 0u);
-	vk::ShaderBuildOptions		defaultHlslBuildOptions		(usedVulkanVersion, baselineSpirvVersion, 0u);
-	vk::SpirVAsmBuildOptions	defaultSpirvAsmBuildOptions	(usedVulkanVersion, baselineSpirvVersion);
-	vk::SourceCollections		sourceProgs					(usedVulkanVersion, defaultGlslBuildOptions, defaultHlslBuildOptions, defaultSpirvAsmBuildOptions);
-	const tcu::CommandLine&		commandLine					= m_context.getTestContext().getCommandLine();
-	const bool					doShaderLog					= commandLine.isLogDecompiledSpirvEnabled() && log.isShaderLoggingEnabled();
+	TestCase*							vktCase						= dynamic_cast<TestCase*>(testCase);
+	tcu::TestLog&						log							= m_context.getTestContext().getLog();
+	const deUint32						usedVulkanVersion			= m_context.getUsedApiVersion();
+	const vk::SpirvVersion				baselineSpirvVersion		= vk::getBaselineSpirvVersion(usedVulkanVersion);
+	vk::ShaderBuildOptions				defaultGlslBuildOptions		(usedVulkanVersion, baselineSpirvVersion, 0u);
+	vk::ShaderBuildOptions				defaultHlslBuildOptions		(usedVulkanVersion, baselineSpirvVersion, 0u);
+	vk::SpirVAsmBuildOptions			defaultSpirvAsmBuildOptions	(usedVulkanVersion, baselineSpirvVersion);
+	vk::SourceCollections				sourceProgs					(usedVulkanVersion, defaultGlslBuildOptions, defaultHlslBuildOptions, defaultSpirvAsmBuildOptions);
+	const tcu::CommandLine&				commandLine					= m_context.getTestContext().getCommandLine();
+	const bool							doShaderLog					= commandLine.isLogDecompiledSpirvEnabled() && log.isShaderLoggingEnabled();
+	de::SharedPtr<PrefetchedPrograms>	prefetched;
+
+	if (const vk::SubAllocator* subAllocator = dynamic_cast<const vk::SubAllocator*>(&m_context.getDefaultAllocator()))
+		m_allocatorStats = subAllocator->getStatistics();
+
+	m_devicePoolStats = m_context.getCustomDevicePool().getStatistics();
+
+	{
+		const PrefetchMap::iterator	found	= m_prefetched.find(casePath);
+
+		if (found != m_prefetched.end())
+		{
+			prefetched = found->second;
+			m_prefetched.erase(found);
+
+			// If the case turns out to be unsupported, programs are not needed
+			m_abandoned.push_back(prefetched);
+		}
+	}
 
 	if (!vktCase)
 		TCU_THROW(InternalError, "Test node not an instance of vkt::TestCase");
@@ -283,56 +585,142 @@ void TestCaseExecutor::init (tcu::TestCase* testCase, const std::string& casePat
 	{
 		if (!spirvVersionSupported(progIter.getProgram().buildOptions.targetVersion))
 			TCU_THROW(NotSupportedError, "Shader requires SPIR-V higher than available");
+	}
+
+	for (vk::HlslSourceCollection::Iterator progIter = sourceProgs.hlslSources.begin(); progIter != sourceProgs.hlslSources.end(); ++progIter)
+	{
+		if (!spirvVersionSupported(progIter.getProgram().buildOptions.targetVersion))
+			TCU_THROW(NotSupportedError, "Shader requires SPIR-V higher than available");
+	}
+
+	for (vk::SpirVAsmCollection::Iterator asmIterator = sourceProgs.spirvAsmSources.begin(); asmIterator != sourceProgs.spirvAsmSources.end(); ++asmIterator)
+	{
+		if (!spirvVersionSupported(asmIterator.getProgram().buildOptions.targetVersion))
+			TCU_THROW(NotSupportedError, "Shader requires SPIR-V higher than available");
+	}
+
+	{
+		de::Semaphore								compiled		(0);
+		vector<de::SharedPtr<GlslCompileTask> >		glslTasks;
+		vector<de::SharedPtr<HlslCompileTask> >		hlslTasks;
+		vector<de::SharedPtr<SpirVAsmCompileTask> >	spirvAsmTasks;
+		vector<Task*>								newTasks;
+
+		if (prefetched)
+		{
+			DE_ASSERT(m_abandoned.back() == prefetched);
 
-		const vk::ProgramBinary* const binProg = buildProgram<glu::ShaderProgramInfo, vk::GlslSourceCollection::Iterator>(casePath, progIter, m_prebuiltBinRegistry, log, &m_progCollection, commandLine);
+			prefetched->waitForCompletion();
+			m_abandoned.pop_back();
+		}
 
-		if (doShaderLog)
+		// Programs are compiled concurrently, but results, logs and errors are handled below in source order.
+		// Programs that were already built ahead of time with identical sources and options are reused.
 		{
-			try
+			for (vk::GlslSourceCollection::Iterator progIter = sourceProgs.glslSources.begin(); progIter != sourceProgs.glslSources.end(); ++progIter)
 			{
-				std::ostringstream disasm;
+				de::SharedPtr<GlslCompileTask> task = prefetched ? prefetched->findTask(progIter) : de::SharedPtr<GlslCompileTask>();
 
-				vk::disassembleProgram(*binProg, &disasm);
+				if (!task)
+				{
+					task = de::SharedPtr<GlslCompileTask>(new GlslCompileTask(progIter, commandLine, compiled));
+					newTasks.push_back(task.get());
+				}
 
-				log << vk::SpirVAsmSource(disasm.str());
+				glslTasks.push_back(task);
 			}
-			catch (const tcu::NotSupportedError& err)
+
+			for (vk::HlslSourceCollection::Iterator progIter = sourceProgs.hlslSources.begin(); progIter != sourceProgs.hlslSources.end(); ++progIter)
 			{
-				log << err;
+				de::SharedPtr<HlslCompileTask> task = prefetched ? prefetched->findTask(progIter) : de::SharedPtr<HlslCompileTask>();
+
+				if (!task)
+				{
+					task = de::SharedPtr<HlslCompileTask>(new HlslCompileTask(progIter, commandLine, compiled));
+					newTasks.push_back(task.get());
+				}
+
+				hlslTasks.push_back(task);
 			}
-		}
-	}
 
-	for (vk::HlslSourceCollection::Iterator progIter = sourceProgs.hlslSources.begin(); progIter != sourceProgs.hlslSources.end(); ++progIter)
-	{
-		if (!spirvVersionSupported(progIter.getProgram().buildOptions.targetVersion))
-			TCU_THROW(NotSupportedError, "Shader requires SPIR-V higher than available");
+			for (vk::SpirVAsmCollection::Iterator asmIterator = sourceProgs.spirvAsmSources.begin(); asmIterator != sourceProgs.spirvAsmSources.end(); ++asmIterator)
+			{
+				de::SharedPtr<SpirVAsmCompileTask> task = prefetched ? prefetched->findTask(asmIterator) : de::SharedPtr<SpirVAsmCompileTask>();
 
-		const vk::ProgramBinary* const binProg = buildProgram<glu::ShaderProgramInfo, vk::HlslSourceCollection::Iterator>(casePath, progIter, m_prebuiltBinRegistry, log, &m_progCollection, commandLine);
+				if (!task)
+				{
+					task = de::SharedPtr<SpirVAsmCompileTask>(new SpirVAsmCompileTask(asmIterator, commandLine, compiled));
+					newTasks.push_back(task.get());
+				}
 
-		if (doShaderLog)
-		{
-			try
+				spirvAsmTasks.push_back(task);
+			}
+
+			// If not worth handing off to the pool, tasks are left unexecuted and buildProgram() compiles directly
+			if (newTasks.size() > 1 && deGetNumAvailableLogicalCores() > 1)
 			{
-				std::ostringstream disasm;
+				TaskExecutor& executor = getCompileExecutor();
 
-				vk::disassembleProgram(*binProg, &disasm);
+				for (size_t ndx = 0; ndx < newTasks.size(); ++ndx)
+					executor.submit(newTasks[ndx]);
 
-				log << vk::SpirVAsmSource(disasm.str());
+				for (size_t ndx = 0; ndx < newTasks.size(); ++ndx)
+					compiled.decrement();
 			}
-			catch (const tcu::NotSupportedError& err)
+		}
+
+		size_t taskNdx = 0;
+
+		for (vk::GlslSourceCollection::Iterator progIter = sourceProgs.glslSources.begin(); progIter != sourceProgs.glslSources.end(); ++progIter, ++taskNdx)
+		{
+			const vk::ProgramBinary* const binProg = buildProgram<glu::ShaderProgramInfo, vk::GlslSourceCollection::Iterator>(casePath, progIter, m_prebuiltBinRegistry, log, &m_progCollection, commandLine, glslTasks[taskNdx].get());
+
+			if (doShaderLog)
 			{
-				log << err;
+				try
+				{
+					std::ostringstream disasm;
+
+					vk::disassembleProgram(*binProg, &disasm);
+
+					log << vk::SpirVAsmSource(disasm.str());
+				}
+				catch (const tcu::NotSupportedError& err)
+				{
+					log << err;
+				}
 			}
 		}
-	}
 
-	for (vk::SpirVAsmCollection::Iterator asmIterator = sourceProgs.spirvAsmSources.begin(); asmIterator != sourceProgs.spirvAsmSources.end(); ++asmIterator)
-	{
-		if (!spirvVersionSupported(asmIterator.getProgram().buildOptions.targetVersion))
-			TCU_THROW(NotSupportedError, "Shader requires SPIR-V higher than available");
+		taskNdx = 0;
+
+		for (vk::HlslSourceCollection::Iterator progIter = sourceProgs.hlslSources.begin(); progIter != sourceProgs.hlslSources.end(); ++progIter, ++taskNdx)
+		{
+			const vk::ProgramBinary* const binProg = buildProgram<glu::ShaderProgramInfo, vk::HlslSourceCollection::Iterator>(casePath, progIter, m_prebuiltBinRegistry, log, &m_progCollection, commandLine, hlslTasks[taskNdx].get());
 
-		buildProgram<vk::SpirVProgramInfo, vk::SpirVAsmCollection::Iterator>(casePath, asmIterator, m_prebuiltBinRegistry, log, &m_progCollection, commandLine);
+			if (doShaderLog)
+			{
+				try
+				{
+					std::ostringstream disasm;
+
+					vk::disassembleProgram(*binProg, &disasm);
+
+					log << vk::SpirVAsmSource(disasm.str());
+				}
+				catch (const tcu::NotSupportedError& err)
+				{
+					log << err;
+				}
+			}
+		}
+
+		taskNdx = 0;
+
+		for (vk::SpirVAsmCollection::Iterator asmIterator = sourceProgs.spirvAsmSources.begin(); asmIterator != sourceProgs.spirvAsmSources.end(); ++asmIterator, ++taskNdx)
+		{
+			buildProgram<vk::SpirVProgramInfo, vk::SpirVAsmCollection::Iterator>(casePath, asmIterator, m_prebuiltBinRegistry, log, &m_progCollection, commandLine, spirvAsmTasks[taskNdx].get());
+		}
 	}
 
 	if (m_renderDoc) m_renderDoc->startFrame(m_context.getInstance());
@@ -347,6 +735,9 @@ void TestCaseExecutor::deinit (tcu::TestCase* testCase)
 	delete m_instance;
 	m_instance = DE_NULL;
 
+	logAllocatorStatistics();
+	releasePooledDevices();
+
 	if (m_renderDoc) m_renderDoc->endFrame(m_context.getInstance());
 
 	// Collect and report any debug messages
@@ -394,6 +785,48 @@ void TestCaseExecutor::logUnusedShaders (tcu::TestCase* testCase)
 	}
 }
 
+void TestCaseExecutor::logAllocatorStatistics (void)
+{
+	const vk::SubAllocator* const	subAllocator	= dynamic_cast<const vk::SubAllocator*>(&m_context.getDefaultAllocator());
+
+	if (subAllocator)
+	{
+		const vk::SubAllocator::Statistics	stats				= subAllocator->getStatistics();
+		const deUint64						numSubAllocations	= stats.numSubAllocations - m_allocatorStats.numSubAllocations;
+		const deUint64						numDedicated		= stats.numDedicatedAllocations - m_allocatorStats.numDedicatedAllocations;
+		const deUint64						numBlockAllocations	= stats.numBlockAllocations - m_allocatorStats.numBlockAllocations;
+
+		if (numSubAllocations + numDedicated > 0)
+		{
+			m_context.getTestContext().getLog()
+				<< TestLog::Message
+				<< "Default allocator: " << numSubAllocations << " sub-allocations, "
+				<< numDedicated << " dedicated allocations, "
+				<< numBlockAllocations << " new memory blocks, "
+				<< stats.numBlocks << " blocks (" << stats.blockMemorySize << " bytes) in use after case"
+				<< TestLog::EndMessage;
+		}
+	}
+}
+
+void TestCaseExecutor::releasePooledDevices (void)
+{
+	CustomDevicePool&					pool			= m_context.getCustomDevicePool();
+	const CustomDevicePool::Statistics	stats			= pool.getStatistics();
+	const deUint64						numRequests		= stats.numRequests - m_devicePoolStats.numRequests;
+
+	pool.release();
+
+	if (numRequests > 0)
+	{
+		m_context.getTestContext().getLog()
+			<< TestLog::Message
+			<< "Custom device pool: " << (stats.numHits - m_devicePoolStats.numHits) << " of " << numRequests << " device requests reused an existing device, "
+			<< (stats.numUnpooled - m_devicePoolStats.numUnpooled) << " could not be pooled"
+			<< TestLog::EndMessage;
+	}
+}
+
 tcu::TestNode::IterateResult TestCaseExecutor::iterate (tcu::TestCase*)
 {
 	DE_ASSERT(m_instance);
@@ -23,11 +23,20 @@
 
 #include "tcuAstcUtil.hpp"
 #include "deFloat16.h"
+#include "deMemory.h"
 #include "deRandom.hpp"
 #include "deMeta.hpp"
 
 #include <algorithm>
 
+#if (DE_CPU == DE_CPU_X86_64)
+#	define TCU_ASTC_SSE2
+#	include <emmintrin.h>
+#elif (DE_CPU == DE_CPU_ARM_64)
+#	define TCU_ASTC_NEON
+#	include <arm_neon.h>
+#endif
+
 namespace tcu
 {
 namespace astc
@@ -1341,63 +1350,79 @@ inline deUint32 hash52 (deUint32 v)
 	return p;
 }
 
-int computeTexelPartition (deUint32 seedIn, deUint32 xIn, deUint32 yIn, deUint32 zIn, int numPartitions, bool smallBlock)
+// Partition selection state that only depends on the block, computed once per block.
+struct TexelPartitionParams
+{
+	int			numPartitions;
+	bool		smallBlock;
+	deUint32	rnum;
+	deUint8		seeds[12];
+};
+
+TexelPartitionParams computeTexelPartitionParams (deUint32 seedIn, int numPartitions, bool smallBlock)
+{
+	const deUint32			seed	= seedIn + 1024*(numPartitions-1);
+	const deUint32			rnum	= hash52(seed);
+	TexelPartitionParams	params;
+
+	params.numPartitions	= numPartitions;
+	params.smallBlock		= smallBlock;
+	params.rnum				= rnum;
+
+	params.seeds[0]		= (deUint8)( rnum							& 0xf);
+	params.seeds[1]		= (deUint8)((rnum >>  4)					& 0xf);
+	params.seeds[2]		= (deUint8)((rnum >>  8)					& 0xf);
+	params.seeds[3]		= (deUint8)((rnum >> 12)					& 0xf);
+	params.seeds[4]		= (deUint8)((rnum >> 16)					& 0xf);
+	params.seeds[5]		= (deUint8)((rnum >> 20)					& 0xf);
+	params.seeds[6]		= (deUint8)((rnum >> 24)					& 0xf);
+	params.seeds[7]		= (deUint8)((rnum >> 28)					& 0xf);
+	params.seeds[8]		= (deUint8)((rnum >> 18)					& 0xf);
+	params.seeds[9]		= (deUint8)((rnum >> 22)					& 0xf);
+	params.seeds[10]	= (deUint8)((rnum >> 26)					& 0xf);
+	params.seeds[11]	= (deUint8)(((rnum >> 30) | (rnum << 2))	& 0xf);
+
+	for (int ndx = 0; ndx < DE_LENGTH_OF_ARRAY(params.seeds); ndx++)
+		params.seeds[ndx] = (deUint8)(params.seeds[ndx] * params.seeds[ndx]);
+
+	{
+		const int shA = (seed & 2) != 0		? 4		: 5;
+		const int shB = numPartitions == 3	? 6		: 5;
+		const int sh1 = (seed & 1) != 0		? shA	: shB;
+		const int sh2 = (seed & 1) != 0		? shB	: shA;
+		const int sh3 = (seed & 0x10) != 0	? sh1	: sh2;
+
+		params.seeds[0]		= (deUint8)(params.seeds[0]		>> sh1);
+		params.seeds[1]		= (deUint8)(params.seeds[1]		>> sh2);
+		params.seeds[2]		= (deUint8)(params.seeds[2]		>> sh1);
+		params.seeds[3]		= (deUint8)(params.seeds[3]		>> sh2);
+		params.seeds[4]		= (deUint8)(params.seeds[4]		>> sh1);
+		params.seeds[5]		= (deUint8)(params.seeds[5]		>> sh2);
+		params.seeds[6]		= (deUint8)(params.seeds[6]		>> sh1);
+		params.seeds[7]		= (deUint8)(params.seeds[7]		>> sh2);
+		params.seeds[8]		= (deUint8)(params.seeds[8]		>> sh3);
+		params.seeds[9]		= (deUint8)(params.seeds[9]		>> sh3);
+		params.seeds[10]	= (deUint8)(params.seeds[10]	>> sh3);
+		params.seeds[11]	= (deUint8)(params.seeds[11]	>> sh3);
+	}
+
+	return params;
+}
+
+int computeTexelPartition (const TexelPartitionParams& params, deUint32 xIn, deUint32 yIn, deUint32 zIn)
 {
 	DE_ASSERT(zIn == 0);
-	const deUint32	x		= smallBlock ? xIn << 1 : xIn;
-	const deUint32	y		= smallBlock ? yIn << 1 : yIn;
-	const deUint32	z		= smallBlock ? zIn << 1 : zIn;
-	const deUint32	seed	= seedIn + 1024*(numPartitions-1);
-	const deUint32	rnum	= hash52(seed);
-	deUint8			seed1	= (deUint8)( rnum							& 0xf);
-	deUint8			seed2	= (deUint8)((rnum >>  4)					& 0xf);
-	deUint8			seed3	= (deUint8)((rnum >>  8)					& 0xf);
-	deUint8			seed4	= (deUint8)((rnum >> 12)					& 0xf);
-	deUint8			seed5	= (deUint8)((rnum >> 16)					& 0xf);
-	deUint8			seed6	= (deUint8)((rnum >> 20)					& 0xf);
-	deUint8			seed7	= (deUint8)((rnum >> 24)					& 0xf);
-	deUint8			seed8	= (deUint8)((rnum >> 28)					& 0xf);
-	deUint8			seed9	= (deUint8)((rnum >> 18)					& 0xf);
-	deUint8			seed10	= (deUint8)((rnum >> 22)					& 0xf);
-	deUint8			seed11	= (deUint8)((rnum >> 26)					& 0xf);
-	deUint8			seed12	= (deUint8)(((rnum >> 30) | (rnum << 2))	& 0xf);
-
-	seed1  = (deUint8)(seed1  * seed1 );
-	seed2  = (deUint8)(seed2  * seed2 );
-	seed3  = (deUint8)(seed3  * seed3 );
-	seed4  = (deUint8)(seed4  * seed4 );
-	seed5  = (deUint8)(seed5  * seed5 );
-	seed6  = (deUint8)(seed6  * seed6 );
-	seed7  = (deUint8)(seed7  * seed7 );
-	seed8  = (deUint8)(seed8  * seed8 );
-	seed9  = (deUint8)(seed9  * seed9 );
-	seed10 = (deUint8)(seed10 * seed10);
-	seed11 = (deUint8)(seed11 * seed11);
-	seed12 = (deUint8)(seed12 * seed12);
-
-	const int shA = (seed & 2) != 0		? 4		: 5;
-	const int shB = numPartitions == 3	? 6		: 5;
-	const int sh1 = (seed & 1) != 0		? shA	: shB;
-	const int sh2 = (seed & 1) != 0		? shB	: shA;
-	const int sh3 = (seed & 0x10) != 0	? sh1	: sh2;
-
-	seed1  = (deUint8)(seed1  >> sh1);
-	seed2  = (deUint8)(seed2  >> sh2);
-	seed3  = (deUint8)(seed3  >> sh1);
-	seed4  = (deUint8)(seed4  >> sh2);
-	seed5  = (deUint8)(seed5  >> sh1);
-	seed6  = (deUint8)(seed6  >> sh2);
-	seed7  = (deUint8)(seed7  >> sh1);
-	seed8  = (deUint8)(seed8  >> sh2);
-	seed9  = (deUint8)(seed9  >> sh3);
-	seed10 = (deUint8)(seed10 >> sh3);
-	seed11 = (deUint8)(seed11 >> sh3);
-	seed12 = (deUint8)(seed12 >> sh3);
-
-	const int a =						0x3f & (seed1*x + seed2*y + seed11*z + (rnum >> 14));
-	const int b =						0x3f & (seed3*x + seed4*y + seed12*z + (rnum >> 10));
-	const int c = numPartitions >= 3 ?	0x3f & (seed5*x + seed6*y + seed9*z  + (rnum >>  6))	: 0;
-	const int d = numPartitions >= 4 ?	0x3f & (seed7*x + seed8*y + seed10*z + (rnum >>  2))	: 0;
+	const deUint32	x				= params.smallBlock ? xIn << 1 : xIn;
+	const deUint32	y				= params.smallBlock ? yIn << 1 : yIn;
+	const deUint32	z				= params.smallBlock ? zIn << 1 : zIn;
+	const int		numPartitions	= params.numPartitions;
+	const deUint32	rnum			= params.rnum;
+	const deUint8*	seeds			= params.seeds;
+
+	const int a =						0x3f & (seeds[0]*x + seeds[1]*y + seeds[10]*z + (rnum >> 14));
+	const int b =						0x3f & (seeds[2]*x + seeds[3]*y + seeds[11]*z + (rnum >> 10));
+	const int c = numPartitions >= 3 ?	0x3f & (seeds[4]*x + seeds[5]*y + seeds[8]*z  + (rnum >>  6))	: 0;
+	const int d = numPartitions >= 4 ?	0x3f & (seeds[6]*x + seeds[7]*y + seeds[9]*z  + (rnum >>  2))	: 0;
 
 	return a >= b && a >= c && a >= d	? 0
 		 : b >= c && b >= d				? 1
@@ -1405,21 +1430,167 @@ int computeTexelPartition (deUint32 seedIn, deUint32 xIn, deUint32 yIn, deUint32
 		 :								  3;
 }
 
+// Scalar LDR endpoint interpolation of a single channel. See below.
+inline deUint32 interpolateLdrChannel (deUint32 e0, deUint32 e1, deUint32 w, bool isSRGB)
+{
+	const deUint32 c0 = (e0 << 8) | (isSRGB ? 0x80 : e0);
+	const deUint32 c1 = (e1 << 8) | (isSRGB ? 0x80 : e1);
+
+	return (c0*(64-w) + c1*w + 32) / 64;
+}
+
+inline void storeLdrChannel (void* dst, int texelNdx, int channelNdx, deUint32 c, bool isSRGB)
+{
+	if (isSRGB)
+		((deUint8*)dst)[texelNdx*4 + channelNdx] = (deUint8)((c & 0xff00) >> 8);
+	else
+		((float*)dst)[texelNdx*4 + channelNdx] = c == 65535 ? 1.0f : (float)c / 65536.0f;
+}
+
+// LDR endpoint interpolation of all four channels of a texel:
+//
+//   c = (c0*(64-w) + c1*w + 32) / 64, where c0 = (e0 << 8) | low0 and c1 = (e1 << 8) | low1
+//
+// low is 0x80 for sRGB and e otherwise. Endpoints are prepared once per
+// partition. With SSE2 the sum is split into products of the 8-bit endpoint
+// and low parts so that they can be computed with 16-bit multiply-adds.
+struct LdrEndpoints
+{
+#if defined(TCU_ASTC_SSE2)
+	__m128i		e;		//!< (e0, e1) pairs of all channels as 16-bit values.
+	__m128i		low;	//!< (low0, low1) pairs of all channels as 16-bit values.
+#elif defined(TCU_ASTC_NEON)
+	uint32x4_t	c0;
+	uint32x4_t	c1;
+#else
+	UVec4		e0;
+	UVec4		e1;
+#endif
+};
+
+LdrEndpoints prepareLdrEndpoints (const UVec4& e0, const UVec4& e1, bool isSRGB)
+{
+	LdrEndpoints endpoints;
+
+#if defined(TCU_ASTC_SSE2)
+	deInt16 e[8];
+	deInt16 low[8];
+
+	for (int channelNdx = 0; channelNdx < 4; channelNdx++)
+	{
+		e[channelNdx*2 + 0]		= (deInt16)e0[channelNdx];
+		e[channelNdx*2 + 1]		= (deInt16)e1[channelNdx];
+		low[channelNdx*2 + 0]	= (deInt16)(isSRGB ? 0x80 : e0[channelNdx]);
+		low[channelNdx*2 + 1]	= (deInt16)(isSRGB ? 0x80 : e1[channelNdx]);
+	}
+
+	endpoints.e		= _mm_loadu_si128((const __m128i*)e);
+	endpoints.low	= _mm_loadu_si128((const __m128i*)low);
+#elif defined(TCU_ASTC_NEON)
+	deUint32 c0[4];
+	deUint32 c1[4];
+
+	for (int channelNdx = 0; channelNdx < 4; channelNdx++)
+	{
+		c0[channelNdx] = (e0[channelNdx] << 8) | (isSRGB ? 0x80 : e0[channelNdx]);
+		c1[channelNdx] = (e1[channelNdx] << 8) | (isSRGB ? 0x80 : e1[channelNdx]);
+	}
+
+	endpoints.c0	= vld1q_u32(c0);
+	endpoints.c1	= vld1q_u32(c1);
+#else
+	DE_UNREF(isSRGB);
+
+	endpoints.e0	= e0;
+	endpoints.e1	= e1;
+#endif
+
+	return endpoints;
+}
+
+void interpolateLdrTexel (void* dst, int texelNdx, const LdrEndpoints& endpoints, const TexelWeightPair& weight, int ccs, bool isSRGB)
+{
+	// Endpoint values are at most 8 bits and weights at most 64, so interpolated values fit in 16 bits.
+#if defined(TCU_ASTC_SSE2)
+	deInt16 w[8];
+
+	for (int channelNdx = 0; channelNdx < 4; channelNdx++)
+	{
+		const deInt16 channelWeight = (deInt16)weight.w[ccs == channelNdx ? 1 : 0];
+
+		w[channelNdx*2 + 0] = (deInt16)(64 - channelWeight);
+		w[channelNdx*2 + 1] = channelWeight;
+	}
+
+	{
+		const __m128i	weights	= _mm_loadu_si128((const __m128i*)w);
+		const __m128i	sumE	= _mm_madd_epi16(endpoints.e, weights);
+		const __m128i	sumLow	= _mm_madd_epi16(endpoints.low, weights);
+		const __m128i	c		= _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(_mm_slli_epi32(sumE, 8), sumLow), _mm_set1_epi32(32)), 6);
+
+		if (isSRGB)
+		{
+			const __m128i bytes = _mm_packus_epi16(_mm_packs_epi32(_mm_srli_epi32(c, 8), _mm_setzero_si128()), _mm_setzero_si128());
+			*(deUint32*)((deUint8*)dst + texelNdx*4) = (deUint32)_mm_cvtsi128_si32(bytes);
+		}
+		else
+		{
+			const __m128	scaled	= _mm_mul_ps(_mm_cvtepi32_ps(c), _mm_set1_ps(1.0f / 65536.0f));
+			const __m128	isMax	= _mm_castsi128_ps(_mm_cmpeq_epi32(c, _mm_set1_epi32(65535)));
+			_mm_storeu_ps((float*)dst + texelNdx*4, _mm_or_ps(_mm_and_ps(isMax, _mm_set1_ps(1.0f)), _mm_andnot_ps(isMax, scaled)));
+		}
+	}
+#elif defined(TCU_ASTC_NEON)
+	deUint32 w[4];
+
+	for (int channelNdx = 0; channelNdx < 4; channelNdx++)
+		w[channelNdx] = weight.w[ccs == channelNdx ? 1 : 0];
+
+	{
+		const uint32x4_t	weights	= vld1q_u32(w);
+		const uint32x4_t	sum		= vmlaq_u32(vmulq_u32(endpoints.c0, vsubq_u32(vdupq_n_u32(64), weights)), endpoints.c1, weights);
+		const uint32x4_t	c		= vshrq_n_u32(vaddq_u32(sum, vdupq_n_u32(32)), 6);
+
+		if (isSRGB)
+		{
+			const uint8x8_t bytes = vmovn_u16(vcombine_u16(vmovn_u32(vshrq_n_u32(c, 8)), vdup_n_u16(0)));
+			vst1_lane_u32((deUint32*)((deUint8*)dst + texelNdx*4), vreinterpret_u32_u8(bytes), 0);
+		}
+		else
+		{
+			const float32x4_t	scaled	= vmulq_f32(vcvtq_f32_u32(c), vdupq_n_f32(1.0f / 65536.0f));
+			const uint32x4_t	isMax	= vceqq_u32(c, vdupq_n_u32(65535));
+			vst1q_f32((float*)dst + texelNdx*4, vbslq_f32(isMax, vdupq_n_f32(1.0f), scaled));
+		}
+	}
+#else
+	for (int channelNdx = 0; channelNdx < 4; channelNdx++)
+		storeLdrChannel(dst, texelNdx, channelNdx, interpolateLdrChannel(endpoints.e0[channelNdx], endpoints.e1[channelNdx], weight.w[ccs == channelNdx ? 1 : 0], isSRGB), isSRGB);
+#endif
+}
+
 DecompressResult setTexelColors (void* dst, ColorEndpointPair* colorEndpoints, TexelWeightPair* texelWeights, int ccs, deUint32 partitionIndexSeed,
 								 int numPartitions, int blockWidth, int blockHeight, bool isSRGB, bool isLDRMode, const deUint32* colorEndpointModes)
 {
-	const bool			smallBlock	= blockWidth*blockHeight < 31;
-	DecompressResult	result		= DECOMPRESS_RESULT_VALID_BLOCK;
-	bool				isHDREndpoint[4];
+	const bool					smallBlock		= blockWidth*blockHeight < 31;
+	const TexelPartitionParams	partitionParams	= computeTexelPartitionParams(partitionIndexSeed, numPartitions, smallBlock);
+	DecompressResult			result			= DECOMPRESS_RESULT_VALID_BLOCK;
+	bool						isHDREndpoint[4];
+	LdrEndpoints				ldrEndpoints[4];
 
 	for (int i = 0; i < numPartitions; i++)
+	{
 		isHDREndpoint[i] = isColorEndpointModeHDR(colorEndpointModes[i]);
 
+		if (!isHDREndpoint[i])
+			ldrEndpoints[i] = prepareLdrEndpoints(colorEndpoints[i].e0, colorEndpoints[i].e1, isSRGB);
+	}
+
 	for (int texelY = 0; texelY < blockHeight; texelY++)
 	for (int texelX = 0; texelX < blockWidth; texelX++)
 	{
 		const int				texelNdx			= texelY*blockWidth + texelX;
-		const int				colorEndpointNdx	= numPartitions == 1 ? 0 : computeTexelPartition(partitionIndexSeed, texelX, texelY, 0, numPartitions, smallBlock);
+		const int				colorEndpointNdx	= numPartitions == 1 ? 0 : computeTexelPartition(partitionParams, texelX, texelY, 0);
 		DE_ASSERT(colorEndpointNdx < numPartitions);
 		const UVec4&			e0					= colorEndpoints[colorEndpointNdx].e0;
 		const UVec4&			e1					= colorEndpoints[colorEndpointNdx].e1;
@@ -1444,22 +1615,14 @@ DecompressResult setTexelColors (void* dst, ColorEndpointPair* colorEndpoints, T
 
 			result = DECOMPRESS_RESULT_ERROR;
 		}
+		else if (!isHDREndpoint[colorEndpointNdx])
+			interpolateLdrTexel(dst, texelNdx, ldrEndpoints[colorEndpointNdx], weight, ccs, isSRGB);
 		else
 		{
 			for (int channelNdx = 0; channelNdx < 4; channelNdx++)
 			{
-				if (!isHDREndpoint[colorEndpointNdx] || (channelNdx == 3 && colorEndpointModes[colorEndpointNdx] == 14)) // \note Alpha for mode 14 is treated the same as LDR.
-				{
-					const deUint32 c0	= (e0[channelNdx] << 8) | (isSRGB ? 0x80 : e0[channelNdx]);
-					const deUint32 c1	= (e1[channelNdx] << 8) | (isSRGB ? 0x80 : e1[channelNdx]);
-					const deUint32 w	= weight.w[ccs == channelNdx ? 1 : 0];
-					const deUint32 c	= (c0*(64-w) + c1*w + 32) / 64;
-
-					if (isSRGB)
-						((deUint8*)dst)[texelNdx*4 + channelNdx] = (deUint8)((c & 0xff00) >> 8);
-					else
-						((float*)dst)[texelNdx*4 + channelNdx] = c == 65535 ? 1.0f : (float)c / 65536.0f;
-				}
+				if (channelNdx == 3 && colorEndpointModes[colorEndpointNdx] == 14) // \note Alpha for mode 14 is treated the same as LDR.
+					storeLdrChannel(dst, texelNdx, channelNdx, interpolateLdrChannel(e0[channelNdx], e1[channelNdx], weight.w[ccs == channelNdx ? 1 : 0], isSRGB), isSRGB);
 				else
 				{
 					DE_STATIC_ASSERT((de::meta::TypesSame<deFloat16, deUint16>::Value));
@@ -1585,7 +1748,25 @@ void decompress (const PixelBufferAccess& dst, const deUint8* data, bool isSRGB,
 	decompressBlock(isSRGB ? (void*)&decompressedBuffer.sRGB[0] : (void*)&decompressedBuffer.linear[0],
 					blockData, dst.getWidth(), dst.getHeight(), isSRGB, isLDR);
 
-	if (isSRGB)
+	const TextureFormat	blockFormat	= isSRGB ? TextureFormat(TextureFormat::sRGBA, TextureFormat::UNORM_INT8) : TextureFormat(TextureFormat::RGBA, TextureFormat::HALF_FLOAT);
+
+	if (dst.getFormat() == blockFormat && dst.getPixelPitch() == blockFormat.getPixelSize())
+	{
+		// Fast path for the uncompressed formats of ASTC blocks. Equivalent to setPixel() below.
+		for (int i = 0; i < blockHeight; i++)
+		{
+			if (isSRGB)
+				deMemcpy(dst.getPixelPtr(0, i), &decompressedBuffer.sRGB[i*blockWidth*4], blockWidth*4);
+			else
+			{
+				deFloat16* const dstRow = (deFloat16*)dst.getPixelPtr(0, i);
+
+				for (int j = 0; j < blockWidth*4; j++)
+					dstRow[j] = deFloat32To16(decompressedBuffer.linear[i*blockWidth*4 + j]);
+			}
+		}
+	}
+	else if (isSRGB)
 	{
 		for (int i = 0; i < blockHeight; i++)
 		for (int j = 0; j < blockWidth; j++)
@@ -2930,6 +3111,41 @@ void generateDummyNormalBlocks (deUint8* dst, size_t numBlocks, int blockWidth,
 	}
 }
 
+void ldrInterpolation_selfTest (void)
+{
+	// All endpoint value pairs and weights, in all channels and both with and without CCS.
+	for (int isSRGBNdx = 0; isSRGBNdx < 2; isSRGBNdx++)
+	for (deUint32 e0 = 0; e0 < 256; e0++)
+	for (deUint32 e1 = 0; e1 < 256; e1++)
+	{
+		const bool			isSRGB		= isSRGBNdx != 0;
+		const UVec4			endpoint0	(e0, e1, 255-e0, e0);
+		const UVec4			endpoint1	(e1, e0, e1, 255-e1);
+		const LdrEndpoints	endpoints	= prepareLdrEndpoints(endpoint0, endpoint1, isSRGB);
+
+		for (deUint32 w = 0; w <= 64; w++)
+		{
+			const int		ccs			= (int)((e0 + e1 + w) % 5) - 1;
+			TexelWeightPair	weight;
+			deUint32		result[4];
+			deUint32		reference[4];
+
+			weight.w[0]	= w;
+			weight.w[1]	= 64 - w;
+
+			deMemset(result, 0, sizeof(result));
+			deMemset(reference, 0, sizeof(reference));
+
+			interpolateLdrTexel(result, 0, endpoints, weight, ccs, isSRGB);
+
+			for (int channelNdx = 0; channelNdx < 4; channelNdx++)
+				storeLdrChannel(reference, 0, channelNdx, interpolateLdrChannel(endpoint0[channelNdx], endpoint1[channelNdx], weight.w[ccs == channelNdx ? 1 : 0], isSRGB), isSRGB);
+
+			TCU_CHECK_MSG(deMemCmp(result, reference, sizeof(result)) == 0, "LDR interpolation differs from scalar reference");
+		}
+	}
+}
+
 bool isValidBlock (const deUint8* data, CompressedTexFormat format, TexDecompressionParams::AstcMode mode)
 {
 	const tcu::IVec3		blockPixelSize	= getBlockPixelSize(format);
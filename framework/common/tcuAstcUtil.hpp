@@ -74,6 +74,8 @@ bool			isValidBlock					(const deUint8* data, CompressedTexFormat format, TexDec
 
 void			decompress						(const PixelBufferAccess& dst, const deUint8* data, CompressedTexFormat format, TexDecompressionParams::AstcMode mode);
 
+void			ldrInterpolation_selfTest		(void);
+
 } // astc
 } // tcu
 
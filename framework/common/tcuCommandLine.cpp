@@ -26,6 +26,8 @@
 #include "tcuTestCase.hpp"
 #include "tcuResource.hpp"
 #include "deFilePath.hpp"
+#include "deMemPool.hpp"
+#include "deMemory.h"
 #include "deStringUtil.hpp"
 #include "deString.h"
 #include "deInt32.h"
@@ -91,7 +93,11 @@ DE_DECLARE_COMMAND_LINE_OPT(TestOOM,					bool);
 DE_DECLARE_COMMAND_LINE_OPT(ArchiveDir,					std::string);
 DE_DECLARE_COMMAND_LINE_OPT(VKDeviceID,					int);
 DE_DECLARE_COMMAND_LINE_OPT(VKDeviceGroupID,			int);
+DE_DECLARE_COMMAND_LINE_OPT(VKSuballocation,			bool);
+DE_DECLARE_COMMAND_LINE_OPT(VKDevicePoolSize,			int);
 DE_DECLARE_COMMAND_LINE_OPT(LogFlush,					bool);
+DE_DECLARE_COMMAND_LINE_OPT(BinaryLog,					bool);
+DE_DECLARE_COMMAND_LINE_OPT(LogAsyncImages,				bool);
 DE_DECLARE_COMMAND_LINE_OPT(Validation,					bool);
 DE_DECLARE_COMMAND_LINE_OPT(PrintValidationErrors,		bool);
 DE_DECLARE_COMMAND_LINE_OPT(ShaderCache,				bool);
@@ -105,6 +111,8 @@ DE_DECLARE_COMMAND_LINE_OPT(CaseFractionMandatoryTests,	std::string);
 DE_DECLARE_COMMAND_LINE_OPT(WaiverFile,					std::string);
 DE_DECLARE_COMMAND_LINE_OPT(RunnerType,					tcu::TestRunnerType);
 DE_DECLARE_COMMAND_LINE_OPT(TerminateOnFail,			bool);
+DE_DECLARE_COMMAND_LINE_OPT(ProgramPrefetch,			int);
+DE_DECLARE_COMMAND_LINE_OPT(SubprocessCount,			int);
 
 static void parseIntList (const char* src, std::vector<int>* dst)
 {
@@ -129,6 +137,11 @@ void registerOptions (de::cmdline::Parser& parser)
 		{ "enable",		true	},
 		{ "disable",	false	}
 	};
+	static const NamedValue<bool> s_logFormats[] =
+	{
+		{ "text",		false	},
+		{ "binary",		true	}
+	};
 	static const NamedValue<tcu::RunMode> s_runModes[] =
 	{
 		{ "execute",		RUNMODE_EXECUTE				  },
@@ -196,6 +209,8 @@ void registerOptions (de::cmdline::Parser& parser)
 		<< Option<EGLPixmapType>				(DE_NULL,	"deqp-egl-pixmap-type",						"EGL native pixmap type")
 		<< Option<VKDeviceID>					(DE_NULL,	"deqp-vk-device-id",						"Vulkan device ID (IDs start from 1)",									"1")
 		<< Option<VKDeviceGroupID>				(DE_NULL,	"deqp-vk-device-group-id",					"Vulkan device Group ID (IDs start from 1)",							"1")
+		<< Option<VKSuballocation>				(DE_NULL,	"deqp-vk-suballocation",					"Sub-allocate Vulkan memory from large per-memory-type blocks",	s_enableNames,		"disable")
+		<< Option<VKDevicePoolSize>				(DE_NULL,	"deqp-vk-device-pool-size",					"Number of idle custom Vulkan devices kept for reuse by later test cases (0 = disable)",	"0")
 		<< Option<LogImages>					(DE_NULL,	"deqp-log-images",							"Enable or disable logging of result images",		s_enableNames,		"enable")
 		<< Option<LogShaderSources>				(DE_NULL,	"deqp-log-shader-sources",					"Enable or disable logging of shader sources",		s_enableNames,		"enable")
 		<< Option<LogDecompiledSpirv>			(DE_NULL,	"deqp-log-decompiled-spirv",				"Enable or disable logging of decompiled spir-v",	s_enableNames,		"enable")
@@ -203,6 +218,8 @@ void registerOptions (de::cmdline::Parser& parser)
 		<< Option<TestOOM>						(DE_NULL,	"deqp-test-oom",							"Run tests that exhaust memory on purpose",			s_enableNames,		TEST_OOM_DEFAULT)
 		<< Option<ArchiveDir>					(DE_NULL,	"deqp-archive-dir",							"Path to test resource files",											".")
 		<< Option<LogFlush>						(DE_NULL,	"deqp-log-flush",							"Enable or disable log file fflush",				s_enableNames,		"enable")
+		<< Option<BinaryLog>					(DE_NULL,	"deqp-log-format",							"Write test log as text or using binary record encoding",	s_logFormats,	"text")
+		<< Option<LogAsyncImages>				(DE_NULL,	"deqp-log-async-images",					"Compress logged images in background threads",		s_enableNames,		"enable")
 		<< Option<Validation>					(DE_NULL,	"deqp-validation",							"Enable or disable test case validation",			s_enableNames,		"disable")
 		<< Option<PrintValidationErrors>		(DE_NULL,	"deqp-print-validation-errors",				"Print validation errors to standard error")
 		<< Option<Optimization>					(DE_NULL,	"deqp-optimization-recipe",					"Shader optimization recipe (0=disabled, 1=performance, 2=size)",		"0")
@@ -215,7 +232,9 @@ void registerOptions (de::cmdline::Parser& parser)
 		<< Option<CaseFractionMandatoryTests>	(DE_NULL,	"deqp-fraction-mandatory-caselist-file",	"Case list file that must be run for each fraction",					"")
 		<< Option<WaiverFile>					(DE_NULL,	"deqp-waiver-file",							"Read waived tests from given file",									"")
 		<< Option<RunnerType>					(DE_NULL,	"deqp-runner-type",							"Filter test cases based on runner",				s_runnerTypes,		"any")
-		<< Option<TerminateOnFail>				(DE_NULL,	"deqp-terminate-on-fail",					"Terminate the run on first failure",				s_enableNames,		"disable");
+		<< Option<TerminateOnFail>				(DE_NULL,	"deqp-terminate-on-fail",					"Terminate the run on first failure",				s_enableNames,		"disable")
+		<< Option<ProgramPrefetch>				(DE_NULL,	"deqp-program-prefetch",					"Number of upcoming test cases whose programs are built in the background",	"0")
+		<< Option<SubprocessCount>				(DE_NULL,	"deqp-subprocess-count",					"Run test cases in given number of child processes (0 = run in this process)",	"0");
 }
 
 void registerLegacyOptions (de::cmdline::Parser& parser)
@@ -287,65 +306,200 @@ void DebugOutStreambuf::flushLine (void)
 	m_curLine.str("");
 }
 
+// Case tree
+//
+// Case lists of the full Vulkan mustpass contain hundreds of thousands of cases
+// under a handful of very wide groups, so child lookup must not depend on the
+// number of siblings. Nodes and names are allocated from a memory pool. Names
+// are interned, and each node keeps its children in an open addressing hash
+// table keyed by name.
+
+struct CaseTreeName
+{
+	deUint32	hash;
+	deUint32	length;
+	char		chars[1];	//!< Null-terminated, allocated to actual length
+
+	bool equals (const char* str, deUint32 len, deUint32 strHash) const
+	{
+		return hash == strHash && length == len && deMemCmp(chars, str, len) == 0;
+	}
+};
+
+static inline deUint32 getCaseTreeNameHash (const char* str, deUint32 len)
+{
+	return deMemoryHash(str, len);
+}
+
 class CaseTreeNode
 {
 public:
-										CaseTreeNode		(const std::string& name) : m_name(name) {}
-										~CaseTreeNode		(void);
-
-	const std::string&					getName				(void) const { return m_name;				}
-	bool								hasChildren			(void) const { return !m_children.empty();	}
+										CaseTreeNode		(const CaseTreeName* name) : m_name(name), m_children(DE_NULL), m_capacity(0), m_numChildren(0) {}
 
-	bool								hasChild			(const std::string& name) const;
-	const CaseTreeNode*					getChild			(const std::string& name) const;
-	CaseTreeNode*						getChild			(const std::string& name);
+	const char*							getName				(void) const { return m_name->chars;	}
+	bool								hasName				(const char* name, deUint32 len) const { return m_name->equals(name, len, getCaseTreeNameHash(name, len)); }
+	bool								hasChildren			(void) const { return m_numChildren > 0;	}
 
-	void								addChild			(CaseTreeNode* child) { m_children.push_back(child); }
+	CaseTreeNode*						findChild			(const char* name, deUint32 len, deUint32 hash) const;
+	void								addChild			(de::MemPool& pool, CaseTreeNode* child);
 
 private:
 										CaseTreeNode		(const CaseTreeNode&);
 	CaseTreeNode&						operator=			(const CaseTreeNode&);
 
-	enum { NOT_FOUND = -1 };
-
-	// \todo [2014-10-30 pyry] Speed up with hash / sorting
-	int									findChildNdx		(const std::string& name) const;
+	void								insert				(CaseTreeNode* child);
 
-	std::string							m_name;
-	std::vector<CaseTreeNode*>			m_children;
+	const CaseTreeName*					m_name;
+	CaseTreeNode**						m_children;			//!< Hash table, capacity is zero or a power of two
+	deUint32							m_capacity;
+	deUint32							m_numChildren;
 };
 
-CaseTreeNode::~CaseTreeNode (void)
+CaseTreeNode* CaseTreeNode::findChild (const char* name, deUint32 len, deUint32 hash) const
 {
-	for (vector<CaseTreeNode*>::const_iterator i = m_children.begin(); i != m_children.end(); ++i)
-		delete *i;
+	if (m_capacity == 0)
+		return DE_NULL;
+
+	for (deUint32 slot = hash & (m_capacity - 1u);; slot = (slot + 1u) & (m_capacity - 1u))
+	{
+		CaseTreeNode* const child = m_children[slot];
+
+		if (!child || child->m_name->equals(name, len, hash))
+			return child;
+	}
 }
 
-int CaseTreeNode::findChildNdx (const std::string& name) const
+void CaseTreeNode::insert (CaseTreeNode* child)
 {
-	for (int ndx = 0; ndx < (int)m_children.size(); ++ndx)
+	deUint32 slot = child->m_name->hash & (m_capacity - 1u);
+
+	while (m_children[slot])
+		slot = (slot + 1u) & (m_capacity - 1u);
+
+	m_children[slot] = child;
+	m_numChildren++;
+}
+
+void CaseTreeNode::addChild (de::MemPool& pool, CaseTreeNode* child)
+{
+	DE_ASSERT(!findChild(child->m_name->chars, child->m_name->length, child->m_name->hash));
+
+	// Keep load factor at or below 1/2. Old tables are left in the pool.
+	if ((m_numChildren + 1u) * 2u > m_capacity)
 	{
-		if (m_children[ndx]->getName() == name)
-			return ndx;
+		CaseTreeNode** const	oldChildren	= m_children;
+		const deUint32			oldCapacity	= m_capacity;
+
+		m_capacity		= de::max(4u, m_capacity * 2u);
+		m_children		= (CaseTreeNode**)pool.alloc(m_capacity * sizeof(CaseTreeNode*));
+		m_numChildren	= 0;
+
+		deMemset(m_children, 0, m_capacity * sizeof(CaseTreeNode*));
+
+		for (deUint32 ndx = 0; ndx < oldCapacity; ndx++)
+		{
+			if (oldChildren[ndx])
+				insert(oldChildren[ndx]);
+		}
 	}
-	return NOT_FOUND;
+
+	insert(child);
 }
 
-inline bool CaseTreeNode::hasChild (const std::string& name) const
+class CaseTree
+{
+public:
+										CaseTree			(void);
+
+	CaseTreeNode*						getRoot				(void) { return m_root; }
+	const CaseTreeNode*					getRoot				(void) const { return m_root; }
+
+	//! Get child with given name, or add one if it doesn't exist yet.
+	CaseTreeNode*						getOrAddChild		(CaseTreeNode* parent, const std::string& name, bool* added = DE_NULL);
+
+private:
+										CaseTree			(const CaseTree&);
+	CaseTree&							operator=			(const CaseTree&);
+
+	const CaseTreeName*					internName			(const char* name, deUint32 len, deUint32 hash);
+
+	de::MemPool							m_pool;
+	CaseTreeNode*						m_root;
+
+	// Hash table of interned names
+	std::vector<const CaseTreeName*>	m_names;
+	deUint32							m_numNames;
+};
+
+CaseTree::CaseTree (void)
+	: m_root		(DE_NULL)
+	, m_names		(64, DE_NULL)
+	, m_numNames	(0)
 {
-	return findChildNdx(name) != NOT_FOUND;
+	m_root = new (m_pool.alloc(sizeof(CaseTreeNode))) CaseTreeNode(internName("", 0, getCaseTreeNameHash("", 0)));
 }
 
-inline const CaseTreeNode* CaseTreeNode::getChild (const std::string& name) const
+const CaseTreeName* CaseTree::internName (const char* name, deUint32 len, deUint32 hash)
 {
-	const int ndx = findChildNdx(name);
-	return ndx == NOT_FOUND ? DE_NULL : m_children[ndx];
+	deUint32 mask = (deUint32)m_names.size() - 1u;
+	deUint32 slot = hash & mask;
+
+	for (; m_names[slot]; slot = (slot + 1u) & mask)
+	{
+		if (m_names[slot]->equals(name, len, hash))
+			return m_names[slot];
+	}
+
+	{
+		CaseTreeName* const newName = (CaseTreeName*)m_pool.alignedAlloc(sizeof(CaseTreeName) + len, (deUint32)sizeof(deUint32));
+
+		newName->hash	= hash;
+		newName->length	= len;
+		deMemcpy(newName->chars, name, len);
+		newName->chars[len] = 0;
+
+		if ((m_numNames + 1u) * 2u > (deUint32)m_names.size())
+		{
+			std::vector<const CaseTreeName*> oldNames (m_names.size() * 2u, DE_NULL);
+
+			m_names.swap(oldNames);
+			mask = (deUint32)m_names.size() - 1u;
+
+			for (size_t ndx = 0; ndx < oldNames.size(); ndx++)
+			{
+				if (oldNames[ndx])
+				{
+					for (slot = oldNames[ndx]->hash & mask; m_names[slot]; slot = (slot + 1u) & mask);
+					m_names[slot] = oldNames[ndx];
+				}
+			}
+
+			for (slot = hash & mask; m_names[slot]; slot = (slot + 1u) & mask);
+		}
+
+		m_names[slot] = newName;
+		m_numNames++;
+
+		return newName;
+	}
 }
 
-inline CaseTreeNode* CaseTreeNode::getChild (const std::string& name)
+CaseTreeNode* CaseTree::getOrAddChild (CaseTreeNode* parent, const std::string& name, bool* added)
 {
-	const int ndx = findChildNdx(name);
-	return ndx == NOT_FOUND ? DE_NULL : m_children[ndx];
+	const deUint32	len		= (deUint32)name.size();
+	const deUint32	hash	= getCaseTreeNameHash(name.c_str(), len);
+	CaseTreeNode*	child	= parent->findChild(name.c_str(), len, hash);
+
+	if (added)
+		*added = !child;
+
+	if (!child)
+	{
+		child = new (m_pool.alloc(sizeof(CaseTreeNode))) CaseTreeNode(internName(name.c_str(), len, hash));
+		parent->addChild(m_pool, child);
+	}
+
+	return child;
 }
 
 static int getCurrentComponentLen (const char* path)
@@ -355,15 +509,15 @@ static int getCurrentComponentLen (const char* path)
 	return ndx;
 }
 
-static const CaseTreeNode* findNode (const CaseTreeNode* root, const char* path)
+static const CaseTreeNode* findNode (const CaseTree* tree, const char* path)
 {
-	const CaseTreeNode*	curNode		= root;
+	const CaseTreeNode*	curNode		= tree->getRoot();
 	const char*			curPath		= path;
 	int					curLen		= getCurrentComponentLen(curPath);
 
 	for (;;)
 	{
-		curNode = curNode->getChild(std::string(curPath, curPath+curLen));
+		curNode = curNode->findChild(curPath, (deUint32)curLen, getCaseTreeNameHash(curPath, (deUint32)curLen));
 
 		if (!curNode)
 			break;
@@ -383,7 +537,7 @@ static const CaseTreeNode* findNode (const CaseTreeNode* root, const char* path)
 	return curNode;
 }
 
-static void parseCaseTrie (CaseTreeNode* root, std::istream& in)
+static void parseCaseTrie (CaseTree& tree, std::istream& in)
 {
 	vector<CaseTreeNode*>	nodeStack;
 	string					curName;
@@ -392,7 +546,7 @@ static void parseCaseTrie (CaseTreeNode* root, std::istream& in)
 	if (in.get() != '{')
 		throw std::invalid_argument("Malformed case trie");
 
-	nodeStack.push_back(root);
+	nodeStack.push_back(tree.getRoot());
 
 	while (!nodeStack.empty())
 	{
@@ -405,17 +559,7 @@ static void parseCaseTrie (CaseTreeNode* root, std::istream& in)
 		{
 			if (!curName.empty() && expectNode)
 			{
-				CaseTreeNode* const newChild = new CaseTreeNode(curName);
-
-				try
-				{
-					nodeStack.back()->addChild(newChild);
-				}
-				catch (...)
-				{
-					delete newChild;
-					throw;
-				}
+				CaseTreeNode* const newChild = tree.getOrAddChild(nodeStack.back(), curName);
 
 				if (curChr == '{')
 					nodeStack.push_back(newChild);
@@ -449,7 +593,7 @@ static void parseCaseTrie (CaseTreeNode* root, std::istream& in)
 	}
 }
 
-static void parseSimpleCaseList (vector<CaseTreeNode*>& nodeStack, std::istream& in, bool reportDuplicates)
+static void parseSimpleCaseList (CaseTree& tree, vector<CaseTreeNode*>& nodeStack, std::istream& in, bool reportDuplicates)
 {
 	// \note Algorithm assumes that cases are sorted by groups, but will
 	//		 function fine, albeit more slowly, if that is not the case.
@@ -465,22 +609,14 @@ static void parseSimpleCaseList (vector<CaseTreeNode*>& nodeStack, std::istream&
 			if (curName.empty())
 				throw std::invalid_argument("Empty test case name");
 
-			if (!nodeStack[stackPos]->hasChild(curName))
 			{
-				CaseTreeNode* const newChild = new CaseTreeNode(curName);
+				bool added = false;
 
-				try
-				{
-					nodeStack[stackPos]->addChild(newChild);
-				}
-				catch (...)
-				{
-					delete newChild;
-					throw;
-				}
+				tree.getOrAddChild(nodeStack[stackPos], curName, &added);
+
+				if (!added && reportDuplicates)
+					throw std::invalid_argument("Duplicate test case");
 			}
-			else if (reportDuplicates)
-				throw std::invalid_argument("Duplicate test case");
 
 			curName.clear();
 			stackPos = 0;
@@ -503,26 +639,9 @@ static void parseSimpleCaseList (vector<CaseTreeNode*>& nodeStack, std::istream&
 			if ((int)nodeStack.size() <= stackPos+1)
 				nodeStack.resize(nodeStack.size()*2, DE_NULL);
 
-			if (!nodeStack[stackPos+1] || nodeStack[stackPos+1]->getName() != curName)
+			if (!nodeStack[stackPos+1] || !nodeStack[stackPos+1]->hasName(curName.c_str(), (deUint32)curName.size()))
 			{
-				CaseTreeNode* curGroup = nodeStack[stackPos]->getChild(curName);
-
-				if (!curGroup)
-				{
-					curGroup = new CaseTreeNode(curName);
-
-					try
-					{
-						nodeStack[stackPos]->addChild(curGroup);
-					}
-					catch (...)
-					{
-						delete curGroup;
-						throw;
-					}
-				}
-
-				nodeStack[stackPos+1] = curGroup;
+				nodeStack[stackPos+1] = tree.getOrAddChild(nodeStack[stackPos], curName);
 
 				if ((int)nodeStack.size() > stackPos+2)
 					nodeStack[stackPos+2] = DE_NULL; // Invalidate rest of entries
@@ -540,19 +659,19 @@ static void parseSimpleCaseList (vector<CaseTreeNode*>& nodeStack, std::istream&
 	}
 }
 
-static void parseCaseList (CaseTreeNode* root, std::istream& in, bool reportDuplicates)
+static void parseCaseList (CaseTree& tree, std::istream& in, bool reportDuplicates)
 {
-	vector<CaseTreeNode*> nodeStack(8, root);
-	parseSimpleCaseList(nodeStack, in, reportDuplicates);
+	vector<CaseTreeNode*> nodeStack(8, tree.getRoot());
+	parseSimpleCaseList(tree, nodeStack, in, reportDuplicates);
 }
 
-static void parseGroupFile(CaseTreeNode* root, std::istream& inGroupList, const tcu::Archive& archive, bool reportDuplicates)
+static void parseGroupFile(CaseTree& tree, std::istream& inGroupList, const tcu::Archive& archive, bool reportDuplicates)
 {
 	// read whole file and remove all '\r'
 	std::string buffer(std::istreambuf_iterator<char>(inGroupList), {});
 	buffer.erase(std::remove(buffer.begin(), buffer.end(), '\r'), buffer.end());
 
-	vector<CaseTreeNode*>	nodeStack(8, root);
+	vector<CaseTreeNode*>	nodeStack(8, tree.getRoot());
 	std::stringstream		namesStream(buffer);
 	std::string				fileName;
 
@@ -568,17 +687,17 @@ static void parseGroupFile(CaseTreeNode* root, std::istream& inGroupList, const
 			throw Exception("Empty case list resource");
 
 		std::istringstream groupIn(std::string(groupBuffer.begin(), groupBuffer.end()));
-		parseSimpleCaseList(nodeStack, groupIn, reportDuplicates);
+		parseSimpleCaseList(tree, nodeStack, groupIn, reportDuplicates);
 	}
 }
 
-static CaseTreeNode* parseCaseList (std::istream& in, const tcu::Archive& archive, const char* path = DE_NULL)
+static CaseTree* parseCaseList (std::istream& in, const tcu::Archive& archive, const char* path = DE_NULL)
 {
-	CaseTreeNode* const root = new CaseTreeNode("");
+	CaseTree* const tree = new CaseTree();
 	try
 	{
 		if (in.peek() == '{')
-			parseCaseTrie(root, in);
+			parseCaseTrie(*tree, in);
 		else
 		{
 			// if we are reading cases from file determine if we are
@@ -601,9 +720,9 @@ static CaseTreeNode* parseCaseList (std::istream& in, const tcu::Archive& archiv
 			}
 
 			if (readGroupFile)
-				parseGroupFile(root, in, archive, true);
+				parseGroupFile(*tree, in, archive, true);
 			else
-				parseCaseList(root, in, true);
+				parseCaseList(*tree, in, true);
 		}
 
 		{
@@ -612,11 +731,11 @@ static CaseTreeNode* parseCaseList (std::istream& in, const tcu::Archive& archiv
 				throw std::invalid_argument("Trailing characters at end of case list");
 		}
 
-		return root;
+		return tree;
 	}
 	catch (...)
 	{
-		delete root;
+		delete tree;
 		throw;
 	}
 }
@@ -846,6 +965,12 @@ bool CommandLine::parse (int argc, const char* const* argv)
 	if (!m_cmdLine.getOption<opt::LogFlush>())
 		m_logFlags |= QP_TEST_LOG_NO_FLUSH;
 
+	if (m_cmdLine.getOption<opt::BinaryLog>())
+		m_logFlags |= QP_TEST_LOG_BINARY;
+
+	if (!m_cmdLine.getOption<opt::LogAsyncImages>())
+		m_logFlags |= QP_TEST_LOG_SYNC_IMAGES;
+
 	if (!m_cmdLine.getOption<opt::LogEmptyLoginfo>())
 		m_logFlags |= QP_TEST_LOG_EXCLUDE_EMPTY_LOGINFO;
 
@@ -918,6 +1043,8 @@ int						CommandLine::getCLPlatformId				(void) const	{ return m_cmdLine.getOpti
 const std::vector<int>&	CommandLine::getCLDeviceIds					(void) const	{ return m_cmdLine.getOption<opt::CLDeviceIDs>();							}
 int						CommandLine::getVKDeviceId					(void) const	{ return m_cmdLine.getOption<opt::VKDeviceID>();							}
 int						CommandLine::getVKDeviceGroupId				(void) const	{ return m_cmdLine.getOption<opt::VKDeviceGroupID>();						}
+bool					CommandLine::isVKSuballocationEnabled		(void) const	{ return m_cmdLine.getOption<opt::VKSuballocation>();						}
+int						CommandLine::getVKDevicePoolSize			(void) const	{ return m_cmdLine.getOption<opt::VKDevicePoolSize>();						}
 bool					CommandLine::isValidationEnabled			(void) const	{ return m_cmdLine.getOption<opt::Validation>();							}
 bool					CommandLine::printValidationErrors			(void) const	{ return m_cmdLine.getOption<opt::PrintValidationErrors>();					}
 bool					CommandLine::isLogDecompiledSpirvEnabled	(void) const	{ return m_cmdLine.getOption<opt::LogDecompiledSpirv>();					}
@@ -934,6 +1061,8 @@ const char*				CommandLine::getCaseFractionMandatoryTests	(void) const	{ return
 const char*				CommandLine::getArchiveDir					(void) const	{ return m_cmdLine.getOption<opt::ArchiveDir>().c_str();					}
 tcu::TestRunnerType		CommandLine::getRunnerType					(void) const	{ return m_cmdLine.getOption<opt::RunnerType>();							}
 bool					CommandLine::isTerminateOnFailEnabled		(void) const	{ return m_cmdLine.getOption<opt::TerminateOnFail>();						}
+int						CommandLine::getProgramPrefetchCount		(void) const	{ return m_cmdLine.getOption<opt::ProgramPrefetch>();						}
+int						CommandLine::getSubprocessCount				(void) const	{ return m_cmdLine.getOption<opt::SubprocessCount>();						}
 
 const char* CommandLine::getGLContextType (void) const
 {
@@ -990,15 +1119,15 @@ const char* CommandLine::getEGLPixmapType (void) const
 		return DE_NULL;
 }
 
-static bool checkTestGroupName (const CaseTreeNode* root, const char* groupPath)
+static bool checkTestGroupName (const CaseTree* tree, const char* groupPath)
 {
-	const CaseTreeNode* node = findNode(root, groupPath);
+	const CaseTreeNode* node = findNode(tree, groupPath);
 	return node && node->hasChildren();
 }
 
-static bool checkTestCaseName (const CaseTreeNode* root, const char* casePath)
+static bool checkTestCaseName (const CaseTree* tree, const char* casePath)
 {
-	const CaseTreeNode* node = findNode(root, casePath);
+	const CaseTreeNode* node = findNode(tree, casePath);
 	return node && !node->hasChildren();
 }
 
@@ -1136,7 +1265,7 @@ CaseListFilter::CaseListFilter (const de::cmdline::CommandLine& cmdLine, const t
 				{
 					fileStream.clear();
 					fileStream.seekg(0, fileStream.beg);
-					parseCaseList(m_caseTree, fileStream, false);
+					parseCaseList(*m_caseTree, fileStream, false);
 				}
 			}
 		}
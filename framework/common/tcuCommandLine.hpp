@@ -89,7 +89,7 @@ enum ScreenRotation
 	SCREENROTATION_LAST
 };
 
-class CaseTreeNode;
+class CaseTree;
 class CasePaths;
 class Archive;
 
@@ -123,7 +123,7 @@ private:
 	CaseListFilter												(const CaseListFilter&);	// not allowed!
 	CaseListFilter&					operator=					(const CaseListFilter&);	// not allowed!
 
-	CaseTreeNode*					m_caseTree;
+	CaseTree*						m_caseTree;
 	de::MovePtr<const CasePaths>	m_casePaths;
 	std::vector<int>				m_caseFraction;
 	de::MovePtr<const CasePaths>	m_caseFractionMandatoryTests;
@@ -225,6 +225,12 @@ public:
 	//! Get Vulkan device group ID (--deqp-vk-device-group-id)
 	int								getVKDeviceGroupId				(void) const;
 
+	//! Sub-allocate Vulkan memory from large blocks (--deqp-vk-suballocation)
+	bool							isVKSuballocationEnabled		(void) const;
+
+	//! Number of idle custom Vulkan devices kept for reuse (--deqp-vk-device-pool-size)
+	int								getVKDevicePoolSize				(void) const;
+
 	//! Enable development-time test case validation checks
 	bool							isValidationEnabled				(void) const;
 
@@ -273,6 +279,12 @@ public:
 	//! Should the run be terminated on first failure (--deqp-terminate-on-fail)
 	bool							isTerminateOnFailEnabled	(void) const;
 
+	//! Get number of upcoming test cases whose programs are built ahead of time (--deqp-program-prefetch)
+	int								getProgramPrefetchCount		(void) const;
+
+	//! Get number of child processes used to run the test cases (--deqp-subprocess-count)
+	int								getSubprocessCount			(void) const;
+
 	/*--------------------------------------------------------------------*//*!
 	 * \brief Creates case list filter
 	 * \param archive Resources
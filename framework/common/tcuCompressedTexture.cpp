@@ -27,6 +27,10 @@
 
 #include "deStringUtil.hpp"
 #include "deFloat16.h"
+#include "deMemory.h"
+#include "deSharedPtr.hpp"
+#include "deThread.hpp"
+#include "deAtomic.h"
 
 #include <algorithm>
 
@@ -915,9 +919,17 @@ void decompressETC1 (const PixelBufferAccess& dst, const deUint8* src)
 	using namespace EtcDecompressInternal;
 
 	deUint8* const	dstPtr			= (deUint8*)dst.getDataPtr();
+	const int		dstRowPitch		= dst.getRowPitch();
+	const int		srcRowSize		= ETC2_BLOCK_WIDTH*ETC2_UNCOMPRESSED_PIXEL_SIZE_RGB8;
 	const deUint64	compressedBlock = get64BitBlock(src, 0);
+	deUint8			uncompressedBlock[ETC2_UNCOMPRESSED_BLOCK_SIZE_RGB8];
+
+	// Decompress.
+	decompressETC1Block(uncompressedBlock, compressedBlock);
 
-	decompressETC1Block(dstPtr, compressedBlock);
+	// Write to dst.
+	for (int y = 0; y < (int)ETC2_BLOCK_HEIGHT; y++)
+		deMemcpy(dstPtr + y*dstRowPitch, &uncompressedBlock[y*srcRowSize], srcRowSize);
 }
 
 void decompressETC2 (const PixelBufferAccess& dst, const deUint8* src)
@@ -925,9 +937,17 @@ void decompressETC2 (const PixelBufferAccess& dst, const deUint8* src)
 	using namespace EtcDecompressInternal;
 
 	deUint8* const	dstPtr			= (deUint8*)dst.getDataPtr();
+	const int		dstRowPitch		= dst.getRowPitch();
+	const int		srcRowSize		= ETC2_BLOCK_WIDTH*ETC2_UNCOMPRESSED_PIXEL_SIZE_RGB8;
 	const deUint64	compressedBlock = get64BitBlock(src, 0);
+	deUint8			uncompressedBlock[ETC2_UNCOMPRESSED_BLOCK_SIZE_RGB8];
+
+	// Decompress.
+	decompressETC2Block(uncompressedBlock, compressedBlock, NULL, false);
 
-	decompressETC2Block(dstPtr, compressedBlock, NULL, false);
+	// Write to dst.
+	for (int y = 0; y < (int)ETC2_BLOCK_HEIGHT; y++)
+		deMemcpy(dstPtr + y*dstRowPitch, &uncompressedBlock[y*srcRowSize], srcRowSize);
 }
 
 void decompressETC2_EAC_RGBA8 (const PixelBufferAccess& dst, const deUint8* src)
@@ -2488,42 +2508,188 @@ void decompressBlock (CompressedTexFormat format, const PixelBufferAccess& dst,
 	}
 }
 
-int componentSum (const IVec3& vec)
+// Block row decompression.
+//
+// Blocks are decompressed one row of blocks at a time, where block rows of
+// all block slices are numbered consecutively. Blocks that lie completely
+// inside dst are decompressed directly into dst, and partial blocks at the
+// right and bottom edges through a temporary block.
+//
+// In EXECMODE_PARALLEL block rows are grouped into tiles that are
+// decompressed on multiple threads. Blocks are independent, so output is the
+// same regardless of number of cores or scheduling.
+
+enum
 {
-	return vec.x() + vec.y() + vec.z();
+	DECOMPRESS_TILE_BLOCKS	= 256	//!< Approximate number of blocks in a tile in parallel mode.
+};
+
+class DecompressTask
+{
+public:
+							DecompressTask		(const PixelBufferAccess& dst, CompressedTexFormat format, const deUint8* src, const TexDecompressionParams& params);
+
+	//! Decompress all tiles. Exceptions thrown by tiles are re-thrown on the calling thread.
+	void					execute				(void);
+
+	//! Decompress tiles until none are left. Called by all participating threads.
+	void					decompressTiles		(void);
+
+private:
+							DecompressTask		(const DecompressTask&);
+	DecompressTask&			operator=			(const DecompressTask&);
+
+	void					decompressTile		(int tileNdx);
+
+	const PixelBufferAccess			m_dst;
+	const CompressedTexFormat		m_format;
+	const deUint8* const			m_src;
+	const TexDecompressionParams	m_params;
+	const IVec3						m_blockPixelSize;
+	const IVec3						m_blockCount;
+	const int						m_blockSize;
+	const bool						m_directWrite;
+
+	const int						m_numRows;
+	const int						m_rowsPerTile;
+	const int						m_numTiles;
+	volatile deInt32				m_nextTile;
+	std::vector<deUint8>			m_tileFailed;
+};
+
+class DecompressThread : public de::Thread
+{
+public:
+					DecompressThread	(DecompressTask& task) : m_task(task) {}
+	void			run					(void) { m_task.decompressTiles(); }
+
+private:
+	DecompressTask&	m_task;
+};
+
+DecompressTask::DecompressTask (const PixelBufferAccess& dst, CompressedTexFormat format, const deUint8* src, const TexDecompressionParams& params)
+	: m_dst				(dst)
+	, m_format			(format)
+	, m_src				(src)
+	, m_params			(params)
+	, m_blockPixelSize	(getBlockPixelSize(format))
+	, m_blockCount		(deDivRoundUp32(dst.getWidth(),		m_blockPixelSize.x()),
+						 deDivRoundUp32(dst.getHeight(),	m_blockPixelSize.y()),
+						 deDivRoundUp32(dst.getDepth(),		m_blockPixelSize.z()))
+	, m_blockSize		(getBlockSize(format))
+	, m_directWrite		(dst.getPixelPitch() == dst.getFormat().getPixelSize())	// Block decoders write tightly packed rows of pixels.
+	, m_numRows			(m_blockCount.y() * m_blockCount.z())
+	, m_rowsPerTile		(params.execMode == TexDecompressionParams::EXECMODE_PARALLEL ? de::max(1, DECOMPRESS_TILE_BLOCKS / de::max(m_blockCount.x(), 1)) : de::max(m_numRows, 1))
+	, m_numTiles		((m_numRows + m_rowsPerTile - 1) / m_rowsPerTile)
+	, m_nextTile		(0)
+	, m_tileFailed		((size_t)m_numTiles, 0)
+{
+	DE_ASSERT(de::inBounds(params.execMode, TexDecompressionParams::EXECMODE_SERIAL, TexDecompressionParams::EXECMODE_LAST));
+	DE_ASSERT(dst.getFormat() == getUncompressedFormat(format));
 }
 
-} // anonymous
+void DecompressTask::decompressTile (int tileNdx)
+{
+	const int				beginRow			= tileNdx * m_rowsPerTile;
+	const int				endRow				= de::min(beginRow + m_rowsPerTile, m_numRows);
+	std::vector<deUint8>	uncompressedBlock	(m_dst.getFormat().getPixelSize() * m_blockPixelSize.x() * m_blockPixelSize.y() * m_blockPixelSize.z());
+	const PixelBufferAccess	blockAccess			(m_dst.getFormat(), m_blockPixelSize.x(), m_blockPixelSize.y(), m_blockPixelSize.z(), &uncompressedBlock[0]);
 
-void decompress (const PixelBufferAccess& dst, CompressedTexFormat fmt, const deUint8* src, const TexDecompressionParams& params)
+	for (int rowNdx = beginRow; rowNdx < endRow; rowNdx++)
+	{
+		const int	blockY	= rowNdx % m_blockCount.y();
+		const int	blockZ	= rowNdx / m_blockCount.y();
+
+		for (int blockX = 0; blockX < m_blockCount.x(); blockX++)
+		{
+			const IVec3				blockPos	(blockX, blockY, blockZ);
+			const deUint8* const	blockPtr	= m_src + (size_t)m_blockSize * (size_t)(blockX + m_blockCount.x() * (blockY + m_blockCount.y() * blockZ));
+			const IVec3				dstPixelPos	= blockPos * m_blockPixelSize;
+			const IVec3				copySize	(de::min(m_blockPixelSize.x(), m_dst.getWidth()	- dstPixelPos.x()),
+												 de::min(m_blockPixelSize.y(), m_dst.getHeight()	- dstPixelPos.y()),
+												 de::min(m_blockPixelSize.z(), m_dst.getDepth()		- dstPixelPos.z()));
+			const PixelBufferAccess	dstRegion	= getSubregion(m_dst, dstPixelPos.x(), dstPixelPos.y(), dstPixelPos.z(), copySize.x(), copySize.y(), copySize.z());
+
+			if (m_directWrite && copySize == m_blockPixelSize)
+				decompressBlock(m_format, dstRegion, blockPtr, m_params);
+			else
+			{
+				decompressBlock(m_format, blockAccess, blockPtr, m_params);
+				copy(dstRegion, getSubregion(blockAccess, 0, 0, 0, copySize.x(), copySize.y(), copySize.z()));
+			}
+		}
+	}
+}
+
+void DecompressTask::decompressTiles (void)
 {
-	const int				blockSize			= getBlockSize(fmt);
-	const IVec3				blockPixelSize		(getBlockPixelSize(fmt));
-	const IVec3				blockCount			(deDivRoundUp32(dst.getWidth(),		blockPixelSize.x()),
-												 deDivRoundUp32(dst.getHeight(),	blockPixelSize.y()),
-												 deDivRoundUp32(dst.getDepth(),		blockPixelSize.z()));
-	const IVec3				blockPitches		(blockSize, blockSize * blockCount.x(), blockSize * blockCount.x() * blockCount.y());
+	for (;;)
+	{
+		const int tileNdx = deAtomicIncrementInt32(&m_nextTile) - 1;
+
+		if (tileNdx >= m_numTiles)
+			break;
 
-	std::vector<deUint8>	uncompressedBlock	(dst.getFormat().getPixelSize() * blockPixelSize.x() * blockPixelSize.y() * blockPixelSize.z());
-	const PixelBufferAccess	blockAccess			(getUncompressedFormat(fmt), blockPixelSize.x(), blockPixelSize.y(), blockPixelSize.z(), &uncompressedBlock[0]);
+		try
+		{
+			decompressTile(tileNdx);
+		}
+		catch (...)
+		{
+			m_tileFailed[tileNdx] = 1;
+		}
+	}
+}
 
-	DE_ASSERT(dst.getFormat() == getUncompressedFormat(fmt));
+void DecompressTask::execute (void)
+{
+	const int										numThreads	= de::min((int)deGetNumAvailableLogicalCores(), m_numTiles);
+	std::vector<de::SharedPtr<DecompressThread> >	threads;
 
-	for (int blockZ = 0; blockZ < blockCount.z(); blockZ++)
-	for (int blockY = 0; blockY < blockCount.y(); blockY++)
-	for (int blockX = 0; blockX < blockCount.x(); blockX++)
+	if (numThreads <= 1)
 	{
-		const IVec3				blockPos	(blockX, blockY, blockZ);
-		const deUint8* const	blockPtr	= src + componentSum(blockPos * blockPitches);
-		const IVec3				copySize	(de::min(blockPixelSize.x(), dst.getWidth()		- blockPos.x() * blockPixelSize.x()),
-											 de::min(blockPixelSize.y(), dst.getHeight()	- blockPos.y() * blockPixelSize.y()),
-											 de::min(blockPixelSize.z(), dst.getDepth()		- blockPos.z() * blockPixelSize.z()));
-		const IVec3				dstPixelPos	= blockPos * blockPixelSize;
+		for (int tileNdx = 0; tileNdx < m_numTiles; tileNdx++)
+			decompressTile(tileNdx);
+		return;
+	}
 
-		decompressBlock(fmt, blockAccess, blockPtr, params);
+	for (int threadNdx = 1; threadNdx < numThreads; threadNdx++)
+	{
+		const de::SharedPtr<DecompressThread> thread (new DecompressThread(*this));
 
-		copy(getSubregion(dst, dstPixelPos.x(), dstPixelPos.y(), dstPixelPos.z(), copySize.x(), copySize.y(), copySize.z()), getSubregion(blockAccess, 0, 0, 0, copySize.x(), copySize.y(), copySize.z()));
+		try
+		{
+			thread->start();
+		}
+		catch (const std::bad_alloc&)
+		{
+			// Continue with threads started so far.
+			break;
+		}
+
+		threads.push_back(thread);
 	}
+
+	decompressTiles();
+
+	for (size_t threadNdx = 0; threadNdx < threads.size(); threadNdx++)
+		threads[threadNdx]->join();
+
+	// Tiles are independent, so re-running a failed tile reproduces the original exception on this thread.
+	for (int tileNdx = 0; tileNdx < m_numTiles; tileNdx++)
+	{
+		if (m_tileFailed[tileNdx])
+			decompressTile(tileNdx);
+	}
+}
+
+} // anonymous
+
+void decompress (const PixelBufferAccess& dst, CompressedTexFormat fmt, const deUint8* src, const TexDecompressionParams& params)
+{
+	DecompressTask task (dst, fmt, src, params);
+
+	task.execute();
 }
 
 CompressedTexture::CompressedTexture (void)
@@ -116,9 +116,17 @@ struct TexDecompressionParams
 		ASTCMODE_LAST
 	};
 
-	TexDecompressionParams (AstcMode astcMode_ = ASTCMODE_LAST) : astcMode(astcMode_) {}
+	enum ExecMode
+	{
+		EXECMODE_SERIAL = 0,	//!< Decompress all blocks on the calling thread.
+		EXECMODE_PARALLEL,		//!< Decompress rows of blocks on all available cores. Output does not depend on number of cores.
+		EXECMODE_LAST
+	};
+
+	TexDecompressionParams (AstcMode astcMode_ = ASTCMODE_LAST, ExecMode execMode_ = EXECMODE_PARALLEL) : astcMode(astcMode_), execMode(execMode_) {}
 
 	AstcMode astcMode;
+	ExecMode execMode;
 };
 
 /*--------------------------------------------------------------------*//*!
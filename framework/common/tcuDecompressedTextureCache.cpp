@@ -0,0 +1,232 @@
+/*-------------------------------------------------------------------------
+ * drawElements Quality Program Tester Core
+ * ----------------------------------------
+ *
+ * Copyright 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *//*!
+ * \file
+ * \brief Cache of decompressed compressed texture data.
+ *//*--------------------------------------------------------------------*/
+
+#include "tcuDecompressedTextureCache.hpp"
+#include "tcuTextureUtil.hpp"
+
+#include "deMemory.h"
+
+namespace tcu
+{
+
+namespace
+{
+
+// 64-bit FNV-1a
+class Hasher
+{
+public:
+				Hasher		(void) : m_hash(0xcbf29ce484222325ull) {}
+
+	void		add			(const void* data, size_t size)
+	{
+		const deUint8* const bytes = (const deUint8*)data;
+
+		for (size_t ndx = 0; ndx < size; ndx++)
+		{
+			m_hash ^= bytes[ndx];
+			m_hash *= 0x100000001b3ull;
+		}
+	}
+
+	void		add			(deUint32 value)	{ add(&value, sizeof(value));	}
+	deUint64	get			(void) const		{ return m_hash;				}
+
+private:
+	deUint64	m_hash;
+};
+
+// ASTC mode does not affect other formats so it is not part of their key.
+TexDecompressionParams::AstcMode getKeyAstcMode (CompressedTexFormat format, const TexDecompressionParams& params)
+{
+	return isAstcFormat(format) ? params.astcMode : TexDecompressionParams::ASTCMODE_LAST;
+}
+
+deUint64 computeKeyHash (const CompressedTexture& texture, TexDecompressionParams::AstcMode astcMode)
+{
+	Hasher hasher;
+
+	hasher.add((deUint32)texture.getFormat());
+	hasher.add((deUint32)texture.getWidth());
+	hasher.add((deUint32)texture.getHeight());
+	hasher.add((deUint32)texture.getDepth());
+	hasher.add((deUint32)astcMode);
+	hasher.add(texture.getData(), (size_t)texture.getDataSize());
+
+	return hasher.get();
+}
+
+} // anonymous
+
+DecompressedTextureCache::DecompressedTextureCache (size_t maxCachedSize)
+	: m_maxCachedSize(maxCachedSize)
+{
+}
+
+DecompressedTextureCache::~DecompressedTextureCache (void)
+{
+}
+
+DecompressedTextureCache& DecompressedTextureCache::getInstance (void)
+{
+	static DecompressedTextureCache s_cache;
+	return s_cache;
+}
+
+DecompressedTextureCache::EntryList::iterator DecompressedTextureCache::find (deUint64 hash, const CompressedTexture& texture, TexDecompressionParams::AstcMode astcMode)
+{
+	const std::pair<EntryIndex::iterator, EntryIndex::iterator> range = m_index.equal_range(hash);
+
+	for (EntryIndex::iterator indexIter = range.first; indexIter != range.second; ++indexIter)
+	{
+		const Entry& entry = *indexIter->second;
+
+		if (entry.format		== texture.getFormat()												&&
+			entry.size			== IVec3(texture.getWidth(), texture.getHeight(), texture.getDepth())	&&
+			entry.astcMode		== astcMode															&&
+			entry.data.size()	== (size_t)texture.getDataSize()									&&
+			(entry.data.empty() || deMemCmp(&entry.data[0], texture.getData(), entry.data.size()) == 0))
+			return indexIter->second;
+	}
+
+	return m_entries.end();
+}
+
+void DecompressedTextureCache::evict (size_t maxCachedSize)
+{
+	while (m_statistics.cachedSize > maxCachedSize)
+	{
+		const EntryList::iterator	lruEntry	= --m_entries.end();
+		const std::pair<EntryIndex::iterator, EntryIndex::iterator> range = m_index.equal_range(lruEntry->hash);
+
+		for (EntryIndex::iterator indexIter = range.first; indexIter != range.second; ++indexIter)
+		{
+			if (indexIter->second == lruEntry)
+			{
+				m_index.erase(indexIter);
+				break;
+			}
+		}
+
+		m_statistics.cachedSize	-= lruEntry->levelSize;
+		m_statistics.numEvictions	+= 1;
+		m_entries.erase(lruEntry);
+	}
+}
+
+de::SharedPtr<const TextureLevel> DecompressedTextureCache::get (const CompressedTexture& texture, const TexDecompressionParams& params)
+{
+	const TexDecompressionParams::AstcMode	astcMode	= getKeyAstcMode(texture.getFormat(), params);
+	const deUint64							hash		= computeKeyHash(texture, astcMode);
+
+	{
+		const de::ScopedLock			lock	(m_lock);
+		const EntryList::iterator		entry	= find(hash, texture, astcMode);
+
+		if (entry != m_entries.end())
+		{
+			m_entries.splice(m_entries.begin(), m_entries, entry);
+			m_statistics.numHits += 1;
+			return entry->level;
+		}
+
+		m_statistics.numMisses += 1;
+	}
+
+	// Decompress without holding the lock so that other threads can use the cache meanwhile.
+	{
+		TextureLevel* const						level		= new TextureLevel(getUncompressedFormat(texture.getFormat()), texture.getWidth(), texture.getHeight(), texture.getDepth());
+		const de::SharedPtr<const TextureLevel>	levelPtr	(level);
+		const size_t							levelSize	= (size_t)(level->getFormat().getPixelSize()*texture.getWidth()*texture.getHeight()*texture.getDepth());
+
+		texture.decompress(level->getAccess(), params);
+
+		{
+			const de::ScopedLock		lock	(m_lock);
+			const EntryList::iterator	entry	= find(hash, texture, astcMode);
+
+			// Another thread may have added the same texture meanwhile.
+			if (entry != m_entries.end())
+				return entry->level;
+
+			if (levelSize > m_maxCachedSize)
+				return levelPtr;
+
+			evict(m_maxCachedSize - levelSize);
+
+			m_entries.push_front(Entry());
+
+			{
+				Entry& newEntry = m_entries.front();
+
+				newEntry.hash		= hash;
+				newEntry.format		= texture.getFormat();
+				newEntry.size		= IVec3(texture.getWidth(), texture.getHeight(), texture.getDepth());
+				newEntry.astcMode	= astcMode;
+				newEntry.data		= std::vector<deUint8>((const deUint8*)texture.getData(), (const deUint8*)texture.getData() + texture.getDataSize());
+				newEntry.level		= levelPtr;
+				newEntry.levelSize	= levelSize;
+			}
+
+			m_index.insert(std::make_pair(hash, m_entries.begin()));
+			m_statistics.cachedSize += levelSize;
+
+			return levelPtr;
+		}
+	}
+}
+
+void DecompressedTextureCache::decompress (const PixelBufferAccess& dst, const CompressedTexture& texture, const TexDecompressionParams& params)
+{
+	const de::SharedPtr<const TextureLevel> level = get(texture, params);
+
+	DE_ASSERT(dst.getSize() == level->getSize());
+	DE_ASSERT(dst.getFormat() == level->getFormat());
+
+	copy(dst, level->getAccess());
+}
+
+DecompressedTextureCache::Statistics DecompressedTextureCache::getStatistics (void) const
+{
+	const de::ScopedLock lock (m_lock);
+	return m_statistics;
+}
+
+void DecompressedTextureCache::setMaxCachedSize (size_t maxCachedSize)
+{
+	const de::ScopedLock lock (m_lock);
+
+	m_maxCachedSize = maxCachedSize;
+	evict(m_maxCachedSize);
+}
+
+void DecompressedTextureCache::clear (void)
+{
+	const de::ScopedLock lock (m_lock);
+
+	m_entries.clear();
+	m_index.clear();
+	m_statistics.cachedSize = 0;
+}
+
+} // tcu
@@ -0,0 +1,111 @@
+#ifndef _TCUDECOMPRESSEDTEXTURECACHE_HPP
+#define _TCUDECOMPRESSEDTEXTURECACHE_HPP
+/*-------------------------------------------------------------------------
+ * drawElements Quality Program Tester Core
+ * ----------------------------------------
+ *
+ * Copyright 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *//*!
+ * \file
+ * \brief Cache of decompressed compressed texture data.
+ *//*--------------------------------------------------------------------*/
+
+#include "tcuDefs.hpp"
+#include "tcuCompressedTexture.hpp"
+#include "tcuTexture.hpp"
+#include "deSharedPtr.hpp"
+#include "deMutex.hpp"
+
+#include <list>
+#include <map>
+#include <vector>
+
+namespace tcu
+{
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Size-bounded LRU cache of decompressed textures
+ *
+ * Many test cases decompress identical generated block data to build
+ * reference images. The cache keeps the decompressed results keyed by
+ * format, size, decompression mode and the compressed bytes so that each
+ * unique payload is decompressed only once per run. Cached levels are
+ * immutable and may be shared between callers.
+ *
+ * All methods are thread-safe.
+ *//*--------------------------------------------------------------------*/
+class DecompressedTextureCache
+{
+public:
+	enum
+	{
+		DEFAULT_MAX_CACHED_SIZE	= 64*1024*1024	//!< Default limit for total size of cached decompressed data in bytes.
+	};
+
+	struct Statistics
+	{
+		deUint64	numHits;
+		deUint64	numMisses;
+		deUint64	numEvictions;
+		size_t		cachedSize;		//!< Total size of currently cached decompressed data in bytes.
+
+		Statistics (void) : numHits(0), numMisses(0), numEvictions(0), cachedSize(0) {}
+	};
+
+	explicit								DecompressedTextureCache	(size_t maxCachedSize = DEFAULT_MAX_CACHED_SIZE);
+											~DecompressedTextureCache	(void);
+
+	//! Process-wide cache instance
+	static DecompressedTextureCache&		getInstance					(void);
+
+	de::SharedPtr<const TextureLevel>		get							(const CompressedTexture& texture, const TexDecompressionParams& params = TexDecompressionParams());
+	void									decompress					(const PixelBufferAccess& dst, const CompressedTexture& texture, const TexDecompressionParams& params = TexDecompressionParams());
+
+	Statistics								getStatistics				(void) const;
+	void									setMaxCachedSize			(size_t maxCachedSize);
+	void									clear						(void);
+
+private:
+											DecompressedTextureCache	(const DecompressedTextureCache&); // disabled, non-copyable
+	DecompressedTextureCache&				operator=					(const DecompressedTextureCache&); // disabled, non-copyable
+
+	struct Entry
+	{
+		deUint64							hash;
+		CompressedTexFormat					format;
+		IVec3								size;
+		TexDecompressionParams::AstcMode	astcMode;
+		std::vector<deUint8>				data;
+		de::SharedPtr<const TextureLevel>	level;
+		size_t								levelSize;
+	};
+
+	typedef std::list<Entry>							EntryList;		//!< Most recently used first.
+	typedef std::multimap<deUint64, EntryList::iterator>	EntryIndex;
+
+	EntryList::iterator						find						(deUint64 hash, const CompressedTexture& texture, TexDecompressionParams::AstcMode astcMode);
+	void									evict						(size_t maxCachedSize);
+
+	mutable de::Mutex						m_lock;
+	size_t									m_maxCachedSize;
+	EntryList								m_entries;
+	EntryIndex								m_index;
+	Statistics								m_statistics;
+};
+
+} // tcu
+
+#endif // _TCUDECOMPRESSEDTEXTURECACHE_HPP
@@ -32,8 +32,21 @@
 #include "tcuTexture.hpp"
 #include "tcuTextureUtil.hpp"
 #include "tcuFloat.hpp"
+#include "deFloat16.h"
+#include "deThread.hpp"
+#include "deSharedPtr.hpp"
+#include "deAtomic.h"
 
 #include <string.h>
+#include <vector>
+
+#if (DE_CPU == DE_CPU_X86_64)
+#	define TCU_IMAGE_COMPARE_SSE2
+#	include <emmintrin.h>
+#elif (DE_CPU == DE_CPU_ARM_64)
+#	define TCU_IMAGE_COMPARE_NEON
+#	include <arm_neon.h>
+#endif
 
 namespace tcu
 {
@@ -88,41 +101,752 @@ void computeScaleAndBias (const ConstPixelBufferAccess& reference, const ConstPi
 	}
 }
 
-static int findNumPositionDeviationFailingPixels (const PixelBufferAccess& errorMask, const ConstPixelBufferAccess& reference, const ConstPixelBufferAccess& result, const UVec4& threshold, const tcu::IVec3& maxPositionDeviation, bool acceptOutOfBoundsAsAnyValue)
+// Format-specialized compare paths.
+//
+// Row kernels below read tightly packed rows directly and produce exactly
+// the same error mask and max difference as the generic per-pixel loops,
+// including handling of NaNs and signed zeros.
+
+bool isTightlyPacked (const ConstPixelBufferAccess& access)
 {
-	const tcu::IVec4	okColor				(0, 255, 0, 255);
-	const tcu::IVec4	errorColor			(255, 0, 0, 255);
-	const int			width				= reference.getWidth();
-	const int			height				= reference.getHeight();
-	const int			depth				= reference.getDepth();
-	int					numFailingPixels	= 0;
+	return access.getPixelPitch() == getPixelSize(access.getFormat()) && access.getDivider() == IVec3(1);
+}
 
-	// Accept pixels "sampling" over the image bounds pixels since "taps" could be anything
-	const int			beginX				= (acceptOutOfBoundsAsAnyValue) ? (maxPositionDeviation.x()) : (0);
-	const int			beginY				= (acceptOutOfBoundsAsAnyValue) ? (maxPositionDeviation.y()) : (0);
-	const int			beginZ				= (acceptOutOfBoundsAsAnyValue) ? (maxPositionDeviation.z()) : (0);
-	const int			endX				= (acceptOutOfBoundsAsAnyValue) ? (width  - maxPositionDeviation.x()) : (width);
-	const int			endY				= (acceptOutOfBoundsAsAnyValue) ? (height - maxPositionDeviation.y()) : (height);
-	const int			endZ				= (acceptOutOfBoundsAsAnyValue) ? (depth  - maxPositionDeviation.z()) : (depth);
+inline void setErrorMaskPixel (deUint8* dst, bool isOk)
+{
+	dst[0] = isOk ? 0x00 : 0xff;
+	dst[1] = isOk ? 0xff : 0x00;
+	dst[2] = 0x00;
+}
 
-	TCU_CHECK_INTERNAL(result.getWidth() == width && result.getHeight() == height && result.getDepth() == depth);
-	DE_ASSERT(endX > 0 && endY > 0 && endZ > 0);	// most likely a bug
+deUint8* getErrorMaskRow (const PixelBufferAccess& errorMask, int y, int z)
+{
+	DE_ASSERT(errorMask.getFormat() == TextureFormat(TextureFormat::RGB, TextureFormat::UNORM_INT8) && isTightlyPacked(errorMask));
+	return (deUint8*)errorMask.getPixelPtr(0, y, z);
+}
 
-	tcu::clear(errorMask, okColor);
+bool isFloatRowFormat (const ConstPixelBufferAccess& access)
+{
+	const TextureFormat& format = access.getFormat();
 
-	for (int z = beginZ; z < endZ; z++)
+	return isTightlyPacked(access)													&&
+		   (format == TextureFormat(TextureFormat::RGBA, TextureFormat::UNORM_INT8)	||
+			format == TextureFormat(TextureFormat::RGBA, TextureFormat::HALF_FLOAT)	||
+			format == TextureFormat(TextureFormat::RGBA, TextureFormat::FLOAT));
+}
+
+void convertUnorm8RowToFloat (const deUint8* src, int numValues, float* dst)
+{
+	int ndx = 0;
+
+#if defined(TCU_IMAGE_COMPARE_SSE2)
 	{
-		for (int y = beginY; y < endY; y++)
+		const __m128i	zero	= _mm_setzero_si128();
+		const __m128	scale	= _mm_set1_ps(255.0f);
+
+		for (; ndx + 16 <= numValues; ndx += 16)
 		{
-			for (int x = beginX; x < endX; x++)
+			const __m128i	bytes	= _mm_loadu_si128((const __m128i*)(src + ndx));
+			const __m128i	lo16	= _mm_unpacklo_epi8(bytes, zero);
+			const __m128i	hi16	= _mm_unpackhi_epi8(bytes, zero);
+
+			_mm_storeu_ps(dst + ndx + 0,	_mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo16, zero)), scale));
+			_mm_storeu_ps(dst + ndx + 4,	_mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo16, zero)), scale));
+			_mm_storeu_ps(dst + ndx + 8,	_mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi16, zero)), scale));
+			_mm_storeu_ps(dst + ndx + 12,	_mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi16, zero)), scale));
+		}
+	}
+#elif defined(TCU_IMAGE_COMPARE_NEON)
+	{
+		const float32x4_t scale = vdupq_n_f32(255.0f);
+
+		for (; ndx + 16 <= numValues; ndx += 16)
+		{
+			const uint8x16_t	bytes	= vld1q_u8(src + ndx);
+			const uint16x8_t	lo16	= vmovl_u8(vget_low_u8(bytes));
+			const uint16x8_t	hi16	= vmovl_u8(vget_high_u8(bytes));
+
+			vst1q_f32(dst + ndx + 0,	vdivq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(lo16))), scale));
+			vst1q_f32(dst + ndx + 4,	vdivq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(lo16))), scale));
+			vst1q_f32(dst + ndx + 8,	vdivq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(hi16))), scale));
+			vst1q_f32(dst + ndx + 12,	vdivq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(hi16))), scale));
+		}
+	}
+#endif
+
+	// Same conversion as in readRGBA8888Float()
+	for (; ndx < numValues; ndx++)
+		dst[ndx] = src[ndx]/255.0f;
+}
+
+//! Get row of RGBA float pixels. Row is converted into storage if needed.
+const float* getFloatRow (const ConstPixelBufferAccess& access, int y, int z, std::vector<float>& storage)
+{
+	const int		numValues	= access.getWidth()*4;
+	const void*		rowPtr		= access.getPixelPtr(0, y, z);
+
+	DE_ASSERT(isFloatRowFormat(access));
+
+	switch (access.getFormat().type)
+	{
+		case TextureFormat::FLOAT:
+			return (const float*)rowPtr;
+
+		case TextureFormat::HALF_FLOAT:
+			storage.resize(numValues);
+			for (int ndx = 0; ndx < numValues; ndx++)
+				storage[ndx] = deFloat16To32(((const deFloat16*)rowPtr)[ndx]);
+			return &storage[0];
+
+		case TextureFormat::UNORM_INT8:
+			storage.resize(numValues);
+			convertUnorm8RowToFloat((const deUint8*)rowPtr, numValues, &storage[0]);
+			return &storage[0];
+
+		default:
+			DE_ASSERT(false);
+			return DE_NULL;
+	}
+}
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Compare row of RGBA float pixels
+ *
+ * Equivalent to the generic floatThresholdCompare() loop: diff is computed
+ * with de::abs() and accumulated with de::max(maxDiff, diff).
+ *
+ * \param refPixelStride	Float offset between reference pixels, 0 when
+ *							comparing against a single color.
+ *//*--------------------------------------------------------------------*/
+void compareFloatRow (const float* ref, int refPixelStride, const float* cmp, int width, const Vec4& threshold, deUint8* errorMask, Vec4& maxDiff)
+{
+#if defined(TCU_IMAGE_COMPARE_SSE2)
+	const __m128	thresholdVec	= _mm_loadu_ps(threshold.getPtr());
+	const __m128	zero			= _mm_setzero_ps();
+	const __m128	signBit			= _mm_set1_ps(-0.0f);
+	__m128			maxDiffVec		= _mm_loadu_ps(maxDiff.getPtr());
+
+	for (int x = 0; x < width; x++)
+	{
+		const __m128	delta		= _mm_sub_ps(_mm_loadu_ps(ref + x*refPixelStride), _mm_loadu_ps(cmp + x*4));
+		const __m128	isNegative	= _mm_cmplt_ps(delta, zero);
+		const __m128	diff		= _mm_or_ps(_mm_and_ps(isNegative, _mm_xor_ps(delta, signBit)), _mm_andnot_ps(isNegative, delta));
+		const __m128	keepMax		= _mm_cmpge_ps(maxDiffVec, diff);
+		const bool		isOk		= _mm_movemask_ps(_mm_cmple_ps(diff, thresholdVec)) == 0xf;
+
+		maxDiffVec = _mm_or_ps(_mm_and_ps(keepMax, maxDiffVec), _mm_andnot_ps(keepMax, diff));
+		setErrorMaskPixel(errorMask + x*3, isOk);
+	}
+
+	_mm_storeu_ps(maxDiff.getPtr(), maxDiffVec);
+#elif defined(TCU_IMAGE_COMPARE_NEON)
+	const float32x4_t	thresholdVec	= vld1q_f32(threshold.getPtr());
+	const float32x4_t	zero			= vdupq_n_f32(0.0f);
+	float32x4_t			maxDiffVec		= vld1q_f32(maxDiff.getPtr());
+
+	for (int x = 0; x < width; x++)
+	{
+		const float32x4_t	delta		= vsubq_f32(vld1q_f32(ref + x*refPixelStride), vld1q_f32(cmp + x*4));
+		const float32x4_t	diff		= vbslq_f32(vcltq_f32(delta, zero), vnegq_f32(delta), delta);
+		const bool			isOk		= vminvq_u32(vcleq_f32(diff, thresholdVec)) != 0;
+
+		maxDiffVec = vbslq_f32(vcgeq_f32(maxDiffVec, diff), maxDiffVec, diff);
+		setErrorMaskPixel(errorMask + x*3, isOk);
+	}
+
+	vst1q_f32(maxDiff.getPtr(), maxDiffVec);
+#else
+	for (int x = 0; x < width; x++)
+	{
+		const float* const	refPix	= ref + x*refPixelStride;
+		const float* const	cmpPix	= cmp + x*4;
+		const Vec4			diff	= abs(Vec4(refPix[0], refPix[1], refPix[2], refPix[3]) - Vec4(cmpPix[0], cmpPix[1], cmpPix[2], cmpPix[3]));
+
+		maxDiff = max(maxDiff, diff);
+		setErrorMaskPixel(errorMask + x*3, boolAll(lessThanEqual(diff, threshold)));
+	}
+#endif
+}
+
+bool isIntRowFormat (const ConstPixelBufferAccess& reference, const ConstPixelBufferAccess& result)
+{
+	const TextureFormat& format = reference.getFormat();
+
+	return format == result.getFormat() && isTightlyPacked(reference) && isTightlyPacked(result) &&
+		   (format == TextureFormat(TextureFormat::RGBA, TextureFormat::UNORM_INT8) ||
+			format == TextureFormat(TextureFormat::R, TextureFormat::UNSIGNED_INT32));
+}
+
+//! Compare row of RGBA8 pixels as integers. Differences fit into 8 bits so per-channel max is kept in bytes.
+void compareRGBA8Row (const deUint8* ref, const deUint8* cmp, int width, const UVec4& threshold, deUint8* errorMask, deUint8 maxDiff[4])
+{
+	deUint8	thresholdBytes[16];
+	int		x				= 0;
+
+	for (int ndx = 0; ndx < DE_LENGTH_OF_ARRAY(thresholdBytes); ndx++)
+		thresholdBytes[ndx] = (deUint8)de::min(threshold[ndx%4], 255u);
+
+#if defined(TCU_IMAGE_COMPARE_SSE2)
+	{
+		const __m128i	thresholdVec	= _mm_loadu_si128((const __m128i*)thresholdBytes);
+		const __m128i	zero			= _mm_setzero_si128();
+		__m128i			maxDiffVec		= zero;
+		deUint8			maxDiffBytes[16];
+
+		for (; x + 4 <= width; x += 4)
+		{
+			const __m128i	refPix		= _mm_loadu_si128((const __m128i*)(ref + x*4));
+			const __m128i	cmpPix		= _mm_loadu_si128((const __m128i*)(cmp + x*4));
+			const __m128i	diff		= _mm_or_si128(_mm_subs_epu8(refPix, cmpPix), _mm_subs_epu8(cmpPix, refPix));
+			const int		okMask		= _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(_mm_subs_epu8(diff, thresholdVec), zero)));
+
+			maxDiffVec = _mm_max_epu8(maxDiffVec, diff);
+
+			for (int ndx = 0; ndx < 4; ndx++)
+				setErrorMaskPixel(errorMask + (x+ndx)*3, ((okMask >> ndx) & 1) != 0);
+		}
+
+		_mm_storeu_si128((__m128i*)maxDiffBytes, maxDiffVec);
+
+		for (int ndx = 0; ndx < DE_LENGTH_OF_ARRAY(maxDiffBytes); ndx++)
+			maxDiff[ndx%4] = de::max(maxDiff[ndx%4], maxDiffBytes[ndx]);
+	}
+#elif defined(TCU_IMAGE_COMPARE_NEON)
+	{
+		const uint8x16_t	thresholdVec	= vld1q_u8(thresholdBytes);
+		uint8x16_t			maxDiffVec		= vdupq_n_u8(0);
+		deUint8				maxDiffBytes[16];
+
+		for (; x + 4 <= width; x += 4)
+		{
+			const uint8x16_t	diff		= vabdq_u8(vld1q_u8(ref + x*4), vld1q_u8(cmp + x*4));
+			const uint32x4_t	isOk		= vceqq_u32(vreinterpretq_u32_u8(vqsubq_u8(diff, thresholdVec)), vdupq_n_u32(0));
+
+			maxDiffVec = vmaxq_u8(maxDiffVec, diff);
+
+			setErrorMaskPixel(errorMask + (x+0)*3, vgetq_lane_u32(isOk, 0) != 0);
+			setErrorMaskPixel(errorMask + (x+1)*3, vgetq_lane_u32(isOk, 1) != 0);
+			setErrorMaskPixel(errorMask + (x+2)*3, vgetq_lane_u32(isOk, 2) != 0);
+			setErrorMaskPixel(errorMask + (x+3)*3, vgetq_lane_u32(isOk, 3) != 0);
+		}
+
+		vst1q_u8(maxDiffBytes, maxDiffVec);
+
+		for (int ndx = 0; ndx < DE_LENGTH_OF_ARRAY(maxDiffBytes); ndx++)
+			maxDiff[ndx%4] = de::max(maxDiff[ndx%4], maxDiffBytes[ndx]);
+	}
+#endif
+
+	for (; x < width; x++)
+	{
+		bool isOk = true;
+
+		for (int c = 0; c < 4; c++)
+		{
+			const deUint8 diff = (deUint8)de::abs((int)ref[x*4+c] - (int)cmp[x*4+c]);
+
+			maxDiff[c]	= de::max(maxDiff[c], diff);
+			isOk		= isOk && diff <= thresholdBytes[c];
+		}
+
+		setErrorMaskPixel(errorMask + x*3, isOk);
+	}
+}
+
+//! Compare row of R32UI pixels. Without use64Bits, difference wraps around like abs(IVec4 - IVec4) in the generic path.
+void compareR32UIRow (const deUint32* ref, const deUint32* cmp, int width, deUint64 threshold, bool use64Bits, deUint8* errorMask, deUint64& maxDiff)
+{
+	for (int x = 0; x < width; x++)
+	{
+		deUint64 diff;
+
+		if (use64Bits)
+			diff = ref[x] >= cmp[x] ? (deUint64)(ref[x] - cmp[x]) : (deUint64)(cmp[x] - ref[x]);
+		else
+		{
+			const deUint32 delta = ref[x] - cmp[x];
+			diff = (deUint64)(deInt64)(deInt32)((deInt32)delta < 0 ? 0u - delta : delta);
+		}
+
+		maxDiff = de::max(maxDiff, diff);
+		setErrorMaskPixel(errorMask + x*3, diff <= threshold);
+	}
+}
+
+bool isDepthStencilRowFormat (const ConstPixelBufferAccess& reference, const ConstPixelBufferAccess& result)
+{
+	const TextureFormat format (TextureFormat::DS, TextureFormat::UNSIGNED_INT_24_8);
+
+	return reference.getFormat() == format && result.getFormat() == format && isTightlyPacked(reference) && isTightlyPacked(result);
+}
+
+//! Compare row of D24S8 pixels. Depth conversion matches getPixDepth().
+void compareD24S8Row (const deUint32* ref, const deUint32* cmp, int width, float threshold, deUint8* errorMask, float& maxDiff, bool& allStencilOk)
+{
+	for (int x = 0; x < width; x++)
+	{
+		const float	refDepth	= (float)(ref[x] >> 8) / 16777215.0f;
+		const float	cmpDepth	= (float)(cmp[x] >> 8) / 16777215.0f;
+		const float	diff		= de::abs(refDepth - cmpDepth);
+		const bool	stencilOk	= (ref[x] & 0xffu) == (cmp[x] & 0xffu);
+
+		maxDiff			= (float)deMax(maxDiff, diff);
+		allStencilOk	= allStencilOk && stencilOk;
+
+		setErrorMaskPixel(errorMask + x*3, diff <= threshold && stencilOk);
+	}
+}
+
+// Tiled compare execution.
+//
+// Compare work is split into tiles of whole rows, where rows of all slices
+// are numbered consecutively. Each tile produces its own partial result, and
+// partial results are reduced in tile order once all tiles are done.
+//
+// In COMPARE_EXEC_SERIAL mode the whole image is a single tile that is
+// processed on the calling thread. In COMPARE_EXEC_PARALLEL mode tile size
+// depends only on image dimensions, so results are the same regardless of
+// number of cores or scheduling.
+
+enum
+{
+	COMPARE_TILE_PIXELS		= 16*1024	//!< Approximate number of pixels in a tile in parallel mode.
+};
+
+class CompareTileTask
+{
+public:
+							CompareTileTask		(int rowWidth, int numRows, CompareExecMode execMode);
+	virtual					~CompareTileTask	(void) {}
+
+	//! Compare all tiles. Exceptions thrown by tiles are re-thrown on the calling thread.
+	void					execute				(void);
+
+	//! Compare tiles until none are left. Called by all participating threads.
+	void					compareTiles		(void);
+
+protected:
+	int						getNumTiles			(void) const { return m_numTiles; }
+
+	virtual void			compareRows			(int tileNdx, int beginRow, int endRow) = 0;
+
+private:
+							CompareTileTask		(const CompareTileTask&);
+	CompareTileTask&		operator=			(const CompareTileTask&);
+
+	void					compareTile			(int tileNdx);
+
+	const int				m_numRows;
+	const int				m_rowsPerTile;
+	const int				m_numTiles;
+	volatile deInt32		m_nextTile;
+	std::vector<deUint8>	m_tileFailed;
+};
+
+class CompareTileThread : public de::Thread
+{
+public:
+					CompareTileThread	(CompareTileTask& task) : m_task(task) {}
+	void			run					(void) { m_task.compareTiles(); }
+
+private:
+	CompareTileTask&	m_task;
+};
+
+CompareTileTask::CompareTileTask (int rowWidth, int numRows, CompareExecMode execMode)
+	: m_numRows		(de::max(numRows, 0))
+	, m_rowsPerTile	(execMode == COMPARE_EXEC_PARALLEL ? de::max(1, COMPARE_TILE_PIXELS / de::max(rowWidth, 1)) : de::max(m_numRows, 1))
+	, m_numTiles	((m_numRows + m_rowsPerTile - 1) / m_rowsPerTile)
+	, m_nextTile	(0)
+	, m_tileFailed	((size_t)m_numTiles, 0)
+{
+	DE_ASSERT(de::inBounds(execMode, COMPARE_EXEC_SERIAL, COMPARE_EXEC_LAST));
+}
+
+void CompareTileTask::compareTile (int tileNdx)
+{
+	const int beginRow = tileNdx * m_rowsPerTile;
+
+	compareRows(tileNdx, beginRow, de::min(beginRow + m_rowsPerTile, m_numRows));
+}
+
+void CompareTileTask::compareTiles (void)
+{
+	for (;;)
+	{
+		const int tileNdx = deAtomicIncrementInt32(&m_nextTile) - 1;
+
+		if (tileNdx >= m_numTiles)
+			break;
+
+		try
+		{
+			compareTile(tileNdx);
+		}
+		catch (...)
+		{
+			m_tileFailed[tileNdx] = 1;
+		}
+	}
+}
+
+void CompareTileTask::execute (void)
+{
+	const int										numThreads	= de::min((int)deGetNumAvailableLogicalCores(), m_numTiles);
+	std::vector<de::SharedPtr<CompareTileThread> >	threads;
+
+	if (numThreads <= 1)
+	{
+		for (int tileNdx = 0; tileNdx < m_numTiles; tileNdx++)
+			compareTile(tileNdx);
+		return;
+	}
+
+	for (int threadNdx = 1; threadNdx < numThreads; threadNdx++)
+	{
+		const de::SharedPtr<CompareTileThread> thread (new CompareTileThread(*this));
+
+		try
+		{
+			thread->start();
+		}
+		catch (const std::bad_alloc&)
+		{
+			// Continue with threads started so far.
+			break;
+		}
+
+		threads.push_back(thread);
+	}
+
+	compareTiles();
+
+	for (size_t threadNdx = 0; threadNdx < threads.size(); threadNdx++)
+		threads[threadNdx]->join();
+
+	// Tiles are independent, so re-running a failed tile reproduces the original exception on this thread.
+	for (int tileNdx = 0; tileNdx < m_numTiles; tileNdx++)
+	{
+		if (m_tileFailed[tileNdx])
+			compareTile(tileNdx);
+	}
+}
+
+inline void getRowCoords (int row, int height, int& y, int& z)
+{
+	y = row % height;
+	z = row / height;
+}
+
+class FloatThresholdCompareTask : public CompareTileTask
+{
+public:
+	//! Compare result against reference image, or against referenceColor if reference is null.
+	FloatThresholdCompareTask (const ConstPixelBufferAccess* reference, const Vec4& referenceColor, const ConstPixelBufferAccess& result, const Vec4& threshold, const PixelBufferAccess& errorMask, CompareExecMode execMode)
+		: CompareTileTask	(result.getWidth(), result.getHeight()*result.getDepth(), execMode)
+		, m_reference		(reference)
+		, m_referenceColor	(referenceColor)
+		, m_result			(result)
+		, m_threshold		(threshold)
+		, m_errorMask		(errorMask)
+		, m_useRowKernel	(isFloatRowFormat(result) && (!reference || isFloatRowFormat(*reference)))
+		, m_tileMaxDiff		((size_t)getNumTiles())
+	{
+	}
+
+	Vec4 getMaxDiff (void) const
+	{
+		Vec4 maxDiff = m_tileMaxDiff.empty() ? Vec4(0.0f) : m_tileMaxDiff[0];
+
+		for (size_t tileNdx = 1; tileNdx < m_tileMaxDiff.size(); tileNdx++)
+			maxDiff = max(maxDiff, m_tileMaxDiff[tileNdx]);
+
+		return maxDiff;
+	}
+
+protected:
+	void compareRows (int tileNdx, int beginRow, int endRow)
+	{
+		const int			width		= m_result.getWidth();
+		Vec4				maxDiff		(0.0f, 0.0f, 0.0f, 0.0f);
+		std::vector<float>	refRow;
+		std::vector<float>	cmpRow;
+
+		for (int row = beginRow; row < endRow; row++)
+		{
+			int y, z;
+			getRowCoords(row, m_result.getHeight(), y, z);
+
+			if (m_useRowKernel)
+			{
+				const float* const refPtr = m_reference ? getFloatRow(*m_reference, y, z, refRow) : m_referenceColor.getPtr();
+
+				compareFloatRow(refPtr, m_reference ? 4 : 0, getFloatRow(m_result, y, z, cmpRow), width, m_threshold, getErrorMaskRow(m_errorMask, y, z), maxDiff);
+				continue;
+			}
+
+			for (int x = 0; x < width; x++)
+			{
+				const Vec4	refPix		= m_reference ? m_reference->getPixel(x, y, z) : m_referenceColor;
+				const Vec4	cmpPix		= m_result.getPixel(x, y, z);
+				const Vec4	diff		= abs(refPix - cmpPix);
+				const bool	isOk		= boolAll(lessThanEqual(diff, m_threshold));
+
+				maxDiff = max(maxDiff, diff);
+
+				m_errorMask.setPixel(isOk ? Vec4(0.0f, 1.0f, 0.0f, 1.0f) : Vec4(1.0f, 0.0f, 0.0f, 1.0f), x, y, z);
+			}
+		}
+
+		m_tileMaxDiff[tileNdx] = maxDiff;
+	}
+
+private:
+	const ConstPixelBufferAccess* const	m_reference;
+	const Vec4							m_referenceColor;
+	const ConstPixelBufferAccess		m_result;
+	const Vec4							m_threshold;
+	const PixelBufferAccess				m_errorMask;
+	const bool							m_useRowKernel;
+	std::vector<Vec4>					m_tileMaxDiff;
+};
+
+class IntThresholdCompareTask : public CompareTileTask
+{
+public:
+	IntThresholdCompareTask (const ConstPixelBufferAccess& reference, const ConstPixelBufferAccess& result, const UVec4& threshold, bool use64Bits, const PixelBufferAccess& errorMask, CompareExecMode execMode)
+		: CompareTileTask	(reference.getWidth(), reference.getHeight()*reference.getDepth(), execMode)
+		, m_reference		(reference)
+		, m_result			(result)
+		, m_threshold		(threshold)
+		, m_use64Bits		(use64Bits)
+		, m_errorMask		(errorMask)
+		, m_useRowKernel	(isIntRowFormat(reference, result))
+		, m_tileMaxDiff		((size_t)getNumTiles(), U64Vec4(0u))
+	{
+	}
+
+	U64Vec4 getMaxDiff (void) const
+	{
+		U64Vec4 maxDiff (0u, 0u, 0u, 0u);
+
+		for (size_t tileNdx = 0; tileNdx < m_tileMaxDiff.size(); tileNdx++)
+			maxDiff = max(maxDiff, m_tileMaxDiff[tileNdx]);
+
+		return maxDiff;
+	}
+
+protected:
+	void compareRows (int tileNdx, int beginRow, int endRow)
+	{
+		const int		width			= m_reference.getWidth();
+		const U64Vec4	threshold64		= m_threshold.cast<deUint64>();
+		U64Vec4			maxDiff			(0u, 0u, 0u, 0u);
+		deUint8			maxDiff8[4]		= { 0u, 0u, 0u, 0u };
+
+		for (int row = beginRow; row < endRow; row++)
+		{
+			int y, z;
+			getRowCoords(row, m_reference.getHeight(), y, z);
+
+			if (m_useRowKernel && m_reference.getFormat().order == TextureFormat::RGBA)
 			{
-				const IVec4	refPix = reference.getPixelInt(x, y, z);
-				const IVec4	cmpPix = result.getPixelInt(x, y, z);
+				compareRGBA8Row((const deUint8*)m_reference.getPixelPtr(0, y, z), (const deUint8*)m_result.getPixelPtr(0, y, z), width, m_threshold, getErrorMaskRow(m_errorMask, y, z), maxDiff8);
+				continue;
+			}
+
+			if (m_useRowKernel)
+			{
+				compareR32UIRow((const deUint32*)m_reference.getPixelPtr(0, y, z), (const deUint32*)m_result.getPixelPtr(0, y, z), width, threshold64.x(), m_use64Bits, getErrorMaskRow(m_errorMask, y, z), maxDiff.x());
+				continue;
+			}
+
+			for (int x = 0; x < width; x++)
+			{
+				U64Vec4 diff;
+
+				if (m_use64Bits)
+				{
+					I64Vec4	refPix	= m_reference.getPixelInt64(x, y, z);
+					I64Vec4	cmpPix	= m_result.getPixelInt64(x, y, z);
+					diff			= abs(refPix - cmpPix).cast<deUint64>();
+				}
+				else
+				{
+					IVec4	refPix	= m_reference.getPixelInt(x, y, z);
+					IVec4	cmpPix	= m_result.getPixelInt(x, y, z);
+					diff			= abs(refPix - cmpPix).cast<deUint64>();
+				}
+
+				maxDiff = max(maxDiff, diff);
+
+				const bool isOk = boolAll(lessThanEqual(diff, threshold64));
+				m_errorMask.setPixel(isOk ? IVec4(0, 0xff, 0, 0xff) : IVec4(0xff, 0, 0, 0xff), x, y, z);
+			}
+		}
+
+		m_tileMaxDiff[tileNdx] = max(maxDiff, U64Vec4(maxDiff8[0], maxDiff8[1], maxDiff8[2], maxDiff8[3]));
+	}
+
+private:
+	const ConstPixelBufferAccess	m_reference;
+	const ConstPixelBufferAccess	m_result;
+	const UVec4						m_threshold;
+	const bool						m_use64Bits;
+	const PixelBufferAccess			m_errorMask;
+	const bool						m_useRowKernel;
+	std::vector<U64Vec4>			m_tileMaxDiff;
+};
+
+class DepthStencilThresholdCompareTask : public CompareTileTask
+{
+public:
+	DepthStencilThresholdCompareTask (const ConstPixelBufferAccess& reference, const ConstPixelBufferAccess& result, float threshold, const PixelBufferAccess& errorMask, CompareExecMode execMode)
+		: CompareTileTask	(reference.getWidth(), reference.getHeight()*reference.getDepth(), execMode)
+		, m_reference		(reference)
+		, m_result			(result)
+		, m_threshold		(threshold)
+		, m_errorMask		(errorMask)
+		, m_hasDepth		(tcu::hasDepthComponent(result.getFormat().order))
+		, m_hasStencil		(tcu::hasStencilComponent(result.getFormat().order))
+		, m_useRowKernel	(isDepthStencilRowFormat(reference, result))
+		, m_tileMaxDiff		((size_t)getNumTiles(), 0.0f)
+		, m_tileStencilOk	((size_t)getNumTiles(), 1)
+	{
+	}
+
+	float getMaxDiff (void) const
+	{
+		float maxDiff = m_tileMaxDiff.empty() ? 0.0f : m_tileMaxDiff[0];
+
+		for (size_t tileNdx = 1; tileNdx < m_tileMaxDiff.size(); tileNdx++)
+			maxDiff = (float)deMax(maxDiff, m_tileMaxDiff[tileNdx]);
+
+		return maxDiff;
+	}
+
+	bool isStencilOk (void) const
+	{
+		for (size_t tileNdx = 0; tileNdx < m_tileStencilOk.size(); tileNdx++)
+		{
+			if (!m_tileStencilOk[tileNdx])
+				return false;
+		}
+
+		return true;
+	}
+
+protected:
+	void compareRows (int tileNdx, int beginRow, int endRow)
+	{
+		const int	width			= m_reference.getWidth();
+		float		maxDiff			= 0.0f;
+		bool		allStencilOk	= true;
+
+		for (int row = beginRow; row < endRow; row++)
+		{
+			int y, z;
+			getRowCoords(row, m_reference.getHeight(), y, z);
+
+			if (m_useRowKernel)
+			{
+				compareD24S8Row((const deUint32*)m_reference.getPixelPtr(0, y, z), (const deUint32*)m_result.getPixelPtr(0, y, z), width, m_threshold, getErrorMaskRow(m_errorMask, y, z), maxDiff, allStencilOk);
+				continue;
+			}
+
+			for (int x = 0; x < width; x++)
+			{
+				bool	isOk = true;
+
+				if (m_hasDepth)
+				{
+					float refDepth	= m_reference.getPixDepth(x, y, z);
+					float cmpDepth	= m_result.getPixDepth(x, y, z);
+					float diff		= de::abs(refDepth - cmpDepth);
+
+					isOk = diff <= m_threshold;
+					maxDiff = (float) deMax(maxDiff, diff);
+				}
+
+				if (m_hasStencil)
+				{
+					deUint8 refStencil = (deUint8) m_reference.getPixStencil(x, y, z);
+					deUint8 cmpStencil = (deUint8) m_result.getPixStencil(x, y, z);
+
+					bool isStencilOk = (refStencil == cmpStencil);
+					allStencilOk = allStencilOk && isStencilOk;
+					isOk = isOk && isStencilOk;
+				}
+
+				m_errorMask.setPixel(isOk ? IVec4(0, 0xff, 0, 0xff) : IVec4(0xff, 0, 0, 0xff), x, y, z);
+			}
+		}
+
+		m_tileMaxDiff[tileNdx]		= maxDiff;
+		m_tileStencilOk[tileNdx]	= allStencilOk ? 1 : 0;
+	}
+
+private:
+	const ConstPixelBufferAccess	m_reference;
+	const ConstPixelBufferAccess	m_result;
+	const float						m_threshold;
+	const PixelBufferAccess			m_errorMask;
+	const bool						m_hasDepth;
+	const bool						m_hasStencil;
+	const bool						m_useRowKernel;
+	std::vector<float>				m_tileMaxDiff;
+	std::vector<deUint8>			m_tileStencilOk;
+};
+
+class PositionDeviationCompareTask : public CompareTileTask
+{
+public:
+	PositionDeviationCompareTask (const PixelBufferAccess& errorMask, const ConstPixelBufferAccess& reference, const ConstPixelBufferAccess& result, const UVec4& threshold, const tcu::IVec3& maxPositionDeviation, const IVec3& begin, const IVec3& end, CompareExecMode execMode)
+		: CompareTileTask			(end.x() - begin.x(), de::max(end.y() - begin.y(), 0) * de::max(end.z() - begin.z(), 0), execMode)
+		, m_errorMask				(errorMask)
+		, m_reference				(reference)
+		, m_result					(result)
+		, m_threshold				(threshold)
+		, m_maxPositionDeviation	(maxPositionDeviation)
+		, m_begin					(begin)
+		, m_end						(end)
+		, m_tileNumFailingPixels	((size_t)getNumTiles(), 0)
+	{
+	}
+
+	int getNumFailingPixels (void) const
+	{
+		int numFailingPixels = 0;
+
+		for (size_t tileNdx = 0; tileNdx < m_tileNumFailingPixels.size(); tileNdx++)
+			numFailingPixels += m_tileNumFailingPixels[tileNdx];
+
+		return numFailingPixels;
+	}
+
+protected:
+	void compareRows (int tileNdx, int beginRow, int endRow)
+	{
+		const tcu::IVec4	errorColor			(255, 0, 0, 255);
+		const int			width				= m_reference.getWidth();
+		const int			height				= m_reference.getHeight();
+		const int			depth				= m_reference.getDepth();
+		int					numFailingPixels	= 0;
+
+		for (int row = beginRow; row < endRow; row++)
+		{
+			const int y = m_begin.y() + row % (m_end.y() - m_begin.y());
+			const int z = m_begin.z() + row / (m_end.y() - m_begin.y());
+
+			for (int x = m_begin.x(); x < m_end.x(); x++)
+			{
+				const IVec4	refPix = m_reference.getPixelInt(x, y, z);
+				const IVec4	cmpPix = m_result.getPixelInt(x, y, z);
 
 				// Exact match
 				{
 					const UVec4	diff = abs(refPix - cmpPix).cast<deUint32>();
-					const bool	isOk = boolAll(lessThanEqual(diff, threshold));
+					const bool	isOk = boolAll(lessThanEqual(diff, m_threshold));
 
 					if (isOk)
 						continue;
@@ -135,20 +859,20 @@ static int findNumPositionDeviationFailingPixels (const PixelBufferAccess& error
 
 					// Find deviated result pixel for reference
 
-					for (int sz = de::max(0, z - maxPositionDeviation.z()); sz <= de::min(depth  - 1, z + maxPositionDeviation.z()) && !pixelFoundForReference; ++sz)
-					for (int sy = de::max(0, y - maxPositionDeviation.y()); sy <= de::min(height - 1, y + maxPositionDeviation.y()) && !pixelFoundForReference; ++sy)
-					for (int sx = de::max(0, x - maxPositionDeviation.x()); sx <= de::min(width  - 1, x + maxPositionDeviation.x()) && !pixelFoundForReference; ++sx)
+					for (int sz = de::max(0, z - m_maxPositionDeviation.z()); sz <= de::min(depth  - 1, z + m_maxPositionDeviation.z()) && !pixelFoundForReference; ++sz)
+					for (int sy = de::max(0, y - m_maxPositionDeviation.y()); sy <= de::min(height - 1, y + m_maxPositionDeviation.y()) && !pixelFoundForReference; ++sy)
+					for (int sx = de::max(0, x - m_maxPositionDeviation.x()); sx <= de::min(width  - 1, x + m_maxPositionDeviation.x()) && !pixelFoundForReference; ++sx)
 					{
-						const IVec4	deviatedCmpPix	= result.getPixelInt(sx, sy, sz);
+						const IVec4	deviatedCmpPix	= m_result.getPixelInt(sx, sy, sz);
 						const UVec4	diff			= abs(refPix - deviatedCmpPix).cast<deUint32>();
-						const bool	isOk			= boolAll(lessThanEqual(diff, threshold));
+						const bool	isOk			= boolAll(lessThanEqual(diff, m_threshold));
 
 						pixelFoundForReference		= isOk;
 					}
 
 					if (!pixelFoundForReference)
 					{
-						errorMask.setPixel(errorColor, x, y, z);
+						m_errorMask.setPixel(errorColor, x, y, z);
 						++numFailingPixels;
 						continue;
 					}
@@ -158,33 +882,164 @@ static int findNumPositionDeviationFailingPixels (const PixelBufferAccess& error
 
 					// Find deviated reference pixel for result
 
-					for (int sz = de::max(0, z - maxPositionDeviation.z()); sz <= de::min(depth  - 1, z + maxPositionDeviation.z()) && !pixelFoundForResult; ++sz)
-					for (int sy = de::max(0, y - maxPositionDeviation.y()); sy <= de::min(height - 1, y + maxPositionDeviation.y()) && !pixelFoundForResult; ++sy)
-					for (int sx = de::max(0, x - maxPositionDeviation.x()); sx <= de::min(width  - 1, x + maxPositionDeviation.x()) && !pixelFoundForResult; ++sx)
+					for (int sz = de::max(0, z - m_maxPositionDeviation.z()); sz <= de::min(depth  - 1, z + m_maxPositionDeviation.z()) && !pixelFoundForResult; ++sz)
+					for (int sy = de::max(0, y - m_maxPositionDeviation.y()); sy <= de::min(height - 1, y + m_maxPositionDeviation.y()) && !pixelFoundForResult; ++sy)
+					for (int sx = de::max(0, x - m_maxPositionDeviation.x()); sx <= de::min(width  - 1, x + m_maxPositionDeviation.x()) && !pixelFoundForResult; ++sx)
 					{
-						const IVec4	deviatedRefPix	= reference.getPixelInt(sx, sy, sz);
+						const IVec4	deviatedRefPix	= m_reference.getPixelInt(sx, sy, sz);
 						const UVec4	diff			= abs(cmpPix - deviatedRefPix).cast<deUint32>();
-						const bool	isOk			= boolAll(lessThanEqual(diff, threshold));
+						const bool	isOk			= boolAll(lessThanEqual(diff, m_threshold));
 
 						pixelFoundForResult			= isOk;
 					}
 
 					if (!pixelFoundForResult)
 					{
-						errorMask.setPixel(errorColor, x, y, z);
+						m_errorMask.setPixel(errorColor, x, y, z);
 						++numFailingPixels;
 						continue;
 					}
 				}
 			}
 		}
+
+		m_tileNumFailingPixels[tileNdx] = numFailingPixels;
 	}
 
-	return numFailingPixels;
+private:
+	const PixelBufferAccess			m_errorMask;
+	const ConstPixelBufferAccess	m_reference;
+	const ConstPixelBufferAccess	m_result;
+	const UVec4						m_threshold;
+	const IVec3						m_maxPositionDeviation;
+	const IVec3						m_begin;
+	const IVec3						m_end;
+	std::vector<int>				m_tileNumFailingPixels;
+};
+
+int findNumPositionDeviationFailingPixels (const PixelBufferAccess& errorMask, const ConstPixelBufferAccess& reference, const ConstPixelBufferAccess& result, const UVec4& threshold, const tcu::IVec3& maxPositionDeviation, bool acceptOutOfBoundsAsAnyValue, CompareExecMode execMode)
+{
+	const tcu::IVec4	okColor				(0, 255, 0, 255);
+	const int			width				= reference.getWidth();
+	const int			height				= reference.getHeight();
+	const int			depth				= reference.getDepth();
+
+	// Accept pixels "sampling" over the image bounds pixels since "taps" could be anything
+	const int			beginX				= (acceptOutOfBoundsAsAnyValue) ? (maxPositionDeviation.x()) : (0);
+	const int			beginY				= (acceptOutOfBoundsAsAnyValue) ? (maxPositionDeviation.y()) : (0);
+	const int			beginZ				= (acceptOutOfBoundsAsAnyValue) ? (maxPositionDeviation.z()) : (0);
+	const int			endX				= (acceptOutOfBoundsAsAnyValue) ? (width  - maxPositionDeviation.x()) : (width);
+	const int			endY				= (acceptOutOfBoundsAsAnyValue) ? (height - maxPositionDeviation.y()) : (height);
+	const int			endZ				= (acceptOutOfBoundsAsAnyValue) ? (depth  - maxPositionDeviation.z()) : (depth);
+
+	TCU_CHECK_INTERNAL(result.getWidth() == width && result.getHeight() == height && result.getDepth() == depth);
+	DE_ASSERT(endX > 0 && endY > 0 && endZ > 0);	// most likely a bug
+
+	tcu::clear(errorMask, okColor);
+
+	{
+		PositionDeviationCompareTask task (errorMask, reference, result, threshold, maxPositionDeviation, IVec3(beginX, beginY, beginZ), IVec3(endX, endY, endZ), execMode);
+
+		task.execute();
+
+		return task.getNumFailingPixels();
+	}
 }
 
 } // anonymous
 
+/*--------------------------------------------------------------------*//*!
+ * \brief Per-pixel threshold-based comparison without logging
+ *
+ * Computes the error mask and maximum difference as floatThresholdCompare()
+ * does. Results are identical in serial and parallel execution modes.
+ *
+ * \param reference		Reference image
+ * \param result		Result image
+ * \param threshold		Maximum allowed difference
+ * \param errorMask		RGB UNORM_INT8 image of the same size for error mask
+ * \param execMode		Serial or parallel execution
+ * \return Maximum difference per channel
+ *//*--------------------------------------------------------------------*/
+Vec4 computeFloatThresholdErrorMask (const ConstPixelBufferAccess& reference, const ConstPixelBufferAccess& result, const Vec4& threshold, const PixelBufferAccess& errorMask, CompareExecMode execMode)
+{
+	FloatThresholdCompareTask task (&reference, Vec4(0.0f), result, threshold, errorMask, execMode);
+
+	task.execute();
+
+	return task.getMaxDiff();
+}
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Per-pixel integer threshold-based comparison without logging
+ *
+ * Computes the error mask and maximum difference as intThresholdCompare()
+ * does. Results are identical in serial and parallel execution modes.
+ *
+ * \param reference		Reference image
+ * \param result		Result image
+ * \param threshold		Maximum allowed difference
+ * \param use64Bits		Use 64-bit components
+ * \param errorMask		RGB UNORM_INT8 image of the same size for error mask
+ * \param execMode		Serial or parallel execution
+ * \return Maximum difference per channel
+ *//*--------------------------------------------------------------------*/
+U64Vec4 computeIntThresholdErrorMask (const ConstPixelBufferAccess& reference, const ConstPixelBufferAccess& result, const UVec4& threshold, bool use64Bits, const PixelBufferAccess& errorMask, CompareExecMode execMode)
+{
+	IntThresholdCompareTask task (reference, result, threshold, use64Bits, errorMask, execMode);
+
+	task.execute();
+
+	return task.getMaxDiff();
+}
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Per-pixel depth-stencil threshold-based comparison without logging
+ *
+ * Computes the error mask and maximum depth difference as
+ * dsThresholdCompare() does. Results are identical in serial and parallel
+ * execution modes.
+ *
+ * \param reference		Reference image
+ * \param result		Result image
+ * \param threshold		Maximum allowed depth difference
+ * \param errorMask		RGB UNORM_INT8 image of the same size for error mask
+ * \param allStencilOk	Set to true if all stencil values match, false otherwise
+ * \param execMode		Serial or parallel execution
+ * \return Maximum depth difference
+ *//*--------------------------------------------------------------------*/
+float computeDepthStencilThresholdErrorMask (const ConstPixelBufferAccess& reference, const ConstPixelBufferAccess& result, float threshold, const PixelBufferAccess& errorMask, bool& allStencilOk, CompareExecMode execMode)
+{
+	DepthStencilThresholdCompareTask task (reference, result, threshold, errorMask, execMode);
+
+	task.execute();
+
+	allStencilOk = task.isStencilOk();
+
+	return task.getMaxDiff();
+}
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Position deviation comparison without logging
+ *
+ * Computes the error mask as intThresholdPositionDeviationCompare() does.
+ * Results are identical in serial and parallel execution modes.
+ *
+ * \param reference						Reference image
+ * \param result						Result image
+ * \param threshold						Maximum allowed difference
+ * \param maxPositionDeviation			Maximum allowed distance in the search
+ *										volume.
+ * \param acceptOutOfBoundsAsAnyValue	Accept any pixel in the boundary region
+ * \param errorMask						RGB UNORM_INT8 image of the same size for error mask
+ * \param execMode						Serial or parallel execution
+ * \return Number of failing pixels
+ *//*--------------------------------------------------------------------*/
+int computePositionDeviationErrorMask (const ConstPixelBufferAccess& reference, const ConstPixelBufferAccess& result, const UVec4& threshold, const tcu::IVec3& maxPositionDeviation, bool acceptOutOfBoundsAsAnyValue, const PixelBufferAccess& errorMask, CompareExecMode execMode)
+{
+	return findNumPositionDeviationFailingPixels(errorMask, reference, result, threshold, maxPositionDeviation, acceptOutOfBoundsAsAnyValue, execMode);
+}
+
 /*--------------------------------------------------------------------*//*!
  * \brief Fuzzy image comparison
  *
@@ -462,6 +1317,68 @@ static tcu::UVec4 computeFlushRelaxedULPDiff (const tcu::Vec4& a, const tcu::Vec
 					  computeFloatFlushRelaxedULPDiff(a.w(), b.w()));
 }
 
+namespace
+{
+
+class FloatUlpThresholdCompareTask : public CompareTileTask
+{
+public:
+	FloatUlpThresholdCompareTask (const ConstPixelBufferAccess& reference, const ConstPixelBufferAccess& result, const UVec4& threshold, const PixelBufferAccess& errorMask, CompareExecMode execMode)
+		: CompareTileTask	(reference.getWidth(), reference.getHeight()*reference.getDepth(), execMode)
+		, m_reference		(reference)
+		, m_result			(result)
+		, m_threshold		(threshold)
+		, m_errorMask		(errorMask)
+		, m_tileMaxDiff		((size_t)getNumTiles(), UVec4(0u))
+	{
+	}
+
+	UVec4 getMaxDiff (void) const
+	{
+		UVec4 maxDiff (0, 0, 0, 0);
+
+		for (size_t tileNdx = 0; tileNdx < m_tileMaxDiff.size(); tileNdx++)
+			maxDiff = max(maxDiff, m_tileMaxDiff[tileNdx]);
+
+		return maxDiff;
+	}
+
+protected:
+	void compareRows (int tileNdx, int beginRow, int endRow)
+	{
+		UVec4 maxDiff (0, 0, 0, 0);
+
+		for (int row = beginRow; row < endRow; row++)
+		{
+			int y, z;
+			getRowCoords(row, m_reference.getHeight(), y, z);
+
+			for (int x = 0; x < m_reference.getWidth(); x++)
+			{
+				const Vec4	refPix	= m_reference.getPixel(x, y, z);
+				const Vec4	cmpPix	= m_result.getPixel(x, y, z);
+				const UVec4	diff	= computeFlushRelaxedULPDiff(refPix, cmpPix);
+				const bool	isOk	= boolAll(lessThanEqual(diff, m_threshold));
+
+				maxDiff = max(maxDiff, diff);
+
+				m_errorMask.setPixel(isOk ? Vec4(0.0f, 1.0f, 0.0f, 1.0f) : Vec4(1.0f, 0.0f, 0.0f, 1.0f), x, y, z);
+			}
+		}
+
+		m_tileMaxDiff[tileNdx] = maxDiff;
+	}
+
+private:
+	const ConstPixelBufferAccess	m_reference;
+	const ConstPixelBufferAccess	m_result;
+	const UVec4						m_threshold;
+	const PixelBufferAccess			m_errorMask;
+	std::vector<UVec4>				m_tileMaxDiff;
+};
+
+} // anonymous
+
 /*--------------------------------------------------------------------*//*!
  * \brief Per-pixel threshold-based comparison
  *
@@ -483,9 +1400,10 @@ static tcu::UVec4 computeFlushRelaxedULPDiff (const tcu::Vec4& a, const tcu::Vec
  * \param result		Result image
  * \param threshold		Maximum allowed difference
  * \param logMode		Logging mode
+ * \param execMode		Serial or parallel execution
  * \return true if comparison passes, false otherwise
  *//*--------------------------------------------------------------------*/
-bool floatUlpThresholdCompare (TestLog& log, const char* imageSetName, const char* imageSetDesc, const ConstPixelBufferAccess& reference, const ConstPixelBufferAccess& result, const UVec4& threshold, CompareLogMode logMode)
+bool floatUlpThresholdCompare (TestLog& log, const char* imageSetName, const char* imageSetDesc, const ConstPixelBufferAccess& reference, const ConstPixelBufferAccess& result, const UVec4& threshold, CompareLogMode logMode, CompareExecMode execMode)
 {
 	int					width				= reference.getWidth();
 	int					height				= reference.getHeight();
@@ -498,22 +1416,11 @@ bool floatUlpThresholdCompare (TestLog& log, const char* imageSetName, const cha
 
 	TCU_CHECK(result.getWidth() == width && result.getHeight() == height && result.getDepth() == depth);
 
-	for (int z = 0; z < depth; z++)
 	{
-		for (int y = 0; y < height; y++)
-		{
-			for (int x = 0; x < width; x++)
-			{
-				const Vec4	refPix	= reference.getPixel(x, y, z);
-				const Vec4	cmpPix	= result.getPixel(x, y, z);
-				const UVec4	diff	= computeFlushRelaxedULPDiff(refPix, cmpPix);
-				const bool	isOk	= boolAll(lessThanEqual(diff, threshold));
+		FloatUlpThresholdCompareTask task (reference, result, threshold, errorMask, execMode);
 
-				maxDiff = max(maxDiff, diff);
-
-				errorMask.setPixel(isOk ? Vec4(0.0f, 1.0f, 0.0f, 1.0f) : Vec4(1.0f, 0.0f, 0.0f, 1.0f), x, y, z);
-			}
-		}
+		task.execute();
+		maxDiff = task.getMaxDiff();
 	}
 
 	bool compareOk = boolAll(lessThanEqual(maxDiff, threshold));
@@ -569,9 +1476,10 @@ bool floatUlpThresholdCompare (TestLog& log, const char* imageSetName, const cha
  * \param result		Result image
  * \param threshold		Maximum allowed difference
  * \param logMode		Logging mode
+ * \param execMode		Serial or parallel execution
  * \return true if comparison passes, false otherwise
  *//*--------------------------------------------------------------------*/
-bool floatThresholdCompare (TestLog& log, const char* imageSetName, const char* imageSetDesc, const ConstPixelBufferAccess& reference, const ConstPixelBufferAccess& result, const Vec4& threshold, CompareLogMode logMode)
+bool floatThresholdCompare (TestLog& log, const char* imageSetName, const char* imageSetDesc, const ConstPixelBufferAccess& reference, const ConstPixelBufferAccess& result, const Vec4& threshold, CompareLogMode logMode, CompareExecMode execMode)
 {
 	int					width				= reference.getWidth();
 	int					height				= reference.getHeight();
@@ -584,24 +1492,7 @@ bool floatThresholdCompare (TestLog& log, const char* imageSetName, const char*
 
 	TCU_CHECK_INTERNAL(result.getWidth() == width && result.getHeight() == height && result.getDepth() == depth);
 
-	for (int z = 0; z < depth; z++)
-	{
-		for (int y = 0; y < height; y++)
-		{
-			for (int x = 0; x < width; x++)
-			{
-				Vec4	refPix		= reference.getPixel(x, y, z);
-				Vec4	cmpPix		= result.getPixel(x, y, z);
-
-				Vec4	diff		= abs(refPix - cmpPix);
-				bool	isOk		= boolAll(lessThanEqual(diff, threshold));
-
-				maxDiff = max(maxDiff, diff);
-
-				errorMask.setPixel(isOk ? Vec4(0.0f, 1.0f, 0.0f, 1.0f) : Vec4(1.0f, 0.0f, 0.0f, 1.0f), x, y, z);
-			}
-		}
-	}
+	maxDiff = computeFloatThresholdErrorMask(reference, result, threshold, errorMask, execMode);
 
 	bool compareOk = boolAll(lessThanEqual(maxDiff, threshold));
 
@@ -656,9 +1547,10 @@ bool floatThresholdCompare (TestLog& log, const char* imageSetName, const char*
  * \param result		Result image
  * \param threshold		Maximum allowed difference
  * \param logMode		Logging mode
+ * \param execMode		Serial or parallel execution
  * \return true if comparison passes, false otherwise
  *//*--------------------------------------------------------------------*/
-bool floatThresholdCompare (TestLog& log, const char* imageSetName, const char* imageSetDesc, const Vec4& reference, const ConstPixelBufferAccess& result, const Vec4& threshold, CompareLogMode logMode)
+bool floatThresholdCompare (TestLog& log, const char* imageSetName, const char* imageSetDesc, const Vec4& reference, const ConstPixelBufferAccess& result, const Vec4& threshold, CompareLogMode logMode, CompareExecMode execMode)
 {
 	const int			width				= result.getWidth();
 	const int			height				= result.getHeight();
@@ -670,21 +1562,11 @@ bool floatThresholdCompare (TestLog& log, const char* imageSetName, const char*
 	Vec4				pixelBias			(0.0f, 0.0f, 0.0f, 0.0f);
 	Vec4				pixelScale			(1.0f, 1.0f, 1.0f, 1.0f);
 
-	for (int z = 0; z < depth; z++)
 	{
-		for (int y = 0; y < height; y++)
-		{
-			for (int x = 0; x < width; x++)
-			{
-				const Vec4	cmpPix		= result.getPixel(x, y, z);
-				const Vec4	diff		= abs(reference - cmpPix);
-				const bool	isOk		= boolAll(lessThanEqual(diff, threshold));
+		FloatThresholdCompareTask task (DE_NULL, reference, result, threshold, errorMask, execMode);
 
-				maxDiff = max(maxDiff, diff);
-
-				errorMask.setPixel(isOk ? Vec4(0.0f, 1.0f, 0.0f, 1.0f) : Vec4(1.0f, 0.0f, 0.0f, 1.0f), x, y, z);
-			}
-		}
+		task.execute();
+		maxDiff = task.getMaxDiff();
 	}
 
 	bool compareOk = boolAll(lessThanEqual(maxDiff, threshold));
@@ -739,9 +1621,10 @@ bool floatThresholdCompare (TestLog& log, const char* imageSetName, const char*
  * \param threshold		Maximum allowed difference
  * \param logMode		Logging mode
  * \param use64Bits		Use 64-bit components when reading image data.
+ * \param execMode		Serial or parallel execution
  * \return true if comparison passes, false otherwise
  *//*--------------------------------------------------------------------*/
-bool intThresholdCompare (TestLog& log, const char* imageSetName, const char* imageSetDesc, const ConstPixelBufferAccess& reference, const ConstPixelBufferAccess& result, const UVec4& threshold, CompareLogMode logMode, bool use64Bits)
+bool intThresholdCompare (TestLog& log, const char* imageSetName, const char* imageSetDesc, const ConstPixelBufferAccess& reference, const ConstPixelBufferAccess& result, const UVec4& threshold, CompareLogMode logMode, bool use64Bits, CompareExecMode execMode)
 {
 	int					width				= reference.getWidth();
 	int					height				= reference.getHeight();
@@ -749,39 +1632,13 @@ bool intThresholdCompare (TestLog& log, const char* imageSetName, const char* im
 	TextureLevel		errorMaskStorage	(TextureFormat(TextureFormat::RGB, TextureFormat::UNORM_INT8), width, height, depth);
 	PixelBufferAccess	errorMask			= errorMaskStorage.getAccess();
 	U64Vec4				maxDiff				(0u, 0u, 0u, 0u);
-	U64Vec4				diff				(0u, 0u, 0u, 0u);
 	const U64Vec4		threshold64			= threshold.cast<deUint64>();
 	Vec4				pixelBias			(0.0f, 0.0f, 0.0f, 0.0f);
 	Vec4				pixelScale			(1.0f, 1.0f, 1.0f, 1.0f);
 
 	TCU_CHECK_INTERNAL(result.getWidth() == width && result.getHeight() == height && result.getDepth() == depth);
 
-	for (int z = 0; z < depth; z++)
-	{
-		for (int y = 0; y < height; y++)
-		{
-			for (int x = 0; x < width; x++)
-			{
-				if (use64Bits)
-				{
-					I64Vec4	refPix	= reference.getPixelInt64(x, y, z);
-					I64Vec4	cmpPix	= result.getPixelInt64(x, y, z);
-					diff			= abs(refPix - cmpPix).cast<deUint64>();
-				}
-				else
-				{
-					IVec4	refPix	= reference.getPixelInt(x, y, z);
-					IVec4	cmpPix	= result.getPixelInt(x, y, z);
-					diff			= abs(refPix - cmpPix).cast<deUint64>();
-				}
-
-				maxDiff = max(maxDiff, diff);
-
-				const bool isOk = boolAll(lessThanEqual(diff, threshold64));
-				errorMask.setPixel(isOk ? IVec4(0, 0xff, 0, 0xff) : IVec4(0xff, 0, 0, 0xff), x, y, z);
-			}
-		}
-	}
+	maxDiff = computeIntThresholdErrorMask(reference, result, threshold, use64Bits, errorMask, execMode);
 
 	bool compareOk = boolAll(lessThanEqual(maxDiff, threshold64));
 
@@ -836,9 +1693,10 @@ bool intThresholdCompare (TestLog& log, const char* imageSetName, const char* im
  * \param result		Result image
  * \param threshold		Maximum allowed depth difference (stencil must be exact)
  * \param logMode		Logging mode
+ * \param execMode		Serial or parallel execution
  * \return true if comparison passes, false otherwise
  *//*--------------------------------------------------------------------*/
-bool dsThresholdCompare(TestLog& log, const char* imageSetName, const char* imageSetDesc, const ConstPixelBufferAccess& reference, const ConstPixelBufferAccess& result, const float threshold, CompareLogMode logMode)
+bool dsThresholdCompare(TestLog& log, const char* imageSetName, const char* imageSetDesc, const ConstPixelBufferAccess& reference, const ConstPixelBufferAccess& result, const float threshold, CompareLogMode logMode, CompareExecMode execMode)
 {
 	int					width = reference.getWidth();
 	int					height = reference.getHeight();
@@ -847,43 +1705,10 @@ bool dsThresholdCompare(TestLog& log, const char* imageSetName, const char* imag
 	PixelBufferAccess	errorMask = errorMaskStorage.getAccess();
 	float				maxDiff = 0.0;
 	bool				allStencilOk = true;
-	bool				hasDepth = tcu::hasDepthComponent(result.getFormat().order);
-	bool				hasStencil = tcu::hasStencilComponent(result.getFormat().order);
 
 	TCU_CHECK_INTERNAL(result.getWidth() == width && result.getHeight() == height && result.getDepth() == depth);
 
-	for (int z = 0; z < depth; z++)
-	{
-		for (int y = 0; y < height; y++)
-		{
-			for (int x = 0; x < width; x++)
-			{
-				bool	isOk = true;
-
-				if (hasDepth)
-				{
-					float refDepth	= reference.getPixDepth(x, y, z);
-					float cmpDepth	= result.getPixDepth(x, y, z);
-					float diff		= de::abs(refDepth - cmpDepth);
-
-					isOk = diff <= threshold;
-					maxDiff = (float) deMax(maxDiff, diff);
-				}
-
-				if (hasStencil)
-				{
-					deUint8 refStencil = (deUint8) reference.getPixStencil(x, y, z);
-					deUint8 cmpStencil = (deUint8) result.getPixStencil(x, y, z);
-
-					bool isStencilOk = (refStencil == cmpStencil);
-					allStencilOk = allStencilOk && isStencilOk;
-					isOk = isOk && isStencilOk;
-				}
-
-				errorMask.setPixel(isOk ? IVec4(0, 0xff, 0, 0xff) : IVec4(0xff, 0, 0, 0xff), x, y, z);
-			}
-		}
-	}
+	maxDiff = computeDepthStencilThresholdErrorMask(reference, result, threshold, errorMask, allStencilOk, execMode);
 
 	bool compareOk = (maxDiff <= threshold) && allStencilOk;
 
@@ -946,16 +1771,17 @@ bool dsThresholdCompare(TestLog& log, const char* imageSetName, const char* imag
  *										volume.
  * \param acceptOutOfBoundsAsAnyValue	Accept any pixel in the boundary region
  * \param logMode						Logging mode
+ * \param execMode						Serial or parallel execution
  * \return true if comparison passes, false otherwise
  *//*--------------------------------------------------------------------*/
-bool intThresholdPositionDeviationCompare (TestLog& log, const char* imageSetName, const char* imageSetDesc, const ConstPixelBufferAccess& reference, const ConstPixelBufferAccess& result, const UVec4& threshold, const tcu::IVec3& maxPositionDeviation, bool acceptOutOfBoundsAsAnyValue, CompareLogMode logMode)
+bool intThresholdPositionDeviationCompare (TestLog& log, const char* imageSetName, const char* imageSetDesc, const ConstPixelBufferAccess& reference, const ConstPixelBufferAccess& result, const UVec4& threshold, const tcu::IVec3& maxPositionDeviation, bool acceptOutOfBoundsAsAnyValue, CompareLogMode logMode, CompareExecMode execMode)
 {
 	const int			width				= reference.getWidth();
 	const int			height				= reference.getHeight();
 	const int			depth				= reference.getDepth();
 	TextureLevel		errorMaskStorage	(TextureFormat(TextureFormat::RGB, TextureFormat::UNORM_INT8), width, height, depth);
 	PixelBufferAccess	errorMask			= errorMaskStorage.getAccess();
-	const int			numFailingPixels	= findNumPositionDeviationFailingPixels(errorMask, reference, result, threshold, maxPositionDeviation, acceptOutOfBoundsAsAnyValue);
+	const int			numFailingPixels	= findNumPositionDeviationFailingPixels(errorMask, reference, result, threshold, maxPositionDeviation, acceptOutOfBoundsAsAnyValue, execMode);
 	const bool			compareOk			= numFailingPixels == 0;
 	Vec4				pixelBias			(0.0f, 0.0f, 0.0f, 0.0f);
 	Vec4				pixelScale			(1.0f, 1.0f, 1.0f, 1.0f);
@@ -1025,16 +1851,17 @@ bool intThresholdPositionDeviationCompare (TestLog& log, const char* imageSetNam
  * \param acceptOutOfBoundsAsAnyValue	Accept any pixel in the boundary region
  * \param maxAllowedFailingPixels		Maximum number of failing pixels
  * \param logMode						Logging mode
+ * \param execMode						Serial or parallel execution
  * \return true if comparison passes, false otherwise
  *//*--------------------------------------------------------------------*/
-bool intThresholdPositionDeviationErrorThresholdCompare (TestLog& log, const char* imageSetName, const char* imageSetDesc, const ConstPixelBufferAccess& reference, const ConstPixelBufferAccess& result, const UVec4& threshold, const tcu::IVec3& maxPositionDeviation, bool acceptOutOfBoundsAsAnyValue, int maxAllowedFailingPixels, CompareLogMode logMode)
+bool intThresholdPositionDeviationErrorThresholdCompare (TestLog& log, const char* imageSetName, const char* imageSetDesc, const ConstPixelBufferAccess& reference, const ConstPixelBufferAccess& result, const UVec4& threshold, const tcu::IVec3& maxPositionDeviation, bool acceptOutOfBoundsAsAnyValue, int maxAllowedFailingPixels, CompareLogMode logMode, CompareExecMode execMode)
 {
 	const int			width				= reference.getWidth();
 	const int			height				= reference.getHeight();
 	const int			depth				= reference.getDepth();
 	TextureLevel		errorMaskStorage	(TextureFormat(TextureFormat::RGB, TextureFormat::UNORM_INT8), width, height, depth);
 	PixelBufferAccess	errorMask			= errorMaskStorage.getAccess();
-	const int			numFailingPixels	= findNumPositionDeviationFailingPixels(errorMask, reference, result, threshold, maxPositionDeviation, acceptOutOfBoundsAsAnyValue);
+	const int			numFailingPixels	= findNumPositionDeviationFailingPixels(errorMask, reference, result, threshold, maxPositionDeviation, acceptOutOfBoundsAsAnyValue, execMode);
 	const bool			compareOk			= numFailingPixels <= maxAllowedFailingPixels;
 	Vec4				pixelBias			(0.0f, 0.0f, 0.0f, 0.0f);
 	Vec4				pixelScale			(1.0f, 1.0f, 1.0f, 1.0f);
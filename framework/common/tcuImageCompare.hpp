@@ -32,6 +32,7 @@ namespace tcu
 class RGBA;
 class Surface;
 class ConstPixelBufferAccess;
+class PixelBufferAccess;
 class TestLog;
 
 enum CompareLogMode
@@ -43,22 +44,36 @@ enum CompareLogMode
 	COMPARE_LOG_LAST
 };
 
+enum CompareExecMode
+{
+	COMPARE_EXEC_SERIAL	= 0,	//!< Compare on the calling thread.
+	COMPARE_EXEC_PARALLEL,		//!< Split image into tiles and compare them on all available cores. Results do not depend on number of cores.
+
+	COMPARE_EXEC_LAST
+};
+
 // Utilities for comparing and logging.
 bool	pixelThresholdCompare								(TestLog& log, const char* imageSetName, const char* imageSetDesc, const Surface& reference, const Surface& result, const RGBA& threshold, CompareLogMode logMode);
 bool	fuzzyCompare										(TestLog& log, const char* imageSetName, const char* imageSetDesc, const Surface& reference, const Surface& result, float threshold, CompareLogMode logMode);
 int		measurePixelDiffAccuracy							(TestLog& log, const char* imageSetName, const char* imageSetDesc, const Surface& reference, const Surface& result, int bestScoreDiff, int worstScoreDiff, CompareLogMode logMode);
 
 bool	fuzzyCompare										(TestLog& log, const char* imageSetName, const char* imageSetDesc, const ConstPixelBufferAccess& reference, const ConstPixelBufferAccess& result, float threshold, CompareLogMode logMode);
-bool	floatUlpThresholdCompare							(TestLog& log, const char* imageSetName, const char* imageSetDesc, const ConstPixelBufferAccess& reference, const ConstPixelBufferAccess& result, const UVec4& threshold, CompareLogMode logMode);
-bool	floatThresholdCompare								(TestLog& log, const char* imageSetName, const char* imageSetDesc, const ConstPixelBufferAccess& reference, const ConstPixelBufferAccess& result, const Vec4& threshold, CompareLogMode logMode);
-bool	floatThresholdCompare								(TestLog& log, const char* imageSetName, const char* imageSetDesc, const Vec4& reference, const ConstPixelBufferAccess& result, const Vec4& threshold, CompareLogMode logMode);
-bool	intThresholdCompare									(TestLog& log, const char* imageSetName, const char* imageSetDesc, const ConstPixelBufferAccess& reference, const ConstPixelBufferAccess& result, const UVec4& threshold, CompareLogMode logMode, bool use64Bits = false);
-bool	intThresholdPositionDeviationCompare				(TestLog& log, const char* imageSetName, const char* imageSetDesc, const ConstPixelBufferAccess& reference, const ConstPixelBufferAccess& result, const UVec4& threshold, const tcu::IVec3& maxPositionDeviation, bool acceptOutOfBoundsAsAnyValue, CompareLogMode logMode);
-bool	intThresholdPositionDeviationErrorThresholdCompare	(TestLog& log, const char* imageSetName, const char* imageSetDesc, const ConstPixelBufferAccess& reference, const ConstPixelBufferAccess& result, const UVec4& threshold, const tcu::IVec3& maxPositionDeviation, bool acceptOutOfBoundsAsAnyValue, int maxAllowedFailingPixels, CompareLogMode logMode);
-bool	dsThresholdCompare									(TestLog& log, const char* imageSetName, const char* imageSetDesc, const ConstPixelBufferAccess& reference, const ConstPixelBufferAccess& result, const float threshold, CompareLogMode logMode);
+bool	floatUlpThresholdCompare							(TestLog& log, const char* imageSetName, const char* imageSetDesc, const ConstPixelBufferAccess& reference, const ConstPixelBufferAccess& result, const UVec4& threshold, CompareLogMode logMode, CompareExecMode execMode = COMPARE_EXEC_SERIAL);
+bool	floatThresholdCompare								(TestLog& log, const char* imageSetName, const char* imageSetDesc, const ConstPixelBufferAccess& reference, const ConstPixelBufferAccess& result, const Vec4& threshold, CompareLogMode logMode, CompareExecMode execMode = COMPARE_EXEC_SERIAL);
+bool	floatThresholdCompare								(TestLog& log, const char* imageSetName, const char* imageSetDesc, const Vec4& reference, const ConstPixelBufferAccess& result, const Vec4& threshold, CompareLogMode logMode, CompareExecMode execMode = COMPARE_EXEC_SERIAL);
+bool	intThresholdCompare									(TestLog& log, const char* imageSetName, const char* imageSetDesc, const ConstPixelBufferAccess& reference, const ConstPixelBufferAccess& result, const UVec4& threshold, CompareLogMode logMode, bool use64Bits = false, CompareExecMode execMode = COMPARE_EXEC_SERIAL);
+bool	intThresholdPositionDeviationCompare				(TestLog& log, const char* imageSetName, const char* imageSetDesc, const ConstPixelBufferAccess& reference, const ConstPixelBufferAccess& result, const UVec4& threshold, const tcu::IVec3& maxPositionDeviation, bool acceptOutOfBoundsAsAnyValue, CompareLogMode logMode, CompareExecMode execMode = COMPARE_EXEC_SERIAL);
+bool	intThresholdPositionDeviationErrorThresholdCompare	(TestLog& log, const char* imageSetName, const char* imageSetDesc, const ConstPixelBufferAccess& reference, const ConstPixelBufferAccess& result, const UVec4& threshold, const tcu::IVec3& maxPositionDeviation, bool acceptOutOfBoundsAsAnyValue, int maxAllowedFailingPixels, CompareLogMode logMode, CompareExecMode execMode = COMPARE_EXEC_SERIAL);
+bool	dsThresholdCompare									(TestLog& log, const char* imageSetName, const char* imageSetDesc, const ConstPixelBufferAccess& reference, const ConstPixelBufferAccess& result, const float threshold, CompareLogMode logMode, CompareExecMode execMode = COMPARE_EXEC_SERIAL);
 int		measurePixelDiffAccuracy							(TestLog& log, const char* imageSetName, const char* imageSetDesc, const ConstPixelBufferAccess& reference, const ConstPixelBufferAccess& result, int bestScoreDiff, int worstScoreDiff, CompareLogMode logMode);
 bool	bilinearCompare										(TestLog& log, const char* imageSetName, const char* imageSetDesc, const ConstPixelBufferAccess& reference, const ConstPixelBufferAccess& result, const RGBA threshold, CompareLogMode logMode);
 
+// Comparisons without logging. Error mask must be a RGB UNORM_INT8 image of the same size as the compared images.
+Vec4	computeFloatThresholdErrorMask						(const ConstPixelBufferAccess& reference, const ConstPixelBufferAccess& result, const Vec4& threshold, const PixelBufferAccess& errorMask, CompareExecMode execMode = COMPARE_EXEC_SERIAL);
+U64Vec4	computeIntThresholdErrorMask						(const ConstPixelBufferAccess& reference, const ConstPixelBufferAccess& result, const UVec4& threshold, bool use64Bits, const PixelBufferAccess& errorMask, CompareExecMode execMode = COMPARE_EXEC_SERIAL);
+float	computeDepthStencilThresholdErrorMask				(const ConstPixelBufferAccess& reference, const ConstPixelBufferAccess& result, float threshold, const PixelBufferAccess& errorMask, bool& allStencilOk, CompareExecMode execMode = COMPARE_EXEC_SERIAL);
+int		computePositionDeviationErrorMask					(const ConstPixelBufferAccess& reference, const ConstPixelBufferAccess& result, const UVec4& threshold, const tcu::IVec3& maxPositionDeviation, bool acceptOutOfBoundsAsAnyValue, const PixelBufferAccess& errorMask, CompareExecMode execMode = COMPARE_EXEC_SERIAL);
+
 } // tcu
 
 #endif // _TCUIMAGECOMPARE_HPP
@@ -24,14 +24,164 @@
 #include "tcuInterval.hpp"
 
 #include "deMath.h"
+#include "deMemory.h"
 
 #include <cmath>
+#include <limits>
 
 namespace tcu
 {
 
 using std::ldexp;
 
+// Products and quotients with magnitude below 2^(-1022 + 2*53) may have
+// an inexact rounding error term
+static const double s_minExactErrorMagnitude = ldexp(1.0, -1022 + 2*53);
+
+//! Next representable value towards positive infinity. Faster than std::nextafter().
+static inline double nextUp (double x)
+{
+	if (deIsNaN(x) || x == std::numeric_limits<double>::infinity())
+		return x;
+	else if (x == 0.0)
+		return std::numeric_limits<double>::denorm_min();
+	else
+	{
+		deUint64 bits;
+
+		deMemcpy(&bits, &x, sizeof(bits));
+		bits = (x > 0.0) ? (bits + 1) : (bits - 1);
+		deMemcpy(&x, &bits, sizeof(bits));
+
+		return x;
+	}
+}
+
+//! Next representable value towards negative infinity.
+static inline double nextDown (double x)
+{
+	return -nextUp(-x);
+}
+
+//! Round round-to-nearest result r of an operation, whose exact result is
+//! r + err, in the given direction.
+static inline double roundDirected (double r, double err, bool upward)
+{
+	if (upward)
+		return (err > 0.0) ? nextUp(r) : r;
+	else
+		return (err < 0.0) ? nextDown(r) : r;
+}
+
+//! Widen inexact round-to-nearest result in the given direction.
+static inline double roundInexact (double r, bool upward)
+{
+	return upward ? nextUp(r) : nextDown(r);
+}
+
+//! Directed rounding of a result that overflowed to infinity in round-to-nearest mode.
+static inline double roundOverflow (double r, bool upward)
+{
+	const double maxValue = std::numeric_limits<double>::max();
+
+	if (r > 0.0)
+		return upward ? r : maxValue;
+	else
+		return upward ? -maxValue : r;
+}
+
+static inline bool isFinite (double x)
+{
+	return !deIsInf(x) && !deIsNaN(x);
+}
+
+double roundedAdd (double x, double y, bool upward)
+{
+	const double sum = x + y;
+
+	if (!isFinite(sum))
+		return (deIsInf(sum) && isFinite(x) && isFinite(y)) ? roundOverflow(sum, upward) : sum;
+
+	// Exact zero sum is -0 when rounding downwards, unless both operands are +0
+	if (sum == 0.0 && !upward && (std::signbit(x) || std::signbit(y) || x != 0.0))
+		return -0.0;
+
+	{
+		// TwoSum
+		const double yv = sum - x;
+		const double xv = sum - yv;
+		const double err = (x - xv) + (y - yv);
+
+		return roundDirected(sum, err, upward);
+	}
+}
+
+double roundedSub (double x, double y, bool upward)
+{
+	return roundedAdd(x, -y, upward);
+}
+
+double roundedMul (double x, double y, bool upward)
+{
+	const double prod = x * y;
+
+	if (!isFinite(prod))
+		return (deIsInf(prod) && isFinite(x) && isFinite(y)) ? roundOverflow(prod, upward) : prod;
+
+	if (x == 0.0 || y == 0.0)
+		return prod;
+
+	if (std::abs(prod) < s_minExactErrorMagnitude)
+		return roundInexact(prod, upward);
+
+	// TwoProd
+	return roundDirected(prod, std::fma(x, y, -prod), upward);
+}
+
+double roundedDiv (double x, double y, bool upward)
+{
+	const double quot = x / y;
+
+	if (!isFinite(quot))
+		return (deIsInf(quot) && isFinite(x) && isFinite(y) && y != 0.0) ? roundOverflow(quot, upward) : quot;
+
+	if (x == 0.0 || deIsInf(y))
+		return quot;
+
+	if (std::abs(quot) < s_minExactErrorMagnitude || std::abs(x) < s_minExactErrorMagnitude || std::abs(y) < s_minExactErrorMagnitude)
+		return roundInexact(quot, upward);
+
+	{
+		// Exact remainder x - quot*y has the sign of the error times the sign of y
+		const double rem = std::fma(-quot, y, x);
+
+		return roundDirected(quot, (y < 0.0) ? -rem : rem, upward);
+	}
+}
+
+Interval widenByUlps (const Interval& x, int numUlps)
+{
+	double	lo	= x.lo();
+	double	hi	= x.hi();
+
+	if (x.empty())
+		return x;
+
+	for (int ndx = 0; ndx < numUlps; ndx++)
+	{
+		lo = nextDown(lo);
+		hi = nextUp(hi);
+	}
+
+	return Interval(x.hasNaN(), lo, hi, x.warningLo(), x.warningHi());
+}
+
+#if TCU_INTERVAL_ROUNDING_MODE_FREE
+#	define SET_ROUNDED_INTERVAL(DST, X, OP, Y, ROUNDEDOP) ((DST) = Interval(ROUNDEDOP((X), (Y), false)) | Interval(ROUNDEDOP((X), (Y), true)))
+#else
+#	define SET_ROUNDED_INTERVAL(DST, X, OP, Y, ROUNDEDOP) TCU_SET_INTERVAL(DST, point, point = (X) OP (Y))
+#endif
+
 Interval applyMonotone (DoubleFunc1& func, const Interval& arg0)
 {
 	Interval ret;
@@ -67,7 +217,13 @@ Interval operator+ (const Interval& x, const Interval& y)
 	Interval ret;
 
 	if (!x.empty() && !y.empty())
+	{
+#if TCU_INTERVAL_ROUNDING_MODE_FREE
+		ret = Interval(roundedAdd(x.lo(), y.lo(), false)) | Interval(roundedAdd(x.hi(), y.hi(), true));
+#else
 		TCU_SET_INTERVAL_BOUNDS(ret, p, p = x.lo() + y.lo(), p = x.hi() + y.hi());
+#endif
+	}
 	if (x.hasNaN() || y.hasNaN())
 		ret |= TCU_NAN;
 
@@ -79,7 +235,7 @@ Interval operator- (const Interval& x, const Interval& y)
 	Interval ret;
 
 	TCU_INTERVAL_APPLY_MONOTONE2(ret, xp, x, yp, y, val,
-								 TCU_SET_INTERVAL(val, point, point = xp - yp));
+								 SET_ROUNDED_INTERVAL(val, xp, -, yp, roundedSub));
 	return ret;
 }
 
@@ -88,7 +244,7 @@ Interval operator* (const Interval& x, const Interval& y)
 	Interval ret;
 
 	TCU_INTERVAL_APPLY_MONOTONE2(ret, xp, x, yp, y, val,
-								 TCU_SET_INTERVAL(val, point, point = xp * yp));
+								 SET_ROUNDED_INTERVAL(val, xp, *, yp, roundedMul));
 	return ret;
 }
 
@@ -105,7 +261,7 @@ Interval operator/ (const Interval& nom, const Interval& den)
 		Interval ret;
 
 		TCU_INTERVAL_APPLY_MONOTONE2(ret, nomp, nom, denp, den, val,
-									 TCU_SET_INTERVAL(val, point, point = nomp / denp));
+									 SET_ROUNDED_INTERVAL(val, nomp, /, denp, roundedDiv));
 		return ret;
 	}
 }
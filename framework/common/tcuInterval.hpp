@@ -34,6 +34,14 @@
 #define TCU_INFINITY	(::std::numeric_limits<float>::infinity())
 #define TCU_NAN			(::std::numeric_limits<float>::quiet_NaN())
 
+// Interval bounds are rounded outwards by switching the FPU rounding mode,
+// unless TCU_INTERVAL_ROUNDING_MODE_FREE is set. In that case rounding mode
+// is never changed and directed rounding is derived from round-to-nearest
+// results using error-free transformations.
+#if !defined(TCU_INTERVAL_ROUNDING_MODE_FREE)
+#	define TCU_INTERVAL_ROUNDING_MODE_FREE 0
+#endif
+
 namespace tcu
 {
 
@@ -202,6 +210,11 @@ public:
 				 (m_lo == other.m_lo && m_hi == other.m_hi)));
 	}
 
+	bool		operator!=		(const Interval& other) const
+	{
+		return !(*this == other);
+	}
+
 private:
 	bool		m_hasNaN;
 	double		m_lo;
@@ -229,6 +242,53 @@ inline Interval& operator/=	(Interval& x,	const Interval& y) { return (x = x / y
 
 std::ostream&	operator<<	(std::ostream& os, const Interval& interval);
 
+// Operations rounded towards negative (upward == false) or positive
+// (upward == true) infinity without changing the rounding mode. Assumes
+// round-to-nearest mode. Results equal those computed in the directed
+// rounding mode, except when operands or result are near the subnormal
+// range, where they may be one ulp wider.
+double			roundedAdd	(double x, double y, bool upward);
+double			roundedSub	(double x, double y, bool upward);
+double			roundedMul	(double x, double y, bool upward);
+double			roundedDiv	(double x, double y, bool upward);
+
+// Widen a non-empty interval by numUlps ulps in both directions.
+Interval		widenByUlps	(const Interval& x, int numUlps);
+
+#if TCU_INTERVAL_ROUNDING_MODE_FREE
+
+// Bodies are evaluated in round-to-nearest mode and the result is widened
+// by NUMOPS ulps. This is conservative when the body is a chain of at most
+// NUMOPS operations that are each correctly rounded or accurate to within
+// one ulp, such as 1.0 / deSqrt(x) with NUMOPS == 2, and the operations
+// don't amplify the errors of their operands. Bodies with cancellation,
+// such as a - b * c, need the FPU rounding mode backend.
+#define TCU_SET_INTERVAL_BOUNDS_OPS(DST, VAR, NUMOPS, SETLOW, SETHIGH) do	\
+{																			\
+	::tcu::Interval&			VAR##_dst_	= (DST);						\
+	::tcu::Interval				VAR##_lo_;									\
+	::tcu::Interval				VAR##_hi_;									\
+																			\
+	{																		\
+		::tcu::Interval&	VAR = VAR##_lo_;								\
+		SETLOW;																\
+	}																		\
+	{																		\
+		::tcu::Interval&	VAR = VAR##_hi_;								\
+		SETHIGH;															\
+	}																		\
+																			\
+	VAR##_dst_ = ::tcu::widenByUlps(VAR##_lo_ | VAR##_hi_, (NUMOPS));		\
+} while (::deGetFalse())
+
+// Bodies must consist of one correctly rounded operation or a function
+// accurate to within one ulp. Use TCU_SET_INTERVAL_BOUNDS_OPS for longer
+// bodies.
+#define TCU_SET_INTERVAL_BOUNDS(DST, VAR, SETLOW, SETHIGH)		\
+	TCU_SET_INTERVAL_BOUNDS_OPS(DST, VAR, 1, SETLOW, SETHIGH)
+
+#else
+
 #define TCU_SET_INTERVAL_BOUNDS(DST, VAR, SETLOW, SETHIGH) do	\
 {																\
 	::tcu::ScopedRoundingMode	VAR##_ctx_;						\
@@ -250,9 +310,19 @@ std::ostream&	operator<<	(std::ostream& os, const Interval& interval);
 	VAR##_dst_ = VAR##_lo_ | VAR##_hi_;							\
 } while (::deGetFalse())
 
+// Bodies are evaluated with directed rounding, so operation count is not needed.
+#define TCU_SET_INTERVAL_BOUNDS_OPS(DST, VAR, NUMOPS, SETLOW, SETHIGH)	\
+	TCU_SET_INTERVAL_BOUNDS(DST, VAR, SETLOW, SETHIGH)
+
+#endif // TCU_INTERVAL_ROUNDING_MODE_FREE
+
 #define TCU_SET_INTERVAL(DST, VAR, BODY)						\
 	TCU_SET_INTERVAL_BOUNDS(DST, VAR, BODY, BODY)
 
+//! Like TCU_SET_INTERVAL, for bodies of NUMOPS rounded operations.
+#define TCU_SET_INTERVAL_OPS(DST, VAR, NUMOPS, BODY)			\
+	TCU_SET_INTERVAL_BOUNDS_OPS(DST, VAR, NUMOPS, BODY, BODY)
+
 //! Set the interval DST to the image of BODY on ARG, assuming that BODY on
 //! ARG is a monotone function. In practice, BODY is evaluated on both the
 //! upper and lower bound of ARG, and DST is set to the union of these
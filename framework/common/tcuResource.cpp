@@ -22,6 +22,7 @@
  *//*--------------------------------------------------------------------*/
 
 #include "tcuResource.hpp"
+#include "deMemory.h"
 
 #include <stdio.h>
 
@@ -45,6 +46,11 @@ Resource* DirArchive::getResource (const char* name) const
 	return static_cast<Resource*>(new FileResource((m_path + name).c_str()));
 }
 
+Resource* DirArchive::getMappedResource (const char* name) const
+{
+	return static_cast<Resource*>(new MappedFileResource((m_path + name).c_str()));
+}
+
 FileResource::FileResource (const char* filename)
 	: Resource(std::string(filename))
 {
@@ -83,6 +89,56 @@ void FileResource::setPosition (int position)
 	fseek(m_file, (size_t)position, SEEK_SET);
 }
 
+MappedFileResource::MappedFileResource (const char* filename)
+	: Resource		(std::string(filename))
+	, m_file		(deMappedFile_create(filename))
+	, m_position	(0)
+{
+	if (!m_file)
+		throw ResourceError("Failed to map file", filename, __FILE__, __LINE__);
+
+	if (deMappedFile_getSize(m_file) > (deInt64)0x7fffffff)
+	{
+		deMappedFile_destroy(m_file);
+		throw ResourceError("File too large", filename, __FILE__, __LINE__);
+	}
+}
+
+MappedFileResource::~MappedFileResource (void)
+{
+	deMappedFile_destroy(m_file);
+}
+
+void MappedFileResource::read (deUint8* dst, int numBytes)
+{
+	TCU_CHECK(numBytes >= 0 && numBytes <= getSize() - m_position);
+
+	if (numBytes > 0)
+		deMemcpy(dst, getData() + m_position, (size_t)numBytes);
+
+	m_position += numBytes;
+}
+
+int MappedFileResource::getSize (void) const
+{
+	return (int)deMappedFile_getSize(m_file);
+}
+
+int MappedFileResource::getPosition (void) const
+{
+	return m_position;
+}
+
+void MappedFileResource::setPosition (int position)
+{
+	m_position = de::clamp(position, 0, getSize());
+}
+
+const deUint8* MappedFileResource::getData (void) const
+{
+	return (const deUint8*)deMappedFile_getPtr(m_file);
+}
+
 ResourcePrefix::ResourcePrefix (const Archive& archive, const char* prefix)
 	: m_archive	(archive)
 	, m_prefix	(prefix)
@@ -94,4 +150,9 @@ Resource* ResourcePrefix::getResource (const char* name) const
 	return m_archive.getResource((m_prefix + name).c_str());
 }
 
+Resource* ResourcePrefix::getMappedResource (const char* name) const
+{
+	return m_archive.getMappedResource((m_prefix + name).c_str());
+}
+
 } // tcu
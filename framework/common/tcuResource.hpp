@@ -24,6 +24,7 @@
  *//*--------------------------------------------------------------------*/
 
 #include "tcuDefs.hpp"
+#include "deMappedFile.h"
 
 #include <string>
 
@@ -52,6 +53,9 @@ public:
 	virtual int			getPosition		(void) const = 0;
 	virtual void		setPosition		(int position) = 0;
 
+	//! Get pointer to whole resource contents, or DE_NULL if resource is not directly accessible in memory.
+	virtual const deUint8*	getData		(void) const { return DE_NULL; }
+
 	const std::string&	getName			(void) const { return m_name; }
 
 protected:
@@ -81,6 +85,18 @@ public:
 	 *//*--------------------------------------------------------------------*/
 	virtual Resource*	getResource		(const char* name) const = 0;
 
+	/*--------------------------------------------------------------------*//*!
+	 * \brief Open resource for direct memory access
+	 *
+	 * If supported by the archive, contents of the returned resource are
+	 * available with Resource::getData() without copying. Otherwise works
+	 * as getResource().
+	 *
+	 * \param name Resource path
+	 * \return Resource object
+	 *//*--------------------------------------------------------------------*/
+	virtual Resource*	getMappedResource	(const char* name) const { return getResource(name); }
+
 protected:
 						Archive			() {}
 };
@@ -95,6 +111,7 @@ public:
 						~DirArchive			(void);
 
 	Resource*			getResource			(const char* name) const;
+	Resource*			getMappedResource	(const char* name) const;
 
 	// \note Assignment and copy allowed
 						DirArchive			(const DirArchive& other) : Archive(), m_path(other.m_path) {}
@@ -123,6 +140,32 @@ private:
 	FILE*				m_file;
 };
 
+/*--------------------------------------------------------------------*//*!
+ * \brief Memory mapped file resource
+ *
+ * File is mapped read-only and shared, so processes that map the same
+ * file share the pages through the OS page cache.
+ *//*--------------------------------------------------------------------*/
+class MappedFileResource : public Resource
+{
+public:
+							MappedFileResource	(const char* filename);
+							~MappedFileResource	(void);
+
+	void					read				(deUint8* dst, int numBytes);
+	int						getSize				(void) const;
+	int						getPosition			(void) const;
+	void					setPosition			(int position);
+	const deUint8*			getData				(void) const;
+
+private:
+							MappedFileResource	(const MappedFileResource& other);
+	MappedFileResource&		operator=			(const MappedFileResource& other);
+
+	deMappedFile*			m_file;
+	int						m_position;
+};
+
 class ResourcePrefix : public Archive
 {
 public:
@@ -130,6 +173,7 @@ public:
 	virtual						~ResourcePrefix		(void) {}
 
 	virtual Resource*			getResource			(const char* name) const;
+	virtual Resource*			getMappedResource	(const char* name) const;
 
 private:
 	const Archive&				m_archive;
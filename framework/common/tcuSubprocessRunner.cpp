@@ -0,0 +1,868 @@
+/*-------------------------------------------------------------------------
+ * drawElements Quality Program Tester Core
+ * ----------------------------------------
+ *
+ * Copyright (c) 2020 The Khronos Group Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *//*!
+ * \file
+ * \brief Test session runner using child processes.
+ *//*--------------------------------------------------------------------*/
+
+#include "tcuSubprocessRunner.hpp"
+#include "tcuCommandLine.hpp"
+
+#include "qpInfo.h"
+
+#include "deProcess.hpp"
+#include "deThread.hpp"
+#include "deMutex.hpp"
+#include "deSharedPtr.hpp"
+#include "deStringUtil.hpp"
+#include "deFile.h"
+
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <set>
+#include <sstream>
+
+namespace tcu
+{
+
+using std::string;
+using std::vector;
+
+namespace
+{
+
+enum
+{
+	MAX_BATCH_SIZE		= 128,	//!< Upper limit for cases run by one child process
+	BATCH_SIZE_DIVISOR	= 8		//!< Batch takes 1/BATCH_SIZE_DIVISOR of the remaining range
+};
+
+struct OptionInfo
+{
+	const char*	name;			//!< Option name including leading dashes
+	bool		hasValue;		//!< Option takes a value that may be given as the next argument
+};
+
+// Options that are replaced by the runner in all child processes.
+static const OptionInfo s_runnerOptions[] =
+{
+	{ "--deqp-runmode",							true	},
+	{ "--deqp-log-filename",					true	},
+	{ "--deqp-log-format",						true	},
+	{ "--deqp-subprocess-count",				true	},
+	{ "--deqp-shadercache",						true	},
+	{ "--deqp-shadercache-filename",			true	},
+	{ "--deqp-shadercache-truncate",			true	},
+};
+
+// Case selection options, replaced by batch case list when running cases.
+static const OptionInfo s_selectionOptions[] =
+{
+	{ "-n",										true	},
+	{ "--deqp-case",							true	},
+	{ "--deqp-caselist",						true	},
+	{ "--deqp-caselist-file",					true	},
+	{ "--deqp-caselist-resource",				true	},
+	{ "--deqp-fraction",						true	},
+	{ "--deqp-fraction-mandatory-caselist-file",	true	},
+};
+
+static const OptionInfo* findOption (const char* arg, const OptionInfo* options, size_t numOptions)
+{
+	const char* const	nameEnd		= std::strchr(arg, '=');
+	const size_t		nameLen		= nameEnd ? (size_t)(nameEnd - arg) : std::strlen(arg);
+
+	for (size_t ndx = 0; ndx < numOptions; ndx++)
+	{
+		if (std::strlen(options[ndx].name) == nameLen && std::strncmp(arg, options[ndx].name, nameLen) == 0)
+			return &options[ndx];
+	}
+
+	return DE_NULL;
+}
+
+static vector<string> filterArgs (int argc, const char* const* argv, bool removeSelection)
+{
+	vector<string> args;
+
+	for (int argNdx = 1; argNdx < argc; argNdx++)
+	{
+		const char* const	arg		= argv[argNdx];
+		const OptionInfo*	option	= findOption(arg, s_runnerOptions, DE_LENGTH_OF_ARRAY(s_runnerOptions));
+
+		if (!option && removeSelection)
+			option = findOption(arg, s_selectionOptions, DE_LENGTH_OF_ARRAY(s_selectionOptions));
+
+		if (!option)
+			args.push_back(arg);
+		else if (option->hasValue && !std::strchr(arg, '='))
+			argNdx += 1; // Skip value
+	}
+
+	return args;
+}
+
+static string quoteArg (const string& arg)
+{
+	string quoted = "\"";
+
+#if (DE_OS == DE_OS_WIN32)
+	// CommandLineToArgvW() rules: backslashes are literal unless they precede a quote.
+	for (size_t ndx = 0; ndx < arg.size(); ndx++)
+	{
+		size_t numBackslashes = 0;
+
+		while (ndx < arg.size() && arg[ndx] == '\\')
+		{
+			numBackslashes	+= 1;
+			ndx				+= 1;
+		}
+
+		if (ndx == arg.size())
+		{
+			// Backslashes precede the closing quote
+			quoted.append(numBackslashes * 2, '\\');
+			break;
+		}
+		else if (arg[ndx] == '"')
+			quoted.append(numBackslashes * 2 + 1, '\\');
+		else
+			quoted.append(numBackslashes, '\\');
+
+		quoted += arg[ndx];
+	}
+#else
+	// deCommandLine_parse() treats every backslash within quotes as an escape.
+	for (size_t ndx = 0; ndx < arg.size(); ndx++)
+	{
+		if (arg[ndx] == '"' || arg[ndx] == '\\')
+			quoted += '\\';
+		quoted += arg[ndx];
+	}
+#endif
+
+	return quoted + "\"";
+}
+
+static string buildCommandLine (const string& executable, const vector<string>& args)
+{
+	string commandLine = quoteArg(executable);
+
+	for (size_t ndx = 0; ndx < args.size(); ndx++)
+		commandLine += " " + quoteArg(args[ndx]);
+
+	return commandLine;
+}
+
+static bool readFile (const string& filename, string& dst)
+{
+	std::ifstream		in		(filename.c_str(), std::ios_base::binary);
+	std::ostringstream	data;
+
+	if (!in.is_open())
+		return false;
+
+	data << in.rdbuf();
+	dst = data.str();
+	return true;
+}
+
+static bool beginsWith (const string& str, size_t pos, const char* prefix)
+{
+	return str.compare(pos, std::strlen(prefix), prefix) == 0;
+}
+
+//! Reads child process output until end of file and either forwards it line by line or stores it.
+class OutputReader : public de::Thread
+{
+public:
+	OutputReader (deFile* file, FILE* forwardTo, de::Mutex* forwardLock)
+		: m_file		(file)
+		, m_forwardTo	(forwardTo)
+		, m_forwardLock	(forwardLock)
+	{
+	}
+
+	void run (void)
+	{
+		deUint8	buf[4096];
+		deInt64	numRead	= 0;
+
+		while (deFile_read(m_file, buf, (deInt64)sizeof(buf), &numRead) == DE_FILERESULT_SUCCESS)
+		{
+			m_data.append((const char*)buf, (size_t)numRead);
+
+			if (m_forwardTo)
+				forward(false);
+		}
+
+		if (m_forwardTo)
+			forward(true);
+	}
+
+	const string& getData (void) const { return m_data; }
+
+private:
+	void forward (bool flushAll)
+	{
+		const size_t	end	= flushAll ? m_data.size() : m_data.rfind('\n') + 1;
+
+		if (end == 0)
+			return;
+
+		{
+			de::ScopedLock lock (*m_forwardLock);
+			std::fwrite(m_data.c_str(), 1, end, m_forwardTo);
+			std::fflush(m_forwardTo);
+		}
+
+		m_data.erase(0, end);
+	}
+
+	deFile* const		m_file;
+	FILE* const			m_forwardTo;
+	de::Mutex* const	m_forwardLock;
+	string				m_data;
+};
+
+//! Run child process to completion. Output is forwarded, or stdout is stored to capturedStdout if given.
+static int runChild (const string& commandLine, de::Mutex& outputLock, string* capturedStdout)
+{
+	de::Process	process;
+
+	process.start(commandLine.c_str(), DE_NULL);
+	process.closeStdIn();
+
+	{
+		OutputReader	stdoutReader	(process.getStdOut(), capturedStdout ? DE_NULL : stdout, &outputLock);
+		OutputReader	stderrReader	(process.getStdErr(), stderr, &outputLock);
+
+		stdoutReader.start();
+		stderrReader.start();
+
+		stdoutReader.join();
+		stderrReader.join();
+
+		if (capturedStdout)
+			*capturedStdout = stdoutReader.getData();
+	}
+
+	process.waitForFinish();
+	return process.getExitCode();
+}
+
+//! Per-slot case ranges with stealing from the largest range.
+class CaseQueue
+{
+public:
+	CaseQueue (size_t numCases, int numSlots)
+		: m_ranges		(numSlots)
+		, m_cancelled	(false)
+	{
+		for (int slotNdx = 0; slotNdx < numSlots; slotNdx++)
+		{
+			const size_t begin	= numCases * (size_t)slotNdx / (size_t)numSlots;
+			const size_t end	= numCases * (size_t)(slotNdx+1) / (size_t)numSlots;
+
+			for (size_t caseNdx = begin; caseNdx < end; caseNdx++)
+				m_ranges[slotNdx].push_back(caseNdx);
+		}
+	}
+
+	//! Take next batch for slot. Returns false when there is no work left.
+	bool takeBatch (int slotNdx, vector<size_t>& batch)
+	{
+		de::ScopedLock		lock	(m_lock);
+		std::deque<size_t>&	range	= m_ranges[slotNdx];
+
+		batch.clear();
+
+		if (m_cancelled)
+			return false;
+
+		if (range.empty())
+		{
+			size_t victimNdx = 0;
+
+			for (size_t ndx = 1; ndx < m_ranges.size(); ndx++)
+			{
+				if (m_ranges[ndx].size() > m_ranges[victimNdx].size())
+					victimNdx = ndx;
+			}
+
+			{
+				std::deque<size_t>&	victim		= m_ranges[victimNdx];
+				const size_t		numStolen	= (victim.size() + 1) / 2;
+
+				range.insert(range.end(), victim.end() - (std::ptrdiff_t)numStolen, victim.end());
+				victim.erase(victim.end() - (std::ptrdiff_t)numStolen, victim.end());
+			}
+
+			if (range.empty())
+				return false;
+		}
+
+		{
+			const size_t batchSize = de::clamp<size_t>(range.size() / BATCH_SIZE_DIVISOR, 1, MAX_BATCH_SIZE);
+
+			batch.insert(batch.end(), range.begin(), range.begin() + (std::ptrdiff_t)batchSize);
+			range.erase(range.begin(), range.begin() + (std::ptrdiff_t)batchSize);
+		}
+
+		return true;
+	}
+
+	//! Put cases back to the front of slot's range.
+	void returnCases (int slotNdx, const vector<size_t>& cases)
+	{
+		de::ScopedLock lock (m_lock);
+		m_ranges[slotNdx].insert(m_ranges[slotNdx].begin(), cases.begin(), cases.end());
+	}
+
+	void cancel (void)
+	{
+		de::ScopedLock lock (m_lock);
+		m_cancelled = true;
+	}
+
+	bool isCancelled (void)
+	{
+		de::ScopedLock lock (m_lock);
+		return m_cancelled;
+	}
+
+private:
+	de::Mutex						m_lock;
+	vector<std::deque<size_t> >		m_ranges;
+	bool							m_cancelled;
+};
+
+//! Contents of a child process log.
+struct ChildLog
+{
+	string				header;			//!< #sessionInfo lines
+	vector<string>		casePaths;		//!< Completed cases
+	vector<string>		caseResults;	//!< Result blocks of completed cases
+	string				openCasePath;	//!< Case in progress when log ended
+	string				openCaseResult;
+	bool				sessionEnded;
+
+	ChildLog (void) : sessionEnded(false) {}
+};
+
+static void parseChildLog (const string& text, ChildLog& dst)
+{
+	enum State
+	{
+		STATE_SESSION = 0,
+		STATE_CASE,
+		STATE_CASES_TIME
+	};
+
+	State	state		= STATE_SESSION;
+	size_t	blockStart	= 0;
+	size_t	lineStart	= 0;
+
+	while (lineStart < text.size())
+	{
+		const size_t	newline		= text.find('\n', lineStart);
+		const size_t	lineEnd		= newline != string::npos ? newline + 1 : text.size();
+
+		if (text[lineStart] == '#')
+		{
+			if (beginsWith(text, lineStart, "#beginSession"))
+				dst.header = text.substr(0, lineStart);
+			else if (beginsWith(text, lineStart, "#endSession"))
+				dst.sessionEnded = true;
+			else if (beginsWith(text, lineStart, "#beginTestCaseResult "))
+			{
+				const size_t pathStart = lineStart + std::strlen("#beginTestCaseResult ");
+
+				state			= STATE_CASE;
+				blockStart		= lineStart;
+				dst.openCasePath = text.substr(pathStart, (newline != string::npos ? newline : text.size()) - pathStart);
+			}
+			else if (state == STATE_CASE && (beginsWith(text, lineStart, "#endTestCaseResult") || beginsWith(text, lineStart, "#terminateTestCaseResult ")))
+			{
+				state = STATE_SESSION;
+				dst.casePaths.push_back(dst.openCasePath);
+				dst.caseResults.push_back("\n" + text.substr(blockStart, lineEnd - blockStart));
+				dst.openCasePath.clear();
+			}
+			else if (beginsWith(text, lineStart, "#beginTestsCasesTime"))
+				state = STATE_CASES_TIME; // Per-process timing information is not merged
+			else if (state == STATE_CASES_TIME && beginsWith(text, lineStart, "#endTestsCasesTime"))
+				state = STATE_SESSION;
+		}
+
+		lineStart = lineEnd;
+	}
+
+	if (state == STATE_CASE)
+	{
+		dst.openCaseResult = "\n" + text.substr(blockStart);
+
+		if (dst.openCaseResult[dst.openCaseResult.size()-1] != '\n')
+			dst.openCaseResult += "\n";
+	}
+	else
+		dst.openCasePath.clear();
+}
+
+static qpTestResult getCaseResult (const string& result)
+{
+	const size_t	terminatePos	= result.rfind("\n#terminateTestCaseResult ");
+	const size_t	statusPos		= result.rfind("StatusCode=\"");
+
+	if (terminatePos != string::npos)
+	{
+		const size_t	codeStart	= terminatePos + std::strlen("\n#terminateTestCaseResult ");
+		const size_t	codeEnd		= result.find_first_of("\r\n", codeStart);
+		const string	code		= result.substr(codeStart, codeEnd == string::npos ? string::npos : codeEnd - codeStart);
+
+		for (int resultNdx = 0; resultNdx < QP_TEST_RESULT_LAST; resultNdx++)
+		{
+			if (code == qpGetTestResultName((qpTestResult)resultNdx))
+				return (qpTestResult)resultNdx;
+		}
+
+		return QP_TEST_RESULT_CRASH;
+	}
+
+	if (statusPos != string::npos)
+	{
+		const size_t	codeStart	= statusPos + std::strlen("StatusCode=\"");
+		const size_t	codeEnd		= result.find('"', codeStart);
+		const string	code		= result.substr(codeStart, codeEnd - codeStart);
+
+		for (int resultNdx = 0; resultNdx < QP_TEST_RESULT_LAST; resultNdx++)
+		{
+			if (code == qpGetTestResultName((qpTestResult)resultNdx))
+				return (qpTestResult)resultNdx;
+		}
+	}
+
+	return QP_TEST_RESULT_INTERNAL_ERROR;
+}
+
+//! Writes merged log. Case results are written as they arrive, once the session header is known.
+class LogMerger
+{
+public:
+	LogMerger (const char* filename)
+		: m_file	(std::fopen(filename, "wb"))
+	{
+		if (!m_file)
+			throw ResourceError(string("Failed to open test log file '") + filename + "'");
+	}
+
+	~LogMerger (void)
+	{
+		std::fclose(m_file);
+	}
+
+	void addHeader (const string& header)
+	{
+		de::ScopedLock lock (m_lock);
+
+		if (m_header.empty() && !header.empty())
+		{
+			m_header = header;
+			write(m_header + "#beginSession\n");
+
+			for (size_t ndx = 0; ndx < m_pending.size(); ndx++)
+				write(m_pending[ndx]);
+			m_pending.clear();
+		}
+	}
+
+	void addCaseResult (const string& result)
+	{
+		const qpTestResult	testResult	= getCaseResult(result);
+		de::ScopedLock		lock		(m_lock);
+
+		if (m_header.empty())
+			m_pending.push_back(result);
+		else
+			write(result);
+
+		m_status.numExecuted += 1;
+		switch (testResult)
+		{
+			case QP_TEST_RESULT_PASS:					m_status.numPassed			+= 1;	break;
+			case QP_TEST_RESULT_NOT_SUPPORTED:			m_status.numNotSupported	+= 1;	break;
+			case QP_TEST_RESULT_QUALITY_WARNING:		m_status.numWarnings		+= 1;	break;
+			case QP_TEST_RESULT_COMPATIBILITY_WARNING:	m_status.numWarnings		+= 1;	break;
+			case QP_TEST_RESULT_WAIVER:					m_status.numWaived			+= 1;	break;
+			default:									m_status.numFailed			+= 1;	break;
+		}
+	}
+
+	//! Write end of session. Header is generated if no child process wrote one.
+	void finish (const string& defaultHeader)
+	{
+		addHeader(defaultHeader);
+		write("\n#endSession\n");
+	}
+
+	TestRunStatus getStatus (void)
+	{
+		de::ScopedLock lock (m_lock);
+		return m_status;
+	}
+
+private:
+	void write (const string& data)
+	{
+		if (std::fwrite(data.c_str(), 1, data.size(), m_file) != data.size() || std::fflush(m_file) != 0)
+			throw ResourceError("Writing to test log failed");
+	}
+
+	FILE* const			m_file;
+	de::Mutex			m_lock;
+	string				m_header;
+	vector<string>		m_pending;
+	TestRunStatus		m_status;
+};
+
+struct RunContext
+{
+	string					executable;
+	vector<string>			args;
+	string					filePrefix;
+	const vector<string>*	cases;
+	bool					useShaderCache;
+	string					shaderCacheFilename;
+	bool					truncateShaderCache;
+	bool					terminateOnFail;
+
+	CaseQueue*				queue;
+	LogMerger*				log;
+	de::Mutex				outputLock;
+};
+
+//! Runs batches for one slot, one child process per batch.
+class SlotRunner : public de::Thread
+{
+public:
+	SlotRunner (RunContext& context, int slotNdx)
+		: m_context		(context)
+		, m_slotNdx		(slotNdx)
+		, m_caseListFile(context.filePrefix + "." + de::toString(slotNdx) + ".caselist")
+		, m_logFile		(context.filePrefix + "." + de::toString(slotNdx) + ".qpa")
+		, m_isComplete	(true)
+	{
+	}
+
+	void run (void)
+	{
+		try
+		{
+			vector<size_t>	batch;
+			bool			isFirst	= true;
+
+			while (m_context.queue->takeBatch(m_slotNdx, batch))
+			{
+				runBatch(batch, isFirst);
+				isFirst = false;
+			}
+		}
+		catch (const std::exception& e)
+		{
+			m_error			= e.what();
+			m_isComplete	= false;
+			m_context.queue->cancel();
+		}
+
+		deDeleteFile(m_caseListFile.c_str());
+		deDeleteFile(m_logFile.c_str());
+	}
+
+	bool			isComplete	(void) const { return m_isComplete;	}
+	const string&	getError	(void) const { return m_error;		}
+
+private:
+	void runBatch (const vector<size_t>& batch, bool isFirst)
+	{
+		const vector<string>&	cases	= *m_context.cases;
+		vector<string>			args	= m_context.args;
+		ChildLog				childLog;
+
+		{
+			std::ofstream caseList (m_caseListFile.c_str(), std::ios_base::binary);
+
+			for (size_t ndx = 0; ndx < batch.size(); ndx++)
+				caseList << cases[batch[ndx]] << "\n";
+
+			if (!caseList.good())
+				throw ResourceError("Failed to write case list '" + m_caseListFile + "'");
+		}
+
+		args.push_back("--deqp-caselist-file=" + m_caseListFile);
+		args.push_back("--deqp-log-filename=" + m_logFile);
+
+		if (m_context.useShaderCache)
+		{
+			// Each child gets its own cache file so that children don't contend on the cache file lock.
+			args.push_back("--deqp-shadercache=enable");
+			args.push_back("--deqp-shadercache-filename=" + m_context.shaderCacheFilename + "." + de::toString(m_slotNdx));
+			args.push_back(string("--deqp-shadercache-truncate=") + (isFirst && m_context.truncateShaderCache ? "enable" : "disable"));
+		}
+		else
+			args.push_back("--deqp-shadercache=disable");
+
+		deDeleteFile(m_logFile.c_str());
+
+		{
+			const int	exitCode	= runChild(buildCommandLine(m_context.executable, args), m_context.outputLock, DE_NULL);
+			string		logText;
+
+			if (readFile(m_logFile, logText))
+				parseChildLog(logText, childLog);
+
+			m_context.log->addHeader(childLog.header);
+
+			for (size_t ndx = 0; ndx < childLog.caseResults.size(); ndx++)
+				m_context.log->addCaseResult(childLog.caseResults[ndx]);
+
+			finishBatch(batch, childLog, exitCode);
+		}
+	}
+
+	void finishBatch (const vector<size_t>& batch, const ChildLog& childLog, int exitCode)
+	{
+		const vector<string>&	cases		= *m_context.cases;
+		std::set<string>		completed	(childLog.casePaths.begin(), childLog.casePaths.end());
+		vector<size_t>			remaining;
+
+		for (size_t ndx = 0; ndx < batch.size(); ndx++)
+		{
+			if (completed.find(cases[batch[ndx]]) == completed.end())
+				remaining.push_back(batch[ndx]);
+		}
+
+		if (remaining.empty())
+			return;
+
+		if (!childLog.openCasePath.empty())
+		{
+			// Child died in the middle of a case.
+			m_context.log->addCaseResult(childLog.openCaseResult + "\n#terminateTestCaseResult Crash\n");
+			removeCase(remaining, childLog.openCasePath);
+			report("Child process terminated in '%s' (exit code %d)\n", childLog.openCasePath.c_str(), exitCode);
+		}
+		else if (!childLog.sessionEnded && completed.empty())
+		{
+			// Child died before starting any case. Blame the first one so that the run progresses.
+			const string& casePath = cases[remaining.front()];
+
+			m_context.log->addCaseResult("\n#beginTestCaseResult " + casePath + "\n\n#terminateTestCaseResult Crash\n");
+			remaining.erase(remaining.begin());
+			report("Child process terminated before '%s' (exit code %d)\n", casePath.c_str(), exitCode);
+		}
+		else if (childLog.sessionEnded && m_context.terminateOnFail && m_context.log->getStatus().numFailed > 0)
+		{
+			m_isComplete = false;
+			m_context.queue->cancel();
+			return;
+		}
+		else if (childLog.sessionEnded && completed.empty())
+		{
+			// Child ended session without running any case. Blame the first one and run rest in a new child.
+			const string& casePath = cases[remaining.front()];
+
+			m_context.log->addCaseResult("\n#beginTestCaseResult " + casePath + "\n\n#terminateTestCaseResult InternalError\n");
+			remaining.erase(remaining.begin());
+			report("Child process did not run '%s' (exit code %d)\n", casePath.c_str(), exitCode);
+		}
+
+		// Session aborted after a ResourceError or a crash between cases: run rest of the batch in a new child.
+		if (!remaining.empty())
+			m_context.queue->returnCases(m_slotNdx, remaining);
+	}
+
+	void report (const char* format, ...)
+	{
+		de::ScopedLock	lock	(m_context.outputLock);
+		va_list			args;
+
+		va_start(args, format);
+		std::vprintf(format, args);
+		va_end(args);
+		std::fflush(stdout);
+	}
+
+	void removeCase (vector<size_t>& remaining, const string& casePath) const
+	{
+		for (vector<size_t>::iterator iter = remaining.begin(); iter != remaining.end(); ++iter)
+		{
+			if ((*m_context.cases)[*iter] == casePath)
+			{
+				remaining.erase(iter);
+				break;
+			}
+		}
+	}
+
+	RunContext&			m_context;
+	const int			m_slotNdx;
+	const string		m_caseListFile;
+	const string		m_logFile;
+	bool				m_isComplete;
+	string				m_error;
+};
+
+} // anonymous
+
+SubprocessRunner::SubprocessRunner (const CommandLine& cmdLine, int argc, const char* const* argv)
+	: m_cmdLine		(cmdLine)
+	, m_executable	(argv[0])
+	, m_listArgs	(filterArgs(argc, argv, false))
+	, m_runArgs		(filterArgs(argc, argv, true))
+{
+	for (int argNdx = 1; argNdx < argc; argNdx++)
+	{
+		if (std::strcmp(argv[argNdx], "--deqp-stdin-caselist") == 0)
+			throw Exception("--deqp-stdin-caselist can not be used with --deqp-subprocess-count");
+	}
+}
+
+SubprocessRunner::~SubprocessRunner (void)
+{
+}
+
+void SubprocessRunner::run (void)
+{
+	const string		filePrefix		= m_cmdLine.getLogFileName();
+	const int			numSlots		= m_cmdLine.getSubprocessCount();
+	vector<string>		cases;
+	RunContext			context;
+
+	// Enumerate cases
+	{
+		const string		listLogFile	= filePrefix + ".list.qpa";
+		vector<string>		args		= m_listArgs;
+		string				output;
+		int					exitCode;
+
+		args.push_back("--deqp-runmode=stdout-caselist");
+		args.push_back("--deqp-log-filename=" + listLogFile);
+		args.push_back("--deqp-shadercache=disable");
+
+		exitCode = runChild(buildCommandLine(m_executable, args), context.outputLock, &output);
+		deDeleteFile(listLogFile.c_str());
+
+		if (exitCode != 0)
+			throw Exception("Failed to enumerate test cases in child process (exit code " + de::toString(exitCode) + ")");
+
+		{
+			std::istringstream	in		(output);
+			string				line;
+
+			while (std::getline(in, line))
+			{
+				if (!line.empty() && line[line.size()-1] == '\r')
+					line.erase(line.size()-1);
+
+				if (beginsWith(line, 0, "TEST: "))
+					cases.push_back(line.substr(std::strlen("TEST: ")));
+			}
+		}
+	}
+
+	print("Running %d test case(s) in %d child process(es)\n", (int)cases.size(), numSlots);
+
+	{
+		const int						numRunners	= de::clamp(numSlots, 1, de::max(1, (int)cases.size()));
+		CaseQueue						queue		(cases.size(), numRunners);
+		LogMerger						log			(m_cmdLine.getLogFileName());
+		vector<de::SharedPtr<SlotRunner> >	runners;
+		string							error;
+
+		context.executable			= m_executable;
+		context.args				= m_runArgs;
+		context.filePrefix			= filePrefix;
+		context.cases				= &cases;
+		context.useShaderCache		= m_cmdLine.isShadercacheEnabled();
+		context.shaderCacheFilename	= m_cmdLine.getShaderCacheFilename();
+		context.truncateShaderCache	= m_cmdLine.isShaderCacheTruncateEnabled();
+		context.terminateOnFail		= m_cmdLine.isTerminateOnFailEnabled();
+		context.queue				= &queue;
+		context.log					= &log;
+
+		for (int slotNdx = 0; slotNdx < numRunners; slotNdx++)
+		{
+			runners.push_back(de::SharedPtr<SlotRunner>(new SlotRunner(context, slotNdx)));
+			runners.back()->start();
+		}
+
+		m_status.isComplete = true;
+
+		for (size_t ndx = 0; ndx < runners.size(); ndx++)
+		{
+			runners[ndx]->join();
+
+			if (!runners[ndx]->isComplete())
+				m_status.isComplete = false;
+
+			if (error.empty())
+				error = runners[ndx]->getError();
+		}
+
+		{
+			std::ostringstream header;
+
+			header << "#sessionInfo releaseName " << qpGetReleaseName() << "\n"
+				   << "#sessionInfo releaseId 0x" << std::hex << qpGetReleaseId() << "\n"
+				   << "#sessionInfo targetName \"" << qpGetTargetName() << "\"\n"
+				   << "#sessionInfo commandLineParameters \"" << m_cmdLine.getInitialCmdLine() << "\"\n";
+
+			log.finish(header.str());
+		}
+
+		if (!error.empty())
+			throw Exception(error);
+
+		{
+			const bool	isComplete	= m_status.isComplete && !queue.isCancelled();
+
+			m_status			= log.getStatus();
+			m_status.isComplete	= isComplete;
+		}
+	}
+
+	{
+		const TestRunStatus& result = m_status;
+
+		print("\nDONE!\n");
+		print("\nTest run totals:\n");
+		print("  Passed:        %d/%d (%.1f%%)\n", result.numPassed,		result.numExecuted, (result.numExecuted > 0 ? (100.0f * (float)result.numPassed			/ (float)result.numExecuted) : 0.0f));
+		print("  Failed:        %d/%d (%.1f%%)\n", result.numFailed,		result.numExecuted, (result.numExecuted > 0 ? (100.0f * (float)result.numFailed			/ (float)result.numExecuted) : 0.0f));
+		print("  Not supported: %d/%d (%.1f%%)\n", result.numNotSupported,	result.numExecuted, (result.numExecuted > 0 ? (100.0f * (float)result.numNotSupported	/ (float)result.numExecuted) : 0.0f));
+		print("  Warnings:      %d/%d (%.1f%%)\n", result.numWarnings,		result.numExecuted, (result.numExecuted > 0 ? (100.0f * (float)result.numWarnings		/ (float)result.numExecuted) : 0.0f));
+		print("  Waived:        %d/%d (%.1f%%)\n", result.numWaived,		result.numExecuted, (result.numExecuted > 0 ? (100.0f * (float)result.numWaived			/ (float)result.numExecuted) : 0.0f));
+		if (!result.isComplete)
+			print("Test run was ABORTED!\n");
+	}
+}
+
+} // tcu
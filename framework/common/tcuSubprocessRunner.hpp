@@ -0,0 +1,83 @@
+#ifndef _TCUSUBPROCESSRUNNER_HPP
+#define _TCUSUBPROCESSRUNNER_HPP
+/*-------------------------------------------------------------------------
+ * drawElements Quality Program Tester Core
+ * ----------------------------------------
+ *
+ * Copyright (c) 2020 The Khronos Group Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *//*!
+ * \file
+ * \brief Test session runner using child processes.
+ *//*--------------------------------------------------------------------*/
+
+#include "tcuDefs.hpp"
+#include "tcuTestSessionExecutor.hpp"
+
+#include <string>
+#include <vector>
+
+namespace tcu
+{
+
+class CommandLine;
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Run test session in child processes
+ *
+ * Runs the test cases selected on the command line in several child
+ * processes of the same test binary (--deqp-subprocess-count).
+ *
+ * The case list is first enumerated by a child process in stdout-caselist
+ * mode, so that all case selection options behave as in a normal run. The
+ * list is then split into one contiguous range per child slot. Each slot
+ * takes small batches from the front of its own range, and a slot that
+ * runs out of cases steals the latter half of the largest remaining range.
+ * Batch size shrinks as the range gets shorter so that long running cases
+ * near the end of the run do not leave other slots idle.
+ *
+ * Each batch is run by a new child process that writes its own log.
+ * Completed case results are appended to the log file given on the
+ * command line as soon as the child exits. If the child crashes, the case
+ * in progress is recorded as Crash and the rest of the batch is run by a
+ * new child.
+ *
+ * See tcuMain.cpp for usage.
+ *//*--------------------------------------------------------------------*/
+class SubprocessRunner
+{
+public:
+							SubprocessRunner	(const CommandLine& cmdLine, int argc, const char* const* argv);
+							~SubprocessRunner	(void);
+
+	//! Run all selected cases. Throws if case list can not be enumerated or log can not be written.
+	void					run					(void);
+
+	const TestRunStatus&	getResult			(void) const { return m_status; }
+
+private:
+							SubprocessRunner	(const SubprocessRunner&);
+	SubprocessRunner&		operator=			(const SubprocessRunner&);
+
+	const CommandLine&			m_cmdLine;
+	std::string					m_executable;
+	std::vector<std::string>	m_listArgs;		//!< Arguments for enumerating case list
+	std::vector<std::string>	m_runArgs;		//!< Arguments for running a batch, without case selection
+	TestRunStatus				m_status;
+};
+
+} // tcu
+
+#endif // _TCUSUBPROCESSRUNNER_HPP
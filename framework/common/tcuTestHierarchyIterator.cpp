@@ -148,6 +148,34 @@ const std::string& TestHierarchyIterator::getNodePath (void) const
 	return m_nodePath;
 }
 
+void TestHierarchyIterator::getUpcomingCases (int maxCases, vector<TestCase*>& cases, vector<string>& casePaths) const
+{
+	DE_ASSERT(getState() == STATE_ENTER_NODE && isTestNodeTypeExecutable(getNode()->getNodeType()));
+	DE_ASSERT(m_sessionStack.size() >= 2);
+
+	const NodeIter&		parent		= m_sessionStack[m_sessionStack.size() - 2];
+	const string		parentPath	= m_nodePath.substr(0, m_nodePath.rfind('.'));
+
+	cases.clear();
+	casePaths.clear();
+
+	for (int childNdx = parent.curChildNdx + 1; childNdx < (int)parent.children.size() && (int)cases.size() < maxCases; childNdx++)
+	{
+		TestNode* const		childNode	= parent.children[childNdx];
+		const string		childPath	= parentPath + "." + childNode->getName();
+
+		// Same filtering as in next()
+		if (!isTestNodeTypeExecutable(childNode->getNodeType()) ||
+			!m_caseListFilter.checkCaseFraction(m_groupNumber, childPath) ||
+			!m_caseListFilter.checkRunnerType(childNode->getRunnerType()) ||
+			!m_caseListFilter.checkTestCaseName(childPath.c_str()))
+			continue;
+
+		cases.push_back(static_cast<TestCase*>(childNode));
+		casePaths.push_back(childPath);
+	}
+}
+
 std::string TestHierarchyIterator::buildNodePath (const vector<NodeIter>& nodeStack)
 {
 	string nodePath;
@@ -103,6 +103,10 @@ protected:
  * Upon exiting a group node, before STATE_LEAVE_NODE is called, inflater
  * is asked to clean up any resources by calling leaveGroupNode() or
  * leaveTestPackage() depending on the type of the node.
+ *
+ * While a test case is entered, getUpcomingCases() can be used to look up
+ * the test cases that will be entered next within the same group. Only
+ * already inflated siblings that pass the same filters are returned.
  *//*--------------------------------------------------------------------*/
 class TestHierarchyIterator
 {
@@ -126,6 +130,8 @@ public:
 
 	void					next					(void);
 
+	void					getUpcomingCases		(int maxCases, std::vector<TestCase*>& cases, std::vector<std::string>& casePaths) const;
+
 private:
 	struct NodeIter
 	{
@@ -58,6 +58,9 @@ public:
 	virtual void						init				(TestCase* testCase, const std::string& path) = 0;
 	virtual void						deinit				(TestCase* testCase) = 0;
 	virtual TestNode::IterateResult		iterate				(TestCase* testCase) = 0;
+
+	//! Called after init() with the cases that will be executed next. Executor may start preparing them in the background. Must not throw.
+	virtual void						prefetch			(const std::vector<TestCase*>& cases, const std::vector<std::string>& paths) { DE_UNREF(cases); DE_UNREF(paths); }
 };
 
 /*--------------------------------------------------------------------*//*!
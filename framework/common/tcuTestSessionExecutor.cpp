@@ -201,8 +201,9 @@ bool TestSessionExecutor::enterTestCase (TestCase* testCase, const std::string&
 	m_testCtx.setTerminateAfter(false);
 	log.startCase(casePath.c_str(), caseType);
 
-	m_isInTestCase	= true;
-	m_testStartTime	= deGetMicroseconds();
+	m_isInTestCase				= true;
+	m_testStartTime				= deGetMicroseconds();
+	m_testStartCacheStatistics	= DecompressedTextureCache::getInstance().getStatistics();
 
 	try
 	{
@@ -232,6 +233,16 @@ bool TestSessionExecutor::enterTestCase (TestCase* testCase, const std::string&
 
 	DE_ASSERT(initOk || m_testCtx.getTestResult() != QP_TEST_RESULT_LAST);
 
+	// Let the package prepare following cases while this one executes
+	if (m_testCtx.getCommandLine().getProgramPrefetchCount() > 0)
+	{
+		vector<TestCase*>	upcomingCases;
+		vector<std::string>	upcomingPaths;
+
+		m_iterator.getUpcomingCases(m_testCtx.getCommandLine().getProgramPrefetchCount(), upcomingCases, upcomingPaths);
+		m_caseExecutor->prefetch(upcomingCases, upcomingPaths);
+	}
+
 	return initOk;
 }
 
@@ -256,6 +267,17 @@ void TestSessionExecutor::leaveTestCase (TestCase* testCase)
 		m_testCtx.getLog() << TestLog::Integer("TestDuration", "Test case duration in microseconds", "us", QP_KEY_TAG_TIME, duration);
 	}
 
+	// Only cases that decompressed textures report cache usage.
+	{
+		const DecompressedTextureCache::Statistics	cacheStatistics	= DecompressedTextureCache::getInstance().getStatistics();
+		const deUint64								numHits			= cacheStatistics.numHits - m_testStartCacheStatistics.numHits;
+		const deUint64								numMisses		= cacheStatistics.numMisses - m_testStartCacheStatistics.numMisses;
+
+		if (numHits > 0 || numMisses > 0)
+			m_testCtx.getLog() << TestLog::Integer("DecompressionCacheHits", "Decompressed texture cache hits", "", QP_KEY_TAG_NONE, (deInt64)numHits)
+							   << TestLog::Integer("DecompressionCacheMisses", "Decompressed texture cache misses", "", QP_KEY_TAG_NONE, (deInt64)numMisses);
+	}
+
 	{
 		const qpTestResult	testResult		= m_testCtx.getTestResult();
 		const char* const	testResultDesc	= m_testCtx.getTestResultDesc();
@@ -28,6 +28,7 @@
 #include "tcuTestCase.hpp"
 #include "tcuTestPackage.hpp"
 #include "tcuTestHierarchyIterator.hpp"
+#include "tcuDecompressedTextureCache.hpp"
 #include "deUniquePtr.hpp"
 #include <map>
 
@@ -103,6 +104,7 @@ private:
 	bool							m_isInTestCase;
 	deUint64						m_testStartTime;
 	deUint64						m_packageStartTime;
+	DecompressedTextureCache::Statistics	m_testStartCacheStatistics;
 	std::map<std::string, deUint64>	m_groupsDurationTime;
 };
 
@@ -354,7 +354,7 @@ inline int channelToInt (const deUint8* value, TextureFormat::ChannelType type)
 	return channelToIntType<int>(value, type);
 }
 
-void floatToChannel (deUint8* dst, float src, TextureFormat::ChannelType type)
+inline void floatToChannel (deUint8* dst, float src, TextureFormat::ChannelType type)
 {
 	// make sure this table is updated if format table is updated
 	DE_STATIC_ASSERT(TextureFormat::CHANNELTYPE_LAST == 48);
@@ -445,7 +445,7 @@ static inline deUint16 convertSatUint12 (S src)
 		return (deUint16)src;
 }
 
-void intToChannel (deUint8* dst, int src, TextureFormat::ChannelType type)
+inline void intToChannel (deUint8* dst, int src, TextureFormat::ChannelType type)
 {
 	// make sure this table is updated if format table is updated
 	DE_STATIC_ASSERT(TextureFormat::CHANNELTYPE_LAST == 48);
@@ -1728,6 +1728,293 @@ void PixelBufferAccess::setPixStencil (int stencil, int x, int y, int z) const
 	}
 }
 
+namespace
+{
+
+// Row access kernels.
+//
+// Kernels are specialized for channel type at compile time, so per-pixel
+// format dispatch is only done once per row. They produce exactly the same
+// values as getPixel(), getPixelInt() and setPixel(). Packed formats and
+// less common channel types are not handled here and fall back to per-pixel
+// access.
+
+template<TextureFormat::ChannelType Type>
+inline void readChannel (const deUint8* ptr, float& dst)
+{
+	dst = channelToFloat(ptr, Type);
+}
+
+template<TextureFormat::ChannelType Type>
+inline void readChannel (const deUint8* ptr, int& dst)
+{
+	dst = channelToInt(ptr, Type);
+}
+
+template<TextureFormat::ChannelType Type>
+inline void writeChannel (deUint8* ptr, float src)
+{
+	floatToChannel(ptr, src, Type);
+}
+
+template<TextureFormat::ChannelType Type>
+inline void writeChannel (deUint8* ptr, int src)
+{
+	intToChannel(ptr, src, Type);
+}
+
+template<TextureFormat::ChannelType Type, typename T>
+void readChannelRow (const TextureFormat& format, const deUint8* rowPtr, int pixelPitch, int width, Vector<T, 4>* dst)
+{
+	const TextureSwizzle::Channel* const	channelMap	= getChannelReadSwizzle(format.order).components;
+	const int								channelSize	= getChannelSize(Type);
+	int										offsets[4];
+	T										constants[4];
+
+	// Resolve swizzle once; constant channels are marked with negative offset.
+	for (int c = 0; c < 4; c++)
+	{
+		switch (channelMap[c])
+		{
+			case TextureSwizzle::CHANNEL_0:
+			case TextureSwizzle::CHANNEL_1:
+			case TextureSwizzle::CHANNEL_2:
+			case TextureSwizzle::CHANNEL_3:
+				offsets[c]		= channelSize*((int)channelMap[c]);
+				constants[c]	= T(0);
+				break;
+
+			case TextureSwizzle::CHANNEL_ZERO:
+				offsets[c]		= -1;
+				constants[c]	= T(0);
+				break;
+
+			case TextureSwizzle::CHANNEL_ONE:
+				offsets[c]		= -1;
+				constants[c]	= T(1);
+				break;
+
+			default:
+				DE_ASSERT(false);
+				offsets[c]		= -1;
+				constants[c]	= T(0);
+		}
+	}
+
+	for (int x = 0; x < width; x++)
+	{
+		const deUint8* const pixelPtr = rowPtr + x*pixelPitch;
+
+		for (int c = 0; c < 4; c++)
+		{
+			if (offsets[c] >= 0)
+				readChannel<Type>(pixelPtr + offsets[c], dst[x][c]);
+			else
+				dst[x][c] = constants[c];
+		}
+	}
+}
+
+template<TextureFormat::ChannelType Type, typename T>
+void writeChannelRow (const TextureFormat& format, deUint8* rowPtr, int pixelPitch, int width, const Vector<T, 4>* src)
+{
+	const int								numChannels	= getNumUsedChannels(format.order);
+	const TextureSwizzle::Channel* const	channelMap	= getChannelWriteSwizzle(format.order).components;
+	const int								channelSize	= getChannelSize(Type);
+
+	for (int c = 0; c < numChannels; c++)
+		DE_ASSERT(deInRange32(channelMap[c], TextureSwizzle::CHANNEL_0, TextureSwizzle::CHANNEL_3));
+
+	for (int x = 0; x < width; x++)
+	{
+		deUint8* const pixelPtr = rowPtr + x*pixelPitch;
+
+		for (int c = 0; c < numChannels; c++)
+			writeChannel<Type>(pixelPtr + channelSize*c, src[x][channelMap[c]]);
+	}
+}
+
+inline bool isRGBA8888Format (const TextureFormat& format)
+{
+	return format.type == TextureFormat::UNORM_INT8 && (format.order == TextureFormat::RGBA || format.order == TextureFormat::sRGBA);
+}
+
+inline bool isRGB888Format (const TextureFormat& format)
+{
+	return format.type == TextureFormat::UNORM_INT8 && (format.order == TextureFormat::RGB || format.order == TextureFormat::sRGB);
+}
+
+//! Read row with kernel specialized for format. Returns false if there is no kernel for format.
+template<typename T>
+bool readRowKernel (const TextureFormat& format, const deUint8* rowPtr, int pixelPitch, int width, Vector<T, 4>* dst)
+{
+	switch (format.type)
+	{
+		case TextureFormat::SNORM_INT8:		readChannelRow<TextureFormat::SNORM_INT8>		(format, rowPtr, pixelPitch, width, dst);	return true;
+		case TextureFormat::SNORM_INT16:	readChannelRow<TextureFormat::SNORM_INT16>		(format, rowPtr, pixelPitch, width, dst);	return true;
+		case TextureFormat::UNORM_INT8:		readChannelRow<TextureFormat::UNORM_INT8>		(format, rowPtr, pixelPitch, width, dst);	return true;
+		case TextureFormat::UNORM_INT16:	readChannelRow<TextureFormat::UNORM_INT16>		(format, rowPtr, pixelPitch, width, dst);	return true;
+		case TextureFormat::SIGNED_INT8:	readChannelRow<TextureFormat::SIGNED_INT8>		(format, rowPtr, pixelPitch, width, dst);	return true;
+		case TextureFormat::SIGNED_INT16:	readChannelRow<TextureFormat::SIGNED_INT16>		(format, rowPtr, pixelPitch, width, dst);	return true;
+		case TextureFormat::SIGNED_INT32:	readChannelRow<TextureFormat::SIGNED_INT32>		(format, rowPtr, pixelPitch, width, dst);	return true;
+		case TextureFormat::UNSIGNED_INT8:	readChannelRow<TextureFormat::UNSIGNED_INT8>	(format, rowPtr, pixelPitch, width, dst);	return true;
+		case TextureFormat::UNSIGNED_INT16:	readChannelRow<TextureFormat::UNSIGNED_INT16>	(format, rowPtr, pixelPitch, width, dst);	return true;
+		case TextureFormat::UNSIGNED_INT32:	readChannelRow<TextureFormat::UNSIGNED_INT32>	(format, rowPtr, pixelPitch, width, dst);	return true;
+		case TextureFormat::HALF_FLOAT:		readChannelRow<TextureFormat::HALF_FLOAT>		(format, rowPtr, pixelPitch, width, dst);	return true;
+		case TextureFormat::FLOAT:			readChannelRow<TextureFormat::FLOAT>			(format, rowPtr, pixelPitch, width, dst);	return true;
+		default:
+			return false;
+	}
+}
+
+//! Write row with kernel specialized for format. Returns false if there is no kernel for format.
+template<typename T>
+bool writeRowKernel (const TextureFormat& format, deUint8* rowPtr, int pixelPitch, int width, const Vector<T, 4>* src)
+{
+	switch (format.type)
+	{
+		case TextureFormat::SNORM_INT8:		writeChannelRow<TextureFormat::SNORM_INT8>		(format, rowPtr, pixelPitch, width, src);	return true;
+		case TextureFormat::SNORM_INT16:	writeChannelRow<TextureFormat::SNORM_INT16>		(format, rowPtr, pixelPitch, width, src);	return true;
+		case TextureFormat::UNORM_INT8:		writeChannelRow<TextureFormat::UNORM_INT8>		(format, rowPtr, pixelPitch, width, src);	return true;
+		case TextureFormat::UNORM_INT16:	writeChannelRow<TextureFormat::UNORM_INT16>		(format, rowPtr, pixelPitch, width, src);	return true;
+		case TextureFormat::SIGNED_INT8:	writeChannelRow<TextureFormat::SIGNED_INT8>		(format, rowPtr, pixelPitch, width, src);	return true;
+		case TextureFormat::SIGNED_INT16:	writeChannelRow<TextureFormat::SIGNED_INT16>	(format, rowPtr, pixelPitch, width, src);	return true;
+		case TextureFormat::SIGNED_INT32:	writeChannelRow<TextureFormat::SIGNED_INT32>	(format, rowPtr, pixelPitch, width, src);	return true;
+		case TextureFormat::UNSIGNED_INT8:	writeChannelRow<TextureFormat::UNSIGNED_INT8>	(format, rowPtr, pixelPitch, width, src);	return true;
+		case TextureFormat::UNSIGNED_INT16:	writeChannelRow<TextureFormat::UNSIGNED_INT16>	(format, rowPtr, pixelPitch, width, src);	return true;
+		case TextureFormat::UNSIGNED_INT32:	writeChannelRow<TextureFormat::UNSIGNED_INT32>	(format, rowPtr, pixelPitch, width, src);	return true;
+		case TextureFormat::HALF_FLOAT:		writeChannelRow<TextureFormat::HALF_FLOAT>		(format, rowPtr, pixelPitch, width, src);	return true;
+		case TextureFormat::FLOAT:			writeChannelRow<TextureFormat::FLOAT>			(format, rowPtr, pixelPitch, width, src);	return true;
+		default:
+			return false;
+	}
+}
+
+} // anonymous
+
+void ConstPixelBufferAccess::readRow (int y, int z, Vec4* dst) const
+{
+	DE_ASSERT(de::inBounds(y, 0, m_size.y()));
+	DE_ASSERT(de::inBounds(z, 0, m_size.z()));
+	DE_ASSERT(!isCombinedDepthStencilType(m_format.type)); // combined types cannot be accessed directly
+	DE_ASSERT(m_format.order != TextureFormat::DS); // combined formats cannot be accessed directly
+
+	const deUint8* const	rowPtr	= (const deUint8*)getPixelPtr(0, y, z);
+	const int				width	= m_size.x();
+
+	if (m_divider.x() == 1)
+	{
+		if (isRGBA8888Format(m_format))
+		{
+			for (int x = 0; x < width; x++)
+				dst[x] = readRGBA8888Float(rowPtr + x*m_pitch.x());
+			return;
+		}
+
+		if (readRowKernel(m_format, rowPtr, m_pitch.x(), width, dst))
+			return;
+	}
+
+	for (int x = 0; x < width; x++)
+		dst[x] = getPixel(x, y, z);
+}
+
+void ConstPixelBufferAccess::readRow (int y, int z, IVec4* dst) const
+{
+	DE_ASSERT(de::inBounds(y, 0, m_size.y()));
+	DE_ASSERT(de::inBounds(z, 0, m_size.z()));
+	DE_ASSERT(!isCombinedDepthStencilType(m_format.type)); // combined types cannot be accessed directly
+	DE_ASSERT(m_format.order != TextureFormat::DS); // combined formats cannot be accessed directly
+
+	const deUint8* const	rowPtr	= (const deUint8*)getPixelPtr(0, y, z);
+	const int				width	= m_size.x();
+
+	if (m_divider.x() == 1)
+	{
+		if (isRGBA8888Format(m_format))
+		{
+			for (int x = 0; x < width; x++)
+				dst[x] = readRGBA8888Int(rowPtr + x*m_pitch.x());
+			return;
+		}
+
+		if (readRowKernel(m_format, rowPtr, m_pitch.x(), width, dst))
+			return;
+	}
+
+	for (int x = 0; x < width; x++)
+		dst[x] = getPixelInt(x, y, z);
+}
+
+void PixelBufferAccess::writeRow (int y, int z, const Vec4* src) const
+{
+	DE_ASSERT(de::inBounds(y, 0, m_size.y()));
+	DE_ASSERT(de::inBounds(z, 0, m_size.z()));
+	DE_ASSERT(!isCombinedDepthStencilType(m_format.type)); // combined types cannot be accessed directly
+	DE_ASSERT(m_format.order != TextureFormat::DS); // combined formats cannot be accessed directly
+
+	deUint8* const	rowPtr	= (deUint8*)getPixelPtr(0, y, z);
+	const int		width	= m_size.x();
+
+	if (m_divider.x() == 1)
+	{
+		// setPixel() uses optimized conversion for these formats that differs from generic path.
+		if (isRGBA8888Format(m_format))
+		{
+			for (int x = 0; x < width; x++)
+				writeRGBA8888Float(rowPtr + x*m_pitch.x(), src[x]);
+			return;
+		}
+
+		if (isRGB888Format(m_format))
+		{
+			for (int x = 0; x < width; x++)
+				writeRGB888Float(rowPtr + x*m_pitch.x(), src[x]);
+			return;
+		}
+
+		if (writeRowKernel(m_format, rowPtr, m_pitch.x(), width, src))
+			return;
+	}
+
+	for (int x = 0; x < width; x++)
+		setPixel(src[x], x, y, z);
+}
+
+void PixelBufferAccess::writeRow (int y, int z, const IVec4* src) const
+{
+	DE_ASSERT(de::inBounds(y, 0, m_size.y()));
+	DE_ASSERT(de::inBounds(z, 0, m_size.z()));
+	DE_ASSERT(!isCombinedDepthStencilType(m_format.type)); // combined types cannot be accessed directly
+	DE_ASSERT(m_format.order != TextureFormat::DS); // combined formats cannot be accessed directly
+
+	deUint8* const	rowPtr	= (deUint8*)getPixelPtr(0, y, z);
+	const int		width	= m_size.x();
+
+	if (m_divider.x() == 1)
+	{
+		if (isRGBA8888Format(m_format))
+		{
+			for (int x = 0; x < width; x++)
+				writeRGBA8888Int(rowPtr + x*m_pitch.x(), src[x]);
+			return;
+		}
+
+		if (isRGB888Format(m_format))
+		{
+			for (int x = 0; x < width; x++)
+				writeRGB888Int(rowPtr + x*m_pitch.x(), src[x]);
+			return;
+		}
+
+		if (writeRowKernel(m_format, rowPtr, m_pitch.x(), width, src))
+			return;
+	}
+
+	for (int x = 0; x < width; x++)
+		setPixel(src[x], x, y, z);
+}
+
 static inline int imod (int a, int b)
 {
 	int m = a % b;
@@ -380,6 +380,10 @@ public:
 	template<typename T>
 	Vector<T, 4>			getPixelT					(int x, int y, int z = 0) const;
 
+	//! Read all pixels of row. Equivalent to getPixel() / getPixelInt() for each pixel, but format is resolved once per row.
+	void					readRow						(int y, int z, Vec4* dst) const;
+	void					readRow						(int y, int z, IVec4* dst) const;
+
 	float					getPixDepth					(int x, int y, int z = 0) const;
 	int						getPixStencil				(int x, int y, int z = 0) const;
 
@@ -429,6 +433,10 @@ public:
 	void				setPixel			(const tcu::IVec4& color, int x, int y, int z = 0) const;
 	void				setPixel			(const tcu::UVec4& color, int x, int y, int z = 0) const { setPixel(color.cast<int>(), x, y, z); }
 
+	//! Write all pixels of row. Equivalent to setPixel() for each pixel, but format is resolved once per row.
+	void				writeRow			(int y, int z, const Vec4* src) const;
+	void				writeRow			(int y, int z, const IVec4* src) const;
+
 	void				setPixDepth			(float depth, int x, int y, int z = 0) const;
 	void				setPixStencil		(int stencil, int x, int y, int z = 0) const;
 } DE_WARN_UNUSED_TYPE;
@@ -28,6 +28,7 @@
 #include "deMemory.h"
 
 #include <limits>
+#include <vector>
 
 namespace tcu
 {
@@ -771,12 +772,13 @@ void clear (const PixelBufferAccess& access, const Vec4& color)
 			for (int y = 0; y < access.getHeight(); y++)
 				fillRow(access, y, z, pixelSize, &pixel.u8[0]);
 	}
-	else
+	else if (access.getWidth() > 0)
 	{
+		const std::vector<Vec4> row (access.getWidth(), color);
+
 		for (int z = 0; z < access.getDepth(); z++)
 			for (int y = 0; y < access.getHeight(); y++)
-				for (int x = 0; x < access.getWidth(); x++)
-					access.setPixel(color, x, y, z);
+				access.writeRow(y, z, &row[0]);
 	}
 }
 
@@ -802,12 +804,13 @@ void clear (const PixelBufferAccess& access, const IVec4& color)
 			for (int y = 0; y < access.getHeight(); y++)
 				fillRow(access, y, z, pixelSize, &pixel.u8[0]);
 	}
-	else
+	else if (access.getWidth() > 0)
 	{
+		const std::vector<IVec4> row (access.getWidth(), color);
+
 		for (int z = 0; z < access.getDepth(); z++)
 			for (int y = 0; y < access.getHeight(); y++)
-				for (int x = 0; x < access.getWidth(); x++)
-					access.setPixel(color, x, y, z);
+				access.writeRow(y, z, &row[0]);
 	}
 }
 
@@ -1201,19 +1204,31 @@ void copy (const PixelBufferAccess& dst, const ConstPixelBufferAccess& src, cons
 		bool					srcIsInt	= srcClass == TEXTURECHANNELCLASS_SIGNED_INTEGER || srcClass == TEXTURECHANNELCLASS_UNSIGNED_INTEGER;
 		bool					dstIsInt	= dstClass == TEXTURECHANNELCLASS_SIGNED_INTEGER || dstClass == TEXTURECHANNELCLASS_UNSIGNED_INTEGER;
 
+		if (width == 0)
+			return;
+
+		// Convert through row buffer to avoid per-pixel format dispatch.
 		if (srcIsInt && dstIsInt)
 		{
+			std::vector<IVec4> row (width);
+
 			for (int z = 0; z < depth; z++)
 			for (int y = 0; y < height; y++)
-			for (int x = 0; x < width; x++)
-				dst.setPixel(src.getPixelInt(x, y, z), x, y, z);
+			{
+				src.readRow(y, z, &row[0]);
+				dst.writeRow(y, z, &row[0]);
+			}
 		}
 		else
 		{
+			std::vector<Vec4> row (width);
+
 			for (int z = 0; z < depth; z++)
 			for (int y = 0; y < height; y++)
-			for (int x = 0; x < width; x++)
-				dst.setPixel(src.getPixel(x, y, z), x, y, z);
+			{
+				src.readRow(y, z, &row[0]);
+				dst.writeRow(y, z, &row[0]);
+			}
 		}
 	}
 }
@@ -0,0 +1,385 @@
+/*-------------------------------------------------------------------------
+ * drawElements C++ Base Library
+ * -----------------------------
+ *
+ * Copyright 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *//*!
+ * \file
+ * \brief Bounded lock-free multi-producer multi-consumer queue.
+ *//*--------------------------------------------------------------------*/
+
+#include "deLockFreeQueue.hpp"
+#include "deRandom.hpp"
+#include "deThread.hpp"
+
+#include <vector>
+
+#if defined(__linux__)
+#	define DE_EVENT_COUNT_USE_FUTEX 1
+#	include <unistd.h>
+#	include <limits.h>
+#	include <sys/syscall.h>
+#	include <linux/futex.h>
+#else
+#	define DE_EVENT_COUNT_USE_FUTEX 0
+#endif
+
+using std::vector;
+
+namespace de
+{
+
+// EventCount
+
+EventCount::EventCount (void)
+	: m_epoch			(0)
+	, m_numWaiters		(0)
+	, m_sleepSemaphore	(0)
+	, m_numSleepers		(0)
+{
+}
+
+EventCount::~EventCount (void)
+{
+	DE_ASSERT(m_numWaiters == 0);
+}
+
+deUint32 EventCount::prepareWait (void)
+{
+	// \note Atomic increment is a full barrier: condition re-check done by
+	//		 caller can't be reordered before waiter is visible to notify().
+	deAtomicIncrementUint32(&m_numWaiters);
+	return m_epoch;
+}
+
+void EventCount::cancelWait (void)
+{
+	deAtomicDecrementUint32(&m_numWaiters);
+}
+
+void EventCount::wait (deUint32 key)
+{
+#if (DE_EVENT_COUNT_USE_FUTEX)
+	// Futex wait returns immediately if epoch has already changed.
+	while (m_epoch == key)
+		syscall(SYS_futex, (volatile int*)&m_epoch, FUTEX_WAIT_PRIVATE, (int)key, DE_NULL, DE_NULL, 0);
+#else
+	bool sleep = false;
+
+	{
+		const ScopedLock lock (m_sleepLock);
+
+		if (m_epoch == key)
+		{
+			m_numSleepers += 1;
+			sleep = true;
+		}
+	}
+
+	if (sleep)
+		m_sleepSemaphore.decrement();
+#endif
+
+	deAtomicDecrementUint32(&m_numWaiters);
+}
+
+void EventCount::notifyOne (void)
+{
+	notify(false);
+}
+
+void EventCount::notifyAll (void)
+{
+	notify(true);
+}
+
+void EventCount::notify (bool all)
+{
+	// Pairs with the barrier in prepareWait(): either waiter sees the
+	// condition change or we see the waiter.
+	deMemoryReadWriteFence();
+
+	if (m_numWaiters == 0)
+		return;
+
+	deAtomicIncrementUint32(&m_epoch);
+
+#if (DE_EVENT_COUNT_USE_FUTEX)
+	syscall(SYS_futex, (volatile int*)&m_epoch, FUTEX_WAKE_PRIVATE, all ? INT_MAX : 1, DE_NULL, DE_NULL, 0);
+#else
+	deUint32 numToWake = 0;
+
+	{
+		const ScopedLock lock (m_sleepLock);
+
+		numToWake		 = all ? m_numSleepers : de::min<deUint32>(m_numSleepers, 1u);
+		m_numSleepers	-= numToWake;
+	}
+
+	for (deUint32 ndx = 0; ndx < numToWake; ndx++)
+		m_sleepSemaphore.increment();
+#endif
+}
+
+// Self-test.
+
+namespace
+{
+
+struct Message
+{
+	deUint32 data;
+
+	Message (deUint16 threadId, deUint16 payload)
+		: data((threadId << 16) | payload)
+	{
+	}
+
+	Message (void)
+		: data(0)
+	{
+	}
+
+	deUint16 getThreadId	(void) const { return (deUint16)(data >> 16);		}
+	deUint16 getPayload		(void) const { return (deUint16)(data & 0xffff);	}
+};
+
+// Blocking and polling access to queues.
+
+template <typename T>
+void pushMessage (BlockingLockFreeQueue<T>& queue, const T& msg)
+{
+	queue.push(msg);
+}
+
+template <typename T>
+T popMessage (BlockingLockFreeQueue<T>& queue)
+{
+	return queue.pop();
+}
+
+template <typename T>
+void pushMessage (LockFreeQueue<T>& queue, const T& msg)
+{
+	while (!queue.tryPush(msg))
+		deYield();
+}
+
+template <typename T>
+T popMessage (LockFreeQueue<T>& queue)
+{
+	T msg;
+
+	while (!queue.tryPop(msg))
+		deYield();
+
+	return msg;
+}
+
+template <typename Queue>
+class Consumer : public Thread
+{
+public:
+	Consumer (Queue& queue, int numProducers)
+		: m_queue	(queue)
+	{
+		m_lastPayload.resize(numProducers, 0);
+		m_payloadSum.resize(numProducers, 0);
+	}
+
+	void run (void)
+	{
+		for (;;)
+		{
+			Message msg = popMessage(m_queue);
+
+			deUint16 threadId = msg.getThreadId();
+
+			if (threadId == 0xffff)
+				break;
+
+			DE_TEST_ASSERT(de::inBounds<int>(threadId, 0, (int)m_lastPayload.size()));
+			DE_TEST_ASSERT((m_lastPayload[threadId] == 0 && msg.getPayload() == 0) || m_lastPayload[threadId] < msg.getPayload());
+
+			m_lastPayload[threadId]	 = msg.getPayload();
+			m_payloadSum[threadId]	+= (deUint32)msg.getPayload();
+		}
+	}
+
+	deUint32 getPayloadSum (deUint16 threadId) const
+	{
+		return m_payloadSum[threadId];
+	}
+
+private:
+	Queue&				m_queue;
+	vector<deUint16>	m_lastPayload;
+	vector<deUint32>	m_payloadSum;
+};
+
+template <typename Queue>
+class Producer : public Thread
+{
+public:
+	Producer (Queue& queue, deUint16 threadId, int dataSize)
+		: m_queue		(queue)
+		, m_threadId	(threadId)
+		, m_dataSize	(dataSize)
+	{
+	}
+
+	void run (void)
+	{
+		// Yield to give main thread chance to start other producers.
+		deSleep(1);
+
+		for (int ndx = 0; ndx < m_dataSize; ndx++)
+			pushMessage(m_queue, Message(m_threadId, (deUint16)ndx));
+	}
+
+private:
+	Queue&				m_queue;
+	deUint16			m_threadId;
+	int					m_dataSize;
+};
+
+void singleThreadTest (void)
+{
+	// Capacity is rounded up to power of two.
+	DE_TEST_ASSERT(LockFreeQueue<int>(1).getCapacity() == 2);
+	DE_TEST_ASSERT(LockFreeQueue<int>(5).getCapacity() == 8);
+	DE_TEST_ASSERT(LockFreeQueue<int>(16).getCapacity() == 16);
+
+	// Full and empty queue, order and wrap-around.
+	{
+		LockFreeQueue<int>	queue	(4);
+		int					value	= -1;
+		int					next	= 0;
+
+		DE_TEST_ASSERT(!queue.tryPop(value));
+
+		for (int iterNdx = 0; iterNdx < 5; iterNdx++)
+		{
+			const int first = next;
+
+			for (int ndx = 0; ndx < 4; ndx++)
+				DE_TEST_ASSERT(queue.tryPush(next++));
+
+			DE_TEST_ASSERT(!queue.tryPush(-1));
+
+			for (int ndx = 0; ndx < 4; ndx++)
+			{
+				DE_TEST_ASSERT(queue.tryPop(value));
+				DE_TEST_ASSERT(value == first + ndx);
+			}
+
+			DE_TEST_ASSERT(!queue.tryPop(value));
+
+			// Interleave pushes and pops to move start position.
+			DE_TEST_ASSERT(queue.tryPush(next));
+			DE_TEST_ASSERT(queue.tryPop(value) && value == next);
+			next += 1;
+		}
+	}
+
+	// Blocking queue doesn't block when not needed.
+	{
+		BlockingLockFreeQueue<int>	queue	(2);
+		int							value	= -1;
+
+		queue.push(1);
+		queue.push(2);
+		DE_TEST_ASSERT(!queue.tryPush(3));
+		DE_TEST_ASSERT(queue.pop() == 1);
+		DE_TEST_ASSERT(queue.tryPush(3));
+		DE_TEST_ASSERT(queue.pop() == 2);
+		DE_TEST_ASSERT(queue.tryPop(value) && value == 3);
+		DE_TEST_ASSERT(!queue.tryPop(value));
+	}
+}
+
+template <typename Queue>
+void multiThreadTest (void)
+{
+	const int numIterations = 16;
+	for (int iterNdx = 0; iterNdx < numIterations; iterNdx++)
+	{
+		Random						rnd				(iterNdx);
+		int							queueSize		= rnd.getInt(1, 2048);
+		int							numProducers	= rnd.getInt(1, 16);
+		int							numConsumers	= rnd.getInt(1, 16);
+		int							dataSize		= rnd.getInt(1000, 10000);
+		Queue						queue			(queueSize);
+		vector<Producer<Queue>*>	producers;
+		vector<Consumer<Queue>*>	consumers;
+
+		for (int i = 0; i < numProducers; i++)
+			producers.push_back(new Producer<Queue>(queue, (deUint16)i, dataSize));
+
+		for (int i = 0; i < numConsumers; i++)
+			consumers.push_back(new Consumer<Queue>(queue, numProducers));
+
+		// Start consumers.
+		for (typename vector<Consumer<Queue>*>::iterator i = consumers.begin(); i != consumers.end(); i++)
+			(*i)->start();
+
+		// Start producers.
+		for (typename vector<Producer<Queue>*>::iterator i = producers.begin(); i != producers.end(); i++)
+			(*i)->start();
+
+		// Wait for producers.
+		for (typename vector<Producer<Queue>*>::iterator i = producers.begin(); i != producers.end(); i++)
+			(*i)->join();
+
+		// Write end messages for consumers.
+		for (int i = 0; i < numConsumers; i++)
+			pushMessage(queue, Message(0xffff, 0));
+
+		// Wait for consumers.
+		for (typename vector<Consumer<Queue>*>::iterator i = consumers.begin(); i != consumers.end(); i++)
+			(*i)->join();
+
+		// Verify payload sums.
+		deUint32 refSum = 0;
+		for (int i = 0; i < dataSize; i++)
+			refSum += (deUint32)(deUint16)i;
+
+		for (int i = 0; i < numProducers; i++)
+		{
+			deUint32 cmpSum = 0;
+			for (int j = 0; j < numConsumers; j++)
+				cmpSum += consumers[j]->getPayloadSum((deUint16)i);
+			DE_TEST_ASSERT(refSum == cmpSum);
+		}
+
+		// Free resources.
+		for (typename vector<Producer<Queue>*>::iterator i = producers.begin(); i != producers.end(); i++)
+			delete *i;
+		for (typename vector<Consumer<Queue>*>::iterator i = consumers.begin(); i != consumers.end(); i++)
+			delete *i;
+	}
+}
+
+} // anonymous
+
+void LockFreeQueue_selfTest (void)
+{
+	singleThreadTest();
+	multiThreadTest<LockFreeQueue<Message> >();
+	multiThreadTest<BlockingLockFreeQueue<Message> >();
+}
+
+} // de
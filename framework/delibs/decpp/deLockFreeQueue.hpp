@@ -0,0 +1,337 @@
+#ifndef _DELOCKFREEQUEUE_HPP
+#define _DELOCKFREEQUEUE_HPP
+/*-------------------------------------------------------------------------
+ * drawElements C++ Base Library
+ * -----------------------------
+ *
+ * Copyright 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *//*!
+ * \file
+ * \brief Bounded lock-free multi-producer multi-consumer queue.
+ *//*--------------------------------------------------------------------*/
+
+#include "deDefs.hpp"
+#include "deAtomic.h"
+#include "deInt32.h"
+#include "deMutex.hpp"
+#include "deSemaphore.hpp"
+
+namespace de
+{
+
+void LockFreeQueue_selfTest (void);
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Bounded lock-free multi-producer multi-consumer queue
+ *
+ * Array-based queue after Dmitry Vyukov's bounded MPMC queue. Each cell
+ * carries a sequence number that tells whether the cell is ready to be
+ * written or read at a given queue position, so producers and consumers
+ * only contend on a single CAS of the push or pop position.
+ *
+ * Capacity is rounded up to a power of two. Elements are copied in and
+ * out of the queue and must be default constructible and assignable.
+ * Popped elements are not destroyed until the cell is overwritten.
+ *//*--------------------------------------------------------------------*/
+template <typename T>
+class LockFreeQueue
+{
+public:
+	explicit		LockFreeQueue		(size_t capacity);
+					~LockFreeQueue		(void);
+
+	//! Push element unless queue is full.
+	bool			tryPush				(const T& elem);
+
+	//! Pop oldest element unless queue is empty.
+	bool			tryPop				(T& dst);
+
+	size_t			getCapacity			(void) const { return m_mask+1; }
+
+private:
+					LockFreeQueue		(const LockFreeQueue&); // disabled
+	LockFreeQueue&	operator=			(const LockFreeQueue&); // disabled
+
+	enum
+	{
+		CACHE_LINE_SIZE = 64
+	};
+
+	struct Cell
+	{
+		volatile size_t	sequence;
+		T				elem;
+	};
+
+	const size_t		m_mask;
+	Cell* const			m_cells;
+
+	// \note Push and pop positions are kept in separate cache lines
+	deUint8				m_padding0[CACHE_LINE_SIZE];
+	volatile size_t		m_pushPos;
+	deUint8				m_padding1[CACHE_LINE_SIZE - sizeof(size_t)];
+	volatile size_t		m_popPos;
+	deUint8				m_padding2[CACHE_LINE_SIZE - sizeof(size_t)];
+};
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Wait-notify primitive for lock-free data structures
+ *
+ * Waiting thread calls prepareWait(), re-checks its condition and then
+ * either cancelWait() if the condition was met or wait() with the key
+ * returned by prepareWait(). A notification that happens after
+ * prepareWait() makes wait() return immediately, so no wakeups are lost.
+ *
+ * On Linux threads sleep on a futex. Elsewhere sleeping is emulated with
+ * a mutex and a semaphore. Notifying is cheap when no thread is waiting.
+ *//*--------------------------------------------------------------------*/
+class EventCount
+{
+public:
+						EventCount		(void);
+						~EventCount		(void);
+
+	deUint32			prepareWait		(void);
+	void				cancelWait		(void);
+	void				wait			(deUint32 key);
+
+	//! Wake one waiting thread, if any.
+	void				notifyOne		(void);
+
+	//! Wake all waiting threads.
+	void				notifyAll		(void);
+
+private:
+						EventCount		(const EventCount&); // disabled
+	EventCount&			operator=		(const EventCount&); // disabled
+
+	void				notify			(bool all);
+
+	volatile deUint32	m_epoch;
+	volatile deUint32	m_numWaiters;	//!< Threads between prepareWait() and return from wait() or cancelWait().
+
+	// Used when futex is not available.
+	Mutex				m_sleepLock;
+	Semaphore			m_sleepSemaphore;
+	deUint32			m_numSleepers;
+};
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Blocking bounded lock-free MPMC queue
+ *
+ * LockFreeQueue with blocking push() and pop(). Threads spin briefly and
+ * then sleep on an EventCount, so that uncontended operations need no
+ * locks or system calls.
+ *//*--------------------------------------------------------------------*/
+template <typename T>
+class BlockingLockFreeQueue
+{
+public:
+	explicit			BlockingLockFreeQueue	(size_t capacity) : m_queue(capacity) {}
+						~BlockingLockFreeQueue	(void) {}
+
+	//! Push element, waiting until there is room in the queue.
+	void				push					(const T& elem);
+	bool				tryPush					(const T& elem);
+
+	//! Pop oldest element, waiting until queue is not empty.
+	T					pop						(void);
+	bool				tryPop					(T& dst);
+
+	size_t				getCapacity				(void) const { return m_queue.getCapacity(); }
+
+private:
+						BlockingLockFreeQueue	(const BlockingLockFreeQueue&); // disabled
+	BlockingLockFreeQueue& operator=			(const BlockingLockFreeQueue&); // disabled
+
+	enum
+	{
+		SPIN_COUNT = 64		//!< Failed attempts before thread goes to sleep.
+	};
+
+	LockFreeQueue<T>	m_queue;
+	EventCount			m_notEmpty;
+	EventCount			m_notFull;
+};
+
+// LockFreeQueue implementation.
+
+template <typename T>
+LockFreeQueue<T>::LockFreeQueue (size_t capacity)
+	: m_mask	(deSmallestGreaterOrEquallPowerOfTwoSize(de::max<size_t>(capacity, 2))-1)
+	, m_cells	(new Cell[m_mask+1])
+	, m_pushPos	(0)
+	, m_popPos	(0)
+{
+	for (size_t ndx = 0; ndx <= m_mask; ndx++)
+		m_cells[ndx].sequence = ndx;
+}
+
+template <typename T>
+LockFreeQueue<T>::~LockFreeQueue (void)
+{
+	delete[] m_cells;
+}
+
+template <typename T>
+bool LockFreeQueue<T>::tryPush (const T& elem)
+{
+	size_t	pos		= m_pushPos;
+	Cell*	cell;
+
+	for (;;)
+	{
+		cell = &m_cells[pos & m_mask];
+
+		const size_t	sequence	= deAtomicLoadAcquireUSize(&cell->sequence);
+		const deIntptr	diff		= (deIntptr)sequence - (deIntptr)pos;
+
+		if (diff == 0)
+		{
+			// Cell is free at this position, try to claim it
+			const size_t prevPos = deAtomicCompareExchangeUSize(&m_pushPos, pos, pos+1);
+
+			if (prevPos == pos)
+				break;
+
+			pos = prevPos;
+		}
+		else if (diff < 0)
+			return false; // Cell still holds element from previous lap: queue is full
+		else
+			pos = m_pushPos; // Another producer claimed the position
+	}
+
+	cell->elem = elem;
+	deAtomicStoreReleaseUSize(&cell->sequence, pos+1);
+
+	return true;
+}
+
+template <typename T>
+bool LockFreeQueue<T>::tryPop (T& dst)
+{
+	size_t	pos		= m_popPos;
+	Cell*	cell;
+
+	for (;;)
+	{
+		cell = &m_cells[pos & m_mask];
+
+		const size_t	sequence	= deAtomicLoadAcquireUSize(&cell->sequence);
+		const deIntptr	diff		= (deIntptr)sequence - (deIntptr)(pos+1);
+
+		if (diff == 0)
+		{
+			// Cell has been written at this position, try to claim it
+			const size_t prevPos = deAtomicCompareExchangeUSize(&m_popPos, pos, pos+1);
+
+			if (prevPos == pos)
+				break;
+
+			pos = prevPos;
+		}
+		else if (diff < 0)
+			return false; // Cell not written yet: queue is empty
+		else
+			pos = m_popPos; // Another consumer claimed the position
+	}
+
+	dst = cell->elem;
+	deAtomicStoreReleaseUSize(&cell->sequence, pos+m_mask+1);
+
+	return true;
+}
+
+// BlockingLockFreeQueue implementation.
+
+template <typename T>
+bool BlockingLockFreeQueue<T>::tryPush (const T& elem)
+{
+	if (!m_queue.tryPush(elem))
+		return false;
+
+	m_notEmpty.notifyOne();
+	return true;
+}
+
+template <typename T>
+void BlockingLockFreeQueue<T>::push (const T& elem)
+{
+	for (int spinNdx = 0; spinNdx < SPIN_COUNT; spinNdx++)
+	{
+		if (tryPush(elem))
+			return;
+	}
+
+	for (;;)
+	{
+		const deUint32 key = m_notFull.prepareWait();
+
+		if (m_queue.tryPush(elem))
+		{
+			m_notFull.cancelWait();
+			break;
+		}
+
+		m_notFull.wait(key);
+	}
+
+	m_notEmpty.notifyOne();
+}
+
+template <typename T>
+bool BlockingLockFreeQueue<T>::tryPop (T& dst)
+{
+	if (!m_queue.tryPop(dst))
+		return false;
+
+	m_notFull.notifyOne();
+	return true;
+}
+
+template <typename T>
+T BlockingLockFreeQueue<T>::pop (void)
+{
+	T elem;
+
+	for (int spinNdx = 0; spinNdx < SPIN_COUNT; spinNdx++)
+	{
+		if (tryPop(elem))
+			return elem;
+	}
+
+	for (;;)
+	{
+		const deUint32 key = m_notEmpty.prepareWait();
+
+		if (m_queue.tryPop(elem))
+		{
+			m_notEmpty.cancelWait();
+			break;
+		}
+
+		m_notEmpty.wait(key);
+	}
+
+	m_notFull.notifyOne();
+
+	return elem;
+}
+
+} // de
+
+#endif // _DELOCKFREEQUEUE_HPP
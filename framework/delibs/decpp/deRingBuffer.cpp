@@ -63,10 +63,28 @@ void RingBuffer_selfTest (void)
 				int			numBytes	= rnd.getInt(1, buffer.getNumElements());
 				vector<int>	tmp			(numBytes);
 
-				buffer.popBack(&tmp[0], numBytes);
+				if (rnd.getBool())
+				{
+					// Read directly from contiguous span.
+					int			spanSize	= 0;
+					const int*	span		= buffer.getElementSpan(spanSize);
 
-				for (int i = 0; i < numBytes; i++)
-					DE_TEST_ASSERT(tmp[i] == data[readPos+i]);
+					DE_TEST_ASSERT(de::inRange(spanSize, 1, buffer.getNumElements()));
+
+					numBytes = de::min(numBytes, spanSize);
+
+					for (int i = 0; i < numBytes; i++)
+						DE_TEST_ASSERT(span[i] == data[readPos+i]);
+
+					buffer.popBack(numBytes);
+				}
+				else
+				{
+					buffer.popBack(&tmp[0], numBytes);
+
+					for (int i = 0; i < numBytes; i++)
+						DE_TEST_ASSERT(tmp[i] == data[readPos+i]);
+				}
 
 				readPos += numBytes;
 			}
@@ -75,7 +93,25 @@ void RingBuffer_selfTest (void)
 				DE_TEST_ASSERT(canWrite);
 
 				int numBytes = rnd.getInt(1, de::min(dataSize-writePos, buffer.getNumFree()));
-				buffer.pushFront(&data[writePos], numBytes);
+
+				if (rnd.getBool())
+				{
+					// Write directly to contiguous span.
+					int		spanSize	= 0;
+					int*	span		= buffer.getFreeSpan(spanSize);
+
+					DE_TEST_ASSERT(de::inRange(spanSize, 1, buffer.getNumFree()));
+
+					numBytes = de::min(numBytes, spanSize);
+
+					for (int i = 0; i < numBytes; i++)
+						span[i] = data[writePos+i];
+
+					buffer.commitFront(numBytes);
+				}
+				else
+					buffer.pushFront(&data[writePos], numBytes);
+
 				writePos += numBytes;
 			}
 		}
@@ -55,6 +55,11 @@ public:
 	void	popBack			(T* elemBuf, int count) { peekBack(elemBuf, count); popBack(count); }
 	void	popBack			(int count);
 
+	// Direct access to contiguous storage, for producing or consuming elements in place.
+	T*			getFreeSpan		(int& numFree);				//!< Contiguous free space at front, size returned in numFree.
+	void		commitFront		(int count);				//!< Push count elements written to free span.
+	const T*	getElementSpan	(int& numElements) const;	//!< Contiguous elements at back, count returned in numElements.
+
 protected:
 	int		m_numElements;
 	int		m_front;
@@ -131,10 +136,18 @@ template <typename T>
 void RingBuffer<T>::pushFront (const T* elemBuf, int count)
 {
 	DE_ASSERT(de::inRange(count, 0, getNumFree()));
-	for (int i = 0; i < count; i++)
-		m_buffer[(m_front + i) % m_size] = elemBuf[i];
-	m_front = (m_front + count) % m_size;
-	m_numElements += count;
+
+	for (int numWritten = 0; numWritten < count;)
+	{
+		const int numToWrite = de::min(count - numWritten, m_size - m_front);
+
+		for (int i = 0; i < numToWrite; i++)
+			m_buffer[m_front + i] = elemBuf[numWritten + i];
+
+		m_front			 = (m_front + numToWrite) % m_size;
+		m_numElements	+= numToWrite;
+		numWritten		+= numToWrite;
+	}
 }
 
 template <typename T>
@@ -158,8 +171,17 @@ template <typename T>
 void RingBuffer<T>::peekBack (T* elemBuf, int count) const
 {
 	DE_ASSERT(de::inRange(count, 0, getNumElements()));
-	for (int i = 0; i < count; i++)
-		elemBuf[i] = m_buffer[(m_back + i) % m_size];
+
+	for (int numRead = 0; numRead < count;)
+	{
+		const int	srcPos		= (m_back + numRead) % m_size;
+		const int	numToRead	= de::min(count - numRead, m_size - srcPos);
+
+		for (int i = 0; i < numToRead; i++)
+			elemBuf[numRead + i] = m_buffer[srcPos + i];
+
+		numRead += numToRead;
+	}
 }
 
 template <typename T>
@@ -170,6 +192,29 @@ void RingBuffer<T>::popBack (int count)
 	m_numElements -= count;
 }
 
+template <typename T>
+T* RingBuffer<T>::getFreeSpan (int& numFree)
+{
+	// \note m_front == m_back is ambiguous, element count tells whether buffer is empty or full.
+	numFree = de::min(getNumFree(), m_size - m_front);
+	return m_buffer + m_front;
+}
+
+template <typename T>
+void RingBuffer<T>::commitFront (int count)
+{
+	DE_ASSERT(de::inRange(count, 0, de::min(getNumFree(), m_size - m_front)));
+	m_front = (m_front + count) % m_size;
+	m_numElements += count;
+}
+
+template <typename T>
+const T* RingBuffer<T>::getElementSpan (int& numElements) const
+{
+	numElements = de::min(getNumElements(), m_size - m_back);
+	return m_buffer + m_back;
+}
+
 } // de
 
 #endif // _DERINGBUFFER_HPP
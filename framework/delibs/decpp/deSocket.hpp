@@ -79,6 +79,7 @@ public:
 
 	deSocketState		getState			(void) const					{ return deSocket_getState(m_socket);				}
 	bool				isConnected			(void) const					{ return getState() == DE_SOCKETSTATE_CONNECTED;	}
+	deUintptr			getHandle			(void) const					{ return deSocket_getHandle(m_socket);				}
 
 	void				listen				(const SocketAddress& address);
 	Socket*				accept				(SocketAddress& clientAddress)	{ return accept(clientAddress.getPtr());			}
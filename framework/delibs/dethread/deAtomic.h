@@ -226,6 +226,24 @@ DE_INLINE size_t deAtomicDecrementUSize (volatile size_t* size)
 #endif
 }
 
+/*--------------------------------------------------------------------*//*!
+ * \brief Atomic compare and exchange (CAS) size_t.
+ * \param dstAddr	Destination address.
+ * \param compare	Old value.
+ * \param exchange	New value.
+ * \return			compare value if CAS passes, *dstAddr value otherwise
+ *//*--------------------------------------------------------------------*/
+DE_INLINE size_t deAtomicCompareExchangeUSize (volatile size_t* dstAddr, size_t compare, size_t exchange)
+{
+#if (DE_PTR_SIZE == 8)
+	return (size_t)deAtomicCompareExchangeUint64((volatile deUint64*)dstAddr, (deUint64)compare, (deUint64)exchange);
+#elif (DE_PTR_SIZE == 4)
+	return (size_t)deAtomicCompareExchangeUint32((volatile deUint32*)dstAddr, (deUint32)compare, (deUint32)exchange);
+#else
+#	error "Invalid DE_PTR_SIZE value"
+#endif
+}
+
 /*--------------------------------------------------------------------*//*!
  * \brief Atomic compare and exchange (CAS) pointer.
  * \param dstAddr	Destination address.
@@ -265,6 +283,76 @@ DE_INLINE void deMemoryReadWriteFence (void)
 #	error "Implement deMemoryReadWriteFence()"
 #endif
 
+/*--------------------------------------------------------------------*//*!
+ * \brief Atomic load size_t with acquire semantics.
+ *
+ * Memory accesses after the load can't be reordered before it.
+ *//*--------------------------------------------------------------------*/
+DE_INLINE size_t deAtomicLoadAcquireUSize (const volatile size_t* srcAddr)
+{
+#if (DE_COMPILER == DE_COMPILER_MSC)
+	const size_t value = *srcAddr;
+	deMemoryReadWriteFence();
+	return value;
+#elif (DE_COMPILER == DE_COMPILER_GCC) || (DE_COMPILER == DE_COMPILER_CLANG)
+	return __atomic_load_n(srcAddr, __ATOMIC_ACQUIRE);
+#else
+#	error "Implement deAtomicLoadAcquireUSize()"
+#endif
+}
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Atomic store size_t with release semantics.
+ *
+ * Memory accesses before the store can't be reordered after it.
+ *//*--------------------------------------------------------------------*/
+DE_INLINE void deAtomicStoreReleaseUSize (volatile size_t* dstAddr, size_t value)
+{
+#if (DE_COMPILER == DE_COMPILER_MSC)
+	deMemoryReadWriteFence();
+	*dstAddr = value;
+#elif (DE_COMPILER == DE_COMPILER_GCC) || (DE_COMPILER == DE_COMPILER_CLANG)
+	__atomic_store_n(dstAddr, value, __ATOMIC_RELEASE);
+#else
+#	error "Implement deAtomicStoreReleaseUSize()"
+#endif
+}
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Atomic load pointer with acquire semantics.
+ *
+ * Memory accesses after the load can't be reordered before it.
+ *//*--------------------------------------------------------------------*/
+DE_INLINE void* deAtomicLoadAcquirePtr (void* const volatile* srcAddr)
+{
+#if (DE_COMPILER == DE_COMPILER_MSC)
+	void* const value = *srcAddr;
+	deMemoryReadWriteFence();
+	return value;
+#elif (DE_COMPILER == DE_COMPILER_GCC) || (DE_COMPILER == DE_COMPILER_CLANG)
+	return __atomic_load_n(srcAddr, __ATOMIC_ACQUIRE);
+#else
+#	error "Implement deAtomicLoadAcquirePtr()"
+#endif
+}
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Atomic store pointer with release semantics.
+ *
+ * Memory accesses before the store can't be reordered after it.
+ *//*--------------------------------------------------------------------*/
+DE_INLINE void deAtomicStoreReleasePtr (void* volatile* dstAddr, void* value)
+{
+#if (DE_COMPILER == DE_COMPILER_MSC)
+	deMemoryReadWriteFence();
+	*dstAddr = value;
+#elif (DE_COMPILER == DE_COMPILER_GCC) || (DE_COMPILER == DE_COMPILER_CLANG)
+	__atomic_store_n(dstAddr, value, __ATOMIC_RELEASE);
+#else
+#	error "Implement deAtomicStoreReleasePtr()"
+#endif
+}
+
 DE_END_EXTERN_C
 
 #endif /* _DEATOMIC_H */
@@ -540,6 +540,24 @@ void deAtomic_selfTest (void)
 		DE_TEST_ASSERT(p == 8);
 	}
 
+	{
+		volatile size_t p;
+
+		p = 0;
+		DE_TEST_ASSERT(deAtomicCompareExchangeUSize(&p, 0, 1) == 0);
+		DE_TEST_ASSERT(p == 1);
+
+		DE_TEST_ASSERT(deAtomicCompareExchangeUSize(&p, 0, 2) == 1);
+		DE_TEST_ASSERT(p == 1);
+
+		p = (size_t)~0;
+		DE_TEST_ASSERT(deAtomicCompareExchangeUSize(&p, (size_t)~0, 3) == (size_t)~0);
+		DE_TEST_ASSERT(p == 3);
+
+		deAtomicStoreReleaseUSize(&p, 5);
+		DE_TEST_ASSERT(deAtomicLoadAcquireUSize(&p) == 5);
+	}
+
 #if (DE_PTR_SIZE == 8)
 	{
 		volatile deInt64 a = 11;
@@ -28,6 +28,7 @@
 
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/file.h>
 #include <fcntl.h>
 #include <unistd.h>
 #include <errno.h>
@@ -63,6 +64,11 @@ deFile* deFile_createFromHandle (deUintptr handle)
 	return file;
 }
 
+deUintptr deFile_getHandle (const deFile* file)
+{
+	return (deUintptr)file->fd;
+}
+
 static int mapOpenMode (deFileMode mode)
 {
 	int flag = 0;
@@ -204,6 +210,23 @@ deFileResult deFile_write (deFile* file, const void* buf, deInt64 bufSize, deInt
 	return mapReadWriteResult(numWritten);
 }
 
+deBool deFile_lock (deFile* file)
+{
+	int result;
+
+	do
+	{
+		result = flock(file->fd, LOCK_EX);
+	} while (result != 0 && errno == EINTR);
+
+	return result == 0;
+}
+
+deBool deFile_unlock (deFile* file)
+{
+	return flock(file->fd, LOCK_UN) == 0;
+}
+
 #elif (DE_OS == DE_OS_WIN32)
 
 #define VC_EXTRALEAN
@@ -238,6 +261,11 @@ deFile* deFile_createFromHandle (deUintptr handle)
 	return file;
 }
 
+deUintptr deFile_getHandle (const deFile* file)
+{
+	return (deUintptr)file->handle;
+}
+
 deFile* deFile_create (const char* filename, deUint32 mode)
 {
 	DWORD	access		= 0;
@@ -396,6 +424,24 @@ deFileResult deFile_write (deFile* file, const void* buf, deInt64 bufSize, deInt
 	return mapReadWriteResult(result, numWritten32);
 }
 
+deBool deFile_lock (deFile* file)
+{
+	OVERLAPPED overlapped;
+
+	deMemset(&overlapped, 0, sizeof(overlapped));
+
+	return LockFileEx(file->handle, LOCKFILE_EXCLUSIVE_LOCK, 0, MAXDWORD, MAXDWORD, &overlapped) == TRUE;
+}
+
+deBool deFile_unlock (deFile* file)
+{
+	OVERLAPPED overlapped;
+
+	deMemset(&overlapped, 0, sizeof(overlapped));
+
+	return UnlockFileEx(file->handle, 0, MAXDWORD, MAXDWORD, &overlapped) == TRUE;
+}
+
 #else
 #	error Implement deFile for your OS.
 #endif
@@ -71,6 +71,7 @@ deBool			deDeleteFile			(const char* filename);
 
 deFile*			deFile_create			(const char* filename, deUint32 mode);
 deFile*			deFile_createFromHandle	(deUintptr handle);
+deUintptr		deFile_getHandle		(const deFile* file);
 void			deFile_destroy			(deFile* file);
 
 deBool			deFile_setFlags			(deFile* file, deUint32 flags);
@@ -82,6 +83,10 @@ deInt64			deFile_getSize			(const deFile* file);
 deFileResult	deFile_read				(deFile* file, void* buf, deInt64 bufSize, deInt64* numRead);
 deFileResult	deFile_write			(deFile* file, const void* buf, deInt64 bufSize, deInt64* numWritten);
 
+/* Advisory whole-file lock, exclusive between processes. Blocks until lock is acquired. */
+deBool			deFile_lock				(deFile* file);
+deBool			deFile_unlock			(deFile* file);
+
 DE_END_EXTERN_C
 
 #endif /* _DEFILE_H */
@@ -0,0 +1,53 @@
+#ifndef _DEMAPPEDFILE_H
+#define _DEMAPPEDFILE_H
+/*-------------------------------------------------------------------------
+ * drawElements Utility Library
+ * ----------------------------
+ *
+ * Copyright 2020 The Khronos Group Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *//*!
+ * \file
+ * \brief Read-only memory mapped file.
+ *//*--------------------------------------------------------------------*/
+
+#include "deDefs.h"
+
+DE_BEGIN_EXTERN_C
+
+typedef struct deMappedFile_s deMappedFile;
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Map whole file into memory for reading.
+ *
+ * The mapping is shared, so multiple processes mapping the same file will
+ * share the pages through the OS page cache. Size of the mapping is fixed
+ * at creation time; data appended to the file later is not visible.
+ *
+ * Mapping an empty file succeeds, in which case getPtr() returns DE_NULL
+ * and getSize() returns 0.
+ *
+ * \param filename File to map
+ * \return Mapped file or DE_NULL if the file couldn't be opened or mapped
+ *//*--------------------------------------------------------------------*/
+deMappedFile*	deMappedFile_create		(const char* filename);
+void			deMappedFile_destroy	(deMappedFile* file);
+
+const void*		deMappedFile_getPtr		(const deMappedFile* file);
+deInt64			deMappedFile_getSize	(const deMappedFile* file);
+
+DE_END_EXTERN_C
+
+#endif /* _DEMAPPEDFILE_H */
@@ -445,6 +445,11 @@ deUint32 deSocket_getOpenChannels (const deSocket* sock)
 	return sock->openChannels;
 }
 
+deUintptr deSocket_getHandle (const deSocket* sock)
+{
+	return (deUintptr)sock->handle;
+}
+
 deBool deSocket_setFlags (deSocket* sock, deUint32 flags)
 {
 	deSocketHandle fd = sock->handle;
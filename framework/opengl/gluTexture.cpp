@@ -27,6 +27,7 @@
 #include "tcuImageIO.hpp"
 #include "tcuSurface.hpp"
 #include "tcuTextureUtil.hpp"
+#include "tcuDecompressedTextureCache.hpp"
 
 #include "glwFunctions.hpp"
 #include "glwEnums.hpp"
@@ -201,7 +202,7 @@ void Texture2D::loadCompressed (int numLevels, const tcu::CompressedTexture* lev
 		tcu::PixelBufferAccess refLevelAccess = m_refTexture.getLevel(levelNdx);
 		TCU_CHECK(level.getWidth()	== refLevelAccess.getWidth() &&
 				  level.getHeight()	== refLevelAccess.getHeight());
-		level.decompress(refLevelAccess, decompressionParams);
+		tcu::DecompressedTextureCache::getInstance().decompress(refLevelAccess, level, decompressionParams);
 
 		// Upload to GL texture in compressed form.
 		gl.compressedTexImage2D(GL_TEXTURE_2D, levelNdx, compressedFormat,
@@ -425,7 +426,7 @@ void TextureCube::loadCompressed (int numLevels, const tcu::CompressedTexture* l
 			tcu::PixelBufferAccess refLevelAccess = m_refTexture.getLevelFace(levelNdx, (tcu::CubeFace)face);
 			TCU_CHECK(level.getWidth()	== refLevelAccess.getWidth() &&
 					  level.getHeight()	== refLevelAccess.getHeight());
-			level.decompress(refLevelAccess, decompressionParams);
+			tcu::DecompressedTextureCache::getInstance().decompress(refLevelAccess, level, decompressionParams);
 
 			// Upload to GL texture in compressed form.
 			gl.compressedTexImage2D(getGLCubeFace((tcu::CubeFace)face), levelNdx, compressedFormat,
@@ -630,7 +631,7 @@ void Texture2DArray::loadCompressed (int numLevels, const tcu::CompressedTexture
 		TCU_CHECK(level.getWidth()	== refLevelAccess.getWidth() &&
 				  level.getHeight()	== refLevelAccess.getHeight() &&
 				  level.getDepth()	== refLevelAccess.getDepth());
-		level.decompress(refLevelAccess, decompressionParams);
+		tcu::DecompressedTextureCache::getInstance().decompress(refLevelAccess, level, decompressionParams);
 
 		// Upload to GL texture in compressed form.
 		gl.compressedTexImage3D(GL_TEXTURE_2D_ARRAY, levelNdx, compressedFormat,
@@ -755,7 +756,7 @@ void Texture3D::loadCompressed (int numLevels, const tcu::CompressedTexture* lev
 		TCU_CHECK(level.getWidth()	== refLevelAccess.getWidth() &&
 				  level.getHeight()	== refLevelAccess.getHeight() &&
 				  level.getDepth()	== refLevelAccess.getDepth());
-		level.decompress(refLevelAccess, decompressionParams);
+		tcu::DecompressedTextureCache::getInstance().decompress(refLevelAccess, level, decompressionParams);
 
 		// Upload to GL texture in compressed form.
 		gl.compressedTexImage3D(GL_TEXTURE_3D, levelNdx, compressedFormat,
@@ -398,6 +398,8 @@ ReferenceContext::ReferenceContext (const ReferenceContextLimits& limits, const
 	, m_primitiveRestartIndex			(0)
 
 	, m_lastError						(GL_NO_ERROR)
+
+	, m_renderer						(rr::RENDEREXECMODE_PARALLEL)
 {
 	// Create empty textures to be used when texture objects are incomplete.
 	m_emptyTex1D.getSampler().wrapS		= tcu::Sampler::CLAMP_TO_EDGE;
@@ -4329,7 +4331,6 @@ void ReferenceContext::drawWithReference (const rr::PrimitiveList& primitives, i
 													 (m_currentProgram->m_program->m_hasGeometryShader) ? (m_currentProgram->m_program->getGeometryShader()) : (DE_NULL));
 	rr::RenderState						state		((rr::ViewportState)(colorBuf0), m_limits.subpixelBits);
 
-	const rr::Renderer					referenceRenderer;
 	std::vector<rr::VertexAttrib>		vertexAttribs;
 
 	// Gen state
@@ -4567,7 +4568,7 @@ void ReferenceContext::drawWithReference (const rr::PrimitiveList& primitives, i
 		}
 	}
 
-	referenceRenderer.drawInstanced(rr::DrawCommand(state, renderTarget, program, (int)vertexAttribs.size(), &vertexAttribs[0], primitives), instanceCount);
+	m_renderer.drawInstanced(rr::DrawCommand(state, renderTarget, program, (int)vertexAttribs.size(), &vertexAttribs[0], primitives), instanceCount);
 }
 
 deUint32 ReferenceContext::createProgram (ShaderProgram* program)
@@ -963,6 +963,7 @@ private:
 
 	deUint32									m_lastError;
 
+	const rr::Renderer							m_renderer;
 	rr::FragmentProcessor						m_fragmentProcessor;
 	std::vector<rr::Fragment>					m_fragmentBuffer;
 	std::vector<float>							m_fragmentDepths;
@@ -28,6 +28,7 @@
 #include "tcuResource.hpp"
 #include "tcuTestLog.hpp"
 #include "tcuTestSessionExecutor.hpp"
+#include "tcuSubprocessRunner.hpp"
 #include "deUniquePtr.hpp"
 
 #include <cstdio>
@@ -47,6 +48,20 @@ int main (int argc, char** argv)
 	try
 	{
 		tcu::CommandLine				cmdLine		(argc, argv);
+
+		if (cmdLine.getRunMode() == tcu::RUNMODE_EXECUTE && cmdLine.getSubprocessCount() > 0)
+		{
+			// Run cases in child processes, no platform is needed here.
+			tcu::SubprocessRunner runner (cmdLine, argc, argv);
+
+			runner.run();
+
+			if (!runner.getResult().isComplete || runner.getResult().numFailed)
+				exitStatus = EXIT_FAILURE;
+
+			return exitStatus;
+		}
+
 		tcu::DirArchive					archive		(cmdLine.getArchiveDir());
 		tcu::TestLog					log			(cmdLine.getLogFileName(), cmdLine.getLogFlags());
 		de::UniquePtr<tcu::Platform>	platform	(createPlatform());
@@ -31,6 +31,9 @@
 #include "deString.h"
 
 #include "deMutex.h"
+#include "deThread.h"
+#include "deSemaphore.h"
+#include "deAtomic.h"
 
 #if defined(QP_SUPPORT_PNG)
 #	include <png.h>
@@ -119,6 +122,14 @@ DE_INLINE ContainerType ContainerStack_getTop (const ContainerStack* stack)
 
 #endif
 
+enum
+{
+	MAX_IMAGE_COMPRESSION_THREADS	= 4,
+	MAX_PENDING_IMAGES				= 16	/*!< Image writes block when this many images are waiting to be written. */
+};
+
+typedef struct ImageJob_s ImageJob;
+
 /* qpTestLog instance */
 struct qpTestLog_s
 {
@@ -135,8 +146,35 @@ struct qpTestLog_s
 #if defined(DE_DEBUG)
 	ContainerStack			containerStack;		/*!< For container usage verification.	*/
 #endif
+
+	/* Asynchronous image compression, see writeImageAsync(). */
+	int						numImageThreads;	/*!< Number of compression threads, 0 if images are compressed synchronously. */
+	deBool					imageThreadsStarted;
+	deBool					syncImages;			/*!< Set after abrupt termination.		*/
+	ImageJob*				pendingImages[MAX_PENDING_IMAGES];	/*!< Images not written yet, in log order. */
+	int						numPendingImages;
+
+	/* Compression queue, protected by imageQueueLock. */
+	deThread				imageThreads[MAX_IMAGE_COMPRESSION_THREADS];
+	deMutex					imageQueueLock;
+	deSemaphore				imageQueueSem;		/*!< Number of jobs in queue.			*/
+	ImageJob*				imageQueue[MAX_PENDING_IMAGES + MAX_IMAGE_COMPRESSION_THREADS];
+	int						imageQueueHead;
+	int						imageQueueSize;
 };
 
+static void flushPendingImages (qpTestLog* log, deBool sync);
+static void stopImageThreads (qpTestLog* log);
+
+/* Acquire log lock for writing. Images still being compressed are written first to keep records in order. */
+static void lockLog (qpTestLog* log)
+{
+	deMutex_lock(log->lock);
+
+	if (log->numPendingImages > 0)
+		flushPendingImages(log, DE_FALSE);
+}
+
 /* Maps integer to string. */
 typedef struct qpKeyStringMap_s
 {
@@ -146,6 +184,11 @@ typedef struct qpKeyStringMap_s
 
 static const char* LOG_FORMAT_VERSION = "0.3.4";
 
+enum
+{
+	BINARY_LOG_BUFFER_SIZE	= 1024*1024
+};
+
 /* Mapping enum to above strings... */
 static const qpKeyStringMap s_qpTestTypeMap[] =
 {
@@ -307,7 +350,7 @@ static deBool endSession (qpTestLog* log)
 	qpXmlWriter_flush(log->writer);
 
 	/* Write out #endSession. */
-	fprintf(log->outputFile, "\n#endSession\n");
+	qpXmlWriter_writeRaw(log->writer, "\n#endSession\n");
 	qpTestLog_flushFile(log);
 
 	log->isSessionOpen = DE_FALSE;
@@ -344,11 +387,26 @@ qpTestLog* qpTestLog_createFileLog (const char* fileName, deUint32 flags)
 	}
 
 	log->flags			= flags;
-	log->writer			= qpXmlWriter_createFileWriter(log->outputFile, 0, !(flags & QP_TEST_LOG_NO_FLUSH));
+
+	if (flags & QP_TEST_LOG_BINARY)
+	{
+		/* Records are small and frequent, leave flushing to case boundaries. */
+		setvbuf(log->outputFile, DE_NULL, _IOFBF, BINARY_LOG_BUFFER_SIZE);
+		log->writer		= qpXmlWriter_createBinaryFileWriter(log->outputFile, DE_TRUE);
+	}
+	else
+		log->writer		= qpXmlWriter_createFileWriter(log->outputFile, 0, !(flags & QP_TEST_LOG_NO_FLUSH));
+
 	log->lock			= deMutex_create(DE_NULL);
 	log->isSessionOpen	= DE_FALSE;
 	log->isCaseOpen		= DE_FALSE;
 
+#if defined(QP_SUPPORT_PNG)
+	/* Binary logs don't use PNG compression. */
+	if ((flags & (QP_TEST_LOG_SYNC_IMAGES|QP_TEST_LOG_EXCLUDE_IMAGES|QP_TEST_LOG_BINARY)) == 0 && deGetNumAvailableLogicalCores() > 1)
+		log->numImageThreads = deMin32((int)deGetNumAvailableLogicalCores(), MAX_IMAGE_COMPRESSION_THREADS);
+#endif
+
 	if (!log->writer)
 	{
 		qpPrintf("ERROR: Unable to create output XML writer to file '%s'.\n", fileName);
@@ -373,6 +431,8 @@ qpTestLog* qpTestLog_createFileLog (const char* fileName, deUint32 flags)
  *//*--------------------------------------------------------------------*/
 deBool qpTestLog_beginSession(qpTestLog* log, const char* additionalSessionInfo)
 {
+	char releaseIdStr[32];
+
 	DE_ASSERT(log);
 
 	/* Make sure this function is called once*/
@@ -380,15 +440,24 @@ deBool qpTestLog_beginSession(qpTestLog* log, const char* additionalSessionInfo)
 		return DE_TRUE;
 
 	/* Write session info. */
-	fprintf(log->outputFile, "#sessionInfo releaseName %s\n", qpGetReleaseName());
-	fprintf(log->outputFile, "#sessionInfo releaseId 0x%08x\n", qpGetReleaseId());
-	fprintf(log->outputFile, "#sessionInfo targetName \"%s\"\n", qpGetTargetName());
+	deSprintf(releaseIdStr, sizeof(releaseIdStr), "0x%08x", qpGetReleaseId());
+
+	qpXmlWriter_writeRaw(log->writer, "#sessionInfo releaseName ");
+	qpXmlWriter_writeRaw(log->writer, qpGetReleaseName());
+	qpXmlWriter_writeRaw(log->writer, "\n#sessionInfo releaseId ");
+	qpXmlWriter_writeRaw(log->writer, releaseIdStr);
+	qpXmlWriter_writeRaw(log->writer, "\n#sessionInfo targetName \"");
+	qpXmlWriter_writeRaw(log->writer, qpGetTargetName());
+	qpXmlWriter_writeRaw(log->writer, "\"\n");
 
 	if (strlen(additionalSessionInfo) > 1)
-		fprintf(log->outputFile, "%s\n", additionalSessionInfo);
+	{
+		qpXmlWriter_writeRaw(log->writer, additionalSessionInfo);
+		qpXmlWriter_writeRaw(log->writer, "\n");
+	}
 
 	/* Write out #beginSession. */
-	fprintf(log->outputFile, "#beginSession\n");
+	qpXmlWriter_writeRaw(log->writer, "#beginSession\n");
 	qpTestLog_flushFile(log);
 
 	log->isSessionOpen = DE_TRUE;
@@ -404,6 +473,11 @@ void qpTestLog_destroy (qpTestLog* log)
 {
 	DE_ASSERT(log);
 
+	if (log->numPendingImages > 0)
+		flushPendingImages(log, DE_FALSE);
+
+	stopImageThreads(log);
+
 	if (log->isSessionOpen)
 		endSession(log);
 
@@ -433,14 +507,16 @@ deBool qpTestLog_startCase (qpTestLog* log, const char* testCasePath, qpTestCase
 	qpXmlAttribute	resultAttribs[8];
 
 	DE_ASSERT(log && testCasePath && (testCasePath[0] != 0));
-	deMutex_lock(log->lock);
+	lockLog(log);
 
 	DE_ASSERT(!log->isCaseOpen);
 	DE_ASSERT(ContainerStack_isEmpty(&log->containerStack));
 
 	/* Flush XML and write out #beginTestCaseResult. */
 	qpXmlWriter_flush(log->writer);
-	fprintf(log->outputFile, "\n#beginTestCaseResult %s\n", testCasePath);
+	qpXmlWriter_writeRaw(log->writer, "\n#beginTestCaseResult ");
+	qpXmlWriter_writeRaw(log->writer, testCasePath);
+	qpXmlWriter_writeRaw(log->writer, "\n");
 	if (!(log->flags & QP_TEST_LOG_NO_FLUSH))
 		qpTestLog_flushFile(log);
 
@@ -475,7 +551,7 @@ deBool qpTestLog_endCase (qpTestLog* log, qpTestResult result, const char* resul
 	const char*		statusStr		= QP_LOOKUP_STRING(s_qpTestResultMap, result);
 	qpXmlAttribute	statusAttrib	= qpSetStringAttrib("StatusCode", statusStr);
 
-	deMutex_lock(log->lock);
+	lockLog(log);
 
 	DE_ASSERT(log->isCaseOpen);
 	DE_ASSERT(ContainerStack_isEmpty(&log->containerStack));
@@ -496,7 +572,7 @@ deBool qpTestLog_endCase (qpTestLog* log, qpTestResult result, const char* resul
 
 	/* Flush XML and write #endTestCaseResult. */
 	qpXmlWriter_flush(log->writer);
-	fprintf(log->outputFile, "\n#endTestCaseResult\n");
+	qpXmlWriter_writeRaw(log->writer, "\n#endTestCaseResult\n");
 	if (!(log->flags & QP_TEST_LOG_NO_FLUSH))
 		qpTestLog_flushFile(log);
 
@@ -509,11 +585,11 @@ deBool qpTestLog_endCase (qpTestLog* log, qpTestResult result, const char* resul
 deBool qpTestLog_startTestsCasesTime (qpTestLog* log)
 {
 	DE_ASSERT(log);
-	deMutex_lock(log->lock);
+	lockLog(log);
 
 	/* Flush XML and write out #beginTestCaseResult. */
 	qpXmlWriter_flush(log->writer);
-	fprintf(log->outputFile, "\n#beginTestsCasesTime\n");
+	qpXmlWriter_writeRaw(log->writer, "\n#beginTestsCasesTime\n");
 
 	log->isCaseOpen = DE_TRUE;
 
@@ -532,7 +608,7 @@ deBool qpTestLog_startTestsCasesTime (qpTestLog* log)
 deBool qpTestLog_endTestsCasesTime (qpTestLog* log)
 {
 	DE_ASSERT(log);
-	deMutex_lock(log->lock);
+	lockLog(log);
 
 	DE_ASSERT(log->isCaseOpen);
 
@@ -546,7 +622,7 @@ deBool qpTestLog_endTestsCasesTime (qpTestLog* log)
 
 	qpXmlWriter_flush(log->writer);
 
-	fprintf(log->outputFile, "\n#endTestsCasesTime\n");
+	qpXmlWriter_writeRaw(log->writer, "\n#endTestsCasesTime\n");
 
 	log->isCaseOpen = DE_FALSE;
 
@@ -570,6 +646,10 @@ deBool qpTestLog_terminateCase (qpTestLog* log, qpTestResult result)
 
 	deMutex_lock(log->lock);
 
+	/* Compression threads may not make progress anymore, write pending images synchronously. */
+	flushPendingImages(log, DE_TRUE);
+	log->syncImages = DE_TRUE;
+
 	if (!log->isCaseOpen)
 	{
 		deMutex_unlock(log->lock);
@@ -578,7 +658,9 @@ deBool qpTestLog_terminateCase (qpTestLog* log, qpTestResult result)
 
 	/* Flush XML and write #terminateTestCaseResult. */
 	qpXmlWriter_flush(log->writer);
-	fprintf(log->outputFile, "\n#terminateTestCaseResult %s\n", resultStr);
+	qpXmlWriter_writeRaw(log->writer, "\n#terminateTestCaseResult ");
+	qpXmlWriter_writeRaw(log->writer, resultStr);
+	qpXmlWriter_writeRaw(log->writer, "\n");
 	qpTestLog_flushFile(log);
 
 	log->isCaseOpen = DE_FALSE;
@@ -598,7 +680,7 @@ static deBool qpTestLog_writeKeyValuePair (qpTestLog* log, const char* elementNa
 	int				numAttribs = 0;
 
 	DE_ASSERT(log && elementName && text);
-	deMutex_lock(log->lock);
+	lockLog(log);
 
 	/* Fill in attributes. */
 	if (name)			attribs[numAttribs++] = qpSetStringAttrib("Name", name);
@@ -805,6 +887,317 @@ static deBool compressImagePNG (Buffer* buffer, qpImageFormat imageFormat, int w
 }
 #endif /* QP_SUPPORT_PNG */
 
+/* Write <Image> element. Log lock must be held. */
+static deBool writeImageElement (qpTestLog* log, const char* name, const char* description, qpImageCompressionMode compressionMode, qpImageFormat imageFormat, int width, int height, const void* data, size_t numBytes)
+{
+	char			widthStr[32];
+	char			heightStr[32];
+	qpXmlAttribute	attribs[8];
+	int				numAttribs	= 0;
+
+	/* Fill in attributes. */
+	int32ToString(width, widthStr);
+	int32ToString(height, heightStr);
+	attribs[numAttribs++] = qpSetStringAttrib("Name", name);
+	attribs[numAttribs++] = qpSetStringAttrib("Width", widthStr);
+	attribs[numAttribs++] = qpSetStringAttrib("Height", heightStr);
+	attribs[numAttribs++] = qpSetStringAttrib("Format", QP_LOOKUP_STRING(s_qpImageFormatMap, imageFormat));
+	attribs[numAttribs++] = qpSetStringAttrib("CompressionMode", QP_LOOKUP_STRING(s_qpImageCompressionModeMap, compressionMode));
+	if (description) attribs[numAttribs++] = qpSetStringAttrib("Description", description);
+
+	/* <Image ID="result" Name="Foobar" Width="640" Height="480" Format="RGB888" CompressionMode="None">base64 data</Image> */
+	if (!qpXmlWriter_startElement(log->writer, "Image", numAttribs, attribs) ||
+		!qpXmlWriter_writeBase64(log->writer, (const deUint8*)data, numBytes) ||
+		!qpXmlWriter_endElement(log->writer, "Image"))
+	{
+		qpPrintf("qpTestLog_writeImage(): Writing XML failed\n");
+		return DE_FALSE;
+	}
+
+	return DE_TRUE;
+}
+
+/* Asynchronous image compression.
+ *
+ * PNG compressed images are copied into jobs that are compressed by a small
+ * pool of threads. Jobs are kept in log order in pendingImages and written
+ * out once the next record is written (see lockLog()), so the output is
+ * identical to compressing synchronously. */
+
+typedef enum ImageJobState_e
+{
+	IMAGEJOBSTATE_PENDING = 0,		/*!< Waiting for a compression thread.				*/
+	IMAGEJOBSTATE_RUNNING,			/*!< Being compressed.								*/
+	IMAGEJOBSTATE_DONE,				/*!< Compressed data is ready.						*/
+	IMAGEJOBSTATE_ABANDONED,		/*!< Written uncompressed, compression not needed.	*/
+
+	IMAGEJOBSTATE_LAST
+} ImageJobState;
+
+struct ImageJob_s
+{
+	volatile deUint32	state;			/*!< ImageJobState.								*/
+	volatile deInt32	refCount;		/*!< References from log and compression queue.	*/
+	deSemaphore			done;			/*!< Signaled when compression has finished.	*/
+
+	char*				name;
+	char*				description;
+	qpImageFormat		imageFormat;
+	int					width;
+	int					height;
+	Buffer				pixels;			/*!< Tightly packed copy of pixel data.			*/
+
+	Buffer				compressed;
+	deBool				compressOk;
+};
+
+static void ImageJob_release (ImageJob* job)
+{
+	if (deAtomicDecrementInt32(&job->refCount) == 0)
+	{
+		if (job->done)
+			deSemaphore_destroy(job->done);
+
+		deFree(job->name);
+		deFree(job->description);
+		Buffer_deinit(&job->pixels);
+		Buffer_deinit(&job->compressed);
+		deFree(job);
+	}
+}
+
+static void pushImageQueue (qpTestLog* log, ImageJob* job)
+{
+	const int queueSize = DE_LENGTH_OF_ARRAY(log->imageQueue);
+
+	deMutex_lock(log->imageQueueLock);
+	DE_ASSERT(log->imageQueueSize < queueSize);
+	log->imageQueue[(log->imageQueueHead + log->imageQueueSize) % queueSize] = job;
+	log->imageQueueSize += 1;
+	deMutex_unlock(log->imageQueueLock);
+
+	deSemaphore_increment(log->imageQueueSem);
+}
+
+static ImageJob* popImageQueue (qpTestLog* log)
+{
+	ImageJob* job;
+
+	deSemaphore_decrement(log->imageQueueSem);
+
+	deMutex_lock(log->imageQueueLock);
+	DE_ASSERT(log->imageQueueSize > 0);
+	job = log->imageQueue[log->imageQueueHead];
+	log->imageQueueHead	 = (log->imageQueueHead + 1) % DE_LENGTH_OF_ARRAY(log->imageQueue);
+	log->imageQueueSize	-= 1;
+	deMutex_unlock(log->imageQueueLock);
+
+	return job;
+}
+
+#if defined(QP_SUPPORT_PNG)
+static void imageCompressionThread (void* arg)
+{
+	qpTestLog* log = (qpTestLog*)arg;
+
+	for (;;)
+	{
+		ImageJob* job = popImageQueue(log);
+
+		if (!job)
+			break; /* Log is being destroyed. */
+
+		if (deAtomicCompareExchangeUint32(&job->state, IMAGEJOBSTATE_PENDING, IMAGEJOBSTATE_RUNNING) == IMAGEJOBSTATE_PENDING)
+		{
+			const int pixelSize = job->imageFormat == QP_IMAGE_FORMAT_RGB888 ? 3 : 4;
+
+			job->compressOk = compressImagePNG(&job->compressed, job->imageFormat, job->width, job->height, pixelSize*job->width, job->pixels.data);
+
+			deAtomicCompareExchangeUint32(&job->state, IMAGEJOBSTATE_RUNNING, IMAGEJOBSTATE_DONE);
+			deSemaphore_increment(job->done);
+		}
+
+		ImageJob_release(job);
+	}
+}
+#endif
+
+static deBool startImageThreads (qpTestLog* log)
+{
+#if defined(QP_SUPPORT_PNG)
+	int ndx;
+
+	if (log->imageThreadsStarted)
+		return DE_TRUE;
+
+	log->imageQueueLock	= deMutex_create(DE_NULL);
+	log->imageQueueSem	= deSemaphore_create(0, DE_NULL);
+
+	if (!log->imageQueueLock || !log->imageQueueSem)
+	{
+		qpPrintf("WARNING: Failed to start image compression threads -- compressing images synchronously.\n");
+		stopImageThreads(log);
+		log->numImageThreads = 0;
+		return DE_FALSE;
+	}
+
+	for (ndx = 0; ndx < log->numImageThreads; ndx++)
+	{
+		log->imageThreads[ndx] = deThread_create(imageCompressionThread, log, DE_NULL);
+
+		if (!log->imageThreads[ndx])
+		{
+			/* Use threads started so far. */
+			log->numImageThreads = ndx;
+			break;
+		}
+	}
+
+	log->imageThreadsStarted = DE_TRUE;
+
+	if (log->numImageThreads == 0)
+	{
+		stopImageThreads(log);
+		return DE_FALSE;
+	}
+
+	return DE_TRUE;
+#else
+	DE_UNREF(log);
+	return DE_FALSE;
+#endif
+}
+
+static void stopImageThreads (qpTestLog* log)
+{
+	int ndx;
+
+	DE_ASSERT(log->numPendingImages == 0);
+
+	for (ndx = 0; ndx < log->numImageThreads && log->imageThreadsStarted; ndx++)
+		pushImageQueue(log, DE_NULL);
+
+	for (ndx = 0; ndx < log->numImageThreads && log->imageThreadsStarted; ndx++)
+	{
+		deThread_join(log->imageThreads[ndx]);
+		deThread_destroy(log->imageThreads[ndx]);
+	}
+
+	if (log->imageQueueSem)
+		deSemaphore_destroy(log->imageQueueSem);
+
+	if (log->imageQueueLock)
+		deMutex_destroy(log->imageQueueLock);
+
+	log->imageQueueSem			= 0;
+	log->imageQueueLock			= 0;
+	log->imageThreadsStarted	= DE_FALSE;
+}
+
+static void writePendingImage (qpTestLog* log, ImageJob* job, deBool sync)
+{
+	deBool compressed = DE_FALSE;
+
+	if (sync)
+	{
+		/* Use compressed data only if it is already available. */
+		const deUint32 prevState = deAtomicCompareExchangeUint32(&job->state, IMAGEJOBSTATE_PENDING, IMAGEJOBSTATE_ABANDONED);
+		compressed = prevState == IMAGEJOBSTATE_DONE;
+	}
+	else
+	{
+		deSemaphore_decrement(job->done);
+		compressed = DE_TRUE;
+	}
+
+	if (compressed && !job->compressOk)
+	{
+		qpPrintf("WARNING: PNG compression failed -- storing image uncompressed.\n");
+		compressed = DE_FALSE;
+	}
+
+	if (compressed)
+		writeImageElement(log, job->name, job->description, QP_IMAGE_COMPRESSION_MODE_PNG, job->imageFormat, job->width, job->height, job->compressed.data, job->compressed.size);
+	else
+		writeImageElement(log, job->name, job->description, QP_IMAGE_COMPRESSION_MODE_NONE, job->imageFormat, job->width, job->height, job->pixels.data, job->pixels.size);
+
+	ImageJob_release(job);
+}
+
+static void flushPendingImages (qpTestLog* log, deBool sync)
+{
+	int ndx;
+
+	for (ndx = 0; ndx < log->numPendingImages; ndx++)
+		writePendingImage(log, log->pendingImages[ndx], sync);
+
+	log->numPendingImages = 0;
+}
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Queue image for PNG compression
+ *
+ * Pixel data is copied, so caller may release it immediately.
+ *
+ * \return true if image was queued, false if it must be written synchronously
+ *//*--------------------------------------------------------------------*/
+static deBool writeImageAsync (qpTestLog* log, const char* name, const char* description, qpImageFormat imageFormat, int width, int height, int stride, const void* data)
+{
+	const int	pixelSize		= imageFormat == QP_IMAGE_FORMAT_RGB888 ? 3 : 4;
+	const int	packedStride	= pixelSize*width;
+	ImageJob*	job				= (ImageJob*)deCalloc(sizeof(ImageJob));
+	int			row;
+
+	if (!job)
+		return DE_FALSE;
+
+	job->state			= IMAGEJOBSTATE_PENDING;
+	job->refCount		= 1;
+	job->done			= deSemaphore_create(0, DE_NULL);
+	job->name			= deStrdup(name);
+	job->description	= description ? deStrdup(description) : DE_NULL;
+	job->imageFormat	= imageFormat;
+	job->width			= width;
+	job->height			= height;
+
+	Buffer_init(&job->pixels);
+	Buffer_init(&job->compressed);
+
+	if (!job->done || !job->name || (description && !job->description) || !Buffer_resize(&job->pixels, (size_t)(packedStride*height)))
+	{
+		ImageJob_release(job);
+		return DE_FALSE;
+	}
+
+	for (row = 0; row < height; row++)
+		memcpy(&job->pixels.data[packedStride*row], &((const deUint8*)data)[row*stride], (size_t)packedStride);
+
+	deMutex_lock(log->lock);
+
+	if (log->syncImages || !startImageThreads(log))
+	{
+		deMutex_unlock(log->lock);
+		ImageJob_release(job);
+		return DE_FALSE;
+	}
+
+	/* Bound memory use by waiting for the oldest image. */
+	if (log->numPendingImages == MAX_PENDING_IMAGES)
+	{
+		writePendingImage(log, log->pendingImages[0], DE_FALSE);
+		memmove(&log->pendingImages[0], &log->pendingImages[1], sizeof(ImageJob*)*(MAX_PENDING_IMAGES-1));
+		log->numPendingImages -= 1;
+	}
+
+	/* One reference for the log, one for the compression queue. */
+	job->refCount = 2;
+	log->pendingImages[log->numPendingImages++] = job;
+	pushImageQueue(log, job);
+
+	deMutex_unlock(log->lock);
+	return DE_TRUE;
+}
+
 /*--------------------------------------------------------------------*//*!
  * \brief Start image set
  * \param log			qpTestLog instance
@@ -818,7 +1211,7 @@ deBool qpTestLog_startImageSet (qpTestLog* log, const char* name, const char* de
 	int				numAttribs = 0;
 
 	DE_ASSERT(log && name);
-	deMutex_lock(log->lock);
+	lockLog(log);
 
 	attribs[numAttribs++] = qpSetStringAttrib("Name", name);
 	if (description)
@@ -846,7 +1239,7 @@ deBool qpTestLog_startImageSet (qpTestLog* log, const char* name, const char* de
 deBool qpTestLog_endImageSet (qpTestLog* log)
 {
 	DE_ASSERT(log);
-	deMutex_lock(log->lock);
+	lockLog(log);
 
 	/* <ImageSet Name="<name>"> */
 	if (!qpXmlWriter_endElement(log->writer, "ImageSet"))
@@ -886,10 +1279,6 @@ deBool qpTestLog_writeImage	(
 	int						stride,
 	const void*				data)
 {
-	char			widthStr[32];
-	char			heightStr[32];
-	qpXmlAttribute	attribs[8];
-	int				numAttribs			= 0;
 	Buffer			compressedBuffer;
 	const void*		writeDataPtr		= DE_NULL;
 	size_t			writeDataBytes		= ~(size_t)0;
@@ -904,6 +1293,10 @@ deBool qpTestLog_writeImage	(
 
 	Buffer_init(&compressedBuffer);
 
+	/* Binary log writer deflates data blocks, which is much cheaper than PNG encoding. */
+	if (log->flags & QP_TEST_LOG_BINARY)
+		compressionMode = QP_IMAGE_COMPRESSION_MODE_NONE;
+
 	/* BEST compression mode defaults to PNG. */
 	if (compressionMode == QP_IMAGE_COMPRESSION_MODE_BEST)
 	{
@@ -915,6 +1308,13 @@ deBool qpTestLog_writeImage	(
 	}
 
 #if defined(QP_SUPPORT_PNG)
+	/* Compress in background if possible. */
+	if (compressionMode == QP_IMAGE_COMPRESSION_MODE_PNG && log->numImageThreads > 0)
+	{
+		if (writeImageAsync(log, name, description, imageFormat, width, height, stride, data))
+			return DE_TRUE;
+	}
+
 	/* Try storing with PNG compression. */
 	if (compressionMode == QP_IMAGE_COMPRESSION_MODE_PNG)
 	{
@@ -976,25 +1376,11 @@ deBool qpTestLog_writeImage	(
 			return DE_FALSE;
 	}
 
-	/* Fill in attributes. */
-	int32ToString(width, widthStr);
-	int32ToString(height, heightStr);
-	attribs[numAttribs++] = qpSetStringAttrib("Name", name);
-	attribs[numAttribs++] = qpSetStringAttrib("Width", widthStr);
-	attribs[numAttribs++] = qpSetStringAttrib("Height", heightStr);
-	attribs[numAttribs++] = qpSetStringAttrib("Format", QP_LOOKUP_STRING(s_qpImageFormatMap, imageFormat));
-	attribs[numAttribs++] = qpSetStringAttrib("CompressionMode", QP_LOOKUP_STRING(s_qpImageCompressionModeMap, compressionMode));
-	if (description) attribs[numAttribs++] = qpSetStringAttrib("Description", description);
-
 	/* \note Log lock is acquired after compression! */
-	deMutex_lock(log->lock);
+	lockLog(log);
 
-	/* <Image ID="result" Name="Foobar" Width="640" Height="480" Format="RGB888" CompressionMode="None">base64 data</Image> */
-	if (!qpXmlWriter_startElement(log->writer, "Image", numAttribs, attribs) ||
-		!qpXmlWriter_writeBase64(log->writer, (const deUint8*)writeDataPtr, writeDataBytes) ||
-		!qpXmlWriter_endElement(log->writer, "Image"))
+	if (!writeImageElement(log, name, description, compressionMode, imageFormat, width, height, writeDataPtr, writeDataBytes))
 	{
-		qpPrintf("qpTestLog_writeImage(): Writing XML failed\n");
 		deMutex_unlock(log->lock);
 		Buffer_deinit(&compressedBuffer);
 		return DE_FALSE;
@@ -1036,7 +1422,7 @@ deBool qpTestLog_startShaderProgram (qpTestLog* log, deBool linkOk, const char*
 	int				numProgramAttribs = 0;
 
 	DE_ASSERT(log);
-	deMutex_lock(log->lock);
+	lockLog(log);
 
 	programAttribs[numProgramAttribs++] = qpSetStringAttrib("LinkStatus", linkOk ? "OK" : "Fail");
 
@@ -1062,7 +1448,7 @@ deBool qpTestLog_startShaderProgram (qpTestLog* log, deBool linkOk, const char*
 deBool qpTestLog_endShaderProgram (qpTestLog* log)
 {
 	DE_ASSERT(log);
-	deMutex_lock(log->lock);
+	lockLog(log);
 
 	/* </ShaderProgram> */
 	if (!qpXmlWriter_endElement(log->writer, "ShaderProgram"))
@@ -1092,7 +1478,7 @@ deBool qpTestLog_writeShader (qpTestLog* log, qpShaderType type, const char* sou
 	int				numShaderAttribs	= 0;
 	qpXmlAttribute	shaderAttribs[4];
 
-	deMutex_lock(log->lock);
+	lockLog(log);
 
 	DE_ASSERT(source);
 	DE_ASSERT(ContainerStack_getTop(&log->containerStack) == CONTAINERTYPE_SHADERPROGRAM);
@@ -1122,7 +1508,7 @@ deBool qpTestLog_startEglConfigSet (qpTestLog* log, const char* name, const char
 	int				numAttribs = 0;
 
 	DE_ASSERT(log && name);
-	deMutex_lock(log->lock);
+	lockLog(log);
 
 	attribs[numAttribs++] = qpSetStringAttrib("Name", name);
 	if (description)
@@ -1148,7 +1534,7 @@ deBool qpTestLog_startEglConfigSet (qpTestLog* log, const char* name, const char
 deBool qpTestLog_endEglConfigSet (qpTestLog* log)
 {
 	DE_ASSERT(log);
-	deMutex_lock(log->lock);
+	lockLog(log);
 
 	/* <EglConfigSet Name="<name>"> */
 	if (!qpXmlWriter_endElement(log->writer, "EglConfigSet"))
@@ -1174,7 +1560,7 @@ deBool qpTestLog_writeEglConfig (qpTestLog* log, const qpEglConfigInfo* config)
 	int				numAttribs = 0;
 
 	DE_ASSERT(log && config);
-	deMutex_lock(log->lock);
+	lockLog(log);
 
 	attribs[numAttribs++] = qpSetIntAttrib		("BufferSize", config->bufferSize);
 	attribs[numAttribs++] = qpSetIntAttrib		("RedSize", config->redSize);
@@ -1233,7 +1619,7 @@ deBool qpTestLog_startSection (qpTestLog* log, const char* name, const char* des
 	int				numAttribs = 0;
 
 	DE_ASSERT(log && name);
-	deMutex_lock(log->lock);
+	lockLog(log);
 
 	attribs[numAttribs++] = qpSetStringAttrib("Name", name);
 	if (description)
@@ -1261,7 +1647,7 @@ deBool qpTestLog_startSection (qpTestLog* log, const char* name, const char* des
 deBool qpTestLog_endSection (qpTestLog* log)
 {
 	DE_ASSERT(log);
-	deMutex_lock(log->lock);
+	lockLog(log);
 
 	/* </Section> */
 	if (!qpXmlWriter_endElement(log->writer, "Section"))
@@ -1285,7 +1671,7 @@ deBool qpTestLog_writeKernelSource (qpTestLog* log, const char* source)
 	const char*		sourceStr	= (log->flags & QP_TEST_LOG_EXCLUDE_SHADER_SOURCES) != 0 ? "" : source;
 
 	DE_ASSERT(log);
-	deMutex_lock(log->lock);
+	lockLog(log);
 
 	if (!qpXmlWriter_writeStringElement(log->writer, "KernelSource", sourceStr))
 	{
@@ -1305,7 +1691,7 @@ deBool qpTestLog_writeSpirVAssemblySource (qpTestLog* log, const char* source)
 {
 	const char* const	sourceStr	= (log->flags & QP_TEST_LOG_EXCLUDE_SHADER_SOURCES) != 0 ? "" : source;
 
-	deMutex_lock(log->lock);
+	lockLog(log);
 
 	DE_ASSERT(ContainerStack_getTop(&log->containerStack) == CONTAINERTYPE_SHADERPROGRAM);
 
@@ -1329,7 +1715,7 @@ deBool qpTestLog_writeCompileInfo (qpTestLog* log, const char* name, const char*
 	qpXmlAttribute	attribs[3];
 
 	DE_ASSERT(log && name && description && infoLog);
-	deMutex_lock(log->lock);
+	lockLog(log);
 
 	attribs[numAttribs++] = qpSetStringAttrib("Name", name);
 	attribs[numAttribs++] = qpSetStringAttrib("Description", description);
@@ -1354,7 +1740,7 @@ deBool qpTestLog_startSampleList (qpTestLog* log, const char* name, const char*
 	qpXmlAttribute	attribs[2];
 
 	DE_ASSERT(log && name && description);
-	deMutex_lock(log->lock);
+	lockLog(log);
 
 	attribs[numAttribs++] = qpSetStringAttrib("Name", name);
 	attribs[numAttribs++] = qpSetStringAttrib("Description", description);
@@ -1375,7 +1761,7 @@ deBool qpTestLog_startSampleList (qpTestLog* log, const char* name, const char*
 deBool qpTestLog_startSampleInfo (qpTestLog* log)
 {
 	DE_ASSERT(log);
-	deMutex_lock(log->lock);
+	lockLog(log);
 
 	if (!qpXmlWriter_startElement(log->writer, "SampleInfo", 0, DE_NULL))
 	{
@@ -1397,7 +1783,7 @@ deBool qpTestLog_writeValueInfo (qpTestLog* log, const char* name, const char* d
 	qpXmlAttribute	attribs[4];
 
 	DE_ASSERT(log && name && description && tagName);
-	deMutex_lock(log->lock);
+	lockLog(log);
 
 	DE_ASSERT(ContainerStack_getTop(&log->containerStack) == CONTAINERTYPE_SAMPLEINFO);
 
@@ -1423,7 +1809,7 @@ deBool qpTestLog_writeValueInfo (qpTestLog* log, const char* name, const char* d
 deBool qpTestLog_endSampleInfo (qpTestLog* log)
 {
 	DE_ASSERT(log);
-	deMutex_lock(log->lock);
+	lockLog(log);
 
 	if (!qpXmlWriter_endElement(log->writer, "SampleInfo"))
 	{
@@ -1441,7 +1827,7 @@ deBool qpTestLog_endSampleInfo (qpTestLog* log)
 deBool qpTestLog_startSample (qpTestLog* log)
 {
 	DE_ASSERT(log);
-	deMutex_lock(log->lock);
+	lockLog(log);
 
 	DE_ASSERT(ContainerStack_getTop(&log->containerStack) == CONTAINERTYPE_SAMPLELIST);
 
@@ -1463,7 +1849,7 @@ deBool qpTestLog_writeValueFloat (qpTestLog* log, double value)
 	char tmpString[512];
 	doubleToString(value, tmpString, (int)sizeof(tmpString));
 
-	deMutex_lock(log->lock);
+	lockLog(log);
 
 	DE_ASSERT(ContainerStack_getTop(&log->containerStack) == CONTAINERTYPE_SAMPLE);
 
@@ -1483,7 +1869,7 @@ deBool qpTestLog_writeValueInteger (qpTestLog* log, deInt64 value)
 	char tmpString[64];
 	int64ToString(value, tmpString);
 
-	deMutex_lock(log->lock);
+	lockLog(log);
 
 	DE_ASSERT(ContainerStack_getTop(&log->containerStack) == CONTAINERTYPE_SAMPLE);
 
@@ -1501,7 +1887,7 @@ deBool qpTestLog_writeValueInteger (qpTestLog* log, deInt64 value)
 deBool qpTestLog_endSample (qpTestLog* log)
 {
 	DE_ASSERT(log);
-	deMutex_lock(log->lock);
+	lockLog(log);
 
 	if (!qpXmlWriter_endElement(log->writer, "Sample"))
 	{
@@ -1519,7 +1905,7 @@ deBool qpTestLog_endSample (qpTestLog* log)
 deBool qpTestLog_endSampleList (qpTestLog* log)
 {
 	DE_ASSERT(log);
-	deMutex_lock(log->lock);
+	lockLog(log);
 
 	if (!qpXmlWriter_endElement(log->writer, "SampleList"))
 	{
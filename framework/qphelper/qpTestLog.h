@@ -137,6 +137,8 @@ typedef enum qpTestLogFlag_e
 	QP_TEST_LOG_EXCLUDE_SHADER_SOURCES	= (1<<1),		/*!< Do not log shader sources. Helps to reduce log size further.	*/
 	QP_TEST_LOG_NO_FLUSH				= (1<<2),		/*!< Do not do a fflush after writing the log.						*/
 	QP_TEST_LOG_EXCLUDE_EMPTY_LOGINFO	= (1<<3),		/*!< Do not log empty shader compile or link loginfo.				*/
+	QP_TEST_LOG_BINARY					= (1<<4),		/*!< Write log using binary record encoding instead of text.		*/
+	QP_TEST_LOG_SYNC_IMAGES				= (1<<5),		/*!< Compress images on the calling thread instead of in background.	*/
 } qpTestLogFlag;
 
 /* Shader type. */
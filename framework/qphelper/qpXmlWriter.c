@@ -33,10 +33,19 @@
 #include "deMemPool.h"
 #include "dePoolArray.h"
 
+#include <zlib.h>
+
+enum
+{
+	MIN_DEFLATE_DATA_SIZE	= 1024	/*!< Smaller base64 blocks are stored uncompressed. */
+};
+
 struct qpXmlWriter_s
 {
 	FILE*				outputFile;
 	deBool				flushAfterWrite;
+	deBool				isBinary;
+	deBool				useCompression;
 
 	deBool				xmlPrevIsStartElement;
 	deBool				xmlIsWriting;
@@ -135,6 +144,129 @@ qpXmlWriter* qpXmlWriter_createFileWriter (FILE* outputFile, deBool useCompressi
 	return writer;
 }
 
+/* Binary record encoding. */
+
+static deBool writeBytes (qpXmlWriter* writer, const void* data, size_t numBytes)
+{
+	return numBytes == 0 || fwrite(data, 1, numBytes, writer->outputFile) == numBytes;
+}
+
+static deBool writeUint32 (qpXmlWriter* writer, deUint32 value)
+{
+	const deUint8 bytes[4] =
+	{
+		(deUint8)(value & 0xFFu),
+		(deUint8)((value >> 8) & 0xFFu),
+		(deUint8)((value >> 16) & 0xFFu),
+		(deUint8)(value >> 24)
+	};
+
+	return writeBytes(writer, bytes, sizeof(bytes));
+}
+
+static deBool writeRecordHeader (qpXmlWriter* writer, qpBinaryLogRecord type, size_t payloadSize)
+{
+	const deUint8 typeByte = (deUint8)type;
+
+	DE_ASSERT(payloadSize <= 0xFFFFFFFFu);
+
+	return writeBytes(writer, &typeByte, 1) && writeUint32(writer, (deUint32)payloadSize);
+}
+
+static deBool writeDataRecord (qpXmlWriter* writer, qpBinaryLogRecord type, const void* data, size_t numBytes)
+{
+	return writeRecordHeader(writer, type, numBytes) && writeBytes(writer, data, numBytes);
+}
+
+static deBool writeLengthPrefixed (qpXmlWriter* writer, const char* str)
+{
+	const size_t len = strlen(str);
+	return writeUint32(writer, (deUint32)len) && writeBytes(writer, str, len);
+}
+
+/* Format attribute value as it would appear in XML text (before escaping). */
+static const char* getAttribValue (const qpXmlAttribute* attrib, char buf[64])
+{
+	switch (attrib->type)
+	{
+		case QP_XML_ATTRIBUTE_STRING:	return attrib->stringValue;
+		case QP_XML_ATTRIBUTE_INT:		sprintf(buf, "%d", attrib->intValue);	return buf;
+		case QP_XML_ATTRIBUTE_BOOL:		return attrib->boolValue ? "True" : "False";
+		default:
+			DE_ASSERT(DE_FALSE);
+			return "";
+	}
+}
+
+static deBool writeStartElementRecord (qpXmlWriter* writer, const char* elementName, int numAttribs, const qpXmlAttribute* attribs)
+{
+	size_t	payloadSize	= 4 + strlen(elementName) + 4;
+	char	buf[64];
+	int		ndx;
+
+	for (ndx = 0; ndx < numAttribs; ndx++)
+		payloadSize += 4 + strlen(attribs[ndx].name) + 4 + strlen(getAttribValue(&attribs[ndx], buf));
+
+	if (!writeRecordHeader(writer, QP_BINARY_LOG_RECORD_START_ELEMENT, payloadSize) ||
+		!writeLengthPrefixed(writer, elementName) ||
+		!writeUint32(writer, (deUint32)numAttribs))
+		return DE_FALSE;
+
+	for (ndx = 0; ndx < numAttribs; ndx++)
+	{
+		if (!writeLengthPrefixed(writer, attribs[ndx].name) ||
+			!writeLengthPrefixed(writer, getAttribValue(&attribs[ndx], buf)))
+			return DE_FALSE;
+	}
+
+	return DE_TRUE;
+}
+
+static deBool writeBase64Record (qpXmlWriter* writer, const deUint8* data, size_t numBytes)
+{
+	if (writer->useCompression && numBytes >= MIN_DEFLATE_DATA_SIZE && numBytes <= 0xFFFFFFFFu)
+	{
+		uLongf		compressedSize	= compressBound((uLong)numBytes);
+		Bytef*		compressed		= (Bytef*)deMalloc((size_t)compressedSize);
+		deBool		isOk			= DE_FALSE;
+
+		/* Favor speed: data is mostly images that previously went through PNG encoding. */
+		if (compressed && compress2(compressed, &compressedSize, data, (uLong)numBytes, Z_BEST_SPEED) == Z_OK && compressedSize < numBytes)
+		{
+			isOk = writeRecordHeader(writer, QP_BINARY_LOG_RECORD_BASE64_DEFLATE, 4 + (size_t)compressedSize) &&
+				   writeUint32(writer, (deUint32)numBytes) &&
+				   writeBytes(writer, compressed, (size_t)compressedSize);
+
+			deFree(compressed);
+			return isOk;
+		}
+
+		deFree(compressed);
+	}
+
+	return writeDataRecord(writer, QP_BINARY_LOG_RECORD_BASE64, data, numBytes);
+}
+
+qpXmlWriter* qpXmlWriter_createBinaryFileWriter (FILE* outputFile, deBool useCompression)
+{
+	qpXmlWriter* writer = (qpXmlWriter*)deCalloc(sizeof(qpXmlWriter));
+	if (!writer)
+		return DE_NULL;
+
+	writer->outputFile		= outputFile;
+	writer->isBinary		= DE_TRUE;
+	writer->useCompression	= useCompression;
+
+	if (!writeBytes(writer, QP_BINARY_LOG_MAGIC, strlen(QP_BINARY_LOG_MAGIC)) ||
+		!writeUint32(writer, QP_BINARY_LOG_VERSION))
+	{
+		deFree(writer);
+		return DE_NULL;
+	}
+
+	return writer;
+}
+
 void qpXmlWriter_destroy (qpXmlWriter* writer)
 {
 	DE_ASSERT(writer);
@@ -144,6 +276,9 @@ void qpXmlWriter_destroy (qpXmlWriter* writer)
 
 static deBool closePending (qpXmlWriter* writer)
 {
+	if (writer->isBinary)
+		return DE_TRUE;
+
 	if (writer->xmlPrevIsStartElement)
 	{
 		fprintf(writer->outputFile, ">\n");
@@ -164,6 +299,10 @@ deBool qpXmlWriter_startDocument (qpXmlWriter* writer)
 	writer->xmlIsWriting			= DE_TRUE;
 	writer->xmlElementDepth			= 0;
 	writer->xmlPrevIsStartElement	= DE_FALSE;
+
+	if (writer->isBinary)
+		return writeRecordHeader(writer, QP_BINARY_LOG_RECORD_START_DOCUMENT, 0);
+
 	fprintf(writer->outputFile, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
 	return DE_TRUE;
 }
@@ -182,11 +321,18 @@ deBool qpXmlWriter_endDocument (qpXmlWriter* writer)
 	DE_ASSERT(writer->xmlElementDepth == 0);
 	closePending(writer);
 	writer->xmlIsWriting = DE_FALSE;
+
+	if (writer->isBinary)
+		return writeRecordHeader(writer, QP_BINARY_LOG_RECORD_END_DOCUMENT, 0);
+
 	return DE_TRUE;
 }
 
 deBool qpXmlWriter_writeString (qpXmlWriter* writer, const char* str)
 {
+	if (writer->isBinary)
+		return writeDataRecord(writer, QP_BINARY_LOG_RECORD_STRING, str, strlen(str));
+
 	if (writer->xmlPrevIsStartElement)
 	{
 		fprintf(writer->outputFile, ">");
@@ -200,6 +346,12 @@ deBool qpXmlWriter_startElement(qpXmlWriter* writer, const char* elementName, in
 {
 	int ndx;
 
+	if (writer->isBinary)
+	{
+		writer->xmlElementDepth++;
+		return writeStartElementRecord(writer, elementName, numAttribs, attribs);
+	}
+
 	closePending(writer);
 
 	fprintf(writer->outputFile, "%s<%s", getIndentStr(writer->xmlElementDepth), elementName);
@@ -242,6 +394,9 @@ deBool qpXmlWriter_endElement (qpXmlWriter* writer, const char* elementName)
 	DE_ASSERT(writer && writer->xmlElementDepth > 0);
 	writer->xmlElementDepth--;
 
+	if (writer->isBinary)
+		return writeDataRecord(writer, QP_BINARY_LOG_RECORD_END_ELEMENT, elementName, strlen(elementName));
+
 	if (writer->xmlPrevIsStartElement) /* leave flag as-is */
 	{
 		fprintf(writer->outputFile, " />\n");
@@ -271,6 +426,9 @@ deBool qpXmlWriter_writeBase64 (qpXmlWriter* writer, const deUint8* data, size_t
 
 	DE_ASSERT(writer && data && (numBytes > 0));
 
+	if (writer->isBinary)
+		return writeBase64Record(writer, data, numBytes);
+
 	/* Close and pending writes. */
 	closePending(writer);
 
@@ -322,6 +480,16 @@ deBool qpXmlWriter_writeBase64 (qpXmlWriter* writer, const deUint8* data, size_t
 	return DE_TRUE;
 }
 
+deBool qpXmlWriter_writeRaw (qpXmlWriter* writer, const char* content)
+{
+	DE_ASSERT(writer && !writer->xmlPrevIsStartElement);
+
+	if (writer->isBinary)
+		return writeDataRecord(writer, QP_BINARY_LOG_RECORD_RAW, content, strlen(content));
+
+	return fputs(content, writer->outputFile) >= 0;
+}
+
 /* Common helper functions. */
 
 deBool qpXmlWriter_writeStringElement (qpXmlWriter* writer, const char* elementName, const char* elementContent)
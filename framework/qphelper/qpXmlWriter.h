@@ -31,6 +31,24 @@ DE_BEGIN_EXTERN_C
 
 typedef struct qpXmlWriter_s	qpXmlWriter;
 
+/* Binary record encoding. \note Keep in sync with executor/xeBinaryLogDecoder.cpp. */
+#define QP_BINARY_LOG_MAGIC		"qpBinLog"
+#define QP_BINARY_LOG_VERSION	1
+
+typedef enum qpBinaryLogRecord_e
+{
+	QP_BINARY_LOG_RECORD_RAW = 0,			/*!< Text outside of XML documents, written as-is.		*/
+	QP_BINARY_LOG_RECORD_START_DOCUMENT,	/*!< No payload.										*/
+	QP_BINARY_LOG_RECORD_END_DOCUMENT,		/*!< No payload.										*/
+	QP_BINARY_LOG_RECORD_START_ELEMENT,		/*!< Name, attribute count (32-bit), name-value pairs.	*/
+	QP_BINARY_LOG_RECORD_END_ELEMENT,		/*!< Element name.										*/
+	QP_BINARY_LOG_RECORD_STRING,			/*!< Unescaped text.									*/
+	QP_BINARY_LOG_RECORD_BASE64,			/*!< Raw data bytes.									*/
+	QP_BINARY_LOG_RECORD_BASE64_DEFLATE,	/*!< Data size (32-bit) followed by zlib stream.		*/
+
+	QP_BINARY_LOG_RECORD_LAST
+} qpBinaryLogRecord;
+
 typedef enum qpXmlAttributeType_e
 {
 	QP_XML_ATTRIBUTE_STRING = 0,
@@ -90,6 +108,25 @@ DE_INLINE qpXmlAttribute qpSetBoolAttrib (const char* name, deBool value)
  *//*--------------------------------------------------------------------*/
 qpXmlWriter*	qpXmlWriter_createFileWriter (FILE* outFile, deBool useCompression, deBool flushAfterWrite);
 
+/*--------------------------------------------------------------------*//*!
+ * \brief Create a file based writer using binary record encoding
+ *
+ * Instead of XML text, each writer call is stored as a length-prefixed
+ * record that can be converted back to the exact same text later (see
+ * executor/xeBinaryLogDecoder.hpp). Text is not escaped and base64 data
+ * is stored as raw bytes. Output is never flushed by the writer.
+ *
+ * File starts with QP_BINARY_LOG_MAGIC followed by format version as
+ * 32-bit little-endian integer. Each record consists of record type
+ * (1 byte), payload size (32-bit little-endian) and payload. Strings in
+ * payloads are stored as 32-bit length followed by the characters.
+ *
+ * \param outFile			Output file
+ * \param useCompression	Set to DE_TRUE to deflate large base64 data blocks
+ * \return qpXmlWriter instance, or DE_NULL on allocation failure
+ *//*--------------------------------------------------------------------*/
+qpXmlWriter*	qpXmlWriter_createBinaryFileWriter (FILE* outFile, deBool useCompression);
+
 /*--------------------------------------------------------------------*//*!
  * \brief XML Writer instance
  * \param a	qpXmlWriter instance
@@ -140,6 +177,14 @@ deBool			qpXmlWriter_endElement (qpXmlWriter* writer, const char* elementName);
  *//*--------------------------------------------------------------------*/
 deBool			qpXmlWriter_writeString (qpXmlWriter* writer, const char* content);
 
+/*--------------------------------------------------------------------*//*!
+ * \brief Write unescaped text outside of XML document
+ * \param writer qpXmlWriter instance
+ * \param content Text to be written as-is
+ * \return true on success, false on error
+ *//*--------------------------------------------------------------------*/
+deBool			qpXmlWriter_writeRaw (qpXmlWriter* writer, const char* content);
+
 /*--------------------------------------------------------------------*//*!
  * \brief Write base64 encoded data into XML document
  * \param writer	qpXmlWriter instance
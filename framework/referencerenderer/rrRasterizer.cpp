@@ -25,6 +25,14 @@
 #include "deMath.h"
 #include "tcuVectorUtil.hpp"
 
+#if (DE_CPU == DE_CPU_X86_64)
+#	define RR_RASTERIZER_SSE2
+#	include <emmintrin.h>
+#elif (DE_CPU == DE_CPU_ARM_64)
+#	define RR_RASTERIZER_NEON
+#	include <arm_neon.h>
+#endif
+
 namespace rr
 {
 
@@ -91,6 +99,150 @@ static inline bool isInsideCCW (const EdgeFunction& edge, const deInt64 edgeVal)
 	return edge.inclusive ? (edgeVal >= 0) : (edgeVal > 0);
 }
 
+//! Get bias that turns isInsideCCW() into a sign test: edgeVal is inside if edgeVal - bias >= 0.
+static inline deInt64 getEdgeBias (const EdgeFunction& edge)
+{
+	return edge.inclusive ? 0 : 1;
+}
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Compute coverage from biased edge values
+ *
+ * Edge values are biased with getEdgeBias() and stored in coverage bit
+ * order, i.e. value for coverage bit N is in lane N. Lane is covered if
+ * it is inside all three edges.
+ *//*--------------------------------------------------------------------*/
+template<int NumLanes>
+static inline deUint64 getEdgeCoverage (const deInt64* e01, const deInt64* e12, const deInt64* e20)
+{
+	DE_STATIC_ASSERT(NumLanes % 2 == 0 && NumLanes <= 64);
+
+	deUint64 coverage = 0;
+
+	for (int laneNdx = 0; laneNdx < NumLanes; laneNdx += 2)
+	{
+#if defined(RR_RASTERIZER_SSE2)
+		const __m128i	outside	= _mm_or_si128(_mm_or_si128(_mm_loadu_si128((const __m128i*)(e01 + laneNdx)),
+															_mm_loadu_si128((const __m128i*)(e12 + laneNdx))),
+												_mm_loadu_si128((const __m128i*)(e20 + laneNdx)));
+		const deUint64	signs	= (deUint64)_mm_movemask_pd(_mm_castsi128_pd(outside));
+#elif defined(RR_RASTERIZER_NEON)
+		const uint64x2_t	outside	= vshrq_n_u64(vreinterpretq_u64_s64(vorrq_s64(vorrq_s64(vld1q_s64(e01 + laneNdx), vld1q_s64(e12 + laneNdx)), vld1q_s64(e20 + laneNdx))), 63);
+		const deUint64		signs	= vgetq_lane_u64(outside, 0) | (vgetq_lane_u64(outside, 1) << 1);
+#else
+		const deUint64	signs	= (((deUint64)(e01[laneNdx+0] | e12[laneNdx+0] | e20[laneNdx+0])) >> 63)
+								| ((((deUint64)(e01[laneNdx+1] | e12[laneNdx+1] | e20[laneNdx+1])) >> 63) << 1);
+#endif
+		coverage |= (signs ^ 0x3u) << laneNdx;
+	}
+
+	return coverage;
+}
+
+//! Advance edge values by step. Edge functions are linear so this equals evaluating them at the next location.
+template<int NumLanes>
+static inline void stepEdgeValues (deInt64* values, const deInt64 step)
+{
+#if defined(RR_RASTERIZER_SSE2)
+	const __m128i stepVec = _mm_set1_epi64x(step);
+
+	for (int laneNdx = 0; laneNdx < NumLanes; laneNdx += 2)
+		_mm_storeu_si128((__m128i*)(values + laneNdx), _mm_add_epi64(_mm_loadu_si128((const __m128i*)(values + laneNdx)), stepVec));
+#elif defined(RR_RASTERIZER_NEON)
+	const int64x2_t stepVec = vdupq_n_s64(step);
+
+	for (int laneNdx = 0; laneNdx < NumLanes; laneNdx += 2)
+		vst1q_s64(values + laneNdx, vaddq_s64(vld1q_s64(values + laneNdx), stepVec));
+#else
+	for (int laneNdx = 0; laneNdx < NumLanes; laneNdx++)
+		values[laneNdx] = (deInt64)((deUint64)values[laneNdx] + (deUint64)step);
+#endif
+}
+
+//! Compute perspective-corrected barycentrics from floating-point edge values.
+static inline void computeBarycentrics (tcu::Vec4* barycentric, const tcu::Vec4& e01f, const tcu::Vec4& e12f, const tcu::Vec4& e20f, const float w0, const float w1, const float w2)
+{
+#if defined(RR_RASTERIZER_SSE2)
+	const __m128	b0		= _mm_mul_ps(_mm_loadu_ps(e12f.getPtr()), _mm_set1_ps(w0));
+	const __m128	b1		= _mm_mul_ps(_mm_loadu_ps(e20f.getPtr()), _mm_set1_ps(w1));
+	const __m128	b2		= _mm_mul_ps(_mm_loadu_ps(e01f.getPtr()), _mm_set1_ps(w2));
+	const __m128	bSum	= _mm_add_ps(_mm_add_ps(b0, b1), b2);
+	const __m128	r0		= _mm_div_ps(b0, bSum);
+	const __m128	r1		= _mm_div_ps(b1, bSum);
+
+	_mm_storeu_ps(barycentric[0].getPtr(), r0);
+	_mm_storeu_ps(barycentric[1].getPtr(), r1);
+	_mm_storeu_ps(barycentric[2].getPtr(), _mm_sub_ps(_mm_sub_ps(_mm_set1_ps(1.0f), r0), r1));
+#else
+	const tcu::Vec4		b0		= e12f * w0;
+	const tcu::Vec4		b1		= e20f * w1;
+	const tcu::Vec4		b2		= e01f * w2;
+	const tcu::Vec4		bSum	= b0 + b1 + b2;
+
+	barycentric[0]	= b0 / bSum;
+	barycentric[1]	= b1 / bSum;
+	barycentric[2]	= 1.0f - barycentric[0] - barycentric[1];
+#endif
+}
+
+//! Compute depth values from floating-point edge values. See TriangleRasterizer::rasterizeSingleSample() for za, zb and zc.
+static inline tcu::Vec4 computeDepth (const tcu::Vec4& e01f, const tcu::Vec4& e12f, const tcu::Vec4& e20f, const float za, const float zb, const float zc)
+{
+#if defined(RR_RASTERIZER_SSE2)
+	const __m128	e12v	= _mm_loadu_ps(e12f.getPtr());
+	const __m128	e20v	= _mm_loadu_ps(e20f.getPtr());
+	const __m128	edgeSum	= _mm_add_ps(_mm_add_ps(_mm_loadu_ps(e01f.getPtr()), e12v), e20v);
+	const __m128	z0		= _mm_div_ps(e12v, edgeSum);
+	const __m128	z1		= _mm_div_ps(e20v, edgeSum);
+	tcu::Vec4		depth;
+
+	_mm_storeu_ps(depth.getPtr(), _mm_add_ps(_mm_add_ps(_mm_mul_ps(z0, _mm_set1_ps(za)), _mm_mul_ps(z1, _mm_set1_ps(zb))), _mm_set1_ps(zc)));
+
+	return depth;
+#else
+	const tcu::Vec4		edgeSum	= e01f + e12f + e20f;
+	const tcu::Vec4		z0		= e12f / edgeSum;
+	const tcu::Vec4		z1		= e20f / edgeSum;
+
+	return tcu::Vec4(z0[0]*za + z1[0]*zb + zc,
+					 z0[1]*za + z1[1]*zb + zc,
+					 z0[2]*za + z1[2]*zb + zc,
+					 z0[3]*za + z1[3]*zb + zc);
+#endif
+}
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Evaluate biased edge values for a fragment packet
+ *
+ * Values are written in coverage bit order (see getEdgeCoverage()).
+ * sampleOffsets contains subpixel (x, y) offsets for each sample.
+ *//*--------------------------------------------------------------------*/
+template<int NumSamples>
+static inline void initEdgeValues (deInt64* values, const EdgeFunction& edge, const deInt64 sx0, const deInt64 sx1, const deInt64 sy0, const deInt64 sy1, const deInt64* sampleOffsets)
+{
+	const deInt64 bias = getEdgeBias(edge);
+
+	for (int fragY = 0; fragY < 2; fragY++)
+	for (int fragX = 0; fragX < 2; fragX++)
+	for (int sampleNdx = 0; sampleNdx < NumSamples; sampleNdx++)
+	{
+		const deInt64 x = (fragX ? sx1 : sx0) + sampleOffsets[sampleNdx*2 + 0];
+		const deInt64 y = (fragY ? sy1 : sy0) + sampleOffsets[sampleNdx*2 + 1];
+
+		values[getCoverageOffset(NumSamples, fragX, fragY) + sampleNdx] = evaluateEdge(edge, x, y) - bias;
+	}
+}
+
+//! Get floating-point edge values for packet fragments at given sample. Fragments are in (0,0), (1,0), (0,1), (1,1) order.
+template<int NumSamples>
+static inline tcu::Vec4 getFragmentEdgeValues (const deInt64* values, const deInt64 bias, const int sampleNdx)
+{
+	return tcu::Vec4(float(values[getCoverageOffset(NumSamples, 0, 0) + sampleNdx] + bias),
+					 float(values[getCoverageOffset(NumSamples, 1, 0) + sampleNdx] + bias),
+					 float(values[getCoverageOffset(NumSamples, 0, 1) + sampleNdx] + bias),
+					 float(values[getCoverageOffset(NumSamples, 1, 1) + sampleNdx] + bias));
+}
+
 namespace LineRasterUtil
 {
 
@@ -534,11 +686,33 @@ void TriangleRasterizer::init (const tcu::Vec4& v0, const tcu::Vec4& v1, const t
 	m_curPos = m_bboxMin;
 }
 
+void TriangleRasterizer::restrictToRect (const tcu::IVec4& rect)
+{
+	const tcu::IVec2	rectMin	= rect.swizzle(0, 1);
+	const tcu::IVec2	rectMax	= rectMin + rect.swizzle(2, 3) - 1;
+
+	for (int axisNdx = 0; axisNdx < 2; axisNdx++)
+	{
+		// Keep packets aligned to original bounding box
+		if (rectMin[axisNdx] > m_bboxMin[axisNdx])
+			m_bboxMin[axisNdx] += ((rectMin[axisNdx] - m_bboxMin[axisNdx]) / 2) * 2;
+
+		m_bboxMax[axisNdx] = de::min(m_bboxMax[axisNdx], rectMax[axisNdx]);
+	}
+
+	m_curPos = m_bboxMin;
+
+	// Nothing to rasterize
+	if (m_bboxMin.x() > m_bboxMax.x())
+		m_curPos.y() = m_bboxMax.y() + 1;
+}
+
 void TriangleRasterizer::rasterizeSingleSample (FragmentPacket* const fragmentPackets, float* const depthValues, const int maxFragmentPackets, int& numPacketsRasterized)
 {
 	DE_ASSERT(maxFragmentPackets > 0);
 
-	const deUint64	halfPixel	= 1ll << (m_subpixelBits - 1);
+	const deInt64	halfPixel	= 1ll << (m_subpixelBits - 1);
+	const deInt64	samplePos[]	= { halfPixel, halfPixel };
 	int				packetNdx	= 0;
 
 	// For depth interpolation; given barycentrics A, B, C = (1 - A - B)
@@ -548,94 +722,93 @@ void TriangleRasterizer::rasterizeSingleSample (FragmentPacket* const fragmentPa
 	const float		zb			= m_v1.z()-m_v2.z();
 	const float		zc			= m_v2.z();
 
+	// Edge values are evaluated once per row and stepped to the next packet
+	const deInt64	step01		= m_edge01.a * toSubpixelCoord(2, m_subpixelBits);
+	const deInt64	step12		= m_edge12.a * toSubpixelCoord(2, m_subpixelBits);
+	const deInt64	step20		= m_edge20.a * toSubpixelCoord(2, m_subpixelBits);
+	const deInt64	bias01		= getEdgeBias(m_edge01);
+	const deInt64	bias12		= getEdgeBias(m_edge12);
+	const deInt64	bias20		= getEdgeBias(m_edge20);
+
+	// Coverage bits outside viewport on last column and row
+	const deUint64	column1Bits	= getCoverageFragmentSampleBits(1, 1, 0) | getCoverageFragmentSampleBits(1, 1, 1);
+	const deUint64	row1Bits	= getCoverageFragmentSampleBits(1, 0, 1) | getCoverageFragmentSampleBits(1, 1, 1);
+
+	// Biased edge values in coverage bit order
+	deInt64			e01[4];
+	deInt64			e12[4];
+	deInt64			e20[4];
+
 	while (m_curPos.y() <= m_bboxMax.y() && packetNdx < maxFragmentPackets)
 	{
-		const int		x0		= m_curPos.x();
 		const int		y0		= m_curPos.y();
 
 		// Subpixel coords
-		const deInt64	sx0		= toSubpixelCoord(x0,   m_subpixelBits)	+ halfPixel;
-		const deInt64	sx1		= toSubpixelCoord(x0+1, m_subpixelBits)	+ halfPixel;
-		const deInt64	sy0		= toSubpixelCoord(y0,   m_subpixelBits)	+ halfPixel;
-		const deInt64	sy1		= toSubpixelCoord(y0+1, m_subpixelBits)	+ halfPixel;
-
-		const deInt64	sx[4]	= { sx0, sx1, sx0, sx1 };
-		const deInt64	sy[4]	= { sy0, sy0, sy1, sy1 };
+		const deInt64	sx0		= toSubpixelCoord(m_curPos.x(),   m_subpixelBits);
+		const deInt64	sx1		= toSubpixelCoord(m_curPos.x()+1, m_subpixelBits);
+		const deInt64	sy0		= toSubpixelCoord(y0,   m_subpixelBits);
+		const deInt64	sy1		= toSubpixelCoord(y0+1, m_subpixelBits);
 
 		// Viewport test
-		const bool		outX1	= x0+1 == m_viewport.x()+m_viewport.z();
 		const bool		outY1	= y0+1 == m_viewport.y()+m_viewport.w();
 
-		DE_ASSERT(x0 < m_viewport.x()+m_viewport.z());
 		DE_ASSERT(y0 < m_viewport.y()+m_viewport.w());
 
-		// Edge values
-		tcu::Vector<deInt64, 4>	e01;
-		tcu::Vector<deInt64, 4>	e12;
-		tcu::Vector<deInt64, 4>	e20;
+		initEdgeValues<1>(e01, m_edge01, sx0, sx1, sy0, sy1, samplePos);
+		initEdgeValues<1>(e12, m_edge12, sx0, sx1, sy0, sy1, samplePos);
+		initEdgeValues<1>(e20, m_edge20, sx0, sx1, sy0, sy1, samplePos);
 
-		// Coverage
-		deUint64		coverage	= 0;
-
-		// Evaluate edge values
-		for (int i = 0; i < 4; i++)
+		for (; m_curPos.x() <= m_bboxMax.x() && packetNdx < maxFragmentPackets; m_curPos.x() += 2)
 		{
-			e01[i] = evaluateEdge(m_edge01, sx[i], sy[i]);
-			e12[i] = evaluateEdge(m_edge12, sx[i], sy[i]);
-			e20[i] = evaluateEdge(m_edge20, sx[i], sy[i]);
-		}
+			const int		x0			= m_curPos.x();
+			const bool		outX1		= x0+1 == m_viewport.x()+m_viewport.z();
+			deUint64		coverage	= getEdgeCoverage<4>(e01, e12, e20);
 
-		// Compute coverage mask
-		coverage = setCoverageValue(coverage, 1, 0, 0, 0,						isInsideCCW(m_edge01, e01[0]) && isInsideCCW(m_edge12, e12[0]) && isInsideCCW(m_edge20, e20[0]));
-		coverage = setCoverageValue(coverage, 1, 1, 0, 0, !outX1 &&				isInsideCCW(m_edge01, e01[1]) && isInsideCCW(m_edge12, e12[1]) && isInsideCCW(m_edge20, e20[1]));
-		coverage = setCoverageValue(coverage, 1, 0, 1, 0, !outY1 &&				isInsideCCW(m_edge01, e01[2]) && isInsideCCW(m_edge12, e12[2]) && isInsideCCW(m_edge20, e20[2]));
-		coverage = setCoverageValue(coverage, 1, 1, 1, 0, !outX1 && !outY1 &&	isInsideCCW(m_edge01, e01[3]) && isInsideCCW(m_edge12, e12[3]) && isInsideCCW(m_edge20, e20[3]));
+			DE_ASSERT(x0 < m_viewport.x()+m_viewport.z());
 
-		// Advance to next location
-		m_curPos.x() += 2;
-		if (m_curPos.x() > m_bboxMax.x())
-		{
-			m_curPos.y() += 2;
-			m_curPos.x()  = m_bboxMin.x();
-		}
+			if (outX1)
+				coverage &= ~column1Bits;
+			if (outY1)
+				coverage &= ~row1Bits;
 
-		if (coverage == 0)
-			continue; // Discard.
+			if (coverage != 0)
+			{
+				// Floating-point edge values for barycentrics etc.
+				const tcu::Vec4		e01f	= getFragmentEdgeValues<1>(e01, bias01, 0);
+				const tcu::Vec4		e12f	= getFragmentEdgeValues<1>(e12, bias12, 0);
+				const tcu::Vec4		e20f	= getFragmentEdgeValues<1>(e20, bias20, 0);
 
-		// Floating-point edge values for barycentrics etc.
-		const tcu::Vec4		e01f	= e01.asFloat();
-		const tcu::Vec4		e12f	= e12.asFloat();
-		const tcu::Vec4		e20f	= e20.asFloat();
+				// Compute depth values.
+				if (depthValues)
+				{
+					const tcu::Vec4 depth = computeDepth(e01f, e12f, e20f, za, zb, zc);
 
-		// Compute depth values.
-		if (depthValues)
-		{
-			const tcu::Vec4		edgeSum	= e01f + e12f + e20f;
-			const tcu::Vec4		z0		= e12f / edgeSum;
-			const tcu::Vec4		z1		= e20f / edgeSum;
-
-			depthValues[packetNdx*4+0] = z0[0]*za + z1[0]*zb + zc;
-			depthValues[packetNdx*4+1] = z0[1]*za + z1[1]*zb + zc;
-			depthValues[packetNdx*4+2] = z0[2]*za + z1[2]*zb + zc;
-			depthValues[packetNdx*4+3] = z0[3]*za + z1[3]*zb + zc;
-		}
+					for (int fragNdx = 0; fragNdx < 4; fragNdx++)
+						depthValues[packetNdx*4+fragNdx] = depth[fragNdx];
+				}
 
-		// Compute barycentrics and write out fragment packet
-		{
-			FragmentPacket& packet = fragmentPackets[packetNdx];
+				// Compute barycentrics and write out fragment packet
+				{
+					FragmentPacket& packet = fragmentPackets[packetNdx];
+
+					packet.position			= tcu::IVec2(x0, y0);
+					packet.coverage			= coverage;
+					computeBarycentrics(packet.barycentric, e01f, e12f, e20f, m_v0.w(), m_v1.w(), m_v2.w());
 
-			const tcu::Vec4		b0		= e12f * m_v0.w();
-			const tcu::Vec4		b1		= e20f * m_v1.w();
-			const tcu::Vec4		b2		= e01f * m_v2.w();
-			const tcu::Vec4		bSum	= b0 + b1 + b2;
+					packetNdx += 1;
+				}
+			}
 
-			packet.position			= tcu::IVec2(x0, y0);
-			packet.coverage			= coverage;
-			packet.barycentric[0]	= b0 / bSum;
-			packet.barycentric[1]	= b1 / bSum;
-			packet.barycentric[2]	= 1.0f - packet.barycentric[0] - packet.barycentric[1];
+			stepEdgeValues<4>(e01, step01);
+			stepEdgeValues<4>(e12, step12);
+			stepEdgeValues<4>(e20, step20);
+		}
 
-			packetNdx += 1;
+		// Advance to next row
+		if (m_curPos.x() > m_bboxMax.x())
+		{
+			m_curPos.y() += 2;
+			m_curPos.x()  = m_bboxMin.x();
 		}
 	}
 
@@ -698,7 +871,8 @@ void TriangleRasterizer::rasterizeMultiSample (FragmentPacket* const fragmentPac
 	// Big enough to hold maximum multisample count
 	deInt64			samplePos[DE_LENGTH_OF_ARRAY(s_samplePts16)];
 	const float *	samplePts	= DE_NULL;
-	const deUint64	halfPixel	= 1ll << (m_subpixelBits - 1);
+	const deInt64	halfPixel	= 1ll << (m_subpixelBits - 1);
+	const deInt64	centerPos[]	= { halfPixel, halfPixel };
 	int				packetNdx	= 0;
 
 	// For depth interpolation, see rasterizeSingleSample
@@ -706,6 +880,26 @@ void TriangleRasterizer::rasterizeMultiSample (FragmentPacket* const fragmentPac
 	const float		zb			= m_v1.z()-m_v2.z();
 	const float		zc			= m_v2.z();
 
+	// Edge stepping, see rasterizeSingleSample
+	const deInt64	step01		= m_edge01.a * toSubpixelCoord(2, m_subpixelBits);
+	const deInt64	step12		= m_edge12.a * toSubpixelCoord(2, m_subpixelBits);
+	const deInt64	step20		= m_edge20.a * toSubpixelCoord(2, m_subpixelBits);
+	const deInt64	bias01		= getEdgeBias(m_edge01);
+	const deInt64	bias12		= getEdgeBias(m_edge12);
+	const deInt64	bias20		= getEdgeBias(m_edge20);
+
+	// Coverage bits outside viewport on last column and row
+	const deUint64	column1Bits	= getCoverageFragmentSampleBits(NumSamples, 1, 0) | getCoverageFragmentSampleBits(NumSamples, 1, 1);
+	const deUint64	row1Bits	= getCoverageFragmentSampleBits(NumSamples, 0, 1) | getCoverageFragmentSampleBits(NumSamples, 1, 1);
+
+	// Biased edge values at sample positions and at pixel centers in coverage bit order
+	deInt64			e01[4*NumSamples];
+	deInt64			e12[4*NumSamples];
+	deInt64			e20[4*NumSamples];
+	deInt64			center01[4];
+	deInt64			center12[4];
+	deInt64			center20[4];
+
 	switch (NumSamples)
 	{
 		case 2:		samplePts = s_samplePts2;	break;
@@ -721,117 +915,87 @@ void TriangleRasterizer::rasterizeMultiSample (FragmentPacket* const fragmentPac
 
 	while (m_curPos.y() <= m_bboxMax.y() && packetNdx < maxFragmentPackets)
 	{
-		const int		x0		= m_curPos.x();
 		const int		y0		= m_curPos.y();
 
 		// Base subpixel coords
-		const deInt64	sx0		= toSubpixelCoord(x0,   m_subpixelBits);
-		const deInt64	sx1		= toSubpixelCoord(x0+1, m_subpixelBits);
+		const deInt64	sx0		= toSubpixelCoord(m_curPos.x(),   m_subpixelBits);
+		const deInt64	sx1		= toSubpixelCoord(m_curPos.x()+1, m_subpixelBits);
 		const deInt64	sy0		= toSubpixelCoord(y0,   m_subpixelBits);
 		const deInt64	sy1		= toSubpixelCoord(y0+1, m_subpixelBits);
 
-		const deInt64	sx[4]	= { sx0, sx1, sx0, sx1 };
-		const deInt64	sy[4]	= { sy0, sy0, sy1, sy1 };
-
 		// Viewport test
-		const bool		outX1	= x0+1 == m_viewport.x()+m_viewport.z();
 		const bool		outY1	= y0+1 == m_viewport.y()+m_viewport.w();
 
-		DE_ASSERT(x0 < m_viewport.x()+m_viewport.z());
 		DE_ASSERT(y0 < m_viewport.y()+m_viewport.w());
 
-		// Edge values
-		tcu::Vector<deInt64, 4>	e01[NumSamples];
-		tcu::Vector<deInt64, 4>	e12[NumSamples];
-		tcu::Vector<deInt64, 4>	e20[NumSamples];
-
-		// Coverage
-		deUint64		coverage	= 0;
+		initEdgeValues<NumSamples>(e01, m_edge01, sx0, sx1, sy0, sy1, samplePos);
+		initEdgeValues<NumSamples>(e12, m_edge12, sx0, sx1, sy0, sy1, samplePos);
+		initEdgeValues<NumSamples>(e20, m_edge20, sx0, sx1, sy0, sy1, samplePos);
+		initEdgeValues<1>(center01, m_edge01, sx0, sx1, sy0, sy1, centerPos);
+		initEdgeValues<1>(center12, m_edge12, sx0, sx1, sy0, sy1, centerPos);
+		initEdgeValues<1>(center20, m_edge20, sx0, sx1, sy0, sy1, centerPos);
 
-		// Evaluate edge values at sample positions
-		for (int sampleNdx = 0; sampleNdx < NumSamples; sampleNdx++)
+		for (; m_curPos.x() <= m_bboxMax.x() && packetNdx < maxFragmentPackets; m_curPos.x() += 2)
 		{
-			const deInt64 ox = samplePos[sampleNdx*2 + 0];
-			const deInt64 oy = samplePos[sampleNdx*2 + 1];
+			const int		x0			= m_curPos.x();
+			const bool		outX1		= x0+1 == m_viewport.x()+m_viewport.z();
+			deUint64		coverage	= getEdgeCoverage<4*NumSamples>(e01, e12, e20);
 
-			for (int fragNdx = 0; fragNdx < 4; fragNdx++)
-			{
-				e01[sampleNdx][fragNdx] = evaluateEdge(m_edge01, sx[fragNdx] + ox, sy[fragNdx] + oy);
-				e12[sampleNdx][fragNdx] = evaluateEdge(m_edge12, sx[fragNdx] + ox, sy[fragNdx] + oy);
-				e20[sampleNdx][fragNdx] = evaluateEdge(m_edge20, sx[fragNdx] + ox, sy[fragNdx] + oy);
-			}
-		}
+			DE_ASSERT(x0 < m_viewport.x()+m_viewport.z());
 
-		// Compute coverage mask
-		for (int sampleNdx = 0; sampleNdx < NumSamples; sampleNdx++)
-		{
-			coverage = setCoverageValue(coverage, NumSamples, 0, 0, sampleNdx,						isInsideCCW(m_edge01, e01[sampleNdx][0]) && isInsideCCW(m_edge12, e12[sampleNdx][0]) && isInsideCCW(m_edge20, e20[sampleNdx][0]));
-			coverage = setCoverageValue(coverage, NumSamples, 1, 0, sampleNdx, !outX1 &&			isInsideCCW(m_edge01, e01[sampleNdx][1]) && isInsideCCW(m_edge12, e12[sampleNdx][1]) && isInsideCCW(m_edge20, e20[sampleNdx][1]));
-			coverage = setCoverageValue(coverage, NumSamples, 0, 1, sampleNdx, !outY1 &&			isInsideCCW(m_edge01, e01[sampleNdx][2]) && isInsideCCW(m_edge12, e12[sampleNdx][2]) && isInsideCCW(m_edge20, e20[sampleNdx][2]));
-			coverage = setCoverageValue(coverage, NumSamples, 1, 1, sampleNdx, !outX1 && !outY1 &&	isInsideCCW(m_edge01, e01[sampleNdx][3]) && isInsideCCW(m_edge12, e12[sampleNdx][3]) && isInsideCCW(m_edge20, e20[sampleNdx][3]));
-		}
+			if (outX1)
+				coverage &= ~column1Bits;
+			if (outY1)
+				coverage &= ~row1Bits;
 
-		// Advance to next location
-		m_curPos.x() += 2;
-		if (m_curPos.x() > m_bboxMax.x())
-		{
-			m_curPos.y() += 2;
-			m_curPos.x()  = m_bboxMin.x();
-		}
-
-		if (coverage == 0)
-			continue; // Discard.
-
-		// Compute depth values.
-		if (depthValues)
-		{
-			for (int sampleNdx = 0; sampleNdx < NumSamples; sampleNdx++)
+			if (coverage != 0)
 			{
-				// Floating-point edge values at sample coordinates.
-				const tcu::Vec4&	e01f	= e01[sampleNdx].asFloat();
-				const tcu::Vec4&	e12f	= e12[sampleNdx].asFloat();
-				const tcu::Vec4&	e20f	= e20[sampleNdx].asFloat();
-
-				const tcu::Vec4		edgeSum	= e01f + e12f + e20f;
-				const tcu::Vec4		z0		= e12f / edgeSum;
-				const tcu::Vec4		z1		= e20f / edgeSum;
-
-				depthValues[(packetNdx*4+0)*NumSamples + sampleNdx] = z0[0]*za + z1[0]*zb + zc;
-				depthValues[(packetNdx*4+1)*NumSamples + sampleNdx] = z0[1]*za + z1[1]*zb + zc;
-				depthValues[(packetNdx*4+2)*NumSamples + sampleNdx] = z0[2]*za + z1[2]*zb + zc;
-				depthValues[(packetNdx*4+3)*NumSamples + sampleNdx] = z0[3]*za + z1[3]*zb + zc;
-			}
-		}
+				// Compute depth values.
+				if (depthValues)
+				{
+					for (int sampleNdx = 0; sampleNdx < NumSamples; sampleNdx++)
+					{
+						// Floating-point edge values at sample coordinates.
+						const tcu::Vec4		e01f	= getFragmentEdgeValues<NumSamples>(e01, bias01, sampleNdx);
+						const tcu::Vec4		e12f	= getFragmentEdgeValues<NumSamples>(e12, bias12, sampleNdx);
+						const tcu::Vec4		e20f	= getFragmentEdgeValues<NumSamples>(e20, bias20, sampleNdx);
+						const tcu::Vec4		depth	= computeDepth(e01f, e12f, e20f, za, zb, zc);
+
+						for (int fragNdx = 0; fragNdx < 4; fragNdx++)
+							depthValues[(packetNdx*4+fragNdx)*NumSamples + sampleNdx] = depth[fragNdx];
+					}
+				}
 
-		// Compute barycentrics and write out fragment packet
-		{
-			FragmentPacket& packet = fragmentPackets[packetNdx];
+				// Compute barycentrics and write out fragment packet
+				{
+					FragmentPacket&		packet	= fragmentPackets[packetNdx];
 
-			// Floating-point edge values at pixel center.
-			tcu::Vec4			e01f;
-			tcu::Vec4			e12f;
-			tcu::Vec4			e20f;
+					// Floating-point edge values at pixel center.
+					const tcu::Vec4		e01f	= getFragmentEdgeValues<1>(center01, bias01, 0);
+					const tcu::Vec4		e12f	= getFragmentEdgeValues<1>(center12, bias12, 0);
+					const tcu::Vec4		e20f	= getFragmentEdgeValues<1>(center20, bias20, 0);
 
-			for (int i = 0; i < 4; i++)
-			{
-				e01f[i] = float(evaluateEdge(m_edge01, sx[i] + halfPixel, sy[i] + halfPixel));
-				e12f[i] = float(evaluateEdge(m_edge12, sx[i] + halfPixel, sy[i] + halfPixel));
-				e20f[i] = float(evaluateEdge(m_edge20, sx[i] + halfPixel, sy[i] + halfPixel));
-			}
+					packet.position			= tcu::IVec2(x0, y0);
+					packet.coverage			= coverage;
+					computeBarycentrics(packet.barycentric, e01f, e12f, e20f, m_v0.w(), m_v1.w(), m_v2.w());
 
-			// Barycentrics & scale.
-			const tcu::Vec4		b0		= e12f * m_v0.w();
-			const tcu::Vec4		b1		= e20f * m_v1.w();
-			const tcu::Vec4		b2		= e01f * m_v2.w();
-			const tcu::Vec4		bSum	= b0 + b1 + b2;
+					packetNdx += 1;
+				}
+			}
 
-			packet.position			= tcu::IVec2(x0, y0);
-			packet.coverage			= coverage;
-			packet.barycentric[0]	= b0 / bSum;
-			packet.barycentric[1]	= b1 / bSum;
-			packet.barycentric[2]	= 1.0f - packet.barycentric[0] - packet.barycentric[1];
+			stepEdgeValues<4*NumSamples>(e01, step01);
+			stepEdgeValues<4*NumSamples>(e12, step12);
+			stepEdgeValues<4*NumSamples>(e20, step20);
+			stepEdgeValues<4>(center01, step01);
+			stepEdgeValues<4>(center12, step12);
+			stepEdgeValues<4>(center20, step20);
+		}
 
-			packetNdx += 1;
+		// Advance to next row
+		if (m_curPos.x() > m_bboxMax.x())
+		{
+			m_curPos.y() += 2;
+			m_curPos.x()  = m_bboxMin.x();
 		}
 	}
 
@@ -1033,6 +1197,36 @@ void SingleSampleLineRasterizer::rasterize (FragmentPacket* const fragmentPacket
 	numPacketsRasterized = packetNdx;
 }
 
+void SingleSampleLineRasterizer::restrictToRect (const tcu::IVec4& rect)
+{
+	// \note Stipple counter depends on traversal of the whole line
+	DE_ASSERT(m_stipplePattern == 0xFFFF);
+
+	const bool			isXMajor		= de::abs((m_v1 - m_v0).x()) >= de::abs((m_v1 - m_v0).y());
+	const int			minorAxis		= isXMajor ? 1 : 0;
+	const deInt32		lineWidthPixels	= (m_lineWidth > 1.0f) ? deFloorFloatToInt32(m_lineWidth + 0.5f) : 1;
+	const tcu::IVec2	rectMin			= rect.swizzle(0, 1);
+	const tcu::IVec2	rectMax			= rectMin + rect.swizzle(2, 3) - 1;
+	const int			xDelta			= (m_v1 - m_v0).x() > 0 ? 1 : -1;
+	const int			yDelta			= (m_v1 - m_v0).y() > 0 ? 1 : -1;
+
+	for (int axisNdx = 0; axisNdx < 2; axisNdx++)
+	{
+		// Wide lines replicate fragments in positive minor direction
+		const int minPadding = (axisNdx == minorAxis) ? lineWidthPixels - 1 : 0;
+
+		m_bboxMin[axisNdx] = de::max(m_bboxMin[axisNdx], rectMin[axisNdx] - minPadding);
+		m_bboxMax[axisNdx] = de::min(m_bboxMax[axisNdx], rectMax[axisNdx]);
+	}
+
+	m_curPos.x() = xDelta > 0 ? m_bboxMin.x() : m_bboxMax.x();
+	m_curPos.y() = yDelta > 0 ? m_bboxMin.y() : m_bboxMax.y();
+
+	// Nothing to rasterize
+	if (m_bboxMin.x() > m_bboxMax.x())
+		m_curPos.y() = m_bboxMax.y() + 1;
+}
+
 MultiSampleLineRasterizer::MultiSampleLineRasterizer (const int numSamples, const tcu::IVec4& viewport, const int subpixelBits)
 	: m_numSamples			(numSamples)
 	, m_triangleRasterizer0 (viewport, m_numSamples, RasterizationState(), subpixelBits)
@@ -1064,6 +1258,12 @@ void MultiSampleLineRasterizer::init (const tcu::Vec4& v0, const tcu::Vec4& v1,
 	m_triangleRasterizer1.init(p2, p1, p0);
 }
 
+void MultiSampleLineRasterizer::restrictToRect (const tcu::IVec4& rect)
+{
+	m_triangleRasterizer0.restrictToRect(rect);
+	m_triangleRasterizer1.restrictToRect(rect);
+}
+
 void MultiSampleLineRasterizer::rasterize (FragmentPacket* const fragmentPackets, float* const depthValues, const int maxFragmentPackets, int& numPacketsRasterized)
 {
 	DE_ASSERT(maxFragmentPackets > 0);
@@ -134,6 +134,9 @@ public:
 	FaceType				getVisibleFace			(void) const { return m_face; }
 	void					rasterize				(FragmentPacket* const fragmentPackets, float* const depthValues, const int maxFragmentPackets, int& numPacketsRasterized);
 
+	//! Skip packets not intersecting rect. Must be called before rasterize(). Packet placement is not affected, so packets on rect boundary may contain fragments outside rect.
+	void					restrictToRect			(const tcu::IVec4& rect);
+
 private:
 	void					rasterizeSingleSample	(FragmentPacket* const fragmentPackets, float* const depthValues, const int maxFragmentPackets, int& numPacketsRasterized);
 
@@ -188,6 +191,9 @@ public:
 
 	void							resetStipple				() { m_stippleCounter = 0; }
 
+	//! Skip fragments not inside rect. Must be called before rasterize(). Not supported with line stipple.
+	void							restrictToRect				(const tcu::IVec4& rect);
+
 private:
 									SingleSampleLineRasterizer	(const SingleSampleLineRasterizer&); // not allowed
 	SingleSampleLineRasterizer&		operator=					(const SingleSampleLineRasterizer&); // not allowed
@@ -233,6 +239,9 @@ public:
 	// only available after init()
 	void						rasterize					(FragmentPacket* const fragmentPackets, float* const depthValues, const int maxFragmentPackets, int& numPacketsRasterized);
 
+	//! Skip packets not intersecting rect. Must be called before rasterize(). See TriangleRasterizer::restrictToRect().
+	void						restrictToRect				(const tcu::IVec4& rect);
+
 private:
 								MultiSampleLineRasterizer	(const MultiSampleLineRasterizer&); // not allowed
 	MultiSampleLineRasterizer&	operator=					(const MultiSampleLineRasterizer&); // not allowed
@@ -29,9 +29,16 @@
 #include "rrFragmentOperations.hpp"
 #include "rrRasterizer.hpp"
 #include "deMemory.h"
-
-#include <set>
+#include "deThread.hpp"
+#include "deMutex.hpp"
+#include "deSemaphore.hpp"
+#include "deSharedPtr.hpp"
+#include "deAtomic.h"
+
+#include <algorithm>
+#include <deque>
 #include <limits>
+#include <exception>
 
 namespace rr
 {
@@ -42,15 +49,98 @@ typedef double ClipFloat; // floating point type used in clipping
 
 typedef tcu::Vector<ClipFloat, 4> ClipVec4;
 
+enum
+{
+	RASTER_TILE_SIZE				= 32,		//!< Width and height of a tile in parallel rasterization
+	MIN_PARALLEL_RASTER_PIXELS		= 128*128	//!< Minimum total primitive bounding box area for parallel rasterization
+};
+
 struct RasterizationInternalBuffers
 {
 	std::vector<FragmentPacket>		fragmentPackets;
 	std::vector<GenericVec4>		shaderOutputs;
 	std::vector<GenericVec4>		shaderOutputsSrc1;
 	std::vector<Fragment>			shadedFragments;
+	std::vector<float>				depthValues;
 	float*							fragmentDepthBuffer;
+
+	RasterizationInternalBuffers (void)
+		: fragmentDepthBuffer(DE_NULL)
+	{
+	}
+};
+
+//! Reference to a vertex of an assembled primitive
+struct VertexSlot
+{
+	VertexPacket*	packet;
+	VertexPacket**	slot;		//!< Vertex pointer in primitive. Slots are in primitive list order.
+
+	bool operator< (const VertexSlot& other) const
+	{
+		if (packet != other.packet)
+			return (deUintptr)packet < (deUintptr)other.packet;
+		return (deUintptr)slot < (deUintptr)other.slot;
+	}
+};
+
+//! Vertex post-transform cache entry
+struct VertexCacheEntry
+{
+	size_t	vertexNdx;
+	size_t	elementNdx;	//!< Element relative to start of the primitive batch
+
+	bool operator< (const VertexCacheEntry& other) const
+	{
+		if (vertexNdx != other.vertexNdx)
+			return vertexNdx < other.vertexNdx;
+		return elementNdx < other.elementNdx;
+	}
+};
+
+template <typename Primitive>
+struct PrimitiveBuffers
+{
+	std::vector<Primitive>	assembled;	//!< Output of primitive assembly
+	std::vector<Primitive>	base;		//!< Primitives converted to base type
+	std::vector<Primitive>	clipped;	//!< Output of clipping
+};
+
+struct PrimitiveBufferSet : public PrimitiveBuffers<pa::Triangle>
+						  , public PrimitiveBuffers<pa::TriangleAdjacency>
+						  , public PrimitiveBuffers<pa::Line>
+						  , public PrimitiveBuffers<pa::LineAdjacency>
+						  , public PrimitiveBuffers<pa::Point>
+{
+	template <typename Primitive>
+	PrimitiveBuffers<Primitive>& get (void) { return *this; }
 };
 
+} // anonymous
+
+//! Buffers reused across draws made with the same Renderer
+struct DrawInternalBuffers
+{
+	VertexPacketAllocator			vertexAllocator;
+	VertexPacketAllocator			geometryAllocator;
+	std::vector<VertexPacket*>		vertexPackets;		//!< Packets to shade, one for each unique vertex
+	std::vector<VertexPacket*>		elementPackets;		//!< Shaded packet for each element
+	std::vector<VertexCacheEntry>	vertexCache;
+	std::vector<VertexSlot>			vertexSlots;
+	PrimitiveBufferSet				primitives;			//!< Primitives assembled from vertex shader output
+	PrimitiveBufferSet				geometryPrimitives;	//!< Primitives assembled from geometry shader output
+	RasterizationInternalBuffers	rasterization;
+
+	DrawInternalBuffers (void)
+		: vertexAllocator	(0)
+		, geometryAllocator	(0)
+	{
+	}
+};
+
+namespace
+{
+
 deUint32 readIndexArray (const IndexType type, const void* ptr, size_t ndx)
 {
 	switch (type)
@@ -92,10 +182,14 @@ bool isEmpty (const rr::MultisampleConstPixelBufferAccess& access)
 
 struct DrawContext
 {
-	int primitiveID;
+	int						primitiveID;
+	const RenderExecMode	execMode;
+	DrawInternalBuffers&	buffers;
 
-	DrawContext (void)
-		: primitiveID(0)
+	DrawContext (RenderExecMode execMode_, DrawInternalBuffers& buffers_)
+		: primitiveID	(0)
+		, execMode		(execMode_)
+		, buffers		(buffers_)
 	{
 	}
 };
@@ -522,6 +616,7 @@ void flatshadeVertices (const Program& program, ContainerType& list)
  * Clip triangles to the clip volume.
  *//*--------------------------------------------------------------------*/
 void clipPrimitives (std::vector<pa::Triangle>&		list,
+					 std::vector<pa::Triangle>&		outputTriangles,
 					 const Program&					program,
 					 bool							clipWithZPlanes,
 					 VertexPacketAllocator&			vpalloc)
@@ -539,7 +634,12 @@ void clipPrimitives (std::vector<pa::Triangle>&		list,
 	const ClipVolumePlane*						planes[]			= { &clipPosX, &clipNegX, &clipPosY, &clipNegY, &clipPosZ, &clipNegZ };
 	const int									numPlanes			= (clipWithZPlanes) ? (6) : (4);
 
-	std::vector<pa::Triangle>					outputTriangles;
+	// Clipping buffers are shared by all triangles
+	std::vector<SubTriangle>					subTriangles;
+	std::vector<SubTriangle>					nextPhaseSubTriangles;
+	std::vector<TriangleVertex>					convexPrimitive;
+
+	outputTriangles.clear();
 
 	for (int inputTriangleNdx = 0; inputTriangleNdx < (int)list.size(); ++inputTriangleNdx)
 	{
@@ -586,7 +686,9 @@ void clipPrimitives (std::vector<pa::Triangle>&		list,
 
 		// Clip
 		{
-			std::vector<SubTriangle>	subTriangles	(1);
+			subTriangles.clear();
+			subTriangles.resize(1);
+
 			SubTriangle&				initialTri		= subTriangles[0];
 
 			initialTri.vertices[0].position = vec4ToClipVec4(list[inputTriangleNdx].v0->position);
@@ -607,14 +709,14 @@ void clipPrimitives (std::vector<pa::Triangle>&		list,
 			// Clip all subtriangles to all relevant planes
 			for (int planeNdx = 0; planeNdx < numPlanes; ++planeNdx)
 			{
-				std::vector<SubTriangle> nextPhaseSubTriangles;
-
 				if (!clippedByPlane[planeNdx])
 					continue;
 
+				nextPhaseSubTriangles.clear();
+
 				for (int subTriangleNdx = 0; subTriangleNdx < (int)subTriangles.size(); ++subTriangleNdx)
 				{
-					std::vector<TriangleVertex> convexPrimitive;
+					convexPrimitive.clear();
 
 					// Clip triangle and form a convex n-gon ( n c {3, 4} )
 					clipTriangleToPlane(convexPrimitive, subTriangles[subTriangleNdx].vertices, *planes[planeNdx]);
@@ -667,6 +769,11 @@ void clipPrimitives (std::vector<pa::Triangle>&		list,
 				p1->position = clipVec4ToVec4(subTriangles[subTriangleNdx].vertices[1].position);
 				p2->position = clipVec4ToVec4(subTriangles[subTriangleNdx].vertices[2].position);
 
+				// packets may be recycled, do not leave primitive ID undefined
+				p0->primitiveID = list[inputTriangleNdx].v0->primitiveID;
+				p1->primitiveID = list[inputTriangleNdx].v1->primitiveID;
+				p2->primitiveID = list[inputTriangleNdx].v2->primitiveID;
+
 				for (size_t outputNdx = 0; outputNdx < fragInputs.size(); ++outputNdx)
 				{
 					if (fragInputs[outputNdx].type == GENERICVECTYPE_FLOAT)
@@ -712,6 +819,7 @@ void clipPrimitives (std::vector<pa::Triangle>&		list,
  * rasterization area selection).
  *//*--------------------------------------------------------------------*/
 void clipPrimitives (std::vector<pa::Line>&			list,
+					 std::vector<pa::Line>&			visibleLines,
 					 const Program&					program,
 					 bool							clipWithZPlanes,
 					 VertexPacketAllocator&			vpalloc)
@@ -723,12 +831,13 @@ void clipPrimitives (std::vector<pa::Line>&			list,
 	// Lines are clipped only by the far and the near planes here. Line clipping by other planes done in the rasterization phase
 
 	const std::vector<rr::VertexVaryingInfo>&	fragInputs	= (program.geometryShader) ? (program.geometryShader->getOutputs()) : (program.vertexShader->getOutputs());
-	std::vector<pa::Line>						visibleLines;
 
 	// Z-clipping disabled, don't do anything
 	if (!clipWithZPlanes)
 		return;
 
+	visibleLines.clear();
+
 	for (size_t ndx = 0; ndx < list.size(); ++ndx)
 	{
 		pa::Line& l = list[ndx];
@@ -775,7 +884,7 @@ void clipPrimitives (std::vector<pa::Line>&			list,
 	}
 
 	// return visible in list
-	std::swap(visibleLines, list);
+	list.swap(visibleLines);
 }
 
 /*--------------------------------------------------------------------*//*!
@@ -783,6 +892,7 @@ void clipPrimitives (std::vector<pa::Line>&			list,
  * of the viewport test.
  *//*--------------------------------------------------------------------*/
 void clipPrimitives (std::vector<pa::Point>&		list,
+					 std::vector<pa::Point>&		visiblePoints,
 					 const Program&					program,
 					 bool							clipWithZPlanes,
 					 VertexPacketAllocator&			vpalloc)
@@ -790,12 +900,12 @@ void clipPrimitives (std::vector<pa::Point>&		list,
 	DE_UNREF(vpalloc);
 	DE_UNREF(program);
 
-	std::vector<pa::Point> visiblePoints;
-
 	// Z-clipping disabled, don't do anything
 	if (!clipWithZPlanes)
 		return;
 
+	visiblePoints.clear();
+
 	for (size_t ndx = 0; ndx < list.size(); ++ndx)
 	{
 		pa::Point& p = list[ndx];
@@ -806,7 +916,7 @@ void clipPrimitives (std::vector<pa::Point>&		list,
 	}
 
 	// return visible in list
-	std::swap(visiblePoints, list);
+	list.swap(visiblePoints);
 }
 
 void transformVertexClipCoordsToWindowCoords (const RenderState& state, VertexPacket& packet)
@@ -861,55 +971,71 @@ void transformClipCoordsToWindowCoords (const RenderState& state, ContainerType&
 		transformPrimitiveClipCoordsToWindowCoords(state, *it);
 }
 
-void makeSharedVerticeDistinct (VertexPacket*& packet, std::set<VertexPacket*, std::less<void*> >& vertices, VertexPacketAllocator& vpalloc)
+void collectVertexSlots (pa::Triangle& target, std::vector<VertexSlot>& slots)
 {
-	// distinct
-	if (vertices.find(packet) == vertices.end())
-	{
-		vertices.insert(packet);
-	}
-	else
-	{
-		VertexPacket* newPacket = vpalloc.alloc();
+	const VertexSlot v0 = { target.v0, &target.v0 };
+	const VertexSlot v1 = { target.v1, &target.v1 };
+	const VertexSlot v2 = { target.v2, &target.v2 };
 
-		// copy packet output values
-		newPacket->position		= packet->position;
-		newPacket->pointSize	= packet->pointSize;
-		newPacket->primitiveID	= packet->primitiveID;
-
-		for (size_t outputNdx = 0; outputNdx < vpalloc.getNumVertexOutputs(); ++outputNdx)
-			newPacket->outputs[outputNdx] = packet->outputs[outputNdx];
-
-		// no need to insert new packet to "vertices" as newPacket is unique
-		packet = newPacket;
-	}
+	slots.push_back(v0);
+	slots.push_back(v1);
+	slots.push_back(v2);
 }
 
-void makeSharedVerticesDistinct (pa::Triangle& target, std::set<VertexPacket*, std::less<void*> >& vertices, VertexPacketAllocator& vpalloc)
+void collectVertexSlots (pa::Line& target, std::vector<VertexSlot>& slots)
 {
-	makeSharedVerticeDistinct(target.v0, vertices, vpalloc);
-	makeSharedVerticeDistinct(target.v1, vertices, vpalloc);
-	makeSharedVerticeDistinct(target.v2, vertices, vpalloc);
-}
+	const VertexSlot v0 = { target.v0, &target.v0 };
+	const VertexSlot v1 = { target.v1, &target.v1 };
 
-void makeSharedVerticesDistinct (pa::Line& target, std::set<VertexPacket*, std::less<void*> >& vertices, VertexPacketAllocator& vpalloc)
-{
-	makeSharedVerticeDistinct(target.v0, vertices, vpalloc);
-	makeSharedVerticeDistinct(target.v1, vertices, vpalloc);
+	slots.push_back(v0);
+	slots.push_back(v1);
 }
 
-void makeSharedVerticesDistinct (pa::Point& target, std::set<VertexPacket*, std::less<void*> >& vertices, VertexPacketAllocator& vpalloc)
+void collectVertexSlots (pa::Point& target, std::vector<VertexSlot>& slots)
 {
-	makeSharedVerticeDistinct(target.v0, vertices, vpalloc);
+	const VertexSlot v0 = { target.v0, &target.v0 };
+
+	slots.push_back(v0);
 }
 
+/*--------------------------------------------------------------------*//*!
+ * Give each primitive vertex its own packet. First reference to a packet
+ * in list order keeps the original, others get copies.
+ *
+ * Shared vertices are found by sorting vertex references by packet
+ * instead of using a set so that no per-vertex allocations are needed.
+ *//*--------------------------------------------------------------------*/
 template <typename ContainerType>
-void makeSharedVerticesDistinct (ContainerType& list, VertexPacketAllocator& vpalloc)
+void makeSharedVerticesDistinct (ContainerType& list, VertexPacketAllocator& vpalloc, std::vector<VertexSlot>& slots)
 {
-	std::set<VertexPacket*, std::less<void*> > vertices;
+	slots.clear();
 
 	for (typename ContainerType::iterator it = list.begin(); it != list.end(); ++it)
-		makeSharedVerticesDistinct(*it, vertices, vpalloc);
+		collectVertexSlots(*it, slots);
+
+	std::sort(slots.begin(), slots.end());
+
+	for (size_t slotNdx = 1; slotNdx < slots.size(); ++slotNdx)
+	{
+		const VertexPacket* const	packet		= slots[slotNdx].packet;
+
+		if (packet != slots[slotNdx-1].packet)
+			continue;
+
+		{
+			VertexPacket* const		newPacket	= vpalloc.alloc();
+
+			// copy packet output values
+			newPacket->position		= packet->position;
+			newPacket->pointSize	= packet->pointSize;
+			newPacket->primitiveID	= packet->primitiveID;
+
+			for (size_t outputNdx = 0; outputNdx < vpalloc.getNumVertexOutputs(); ++outputNdx)
+				newPacket->outputs[outputNdx] = packet->outputs[outputNdx];
+
+			*slots[slotNdx].slot = newPacket;
+		}
+	}
 }
 
 void generatePrimitiveIDs (pa::Triangle& target, int id)
@@ -1101,11 +1227,54 @@ void writeFragmentPackets (const RenderState&					state,
 	}
 }
 
+/*--------------------------------------------------------------------*//*!
+ * \brief Removes fragments outside rect from rasterized packets
+ *
+ * Coverage of fragments outside rect is cleared and packets left without
+ * coverage are removed. Returns number of remaining packets.
+ *//*--------------------------------------------------------------------*/
+int discardFragmentsOutsideRect (FragmentPacket* fragmentPackets, float* depthValues, int numPackets, int numSamples, const tcu::IVec4& rect)
+{
+	const int	numPacketDepthValues	= 4*numSamples;
+	int			numRemaining			= 0;
+
+	for (int packetNdx = 0; packetNdx < numPackets; ++packetNdx)
+	{
+		FragmentPacket& packet = fragmentPackets[packetNdx];
+
+		for (int fragNdx = 0; fragNdx < 4; fragNdx++)
+		{
+			const int	xo	= fragNdx%2;
+			const int	yo	= fragNdx/2;
+
+			if (!de::inBounds(packet.position.x() + xo, rect.x(), rect.x() + rect.z()) ||
+				!de::inBounds(packet.position.y() + yo, rect.y(), rect.y() + rect.w()))
+				packet.coverage &= ~getCoverageFragmentSampleBits(numSamples, xo, yo);
+		}
+
+		if (packet.coverage == 0)
+			continue;
+
+		if (numRemaining != packetNdx)
+		{
+			fragmentPackets[numRemaining] = packet;
+
+			if (depthValues)
+				deMemcpy(&depthValues[numRemaining*numPacketDepthValues], &depthValues[packetNdx*numPacketDepthValues], sizeof(float)*numPacketDepthValues);
+		}
+
+		numRemaining += 1;
+	}
+
+	return numRemaining;
+}
+
 void rasterizePrimitive (const RenderState&					state,
 						 const RenderTarget&				renderTarget,
 						 const Program&						program,
 						 const pa::Triangle&				triangle,
 						 const tcu::IVec4&					renderTargetRect,
+						 const tcu::IVec4&					tileRect,
 						 RasterizationInternalBuffers&		buffers)
 {
 	const int			numSamples		= renderTarget.getNumSamples();
@@ -1114,6 +1283,8 @@ void rasterizePrimitive (const RenderState&					state,
 	TriangleRasterizer	rasterizer		(renderTargetRect, numSamples, state.rasterization, state.subpixelBits);
 	float				depthOffset		= 0.0f;
 
+	const bool			isTiled			= tileRect != renderTargetRect;
+
 	rasterizer.init(triangle.v0->position, triangle.v1->position, triangle.v2->position);
 
 	// Culling
@@ -1122,6 +1293,9 @@ void rasterizePrimitive (const RenderState&					state,
 		(state.cullMode == CULLMODE_BACK	&& visibleFace == FACETYPE_BACK))
 		return;
 
+	if (isTiled)
+		rasterizer.restrictToRect(tileRect);
+
 	// Shading context
 	FragmentShadingContext shadingContext(triangle.v0->outputs, triangle.v1->outputs, triangle.v2->outputs, &buffers.shaderOutputs[0], &buffers.shaderOutputsSrc1[0], buffers.fragmentDepthBuffer, triangle.v2->primitiveID, (int)program.fragmentShader->getOutputs().size(), numSamples, rasterizer.getVisibleFace());
 
@@ -1149,6 +1323,15 @@ void rasterizePrimitive (const RenderState&					state,
 		if (!numRasterizedPackets)
 			break; // Rasterization finished.
 
+		// Only fragments inside tile are processed, rest are processed with other tiles
+		if (isTiled)
+		{
+			numRasterizedPackets = discardFragmentsOutsideRect(&buffers.fragmentPackets[0], buffers.fragmentDepthBuffer, numRasterizedPackets, numSamples, tileRect);
+
+			if (!numRasterizedPackets)
+				continue;
+		}
+
 		// Polygon offset
 		if (buffers.fragmentDepthBuffer && state.fragOps.polygonOffsetEnabled)
 			for (int sampleNdx = 0; sampleNdx < numRasterizedPackets * 4 * numSamples; ++sampleNdx)
@@ -1174,12 +1357,14 @@ void rasterizePrimitive (const RenderState&					state,
 						 const Program&						program,
 						 const pa::Line&					line,
 						 const tcu::IVec4&					renderTargetRect,
+						 const tcu::IVec4&					tileRect,
 						 RasterizationInternalBuffers&		buffers)
 {
 	const int					numSamples			= renderTarget.getNumSamples();
 	const float					depthClampMin		= de::min(state.viewport.zn, state.viewport.zf);
 	const float					depthClampMax		= de::max(state.viewport.zn, state.viewport.zf);
 	const bool					msaa				= numSamples > 1;
+	const bool					isTiled				= tileRect != renderTargetRect;
 	FragmentShadingContext		shadingContext		(line.v0->outputs, line.v1->outputs, DE_NULL, &buffers.shaderOutputs[0], &buffers.shaderOutputsSrc1[0], buffers.fragmentDepthBuffer, line.v1->primitiveID, (int)program.fragmentShader->getOutputs().size(), numSamples, FACETYPE_FRONT);
 	SingleSampleLineRasterizer	aliasedRasterizer	(renderTargetRect, state.subpixelBits);
 	MultiSampleLineRasterizer	msaaRasterizer		(numSamples, renderTargetRect, state.subpixelBits);
@@ -1190,6 +1375,14 @@ void rasterizePrimitive (const RenderState&					state,
 	else
 		aliasedRasterizer.init(line.v0->position, line.v1->position, state.line.lineWidth, 1, 0xFFFF);
 
+	if (isTiled)
+	{
+		if (msaa)
+			msaaRasterizer.restrictToRect(tileRect);
+		else
+			aliasedRasterizer.restrictToRect(tileRect);
+	}
+
 	for (;;)
 	{
 		const int	maxFragmentPackets		= (int)buffers.fragmentPackets.size();
@@ -1207,6 +1400,15 @@ void rasterizePrimitive (const RenderState&					state,
 		if (!numRasterizedPackets)
 			break; // Rasterization finished.
 
+		// Only fragments inside tile are processed, rest are processed with other tiles
+		if (isTiled)
+		{
+			numRasterizedPackets = discardFragmentsOutsideRect(&buffers.fragmentPackets[0], buffers.fragmentDepthBuffer, numRasterizedPackets, numSamples, tileRect);
+
+			if (!numRasterizedPackets)
+				continue;
+		}
+
 		// Shade
 
 		program.fragmentShader->shadeFragments(&buffers.fragmentPackets[0], numRasterizedPackets, shadingContext);
@@ -1227,6 +1429,7 @@ void rasterizePrimitive (const RenderState&					state,
 						 const Program&						program,
 						 const pa::Point&					point,
 						 const tcu::IVec4&					renderTargetRect,
+						 const tcu::IVec4&					tileRect,
 						 RasterizationInternalBuffers&		buffers)
 {
 	const int			numSamples		= renderTarget.getNumSamples();
@@ -1234,6 +1437,7 @@ void rasterizePrimitive (const RenderState&					state,
 	const float			depthClampMax	= de::max(state.viewport.zn, state.viewport.zf);
 	TriangleRasterizer	rasterizer1		(renderTargetRect, numSamples, state.rasterization, state.subpixelBits);
 	TriangleRasterizer	rasterizer2		(renderTargetRect, numSamples, state.rasterization, state.subpixelBits);
+	const bool			isTiled			= tileRect != renderTargetRect;
 
 	// draw point as two triangles
 	const float offset				= point.v0->pointSize / 2.0f;
@@ -1245,6 +1449,12 @@ void rasterizePrimitive (const RenderState&					state,
 	rasterizer1.init(w0, w1, w2);
 	rasterizer2.init(w0, w2, w3);
 
+	if (isTiled)
+	{
+		rasterizer1.restrictToRect(tileRect);
+		rasterizer2.restrictToRect(tileRect);
+	}
+
 	// Shading context
 	FragmentShadingContext shadingContext(point.v0->outputs, DE_NULL, DE_NULL, &buffers.shaderOutputs[0], &buffers.shaderOutputsSrc1[0], buffers.fragmentDepthBuffer, point.v0->primitiveID, (int)program.fragmentShader->getOutputs().size(), numSamples, FACETYPE_FRONT);
 
@@ -1272,6 +1482,15 @@ void rasterizePrimitive (const RenderState&					state,
 		if (!numRasterizedPackets)
 			break; // Rasterization finished.
 
+		// Only fragments inside tile are processed, rest are processed with other tiles
+		if (isTiled)
+		{
+			numRasterizedPackets = discardFragmentsOutsideRect(&buffers.fragmentPackets[0], buffers.fragmentDepthBuffer, numRasterizedPackets, numSamples, tileRect);
+
+			if (!numRasterizedPackets)
+				continue;
+		}
+
 		// Shade
 
 		program.fragmentShader->shadeFragments(&buffers.fragmentPackets[0], numRasterizedPackets, shadingContext);
@@ -1287,56 +1506,492 @@ void rasterizePrimitive (const RenderState&					state,
 	}
 }
 
+void initRasterizationBuffers (RasterizationInternalBuffers& buffers, const RenderTarget& renderTarget, const Program& program)
+{
+	const int		numSamples			= renderTarget.getNumSamples();
+	const int		numFragmentOutputs	= (int)program.fragmentShader->getOutputs().size();
+	const size_t	maxFragmentPackets	= 128;
+
+	buffers.fragmentPackets.resize(maxFragmentPackets);
+	buffers.shaderOutputs.resize(maxFragmentPackets*4*numFragmentOutputs);
+	buffers.shaderOutputsSrc1.resize(maxFragmentPackets*4*numFragmentOutputs);
+	buffers.shadedFragments.resize(maxFragmentPackets*4);
+
+	// calculate depth only if we have a depth buffer
+	if (!isEmpty(renderTarget.getDepthBuffer()))
+	{
+		buffers.depthValues.resize(maxFragmentPackets*4*numSamples);
+		buffers.fragmentDepthBuffer = &buffers.depthValues[0];
+	}
+	else
+		buffers.fragmentDepthBuffer = DE_NULL;
+}
+
+bool isFinite (const tcu::Vec4& v)
+{
+	for (int ndx = 0; ndx < 4; ++ndx)
+	{
+		if (!(de::abs(v[ndx]) <= std::numeric_limits<float>::max()))
+			return false;
+	}
+
+	return true;
+}
+
+//! Conservative window-space bounds (xMin, yMin, xMax, yMax) of pixels primitive may cover
+tcu::Vec4 getPrimitiveBounds (const RenderState&, const pa::Triangle& triangle)
+{
+	const tcu::Vec2	p0	= triangle.v0->position.swizzle(0, 1);
+	const tcu::Vec2	p1	= triangle.v1->position.swizzle(0, 1);
+	const tcu::Vec2	p2	= triangle.v2->position.swizzle(0, 1);
+	const float		pad	= 1.0f;
+
+	return tcu::Vec4(de::min(de::min(p0.x(), p1.x()), p2.x()) - pad,
+					 de::min(de::min(p0.y(), p1.y()), p2.y()) - pad,
+					 de::max(de::max(p0.x(), p1.x()), p2.x()) + pad,
+					 de::max(de::max(p0.y(), p1.y()), p2.y()) + pad);
+}
+
+tcu::Vec4 getPrimitiveBounds (const RenderState& state, const pa::Line& line)
+{
+	const tcu::Vec2	p0	= line.v0->position.swizzle(0, 1);
+	const tcu::Vec2	p1	= line.v1->position.swizzle(0, 1);
+	const float		pad	= de::max(state.line.lineWidth, 1.0f) + 2.0f; // wide lines are shifted and replicated in minor direction
+
+	return tcu::Vec4(de::min(p0.x(), p1.x()) - pad,
+					 de::min(p0.y(), p1.y()) - pad,
+					 de::max(p0.x(), p1.x()) + pad,
+					 de::max(p0.y(), p1.y()) + pad);
+}
+
+tcu::Vec4 getPrimitiveBounds (const RenderState&, const pa::Point& point)
+{
+	const tcu::Vec2	p	= point.v0->position.swizzle(0, 1);
+	const float		pad	= point.v0->pointSize / 2.0f + 1.0f;
+
+	return tcu::Vec4(p.x() - pad, p.y() - pad, p.x() + pad, p.y() + pad);
+}
+
+//! Conservative test whether primitive may cover pixels of rect (xMin, yMin, xMax, yMax). Primitive bounds must be finite.
+bool mayTouchRect (const RenderState&, const pa::Triangle&, const tcu::Vec4&)
+{
+	return true;
+}
+
+bool mayTouchRect (const RenderState& state, const pa::Line& line, const tcu::Vec4& rect)
+{
+	// Long diagonal lines only touch a fraction of tiles within their bounds
+	const tcu::Vec2	p0			= line.v0->position.swizzle(0, 1);
+	const tcu::Vec2	dir			= line.v1->position.swizzle(0, 1) - p0;
+	const float		length		= tcu::length(dir);
+	const float		pad			= de::max(state.line.lineWidth, 1.0f) + 2.0f;
+	const tcu::Vec2	center		= (rect.swizzle(0, 1) + rect.swizzle(2, 3)) * 0.5f;
+	const float		halfDiag	= tcu::length(rect.swizzle(2, 3) - rect.swizzle(0, 1)) * 0.5f;
+
+	if (!(length > 0.0f))
+		return true;
+
+	return de::abs(tcu::dot(center - p0, tcu::Vec2(-dir.y(), dir.x()) / length)) <= halfDiag + pad;
+}
+
+bool mayTouchRect (const RenderState&, const pa::Point&, const tcu::Vec4&)
+{
+	return true;
+}
+
+//! Upper bound for the number of pixels covered by primitives. Stops counting at MIN_PARALLEL_RASTER_PIXELS.
+template <typename ContainerType>
+double estimateCoveredArea (const RenderState& state, const ContainerType& list, const tcu::IVec4& renderTargetRect)
+{
+	const tcu::Vec4	rect	= tcu::Vec4((float)renderTargetRect.x(), (float)renderTargetRect.y(), (float)(renderTargetRect.x() + renderTargetRect.z()), (float)(renderTargetRect.y() + renderTargetRect.w()));
+	double			area	= 0.0;
+
+	for (size_t primitiveNdx = 0; primitiveNdx < list.size() && area < (double)MIN_PARALLEL_RASTER_PIXELS; ++primitiveNdx)
+	{
+		const tcu::Vec4	bounds	= getPrimitiveBounds(state, list[primitiveNdx]);
+
+		if (!isFinite(bounds))
+			return (double)renderTargetRect.z() * (double)renderTargetRect.w();
+
+		area += (double)de::max(0.0f, de::min(bounds.z(), rect.z()) - de::max(bounds.x(), rect.x()))
+			  * (double)de::max(0.0f, de::min(bounds.w(), rect.w()) - de::max(bounds.y(), rect.y()));
+	}
+
+	return area;
+}
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Tile-binned parallel rasterization
+ *
+ * Primitives are binned to screen-space tiles and tiles are rasterized in
+ * parallel. Each tile processes its primitives in submission order and
+ * rasterization of a primitive is not affected by tile boundaries, so the
+ * result is identical to serial rasterization.
+ *//*--------------------------------------------------------------------*/
+template <typename ContainerType>
+class RasterizeTileTask
+{
+public:
+									RasterizeTileTask	(const RenderState& state, const RenderTarget& renderTarget, const Program& program, const ContainerType& list, const tcu::IVec4& renderTargetRect);
+
+	//! Total area of primitive bounds in pixels, used for estimating cost.
+	double							getBinnedArea		(void) const { return m_binnedArea;		}
+	int								getNumActiveTiles	(void) const { return (int)m_activeTiles.size(); }
+
+	//! Rasterize tiles until none are left. Called by all participating threads.
+	void							rasterizeTiles		(RasterizationInternalBuffers& buffers);
+
+private:
+									RasterizeTileTask	(const RasterizeTileTask&);
+	RasterizeTileTask&				operator=			(const RasterizeTileTask&);
+
+	void							rasterizeTile		(int tileNdx, RasterizationInternalBuffers& buffers) const;
+
+	const RenderState&				m_state;
+	const RenderTarget&				m_renderTarget;
+	const Program&					m_program;
+	const ContainerType&			m_list;
+	const tcu::IVec4				m_renderTargetRect;
+	const int						m_numTilesX;
+	const int						m_numTilesY;
+
+	std::vector<std::vector<int> >	m_tilePrimitives;	//!< Primitive indices in submission order for each tile
+	std::vector<int>				m_activeTiles;		//!< Tiles with at least one primitive
+	double							m_binnedArea;
+	volatile deInt32				m_nextTile;
+};
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Persistent worker threads for parallel rasterization
+ *
+ * Workers are started on first parallel draw and shared by all renderers
+ * for the lifetime of the process. Jobs from concurrent draws are queued
+ * and run in submission order.
+ *//*--------------------------------------------------------------------*/
+class RasterizationJob
+{
+public:
+	virtual void				execute					(void) = 0;
+
+protected:
+								~RasterizationJob		(void) {}
+};
+
+class RasterizationWorkerPool
+{
+public:
+	static RasterizationWorkerPool&	getInstance			(void);
+
+	int							getNumWorkers			(void) const { return (int)m_workers.size(); }
+
+	//! Queue job for execution on a worker. Job must stay alive until it has been executed.
+	void						submit					(RasterizationJob* job);
+
+private:
+								RasterizationWorkerPool	(void);
+								~RasterizationWorkerPool(void);
+								RasterizationWorkerPool	(const RasterizationWorkerPool&);
+	RasterizationWorkerPool&	operator=				(const RasterizationWorkerPool&);
+
+	class Worker : public de::Thread
+	{
+	public:
+									Worker				(RasterizationWorkerPool& pool) : m_pool(pool) {}
+		void						run					(void);
+
+	private:
+		RasterizationWorkerPool&	m_pool;
+	};
+
+	RasterizationJob*			dequeue					(void);
+
+	de::Mutex						m_lock;
+	de::Semaphore					m_numQueued;
+	std::deque<RasterizationJob*>	m_jobs;				//!< Null job stops a worker
+	std::vector<Worker*>			m_workers;
+};
+
+RasterizationWorkerPool& RasterizationWorkerPool::getInstance (void)
+{
+	static RasterizationWorkerPool pool;
+	return pool;
+}
+
+RasterizationWorkerPool::RasterizationWorkerPool (void)
+	: m_numQueued	(0)
+{
+	// Calling thread takes part in rasterization
+	const int numWorkers = (int)deGetNumAvailableLogicalCores() - 1;
+
+	for (int workerNdx = 0; workerNdx < numWorkers; ++workerNdx)
+	{
+		Worker* worker = DE_NULL;
+
+		try
+		{
+			worker = new Worker(*this);
+			worker->start();
+			m_workers.push_back(worker);
+		}
+		catch (const std::exception&)
+		{
+			// Continue with workers started so far.
+			delete worker;
+			break;
+		}
+	}
+}
+
+RasterizationWorkerPool::~RasterizationWorkerPool (void)
+{
+	for (size_t workerNdx = 0; workerNdx < m_workers.size(); ++workerNdx)
+		submit(DE_NULL);
+
+	for (size_t workerNdx = 0; workerNdx < m_workers.size(); ++workerNdx)
+	{
+		m_workers[workerNdx]->join();
+		delete m_workers[workerNdx];
+	}
+}
+
+void RasterizationWorkerPool::submit (RasterizationJob* job)
+{
+	{
+		const de::ScopedLock lock (m_lock);
+		m_jobs.push_back(job);
+	}
+
+	m_numQueued.increment();
+}
+
+RasterizationJob* RasterizationWorkerPool::dequeue (void)
+{
+	m_numQueued.decrement();
+
+	{
+		const de::ScopedLock	lock	(m_lock);
+		RasterizationJob* const	job		= m_jobs.front();
+
+		m_jobs.pop_front();
+		return job;
+	}
+}
+
+void RasterizationWorkerPool::Worker::run (void)
+{
+	while (RasterizationJob* const job = m_pool.dequeue())
+		job->execute();
+}
+
+template <typename ContainerType>
+class RasterizeTileJob : public RasterizationJob
+{
+public:
+							RasterizeTileJob	(RasterizeTileTask<ContainerType>& task, RasterizationInternalBuffers& buffers, de::Semaphore& finished) : m_task(task), m_buffers(buffers), m_finished(finished) {}
+							~RasterizeTileJob	(void) {}
+
+	void					execute				(void)
+	{
+		try
+		{
+			m_task.rasterizeTiles(m_buffers);
+		}
+		catch (...)
+		{
+			m_exception = std::current_exception();
+		}
+
+		m_finished.increment();
+	}
+
+	//! Re-throw exception thrown by execute(), if any. Only valid after job has finished.
+	void					rethrowException	(void) const
+	{
+		if (m_exception)
+			std::rethrow_exception(m_exception);
+	}
+
+private:
+	RasterizeTileTask<ContainerType>&	m_task;
+	RasterizationInternalBuffers&		m_buffers;
+	de::Semaphore&						m_finished;
+	std::exception_ptr					m_exception;
+};
+
+template <typename ContainerType>
+RasterizeTileTask<ContainerType>::RasterizeTileTask (const RenderState& state, const RenderTarget& renderTarget, const Program& program, const ContainerType& list, const tcu::IVec4& renderTargetRect)
+	: m_state				(state)
+	, m_renderTarget		(renderTarget)
+	, m_program				(program)
+	, m_list				(list)
+	, m_renderTargetRect	(renderTargetRect)
+	, m_numTilesX			(de::max(0, deDivRoundUp32(renderTargetRect.z(), RASTER_TILE_SIZE)))
+	, m_numTilesY			(de::max(0, deDivRoundUp32(renderTargetRect.w(), RASTER_TILE_SIZE)))
+	, m_tilePrimitives		((size_t)(m_numTilesX*m_numTilesY))
+	, m_binnedArea			(0.0)
+	, m_nextTile			(0)
+{
+	if (m_tilePrimitives.empty())
+		return;
+
+	for (size_t primitiveNdx = 0; primitiveNdx < list.size(); ++primitiveNdx)
+	{
+		const tcu::Vec4	bounds		= getPrimitiveBounds(state, list[primitiveNdx]);
+		const tcu::Vec4	tileBounds	= (bounds - renderTargetRect.swizzle(0, 1, 0, 1).asFloat()) / float(RASTER_TILE_SIZE);
+		int				tileX0		= 0;
+		int				tileY0		= 0;
+		int				tileX1		= m_numTilesX-1;
+		int				tileY1		= m_numTilesY-1;
+
+		// Primitives with non-finite bounds are binned to all tiles.
+		if (isFinite(tileBounds))
+		{
+			const tcu::Vec4 clamped = tcu::clamp(tileBounds, tcu::Vec4(-1.0f), tcu::Vec4((float)m_numTilesX, (float)m_numTilesY, (float)m_numTilesX, (float)m_numTilesY));
+
+			tileX0 = de::max(deFloorFloatToInt32(clamped.x()), 0);
+			tileY0 = de::max(deFloorFloatToInt32(clamped.y()), 0);
+			tileX1 = de::min(deFloorFloatToInt32(clamped.z()), m_numTilesX-1);
+			tileY1 = de::min(deFloorFloatToInt32(clamped.w()), m_numTilesY-1);
+		}
+
+		for (int tileY = tileY0; tileY <= tileY1; ++tileY)
+		for (int tileX = tileX0; tileX <= tileX1; ++tileX)
+		{
+			const tcu::Vec4 tileRect = (tcu::Vec4((float)tileX, (float)tileY, (float)(tileX+1), (float)(tileY+1)) * float(RASTER_TILE_SIZE)) + renderTargetRect.swizzle(0, 1, 0, 1).asFloat();
+
+			if (isFinite(tileBounds) && !mayTouchRect(state, list[primitiveNdx], tileRect))
+				continue;
+
+			m_tilePrimitives[tileY*m_numTilesX + tileX].push_back((int)primitiveNdx);
+			m_binnedArea += double(RASTER_TILE_SIZE*RASTER_TILE_SIZE);
+		}
+	}
+
+	for (int tileNdx = 0; tileNdx < (int)m_tilePrimitives.size(); ++tileNdx)
+	{
+		if (!m_tilePrimitives[tileNdx].empty())
+			m_activeTiles.push_back(tileNdx);
+	}
+}
+
+template <typename ContainerType>
+void RasterizeTileTask<ContainerType>::rasterizeTile (int tileNdx, RasterizationInternalBuffers& buffers) const
+{
+	const int					tileX		= tileNdx % m_numTilesX;
+	const int					tileY		= tileNdx / m_numTilesX;
+	const tcu::IVec4			tileRect	= rectIntersection(tcu::IVec4(m_renderTargetRect.x() + tileX*RASTER_TILE_SIZE, m_renderTargetRect.y() + tileY*RASTER_TILE_SIZE, RASTER_TILE_SIZE, RASTER_TILE_SIZE), m_renderTargetRect);
+	const std::vector<int>&		primitives	= m_tilePrimitives[tileNdx];
+
+	for (size_t ndx = 0; ndx < primitives.size(); ++ndx)
+		rasterizePrimitive(m_state, m_renderTarget, m_program, m_list[primitives[ndx]], m_renderTargetRect, tileRect, buffers);
+}
+
+template <typename ContainerType>
+void RasterizeTileTask<ContainerType>::rasterizeTiles (RasterizationInternalBuffers& buffers)
+{
+	for (;;)
+	{
+		const int activeNdx = deAtomicIncrementInt32(&m_nextTile) - 1;
+
+		if (activeNdx >= (int)m_activeTiles.size())
+			break;
+
+		rasterizeTile(m_activeTiles[activeNdx], buffers);
+	}
+}
+
+template <typename ContainerType>
+bool rasterizeParallel (const RenderState&		state,
+						const RenderTarget&		renderTarget,
+						const Program&			program,
+						const ContainerType&	list,
+						const tcu::IVec4&		renderTargetRect)
+{
+	if (!program.fragmentShader->isThreadSafe())
+		return false;
+
+	// Cheap estimate first, binning is not free either
+	if (estimateCoveredArea(state, list, renderTargetRect) < (double)MIN_PARALLEL_RASTER_PIXELS)
+		return false;
+
+	RasterizationWorkerPool&			pool		= RasterizationWorkerPool::getInstance();
+	RasterizeTileTask<ContainerType>	task		(state, renderTarget, program, list, renderTargetRect);
+	const int							numJobs		= de::min(pool.getNumWorkers(), task.getNumActiveTiles() - 1);
+
+	if (numJobs <= 0 || task.getBinnedArea() < (double)MIN_PARALLEL_RASTER_PIXELS)
+		return false;
+
+	typedef de::SharedPtr<RasterizeTileJob<ContainerType> > JobSp;
+
+	// Buffers are allocated up front so that allocation failures are reported on this thread.
+	std::vector<RasterizationInternalBuffers>	buffers		((size_t)numJobs + 1);
+	std::vector<JobSp>							jobs;
+	de::Semaphore								finished	(0);
+	std::exception_ptr							exception;
+
+	for (size_t ndx = 0; ndx < buffers.size(); ++ndx)
+		initRasterizationBuffers(buffers[ndx], renderTarget, program);
+
+	for (int jobNdx = 0; jobNdx < numJobs; ++jobNdx)
+		jobs.push_back(JobSp(new RasterizeTileJob<ContainerType>(task, buffers[jobNdx + 1], finished)));
+
+	for (size_t jobNdx = 0; jobNdx < jobs.size(); ++jobNdx)
+		pool.submit(jobs[jobNdx].get());
+
+	// Jobs reference local state, so they must finish before leaving this function.
+	try
+	{
+		task.rasterizeTiles(buffers[0]);
+	}
+	catch (...)
+	{
+		exception = std::current_exception();
+	}
+
+	for (size_t jobNdx = 0; jobNdx < jobs.size(); ++jobNdx)
+		finished.decrement();
+
+	if (exception)
+		std::rethrow_exception(exception);
+
+	for (size_t jobNdx = 0; jobNdx < jobs.size(); ++jobNdx)
+		jobs[jobNdx]->rethrowException();
+
+	return true;
+}
+
 template <typename ContainerType>
 void rasterize (const RenderState&					state,
 				const RenderTarget&					renderTarget,
 				const Program&						program,
-				const ContainerType&				list)
+				const ContainerType&				list,
+				RenderExecMode						execMode,
+				RasterizationInternalBuffers&		buffers)
 {
-	const int						numSamples			= renderTarget.getNumSamples();
-	const int						numFragmentOutputs	= (int)program.fragmentShader->getOutputs().size();
-	const size_t					maxFragmentPackets	= 128;
-
 	const tcu::IVec4				viewportRect		= tcu::IVec4(state.viewport.rect.left, state.viewport.rect.bottom, state.viewport.rect.width, state.viewport.rect.height);
 	const tcu::IVec4				bufferRect			= getBufferSize(renderTarget.getColorBuffer(0));
 	const tcu::IVec4				renderTargetRect	= rectIntersection(viewportRect, bufferRect);
 
-	// shared buffers for all primitives
-	std::vector<FragmentPacket>		fragmentPackets		(maxFragmentPackets);
-	std::vector<GenericVec4>		shaderOutputs		(maxFragmentPackets*4*numFragmentOutputs);
-	std::vector<GenericVec4>		shaderOutputsSrc1	(maxFragmentPackets*4*numFragmentOutputs);
-	std::vector<Fragment>			shadedFragments		(maxFragmentPackets*4);
-	std::vector<float>				depthValues			(0);
-	float*							depthBufferPointer	= DE_NULL;
-
-	RasterizationInternalBuffers	buffers;
-
-	// calculate depth only if we have a depth buffer
-	if (!isEmpty(renderTarget.getDepthBuffer()))
-	{
-		depthValues.resize(maxFragmentPackets*4*numSamples);
-		depthBufferPointer = &depthValues[0];
-	}
+	// Small draws are not worth the threading overhead and are rasterized serially.
+	if (execMode == RENDEREXECMODE_PARALLEL && rasterizeParallel(state, renderTarget, program, list, renderTargetRect))
+		return;
 
-	// set buffers
-	buffers.fragmentPackets.swap(fragmentPackets);
-	buffers.shaderOutputs.swap(shaderOutputs);
-	buffers.shaderOutputsSrc1.swap(shaderOutputsSrc1);
-	buffers.shadedFragments.swap(shadedFragments);
-	buffers.fragmentDepthBuffer = depthBufferPointer;
+	// shared buffers for all primitives
+	initRasterizationBuffers(buffers, renderTarget, program);
 
 	// rasterize
 	for (typename ContainerType::const_iterator it = list.begin(); it != list.end(); ++it)
-		rasterizePrimitive(state, renderTarget, program, *it, renderTargetRect, buffers);
+		rasterizePrimitive(state, renderTarget, program, *it, renderTargetRect, renderTargetRect, buffers);
 }
 
 /*--------------------------------------------------------------------*//*!
  * Draws transformed triangles, lines or points to render target
  *//*--------------------------------------------------------------------*/
-template <typename ContainerType>
-void drawBasicPrimitives (const RenderState& state, const RenderTarget& renderTarget, const Program& program, ContainerType& primList, VertexPacketAllocator& vpalloc)
+template <typename Primitive>
+void drawBasicPrimitives (const RenderState& state, const RenderTarget& renderTarget, const Program& program, PrimitiveBuffers<Primitive>& primitives, const DrawContext& drawContext, VertexPacketAllocator& vpalloc)
 {
-	const bool clipZ = !state.fragOps.depthClampEnabled;
+	const bool				clipZ		= !state.fragOps.depthClampEnabled;
+	std::vector<Primitive>&	primList	= primitives.base;
 
 	// Transform feedback
 
@@ -1344,14 +1999,13 @@ void drawBasicPrimitives (const RenderState& state, const RenderTarget& renderTa
 	flatshadeVertices(program, primList);
 
 	// Clipping
-	// \todo [jarkko] is creating & swapping std::vectors really a good solution?
-	clipPrimitives(primList, program, clipZ, vpalloc);
+	clipPrimitives(primList, primitives.clipped, program, clipZ, vpalloc);
 
 	// Transform vertices to window coords
 	transformClipCoordsToWindowCoords(state, primList);
 
 	// Rasterize and paint
-	rasterize(state, renderTarget, program, primList);
+	rasterize(state, renderTarget, program, primList, drawContext.execMode, drawContext.buffers.rasterization);
 }
 
 void copyVertexPacketPointers(const VertexPacket** dst, const pa::Point& in)
@@ -1391,29 +2045,36 @@ void copyVertexPacketPointers(const VertexPacket** dst, const pa::TriangleAdjace
 }
 
 template <PrimitiveType DrawPrimitiveType> // \note DrawPrimitiveType  can only be Points, line_strip, or triangle_strip
-void drawGeometryShaderOutputAsPrimitives (const RenderState& state, const RenderTarget& renderTarget, const Program& program, VertexPacket* const* vertices, size_t numVertices, VertexPacketAllocator& vpalloc)
+void drawGeometryShaderOutputAsPrimitives (const RenderState& state, const RenderTarget& renderTarget, const Program& program, VertexPacket* const* vertices, size_t numVertices, const DrawContext& drawContext, VertexPacketAllocator& vpalloc)
 {
 	// Run primitive assembly for generated stream
 
+	typedef typename PrimitiveTypeTraits<DrawPrimitiveType>::BaseType		BaseType;
+
 	const size_t															assemblerPrimitiveCount		= PrimitiveTypeTraits<DrawPrimitiveType>::Assembler::getPrimitiveCount(numVertices);
-	std::vector<typename PrimitiveTypeTraits<DrawPrimitiveType>::BaseType>	inputPrimitives				(assemblerPrimitiveCount);
+	PrimitiveBuffers<BaseType>&												primitives					= drawContext.buffers.geometryPrimitives.get<BaseType>();
+	std::vector<BaseType>&													inputPrimitives				= primitives.base;
+
+	inputPrimitives.resize(assemblerPrimitiveCount);
 
 	PrimitiveTypeTraits<DrawPrimitiveType>::Assembler::exec(inputPrimitives.begin(), vertices, numVertices, state.provokingVertexConvention); // \note input Primitives are baseType_t => only basic primitives (non adjacency) will compile
 
 	// Make shared vertices distinct
 
-	makeSharedVerticesDistinct(inputPrimitives, vpalloc);
+	makeSharedVerticesDistinct(inputPrimitives, vpalloc, drawContext.buffers.vertexSlots);
 
 	// Draw assembled primitives
 
-	drawBasicPrimitives(state, renderTarget, program, inputPrimitives, vpalloc);
+	drawBasicPrimitives(state, renderTarget, program, primitives, drawContext, vpalloc);
 }
 
 template <PrimitiveType DrawPrimitiveType>
 void drawWithGeometryShader(const RenderState& state, const RenderTarget& renderTarget, const Program& program, std::vector<typename PrimitiveTypeTraits<DrawPrimitiveType>::Type>& input, DrawContext& drawContext)
 {
-	// Vertices outputted by geometry shader may have different number of output variables than the original, create new memory allocator
-	VertexPacketAllocator vpalloc(program.geometryShader->getOutputs().size());
+	// Vertices outputted by geometry shader may have different number of output variables than the original, use separate memory allocator
+	VertexPacketAllocator& vpalloc = drawContext.buffers.geometryAllocator;
+
+	vpalloc.reset(program.geometryShader->getOutputs().size());
 
 	// Run geometry shader for all primitives
 	GeometryEmitter					emitter			(vpalloc, program.geometryShader->getNumVerticesOut());
@@ -1461,9 +2122,9 @@ void drawWithGeometryShader(const RenderState& state, const RenderTarget& render
 
 			switch (program.geometryShader->getOutputType())
 			{
-				case rr::GEOMETRYSHADEROUTPUTTYPE_POINTS:			drawGeometryShaderOutputAsPrimitives<PRIMITIVETYPE_POINTS>			(state, renderTarget, program, &emitted[primitiveBegin], primitiveEnd-primitiveBegin, vpalloc); break;
-				case rr::GEOMETRYSHADEROUTPUTTYPE_LINE_STRIP:		drawGeometryShaderOutputAsPrimitives<PRIMITIVETYPE_LINE_STRIP>		(state, renderTarget, program, &emitted[primitiveBegin], primitiveEnd-primitiveBegin, vpalloc); break;
-				case rr::GEOMETRYSHADEROUTPUTTYPE_TRIANGLE_STRIP:	drawGeometryShaderOutputAsPrimitives<PRIMITIVETYPE_TRIANGLE_STRIP>	(state, renderTarget, program, &emitted[primitiveBegin], primitiveEnd-primitiveBegin, vpalloc); break;
+				case rr::GEOMETRYSHADEROUTPUTTYPE_POINTS:			drawGeometryShaderOutputAsPrimitives<PRIMITIVETYPE_POINTS>			(state, renderTarget, program, &emitted[primitiveBegin], primitiveEnd-primitiveBegin, drawContext, vpalloc); break;
+				case rr::GEOMETRYSHADEROUTPUTTYPE_LINE_STRIP:		drawGeometryShaderOutputAsPrimitives<PRIMITIVETYPE_LINE_STRIP>		(state, renderTarget, program, &emitted[primitiveBegin], primitiveEnd-primitiveBegin, drawContext, vpalloc); break;
+				case rr::GEOMETRYSHADEROUTPUTTYPE_TRIANGLE_STRIP:	drawGeometryShaderOutputAsPrimitives<PRIMITIVETYPE_TRIANGLE_STRIP>	(state, renderTarget, program, &emitted[primitiveBegin], primitiveEnd-primitiveBegin, drawContext, vpalloc); break;
 				default:
 					DE_ASSERT(DE_FALSE);
 			}
@@ -1481,8 +2142,13 @@ template <PrimitiveType DrawPrimitiveType>
 void drawAsPrimitives (const RenderState& state, const RenderTarget& renderTarget, const Program& program, VertexPacket* const* vertices, int numVertices, DrawContext& drawContext, VertexPacketAllocator& vpalloc)
 {
 	// Assemble primitives (deconstruct stips & loops)
+	typedef typename PrimitiveTypeTraits<DrawPrimitiveType>::Type			Type;
+	typedef typename PrimitiveTypeTraits<DrawPrimitiveType>::BaseType		BaseType;
+
 	const size_t															assemblerPrimitiveCount		= PrimitiveTypeTraits<DrawPrimitiveType>::Assembler::getPrimitiveCount(numVertices);
-	std::vector<typename PrimitiveTypeTraits<DrawPrimitiveType>::Type>		inputPrimitives				(assemblerPrimitiveCount);
+	std::vector<Type>&														inputPrimitives				= drawContext.buffers.primitives.get<Type>().assembled;
+
+	inputPrimitives.resize(assemblerPrimitiveCount);
 
 	PrimitiveTypeTraits<DrawPrimitiveType>::Assembler::exec(inputPrimitives.begin(), vertices, (size_t)numVertices, state.provokingVertexConvention);
 
@@ -1498,19 +2164,19 @@ void drawAsPrimitives (const RenderState& state, const RenderTarget& renderTarge
 	}
 	else
 	{
-		std::vector<typename PrimitiveTypeTraits<DrawPrimitiveType>::BaseType> basePrimitives;
+		PrimitiveBuffers<BaseType>&	basePrimitives	= drawContext.buffers.primitives.get<BaseType>();
 
 		// convert types from X_adjacency to X
-		convertPrimitiveToBaseType(basePrimitives, inputPrimitives);
+		convertPrimitiveToBaseType(basePrimitives.base, inputPrimitives);
 
 		// Make shared vertices distinct. Needed for that the translation to screen space happens only once per vertex, and for flatshading
-		makeSharedVerticesDistinct(basePrimitives, vpalloc);
+		makeSharedVerticesDistinct(basePrimitives.base, vpalloc, drawContext.buffers.vertexSlots);
 
 		// A primitive ID will be generated even if no geometry shader is active
-		generatePrimitiveIDs(basePrimitives, drawContext);
+		generatePrimitiveIDs(basePrimitives.base, drawContext);
 
 		// Draw as a basic type
-		drawBasicPrimitives(state, renderTarget, program, basePrimitives, vpalloc);
+		drawBasicPrimitives(state, renderTarget, program, basePrimitives, drawContext, vpalloc);
 	}
 }
 
@@ -1649,6 +2315,75 @@ bool isValidCommand (const DrawCommand& command, int numInstances)
 	return true;
 }
 
+void initVertexPacket (VertexPacket& packet, int instanceNdx, size_t vertexNdx, float pointSize)
+{
+	// input
+	packet.instanceNdx	= instanceNdx;
+	packet.vertexNdx	= (int)vertexNdx;
+
+	// output
+	packet.pointSize	= pointSize;				// default value from the current state
+	packet.position		= tcu::Vec4(0, 0, 0, 0);	// no undefined values
+}
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Set up vertex packets for a batch of elements
+ *
+ * Works as a post-transform vertex cache: elements referencing the same
+ * vertex share one packet so that vertex shader is run only once for
+ * each unique vertex. Packets to shade are stored to the beginning of
+ * buffers.vertexPackets and the packet of each element to
+ * buffers.elementPackets.
+ *
+ * \return Number of packets to shade
+ *//*--------------------------------------------------------------------*/
+size_t setupVertexPackets (const PrimitiveList& primitives, size_t firstElementNdx, size_t numElements, int instanceNdx, float pointSize, DrawInternalBuffers& buffers)
+{
+	std::vector<VertexPacket*>&	vertexPackets	= buffers.vertexPackets;
+	std::vector<VertexPacket*>&	elementPackets	= buffers.elementPackets;
+
+	DE_ASSERT(numElements <= vertexPackets.size());
+
+	elementPackets.resize(numElements);
+
+	if (!primitives.isIndexed())
+	{
+		// Implicit indices are unique
+		for (size_t elementNdx = 0; elementNdx < numElements; ++elementNdx)
+		{
+			initVertexPacket(*vertexPackets[elementNdx], instanceNdx, primitives.getIndex(firstElementNdx + elementNdx), pointSize);
+			elementPackets[elementNdx] = vertexPackets[elementNdx];
+		}
+
+		return numElements;
+	}
+	else
+	{
+		std::vector<VertexCacheEntry>&	cache		= buffers.vertexCache;
+		size_t							numUnique	= 0;
+
+		cache.resize(numElements);
+
+		for (size_t elementNdx = 0; elementNdx < numElements; ++elementNdx)
+		{
+			cache[elementNdx].vertexNdx		= primitives.getIndex(firstElementNdx + elementNdx);
+			cache[elementNdx].elementNdx	= elementNdx;
+		}
+
+		std::sort(cache.begin(), cache.end());
+
+		for (size_t entryNdx = 0; entryNdx < numElements; ++entryNdx)
+		{
+			if (entryNdx == 0 || cache[entryNdx].vertexNdx != cache[entryNdx-1].vertexNdx)
+				initVertexPacket(*vertexPackets[numUnique++], instanceNdx, cache[entryNdx].vertexNdx, pointSize);
+
+			elementPackets[cache[entryNdx].elementNdx] = vertexPackets[numUnique-1];
+		}
+
+		return numUnique;
+	}
+}
+
 } // anonymous
 
 RenderTarget::RenderTarget (const MultisamplePixelBufferAccess& colorMultisampleBuffer,
@@ -1739,43 +2474,22 @@ bool PrimitiveList::isRestartIndex (size_t elementNdx, deUint32 restartIndex) co
 		return elementNdx == (size_t)restartIndex;
 }
 
-Renderer::Renderer (void)
-{
-}
-
-Renderer::~Renderer (void)
-{
-}
-
-void Renderer::draw (const DrawCommand& command) const
+namespace
 {
-	drawInstanced(command, 1);
-}
 
-void Renderer::drawInstanced (const DrawCommand& command, int numInstances) const
+void drawInstancedWithBuffers (const DrawCommand& command, int numInstances, RenderExecMode execMode, DrawInternalBuffers& buffers)
 {
-	// Do not run bad commands
-	{
-		const bool validCommand = isValidCommand(command, numInstances);
-		if (!validCommand)
-		{
-			DE_ASSERT(false);
-			return;
-		}
-	}
-
-	// Do not draw if nothing to draw
-	{
-		if (command.primitives.getNumElements() == 0 || numInstances == 0)
-			return;
-	}
-
 	// Prepare transformation
 
-	const size_t				numVaryings = command.program.vertexShader->getOutputs().size();
-	VertexPacketAllocator		vpalloc(numVaryings);
-	std::vector<VertexPacket*>	vertexPackets = vpalloc.allocArray(command.primitives.getNumElements());
-	DrawContext					drawContext;
+	const size_t				numVaryings		= command.program.vertexShader->getOutputs().size();
+	VertexPacketAllocator&		vpalloc			= buffers.vertexAllocator;
+	std::vector<VertexPacket*>&	vertexPackets	= buffers.vertexPackets;
+	DrawContext					drawContext		(execMode, buffers);
+
+	// Packets from previous draws are no longer referenced
+	vpalloc.reset(numVaryings);
+	vertexPackets.resize(command.primitives.getNumElements());
+	vpalloc.allocArray(vertexPackets.size(), &vertexPackets[0]);
 
 	for (int instanceID = 0; instanceID < numInstances; ++instanceID)
 	{
@@ -1784,50 +2498,41 @@ void Renderer::drawInstanced (const DrawCommand& command, int numInstances) cons
 
 		for (size_t elementNdx = 0; elementNdx < command.primitives.getNumElements(); ++elementNdx)
 		{
-			int numVertexPackets = 0;
+			const size_t firstElementNdx = elementNdx;
 
 			// collect primitive vertices until restart
 
 			while (elementNdx < command.primitives.getNumElements() &&
 					!(command.state.restart.enabled && command.primitives.isRestartIndex(elementNdx, command.state.restart.restartIndex)))
-			{
-				// input
-				vertexPackets[numVertexPackets]->instanceNdx	= instanceID;
-				vertexPackets[numVertexPackets]->vertexNdx		= (int)command.primitives.getIndex(elementNdx);
-
-				// output
-				vertexPackets[numVertexPackets]->pointSize		= command.state.point.pointSize;	// default value from the current state
-				vertexPackets[numVertexPackets]->position		= tcu::Vec4(0, 0, 0, 0);			// no undefined values
-
-				++numVertexPackets;
 				++elementNdx;
-			}
 
 			// Duplicated restart shade
-			if (numVertexPackets == 0)
+			if (elementNdx == firstElementNdx)
 				continue;
 
-			// \todo Vertex cache?
-
 			// Transform vertices
 
-			command.program.vertexShader->shadeVertices(command.vertexAttribs, &vertexPackets[0], numVertexPackets);
+			const int			numVertexPackets	= (int)(elementNdx - firstElementNdx);
+			const size_t		numShadedPackets	= setupVertexPackets(command.primitives, firstElementNdx, (size_t)numVertexPackets, instanceID, command.state.point.pointSize, buffers);
+			VertexPacket**		elementPackets		= &buffers.elementPackets[0];
+
+			command.program.vertexShader->shadeVertices(command.vertexAttribs, &vertexPackets[0], (int)numShadedPackets);
 
 			// Draw primitives
 
 			switch (command.primitives.getPrimitiveType())
 			{
-				case PRIMITIVETYPE_TRIANGLES:				{ drawAsPrimitives<PRIMITIVETYPE_TRIANGLES>					(command.state, command.renderTarget, command.program, &vertexPackets[0], numVertexPackets, drawContext, vpalloc);	break; }
-				case PRIMITIVETYPE_TRIANGLE_STRIP:			{ drawAsPrimitives<PRIMITIVETYPE_TRIANGLE_STRIP>			(command.state, command.renderTarget, command.program, &vertexPackets[0], numVertexPackets, drawContext, vpalloc);	break; }
-				case PRIMITIVETYPE_TRIANGLE_FAN:			{ drawAsPrimitives<PRIMITIVETYPE_TRIANGLE_FAN>				(command.state, command.renderTarget, command.program, &vertexPackets[0], numVertexPackets, drawContext, vpalloc);	break; }
-				case PRIMITIVETYPE_LINES:					{ drawAsPrimitives<PRIMITIVETYPE_LINES>						(command.state, command.renderTarget, command.program, &vertexPackets[0], numVertexPackets, drawContext, vpalloc);	break; }
-				case PRIMITIVETYPE_LINE_STRIP:				{ drawAsPrimitives<PRIMITIVETYPE_LINE_STRIP>				(command.state, command.renderTarget, command.program, &vertexPackets[0], numVertexPackets, drawContext, vpalloc);	break; }
-				case PRIMITIVETYPE_LINE_LOOP:				{ drawAsPrimitives<PRIMITIVETYPE_LINE_LOOP>					(command.state, command.renderTarget, command.program, &vertexPackets[0], numVertexPackets, drawContext, vpalloc);	break; }
-				case PRIMITIVETYPE_POINTS:					{ drawAsPrimitives<PRIMITIVETYPE_POINTS>					(command.state, command.renderTarget, command.program, &vertexPackets[0], numVertexPackets, drawContext, vpalloc);	break; }
-				case PRIMITIVETYPE_LINES_ADJACENCY:			{ drawAsPrimitives<PRIMITIVETYPE_LINES_ADJACENCY>			(command.state, command.renderTarget, command.program, &vertexPackets[0], numVertexPackets, drawContext, vpalloc);	break; }
-				case PRIMITIVETYPE_LINE_STRIP_ADJACENCY:	{ drawAsPrimitives<PRIMITIVETYPE_LINE_STRIP_ADJACENCY>		(command.state, command.renderTarget, command.program, &vertexPackets[0], numVertexPackets, drawContext, vpalloc);	break; }
-				case PRIMITIVETYPE_TRIANGLES_ADJACENCY:		{ drawAsPrimitives<PRIMITIVETYPE_TRIANGLES_ADJACENCY>		(command.state, command.renderTarget, command.program, &vertexPackets[0], numVertexPackets, drawContext, vpalloc);	break; }
-				case PRIMITIVETYPE_TRIANGLE_STRIP_ADJACENCY:{ drawAsPrimitives<PRIMITIVETYPE_TRIANGLE_STRIP_ADJACENCY>	(command.state, command.renderTarget, command.program, &vertexPackets[0], numVertexPackets, drawContext, vpalloc);	break; }
+				case PRIMITIVETYPE_TRIANGLES:				{ drawAsPrimitives<PRIMITIVETYPE_TRIANGLES>					(command.state, command.renderTarget, command.program, elementPackets, numVertexPackets, drawContext, vpalloc);	break; }
+				case PRIMITIVETYPE_TRIANGLE_STRIP:			{ drawAsPrimitives<PRIMITIVETYPE_TRIANGLE_STRIP>			(command.state, command.renderTarget, command.program, elementPackets, numVertexPackets, drawContext, vpalloc);	break; }
+				case PRIMITIVETYPE_TRIANGLE_FAN:			{ drawAsPrimitives<PRIMITIVETYPE_TRIANGLE_FAN>				(command.state, command.renderTarget, command.program, elementPackets, numVertexPackets, drawContext, vpalloc);	break; }
+				case PRIMITIVETYPE_LINES:					{ drawAsPrimitives<PRIMITIVETYPE_LINES>						(command.state, command.renderTarget, command.program, elementPackets, numVertexPackets, drawContext, vpalloc);	break; }
+				case PRIMITIVETYPE_LINE_STRIP:				{ drawAsPrimitives<PRIMITIVETYPE_LINE_STRIP>				(command.state, command.renderTarget, command.program, elementPackets, numVertexPackets, drawContext, vpalloc);	break; }
+				case PRIMITIVETYPE_LINE_LOOP:				{ drawAsPrimitives<PRIMITIVETYPE_LINE_LOOP>					(command.state, command.renderTarget, command.program, elementPackets, numVertexPackets, drawContext, vpalloc);	break; }
+				case PRIMITIVETYPE_POINTS:					{ drawAsPrimitives<PRIMITIVETYPE_POINTS>					(command.state, command.renderTarget, command.program, elementPackets, numVertexPackets, drawContext, vpalloc);	break; }
+				case PRIMITIVETYPE_LINES_ADJACENCY:			{ drawAsPrimitives<PRIMITIVETYPE_LINES_ADJACENCY>			(command.state, command.renderTarget, command.program, elementPackets, numVertexPackets, drawContext, vpalloc);	break; }
+				case PRIMITIVETYPE_LINE_STRIP_ADJACENCY:	{ drawAsPrimitives<PRIMITIVETYPE_LINE_STRIP_ADJACENCY>		(command.state, command.renderTarget, command.program, elementPackets, numVertexPackets, drawContext, vpalloc);	break; }
+				case PRIMITIVETYPE_TRIANGLES_ADJACENCY:		{ drawAsPrimitives<PRIMITIVETYPE_TRIANGLES_ADJACENCY>		(command.state, command.renderTarget, command.program, elementPackets, numVertexPackets, drawContext, vpalloc);	break; }
+				case PRIMITIVETYPE_TRIANGLE_STRIP_ADJACENCY:{ drawAsPrimitives<PRIMITIVETYPE_TRIANGLE_STRIP_ADJACENCY>	(command.state, command.renderTarget, command.program, elementPackets, numVertexPackets, drawContext, vpalloc);	break; }
 				default:
 					DE_ASSERT(DE_FALSE);
 			}
@@ -1835,4 +2540,63 @@ void Renderer::drawInstanced (const DrawCommand& command, int numInstances) cons
 	}
 }
 
+} // anonymous
+
+Renderer::Renderer (RenderExecMode execMode)
+	: m_execMode	(execMode)
+	, m_buffers		(new DrawInternalBuffers())
+{
+	DE_ASSERT(de::inBounds(execMode, RENDEREXECMODE_SERIAL, RENDEREXECMODE_LAST));
+}
+
+Renderer::~Renderer (void)
+{
+}
+
+void Renderer::draw (const DrawCommand& command) const
+{
+	drawInstanced(command, 1);
+}
+
+void Renderer::drawInstanced (const DrawCommand& command, int numInstances) const
+{
+	// Do not run bad commands
+	{
+		const bool validCommand = isValidCommand(command, numInstances);
+		if (!validCommand)
+		{
+			DE_ASSERT(false);
+			return;
+		}
+	}
+
+	// Do not draw if nothing to draw
+	{
+		if (command.primitives.getNumElements() == 0 || numInstances == 0)
+			return;
+	}
+
+	// Concurrent draws with the same renderer use temporary buffers
+	if (m_bufferLock.tryLock())
+	{
+		try
+		{
+			drawInstancedWithBuffers(command, numInstances, m_execMode, *m_buffers);
+		}
+		catch (...)
+		{
+			m_bufferLock.unlock();
+			throw;
+		}
+
+		m_bufferLock.unlock();
+	}
+	else
+	{
+		DrawInternalBuffers buffers;
+
+		drawInstancedWithBuffers(command, numInstances, m_execMode, buffers);
+	}
+}
+
 } // rr
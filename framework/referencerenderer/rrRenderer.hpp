@@ -29,10 +29,14 @@
 #include "rrPrimitiveTypes.hpp"
 #include "rrMultisamplePixelBufferAccess.hpp"
 #include "tcuTexture.hpp"
+#include "deUniquePtr.hpp"
+#include "deMutex.hpp"
 
 namespace rr
 {
 
+struct DrawInternalBuffers;
+
 class RenderTarget
 {
 public:
@@ -97,6 +101,7 @@ public:
 	inline size_t			getNumElements		(void) const	{ return m_numElements;		}
 	inline PrimitiveType	getPrimitiveType	(void) const	{ return m_primitiveType;	}
 	inline IndexType		getIndexType		(void) const	{ return m_indexType;		}
+	inline bool				isIndexed			(void) const	{ return m_indices != DE_NULL;	}
 
 private:
 	const PrimitiveType		m_primitiveType;
@@ -129,14 +134,38 @@ public:
 	const PrimitiveList&		primitives;
 } DE_WARN_UNUSED_TYPE;
 
+enum RenderExecMode
+{
+	RENDEREXECMODE_SERIAL = 0,		//!< Rasterize and shade on calling thread.
+	RENDEREXECMODE_PARALLEL,		//!< Rasterize and shade screen tiles on multiple threads. Falls back to serial if fragment shader is not thread-safe.
+
+	RENDEREXECMODE_LAST
+};
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Reference renderer
+ *
+ * Renderer keeps its internal vertex, primitive and fragment buffers
+ * between draws so that repeated draws do not need to allocate memory.
+ * Draws may be issued concurrently from multiple threads. A draw that
+ * finds the buffers in use renders with temporary buffers instead.
+ *//*--------------------------------------------------------------------*/
 class Renderer
 {
 public:
-					Renderer		(void);
-					~Renderer		(void);
+	explicit								Renderer		(RenderExecMode execMode = RENDEREXECMODE_SERIAL);
+											~Renderer		(void);
+
+	void									draw			(const DrawCommand& command) const;
+	void									drawInstanced	(const DrawCommand& command, int numInstances) const;
+
+private:
+											Renderer		(const Renderer&); // disabled, non-copyable
+	Renderer&								operator=		(const Renderer&); // disabled, non-copyable
 
-	void			draw			(const DrawCommand& command) const;
-	void			drawInstanced	(const DrawCommand& command, int numInstances) const;
+	const RenderExecMode					m_execMode;
+	const de::UniquePtr<DrawInternalBuffers>	m_buffers;
+	mutable de::Mutex						m_bufferLock;		//!< Held while m_buffers are in use
 } DE_WARN_UNUSED_TYPE;
 
 } // rr
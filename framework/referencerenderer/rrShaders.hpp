@@ -129,6 +129,10 @@ public:
 
 	virtual void							shadeFragments		(FragmentPacket* packets, const int numPackets, const FragmentShadingContext& context) const = 0; // \note numPackets must be greater than zero.
 
+	//! Can shadeFragments() be called concurrently from multiple threads. Required by RENDEREXECMODE_PARALLEL, see rrRenderer.hpp.
+	//! \note Shaders must opt in, only shaders that don't modify any state during shading are thread-safe.
+	virtual bool							isThreadSafe		(void) const	{ return false;		}
+
 protected:
 											~FragmentShader		(void) {} // \note Renderer will not delete any objects passed in.
 
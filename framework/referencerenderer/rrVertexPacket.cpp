@@ -34,57 +34,106 @@ VertexPacket::~VertexPacket (void)
 {
 }
 
+namespace
+{
+
+enum
+{
+	MIN_BLOCK_SIZE	= 16*1024	//!< Size of first allocated block in bytes, subsequent blocks double in size
+};
+
+size_t getPacketSize (size_t numberOfVertexOutputs)
+{
+	const size_t extraVaryings = (numberOfVertexOutputs == 0) ? (0) : (numberOfVertexOutputs-1);
+	return sizeof(VertexPacket) + extraVaryings * sizeof(GenericVec4);
+}
+
+} // anonymous
+
 VertexPacketAllocator::VertexPacketAllocator (const size_t numberOfVertexOutputs)
-	: m_numberOfVertexOutputs(numberOfVertexOutputs)
+	: m_numberOfVertexOutputs	(numberOfVertexOutputs)
+	, m_packetSize				(getPacketSize(numberOfVertexOutputs))
+	, m_curBlockNdx				(0)
+	, m_curBlockOffset			(0)
 {
 }
 
 VertexPacketAllocator::~VertexPacketAllocator (void)
 {
-	for (size_t i = 0; i < m_allocations.size(); ++i)
-		delete [] m_allocations[i];
-	m_allocations.clear();
+	for (size_t i = 0; i < m_blocks.size(); ++i)
+		delete [] m_blocks[i].data;
+	m_blocks.clear();
 }
 
-std::vector<VertexPacket*> VertexPacketAllocator::allocArray (size_t count)
+void VertexPacketAllocator::reset (const size_t numberOfVertexOutputs)
 {
-	if (!count)
-		return std::vector<VertexPacket*>();
-
-	const size_t extraVaryings	= (m_numberOfVertexOutputs == 0) ? (0) : (m_numberOfVertexOutputs-1);
-	const size_t packetSize		= sizeof(VertexPacket) + extraVaryings * sizeof(GenericVec4);
-
-	std::vector<VertexPacket*>	retVal;
-	deInt8*						ptr = new deInt8[packetSize * count]; // throws bad_alloc => ok
+	m_numberOfVertexOutputs	= numberOfVertexOutputs;
+	m_packetSize			= getPacketSize(numberOfVertexOutputs);
+	m_curBlockNdx			= 0;
+	m_curBlockOffset		= 0;
+}
 
-	// *.push_back might throw bad_alloc
-	try
+deInt8* VertexPacketAllocator::allocBytes (size_t numBytes)
+{
+	// Use remaining space in current or following blocks
+	for (; m_curBlockNdx < m_blocks.size(); ++m_curBlockNdx, m_curBlockOffset = 0)
 	{
-		// run ctors
-		for (size_t i = 0; i < count; ++i)
-			retVal.push_back(new (ptr + i*packetSize) VertexPacket()); // throws bad_alloc
-
-		m_allocations.push_back(ptr); // throws bad_alloc
+		const Block& block = m_blocks[m_curBlockNdx];
+
+		if (m_curBlockOffset + numBytes <= block.size)
+		{
+			deInt8* const ptr = block.data + m_curBlockOffset;
+			m_curBlockOffset += numBytes;
+			return ptr;
+		}
 	}
-	catch (std::bad_alloc& )
+
+	// Allocate new block
 	{
-		delete [] ptr;
-		throw;
+		const size_t	prevSize	= (m_blocks.empty()) ? (0) : (m_blocks.back().size);
+		Block			block;
+
+		m_blocks.reserve(m_blocks.size() + 1); // throws bad_alloc => ok
+
+		block.size	= de::max(de::max((size_t)MIN_BLOCK_SIZE, 2 * prevSize), numBytes);
+		block.data	= new deInt8[block.size]; // throws bad_alloc => ok
+
+		m_blocks.push_back(block);
+
+		m_curBlockNdx		= m_blocks.size() - 1;
+		m_curBlockOffset	= numBytes;
+
+		return block.data;
 	}
+}
+
+std::vector<VertexPacket*> VertexPacketAllocator::allocArray (size_t count)
+{
+	if (!count)
+		return std::vector<VertexPacket*>();
+
+	std::vector<VertexPacket*> retVal (count); // throws bad_alloc => ok
+
+	allocArray(count, &retVal[0]);
 
 	return retVal;
 }
 
-VertexPacket* VertexPacketAllocator::alloc (void)
+void VertexPacketAllocator::allocArray (size_t count, VertexPacket** packets)
 {
-	const size_t poolSize = 8;
+	if (!count)
+		return;
 
-	if (m_singleAllocPool.empty())
-		m_singleAllocPool = allocArray(poolSize);
+	deInt8* const ptr = allocBytes(m_packetSize * count); // throws bad_alloc => ok
 
-	VertexPacket* packet = *--m_singleAllocPool.end();
-	m_singleAllocPool.pop_back();
-	return packet;
+	// run ctors
+	for (size_t i = 0; i < count; ++i)
+		packets[i] = new (ptr + i*m_packetSize) VertexPacket();
+}
+
+VertexPacket* VertexPacketAllocator::alloc (void)
+{
+	return new (allocBytes(m_packetSize)) VertexPacket(); // throws bad_alloc => ok
 }
 
 } // rr
@@ -85,9 +85,13 @@ private:
  *
  * Vertex packet must have enough space allocated for its outputs.
  *
+ * Packets are allocated linearly from large memory blocks. reset()
+ * releases all packets at once but keeps the blocks, so that the same
+ * allocator can be reused for subsequent draws without heap allocations.
+ *
  * All memory allocated for vertex packets is released when VertexPacketAllocator
  * is destroyed. Allocated vertex packets should not be accessed after
- * allocator is destroyed.
+ * allocator is destroyed or reset.
  *
  * alloc and allocArray will throw bad_alloc if allocation fails.
  *//*--------------------------------------------------------------------*/
@@ -98,17 +102,31 @@ public:
 								~VertexPacketAllocator	(void);
 
 	std::vector<VertexPacket*>	allocArray				(size_t count); // throws bad_alloc
+	void						allocArray				(size_t count, VertexPacket** packets); // throws bad_alloc
 	VertexPacket*				alloc					(void);			// throws bad_alloc
 
+	//! Release all packets and change number of outputs for new packets.
+	void						reset					(const size_t numberOfVertexOutputs);
+
 	inline size_t				getNumVertexOutputs		(void) const	{ return m_numberOfVertexOutputs; }
 
 private:
 								VertexPacketAllocator	(const VertexPacketAllocator&); // disabled, non-copyable
 	VertexPacketAllocator&		operator=				(const VertexPacketAllocator&); // disabled, non-copyable
 
-	const size_t				m_numberOfVertexOutputs;
-	std::vector<deInt8*>		m_allocations;
-	std::vector<VertexPacket*>	m_singleAllocPool;
+	struct Block
+	{
+		deInt8*					data;
+		size_t					size;
+	};
+
+	deInt8*						allocBytes				(size_t numBytes); // throws bad_alloc
+
+	size_t						m_numberOfVertexOutputs;
+	size_t						m_packetSize;
+	std::vector<Block>			m_blocks;
+	size_t						m_curBlockNdx;
+	size_t						m_curBlockOffset;
 } DE_WARN_UNUSED_TYPE;
 
 } // rr
@@ -33,6 +33,10 @@
 #include "deUniquePtr.hpp"
 #include "deSharedPtr.hpp"
 #include "deArrayUtil.hpp"
+#include "deThread.hpp"
+#include "deAtomic.h"
+#include "deMutex.hpp"
+#include "deSemaphore.hpp"
 
 #include "tcuCommandLine.hpp"
 #include "tcuFloatFormat.hpp"
@@ -57,6 +61,7 @@
 #include <map>
 #include <utility>
 #include <limits>
+#include <deque>
 
 // Uncomment this to get evaluation trace dumps to std::cerr
 // #define GLS_ENABLE_TRACE
@@ -70,7 +75,10 @@ enum
 	// platforms where toggling floating-point rounding mode is slow (emulated arm on x86).
 	// As a workaround watchdog is kept happy by touching it periodically during reference
 	// interval computation.
-	TOUCH_WATCHDOG_VALUE_FREQUENCY	= 4096
+	TOUCH_WATCHDOG_VALUE_FREQUENCY	= 4096,
+
+	// Reference intervals are computed on worker threads in batches of this many values.
+	REFERENCE_BATCH_VALUE_COUNT		= 256
 };
 
 namespace deqp
@@ -1707,8 +1715,8 @@ protected:
 		Interval ret;
 
 		TCU_INTERVAL_APPLY_MONOTONE1(ret, arg0, iarg0, val,
-									 TCU_SET_INTERVAL(val, point,
-													  point = this->applyPoint(ctx, arg0)));
+									 TCU_SET_INTERVAL_OPS(val, point, this->getNumExactOps(),
+														  point = this->applyPoint(ctx, arg0)));
 
 		ret |= innerExtrema(ctx, iarg0);
 		ret &= (this->getCodomain() | TCU_NAN);
@@ -1736,6 +1744,12 @@ protected:
 		TCU_THROW(InternalError, "Cannot apply");
 	}
 
+	//! Number of rounded operations in applyExact(), see TCU_SET_INTERVAL_OPS.
+	virtual int			getNumExactOps	(void) const
+	{
+		return 1;
+	}
+
 	virtual Interval	getCodomain		(void) const
 	{
 		return Interval::unbounded(true);
@@ -2101,6 +2115,7 @@ public:
 
 protected:
 	double		applyExact	(double x) const						{ return 1.0 / deSqrt(x); }
+	int			getNumExactOps	(void) const						{ return 2; }
 
 	double		precision	(const EvalContext& ctx, double ret, double x) const
 	{
@@ -4560,6 +4575,382 @@ struct DefaultSamplings : Samplings<In>
 						instance<DefaultSampling<typename In::In3> >()) {}
 };
 
+/*--------------------------------------------------------------------*//*!
+ * \brief Persistent worker threads for reference interval evaluation
+ *
+ * Workers are started when reference intervals are first evaluated in
+ * parallel and shared by all cases for the lifetime of the process, so
+ * that cases don't pay for thread creation.
+ *//*--------------------------------------------------------------------*/
+class ReferenceJob
+{
+public:
+	virtual void				execute					(void) = 0;
+
+protected:
+								~ReferenceJob			(void) {}
+};
+
+class ReferenceWorkerPool
+{
+public:
+	static ReferenceWorkerPool&	getInstance				(void);
+
+	int							getNumWorkers			(void) const { return (int)m_workers.size(); }
+
+	//! Queue job for execution on a worker. Job must stay alive until it has been executed.
+	void						submit					(ReferenceJob* job);
+
+private:
+								ReferenceWorkerPool		(void);
+								~ReferenceWorkerPool	(void);
+								ReferenceWorkerPool		(const ReferenceWorkerPool&);
+	ReferenceWorkerPool&		operator=				(const ReferenceWorkerPool&);
+
+	class Worker : public de::Thread
+	{
+	public:
+									Worker				(ReferenceWorkerPool& pool) : m_pool(pool) {}
+		void						run					(void);
+
+	private:
+		ReferenceWorkerPool&		m_pool;
+	};
+
+	ReferenceJob*				dequeue					(void);
+
+	de::Mutex					m_lock;
+	de::Semaphore				m_numQueued;
+	std::deque<ReferenceJob*>	m_jobs;					//!< Null job stops a worker
+	std::vector<Worker*>		m_workers;
+};
+
+ReferenceWorkerPool& ReferenceWorkerPool::getInstance (void)
+{
+	static ReferenceWorkerPool pool;
+	return pool;
+}
+
+ReferenceWorkerPool::ReferenceWorkerPool (void)
+	: m_numQueued	(0)
+{
+	// Calling thread takes part in evaluation
+	const int numWorkers = (int)deGetNumAvailableLogicalCores() - 1;
+
+	for (int workerNdx = 0; workerNdx < numWorkers; ++workerNdx)
+	{
+		Worker* worker = DE_NULL;
+
+		try
+		{
+			worker = new Worker(*this);
+			worker->start();
+			m_workers.push_back(worker);
+		}
+		catch (const std::exception&)
+		{
+			// Continue with workers started so far.
+			delete worker;
+			break;
+		}
+	}
+}
+
+ReferenceWorkerPool::~ReferenceWorkerPool (void)
+{
+	for (size_t workerNdx = 0; workerNdx < m_workers.size(); ++workerNdx)
+		submit(DE_NULL);
+
+	for (size_t workerNdx = 0; workerNdx < m_workers.size(); ++workerNdx)
+	{
+		m_workers[workerNdx]->join();
+		delete m_workers[workerNdx];
+	}
+}
+
+void ReferenceWorkerPool::submit (ReferenceJob* job)
+{
+	{
+		const de::ScopedLock lock (m_lock);
+		m_jobs.push_back(job);
+	}
+
+	m_numQueued.increment();
+}
+
+ReferenceJob* ReferenceWorkerPool::dequeue (void)
+{
+	m_numQueued.decrement();
+
+	{
+		const de::ScopedLock	lock	(m_lock);
+		ReferenceJob* const		job		= m_jobs.front();
+
+		m_jobs.pop_front();
+		return job;
+	}
+}
+
+void ReferenceWorkerPool::Worker::run (void)
+{
+	while (ReferenceJob* const job = m_pool.dequeue())
+		job->execute();
+}
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Reference interval evaluation for all input values of a statement.
+ *
+ * Input values are split into batches of REFERENCE_BATCH_VALUE_COUNT values
+ * that are evaluated on the calling thread and ReferenceWorkerPool workers.
+ * Each batch executes the statement in its own Environment, and reference
+ * intervals are stored by value index so that comparison and logging can be
+ * done serially in value order.
+ *//*--------------------------------------------------------------------*/
+template <typename In, typename Out>
+class ReferenceEvaluator
+{
+public:
+	typedef typename Traits<typename Out::Out0>::IVal	IVal0;
+	typedef typename Traits<typename Out::Out1>::IVal	IVal1;
+
+							ReferenceEvaluator	(const Variables<In, Out>&	variables,
+												 const Inputs<In>&			inputs,
+												 const Statement&			stmt,
+												 const FloatFormat&			fmt,
+												 const FloatFormat&			highpFmt,
+												 Precision					precision,
+												 size_t						numValues);
+
+	//! Evaluate all values. Exceptions thrown by batches are re-thrown on the calling thread.
+	void					execute				(tcu::TestContext& testCtx);
+
+	//! Evaluate batches until none are left. Watchdog is touched only if testCtx is not null.
+	void					evaluateBatches		(tcu::TestContext* testCtx);
+
+	const IVal0&			getReference0		(size_t valueNdx) const	{ return m_reference0[valueNdx]; }
+	const IVal1&			getReference1		(size_t valueNdx) const	{ return m_reference1[valueNdx]; }
+
+private:
+							ReferenceEvaluator	(const ReferenceEvaluator&);	// disabled, non-copyable
+	ReferenceEvaluator&		operator=			(const ReferenceEvaluator&);	// disabled, non-copyable
+
+	void					evaluateBatch		(int batchNdx);
+	void					computeBatch		(int batchNdx, std::vector<IVal0>& reference0, std::vector<IVal1>& reference1, size_t dstOffset) const;
+	void					verifyBatch			(int batchNdx) const;
+
+	const Variables<In, Out>&	m_variables;
+	const Inputs<In>&			m_inputs;
+	const Statement&			m_stmt;
+	const FloatFormat			m_fmt;
+	const FloatFormat			m_highpFmt;
+	const Precision				m_precision;
+	const size_t				m_numValues;
+	const int					m_numBatches;
+	volatile deInt32			m_nextBatch;
+	std::vector<deUint8>		m_batchFailed;
+	std::vector<deUint8>		m_batchOnWorker;
+	std::vector<IVal0>			m_reference0;
+	std::vector<IVal1>			m_reference1;
+};
+
+template <typename In, typename Out>
+class ReferenceEvaluatorJob : public ReferenceJob
+{
+public:
+							ReferenceEvaluatorJob	(ReferenceEvaluator<In, Out>& evaluator, de::Semaphore& finished) : m_evaluator(evaluator), m_finished(finished) {}
+							~ReferenceEvaluatorJob	(void) {}
+
+	void					execute					(void)
+	{
+		m_evaluator.evaluateBatches(DE_NULL);
+		m_finished.increment();
+	}
+
+private:
+	ReferenceEvaluator<In, Out>&	m_evaluator;
+	de::Semaphore&					m_finished;
+};
+
+template <typename In, typename Out>
+ReferenceEvaluator<In, Out>::ReferenceEvaluator (const Variables<In, Out>&	variables,
+												 const Inputs<In>&			inputs,
+												 const Statement&			stmt,
+												 const FloatFormat&			fmt,
+												 const FloatFormat&			highpFmt,
+												 Precision					precision,
+												 size_t						numValues)
+	: m_variables		(variables)
+	, m_inputs			(inputs)
+	, m_stmt			(stmt)
+	, m_fmt				(fmt)
+	, m_highpFmt		(highpFmt)
+	, m_precision		(precision)
+	, m_numValues		(numValues)
+	, m_numBatches		((int)((numValues + REFERENCE_BATCH_VALUE_COUNT - 1) / REFERENCE_BATCH_VALUE_COUNT))
+	, m_nextBatch		(0)
+	, m_batchFailed		((size_t)m_numBatches, 0)
+	, m_batchOnWorker	((size_t)m_numBatches, 0)
+	, m_reference0		(numOutputs<Out>() > 0 ? numValues : 0)
+	, m_reference1		(numOutputs<Out>() > 1 ? numValues : 0)
+{
+}
+
+template <typename In, typename Out>
+void ReferenceEvaluator<In, Out>::evaluateBatch (int batchNdx)
+{
+	computeBatch(batchNdx, m_reference0, m_reference1, 0);
+}
+
+//! Evaluate batch and store value valueNdx reference intervals at valueNdx - dstOffset.
+template <typename In, typename Out>
+void ReferenceEvaluator<In, Out>::computeBatch (int batchNdx, std::vector<IVal0>& reference0, std::vector<IVal1>& reference1, size_t dstOffset) const
+{
+	typedef typename	In::In0		In0;
+	typedef typename	In::In1		In1;
+	typedef typename	In::In2		In2;
+	typedef typename	In::In3		In3;
+	typedef typename	Out::Out0	Out0;
+	typedef typename	Out::Out1	Out1;
+
+	const size_t		beginNdx	= (size_t)batchNdx * REFERENCE_BATCH_VALUE_COUNT;
+	const size_t		endNdx		= de::min(beginNdx + REFERENCE_BATCH_VALUE_COUNT, m_numValues);
+	const int			outCount	= numOutputs<Out>();
+	Environment			env;
+
+	// Initialize environment with dummy values so we don't need to bind in inner loop.
+	{
+		const typename Traits<In0>::IVal		in0;
+		const typename Traits<In1>::IVal		in1;
+		const typename Traits<In2>::IVal		in2;
+		const typename Traits<In3>::IVal		in3;
+		const IVal0								reference0Init;
+		const IVal1								reference1Init;
+
+		env.bind(*m_variables.in0, in0);
+		env.bind(*m_variables.in1, in1);
+		env.bind(*m_variables.in2, in2);
+		env.bind(*m_variables.in3, in3);
+		env.bind(*m_variables.out0, reference0Init);
+		env.bind(*m_variables.out1, reference1Init);
+	}
+
+	for (size_t valueNdx = beginNdx; valueNdx < endNdx; valueNdx++)
+	{
+		env.lookup(*m_variables.in0) = convert<In0>(m_fmt, round(m_fmt, m_inputs.in0[valueNdx]));
+		env.lookup(*m_variables.in1) = convert<In1>(m_fmt, round(m_fmt, m_inputs.in1[valueNdx]));
+		env.lookup(*m_variables.in2) = convert<In2>(m_fmt, round(m_fmt, m_inputs.in2[valueNdx]));
+		env.lookup(*m_variables.in3) = convert<In3>(m_fmt, round(m_fmt, m_inputs.in3[valueNdx]));
+
+		{
+			EvalContext	ctx (m_fmt, m_precision, env);
+			m_stmt.execute(ctx);
+		}
+
+		if (outCount > 1)
+			reference1[valueNdx - dstOffset] = convert<Out1>(m_highpFmt, env.lookup(*m_variables.out1));
+		if (outCount > 0)
+			reference0[valueNdx - dstOffset] = convert<Out0>(m_highpFmt, env.lookup(*m_variables.out0));
+	}
+}
+
+//! Re-evaluate batch on calling thread and check that results are identical to the stored ones.
+template <typename In, typename Out>
+void ReferenceEvaluator<In, Out>::verifyBatch (int batchNdx) const
+{
+	const size_t		beginNdx	= (size_t)batchNdx * REFERENCE_BATCH_VALUE_COUNT;
+	const size_t		endNdx		= de::min(beginNdx + REFERENCE_BATCH_VALUE_COUNT, m_numValues);
+	const int			outCount	= numOutputs<Out>();
+	std::vector<IVal0>	reference0	(outCount > 0 ? endNdx - beginNdx : 0);
+	std::vector<IVal1>	reference1	(outCount > 1 ? endNdx - beginNdx : 0);
+
+	computeBatch(batchNdx, reference0, reference1, beginNdx);
+
+	for (size_t valueNdx = beginNdx; valueNdx < endNdx; valueNdx++)
+	{
+		// \note Void outputs are never compared, they are not equal to anything.
+		if ((outCount > 0 && !(reference0[valueNdx - beginNdx] == m_reference0[valueNdx])) ||
+			(outCount > 1 && !(reference1[valueNdx - beginNdx] == m_reference1[valueNdx])))
+			TCU_THROW(InternalError, "Reference intervals computed on worker thread differ from serial evaluation");
+	}
+}
+
+template <typename In, typename Out>
+void ReferenceEvaluator<In, Out>::evaluateBatches (tcu::TestContext* testCtx)
+{
+	for (;;)
+	{
+		const int batchNdx = deAtomicIncrementInt32(&m_nextBatch) - 1;
+
+		if (batchNdx >= m_numBatches)
+			break;
+
+		try
+		{
+			evaluateBatch(batchNdx);
+		}
+		catch (...)
+		{
+			m_batchFailed[batchNdx] = 1;
+		}
+
+		if (testCtx)
+			testCtx->touchWatchdog();
+		else
+			m_batchOnWorker[batchNdx] = 1;
+	}
+}
+
+template <typename In, typename Out>
+void ReferenceEvaluator<In, Out>::execute (tcu::TestContext& testCtx)
+{
+	if (m_numBatches == 0)
+		return;
+
+	// Functions initialize their expanded bodies lazily when first evaluated, so the
+	// first batch is evaluated on this thread before any workers take part.
+	evaluateBatch(0);
+	testCtx.touchWatchdog();
+	m_nextBatch = 1;
+
+	if (m_numBatches == 1)
+		return;
+
+	{
+		ReferenceWorkerPool&				pool		= ReferenceWorkerPool::getInstance();
+		const int							numJobs		= de::min(pool.getNumWorkers(), m_numBatches - 1);
+		de::Semaphore						finished	(0);
+		ReferenceEvaluatorJob<In, Out>		job			(*this, finished);
+
+		// All workers run the same job; batches are distributed through m_nextBatch.
+		for (int jobNdx = 0; jobNdx < numJobs; jobNdx++)
+			pool.submit(&job);
+
+		evaluateBatches(&testCtx);
+
+		// Job references this evaluator, so it must finish on all workers before returning.
+		for (int jobNdx = 0; jobNdx < numJobs; jobNdx++)
+			finished.decrement();
+	}
+
+	// Batches are independent, so re-running a failed batch reproduces the original exception on this thread.
+	for (int batchNdx = 0; batchNdx < m_numBatches; batchNdx++)
+	{
+		if (m_batchFailed[batchNdx])
+			evaluateBatch(batchNdx);
+	}
+
+	// Parallel evaluation must give exactly the same intervals as serial evaluation. Check one batch
+	// evaluated on a worker, since rounding mode and other floating-point state are per thread.
+	for (int batchNdx = 0; batchNdx < m_numBatches; batchNdx++)
+	{
+		if (m_batchOnWorker[batchNdx])
+		{
+			verifyBatch(batchNdx);
+			break;
+		}
+	}
+}
+
 class PrecisionCase : public TestCase
 {
 public:
@@ -4619,10 +5010,6 @@ void PrecisionCase::testStatement (const Variables<In, Out>&	variables,
 {
 	using namespace ShaderExecUtil;
 
-	typedef typename	In::In0		In0;
-	typedef typename	In::In1		In1;
-	typedef typename	In::In2		In2;
-	typedef typename	In::In3		In3;
 	typedef typename	Out::Out0	Out0;
 	typedef typename	Out::Out1	Out1;
 
@@ -4635,7 +5022,6 @@ void PrecisionCase::testStatement (const Variables<In, Out>&	variables,
 	const FloatFormat	highpFmt	= m_ctx.highpFormat;
 	const int			maxMsgs		= 100;
 	int					numErrors	= 0;
-	Environment			env;		// Hoisted out of the inner loop for optimization.
 
 	switch (inCount)
 	{
@@ -4736,25 +5122,12 @@ void PrecisionCase::testStatement (const Variables<In, Out>&	variables,
 		executor->execute(int(numValues), inputArr, outputArr);
 	}
 
-	// Initialize environment with dummy values so we don't need to bind in inner loop.
-	{
-		const typename Traits<In0>::IVal		in0;
-		const typename Traits<In1>::IVal		in1;
-		const typename Traits<In2>::IVal		in2;
-		const typename Traits<In3>::IVal		in3;
-		const typename Traits<Out0>::IVal		reference0;
-		const typename Traits<Out1>::IVal		reference1;
+	// Compute reference intervals for all input tuples.
+	ReferenceEvaluator<In, Out>	evaluator	(variables, inputs, stmt, fmt, highpFmt, m_ctx.precision, numValues);
 
-		env.bind(*variables.in0, in0);
-		env.bind(*variables.in1, in1);
-		env.bind(*variables.in2, in2);
-		env.bind(*variables.in3, in3);
-		env.bind(*variables.out0, reference0);
-		env.bind(*variables.out1, reference1);
-	}
+	evaluator.execute(m_testCtx);
 
-	// For each input tuple, compute output reference interval and compare
-	// shader output to the reference.
+	// For each input tuple, compare shader output to the reference.
 	for (size_t valueNdx = 0; valueNdx < numValues; valueNdx++)
 	{
 		bool						result = true;
@@ -4767,20 +5140,10 @@ void PrecisionCase::testStatement (const Variables<In, Out>&	variables,
 		if (valueNdx % (size_t)TOUCH_WATCHDOG_VALUE_FREQUENCY == 0)
 			m_testCtx.touchWatchdog();
 
-		env.lookup(*variables.in0) = convert<In0>(fmt, round(fmt, inputs.in0[valueNdx]));
-		env.lookup(*variables.in1) = convert<In1>(fmt, round(fmt, inputs.in1[valueNdx]));
-		env.lookup(*variables.in2) = convert<In2>(fmt, round(fmt, inputs.in2[valueNdx]));
-		env.lookup(*variables.in3) = convert<In3>(fmt, round(fmt, inputs.in3[valueNdx]));
-
-		{
-			EvalContext	ctx (fmt, m_ctx.precision, env);
-			stmt.execute(ctx);
-		}
-
 		switch (outCount)
 		{
 			case 2:
-				reference1      = convert<Out1>(highpFmt, env.lookup(*variables.out1));
+				reference1      = evaluator.getReference1(valueNdx);
 				inExpectedRange = contains(reference1, outputs.out1[valueNdx]);
 				inWarningRange  = containsWarning(reference1, outputs.out1[valueNdx]);
 				if (!inExpectedRange && inWarningRange)
@@ -4798,7 +5161,7 @@ void PrecisionCase::testStatement (const Variables<In, Out>&	variables,
 			// Fallthrough
 
 			case 1:
-				reference0      = convert<Out0>(highpFmt, env.lookup(*variables.out0));
+				reference0      = evaluator.getReference0(valueNdx);
 				inExpectedRange = contains(reference0, outputs.out0[valueNdx]);
 				inWarningRange  = containsWarning(reference0, outputs.out0[valueNdx]);
 				if (!inExpectedRange && inWarningRange)
@@ -22,12 +22,15 @@
  *//*--------------------------------------------------------------------*/
 
 #include "ditAstcTests.hpp"
+#include "ditTestCase.hpp"
 
 #include "tcuCompressedTexture.hpp"
 #include "tcuAstcUtil.hpp"
+#include "tcuTextureUtil.hpp"
 
 #include "deUniquePtr.hpp"
 #include "deStringUtil.hpp"
+#include "deMemory.h"
 
 namespace dit
 {
@@ -65,14 +68,45 @@ AstcCase::AstcCase (tcu::TestContext& testCtx, CompressedTexFormat format)
 {
 }
 
+bool isBitExactMatch (const ConstPixelBufferAccess& a, const ConstPixelBufferAccess& b)
+{
+	DE_ASSERT(a.getFormat() == b.getFormat() && a.getWidth() == b.getWidth() && a.getHeight() == b.getHeight() && a.getDepth() == b.getDepth());
+	DE_ASSERT(a.getPixelPitch() == a.getFormat().getPixelSize() && b.getPixelPitch() == b.getFormat().getPixelSize());
+
+	const size_t rowSize = (size_t)(a.getWidth()*a.getFormat().getPixelSize());
+
+	for (int z = 0; z < a.getDepth(); z++)
+	for (int y = 0; y < a.getHeight(); y++)
+	{
+		if (deMemCmp(a.getPixelPtr(0, y, z), b.getPixelPtr(0, y, z), rowSize) != 0)
+			return false;
+	}
+
+	return true;
+}
+
 void testDecompress (CompressedTexFormat format, TexDecompressionParams::AstcMode mode, size_t numBlocks, const deUint8* data)
 {
+	// Lay blocks out in multiple rows when possible so that parallel decompression splits the texture
+	const int						numBlocksX				= (numBlocks % 16 == 0) ? 16 : (int)numBlocks;
+	const int						numBlocksY				= (int)numBlocks / numBlocksX;
 	const IVec3						blockPixelSize			= getBlockPixelSize(format);
-	const TexDecompressionParams	decompressionParams		(mode);
 	const TextureFormat				uncompressedFormat		= getUncompressedFormat(format);
-	TextureLevel					texture					(uncompressedFormat, blockPixelSize.x()*(int)numBlocks, blockPixelSize.y());
+	const int						width					= blockPixelSize.x()*numBlocksX;
+	const int						height					= blockPixelSize.y()*numBlocksY;
+	TextureLevel					serialTexture			(uncompressedFormat, width, height);
+	TextureLevel					parallelTexture			(uncompressedFormat, width, height);
+	TextureLevel					croppedTexture			(uncompressedFormat, width-1, height-1);
+
+	decompress(serialTexture.getAccess(), format, data, TexDecompressionParams(mode, TexDecompressionParams::EXECMODE_SERIAL));
+	decompress(parallelTexture.getAccess(), format, data, TexDecompressionParams(mode, TexDecompressionParams::EXECMODE_PARALLEL));
+	decompress(croppedTexture.getAccess(), format, data, TexDecompressionParams(mode, TexDecompressionParams::EXECMODE_PARALLEL));
 
-	decompress(texture.getAccess(), format, data, decompressionParams);
+	if (!isBitExactMatch(serialTexture.getAccess(), parallelTexture.getAccess()))
+		TCU_FAIL("Parallel decompression result differs from serial decompression result");
+
+	if (!isBitExactMatch(croppedTexture.getAccess(), getSubregion(serialTexture.getAccess(), 0, 0, width-1, height-1)))
+		TCU_FAIL("Decompression result of partial blocks differs from decompression result of full blocks");
 }
 
 void testDecompress (CompressedTexFormat format, size_t numBlocks, const deUint8* data)
@@ -194,6 +228,9 @@ tcu::TestCaseGroup* createAstcTests (tcu::TestContext& testCtx)
 			astcTests->addChild(new AstcCase(testCtx, format));
 	}
 
+	astcTests->addChild(new SelfCheckCase(testCtx, "ldr_interpolation", "tcu::astc::ldrInterpolation_selfTest()",
+										  tcu::astc::ldrInterpolation_selfTest));
+
 	return astcTests.release();
 }
 
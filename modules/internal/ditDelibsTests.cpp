@@ -40,6 +40,7 @@
 // deutil
 #include "deTimerTest.h"
 #include "deCommandLine.h"
+#include "deClock.h"
 
 // debase
 #include "deInt32.h"
@@ -51,6 +52,7 @@
 // decpp
 #include "deBlockBuffer.hpp"
 #include "deFilePath.hpp"
+#include "deLockFreeQueue.hpp"
 #include "dePoolArray.hpp"
 #include "deRingBuffer.hpp"
 #include "deSharedPtr.hpp"
@@ -63,6 +65,9 @@
 #include "deSpinBarrier.hpp"
 #include "deSTLUtil.hpp"
 #include "deAppendList.hpp"
+#include "deThread.hpp"
+
+#include <vector>
 
 namespace dit
 {
@@ -168,6 +173,161 @@ public:
 	}
 };
 
+class QueueThroughputCase : public tcu::TestCase
+{
+public:
+	QueueThroughputCase (tcu::TestContext& testCtx)
+		: tcu::TestCase(testCtx, "lock_free_queue_perf", "Compare de::BlockingLockFreeQueue and de::ThreadSafeRingBuffer throughput")
+	{
+	}
+
+	IterateResult iterate (void)
+	{
+		const int		numThreads		= de::max(1, de::min((int)deGetNumAvailableLogicalCores()/2, 32));
+		const int		numItems		= 1<<19;
+		const int		queueSize		= 1024;
+		deUint64		ringBufferSum	= 0;
+		deUint64		lockFreeSum		= 0;
+		deUint64		ringBufferTime	= 0;
+		deUint64		lockFreeTime	= 0;
+
+		{
+			de::ThreadSafeRingBuffer<deUint32> queue (queueSize);
+			ringBufferTime = measure(queue, numThreads, numItems, ringBufferSum);
+		}
+
+		{
+			de::BlockingLockFreeQueue<deUint32> queue (queueSize);
+			lockFreeTime = measure(queue, numThreads, numItems, lockFreeSum);
+		}
+
+		m_testCtx.getLog() << TestLog::Integer("NumProducers",				"Number of producer threads",					"",			QP_KEY_TAG_NONE,		numThreads)
+						   << TestLog::Integer("NumConsumers",				"Number of consumer threads",					"",			QP_KEY_TAG_NONE,		numThreads)
+						   << TestLog::Integer("NumItems",					"Number of items",								"",			QP_KEY_TAG_NONE,		numItems)
+						   << TestLog::Integer("RingBufferTime",			"de::ThreadSafeRingBuffer time",				"us",		QP_KEY_TAG_TIME,		(deInt64)ringBufferTime)
+						   << TestLog::Integer("LockFreeQueueTime",			"de::BlockingLockFreeQueue time",				"us",		QP_KEY_TAG_TIME,		(deInt64)lockFreeTime)
+						   << TestLog::Float("RingBufferThroughput",		"de::ThreadSafeRingBuffer throughput",			"ops/s",	QP_KEY_TAG_PERFORMANCE,	(float)((double)numItems / ((double)de::max<deUint64>(ringBufferTime, 1) / 1e6)))
+						   << TestLog::Float("LockFreeQueueThroughput",		"de::BlockingLockFreeQueue throughput",			"ops/s",	QP_KEY_TAG_PERFORMANCE,	(float)((double)numItems / ((double)de::max<deUint64>(lockFreeTime, 1) / 1e6)));
+
+		if (ringBufferSum == lockFreeSum)
+			m_testCtx.setTestResult(QP_TEST_RESULT_PASS, "Pass");
+		else
+			m_testCtx.setTestResult(QP_TEST_RESULT_FAIL, "Queues passed different items");
+
+		return STOP;
+	}
+
+private:
+	static void		push	(de::ThreadSafeRingBuffer<deUint32>& queue, deUint32 value)		{ queue.pushFront(value);	}
+	static deUint32	pop		(de::ThreadSafeRingBuffer<deUint32>& queue)						{ return queue.popBack();	}
+	static void		push	(de::BlockingLockFreeQueue<deUint32>& queue, deUint32 value)	{ queue.push(value);		}
+	static deUint32	pop		(de::BlockingLockFreeQueue<deUint32>& queue)					{ return queue.pop();		}
+
+	template<typename Queue>
+	class Producer : public de::Thread
+	{
+	public:
+		Producer (Queue& queue, int first, int count)
+			: m_queue	(queue)
+			, m_first	(first)
+			, m_count	(count)
+		{
+		}
+
+		void run (void)
+		{
+			// \note Values start from 1, 0 is used to stop consumers.
+			for (int ndx = 0; ndx < m_count; ndx++)
+				push(m_queue, (deUint32)(m_first + ndx + 1));
+		}
+
+	private:
+		Queue&		m_queue;
+		const int	m_first;
+		const int	m_count;
+	};
+
+	template<typename Queue>
+	class Consumer : public de::Thread
+	{
+	public:
+		Consumer (Queue& queue)
+			: m_queue	(queue)
+			, m_sum		(0)
+		{
+		}
+
+		void run (void)
+		{
+			for (;;)
+			{
+				const deUint32 value = pop(m_queue);
+
+				if (value == 0)
+					break;
+
+				m_sum += value;
+			}
+		}
+
+		deUint64 getSum (void) const { return m_sum; }
+
+	private:
+		Queue&		m_queue;
+		deUint64	m_sum;
+	};
+
+	//! Pass numItems items from numThreads producers to numThreads consumers, return time in microseconds.
+	template<typename Queue>
+	static deUint64 measure (Queue& queue, int numThreads, int numItems, deUint64& sum)
+	{
+		std::vector<Producer<Queue>*>	producers;
+		std::vector<Consumer<Queue>*>	consumers;
+		deUint64						time;
+
+		for (int threadNdx = 0; threadNdx < numThreads; threadNdx++)
+		{
+			const int first	= (int)((deInt64)numItems * threadNdx / numThreads);
+			const int last	= (int)((deInt64)numItems * (threadNdx+1) / numThreads);
+
+			producers.push_back(new Producer<Queue>(queue, first, last - first));
+			consumers.push_back(new Consumer<Queue>(queue));
+		}
+
+		{
+			const deUint64 startTime = deGetMicroseconds();
+
+			for (int threadNdx = 0; threadNdx < numThreads; threadNdx++)
+			{
+				consumers[threadNdx]->start();
+				producers[threadNdx]->start();
+			}
+
+			for (int threadNdx = 0; threadNdx < numThreads; threadNdx++)
+				producers[threadNdx]->join();
+
+			for (int threadNdx = 0; threadNdx < numThreads; threadNdx++)
+				push(queue, 0u);
+
+			for (int threadNdx = 0; threadNdx < numThreads; threadNdx++)
+				consumers[threadNdx]->join();
+
+			time = deGetMicroseconds() - startTime;
+		}
+
+		sum = 0;
+
+		for (int threadNdx = 0; threadNdx < numThreads; threadNdx++)
+		{
+			sum += consumers[threadNdx]->getSum();
+			delete producers[threadNdx];
+			delete consumers[threadNdx];
+		}
+
+		return time;
+	}
+};
+
 class DecppTests : public tcu::TestCaseGroup
 {
 public:
@@ -180,6 +340,7 @@ public:
 	{
 		addChild(new SelfCheckCase(m_testCtx, "block_buffer",				"de::BlockBuffer_selfTest()",			de::BlockBuffer_selfTest));
 		addChild(new SelfCheckCase(m_testCtx, "file_path",					"de::FilePath_selfTest()",				de::FilePath_selfTest));
+		addChild(new SelfCheckCase(m_testCtx, "lock_free_queue",			"de::LockFreeQueue_selfTest()",			de::LockFreeQueue_selfTest));
 		addChild(new SelfCheckCase(m_testCtx, "pool_array",					"de::PoolArray_selfTest()",				de::PoolArray_selfTest));
 		addChild(new SelfCheckCase(m_testCtx, "ring_buffer",				"de::RingBuffer_selfTest()",			de::RingBuffer_selfTest));
 		addChild(new SelfCheckCase(m_testCtx, "shared_ptr",					"de::SharedPtr_selfTest()",				de::SharedPtr_selfTest));
@@ -192,6 +353,7 @@ public:
 		addChild(new SelfCheckCase(m_testCtx, "spin_barrier",				"de::SpinBarrier_selfTest()",			de::SpinBarrier_selfTest));
 		addChild(new SelfCheckCase(m_testCtx, "stl_util",					"de::STLUtil_selfTest()",				de::STLUtil_selfTest));
 		addChild(new SelfCheckCase(m_testCtx, "append_list",				"de::AppendList_selfTest()",			de::AppendList_selfTest));
+		addChild(new QueueThroughputCase(m_testCtx));
 	}
 };
 
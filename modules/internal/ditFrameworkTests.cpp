@@ -27,19 +27,35 @@
 #include "ditVulkanTests.hpp"
 
 #include "tcuFloatFormat.hpp"
+#include "tcuInterval.hpp"
 #include "tcuEither.hpp"
 #include "tcuTestLog.hpp"
 #include "tcuCommandLine.hpp"
+#include "tcuCompressedTexture.hpp"
+#include "tcuDecompressedTextureCache.hpp"
+#include "tcuAstcUtil.hpp"
 
 #include "rrRenderer.hpp"
+#include "rrRasterizer.hpp"
 #include "tcuTextureUtil.hpp"
 #include "tcuVectorUtil.hpp"
 #include "tcuFloat.hpp"
+#include "tcuFormatUtil.hpp"
 
 #include "deRandom.hpp"
 #include "deArrayUtil.hpp"
+#include "deStringUtil.hpp"
+#include "deSharedPtr.hpp"
+#include "deThread.hpp"
+#include "deClock.h"
+#include "deMemory.h"
+#include "deString.h"
+#include "deThread.h"
 
 #include <stdexcept>
+#include <algorithm>
+#include <limits>
+#include <set>
 
 namespace dit
 {
@@ -556,6 +572,103 @@ public:
 	}
 };
 
+class LargeCaseListCase : public tcu::TestCase
+{
+public:
+	LargeCaseListCase (tcu::TestContext& testCtx, const char* name, int numGroups, int numSubGroups, int numCases)
+		: tcu::TestCase		(testCtx, name, "Parse and filter large case list")
+		, m_numGroups		(numGroups)
+		, m_numSubGroups	(numSubGroups)
+		, m_numCases		(numCases)
+	{
+	}
+
+	IterateResult iterate (void)
+	{
+		TestLog&							log				= m_testCtx.getLog();
+		tcu::CommandLine					cmdLine;
+		de::MovePtr<tcu::CaseListFilter>	caseListFilter;
+		vector<string>						groupPaths;
+		vector<string>						casePaths;
+		string								caseList;
+		deUint64							parseTime		= 0;
+		deUint64							filterTime		= 0;
+		int									numMismatches	= 0;
+
+		// Mimic the shape of the full Vulkan mustpass: few groups, each with very many cases
+		for (int groupNdx = 0; groupNdx < m_numGroups; groupNdx++)
+		{
+			for (int subGroupNdx = 0; subGroupNdx < m_numSubGroups; subGroupNdx++)
+			{
+				const string groupPath = "dEQP-VK.group_" + de::toString(groupNdx) + ".subgroup_" + de::toString(subGroupNdx);
+
+				groupPaths.push_back(groupPath);
+
+				for (int caseNdx = 0; caseNdx < m_numCases; caseNdx++)
+				{
+					casePaths.push_back(groupPath + ".case_" + de::toString(caseNdx));
+					caseList += casePaths.back();
+					caseList += '\n';
+				}
+			}
+		}
+
+		log << TestLog::Message << "Case list contains " << casePaths.size() << " cases in " << groupPaths.size() << " groups" << TestLog::EndMessage;
+
+		{
+			const char* argv[] =
+			{
+				"deqp",
+				"--deqp-caselist",
+				caseList.c_str()
+			};
+
+			if (!cmdLine.parse(DE_LENGTH_OF_ARRAY(argv), argv))
+				TCU_FAIL("Failed to parse command line");
+		}
+
+		{
+			const deUint64 startTime = deGetMicroseconds();
+			caseListFilter = cmdLine.createCaseListFilter(m_testCtx.getArchive());
+			parseTime = deGetMicroseconds()-startTime;
+		}
+
+		{
+			const deUint64 startTime = deGetMicroseconds();
+
+			for (size_t groupNdx = 0; groupNdx < groupPaths.size(); groupNdx++)
+			{
+				if (!caseListFilter->checkTestGroupName(groupPaths[groupNdx].c_str()) ||
+					caseListFilter->checkTestCaseName(groupPaths[groupNdx].c_str()))
+					numMismatches++;
+			}
+
+			for (size_t caseNdx = 0; caseNdx < casePaths.size(); caseNdx++)
+			{
+				// Test both present case and missing case with same prefix
+				if (!caseListFilter->checkTestCaseName(casePaths[caseNdx].c_str()) ||
+					caseListFilter->checkTestCaseName((casePaths[caseNdx] + "_x").c_str()))
+					numMismatches++;
+			}
+
+			filterTime = deGetMicroseconds()-startTime;
+		}
+
+		log << TestLog::Integer("ParseTime", "Case list parse time", "us", QP_KEY_TAG_TIME, parseTime)
+			<< TestLog::Integer("FilterTime", "Case list filter time", "us", QP_KEY_TAG_TIME, filterTime);
+
+		m_testCtx.setTestResult(numMismatches == 0 ? QP_TEST_RESULT_PASS	: QP_TEST_RESULT_FAIL,
+								numMismatches == 0 ? "Pass"					: "Unexpected match result");
+
+		return STOP;
+	}
+
+private:
+	const int	m_numGroups;
+	const int	m_numSubGroups;
+	const int	m_numCases;
+};
+
 class CaseListParserTests : public tcu::TestCaseGroup
 {
 public:
@@ -568,6 +681,7 @@ public:
 	{
 		addChild(new TrieParserTests(m_testCtx));
 		addChild(new ListParserTests(m_testCtx));
+		addChild(new LargeCaseListCase(m_testCtx, "large_list", 10, 10, 10000));
 	}
 };
 
@@ -880,34 +994,1519 @@ protected:
 	vector<SubCase>::const_iterator	m_caseIter;
 };
 
-class CommonFrameworkTests : public tcu::TestCaseGroup
+class ColorVertexShader : public rr::VertexShader
 {
 public:
-	CommonFrameworkTests (tcu::TestContext& testCtx)
-		: tcu::TestCaseGroup(testCtx, "common", "Tests for the common utility framework")
+	ColorVertexShader (void)
+		: rr::VertexShader(2, 1)
 	{
+		m_inputs[0].type	= rr::GENERICVECTYPE_FLOAT;
+		m_inputs[1].type	= rr::GENERICVECTYPE_FLOAT;
+		m_outputs[0].type	= rr::GENERICVECTYPE_FLOAT;
 	}
 
-	void init (void)
+	void shadeVertices (const rr::VertexAttrib* inputs, rr::VertexPacket* const* packets, const int numPackets) const
 	{
-		addChild(new SelfCheckCase(m_testCtx, "float_format","tcu::FloatFormat_selfTest()",
-								   tcu::FloatFormat_selfTest));
-		addChild(new SelfCheckCase(m_testCtx, "either","tcu::Either_selfTest()",
-								   tcu::Either_selfTest));
+		for (int packetNdx = 0; packetNdx < numPackets; packetNdx++)
+		{
+			rr::readVertexAttrib(packets[packetNdx]->position, inputs[0], packets[packetNdx]->instanceNdx, packets[packetNdx]->vertexNdx);
+			packets[packetNdx]->outputs[0] = rr::readVertexAttribFloat(inputs[1], packets[packetNdx]->instanceNdx, packets[packetNdx]->vertexNdx);
+		}
 	}
 };
 
-class ReferenceRendererTests : public tcu::TestCaseGroup
+//! Outputs interpolated color with derivatives added to make result depend on fragment packet placement.
+class ColorDerivateFragmentShader : public rr::FragmentShader
 {
 public:
-	ReferenceRendererTests (tcu::TestContext& testCtx)
-		: tcu::TestCaseGroup(testCtx, "reference_renderer", "Reference renderer tests")
+	ColorDerivateFragmentShader (void)
+		: rr::FragmentShader(1, 1)
 	{
+		m_inputs[0].type	= rr::GENERICVECTYPE_FLOAT;
+		m_outputs[0].type	= rr::GENERICVECTYPE_FLOAT;
 	}
 
-	void init (void)
+	void shadeFragments (rr::FragmentPacket* packets, const int numPackets, const rr::FragmentShadingContext& context) const
 	{
-		addChild(new ConstantInterpolationTest(m_testCtx));
+		for (int packetNdx = 0; packetNdx < numPackets; packetNdx++)
+		{
+			tcu::Vec4 dFdx[4];
+			tcu::Vec4 dFdy[4];
+
+			rr::dFdxVarying(dFdx, packets[packetNdx], context, 0);
+			rr::dFdyVarying(dFdy, packets[packetNdx], context, 0);
+
+			for (int fragNdx = 0; fragNdx < rr::NUM_FRAGMENTS_PER_PACKET; fragNdx++)
+			{
+				const tcu::Vec4 color = rr::readVarying<float>(packets[packetNdx], context, 0, fragNdx);
+				rr::writeFragmentOutput(context, packetNdx, fragNdx, 0, color + 8.0f*(dFdx[fragNdx] + dFdy[fragNdx]));
+			}
+		}
+	}
+
+	bool isThreadSafe (void) const
+	{
+		return true;
+	}
+};
+
+class ParallelRasterizationCase : public tcu::TestCase
+{
+public:
+	ParallelRasterizationCase (tcu::TestContext& testCtx, const char* name, rr::PrimitiveType primitiveType, int numSamples)
+		: tcu::TestCase		(testCtx, name, "Compare parallel rasterization to serial rasterization")
+		, m_primitiveType	(primitiveType)
+		, m_numSamples		(numSamples)
+	{
+	}
+
+	IterateResult iterate (void)
+	{
+		using namespace tcu;
+
+		const TextureFormat		colorFormat		(TextureFormat::RGBA, TextureFormat::UNORM_INT8);
+		const TextureFormat		dsFormat		(TextureFormat::DS, TextureFormat::FLOAT_UNSIGNED_INT_24_8_REV);
+		const int				width			= 203;
+		const int				height			= 157;
+		TextureLevel			serialColor		(colorFormat, m_numSamples, width, height);
+		TextureLevel			serialDS		(dsFormat, m_numSamples, width, height);
+		TextureLevel			parallelColor	(colorFormat, m_numSamples, width, height);
+		TextureLevel			parallelDS		(dsFormat, m_numSamples, width, height);
+
+		m_testCtx.getLog() << TestLog::Message << "Rendering with " << deGetNumAvailableLogicalCores() << " available cores" << TestLog::EndMessage;
+
+		render(rr::RENDEREXECMODE_SERIAL,	serialColor.getAccess(),	serialDS.getAccess());
+		render(rr::RENDEREXECMODE_PARALLEL,	parallelColor.getAccess(),	parallelDS.getAccess());
+
+		{
+			const size_t	colorSize	= (size_t)(colorFormat.getPixelSize()*m_numSamples*width*height);
+			const bool		colorOk		= deMemCmp(serialColor.getAccess().getDataPtr(), parallelColor.getAccess().getDataPtr(), colorSize) == 0;
+			const bool		dsOk		= compareDepthStencil(serialDS.getAccess(), parallelDS.getAccess());
+
+			if (colorOk && dsOk)
+				m_testCtx.setTestResult(QP_TEST_RESULT_PASS, "Pass");
+			else
+			{
+				TextureLevel	resolvedSerial		(colorFormat, width, height);
+				TextureLevel	resolvedParallel	(colorFormat, width, height);
+
+				rr::resolveMultisampleBuffer(resolvedSerial.getAccess(), rr::MultisampleConstPixelBufferAccess::fromMultisampleAccess(serialColor.getAccess()));
+				rr::resolveMultisampleBuffer(resolvedParallel.getAccess(), rr::MultisampleConstPixelBufferAccess::fromMultisampleAccess(parallelColor.getAccess()));
+
+				m_testCtx.getLog() << TestLog::Image("SerialResult", "Serial rasterization result", resolvedSerial)
+								   << TestLog::Image("ParallelResult", "Parallel rasterization result", resolvedParallel);
+
+				if (!colorOk)
+					m_testCtx.getLog() << TestLog::Message << "FAIL: Color buffers differ" << TestLog::EndMessage;
+
+				if (!dsOk)
+					m_testCtx.getLog() << TestLog::Message << "FAIL: Depth-stencil buffers differ" << TestLog::EndMessage;
+
+				m_testCtx.setTestResult(QP_TEST_RESULT_FAIL, "Parallel result differs from serial result");
+			}
+		}
+
+		return STOP;
+	}
+
+private:
+	// \note Depth-stencil storage has unused padding bits so it cannot be compared with deMemCmp
+	static bool compareDepthStencil (const tcu::ConstPixelBufferAccess& a, const tcu::ConstPixelBufferAccess& b)
+	{
+		for (int y = 0; y < a.getDepth(); y++)
+		for (int x = 0; x < a.getHeight(); x++)
+		for (int s = 0; s < a.getWidth(); s++)
+		{
+			if (a.getPixDepth(s, x, y) != b.getPixDepth(s, x, y) || a.getPixStencil(s, x, y) != b.getPixStencil(s, x, y))
+				return false;
+		}
+
+		return true;
+	}
+
+	void render (rr::RenderExecMode execMode, const tcu::PixelBufferAccess& color, const tcu::PixelBufferAccess& depthStencil) const
+	{
+		const int								numVertices		= 600;
+		de::Random								rnd				(deStringHash(getName()));
+		vector<tcu::Vec4>						positions		(numVertices);
+		vector<tcu::Vec4>						colors			(numVertices);
+
+		for (int vtxNdx = 0; vtxNdx < numVertices; vtxNdx++)
+		{
+			positions[vtxNdx]	= tcu::Vec4(rnd.getFloat(-1.2f, 1.2f), rnd.getFloat(-1.2f, 1.2f), rnd.getFloat(-1.0f, 1.0f), 1.0f);
+			colors[vtxNdx]		= tcu::Vec4(rnd.getFloat(), rnd.getFloat(), rnd.getFloat(), rnd.getFloat(0.2f, 0.8f));
+		}
+
+		tcu::clear			(color, tcu::Vec4(0.0f, 0.0f, 0.0f, 1.0f));
+		tcu::clearDepth		(depthStencil, 1.0f);
+		tcu::clearStencil	(depthStencil, 0);
+
+		{
+			const ColorVertexShader					vtxShader;
+			const ColorDerivateFragmentShader		fragShader;
+			const rr::Program						program			(&vtxShader, &fragShader);
+			const rr::MultisamplePixelBufferAccess	colorAccess		= rr::MultisamplePixelBufferAccess::fromMultisampleAccess(color);
+			const rr::MultisamplePixelBufferAccess	dsAccess		= rr::MultisamplePixelBufferAccess::fromMultisampleAccess(depthStencil);
+			const rr::RenderTarget					renderTarget	(colorAccess, dsAccess, dsAccess);
+			const rr::VertexAttrib					vertexAttribs[]	=
+			{
+				rr::VertexAttrib(rr::VERTEXATTRIBTYPE_FLOAT, 4, 0, 0, &positions[0]),
+				rr::VertexAttrib(rr::VERTEXATTRIBTYPE_FLOAT, 4, 0, 0, &colors[0])
+			};
+			// \note Odd viewport offset so that fragment packets are not aligned to tiles
+			rr::RenderState							state			(rr::ViewportState(rr::WindowRectangle(3, 5, color.getHeight()-6, color.getDepth()-9)), rr::RenderState::DEFAULT_SUBPIXEL_BITS);
+			const rr::PrimitiveList					primitives		(m_primitiveType, numVertices, 0);
+			const rr::DrawCommand					drawCmd			(state, renderTarget, program, DE_LENGTH_OF_ARRAY(vertexAttribs), vertexAttribs, primitives);
+			const rr::Renderer						renderer		(execMode);
+
+			state.point.pointSize									= 7.0f;
+			state.line.lineWidth									= 3.0f;
+
+			state.fragOps.depthTestEnabled							= true;
+			state.fragOps.depthFunc									= rr::TESTFUNC_LEQUAL;
+			state.fragOps.stencilTestEnabled						= true;
+			state.fragOps.stencilStates[rr::FACETYPE_BACK].func		= rr::TESTFUNC_ALWAYS;
+			state.fragOps.stencilStates[rr::FACETYPE_BACK].dpPass	= rr::STENCILOP_INCR;
+			state.fragOps.stencilStates[rr::FACETYPE_FRONT]			= state.fragOps.stencilStates[rr::FACETYPE_BACK];
+			state.fragOps.blendMode									= rr::BLENDMODE_STANDARD;
+			state.fragOps.blendRGBState.srcFunc						= rr::BLENDFUNC_SRC_ALPHA;
+			state.fragOps.blendRGBState.dstFunc						= rr::BLENDFUNC_ONE_MINUS_SRC_ALPHA;
+			state.fragOps.blendAState								= state.fragOps.blendRGBState;
+
+			renderer.draw(drawCmd);
+		}
+	}
+
+	const rr::PrimitiveType		m_primitiveType;
+	const int					m_numSamples;
+};
+
+struct BufferReuseDraw
+{
+	rr::PrimitiveType	primitiveType;
+	int					numVertices;
+	int					width;
+	int					height;
+	deUint32			seed;
+};
+
+void renderBufferReuseDraw (const rr::Renderer& renderer, const BufferReuseDraw& draw, const tcu::PixelBufferAccess& color)
+{
+	de::Random						rnd				(draw.seed);
+	vector<tcu::Vec4>				positions		(draw.numVertices);
+	vector<tcu::Vec4>				colors			(draw.numVertices);
+
+	for (int vtxNdx = 0; vtxNdx < draw.numVertices; vtxNdx++)
+	{
+		positions[vtxNdx]	= tcu::Vec4(rnd.getFloat(-1.2f, 1.2f), rnd.getFloat(-1.2f, 1.2f), 0.0f, 1.0f);
+		colors[vtxNdx]		= tcu::Vec4(rnd.getFloat(), rnd.getFloat(), rnd.getFloat(), rnd.getFloat(0.2f, 0.8f));
+	}
+
+	tcu::clear(color, tcu::Vec4(0.0f, 0.0f, 0.0f, 1.0f));
+
+	{
+		const ColorVertexShader					vtxShader;
+		const ColorDerivateFragmentShader		fragShader;
+		const rr::Program						program			(&vtxShader, &fragShader);
+		const rr::MultisamplePixelBufferAccess	colorAccess		= rr::MultisamplePixelBufferAccess::fromSinglesampleAccess(color);
+		const rr::RenderTarget					renderTarget	(colorAccess);
+		const rr::VertexAttrib					vertexAttribs[]	=
+		{
+			rr::VertexAttrib(rr::VERTEXATTRIBTYPE_FLOAT, 4, 0, 0, &positions[0]),
+			rr::VertexAttrib(rr::VERTEXATTRIBTYPE_FLOAT, 4, 0, 0, &colors[0])
+		};
+		rr::RenderState							state			(rr::ViewportState(colorAccess), rr::RenderState::DEFAULT_SUBPIXEL_BITS);
+		const rr::PrimitiveList					primitives		(draw.primitiveType, draw.numVertices, 0);
+		const rr::DrawCommand					drawCmd			(state, renderTarget, program, DE_LENGTH_OF_ARRAY(vertexAttribs), vertexAttribs, primitives);
+
+		state.point.pointSize									= 3.0f;
+		state.fragOps.blendMode									= rr::BLENDMODE_STANDARD;
+		state.fragOps.blendRGBState.srcFunc						= rr::BLENDFUNC_SRC_ALPHA;
+		state.fragOps.blendRGBState.dstFunc						= rr::BLENDFUNC_ONE_MINUS_SRC_ALPHA;
+		state.fragOps.blendAState								= state.fragOps.blendRGBState;
+
+		renderer.draw(drawCmd);
+	}
+}
+
+//! Renders draws in order with given renderer, each to its own color buffer
+class BufferReuseDrawThread : public de::Thread
+{
+public:
+	BufferReuseDrawThread (const rr::Renderer& renderer, const vector<BufferReuseDraw>& draws)
+		: m_renderer	(renderer)
+		, m_draws		(draws)
+	{
+		for (size_t drawNdx = 0; drawNdx < draws.size(); drawNdx++)
+			m_results.push_back(de::SharedPtr<tcu::TextureLevel>(new tcu::TextureLevel(tcu::TextureFormat(tcu::TextureFormat::RGBA, tcu::TextureFormat::UNORM_INT8), draws[drawNdx].width, draws[drawNdx].height)));
+	}
+
+	void run (void)
+	{
+		for (size_t drawNdx = 0; drawNdx < m_draws.size(); drawNdx++)
+			renderBufferReuseDraw(m_renderer, m_draws[drawNdx], m_results[drawNdx]->getAccess());
+	}
+
+	const tcu::TextureLevel& getResult (size_t drawNdx) const { return *m_results[drawNdx]; }
+
+private:
+	const rr::Renderer&								m_renderer;
+	const vector<BufferReuseDraw>					m_draws;
+	vector<de::SharedPtr<tcu::TextureLevel> >		m_results;
+};
+
+class RendererBufferReuseCase : public tcu::TestCase
+{
+public:
+	RendererBufferReuseCase (tcu::TestContext& testCtx)
+		: tcu::TestCase(testCtx, "buffer_reuse", "Compare draws with reused renderer buffers to draws with fresh buffers")
+	{
+	}
+
+	IterateResult iterate (void)
+	{
+		static const BufferReuseDraw s_draws[] =
+		{
+			{ rr::PRIMITIVETYPE_TRIANGLES,		300,	97,		83,		1u	},
+			{ rr::PRIMITIVETYPE_LINES,			40,		31,		45,		2u	},
+			{ rr::PRIMITIVETYPE_TRIANGLE_STRIP,	9,		64,		64,		3u	},
+			{ rr::PRIMITIVETYPE_POINTS,			300,	128,	20,		4u	},
+			{ rr::PRIMITIVETYPE_TRIANGLES,		3,		16,		16,		5u	},
+		};
+
+		vector<BufferReuseDraw>	draws	(DE_ARRAY_BEGIN(s_draws), DE_ARRAY_END(s_draws));
+		bool					allOk	= true;
+
+		// Growing and shrinking draws
+		draws.insert(draws.end(), s_draws, DE_ARRAY_END(s_draws) - 1);
+		std::reverse(draws.begin() + DE_LENGTH_OF_ARRAY(s_draws), draws.end());
+
+		{
+			const rr::Renderer		sharedRenderer;
+			BufferReuseDrawThread	sequential		(sharedRenderer, draws);
+			BufferReuseDrawThread	concurrent0		(sharedRenderer, draws);
+			BufferReuseDrawThread	concurrent1		(sharedRenderer, draws);
+
+			sequential.run();
+
+			concurrent0.start();
+			concurrent1.start();
+			concurrent0.join();
+			concurrent1.join();
+
+			for (size_t drawNdx = 0; drawNdx < draws.size(); drawNdx++)
+			{
+				const BufferReuseDraw&	draw		= draws[drawNdx];
+				const rr::Renderer		freshRenderer;
+				tcu::TextureLevel		reference	(tcu::TextureFormat(tcu::TextureFormat::RGBA, tcu::TextureFormat::UNORM_INT8), draw.width, draw.height);
+				const size_t			size		= (size_t)(reference.getFormat().getPixelSize()*draw.width*draw.height);
+
+				renderBufferReuseDraw(freshRenderer, draw, reference.getAccess());
+
+				allOk = checkResult(drawNdx, "sequential",	reference, sequential.getResult(drawNdx), size)		&& allOk;
+				allOk = checkResult(drawNdx, "concurrent",	reference, concurrent0.getResult(drawNdx), size)	&& allOk;
+				allOk = checkResult(drawNdx, "concurrent",	reference, concurrent1.getResult(drawNdx), size)	&& allOk;
+			}
+		}
+
+		if (allOk)
+			m_testCtx.setTestResult(QP_TEST_RESULT_PASS, "Pass");
+		else
+			m_testCtx.setTestResult(QP_TEST_RESULT_FAIL, "Result with reused buffers differs");
+
+		return STOP;
+	}
+
+private:
+	bool checkResult (size_t drawNdx, const char* mode, const tcu::TextureLevel& reference, const tcu::TextureLevel& result, size_t size) const
+	{
+		if (deMemCmp(reference.getAccess().getDataPtr(), result.getAccess().getDataPtr(), size) == 0)
+			return true;
+
+		m_testCtx.getLog() << TestLog::Message << "FAIL: Draw " << drawNdx << " (" << mode << ") differs from draw with fresh buffers" << TestLog::EndMessage
+						   << TestLog::Image("Reference", "Draw with fresh buffers", reference)
+						   << TestLog::Image("Result", "Draw with reused buffers", result);
+		return false;
+	}
+};
+
+//! Counts vertex shader invocations and checks that no vertex is shaded twice in one call.
+class CountingVertexShader : public ColorVertexShader
+{
+public:
+	CountingVertexShader (void)
+		: m_numInvocations		(0)
+		, m_hasDuplicates		(false)
+	{
+	}
+
+	void shadeVertices (const rr::VertexAttrib* inputs, rr::VertexPacket* const* packets, const int numPackets) const
+	{
+		vector<std::pair<int, int> > vertices;
+
+		for (int packetNdx = 0; packetNdx < numPackets; packetNdx++)
+			vertices.push_back(std::make_pair(packets[packetNdx]->instanceNdx, packets[packetNdx]->vertexNdx));
+
+		std::sort(vertices.begin(), vertices.end());
+
+		m_numInvocations	+= numPackets;
+		m_hasDuplicates		= m_hasDuplicates || std::adjacent_find(vertices.begin(), vertices.end()) != vertices.end();
+
+		ColorVertexShader::shadeVertices(inputs, packets, numPackets);
+	}
+
+	int		getNumInvocations	(void) const { return m_numInvocations;	}
+	bool	hasDuplicates		(void) const { return m_hasDuplicates;	}
+
+private:
+	mutable int		m_numInvocations;
+	mutable bool	m_hasDuplicates;
+};
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Test reference renderer post-transform vertex cache
+ *
+ * Indexed draw with repeated indices must run the vertex shader once per
+ * unique index in each primitive restart batch and instance, and produce
+ * exactly the same result as the equivalent non-indexed draw, which never
+ * shares vertices.
+ *//*--------------------------------------------------------------------*/
+class VertexCacheCase : public tcu::TestCase
+{
+public:
+	VertexCacheCase (tcu::TestContext& testCtx, const char* name, rr::PrimitiveType primitiveType, rr::IndexType indexType, int baseVertex, bool restart, int numInstances)
+		: tcu::TestCase		(testCtx, name, "Compare indexed draws with shared vertices to non-indexed draws")
+		, m_primitiveType	(primitiveType)
+		, m_indexType		(indexType)
+		, m_baseVertex		(baseVertex)
+		, m_restart			(restart)
+		, m_numInstances	(numInstances)
+	{
+	}
+
+	IterateResult iterate (void)
+	{
+		// Grid of vertices; elements pick vertices from a small neighbourhood so that indices repeat often.
+		const int					gridSize			= 8;
+		const int					numVertices			= m_baseVertex + gridSize*gridSize;
+		const int					numElements			= 600;
+		const deUint32				restartIndex		= m_indexType == rr::INDEXTYPE_UINT8 ? 0xFFu : m_indexType == rr::INDEXTYPE_UINT16 ? 0xFFFFu : 0xFFFFFFFFu;
+		const tcu::TextureFormat	colorFormat			(tcu::TextureFormat::RGBA, tcu::TextureFormat::UNORM_INT8);
+		de::Random					rnd					(deStringHash(getName()));
+		vector<tcu::Vec4>			positions			(numVertices);
+		vector<tcu::Vec4>			colors				(numVertices);
+		vector<deUint32>			indices				(numElements);
+		vector<tcu::Vec4>			expandedPositions;
+		vector<tcu::Vec4>			expandedColors;
+		vector<int>					batchSizes;
+		tcu::TextureLevel			indexedResult		(colorFormat, 67, 59);
+		tcu::TextureLevel			nonIndexedResult	(colorFormat, 67, 59);
+		int							expectedInvocations	= 0;
+		int							numInvocations		= 0;
+		bool						hasDuplicates		= false;
+
+		for (int vtxNdx = 0; vtxNdx < numVertices; vtxNdx++)
+		{
+			const int gridNdx = de::max(vtxNdx - m_baseVertex, 0);
+
+			positions[vtxNdx] = tcu::Vec4(-1.1f + 2.2f*(float)(gridNdx % gridSize)/(float)(gridSize-1) + rnd.getFloat(-0.1f, 0.1f),
+										  -1.1f + 2.2f*(float)(gridNdx / gridSize)/(float)(gridSize-1) + rnd.getFloat(-0.1f, 0.1f),
+										  0.0f, 1.0f);
+		}
+
+		for (size_t colorNdx = 0; colorNdx < colors.size(); colorNdx++)
+			colors[colorNdx] = tcu::Vec4(rnd.getFloat(), rnd.getFloat(), rnd.getFloat(), rnd.getFloat(0.2f, 0.8f));
+
+		{
+			int cx = 0;
+			int cy = 0;
+
+			for (int elementNdx = 0; elementNdx < numElements; elementNdx++)
+			{
+				if (m_restart && rnd.getInt(0, 15) == 0)
+				{
+					indices[elementNdx] = restartIndex;
+					continue;
+				}
+
+				if (rnd.getInt(0, 3) == 0)
+				{
+					cx = rnd.getInt(0, gridSize-2);
+					cy = rnd.getInt(0, gridSize-2);
+				}
+
+				indices[elementNdx] = (deUint32)((cy + rnd.getInt(0, 1))*gridSize + cx + rnd.getInt(0, 1));
+			}
+		}
+
+		// Expected invocations and equivalent non-indexed draws, one per restart batch.
+		for (int elementNdx = 0; elementNdx < numElements;)
+		{
+			std::set<deUint32>	batchIndices;
+			int					batchSize		= 0;
+
+			for (; elementNdx < numElements && !(m_restart && indices[elementNdx] == restartIndex); elementNdx++, batchSize++)
+			{
+				batchIndices.insert(indices[elementNdx]);
+
+				expandedPositions.push_back(positions[m_baseVertex + indices[elementNdx]]);
+				expandedColors.push_back(colors[m_baseVertex + indices[elementNdx]]);
+			}
+
+			if (batchSize > 0)
+				batchSizes.push_back(batchSize);
+
+			expectedInvocations += (int)batchIndices.size() * m_numInstances;
+
+			// Skip restart index
+			if (elementNdx < numElements)
+				elementNdx++;
+		}
+
+		{
+			const CountingVertexShader	vtxShader;
+			vector<deUint8>				indexData	(numElements*4);
+
+			for (int elementNdx = 0; elementNdx < numElements; elementNdx++)
+			{
+				switch (m_indexType)
+				{
+					case rr::INDEXTYPE_UINT8:	indexData[elementNdx] = (deUint8)indices[elementNdx];												break;
+					case rr::INDEXTYPE_UINT16:	((deUint16*)&indexData[0])[elementNdx] = (deUint16)indices[elementNdx];							break;
+					case rr::INDEXTYPE_UINT32:	((deUint32*)&indexData[0])[elementNdx] = indices[elementNdx];										break;
+					default:
+						DE_ASSERT(false);
+				}
+			}
+
+			{
+				const rr::DrawIndices	drawIndices	= m_indexType == rr::INDEXTYPE_UINT8	? rr::DrawIndices((const deUint8*)&indexData[0], m_baseVertex)
+													: m_indexType == rr::INDEXTYPE_UINT16	? rr::DrawIndices((const deUint16*)&indexData[0], m_baseVertex)
+													: rr::DrawIndices((const deUint32*)&indexData[0], m_baseVertex);
+
+				render(vtxShader, positions, colors, vector<rr::PrimitiveList>(1, rr::PrimitiveList(m_primitiveType, numElements, drawIndices)), m_numInstances, 1, restartIndex, indexedResult.getAccess());
+			}
+
+			numInvocations	= vtxShader.getNumInvocations();
+			hasDuplicates	= vtxShader.hasDuplicates();
+		}
+
+		{
+			const CountingVertexShader	vtxShader;
+			vector<rr::PrimitiveList>	primitives;
+			int							firstElement	= 0;
+
+			for (size_t batchNdx = 0; batchNdx < batchSizes.size(); batchNdx++)
+			{
+				primitives.push_back(rr::PrimitiveList(m_primitiveType, batchSizes[batchNdx], firstElement));
+				firstElement += batchSizes[batchNdx];
+			}
+
+			// Instances are drawn one at a time to keep the same primitive order as in the indexed draw
+			render(vtxShader, expandedPositions, expandedColors, primitives, 1, m_numInstances, restartIndex, nonIndexedResult.getAccess());
+
+			if (vtxShader.getNumInvocations() != (int)expandedPositions.size()*m_numInstances)
+			{
+				m_testCtx.getLog() << TestLog::Message << "FAIL: Non-indexed draw ran vertex shader " << vtxShader.getNumInvocations() << " times, expected " << expandedPositions.size()*m_numInstances << TestLog::EndMessage;
+				m_testCtx.setTestResult(QP_TEST_RESULT_FAIL, "Wrong number of vertex shader invocations");
+				return STOP;
+			}
+		}
+
+		m_testCtx.getLog() << TestLog::Message << numElements << " elements in " << batchSizes.size() << " batches, " << m_numInstances << " instances" << TestLog::EndMessage
+						   << TestLog::Message << "Indexed draw ran vertex shader " << numInvocations << " times, expected " << expectedInvocations << TestLog::EndMessage;
+
+		if (numInvocations != expectedInvocations || hasDuplicates)
+		{
+			if (hasDuplicates)
+				m_testCtx.getLog() << TestLog::Message << "FAIL: Same vertex was shaded more than once in one call" << TestLog::EndMessage;
+
+			m_testCtx.setTestResult(QP_TEST_RESULT_FAIL, "Wrong number of vertex shader invocations");
+		}
+		else if (deMemCmp(indexedResult.getAccess().getDataPtr(), nonIndexedResult.getAccess().getDataPtr(), (size_t)(colorFormat.getPixelSize()*indexedResult.getWidth()*indexedResult.getHeight())) != 0)
+		{
+			m_testCtx.getLog() << TestLog::Image("IndexedResult", "Indexed draw result", indexedResult)
+							   << TestLog::Image("NonIndexedResult", "Non-indexed draw result", nonIndexedResult);
+			m_testCtx.setTestResult(QP_TEST_RESULT_FAIL, "Indexed draw result differs from non-indexed draw");
+		}
+		else
+			m_testCtx.setTestResult(QP_TEST_RESULT_PASS, "Pass");
+
+		return STOP;
+	}
+
+private:
+	void render (const rr::VertexShader& vtxShader, const vector<tcu::Vec4>& positions, const vector<tcu::Vec4>& colors, const vector<rr::PrimitiveList>& primitives, int numInstances, int numRepeats, deUint32 restartIndex, const tcu::PixelBufferAccess& color) const
+	{
+		const ColorDerivateFragmentShader		fragShader;
+		const rr::Program						program			(&vtxShader, &fragShader);
+		const rr::MultisamplePixelBufferAccess	colorAccess		= rr::MultisamplePixelBufferAccess::fromSinglesampleAccess(color);
+		const rr::RenderTarget					renderTarget	(colorAccess);
+		const rr::VertexAttrib					vertexAttribs[]	=
+		{
+			rr::VertexAttrib(rr::VERTEXATTRIBTYPE_FLOAT, 4, 0, 0, &positions[0]),
+			rr::VertexAttrib(rr::VERTEXATTRIBTYPE_FLOAT, 4, 0, 0, &colors[0])
+		};
+		const rr::Renderer						renderer;
+		rr::RenderState							state			(rr::ViewportState(colorAccess), rr::RenderState::DEFAULT_SUBPIXEL_BITS);
+
+		state.point.pointSize					= 3.0f;
+		state.line.lineWidth					= 2.0f;
+		state.restart.enabled					= m_restart;
+		state.restart.restartIndex				= restartIndex;
+		state.fragOps.blendMode					= rr::BLENDMODE_STANDARD;
+		state.fragOps.blendRGBState.srcFunc		= rr::BLENDFUNC_SRC_ALPHA;
+		state.fragOps.blendRGBState.dstFunc		= rr::BLENDFUNC_ONE_MINUS_SRC_ALPHA;
+		state.fragOps.blendAState				= state.fragOps.blendRGBState;
+
+		tcu::clear(color, tcu::Vec4(0.0f, 0.0f, 0.0f, 1.0f));
+
+		for (int repeatNdx = 0; repeatNdx < numRepeats; repeatNdx++)
+		for (size_t drawNdx = 0; drawNdx < primitives.size(); drawNdx++)
+			renderer.drawInstanced(rr::DrawCommand(state, renderTarget, program, DE_LENGTH_OF_ARRAY(vertexAttribs), vertexAttribs, primitives[drawNdx]), numInstances);
+	}
+
+	const rr::PrimitiveType		m_primitiveType;
+	const rr::IndexType			m_indexType;
+	const int					m_baseVertex;
+	const bool					m_restart;
+	const int					m_numInstances;
+};
+
+class TriangleRasterizationPerfCase : public tcu::TestCase
+{
+public:
+	TriangleRasterizationPerfCase (tcu::TestContext& testCtx, const char* name, int quadSize, int numSamples)
+		: tcu::TestCase		(testCtx, name, "Measure triangle rasterization performance")
+		, m_quadSize		(quadSize)
+		, m_numSamples		(numSamples)
+	{
+	}
+
+	IterateResult iterate (void)
+	{
+		// Quads are split into two triangles along the diagonal. Quad corners are on
+		// pixel corners and all samples are strictly inside pixels so the fill rules
+		// must cover each sample inside a quad exactly once.
+		const int							viewportSize		= 512;
+		const int							maxPackets			= 128;
+		const int							numQuads			= de::max(1, 4*viewportSize*viewportSize / (m_quadSize*m_quadSize));
+		const tcu::IVec4					viewport			(0, 0, viewportSize, viewportSize);
+		const rr::RasterizationState		state;
+		de::Random							rnd					(deStringHash(getName()));
+		vector<tcu::Vec4>					vertices;
+		vector<rr::FragmentPacket>			packets				(maxPackets);
+		vector<float>						depthValues			(maxPackets*4*m_numSamples);
+		deUint64							numPackets			= 0;
+		deUint64							numCoveredSamples	= 0;
+		deUint64							rasterizationTime	= 0;
+
+		for (int quadNdx = 0; quadNdx < numQuads; quadNdx++)
+		{
+			const float			x0				= (float)rnd.getInt(0, viewportSize - m_quadSize);
+			const float			y0				= (float)rnd.getInt(0, viewportSize - m_quadSize);
+			const float			x1				= x0 + (float)m_quadSize;
+			const float			y1				= y0 + (float)m_quadSize;
+			const tcu::Vec4		corners[]		=
+			{
+				tcu::Vec4(x0, y0, rnd.getFloat(), 1.0f),
+				tcu::Vec4(x1, y0, rnd.getFloat(), 1.0f),
+				tcu::Vec4(x0, y1, rnd.getFloat(), 1.0f),
+				tcu::Vec4(x1, y1, rnd.getFloat(), 1.0f)
+			};
+			const bool			flipDiagonal	= rnd.getBool();
+			const int			indices[]		= { 0, 1, flipDiagonal ? 3 : 2, flipDiagonal ? 0 : 1, 3, 2 };
+
+			for (int ndx = 0; ndx < DE_LENGTH_OF_ARRAY(indices); ndx++)
+				vertices.push_back(corners[indices[ndx]]);
+		}
+
+		{
+			const deUint64 startTime = deGetMicroseconds();
+
+			for (size_t triNdx = 0; triNdx < vertices.size()/3; triNdx++)
+			{
+				rr::TriangleRasterizer rasterizer (viewport, m_numSamples, state, rr::RenderState::DEFAULT_SUBPIXEL_BITS);
+
+				rasterizer.init(vertices[triNdx*3+0], vertices[triNdx*3+1], vertices[triNdx*3+2]);
+
+				for (;;)
+				{
+					int numRasterized = 0;
+
+					rasterizer.rasterize(&packets[0], &depthValues[0], maxPackets, numRasterized);
+
+					if (numRasterized == 0)
+						break;
+
+					numPackets += (deUint64)numRasterized;
+
+					for (int packetNdx = 0; packetNdx < numRasterized; packetNdx++)
+						numCoveredSamples += (deUint64)dePop64(packets[packetNdx].coverage);
+				}
+			}
+
+			rasterizationTime = deGetMicroseconds()-startTime;
+		}
+
+		{
+			const deUint64 expectedSamples = (deUint64)numQuads*(deUint64)(m_quadSize*m_quadSize*m_numSamples);
+
+			m_testCtx.getLog() << TestLog::Integer("NumTriangles",		"Number of triangles",		"",		QP_KEY_TAG_NONE,	2*numQuads)
+							   << TestLog::Integer("NumPackets",		"Number of fragment packets",	"",		QP_KEY_TAG_NONE,	(deInt64)numPackets)
+							   << TestLog::Integer("RasterizationTime",	"Rasterization time",		"us",	QP_KEY_TAG_TIME,	(deInt64)rasterizationTime);
+
+			if (numCoveredSamples == expectedSamples)
+				m_testCtx.setTestResult(QP_TEST_RESULT_PASS, "Pass");
+			else
+			{
+				m_testCtx.getLog() << TestLog::Message << "FAIL: Expected " << expectedSamples << " covered samples, got " << numCoveredSamples << TestLog::EndMessage;
+				m_testCtx.setTestResult(QP_TEST_RESULT_FAIL, "Wrong number of covered samples");
+			}
+		}
+
+		return STOP;
+	}
+
+private:
+	const int	m_quadSize;
+	const int	m_numSamples;
+};
+
+//! Scalar triangle coverage evaluation, equivalent to rr::TriangleRasterizer before packet-wide edge evaluation.
+class ScalarTriangleCoverage
+{
+public:
+	ScalarTriangleCoverage (const rr::RasterizationState& state, int numSamples, int subpixelBits, const tcu::Vec4& v0, const tcu::Vec4& v1, const tcu::Vec4& v2)
+		: m_numSamples		(numSamples)
+		, m_subpixelBits	(subpixelBits)
+		, m_v0				(v0)
+		, m_v1				(v1)
+		, m_v2				(v2)
+	{
+		const deInt64 x0 = toSubpixelCoord(v0.x());
+		const deInt64 y0 = toSubpixelCoord(v0.y());
+		const deInt64 x1 = toSubpixelCoord(v1.x());
+		const deInt64 y1 = toSubpixelCoord(v1.y());
+		const deInt64 x2 = toSubpixelCoord(v2.x());
+		const deInt64 y2 = toSubpixelCoord(v2.y());
+
+		if (state.winding == rr::WINDING_CCW)
+		{
+			initEdge(m_edges[0], state, x0, y0, x1, y1);
+			initEdge(m_edges[1], state, x1, y1, x2, y2);
+			initEdge(m_edges[2], state, x2, y2, x0, y0);
+		}
+		else
+		{
+			initEdge(m_edges[0], state, x1, y1, x0, y0);
+			initEdge(m_edges[1], state, x2, y2, x1, y1);
+			initEdge(m_edges[2], state, x0, y0, x2, y2);
+		}
+
+		{
+			const deInt64	s				= evaluate(m_edges[0], x2, y2);
+			const bool		positiveArea	= (state.winding == rr::WINDING_CCW) ? (s > 0) : (s < 0);
+
+			if (!positiveArea)
+			{
+				for (int edgeNdx = 0; edgeNdx < 3; edgeNdx++)
+				{
+					m_edges[edgeNdx].a			= -m_edges[edgeNdx].a;
+					m_edges[edgeNdx].b			= -m_edges[edgeNdx].b;
+					m_edges[edgeNdx].c			= -m_edges[edgeNdx].c;
+					m_edges[edgeNdx].inclusive	= !m_edges[edgeNdx].inclusive;
+				}
+			}
+		}
+	}
+
+	bool isCovered (int x, int y, int sampleNdx) const
+	{
+		const tcu::Vector<deInt64, 2>	pos	= getSamplePos(x, y, sampleNdx);
+
+		for (int edgeNdx = 0; edgeNdx < 3; edgeNdx++)
+		{
+			const deInt64 value = evaluate(m_edges[edgeNdx], pos.x(), pos.y());
+
+			if (m_edges[edgeNdx].inclusive ? (value < 0) : (value <= 0))
+				return false;
+		}
+
+		return true;
+	}
+
+	//! Barycentrics at pixel center.
+	void getBarycentrics (int x, int y, tcu::Vec3* barycentric) const
+	{
+		const deInt64	halfPixel	= 1ll << (m_subpixelBits - 1);
+		const deInt64	sx			= ((deInt64)x << m_subpixelBits) + halfPixel;
+		const deInt64	sy			= ((deInt64)y << m_subpixelBits) + halfPixel;
+		const float		e01f		= (float)evaluate(m_edges[0], sx, sy);
+		const float		e12f		= (float)evaluate(m_edges[1], sx, sy);
+		const float		e20f		= (float)evaluate(m_edges[2], sx, sy);
+		const float		b0			= e12f * m_v0.w();
+		const float		b1			= e20f * m_v1.w();
+		const float		b2			= e01f * m_v2.w();
+		const float		bSum		= b0 + b1 + b2;
+		const float		r0			= b0 / bSum;
+		const float		r1			= b1 / bSum;
+
+		*barycentric = tcu::Vec3(r0, r1, 1.0f - r0 - r1);
+	}
+
+	float getDepth (int x, int y, int sampleNdx) const
+	{
+		const tcu::Vector<deInt64, 2>	pos		= getSamplePos(x, y, sampleNdx);
+		const float						e01f	= (float)evaluate(m_edges[0], pos.x(), pos.y());
+		const float						e12f	= (float)evaluate(m_edges[1], pos.x(), pos.y());
+		const float						e20f	= (float)evaluate(m_edges[2], pos.x(), pos.y());
+		const float						edgeSum	= e01f + e12f + e20f;
+
+		return (e12f / edgeSum)*(m_v0.z() - m_v2.z()) + (e20f / edgeSum)*(m_v1.z() - m_v2.z()) + m_v2.z();
+	}
+
+private:
+	struct Edge
+	{
+		deInt64	a;
+		deInt64	b;
+		deInt64	c;
+		bool	inclusive;
+	};
+
+	deInt64 toSubpixelCoord (float v) const
+	{
+		return (deInt64)(v * (float)(1 << m_subpixelBits) + (v < 0.f ? -0.5f : 0.5f));
+	}
+
+	static void initEdge (Edge& edge, const rr::RasterizationState& state, deInt64 x0, deInt64 y0, deInt64 x1, deInt64 y1)
+	{
+		const deInt64 xd = x1 - x0;
+		const deInt64 yd = y1 - y0;
+
+		if (yd == 0)
+			edge.inclusive = state.verticalFill == rr::FILL_BOTTOM ? xd >= 0 : xd <= 0;
+		else
+			edge.inclusive = state.horizontalFill == rr::FILL_LEFT ? yd <= 0 : yd >= 0;
+
+		edge.a = y0 - y1;
+		edge.b = x1 - x0;
+		edge.c = x0*y1 - y0*x1;
+	}
+
+	static deInt64 evaluate (const Edge& edge, deInt64 x, deInt64 y)
+	{
+		return edge.a*x + edge.b*y + edge.c;
+	}
+
+	tcu::Vector<deInt64, 2> getSamplePos (int x, int y, int sampleNdx) const
+	{
+		// Sample positions of rrRasterizer.cpp
+		static const float s_samplePts2[]	= { 0.3f, 0.3f, 0.7f, 0.7f };
+		static const float s_samplePts4[]	= { 0.25f, 0.25f, 0.75f, 0.25f, 0.25f, 0.75f, 0.75f, 0.75f };
+		static const float s_samplePts8[]	=
+		{
+			7.f  / 16.f,  9.f / 16.f,	9.f  / 16.f, 13.f / 16.f,	11.f / 16.f,  3.f / 16.f,	13.f / 16.f, 11.f / 16.f,
+			1.f  / 16.f,  7.f / 16.f,	5.f  / 16.f,  1.f / 16.f,	15.f / 16.f,  5.f / 16.f,	 3.f / 16.f, 15.f / 16.f
+		};
+
+		const deInt64	sx	= (deInt64)x << m_subpixelBits;
+		const deInt64	sy	= (deInt64)y << m_subpixelBits;
+
+		switch (m_numSamples)
+		{
+			case 1:		return tcu::Vector<deInt64, 2>(sx + (1ll << (m_subpixelBits - 1)), sy + (1ll << (m_subpixelBits - 1)));
+			case 2:		return tcu::Vector<deInt64, 2>(sx + toSubpixelCoord(s_samplePts2[sampleNdx*2]), sy + toSubpixelCoord(s_samplePts2[sampleNdx*2+1]));
+			case 4:		return tcu::Vector<deInt64, 2>(sx + toSubpixelCoord(s_samplePts4[sampleNdx*2]), sy + toSubpixelCoord(s_samplePts4[sampleNdx*2+1]));
+			case 8:		return tcu::Vector<deInt64, 2>(sx + toSubpixelCoord(s_samplePts8[sampleNdx*2]), sy + toSubpixelCoord(s_samplePts8[sampleNdx*2+1]));
+			case 16:	return tcu::Vector<deInt64, 2>(sx + toSubpixelCoord((float)(2*(sampleNdx%4) + 1) / 8.0f), sy + toSubpixelCoord((float)(2*(sampleNdx/4) + 1) / 8.0f));
+			default:
+				DE_ASSERT(false);
+				return tcu::Vector<deInt64, 2>(sx, sy);
+		}
+	}
+
+	const int		m_numSamples;
+	const int		m_subpixelBits;
+	const tcu::Vec4	m_v0;
+	const tcu::Vec4	m_v1;
+	const tcu::Vec4	m_v2;
+	Edge			m_edges[3];
+};
+
+//! Random coordinate, on a sample position or pixel center grid if snap is set so that edges go through samples.
+float getRandomTriangleCoord (de::Random& rnd, int minCoord, int maxCoord, bool snap)
+{
+	if (snap)
+		return (float)rnd.getInt(minCoord, maxCoord) + (float)rnd.getInt(0, 15) / 16.0f;
+	else
+		return rnd.getFloat((float)minCoord, (float)maxCoord);
+}
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Compare rr::TriangleRasterizer to scalar coverage evaluation
+ *
+ * Coverage of every sample in the viewport, and barycentrics and depth
+ * values of covered fragments must be bit-exact with the scalar evaluation.
+ * Triangles include ones with edges through sample positions (fill rules),
+ * axis-aligned edges and zero-area triangles.
+ *//*--------------------------------------------------------------------*/
+class TriangleCoverageCase : public tcu::TestCase
+{
+public:
+	TriangleCoverageCase (tcu::TestContext& testCtx, const char* name, int numSamples)
+		: tcu::TestCase		(testCtx, name, "Compare triangle rasterization to scalar coverage evaluation")
+		, m_numSamples		(numSamples)
+	{
+	}
+
+	IterateResult iterate (void)
+	{
+		// Odd viewport size and offset so that packets are clipped at the right and top edges.
+		const tcu::IVec4	viewport		(3, 5, 37, 29);
+		const int			subpixelBits	= rr::RenderState::DEFAULT_SUBPIXEL_BITS;
+		const int			numTriangles	= 200;
+		de::Random			rnd				(deStringHash(getName()));
+		int					numFailed		= 0;
+		int					numCovered		= 0;
+
+		for (int stateNdx = 0; stateNdx < 8; stateNdx++)
+		for (int triNdx = 0; triNdx < numTriangles; triNdx++)
+		{
+			rr::RasterizationState	state;
+			tcu::Vec4				v[3];
+
+			state.winding			= (stateNdx & 1) ? rr::WINDING_CW : rr::WINDING_CCW;
+			state.horizontalFill	= (stateNdx & 2) ? rr::FILL_RIGHT : rr::FILL_LEFT;
+			state.verticalFill		= (stateNdx & 4) ? rr::FILL_TOP : rr::FILL_BOTTOM;
+
+			for (int vtxNdx = 0; vtxNdx < 3; vtxNdx++)
+			{
+				v[vtxNdx] = tcu::Vec4(getRandomTriangleCoord(rnd, viewport.x() - 4, viewport.x() + viewport.z() + 4, triNdx % 2 == 0),
+									  getRandomTriangleCoord(rnd, viewport.y() - 4, viewport.y() + viewport.w() + 4, triNdx % 2 == 0),
+									  rnd.getFloat(), rnd.getFloat(0.5f, 2.0f));
+			}
+
+			switch (triNdx % 10)
+			{
+				case 2:
+					// Vertical edge
+					v[1].x() = v[0].x();
+					break;
+
+				case 4:
+					// Horizontal edge
+					v[1].y() = v[0].y();
+					break;
+
+				case 6:
+					// Axis-aligned right angle
+					v[1].x() = v[0].x();
+					v[2].y() = v[0].y();
+					break;
+
+				case 8:
+					// Zero area, collinear vertices
+					v[2].x() = (v[0].x() + v[1].x()) * 0.5f;
+					v[2].y() = (v[0].y() + v[1].y()) * 0.5f;
+					break;
+
+				case 9:
+					// Zero area, repeated vertices
+					v[1] = v[0];
+					if (triNdx % 20 == 19)
+						v[2] = v[0];
+					break;
+
+				default:
+					break;
+			}
+
+			if (!compareTriangle(viewport, state, subpixelBits, v, numCovered))
+				numFailed += 1;
+		}
+
+		m_testCtx.getLog() << TestLog::Message << numFailed << " of " << 8*numTriangles << " triangles differ from scalar evaluation, " << numCovered << " samples covered" << TestLog::EndMessage;
+
+		if (numFailed == 0)
+			m_testCtx.setTestResult(QP_TEST_RESULT_PASS, "Pass");
+		else
+			m_testCtx.setTestResult(QP_TEST_RESULT_FAIL, "Rasterization differs from scalar evaluation");
+
+		return STOP;
+	}
+
+private:
+	bool compareTriangle (const tcu::IVec4& viewport, const rr::RasterizationState& state, int subpixelBits, const tcu::Vec4* v, int& numCovered)
+	{
+		// Small batches so that rasterization is also resumed in the middle of rows.
+		const int						maxPackets	= 3;
+		const int						numPixels	= viewport.z()*viewport.w();
+		const ScalarTriangleCoverage	reference	(state, m_numSamples, subpixelBits, v[0], v[1], v[2]);
+		rr::TriangleRasterizer			rasterizer	(viewport, m_numSamples, state, subpixelBits);
+		vector<rr::FragmentPacket>		packets		(maxPackets);
+		vector<float>					depthValues	(maxPackets*4*m_numSamples);
+		vector<deUint64>				coverage	(numPixels, 0);
+		vector<float>					barycentric	(numPixels*3);
+		vector<float>					depth		(numPixels*m_numSamples);
+		bool							isOk		= true;
+
+		rasterizer.init(v[0], v[1], v[2]);
+
+		for (;;)
+		{
+			int numRasterized = 0;
+
+			rasterizer.rasterize(&packets[0], &depthValues[0], maxPackets, numRasterized);
+
+			if (numRasterized == 0)
+				break;
+
+			for (int packetNdx = 0; packetNdx < numRasterized; packetNdx++)
+			for (int fragNdx = 0; fragNdx < 4; fragNdx++)
+			{
+				const rr::FragmentPacket&	packet		= packets[packetNdx];
+				const int					fragX		= fragNdx % 2;
+				const int					fragY		= fragNdx / 2;
+				const tcu::IVec2			pos			= packet.position + tcu::IVec2(fragX, fragY) - viewport.swizzle(0, 1);
+				const deUint64				fragBits	= packet.coverage & rr::getCoverageFragmentSampleBits(m_numSamples, fragX, fragY);
+				int							pixelNdx;
+
+				if (fragBits == 0)
+					continue;
+
+				if (!de::inBounds(pos.x(), 0, viewport.z()) || !de::inBounds(pos.y(), 0, viewport.w()))
+				{
+					m_testCtx.getLog() << TestLog::Message << "Fragment " << pos << " outside viewport is covered" << TestLog::EndMessage;
+					return false;
+				}
+
+				pixelNdx = pos.y()*viewport.z() + pos.x();
+
+				if (coverage[pixelNdx] != 0)
+				{
+					m_testCtx.getLog() << TestLog::Message << "Fragment " << pos << " is rasterized twice" << TestLog::EndMessage;
+					return false;
+				}
+
+				coverage[pixelNdx] = fragBits >> rr::getCoverageOffset(m_numSamples, fragX, fragY);
+
+				for (int ndx = 0; ndx < 3; ndx++)
+					barycentric[pixelNdx*3 + ndx] = packet.barycentric[ndx][fragNdx];
+
+				for (int sampleNdx = 0; sampleNdx < m_numSamples; sampleNdx++)
+					depth[pixelNdx*m_numSamples + sampleNdx] = depthValues[(packetNdx*4 + fragNdx)*m_numSamples + sampleNdx];
+			}
+		}
+
+		for (int y = 0; y < viewport.w() && isOk; y++)
+		for (int x = 0; x < viewport.z() && isOk; x++)
+		{
+			const int	pixelNdx			= y*viewport.z() + x;
+			deUint64	referenceCoverage	= 0;
+
+			for (int sampleNdx = 0; sampleNdx < m_numSamples; sampleNdx++)
+			{
+				if (reference.isCovered(viewport.x() + x, viewport.y() + y, sampleNdx))
+					referenceCoverage |= 1ull << sampleNdx;
+			}
+
+			numCovered += dePop64(referenceCoverage);
+
+			if (coverage[pixelNdx] != referenceCoverage)
+			{
+				m_testCtx.getLog() << TestLog::Message << "Coverage of fragment " << tcu::IVec2(x, y) << " is " << tcu::toHex(coverage[pixelNdx]) << ", expected " << tcu::toHex(referenceCoverage) << TestLog::EndMessage;
+				isOk = false;
+				break;
+			}
+
+			if (referenceCoverage == 0)
+				continue;
+
+			{
+				tcu::Vec3 refBarycentric;
+
+				reference.getBarycentrics(viewport.x() + x, viewport.y() + y, &refBarycentric);
+
+				for (int ndx = 0; ndx < 3; ndx++)
+				{
+					if (deMemCmp(&barycentric[pixelNdx*3 + ndx], &refBarycentric[ndx], sizeof(float)) != 0)
+					{
+						m_testCtx.getLog() << TestLog::Message << "Barycentric " << ndx << " of fragment " << tcu::IVec2(x, y) << " is " << barycentric[pixelNdx*3 + ndx] << ", expected " << refBarycentric[ndx] << TestLog::EndMessage;
+						isOk = false;
+					}
+				}
+			}
+
+			for (int sampleNdx = 0; sampleNdx < m_numSamples; sampleNdx++)
+			{
+				const float refDepth = reference.getDepth(viewport.x() + x, viewport.y() + y, sampleNdx);
+
+				if (deMemCmp(&depth[pixelNdx*m_numSamples + sampleNdx], &refDepth, sizeof(float)) != 0)
+				{
+					m_testCtx.getLog() << TestLog::Message << "Depth of fragment " << tcu::IVec2(x, y) << " sample " << sampleNdx << " is " << depth[pixelNdx*m_numSamples + sampleNdx] << ", expected " << refDepth << TestLog::EndMessage;
+					isOk = false;
+				}
+			}
+		}
+
+		if (!isOk)
+			m_testCtx.getLog() << TestLog::Message << "Triangle " << v[0] << ", " << v[1] << ", " << v[2] << TestLog::EndMessage;
+
+		return isOk;
+	}
+
+	const int	m_numSamples;
+};
+
+enum IntervalOp
+{
+	INTERVALOP_ADD = 0,
+	INTERVALOP_SUB,
+	INTERVALOP_MUL,
+	INTERVALOP_DIV,
+
+	INTERVALOP_LAST
+};
+
+double getRandomIntervalOperand (de::Random& rnd)
+{
+	static const double specialValues[] =
+	{
+		0.0, -0.0, 1.0, -1.0, 3.0, 0.1,
+		std::numeric_limits<double>::infinity(),
+		-std::numeric_limits<double>::infinity(),
+		std::numeric_limits<double>::quiet_NaN(),
+		std::numeric_limits<double>::max(),
+		std::numeric_limits<double>::min(),
+		std::numeric_limits<double>::denorm_min(),
+	};
+
+	const double sign = rnd.getBool() ? 1.0 : -1.0;
+
+	switch (rnd.getInt(0, 5))
+	{
+		case 0:		return tcu::Float64(rnd.getUint64()).asDouble();
+		case 1:		return (double)tcu::Float32(rnd.getUint32()).asFloat();
+		case 2:		return sign * (double)rnd.getInt(1, 1000) / (double)rnd.getInt(1, 64);
+		case 3:		return sign * deLdExp(rnd.getDouble(1.0, 2.0), rnd.getInt(950, 1023));		// near overflow
+		case 4:		return sign * deLdExp(rnd.getDouble(1.0, 2.0), rnd.getInt(-1074, -900));	// near underflow
+		default:	return specialValues[rnd.getInt(0, DE_LENGTH_OF_ARRAY(specialValues)-1)];
+	}
+}
+
+//! Evaluate operation in current rounding mode
+double evalIntervalOp (IntervalOp op, double x, double y)
+{
+	// \note Volatile prevents compiler from evaluating operation at compile time or moving it across rounding mode changes
+	volatile double	vx	= x;
+	volatile double	vy	= y;
+	volatile double	res	= 0.0;
+
+	switch (op)
+	{
+		case INTERVALOP_ADD:	res = vx + vy;	break;
+		case INTERVALOP_SUB:	res = vx - vy;	break;
+		case INTERVALOP_MUL:	res = vx * vy;	break;
+		case INTERVALOP_DIV:	res = vx / vy;	break;
+		default:
+			DE_ASSERT(false);
+	}
+
+	return res;
+}
+
+double evalIntervalOpFpu (IntervalOp op, double x, double y, bool upward)
+{
+	const tcu::ScopedRoundingMode ctx (upward ? DE_ROUNDINGMODE_TO_POSITIVE_INF : DE_ROUNDINGMODE_TO_NEGATIVE_INF);
+
+	return evalIntervalOp(op, x, y);
+}
+
+double evalIntervalOpModeFree (IntervalOp op, double x, double y, bool upward)
+{
+	switch (op)
+	{
+		case INTERVALOP_ADD:	return tcu::roundedAdd(x, y, upward);
+		case INTERVALOP_SUB:	return tcu::roundedSub(x, y, upward);
+		case INTERVALOP_MUL:	return tcu::roundedMul(x, y, upward);
+		case INTERVALOP_DIV:	return tcu::roundedDiv(x, y, upward);
+		default:
+			DE_ASSERT(false);
+			return 0.0;
+	}
+}
+
+tcu::Interval evalIntervalOp (IntervalOp op, const tcu::Interval& x, const tcu::Interval& y)
+{
+	switch (op)
+	{
+		case INTERVALOP_ADD:	return x + y;
+		case INTERVALOP_SUB:	return x - y;
+		case INTERVALOP_MUL:	return x * y;
+		case INTERVALOP_DIV:	return x / y;
+		default:
+			DE_ASSERT(false);
+			return tcu::Interval();
+	}
+}
+
+//! Differential test of rounding-mode-free interval rounding against FPU directed rounding
+class IntervalRoundingCase : public tcu::TestCase
+{
+public:
+	IntervalRoundingCase (tcu::TestContext& testCtx)
+		: tcu::TestCase(testCtx, "interval_rounding", "Compare rounding-mode-free interval arithmetic to FPU directed rounding")
+	{
+	}
+
+	IterateResult iterate (void)
+	{
+		static const char* const	opNames[]			= { "add", "sub", "mul", "div" };
+		const int					numIterations		= 100000;
+		const int					maxLoggedFailures	= 10;
+		// Results are exact when no value is near subnormal range
+		const double				minExactMagnitude	= deLdExp(1.0, -900);
+		de::Random					rnd					(0x1a2b3c4d);
+		int							numExact[INTERVALOP_LAST]	= { 0 };
+		int							numWider[INTERVALOP_LAST]	= { 0 };
+		int							numFailures			= 0;
+
+		DE_STATIC_ASSERT(DE_LENGTH_OF_ARRAY(opNames) == INTERVALOP_LAST);
+
+		m_testCtx.getLog() << TestLog::Message << "Build uses " << (TCU_INTERVAL_ROUNDING_MODE_FREE ? "rounding-mode-free" : "FPU rounding mode") << " interval rounding" << TestLog::EndMessage;
+
+		for (int iterNdx = 0; iterNdx < numIterations; iterNdx++)
+		{
+			const double	x	= getRandomIntervalOperand(rnd);
+			// Related operands exercise cancellation and exact results
+			const double	y	= (rnd.getInt(0, 3) == 0) ? (rnd.getBool() ? -x : x * (1.0 + deLdExp(1.0, -rnd.getInt(1, 52)))) : getRandomIntervalOperand(rnd);
+
+			for (int opNdx = 0; opNdx < INTERVALOP_LAST; opNdx++)
+			{
+				const IntervalOp	op				= (IntervalOp)opNdx;
+				const double		nearest			= evalIntervalOp(op, x, y);
+				const double		fpuLo			= evalIntervalOpFpu(op, x, y, false);
+				const double		fpuHi			= evalIntervalOpFpu(op, x, y, true);
+				const double		modeFreeLo		= evalIntervalOpModeFree(op, x, y, false);
+				const double		modeFreeHi		= evalIntervalOpModeFree(op, x, y, true);
+				const tcu::Interval	fpuRange		= tcu::Interval(fpuLo) | tcu::Interval(fpuHi);
+				const bool			isExactRange	= (op == INTERVALOP_ADD || op == INTERVALOP_SUB) ||
+													  (isExactMagnitude(x, minExactMagnitude) && isExactMagnitude(y, minExactMagnitude) &&
+													   (nearest == 0.0 ? (x == 0.0 || y == 0.0) : isExactMagnitude(nearest, minExactMagnitude)));
+				const bool			isExact			= isSameValue(modeFreeLo, fpuLo) && isSameValue(modeFreeHi, fpuHi);
+				const bool			isConservative	= (deIsNaN(fpuLo) ? deIsNaN(modeFreeLo) : (modeFreeLo <= fpuLo)) &&
+													  (deIsNaN(fpuHi) ? deIsNaN(modeFreeHi) : (modeFreeHi >= fpuHi));
+				const bool			widenedOk		= tcu::widenByUlps(tcu::Interval(nearest), 1).contains(fpuRange);
+				// \note Rounding mode switching is not visible to the optimizer, so interval operations
+				//		 are checked only when they don't depend on it. Division by interval containing
+				//		 zero gives unbounded interval without NaN.
+				const bool			intervalOk		= !TCU_INTERVAL_ROUNDING_MODE_FREE || (op == INTERVALOP_DIV && y == 0.0) ||
+													  evalIntervalOp(op, tcu::Interval(x), tcu::Interval(y)).contains(fpuRange);
+
+				if (isExact)
+					numExact[opNdx] += 1;
+				else if (isConservative)
+					numWider[opNdx] += 1;
+
+				if (!isConservative || (isExactRange && !isExact) || !widenedOk || !intervalOk)
+				{
+					if (numFailures < maxLoggedFailures)
+						m_testCtx.getLog() << TestLog::Message << "FAIL: " << opNames[opNdx] << "(" << de::toString(x) << ", " << de::toString(y) << "): "
+										   << "expected [" << fpuLo << ", " << fpuHi << "], got [" << modeFreeLo << ", " << modeFreeHi << "]"
+										   << (widenedOk ? "" : ", widened result doesn't contain expected")
+										   << (intervalOk ? "" : ", interval operation result doesn't contain expected")
+										   << TestLog::EndMessage;
+					numFailures += 1;
+				}
+			}
+		}
+
+		for (int opNdx = 0; opNdx < INTERVALOP_LAST; opNdx++)
+			m_testCtx.getLog() << TestLog::Message << opNames[opNdx] << ": " << numExact[opNdx] << " exact, " << numWider[opNdx] << " wider than FPU rounding" << TestLog::EndMessage;
+
+		if (numFailures == 0)
+			m_testCtx.setTestResult(QP_TEST_RESULT_PASS, "Pass");
+		else
+			m_testCtx.setTestResult(QP_TEST_RESULT_FAIL, (de::toString(numFailures) + " failures").c_str());
+
+		return STOP;
+	}
+
+private:
+	static bool isExactMagnitude (double x, double minMagnitude)
+	{
+		return x == 0.0 || deIsNaN(x) || de::abs(x) >= minMagnitude;
+	}
+
+	static bool isSameValue (double a, double b)
+	{
+		return (deIsNaN(a) && deIsNaN(b)) || a == b;
+	}
+};
+
+class DecompressionPerfCase : public tcu::TestCase
+{
+public:
+	DecompressionPerfCase (tcu::TestContext& testCtx, const char* name, tcu::CompressedTexFormat format)
+		: tcu::TestCase		(testCtx, name, "Measure texture decompression throughput")
+		, m_format			(format)
+	{
+	}
+
+	IterateResult iterate (void)
+	{
+		const int								size				= 1024;
+		const tcu::IVec3						blockPixelSize		= tcu::getBlockPixelSize(m_format);
+		const int								numBlocks			= deDivRoundUp32(size, blockPixelSize.x())*deDivRoundUp32(size, blockPixelSize.y());
+		const int								blockSize			= tcu::getBlockSize(m_format);
+		const tcu::TexDecompressionParams::AstcMode	astcMode		= tcu::TexDecompressionParams::ASTCMODE_LDR;
+		const tcu::TextureFormat				uncompressedFormat	= tcu::getUncompressedFormat(m_format);
+		const double							uncompressedMB		= (double)(size*size*uncompressedFormat.getPixelSize()) / (1024.0*1024.0);
+		vector<deUint8>							data				(numBlocks*blockSize);
+		tcu::TextureLevel						serialTexture		(uncompressedFormat, size, size);
+		tcu::TextureLevel						parallelTexture		(uncompressedFormat, size, size);
+		deUint64								serialTime			= 0;
+		deUint64								parallelTime		= 0;
+
+		if (tcu::isAstcFormat(m_format))
+			tcu::astc::generateRandomValidBlocks(&data[0], (size_t)numBlocks, m_format, astcMode, deStringHash(getName()));
+		else
+		{
+			de::Random rnd (deStringHash(getName()));
+
+			for (size_t ndx = 0; ndx < data.size(); ndx++)
+				data[ndx] = rnd.getUint8();
+		}
+
+		{
+			const deUint64 startTime = deGetMicroseconds();
+			tcu::decompress(serialTexture.getAccess(), m_format, &data[0], tcu::TexDecompressionParams(astcMode, tcu::TexDecompressionParams::EXECMODE_SERIAL));
+			serialTime = deGetMicroseconds()-startTime;
+		}
+
+		{
+			const deUint64 startTime = deGetMicroseconds();
+			tcu::decompress(parallelTexture.getAccess(), m_format, &data[0], tcu::TexDecompressionParams(astcMode, tcu::TexDecompressionParams::EXECMODE_PARALLEL));
+			parallelTime = deGetMicroseconds()-startTime;
+		}
+
+		m_testCtx.getLog() << TestLog::Integer("NumBlocks",				"Number of blocks",								"",		QP_KEY_TAG_NONE,		numBlocks)
+						   << TestLog::Integer("SerialTime",			"Serial decompression time",					"us",	QP_KEY_TAG_TIME,		(deInt64)serialTime)
+						   << TestLog::Integer("ParallelTime",			"Parallel decompression time",					"us",	QP_KEY_TAG_TIME,		(deInt64)parallelTime)
+						   << TestLog::Float("SerialThroughput",		"Serial decompression throughput (output)",		"MB/s",	QP_KEY_TAG_PERFORMANCE,	(float)(uncompressedMB / ((double)de::max<deUint64>(serialTime, 1) / 1e6)))
+						   << TestLog::Float("ParallelThroughput",		"Parallel decompression throughput (output)",	"MB/s",	QP_KEY_TAG_PERFORMANCE,	(float)(uncompressedMB / ((double)de::max<deUint64>(parallelTime, 1) / 1e6)));
+
+		if (deMemCmp(serialTexture.getAccess().getDataPtr(), parallelTexture.getAccess().getDataPtr(), (size_t)(size*size*uncompressedFormat.getPixelSize())) == 0)
+			m_testCtx.setTestResult(QP_TEST_RESULT_PASS, "Pass");
+		else
+			m_testCtx.setTestResult(QP_TEST_RESULT_FAIL, "Parallel decompression result differs from serial decompression result");
+
+		return STOP;
+	}
+
+private:
+	const tcu::CompressedTexFormat	m_format;
+};
+
+class DecompressedTextureCacheCase : public tcu::TestCase
+{
+public:
+	DecompressedTextureCacheCase (tcu::TestContext& testCtx)
+		: tcu::TestCase(testCtx, "decompressed_texture_cache", "Decompressed texture cache test")
+	{
+	}
+
+	IterateResult iterate (void)
+	{
+		const tcu::CompressedTexFormat			format			= tcu::COMPRESSEDTEXFORMAT_ETC2_RGB8;
+		const int								size			= 64;
+		const tcu::TextureFormat				levelFormat		= tcu::getUncompressedFormat(format);
+		const size_t							levelSize		= (size_t)(size*size*levelFormat.getPixelSize());
+		const tcu::TexDecompressionParams		params;
+		tcu::DecompressedTextureCache			cache			(2*levelSize);
+		tcu::CompressedTexture					textures[3];
+		de::Random								rnd				(deStringHash(getName()));
+
+		for (int texNdx = 0; texNdx < DE_LENGTH_OF_ARRAY(textures); texNdx++)
+		{
+			textures[texNdx].setStorage(format, size, size);
+
+			for (int byteNdx = 0; byteNdx < textures[texNdx].getDataSize(); byteNdx++)
+				((deUint8*)textures[texNdx].getData())[byteNdx] = rnd.getUint8();
+		}
+
+		{
+			const de::SharedPtr<const tcu::TextureLevel>	first		= cache.get(textures[0], params);
+			const de::SharedPtr<const tcu::TextureLevel>	second		= cache.get(textures[0], params);
+			tcu::TextureLevel								reference	(levelFormat, size, size);
+
+			textures[0].decompress(reference.getAccess(), params);
+
+			if (first.get() != second.get())
+				TCU_FAIL("Same payload was decompressed twice");
+
+			if (deMemCmp(first->getAccess().getDataPtr(), reference.getAccess().getDataPtr(), levelSize) != 0)
+				TCU_FAIL("Cached data differs from decompressed data");
+		}
+
+		// Fill the cache and touch first texture so that second one is least recently used
+		cache.get(textures[1], params);
+		cache.get(textures[0], params);
+		cache.get(textures[2], params);
+
+		{
+			const tcu::DecompressedTextureCache::Statistics	stats	= cache.getStatistics();
+
+			m_testCtx.getLog() << TestLog::Integer("NumHits",		"Number of cache hits",		"", QP_KEY_TAG_NONE, (deInt64)stats.numHits)
+							   << TestLog::Integer("NumMisses",		"Number of cache misses",	"", QP_KEY_TAG_NONE, (deInt64)stats.numMisses)
+							   << TestLog::Integer("NumEvictions",	"Number of cache evictions",	"", QP_KEY_TAG_NONE, (deInt64)stats.numEvictions);
+
+			if (stats.numHits != 2 || stats.numMisses != 3 || stats.numEvictions != 1 || stats.cachedSize != 2*levelSize)
+				TCU_FAIL("Unexpected cache statistics");
+		}
+
+		// First texture must still be cached, second one evicted
+		cache.get(textures[0], params);
+		cache.get(textures[1], params);
+
+		{
+			const tcu::DecompressedTextureCache::Statistics	stats	= cache.getStatistics();
+
+			if (stats.numHits != 3 || stats.numMisses != 4)
+				TCU_FAIL("Least recently used entry was not evicted");
+		}
+
+		m_testCtx.setTestResult(QP_TEST_RESULT_PASS, "Pass");
+		return STOP;
+	}
+};
+
+class CommonFrameworkTests : public tcu::TestCaseGroup
+{
+public:
+	CommonFrameworkTests (tcu::TestContext& testCtx)
+		: tcu::TestCaseGroup(testCtx, "common", "Tests for the common utility framework")
+	{
+	}
+
+	void init (void)
+	{
+		addChild(new SelfCheckCase(m_testCtx, "float_format","tcu::FloatFormat_selfTest()",
+								   tcu::FloatFormat_selfTest));
+		addChild(new SelfCheckCase(m_testCtx, "either","tcu::Either_selfTest()",
+								   tcu::Either_selfTest));
+		addChild(new IntervalRoundingCase(m_testCtx));
+		addChild(new DecompressedTextureCacheCase(m_testCtx));
+
+		{
+			static const struct
+			{
+				const char*					name;
+				tcu::CompressedTexFormat	format;
+			} s_formats[] =
+			{
+				{ "etc1_rgb8",		tcu::COMPRESSEDTEXFORMAT_ETC1_RGB8				},
+				{ "eac_r11",		tcu::COMPRESSEDTEXFORMAT_EAC_R11				},
+				{ "eac_rg11",		tcu::COMPRESSEDTEXFORMAT_EAC_RG11				},
+				{ "etc2_rgb8",		tcu::COMPRESSEDTEXFORMAT_ETC2_RGB8				},
+				{ "etc2_eac_rgba8",	tcu::COMPRESSEDTEXFORMAT_ETC2_EAC_RGBA8			},
+				{ "bc1_rgb_unorm",	tcu::COMPRESSEDTEXFORMAT_BC1_RGB_UNORM_BLOCK	},
+				{ "bc3_unorm",		tcu::COMPRESSEDTEXFORMAT_BC3_UNORM_BLOCK		},
+				{ "bc5_unorm",		tcu::COMPRESSEDTEXFORMAT_BC5_UNORM_BLOCK		},
+				{ "astc_4x4",		tcu::COMPRESSEDTEXFORMAT_ASTC_4x4_RGBA			},
+				{ "astc_8x8",		tcu::COMPRESSEDTEXFORMAT_ASTC_8x8_RGBA			},
+				{ "astc_12x12",		tcu::COMPRESSEDTEXFORMAT_ASTC_12x12_RGBA		},
+				{ "astc_4x4_srgb",	tcu::COMPRESSEDTEXFORMAT_ASTC_4x4_SRGB8_ALPHA8	},
+				{ "astc_8x8_srgb",	tcu::COMPRESSEDTEXFORMAT_ASTC_8x8_SRGB8_ALPHA8	},
+			};
+
+			tcu::TestCaseGroup* const perfGroup = new tcu::TestCaseGroup(m_testCtx, "decompression_perf", "Compressed texture decompression performance");
+
+			addChild(perfGroup);
+
+			for (int formatNdx = 0; formatNdx < DE_LENGTH_OF_ARRAY(s_formats); formatNdx++)
+				perfGroup->addChild(new DecompressionPerfCase(m_testCtx, s_formats[formatNdx].name, s_formats[formatNdx].format));
+		}
+	}
+};
+
+class ReferenceRendererTests : public tcu::TestCaseGroup
+{
+public:
+	ReferenceRendererTests (tcu::TestContext& testCtx)
+		: tcu::TestCaseGroup(testCtx, "reference_renderer", "Reference renderer tests")
+	{
+	}
+
+	void init (void)
+	{
+		addChild(new ConstantInterpolationTest(m_testCtx));
+		addChild(new RendererBufferReuseCase(m_testCtx));
+
+		{
+			tcu::TestCaseGroup* const parallelGroup = new tcu::TestCaseGroup(m_testCtx, "parallel_rasterization", "Parallel rasterization tests");
+
+			addChild(parallelGroup);
+
+			parallelGroup->addChild(new ParallelRasterizationCase(m_testCtx, "triangles",				rr::PRIMITIVETYPE_TRIANGLES,	1));
+			parallelGroup->addChild(new ParallelRasterizationCase(m_testCtx, "triangles_multisample",	rr::PRIMITIVETYPE_TRIANGLES,	4));
+			parallelGroup->addChild(new ParallelRasterizationCase(m_testCtx, "lines",					rr::PRIMITIVETYPE_LINES,		1));
+			parallelGroup->addChild(new ParallelRasterizationCase(m_testCtx, "lines_multisample",		rr::PRIMITIVETYPE_LINES,		4));
+			parallelGroup->addChild(new ParallelRasterizationCase(m_testCtx, "points",					rr::PRIMITIVETYPE_POINTS,		1));
+			parallelGroup->addChild(new ParallelRasterizationCase(m_testCtx, "points_multisample",		rr::PRIMITIVETYPE_POINTS,		4));
+		}
+
+		{
+			tcu::TestCaseGroup* const coverageGroup = new tcu::TestCaseGroup(m_testCtx, "triangle_coverage", "Compare triangle rasterization to scalar coverage evaluation");
+
+			addChild(coverageGroup);
+
+			coverageGroup->addChild(new TriangleCoverageCase(m_testCtx, "single_sample",	1));
+			coverageGroup->addChild(new TriangleCoverageCase(m_testCtx, "multisample_2",	2));
+			coverageGroup->addChild(new TriangleCoverageCase(m_testCtx, "multisample_4",	4));
+			coverageGroup->addChild(new TriangleCoverageCase(m_testCtx, "multisample_8",	8));
+			coverageGroup->addChild(new TriangleCoverageCase(m_testCtx, "multisample_16",	16));
+		}
+
+		{
+			tcu::TestCaseGroup* const vertexCacheGroup = new tcu::TestCaseGroup(m_testCtx, "vertex_cache", "Post-transform vertex cache tests");
+
+			addChild(vertexCacheGroup);
+
+			vertexCacheGroup->addChild(new VertexCacheCase(m_testCtx, "triangles_uint16",				rr::PRIMITIVETYPE_TRIANGLES,		rr::INDEXTYPE_UINT16,	0,	false,	1));
+			vertexCacheGroup->addChild(new VertexCacheCase(m_testCtx, "triangle_strip_restart_uint32",	rr::PRIMITIVETYPE_TRIANGLE_STRIP,	rr::INDEXTYPE_UINT32,	0,	true,	1));
+			vertexCacheGroup->addChild(new VertexCacheCase(m_testCtx, "lines_uint8_base_vertex",		rr::PRIMITIVETYPE_LINES,			rr::INDEXTYPE_UINT8,	5,	false,	1));
+			vertexCacheGroup->addChild(new VertexCacheCase(m_testCtx, "points_restart_uint8",			rr::PRIMITIVETYPE_POINTS,			rr::INDEXTYPE_UINT8,	0,	true,	1));
+			vertexCacheGroup->addChild(new VertexCacheCase(m_testCtx, "triangles_instanced",			rr::PRIMITIVETYPE_TRIANGLES,		rr::INDEXTYPE_UINT16,	3,	true,	2));
+		}
+
+		{
+			static const struct
+			{
+				const char*	name;
+				int			quadSize;
+			} s_quadSizes[] =
+			{
+				{ "small",	4	},
+				{ "medium",	32	},
+				{ "large",	256	},
+			};
+
+			tcu::TestCaseGroup* const perfGroup = new tcu::TestCaseGroup(m_testCtx, "triangle_rasterization_perf", "Triangle rasterization performance");
+
+			addChild(perfGroup);
+
+			for (int sizeNdx = 0; sizeNdx < DE_LENGTH_OF_ARRAY(s_quadSizes); sizeNdx++)
+			{
+				const string name = s_quadSizes[sizeNdx].name;
+
+				perfGroup->addChild(new TriangleRasterizationPerfCase(m_testCtx, name.c_str(),						s_quadSizes[sizeNdx].quadSize,	1));
+				perfGroup->addChild(new TriangleRasterizationPerfCase(m_testCtx, (name + "_multisample_4").c_str(),	s_quadSizes[sizeNdx].quadSize,	4));
+				perfGroup->addChild(new TriangleRasterizationPerfCase(m_testCtx, (name + "_multisample_16").c_str(),	s_quadSizes[sizeNdx].quadSize,	16));
+			}
+		}
 	}
 };
 
@@ -31,7 +31,12 @@
 #include "tcuTextureUtil.hpp"
 #include "tcuRGBA.hpp"
 #include "deFilePath.hpp"
+#include "deRandom.hpp"
+#include "deString.h"
 #include "deClock.h"
+#include "deMemory.h"
+
+#include <limits>
 
 namespace dit
 {
@@ -154,6 +159,370 @@ private:
 	const bool				m_expectedResult;
 };
 
+class ThresholdComparePerfCase : public tcu::TestCase
+{
+public:
+	enum CompareType
+	{
+		COMPARETYPE_FLOAT_THRESHOLD = 0,
+		COMPARETYPE_INT_THRESHOLD,
+		COMPARETYPE_POSITION_DEVIATION,
+
+		COMPARETYPE_LAST
+	};
+
+	ThresholdComparePerfCase (tcu::TestContext& testCtx, const char* name, CompareType compareType, const tcu::TextureFormat& format, int width, int height)
+		: tcu::TestCase		(testCtx, name, "")
+		, m_compareType		(compareType)
+		, m_format			(format)
+		, m_width			(width)
+		, m_height			(height)
+	{
+	}
+
+	IterateResult iterate (void)
+	{
+		const tcu::Vec4		floatThreshold			(2.5f / 255.0f);
+		const tcu::UVec4	intThreshold			(2u);
+		const tcu::UVec4	positionThreshold		(0u);
+		const tcu::IVec3	maxPositionDeviation	(1, 1, 0);
+		tcu::TextureLevel	refImg					(m_format, m_width, m_height);
+		tcu::TextureLevel	cmpImg					(m_format, m_width, m_height);
+		de::Random			rnd						(deStringHash(getName()));
+		bool				results[tcu::COMPARE_EXEC_LAST];
+		deUint64			compareTime[tcu::COMPARE_EXEC_LAST];
+		tcu::TextureLevel	errorMasks[tcu::COMPARE_EXEC_LAST];
+		tcu::Vec4			floatMaxDiff[tcu::COMPARE_EXEC_LAST];
+		tcu::U64Vec4		intMaxDiff[tcu::COMPARE_EXEC_LAST];
+		int					numFailingPixels[tcu::COMPARE_EXEC_LAST];
+
+		for (int y = 0; y < m_height; y++)
+		for (int x = 0; x < m_width; x++)
+		{
+			const tcu::IVec4 color (rnd.getInt(2, 253), rnd.getInt(2, 253), rnd.getInt(2, 253), 255);
+
+			refImg.getAccess().setPixel(color.asFloat() / 255.0f, x, y);
+		}
+
+		if (m_compareType == COMPARETYPE_POSITION_DEVIATION)
+		{
+			// Shift every other row by one pixel so that all pixels on those rows need neighbourhood search.
+			for (int y = 0; y < m_height; y++)
+			for (int x = 0; x < m_width; x++)
+				cmpImg.getAccess().setPixel(refImg.getAccess().getPixel((y % 2 == 0) ? x : de::min(x + 1, m_width - 1), y), x, y);
+		}
+		else
+		{
+			for (int y = 0; y < m_height; y++)
+			for (int x = 0; x < m_width; x++)
+			{
+				const tcu::IVec4 noise (rnd.getInt(-2, 2), rnd.getInt(-2, 2), rnd.getInt(-2, 2), 0);
+
+				cmpImg.getAccess().setPixel(refImg.getAccess().getPixel(x, y) + noise.asFloat() / 255.0f, x, y);
+			}
+		}
+
+		for (int modeNdx = 0; modeNdx < tcu::COMPARE_EXEC_LAST; modeNdx++)
+		{
+			const tcu::CompareExecMode	execMode	= (tcu::CompareExecMode)modeNdx;
+			const deUint64				startTime	= deGetMicroseconds();
+
+			switch (m_compareType)
+			{
+				case COMPARETYPE_FLOAT_THRESHOLD:
+					results[modeNdx] = tcu::floatThresholdCompare(m_testCtx.getLog(), "CompareResult", "Image comparison result", refImg, cmpImg, floatThreshold, tcu::COMPARE_LOG_ON_ERROR, execMode);
+					break;
+
+				case COMPARETYPE_INT_THRESHOLD:
+					results[modeNdx] = tcu::intThresholdCompare(m_testCtx.getLog(), "CompareResult", "Image comparison result", refImg, cmpImg, intThreshold, tcu::COMPARE_LOG_ON_ERROR, false, execMode);
+					break;
+
+				case COMPARETYPE_POSITION_DEVIATION:
+					results[modeNdx] = tcu::intThresholdPositionDeviationCompare(m_testCtx.getLog(), "CompareResult", "Image comparison result", refImg, cmpImg, positionThreshold, maxPositionDeviation, true, tcu::COMPARE_LOG_ON_ERROR, execMode);
+					break;
+
+				default:
+					DE_ASSERT(false);
+			}
+
+			compareTime[modeNdx] = deGetMicroseconds()-startTime;
+		}
+
+		m_testCtx.getLog() << TestLog::Integer("SerialCompareTime", "Serial comparison time", "us", QP_KEY_TAG_TIME, compareTime[tcu::COMPARE_EXEC_SERIAL])
+						   << TestLog::Integer("ParallelCompareTime", "Parallel comparison time", "us", QP_KEY_TAG_TIME, compareTime[tcu::COMPARE_EXEC_PARALLEL]);
+
+		// Parallel comparison must produce exactly the same maximum difference and error mask as serial comparison.
+		for (int modeNdx = 0; modeNdx < tcu::COMPARE_EXEC_LAST; modeNdx++)
+		{
+			const tcu::CompareExecMode	execMode	= (tcu::CompareExecMode)modeNdx;
+
+			errorMasks[modeNdx].setStorage(tcu::TextureFormat(tcu::TextureFormat::RGB, tcu::TextureFormat::UNORM_INT8), m_width, m_height);
+			floatMaxDiff[modeNdx]		= tcu::Vec4(0.0f);
+			intMaxDiff[modeNdx]			= tcu::U64Vec4(0u);
+			numFailingPixels[modeNdx]	= 0;
+
+			switch (m_compareType)
+			{
+				case COMPARETYPE_FLOAT_THRESHOLD:
+					floatMaxDiff[modeNdx] = tcu::computeFloatThresholdErrorMask(refImg, cmpImg, floatThreshold, errorMasks[modeNdx], execMode);
+					break;
+
+				case COMPARETYPE_INT_THRESHOLD:
+					intMaxDiff[modeNdx] = tcu::computeIntThresholdErrorMask(refImg, cmpImg, intThreshold, false, errorMasks[modeNdx], execMode);
+					break;
+
+				case COMPARETYPE_POSITION_DEVIATION:
+					numFailingPixels[modeNdx] = tcu::computePositionDeviationErrorMask(refImg, cmpImg, positionThreshold, maxPositionDeviation, true, errorMasks[modeNdx], execMode);
+					break;
+
+				default:
+					DE_ASSERT(false);
+			}
+		}
+
+		{
+			const bool	sameMaxDiff		= floatMaxDiff[tcu::COMPARE_EXEC_SERIAL] == floatMaxDiff[tcu::COMPARE_EXEC_PARALLEL] &&
+										  intMaxDiff[tcu::COMPARE_EXEC_SERIAL] == intMaxDiff[tcu::COMPARE_EXEC_PARALLEL] &&
+										  numFailingPixels[tcu::COMPARE_EXEC_SERIAL] == numFailingPixels[tcu::COMPARE_EXEC_PARALLEL];
+			const bool	sameErrorMask	= deMemCmp(errorMasks[tcu::COMPARE_EXEC_SERIAL].getAccess().getDataPtr(),
+												   errorMasks[tcu::COMPARE_EXEC_PARALLEL].getAccess().getDataPtr(),
+												   (size_t)(m_width*m_height*3)) == 0;
+
+			if (!sameMaxDiff)
+				m_testCtx.getLog() << TestLog::Message << "Serial and parallel maximum differences differ: "
+								   << floatMaxDiff[tcu::COMPARE_EXEC_SERIAL] << intMaxDiff[tcu::COMPARE_EXEC_SERIAL] << " " << numFailingPixels[tcu::COMPARE_EXEC_SERIAL] << " vs. "
+								   << floatMaxDiff[tcu::COMPARE_EXEC_PARALLEL] << intMaxDiff[tcu::COMPARE_EXEC_PARALLEL] << " " << numFailingPixels[tcu::COMPARE_EXEC_PARALLEL]
+								   << TestLog::EndMessage;
+
+			if (!sameErrorMask)
+				m_testCtx.getLog() << TestLog::Message << "Serial and parallel error masks differ" << TestLog::EndMessage
+								   << TestLog::ImageSet("ErrorMasks", "Error masks")
+								   << TestLog::Image("SerialErrorMask", "Serial error mask", errorMasks[tcu::COMPARE_EXEC_SERIAL])
+								   << TestLog::Image("ParallelErrorMask", "Parallel error mask", errorMasks[tcu::COMPARE_EXEC_PARALLEL])
+								   << TestLog::EndImageSet;
+
+			if (!results[tcu::COMPARE_EXEC_SERIAL] || !results[tcu::COMPARE_EXEC_PARALLEL])
+				m_testCtx.setTestResult(QP_TEST_RESULT_FAIL, "Wrong comparison result");
+			else if (!sameMaxDiff || !sameErrorMask)
+				m_testCtx.setTestResult(QP_TEST_RESULT_FAIL, "Parallel comparison result differs from serial comparison");
+			else
+				m_testCtx.setTestResult(QP_TEST_RESULT_PASS, "Pass");
+		}
+
+		return STOP;
+	}
+
+private:
+	const CompareType			m_compareType;
+	const tcu::TextureFormat	m_format;
+	const int					m_width;
+	const int					m_height;
+};
+
+class ThresholdCompareKernelCase : public tcu::TestCase
+{
+public:
+	enum CompareType
+	{
+		COMPARETYPE_FLOAT_THRESHOLD = 0,
+		COMPARETYPE_INT_THRESHOLD,
+		COMPARETYPE_INT64_THRESHOLD,
+		COMPARETYPE_DEPTH_STENCIL_THRESHOLD,
+
+		COMPARETYPE_LAST
+	};
+
+	ThresholdCompareKernelCase (tcu::TestContext& testCtx, const char* name, CompareType compareType, const tcu::TextureFormat& format)
+		: tcu::TestCase		(testCtx, name, "")
+		, m_compareType		(compareType)
+		, m_format			(format)
+	{
+	}
+
+	IterateResult iterate (void)
+	{
+		// Odd width so that row kernels also process partial vectors at the end of each row.
+		const int					width			= 67;
+		const int					height			= 19;
+		const tcu::TextureFormat	maskFormat		(tcu::TextureFormat::RGB, tcu::TextureFormat::UNORM_INT8);
+		const int					pixelSize		= tcu::getPixelSize(m_format);
+		const tcu::IVec3			stridedPitch	(2*pixelSize, 2*pixelSize*width, 2*pixelSize*width*height);
+		const tcu::Vec4				floatThreshold	= m_format.type == tcu::TextureFormat::UNORM_INT8 ? tcu::Vec4(1.0f, 2.0f, 3.0f, 4.0f) / 255.0f : tcu::Vec4(0.25f, 0.125f, 1.0f / 1024.0f, 0.5f);
+		const tcu::UVec4			intThreshold	= m_format.order == tcu::TextureFormat::R ? tcu::UVec4(3u) : tcu::UVec4(1u, 2u, 3u, 4u);
+		const float					dsThreshold		= 3.0f / (float)0xffffff;
+		de::Random					rnd				(deStringHash(getName()));
+		tcu::TextureLevel			refImg			(m_format, width, height);
+		tcu::TextureLevel			cmpImg			(m_format, width, height);
+		std::vector<deUint8>		stridedRefData	((size_t)(stridedPitch.z()));
+		std::vector<deUint8>		stridedCmpData	((size_t)(stridedPitch.z()));
+		tcu::TextureLevel			errorMasks[2];
+		tcu::Vec4					floatMaxDiff[2];
+		tcu::U64Vec4				intMaxDiff[2];
+		float						dsMaxDiff[2];
+		bool						stencilOk[2];
+
+		fillImages(rnd, refImg.getAccess(), cmpImg.getAccess(), floatThreshold);
+
+		// Same pixels with padding between them; such accesses are always compared with the generic per-pixel code.
+		for (int y = 0; y < height; y++)
+		for (int x = 0; x < width; x++)
+		{
+			deMemcpy(&stridedRefData[(size_t)(y*stridedPitch.y() + x*stridedPitch.x())], refImg.getAccess().getPixelPtr(x, y), (size_t)pixelSize);
+			deMemcpy(&stridedCmpData[(size_t)(y*stridedPitch.y() + x*stridedPitch.x())], cmpImg.getAccess().getPixelPtr(x, y), (size_t)pixelSize);
+		}
+
+		for (int pathNdx = 0; pathNdx < 2; pathNdx++)
+		{
+			const bool							generic		= pathNdx == 1;
+			const tcu::ConstPixelBufferAccess	reference	= generic ? tcu::ConstPixelBufferAccess(m_format, tcu::IVec3(width, height, 1), stridedPitch, &stridedRefData[0]) : refImg.getAccess();
+			const tcu::ConstPixelBufferAccess	result		= generic ? tcu::ConstPixelBufferAccess(m_format, tcu::IVec3(width, height, 1), stridedPitch, &stridedCmpData[0]) : cmpImg.getAccess();
+
+			errorMasks[pathNdx].setStorage(maskFormat, width, height);
+			floatMaxDiff[pathNdx]	= tcu::Vec4(0.0f);
+			intMaxDiff[pathNdx]		= tcu::U64Vec4(0u);
+			dsMaxDiff[pathNdx]		= 0.0f;
+			stencilOk[pathNdx]		= true;
+
+			switch (m_compareType)
+			{
+				case COMPARETYPE_FLOAT_THRESHOLD:
+					floatMaxDiff[pathNdx] = tcu::computeFloatThresholdErrorMask(reference, result, floatThreshold, errorMasks[pathNdx]);
+					break;
+
+				case COMPARETYPE_INT_THRESHOLD:
+				case COMPARETYPE_INT64_THRESHOLD:
+					intMaxDiff[pathNdx] = tcu::computeIntThresholdErrorMask(reference, result, intThreshold, m_compareType == COMPARETYPE_INT64_THRESHOLD, errorMasks[pathNdx]);
+					break;
+
+				case COMPARETYPE_DEPTH_STENCIL_THRESHOLD:
+					dsMaxDiff[pathNdx] = tcu::computeDepthStencilThresholdErrorMask(reference, result, dsThreshold, errorMasks[pathNdx], stencilOk[pathNdx]);
+					break;
+
+				default:
+					DE_ASSERT(false);
+			}
+		}
+
+		{
+			// Maximum differences are compared bitwise so that NaN propagation and signed zeros must match too.
+			const bool	sameMaxDiff		= deMemCmp(floatMaxDiff[0].getPtr(), floatMaxDiff[1].getPtr(), sizeof(tcu::Vec4)) == 0 &&
+										  intMaxDiff[0] == intMaxDiff[1] &&
+										  deMemCmp(&dsMaxDiff[0], &dsMaxDiff[1], sizeof(float)) == 0 &&
+										  stencilOk[0] == stencilOk[1];
+			const bool	sameErrorMask	= deMemCmp(errorMasks[0].getAccess().getDataPtr(), errorMasks[1].getAccess().getDataPtr(), (size_t)(width*height*3)) == 0;
+			int			numFailed		= 0;
+
+			for (int y = 0; y < height; y++)
+			for (int x = 0; x < width; x++)
+				numFailed += errorMasks[0].getAccess().getPixelInt(x, y).x() != 0 ? 1 : 0;
+
+			m_testCtx.getLog() << TestLog::Message << "Format " << m_format << ", " << numFailed << " of " << width*height << " pixels over threshold" << TestLog::EndMessage;
+
+			if (!sameMaxDiff)
+				m_testCtx.getLog() << TestLog::Message << "Maximum differences differ: "
+								   << floatMaxDiff[0] << intMaxDiff[0] << " " << dsMaxDiff[0] << " " << stencilOk[0] << " vs. "
+								   << floatMaxDiff[1] << intMaxDiff[1] << " " << dsMaxDiff[1] << " " << stencilOk[1]
+								   << TestLog::EndMessage;
+
+			if (!sameErrorMask)
+				m_testCtx.getLog() << TestLog::Message << "Error masks differ" << TestLog::EndMessage
+								   << TestLog::ImageSet("ErrorMasks", "Error masks")
+								   << TestLog::Image("KernelErrorMask", "Format-specialized error mask", errorMasks[0])
+								   << TestLog::Image("GenericErrorMask", "Generic error mask", errorMasks[1])
+								   << TestLog::EndImageSet;
+
+			if (!sameMaxDiff || !sameErrorMask)
+				m_testCtx.setTestResult(QP_TEST_RESULT_FAIL, "Format-specialized comparison differs from generic comparison");
+			else if (numFailed == 0 || numFailed == width*height)
+				m_testCtx.setTestResult(QP_TEST_RESULT_FAIL, "Test images are not near the threshold");
+			else
+				m_testCtx.setTestResult(QP_TEST_RESULT_PASS, "Pass");
+		}
+
+		return STOP;
+	}
+
+private:
+	//! Random reference and result values around the threshold, including special float values.
+	void fillImages (de::Random& rnd, const tcu::PixelBufferAccess& reference, const tcu::PixelBufferAccess& result, const tcu::Vec4& floatThreshold) const
+	{
+		const int	numPixels	= reference.getWidth() * reference.getHeight();
+		const int	numValues	= numPixels * tcu::getNumUsedChannels(m_format.order);
+
+		if (m_format.type == tcu::TextureFormat::UNORM_INT8)
+		{
+			deUint8* const	refPtr	= (deUint8*)reference.getDataPtr();
+			deUint8* const	cmpPtr	= (deUint8*)result.getDataPtr();
+
+			for (int ndx = 0; ndx < numValues; ndx++)
+			{
+				refPtr[ndx] = rnd.getUint8();
+				cmpPtr[ndx] = (deUint8)de::clamp((int)refPtr[ndx] + rnd.getInt(-4, 4), 0, 255);
+			}
+		}
+		else if (m_format.type == tcu::TextureFormat::UNSIGNED_INT32)
+		{
+			deUint32* const	refPtr	= (deUint32*)reference.getDataPtr();
+			deUint32* const	cmpPtr	= (deUint32*)result.getDataPtr();
+
+			for (int ndx = 0; ndx < numValues; ndx++)
+			{
+				// Values near zero and the top of the range make 32-bit differences wrap around.
+				refPtr[ndx] = rnd.getBool() ? rnd.getUint32() : (deUint32)rnd.getInt(-8, 8);
+				cmpPtr[ndx] = refPtr[ndx] + (deUint32)rnd.getInt(-5, 5);
+
+				if (rnd.getInt(0, 19) == 0)
+					cmpPtr[ndx] = refPtr[ndx] ^ 0x80000000u;
+			}
+		}
+		else if (m_format.type == tcu::TextureFormat::UNSIGNED_INT_24_8)
+		{
+			deUint32* const	refPtr	= (deUint32*)reference.getDataPtr();
+			deUint32* const	cmpPtr	= (deUint32*)result.getDataPtr();
+
+			for (int ndx = 0; ndx < numPixels; ndx++)
+			{
+				const deUint32	refDepth	= rnd.getUint32() & 0xffffffu;
+				const deUint32	cmpDepth	= (deUint32)de::clamp((int)refDepth + rnd.getInt(-5, 5), 0, 0xffffff);
+				const deUint32	stencil		= rnd.getUint8();
+
+				refPtr[ndx] = (refDepth << 8) | stencil;
+				cmpPtr[ndx] = (cmpDepth << 8) | (rnd.getInt(0, 29) == 0 ? (deUint8)(stencil + 1) : stencil);
+			}
+		}
+		else
+		{
+			const float	specialValues[]	= { 0.0f, -0.0f, std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity(), std::numeric_limits<float>::quiet_NaN() };
+			const float	diffScales[]	= { 0.0f, 0.5f, 0.999f, 1.0f, 1.001f, 2.0f };
+
+			for (int y = 0; y < reference.getHeight(); y++)
+			for (int x = 0; x < reference.getWidth(); x++)
+			{
+				tcu::Vec4 refPix;
+				tcu::Vec4 cmpPix;
+
+				for (int c = 0; c < 4; c++)
+				{
+					refPix[c] = rnd.getFloat(-2.0f, 2.0f);
+					cmpPix[c] = refPix[c] + (rnd.getBool() ? 1.0f : -1.0f) * floatThreshold[c] * diffScales[rnd.getInt(0, DE_LENGTH_OF_ARRAY(diffScales) - 1)];
+
+					if (rnd.getInt(0, 19) == 0)
+						refPix[c] = specialValues[rnd.getInt(0, DE_LENGTH_OF_ARRAY(specialValues) - 1)];
+
+					if (rnd.getInt(0, 19) == 0)
+						cmpPix[c] = specialValues[rnd.getInt(0, DE_LENGTH_OF_ARRAY(specialValues) - 1)];
+				}
+
+				reference.setPixel(refPix, x, y);
+				result.setPixel(cmpPix, x, y);
+			}
+		}
+	}
+
+	const CompareType			m_compareType;
+	const tcu::TextureFormat	m_format;
+};
+
 class FuzzyComparisonMetricTests : public tcu::TestCaseGroup
 {
 public:
@@ -217,6 +586,52 @@ public:
 	}
 };
 
+class ThresholdComparePerfTests : public tcu::TestCaseGroup
+{
+public:
+	ThresholdComparePerfTests (tcu::TestContext& testCtx)
+		: tcu::TestCaseGroup(testCtx, "threshold_compare_perf", "Serial and parallel threshold comparison performance")
+	{
+	}
+
+	void init (void)
+	{
+		const tcu::TextureFormat	rgba8	(tcu::TextureFormat::RGBA, tcu::TextureFormat::UNORM_INT8);
+		const tcu::TextureFormat	rgba32f	(tcu::TextureFormat::RGBA, tcu::TextureFormat::FLOAT);
+
+		addChild(new ThresholdComparePerfCase(m_testCtx, "float_threshold_rgba8",		ThresholdComparePerfCase::COMPARETYPE_FLOAT_THRESHOLD,		rgba8,		2048,	2048));
+		addChild(new ThresholdComparePerfCase(m_testCtx, "float_threshold_rgba32f",		ThresholdComparePerfCase::COMPARETYPE_FLOAT_THRESHOLD,		rgba32f,	2048,	2048));
+		addChild(new ThresholdComparePerfCase(m_testCtx, "int_threshold_rgba8",			ThresholdComparePerfCase::COMPARETYPE_INT_THRESHOLD,		rgba8,		2048,	2048));
+		addChild(new ThresholdComparePerfCase(m_testCtx, "position_deviation_rgba8",	ThresholdComparePerfCase::COMPARETYPE_POSITION_DEVIATION,	rgba8,		1024,	1024));
+	}
+};
+
+class ThresholdCompareKernelTests : public tcu::TestCaseGroup
+{
+public:
+	ThresholdCompareKernelTests (tcu::TestContext& testCtx)
+		: tcu::TestCaseGroup(testCtx, "threshold_compare_kernel", "Format-specialized threshold comparison against generic comparison")
+	{
+	}
+
+	void init (void)
+	{
+		const tcu::TextureFormat	rgba8	(tcu::TextureFormat::RGBA, tcu::TextureFormat::UNORM_INT8);
+		const tcu::TextureFormat	rgba16f	(tcu::TextureFormat::RGBA, tcu::TextureFormat::HALF_FLOAT);
+		const tcu::TextureFormat	rgba32f	(tcu::TextureFormat::RGBA, tcu::TextureFormat::FLOAT);
+		const tcu::TextureFormat	r32ui	(tcu::TextureFormat::R, tcu::TextureFormat::UNSIGNED_INT32);
+		const tcu::TextureFormat	d24s8	(tcu::TextureFormat::DS, tcu::TextureFormat::UNSIGNED_INT_24_8);
+
+		addChild(new ThresholdCompareKernelCase(m_testCtx, "float_threshold_rgba8",		ThresholdCompareKernelCase::COMPARETYPE_FLOAT_THRESHOLD,			rgba8));
+		addChild(new ThresholdCompareKernelCase(m_testCtx, "float_threshold_rgba16f",	ThresholdCompareKernelCase::COMPARETYPE_FLOAT_THRESHOLD,			rgba16f));
+		addChild(new ThresholdCompareKernelCase(m_testCtx, "float_threshold_rgba32f",	ThresholdCompareKernelCase::COMPARETYPE_FLOAT_THRESHOLD,			rgba32f));
+		addChild(new ThresholdCompareKernelCase(m_testCtx, "int_threshold_rgba8",		ThresholdCompareKernelCase::COMPARETYPE_INT_THRESHOLD,				rgba8));
+		addChild(new ThresholdCompareKernelCase(m_testCtx, "int_threshold_r32ui",		ThresholdCompareKernelCase::COMPARETYPE_INT_THRESHOLD,				r32ui));
+		addChild(new ThresholdCompareKernelCase(m_testCtx, "int64_threshold_r32ui",		ThresholdCompareKernelCase::COMPARETYPE_INT64_THRESHOLD,			r32ui));
+		addChild(new ThresholdCompareKernelCase(m_testCtx, "ds_threshold_d24s8",		ThresholdCompareKernelCase::COMPARETYPE_DEPTH_STENCIL_THRESHOLD,	d24s8));
+	}
+};
+
 ImageCompareTests::ImageCompareTests (tcu::TestContext& testCtx)
 	: tcu::TestCaseGroup(testCtx, "image_compare", "Image comparison tests")
 {
@@ -230,6 +645,8 @@ void ImageCompareTests::init (void)
 {
 	addChild(new FuzzyComparisonMetricTests	(m_testCtx));
 	addChild(new BilinearCompareTests		(m_testCtx));
+	addChild(new ThresholdComparePerfTests	(m_testCtx));
+	addChild(new ThresholdCompareKernelTests(m_testCtx));
 }
 
 } // dit
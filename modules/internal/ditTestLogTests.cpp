@@ -23,8 +23,14 @@
 
 #include "ditTestLogTests.hpp"
 #include "tcuTestLog.hpp"
+#include "tcuTextureUtil.hpp"
+#include "xeBinaryLogDecoder.hpp"
+#include "deStringUtil.hpp"
+#include "deFile.h"
 
 #include <limits>
+#include <fstream>
+#include <sstream>
 
 namespace dit
 {
@@ -69,6 +75,149 @@ public:
 	}
 };
 
+//! Writes same log in text and binary formats and checks that decoded binary log matches the text log.
+class BinaryLogRoundTripCase : public tcu::TestCase
+{
+public:
+	BinaryLogRoundTripCase (tcu::TestContext& testCtx)
+		: TestCase(testCtx, "binary_round_trip", "Compare decoded binary log to text log")
+	{
+	}
+
+	IterateResult iterate (void)
+	{
+		const std::string	textPath	= "dit-testlog-round-trip.qpa";
+		const std::string	binaryPath	= "dit-testlog-round-trip.bin";
+		bool				allOk		= true;
+
+		writeLog(textPath.c_str(), 0u);
+		writeLog(binaryPath.c_str(), QP_TEST_LOG_BINARY);
+
+		{
+			const std::string	text	= readFile(textPath);
+			const std::string	binary	= readFile(binaryPath);
+			const size_t		chunkSizes[]	= { 1, 7, 4096, binary.size() };
+
+			allOk = check(xe::BinaryLogDecoder::matchMagic((const deUint8*)binary.data(), binary.size()) == xe::BinaryLogDecoder::MAGIC_MATCH, "Binary log doesn't start with magic") && allOk;
+			allOk = check(xe::BinaryLogDecoder::matchMagic((const deUint8*)text.data(), text.size()) == xe::BinaryLogDecoder::MAGIC_MISMATCH, "Text log matches binary log magic") && allOk;
+
+			// Records split across decode() calls
+			for (int sizeNdx = 0; sizeNdx < DE_LENGTH_OF_ARRAY(chunkSizes); sizeNdx++)
+			{
+				const std::string decoded = decode(binary, chunkSizes[sizeNdx]);
+
+				allOk = check(decoded == text, "Decoded binary log differs from text log with chunk size " + de::toString(chunkSizes[sizeNdx])) && allOk;
+			}
+
+			// Truncated log decodes to prefix of text
+			{
+				const std::string decoded = decode(binary.substr(0, binary.size() - 3), binary.size());
+
+				allOk = check(decoded.size() < text.size() && text.compare(0, decoded.size(), decoded) == 0, "Truncated binary log didn't decode to prefix of text log") && allOk;
+			}
+		}
+
+		// Data record claiming more data than deflate can produce
+		{
+			deUint8					record[]	=
+			{
+				'q', 'p', 'B', 'i', 'n', 'L', 'o', 'g',	1, 0, 0, 0,				// header
+				7,										12, 0, 0, 0,			// RECORD_BASE64_DEFLATE, payload size
+				0, 0, 0, 0,														// uncompressed size
+				0x78, 0x01, 0x03, 0x00, 0x00, 0x00, 0x00, 0x01					// deflated empty data
+			};
+			std::string				dst;
+			bool					threw		= false;
+
+			{
+				xe::BinaryLogDecoder decoder;
+				decoder.decode(record, sizeof(record), dst);
+			}
+
+			record[17] = record[18] = record[19] = record[20] = 0xff;
+
+			try
+			{
+				xe::BinaryLogDecoder decoder;
+				decoder.decode(record, sizeof(record), dst);
+			}
+			catch (const xe::BinaryLogParseError&)
+			{
+				threw = true;
+			}
+
+			allOk = check(threw, "Malformed data record size was not rejected") && allOk;
+		}
+
+		deDeleteFile(textPath.c_str());
+		deDeleteFile(binaryPath.c_str());
+
+		if (allOk)
+			m_testCtx.setTestResult(QP_TEST_RESULT_PASS, "Pass");
+		else
+			m_testCtx.setTestResult(QP_TEST_RESULT_FAIL, "Binary log round trip failed");
+
+		return STOP;
+	}
+
+private:
+	bool check (bool ok, const std::string& message)
+	{
+		if (!ok)
+			m_testCtx.getLog() << TestLog::Message << "FAIL: " << message << TestLog::EndMessage;
+
+		return ok;
+	}
+
+	static void writeLog (const char* path, deUint32 flags)
+	{
+		TestLog				log		(path, flags | QP_TEST_LOG_NO_FLUSH);
+		tcu::TextureLevel	image	(tcu::TextureFormat(tcu::TextureFormat::RGBA, tcu::TextureFormat::UNORM_INT8), 64, 64);
+
+		// Large enough to be deflated in binary log
+		tcu::fillWithComponentGradients(image.getAccess(), tcu::Vec4(0.0f), tcu::Vec4(1.0f));
+
+		log.writeSessionInfo("round trip");
+		log.startCase("dE-IT.testlog.round_trip", QP_TEST_CASE_TYPE_SELF_VALIDATE);
+
+		log << TestLog::Message << "Escaped <&>'\" and \x01\x1b control characters" << TestLog::EndMessage
+			<< TestLog::Section("Section", "Nested section")
+			<< TestLog::Message << "Multi\nline\nmessage" << TestLog::EndMessage
+			<< TestLog::Image("Image", "Uncompressed image", image.getAccess(), QP_IMAGE_COMPRESSION_MODE_NONE)
+			<< TestLog::EndSection
+			<< TestLog::ShaderProgram(true, "")
+			<< TestLog::Shader(QP_SHADER_TYPE_VERTEX, "void main (void) { gl_Position = vec4(0.0); }", true, "")
+			<< TestLog::EndShaderProgram
+			<< TestLog::Float("Value", "Float value", "ms", QP_KEY_TAG_TIME, 1.5f)
+			<< TestLog::Integer("Count", "Integer value", "", QP_KEY_TAG_NONE, -3);
+
+		log.endCase(QP_TEST_RESULT_PASS, "Pass");
+	}
+
+	static std::string readFile (const std::string& path)
+	{
+		std::ifstream		in		(path.c_str(), std::ios_base::binary);
+		std::ostringstream	str;
+
+		if (!in.is_open())
+			throw tcu::ResourceError("Failed to open " + path);
+
+		str << in.rdbuf();
+		return str.str();
+	}
+
+	static std::string decode (const std::string& binary, size_t chunkSize)
+	{
+		xe::BinaryLogDecoder	decoder;
+		std::string				decoded;
+
+		for (size_t offset = 0; offset < binary.size(); offset += chunkSize)
+			decoder.decode((const deUint8*)binary.data() + offset, de::min(chunkSize, binary.size() - offset), decoded);
+
+		return decoded;
+	}
+};
+
 TestLogTests::TestLogTests (tcu::TestContext& testCtx)
 	: TestCaseGroup(testCtx, "testlog", "Test Log Tests")
 {
@@ -81,6 +230,7 @@ TestLogTests::~TestLogTests (void)
 void TestLogTests::init (void)
 {
 	addChild(new BasicSampleListCase(m_testCtx));
+	addChild(new BinaryLogRoundTripCase(m_testCtx));
 }
 
 } // dit
@@ -33,6 +33,7 @@
 #include "deArrayUtil.hpp"
 #include "deStringUtil.hpp"
 #include "deUniquePtr.hpp"
+#include "deMemory.h"
 
 #include <sstream>
 
@@ -1372,6 +1373,34 @@ void copyPixels (const ConstPixelBufferAccess& src, const PixelBufferAccess& dst
 	}
 }
 
+void copyRows (const ConstPixelBufferAccess& src, const PixelBufferAccess& dst)
+{
+	switch (getTextureChannelClass(dst.getFormat().type))
+	{
+		case tcu::TEXTURECHANNELCLASS_FLOATING_POINT:
+		case tcu::TEXTURECHANNELCLASS_SIGNED_FIXED_POINT:
+		case tcu::TEXTURECHANNELCLASS_UNSIGNED_FIXED_POINT:
+		{
+			vector<tcu::Vec4> row (src.getWidth());
+			src.readRow(0, 0, &row[0]);
+			dst.writeRow(0, 0, &row[0]);
+			break;
+		}
+
+		case tcu::TEXTURECHANNELCLASS_SIGNED_INTEGER:
+		case tcu::TEXTURECHANNELCLASS_UNSIGNED_INTEGER:
+		{
+			vector<tcu::IVec4> row (src.getWidth());
+			src.readRow(0, 0, &row[0]);
+			dst.writeRow(0, 0, &row[0]);
+			break;
+		}
+
+		default:
+			DE_FATAL("Unknown channel class");
+	}
+}
+
 const char* getTextureAccessTypeDescription (TextureAccessType type)
 {
 	static const char* s_desc[] =
@@ -1470,6 +1499,43 @@ protected:
 			verifyRead<deInt32>(src);
 	}
 
+	template<typename T>
+	void verifyReadRow (const ConstPixelBufferAccess& src)
+	{
+		const int				numPixels	= src.getWidth();
+		vector<Vector<T, 4> >	res			(numPixels);
+
+		m_testCtx.getLog()
+			<< TestLog::Message << "Verifying " << getTextureAccessTypeDescription(getTextureAccessType<T>()) << " readRow() against per-pixel access" << TestLog::EndMessage;
+
+		src.readRow(0, 0, &res[0]);
+
+		for (int pixelNdx = 0; pixelNdx < numPixels; pixelNdx++)
+		{
+			const Vector<T, 4> ref = src.getPixelT<T>(pixelNdx, 0, 0);
+
+			if (!allComponentsEqual(res[pixelNdx], ref))
+			{
+				m_testCtx.getLog()
+					<< TestLog::Message << "ERROR: at pixel " << pixelNdx << ": expected " << ref << ", got " << res[pixelNdx] << TestLog::EndMessage;
+
+				m_testCtx.setTestResult(QP_TEST_RESULT_FAIL, "Comparison failed");
+			}
+		}
+	}
+
+	void verifyReadRow (const ConstPixelBufferAccess& src)
+	{
+		const bool	isFloat32Or64	= src.getFormat().type == tcu::TextureFormat::FLOAT ||
+									  src.getFormat().type == tcu::TextureFormat::FLOAT64;
+
+		if (isAccessValid(src.getFormat(), tcu::TEXTUREACCESSTYPE_FLOAT))
+			verifyReadRow<float>(src);
+
+		if (isAccessValid(src.getFormat(), tcu::TEXTUREACCESSTYPE_SIGNED_INT) && !isFloat32Or64)
+			verifyReadRow<deInt32>(src);
+	}
+
 	void verifyGetPixDepth (const ConstPixelBufferAccess& refAccess, const ConstPixelBufferAccess& combinedAccess)
 	{
 		m_testCtx.getLog()
@@ -1555,8 +1621,15 @@ public:
 			m_testCtx.getLog() << TestLog::Message << "Copying with getPixel() -> setPixel()" << TestLog::EndMessage;
 			copyPixels(inputAccess, tmpAccess);
 			verifyRead(tmpAccess);
+
+			m_testCtx.getLog() << TestLog::Message << "Copying with readRow() -> writeRow()" << TestLog::EndMessage;
+			deMemset(&tmpMem[0], 0, tmpMem.size());
+			copyRows(inputAccess, tmpAccess);
+			verifyRead(tmpAccess);
 		}
 
+		verifyReadRow(inputAccess);
+
 		return STOP;
 	}
 };
@@ -24,7 +24,9 @@
 #include "ditVulkanTests.hpp"
 #include "ditTestCase.hpp"
 
+#include "vkBinaryRegistry.hpp"
 #include "vkImageUtil.hpp"
+#include "vkShaderCache.hpp"
 
 #include "deUniquePtr.hpp"
 
@@ -36,6 +38,8 @@ tcu::TestCaseGroup* createVulkanTests (tcu::TestContext& testCtx)
 	de::MovePtr<tcu::TestCaseGroup>	group	(new tcu::TestCaseGroup(testCtx, "vulkan", "Vulkan Framework Tests"));
 
 	group->addChild(new SelfCheckCase(testCtx, "image_util", "ImageUtil self-check tests", vk::imageUtilSelfTest));
+	group->addChild(new SelfCheckCase(testCtx, "shader_cache", "ShaderCache self-check tests", vk::shaderCacheSelfTest));
+	group->addChild(new SelfCheckCase(testCtx, "binary_registry", "BinaryRegistry self-check tests", vk::binaryRegistrySelfTest));
 
 	return group.release();
 }